@@ -22,12 +22,112 @@ static const char *TAG = "FPR_DEFAULT_MAIN";
 #ifdef CONFIG_FPR_TEST_DATA_SIZES
 #define FPR_TEST_DATA_SIZES CONFIG_FPR_TEST_DATA_SIZES
 #endif
+#ifdef CONFIG_FPR_TEST_AGGREGATE
+#define FPR_TEST_AGGREGATE CONFIG_FPR_TEST_AGGREGATE
+#endif
+#ifdef CONFIG_FPR_TEST_RPC
+#define FPR_TEST_RPC CONFIG_FPR_TEST_RPC
+#endif
+#ifdef CONFIG_FPR_TEST_PUBSUB
+#define FPR_TEST_PUBSUB CONFIG_FPR_TEST_PUBSUB
+#endif
+#ifdef CONFIG_FPR_TEST_TIMESYNC
+#define FPR_TEST_TIMESYNC CONFIG_FPR_TEST_TIMESYNC
+#endif
+#ifdef CONFIG_FPR_TEST_TDMA
+#define FPR_TEST_TDMA CONFIG_FPR_TEST_TDMA
+#endif
+#ifdef CONFIG_FPR_TEST_SLEEPY
+#define FPR_TEST_SLEEPY CONFIG_FPR_TEST_SLEEPY
+#endif
+#ifdef CONFIG_FPR_TEST_STORE_FORWARD
+#define FPR_TEST_STORE_FORWARD CONFIG_FPR_TEST_STORE_FORWARD
+#endif
+#ifdef CONFIG_FPR_TEST_PROBE
+#define FPR_TEST_PROBE CONFIG_FPR_TEST_PROBE
+#endif
+#ifdef CONFIG_FPR_TEST_CHANNEL_SCAN
+#define FPR_TEST_CHANNEL_SCAN CONFIG_FPR_TEST_CHANNEL_SCAN
+#endif
+#ifdef CONFIG_FPR_TEST_CHANNEL
+#define FPR_TEST_CHANNEL CONFIG_FPR_TEST_CHANNEL
+#endif
+#ifdef CONFIG_FPR_TEST_HOST_SELECT
+#define FPR_TEST_HOST_SELECT CONFIG_FPR_TEST_HOST_SELECT
+#endif
+#ifdef CONFIG_FPR_TEST_STANDBY
+#define FPR_TEST_STANDBY CONFIG_FPR_TEST_STANDBY
+#endif
+#ifdef CONFIG_FPR_TEST_LINK
+#define FPR_TEST_LINK CONFIG_FPR_TEST_LINK
+#endif
+#ifdef CONFIG_FPR_TEST_TREE
+#define FPR_TEST_TREE CONFIG_FPR_TEST_TREE
+#endif
+#ifdef CONFIG_FPR_TEST_MPR
+#define FPR_TEST_MPR CONFIG_FPR_TEST_MPR
+#endif
+#ifdef CONFIG_FPR_TEST_PEER_STATS
+#define FPR_TEST_PEER_STATS CONFIG_FPR_TEST_PEER_STATS
+#endif
+#ifdef CONFIG_FPR_TEST_STATS
+#define FPR_TEST_STATS CONFIG_FPR_TEST_STATS
+#endif
+#ifdef CONFIG_FPR_TEST_TRACE
+#define FPR_TEST_TRACE CONFIG_FPR_TEST_TRACE
+#endif
+#ifdef CONFIG_FPR_TEST_CAPTURE
+#define FPR_TEST_CAPTURE CONFIG_FPR_TEST_CAPTURE
+#endif
+#ifdef CONFIG_FPR_TEST_LOG
+#define FPR_TEST_LOG CONFIG_FPR_TEST_LOG
+#endif
+#ifdef CONFIG_FPR_TEST_EVENT
+#define FPR_TEST_EVENT CONFIG_FPR_TEST_EVENT
+#endif
+#ifdef CONFIG_FPR_TEST_SCHED
+#define FPR_TEST_SCHED CONFIG_FPR_TEST_SCHED
+#endif
+#ifdef CONFIG_FPR_TEST_INSTANCE
+#define FPR_TEST_INSTANCE CONFIG_FPR_TEST_INSTANCE
+#endif
+#ifdef CONFIG_FPR_TEST_TRANSPORT
+#define FPR_TEST_TRANSPORT CONFIG_FPR_TEST_TRANSPORT
+#endif
+#ifdef CONFIG_FPR_TEST_BRIDGE
+#define FPR_TEST_BRIDGE CONFIG_FPR_TEST_BRIDGE
+#endif
 /*
  * Test selection macros (choose one):
  * - Define `FPR_TEST_HOST` to build the host test into main
  * - Define `FPR_TEST_CLIENT` to build the client test into main
  * - Define `FPR_TEST_EXTENDER` to build the extender test into main
  * - Define `FPR_TEST_DATA_SIZES` to build the data size test into main
+ * - Define `FPR_TEST_AGGREGATE` to build the aggregation test into main
+ * - Define `FPR_TEST_RPC` to build the RPC test into main
+ * - Define `FPR_TEST_PUBSUB` to build the pub/sub test into main
+ * - Define `FPR_TEST_TIMESYNC` to build the time sync test into main
+ * - Define `FPR_TEST_TDMA` to build the TDMA test into main
+ * - Define `FPR_TEST_SLEEPY` to build the sleepy client test into main
+ * - Define `FPR_TEST_STORE_FORWARD` to build the store-and-forward test into main
+ * - Define `FPR_TEST_PROBE` to build the probe discovery test into main
+ * - Define `FPR_TEST_CHANNEL_SCAN` to build the multi-channel scan test into main
+ * - Define `FPR_TEST_CHANNEL` to build the channel migration test into main
+ * - Define `FPR_TEST_HOST_SELECT` to build the host load selection test into main
+ * - Define `FPR_TEST_STANDBY` to build the hot standby test into main
+ * - Define `FPR_TEST_LINK` to build the direct link test into main
+ * - Define `FPR_TEST_TREE` to build the collection tree test into main
+ * - Define `FPR_TEST_MPR` to build the broadcast relay test into main
+ * - Define `FPR_TEST_PEER_STATS` to build the per-peer statistics test into main
+ * - Define `FPR_TEST_STATS` to build the network statistics test into main
+ * - Define `FPR_TEST_TRACE` to build the packet-event trace test into main
+ * - Define `FPR_TEST_CAPTURE` to build the packet capture test into main
+ * - Define `FPR_TEST_LOG` to build the rate-limited logging test into main
+ * - Define `FPR_TEST_EVENT` to build the connection event stream test into main
+ * - Define `FPR_TEST_SCHED` to build the service task scheduler test into main
+ * - Define `FPR_TEST_INSTANCE` to build the network instances test into main
+ * - Define `FPR_TEST_TRANSPORT` to build the transport interface test into main
+ * - Define `FPR_TEST_BRIDGE` to build the serial bridge framing test into main
  *
  * Optionally define `FPR_TEST_AUTO_START` to automatically start the
  * selected test from `app_main()` with sane defaults.
@@ -45,6 +145,9 @@ static const char *TAG = "FPR_DEFAULT_MAIN";
 #if defined(FPR_TEST_EXTENDER) && defined(FPR_TEST_DATA_SIZES)
 #error "Define only one of FPR_TEST_HOST, FPR_TEST_CLIENT, FPR_TEST_EXTENDER, FPR_TEST_DATA_SIZES"
 #endif
+#if defined(FPR_TEST_AGGREGATE) && (defined(FPR_TEST_HOST) || defined(FPR_TEST_CLIENT) || defined(FPR_TEST_EXTENDER) || defined(FPR_TEST_DATA_SIZES))
+#error "Define only one of FPR_TEST_HOST, FPR_TEST_CLIENT, FPR_TEST_EXTENDER, FPR_TEST_DATA_SIZES, FPR_TEST_AGGREGATE"
+#endif
 
 #if defined(FPR_TEST_HOST)
 #include "test_fpr_host.h"
@@ -55,6 +158,56 @@ static const char *TAG = "FPR_DEFAULT_MAIN";
 #include "test_fpr_extender.h"
 #elif defined(FPR_TEST_DATA_SIZES)
 #include "test_fpr_data_sizes.h"
+#elif defined(FPR_TEST_AGGREGATE)
+#include "test_fpr_aggregate.h"
+#elif defined(FPR_TEST_RPC)
+#include "test_fpr_rpc.h"
+#elif defined(FPR_TEST_PUBSUB)
+#include "test_fpr_pubsub.h"
+#elif defined(FPR_TEST_TIMESYNC)
+#include "test_fpr_timesync.h"
+#elif defined(FPR_TEST_TDMA)
+#include "test_fpr_tdma.h"
+#elif defined(FPR_TEST_SLEEPY)
+#include "test_fpr_sleepy.h"
+#elif defined(FPR_TEST_STORE_FORWARD)
+#include "test_fpr_store_forward.h"
+#elif defined(FPR_TEST_PROBE)
+#include "test_fpr_probe.h"
+#elif defined(FPR_TEST_CHANNEL_SCAN)
+#include "test_fpr_channel_scan.h"
+#elif defined(FPR_TEST_CHANNEL)
+#include "test_fpr_channel.h"
+#elif defined(FPR_TEST_HOST_SELECT)
+#include "test_fpr_host_select.h"
+#elif defined(FPR_TEST_STANDBY)
+#include "test_fpr_standby.h"
+#elif defined(FPR_TEST_LINK)
+#include "test_fpr_link.h"
+#elif defined(FPR_TEST_TREE)
+#include "test_fpr_tree.h"
+#elif defined(FPR_TEST_MPR)
+#include "test_fpr_mpr.h"
+#elif defined(FPR_TEST_PEER_STATS)
+#include "test_fpr_peer_stats.h"
+#elif defined(FPR_TEST_STATS)
+#include "test_fpr_stats.h"
+#elif defined(FPR_TEST_TRACE)
+#include "test_fpr_trace.h"
+#elif defined(FPR_TEST_CAPTURE)
+#include "test_fpr_capture.h"
+#elif defined(FPR_TEST_LOG)
+#include "test_fpr_log.h"
+#elif defined(FPR_TEST_EVENT)
+#include "test_fpr_event.h"
+#elif defined(FPR_TEST_SCHED)
+#include "test_fpr_sched.h"
+#elif defined(FPR_TEST_INSTANCE)
+#include "test_fpr_instance.h"
+#elif defined(FPR_TEST_TRANSPORT)
+#include "test_fpr_transport.h"
+#elif defined(FPR_TEST_BRIDGE)
+#include "test_fpr_bridge.h"
 #endif
 
 void app_main()
@@ -135,5 +288,330 @@ void app_main()
 #else
     ESP_LOGI(TAG, "FPR data size test compiled in; define FPR_TEST_AUTO_START to auto-start");
 #endif
+#elif defined(FPR_TEST_AGGREGATE)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_aggregate_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_aggregate_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR aggregation test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR aggregation test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_RPC)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_rpc_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_rpc_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR RPC test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR RPC test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_PUBSUB)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_pubsub_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_pubsub_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR pub/sub test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR pub/sub test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_TIMESYNC)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_timesync_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_timesync_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR time sync test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR time sync test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_TDMA)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_tdma_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_tdma_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR TDMA test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR TDMA test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_SLEEPY)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_sleepy_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_sleepy_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR sleepy client test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR sleepy client test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_STORE_FORWARD)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_store_forward_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_store_forward_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR store-and-forward test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR store-and-forward test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_PROBE)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_probe_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_probe_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR probe discovery test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR probe discovery test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_CHANNEL_SCAN)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_channel_scan_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_channel_scan_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR multi-channel scan test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR multi-channel scan test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_CHANNEL)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_channel_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_channel_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR channel migration test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR channel migration test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_HOST_SELECT)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_host_select_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_host_select_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR host load selection test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR host load selection test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_STANDBY)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_standby_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_standby_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR hot standby test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR hot standby test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_LINK)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_link_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_link_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR direct link test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR direct link test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_TREE)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_tree_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_tree_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR collection tree test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR collection tree test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_MPR)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_mpr_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_mpr_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR broadcast relay test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR broadcast relay test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_PEER_STATS)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_peer_stats_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_peer_stats_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR per-peer statistics test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR per-peer statistics test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_STATS)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_stats_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_stats_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR network statistics test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR network statistics test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_TRACE)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_trace_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_trace_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR packet-event trace test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR packet-event trace test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_CAPTURE)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_capture_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_capture_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR packet capture test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR packet capture test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_LOG)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_log_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_log_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR rate-limited logging test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR rate-limited logging test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_EVENT)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_event_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_event_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR connection event stream test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR connection event stream test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_SCHED)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_sched_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_sched_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR service task scheduler test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR service task scheduler test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_INSTANCE)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_instance_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_instance_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR network instances test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR network instances test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_TRANSPORT)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_transport_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_transport_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR transport interface test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR transport interface test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
+#elif defined(FPR_TEST_BRIDGE)
+#ifdef FPR_TEST_AUTO_START
+    {
+        esp_err_t _err = fpr_bridge_test_run();
+        if (_err != ESP_OK) {
+            ESP_LOGE(TAG, "fpr_bridge_test_run failed: %d", _err);
+        } else {
+            ESP_LOGI(TAG, "FPR serial bridge framing test passed");
+        }
+    }
+#else
+    ESP_LOGI(TAG, "FPR serial bridge framing test compiled in; define FPR_TEST_AUTO_START to auto-start");
+#endif
 #endif
 }
\ No newline at end of file
@@ -31,6 +31,9 @@
  */
 
 #include "fpr/internal/helpers.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/log.h"
+#include "fpr/internal/scheduler.h"
 #include "fpr/fpr.h"
 #include "fpr/internal/private_defs.h"
 #include "fpr/fpr_config.h"
@@ -63,12 +66,18 @@
 // Use version definitions from fpr_lts.h
 #define FPR_NETWORK_VERSION FPR_PROTOCOL_VERSION
 
-fpr_network_t fpr_net = {0}; // extern from private_defs.h
+fpr_network_t fpr_instances[FPR_MAX_INSTANCES]; // extern from private_defs.h
 
 static esp_now_peer_info_t broadcast_info;
 
 static const char *TAG = "fpr";
 
+static void _transport_receive(const fpr_transport_rx_info_t *info, const uint8_t *data, int len);
+static void _transport_send_done(const uint8_t *dest_addr, bool success);
+
+// Task the transport delivers frames on; set on the first frame
+static TaskHandle_t s_receive_task;
+
 // ========== INTERNAL FUNCTIONS ==========
 
 static esp_err_t _remove_peer_internal(uint8_t *peer_mac) 
@@ -78,10 +87,12 @@ static esp_err_t _remove_peer_internal(uint8_t *peer_mac)
         if (!hashmap_remove(&fpr_net.peers_map, peer_mac)) {
             return ESP_FAIL;
         }
+        _peer_set_state(var, FPR_PEER_STATE_DISCOVERED, FPR_EVENT_REASON_REMOVED);
+        _fpr_services_on_peer_removed(var);
         vQueueDelete(var->response_queue);
         heap_caps_free(var);
     }
-    return esp_now_del_peer(peer_mac);
+    return _fpr_transport_del_peer(peer_mac);
 }
 
 static void _cleanup_peer_entry(void *key, void *value, void *user_data)
@@ -90,10 +101,12 @@ static void _cleanup_peer_entry(void *key, void *value, void *user_data)
     (void)user_data;
     FPR_STORE_HASH_TYPE *peer = (FPR_STORE_HASH_TYPE *)value;
     if (peer) {
+        _peer_slot_release(peer);
+        _fpr_services_on_peer_removed(peer);
         if (peer->response_queue) {
             vQueueDelete(peer->response_queue);
         }
-        esp_now_del_peer(peer->peer_info.peer_addr);
+        _fpr_transport_del_peer(peer->peer_info.peer_addr);
         heap_caps_free(peer);
     }
 }
@@ -115,14 +128,38 @@ static void _setup_broadcast_peer(void)
 // this needs to be called whenever we change mode (host/client/extender)
 static esp_err_t _add_broadcast_peer(const char *mode_name)
 {
-    esp_now_del_peer(broadcast_info.peer_addr);
-    esp_err_t err = esp_now_add_peer(&broadcast_info);
+    _fpr_transport_del_peer(broadcast_info.peer_addr);
+    esp_err_t err = _fpr_transport_add_peer(&broadcast_info);
     if (err == ESP_OK) {
         ESP_LOGI(TAG, "Broadcast peer added for %s", mode_name);
     }
     return err;
 }
 
+// Must be called with the fold lock held. Unsigned subtraction absorbs at
+// most one wrap of a live counter since the previous fold.
+static void _stats_fold_locked(void)
+{
+    for (int i = 0; i < FPR_STAT_COUNT; i++) {
+        uint32_t live = __atomic_load_n(&fpr_net.stats.live[i], __ATOMIC_RELAXED);
+        fpr_net.stats.total[i] += (uint32_t)(live - fpr_net.stats.folded[i]);
+        fpr_net.stats.folded[i] = live;
+    }
+}
+
+void _fpr_stats_fold(void)
+{
+    taskENTER_CRITICAL(&fpr_net.stats.fold_lock);
+    _stats_fold_locked();
+    taskEXIT_CRITICAL(&fpr_net.stats.fold_lock);
+}
+
+static void _stats_init(void)
+{
+    memset(&fpr_net.stats, 0, sizeof(fpr_net.stats));
+    portMUX_INITIALIZE(&fpr_net.stats.fold_lock);
+}
+
 esp_err_t fpr_network_init(const char *name)
 {
     // Use Kconfig defaults
@@ -140,7 +177,7 @@ esp_err_t fpr_network_init_ex(const char *name, const fpr_init_config_t *config)
     ESP_RETURN_ON_FALSE(config != NULL, ESP_ERR_INVALID_ARG, TAG, "Config is NULL");
     ESP_RETURN_ON_FALSE(strlen(name) < sizeof(fpr_net.name), ESP_ERR_INVALID_ARG, TAG, "Name too long");
     ESP_RETURN_ON_FALSE(fpr_net.state == FPR_STATE_UNINITIALIZED, ESP_ERR_INVALID_STATE, TAG, "Network already initialized");
-    ESP_RETURN_ON_ERROR(esp_read_mac(fpr_net.mac, ESP_MAC_WIFI_STA), TAG, "Failed to read MAC address");
+    ESP_RETURN_ON_ERROR(_fpr_transport_get_addr(fpr_net.mac), TAG, "Failed to read MAC address");
     
     strncpy(fpr_net.name, name, sizeof(fpr_net.name) - 1);
     fpr_net.name[sizeof(fpr_net.name) - 1] = '\0';
@@ -180,8 +217,25 @@ esp_err_t fpr_network_init_ex(const char *name, const fpr_init_config_t *config)
     // Initialize sequence number counter
     fpr_net.tx_sequence_num = 0;
 
+    // Radio, event queue and service task are shared by all instances
+    bool first_instance = _fpr_instance_others_active() == 0;
+
     hashmap_init(&fpr_net.peers_map, FPR_HASHMAP_INITIAL_SIZE, mac_hash, mac_equals);
-    ESP_RETURN_ON_ERROR(esp_now_init(), TAG, "Failed to initialize ESP-NOW");
+    portMUX_INITIALIZE(&fpr_net.peer_stats_lock);
+    _stats_init();
+    _fpr_log_init();
+    if (first_instance) {
+        _fpr_event_init();
+    }
+    _fpr_services_init();
+    _fpr_extender_store_init();
+    _fpr_extender_mpr_init();
+    _fpr_probe_init();
+    _fpr_host_select_init();
+    if (first_instance) {
+        ESP_RETURN_ON_ERROR(_fpr_sched_init(), TAG, "Failed to start the service task");
+        ESP_RETURN_ON_ERROR(_fpr_transport_init(_transport_receive, _transport_send_done), TAG, "Failed to start the transport");
+    }
     
     fpr_net.state = FPR_STATE_INITIALIZED;
     fpr_net.paused = false;
@@ -197,54 +251,124 @@ esp_err_t fpr_network_init_ex(const char *name, const fpr_init_config_t *config)
 // update the function
 esp_err_t fpr_network_deinit(void)
 {
-    // Stop reconnect task if running
-    if (fpr_net.reconnect_task != NULL) {
-        vTaskDelete(fpr_net.reconnect_task);
-        fpr_net.reconnect_task = NULL;
-    }
+    // Stop the loop and reconnect jobs; the service task itself stays
+    _fpr_sched_deinit();
     
-    // Stop loop task if running
-    if (fpr_net.loop_task != NULL) {
-        vTaskDelete(fpr_net.loop_task);
-        fpr_net.loop_task = NULL;
-    }
+    // Fail outstanding service calls while peers are still valid
+    _fpr_services_deinit();
+    _fpr_extender_store_deinit();
+    _fpr_extender_mpr_deinit();
+    _fpr_probe_deinit();
+    _fpr_host_select_deinit();
     
     // Clean up peers and hashmap BEFORE memset
     _reset_all_peers();
     hashmap_free(&fpr_net.peers_map);
     
-    // Deinitialize ESP-NOW
-    esp_err_t esp_now_result = esp_now_deinit();
+    // Stop the transport once no other instance uses it
+    esp_err_t transport_result = ESP_OK;
+    if (_fpr_instance_others_active() == 0) {
+        transport_result = _fpr_transport_deinit();
+    }
     
-    // Now safe to zero out the entire structure
+    // Now safe to zero out the entire structure; the instance keeps its network
+    uint8_t network_id = fpr_net.network_id;
     memset(&fpr_net, 0, sizeof(fpr_net));
     fpr_net.state = FPR_STATE_UNINITIALIZED;
+    fpr_net.network_id = network_id;
     
-    return esp_now_result;
+    return transport_result;
 }
 
 // default
-static void _handle_default_send_complete(const wifi_tx_info_t *tx_info, esp_now_send_status_t status)
+static void _handle_default_send_complete(const uint8_t *dest, bool success)
 {
+    _fpr_channel_on_send_status(success);
+    _fpr_link_on_send_status(dest, success);
+    _fpr_tree_on_send_status(dest, success);
+    _fpr_extender_on_send_status(dest, success);
+    _peer_stats_on_send_status(dest, success);
+    FPR_TRACE(FPR_TRACE_TX_DONE, !success, dest, NULL);
     #if (FPR_DEBUG == 1)
-    if (status == ESP_NOW_SEND_SUCCESS) {
+    if (success) {
         ESP_LOGI(TAG, "Data sent successfully");
     } else {
-        ESP_LOGE(TAG, "Failed to send data: %d", status);
+        ESP_LOGE(TAG, "Failed to send data");
     }
     #endif
 }
 
+static void _transport_deliver(const fpr_transport_rx_info_t *info, const uint8_t *data, int len);
+
+// Every received frame, before the mode handler in fpr_net.receiver. With
+// several instances the frame goes to the one on the network in its header.
+static void _transport_receive(const fpr_transport_rx_info_t *info, const uint8_t *data, int len)
+{
+    s_receive_task = xTaskGetCurrentTaskHandle();
+    #if (FPR_MAX_INSTANCES > 1)
+    fpr_network_t *net = _fpr_instance_for_frame(data, len);
+    if (net == NULL) {
+        return; // Not a network this device is on
+    }
+    void *prev = _fpr_instance_enter(net);
+    _transport_deliver(info, data, len);
+    _fpr_instance_leave(prev);
+    #else
+    _transport_deliver(info, data, len);
+    #endif
+}
+
+static void _transport_deliver(const fpr_transport_rx_info_t *info, const uint8_t *data, int len)
+{
+    #if (FPR_CAPTURE_ENABLE == 1)
+    _fpr_capture_frame(FPR_CAPTURE_RX, info->src_addr, info->dest_addr, info->rssi, info->channel, data, (size_t)len);
+    #endif
+    if (is_fpr_package_compatible(len)) {
+        _peer_stats_on_link_frame(info->src_addr, (const fpr_package_t *)data);
+    }
+    esp_now_recv_cb_t receiver = fpr_net.receiver;
+    if (receiver == NULL) {
+        return;
+    }
+    // Mode handlers read link metadata the way ESP-NOW reports it
+    wifi_pkt_rx_ctrl_t rx_ctrl = {0};
+    rx_ctrl.rssi = info->rssi;
+    rx_ctrl.noise_floor = info->noise_floor;
+    rx_ctrl.channel = info->channel;
+    const esp_now_recv_info_t esp_now_info = {
+        .src_addr = (uint8_t *)info->src_addr,
+        .des_addr = (uint8_t *)info->dest_addr,
+        .rx_ctrl = &rx_ctrl,
+    };
+    receiver(&esp_now_info, data, len);
+}
+
+bool _fpr_is_receive_task(void)
+{
+    return s_receive_task != NULL && xTaskGetCurrentTaskHandle() == s_receive_task;
+}
+
+// A send result goes to the instance that has the destination as a peer
+static void _transport_send_done(const uint8_t *dest_addr, bool success)
+{
+    void *prev = _fpr_instance_enter(_fpr_instance_for_peer(dest_addr));
+    fpr_transport_tx_done_cb_t sender = fpr_net.sender;
+    if (sender) {
+        sender(dest_addr, success);
+    }
+    _fpr_instance_leave(prev);
+}
+
 esp_err_t fpr_network_start()
 {
-    wifi_mode_t mode;
-    ESP_RETURN_ON_ERROR(esp_wifi_get_mode(&mode), TAG, "WiFi is not initialized");
-    ESP_RETURN_ON_FALSE(mode == WIFI_MODE_STA || mode == WIFI_MODE_APSTA, ESP_ERR_INVALID_STATE, TAG, "WiFi is not started or in STA/APSTA mode");
-    ESP_RETURN_ON_ERROR(esp_now_register_send_cb(_handle_default_send_complete), TAG, "Failed to register send callback");
-    ESP_RETURN_ON_ERROR(esp_now_register_recv_cb(_handle_client_discovery), TAG, "Failed to register receive callback");
-    
+    if (fpr_transport_get() == fpr_transport_espnow()) {
+        wifi_mode_t mode;
+        ESP_RETURN_ON_ERROR(esp_wifi_get_mode(&mode), TAG, "WiFi is not initialized");
+        ESP_RETURN_ON_FALSE(mode == WIFI_MODE_STA || mode == WIFI_MODE_APSTA, ESP_ERR_INVALID_STATE, TAG, "WiFi is not started or in STA/APSTA mode");
+    }
     fpr_net.sender = _handle_default_send_complete;
     fpr_net.receiver = _handle_client_discovery;
+    
     fpr_network_set_mode(FPR_MODE_CLIENT);
     
     fpr_net.state = FPR_STATE_STARTED;
@@ -267,54 +391,35 @@ esp_err_t fpr_network_stop()
     return ESP_OK;
 }
 
-static esp_err_t fpr_network_override_protocol(esp_now_send_cb_t sender, esp_now_recv_cb_t receiver)
+// The transport callbacks stay registered; only the handlers they forward to change
+static esp_err_t fpr_network_override_protocol(fpr_transport_tx_done_cb_t sender, esp_now_recv_cb_t receiver)
 {
     if (sender) {
-        ESP_RETURN_ON_ERROR(esp_now_unregister_send_cb(), TAG, "Failed to unregister send callback");
-        ESP_RETURN_ON_ERROR(esp_now_register_send_cb(sender), TAG, "Failed to register send callback");
         fpr_net.sender = sender;
     }
     
     if (receiver) {
-        ESP_RETURN_ON_ERROR(esp_now_unregister_recv_cb(), TAG, "Failed to unregister receive callback");
-        ESP_RETURN_ON_ERROR(esp_now_register_recv_cb(receiver), TAG, "Failed to register receive callback");
         fpr_net.receiver = receiver;
     }
     
     return ESP_OK;
 }
 
-static void _fpr_handle_client_loop(void *arg) 
+static int64_t _fpr_client_discovery_job(int64_t now_us)
 {
-    TickType_t duration = (TickType_t)(uintptr_t)arg;
-    ESP_LOGI(TAG, "Client loop task started for %u ticks", (unsigned int)duration);
-    TickType_t start = xTaskGetTickCount();
-    TickType_t last_wake = start;
-
-    while ((xTaskGetTickCount() - start) < duration) {
-        // Just wait - receiver handler does all the work
-        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(FPR_CLIENT_WAIT_CHECK_INTERVAL_MS));
-    }
-
-    fpr_net.loop_task = NULL;
-    vTaskDelete(NULL);
+    // The receiver handler does all the work; the job only ends the loop
+    return now_us >= fpr_net.loop_end_us ? 0 : fpr_net.loop_end_us;
 }
 
-static void _fpr_handle_host_loop(void *arg)
+static int64_t _fpr_host_discovery_job(int64_t now_us)
 {
-    TickType_t duration = (TickType_t)(uintptr_t)arg;
-    ESP_LOGI(TAG, "Host loop task started for %u ticks", (unsigned int)duration);
-    TickType_t start = xTaskGetTickCount();
-    TickType_t last_wake = start;
-    
-    while ((xTaskGetTickCount() - start) < duration) {
-        // Just broadcast device info - receiver handler does connection work
-        fpr_network_broadcast_device_info();
-        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(FPR_HOST_SCAN_POLL_INTERVAL_MS));
+    if (now_us >= fpr_net.loop_end_us) {
+        return 0;
     }
-
-    fpr_net.loop_task = NULL;
-    vTaskDelete(NULL);
+    // Just broadcast device info - receiver handler does connection work
+    fpr_network_broadcast_device_info();
+    int64_t next_us = now_us + (int64_t)FPR_HOST_SCAN_POLL_INTERVAL_MS * 1000;
+    return next_us < fpr_net.loop_end_us ? next_us : fpr_net.loop_end_us;
 }
 
 void fpr_network_set_mode(fpr_mode_type_t mode)
@@ -341,6 +446,10 @@ void fpr_network_set_mode(fpr_mode_type_t mode)
         _add_broadcast_peer("extender");
         fpr_network_override_protocol(NULL, _handle_extender_receive);
     }
+    _fpr_timesync_on_mode_set();
+    _fpr_extender_mpr_on_mode_set();
+    _fpr_tree_on_mode_set();
+    _fpr_probe_on_mode_set();
 }
 
 fpr_mode_type_t fpr_network_get_mode()
@@ -360,21 +469,16 @@ esp_err_t fpr_network_remove_peer(uint8_t *peer_mac)
 
 esp_err_t fpr_network_start_loop_task(TickType_t duration, bool force_restart) 
 {
-    if (fpr_net.loop_task != NULL && !force_restart) {
+    if (_fpr_sched_is_armed(FPR_JOB_DISCOVERY) && !force_restart) {
         return ESP_ERR_INVALID_STATE; // Loop already running
     }
 
-    if (force_restart && fpr_net.loop_task != NULL) {
-        vTaskDelete(fpr_net.loop_task);
-        fpr_net.loop_task = NULL;
-    }
-
-    BaseType_t result;
+    fpr_job_fn_t job;
     if (fpr_net.current_mode == FPR_MODE_CLIENT) {
-        result = xTaskCreate(_fpr_handle_client_loop, "FPR_Client_Loop", 4096, (void *)(uintptr_t)duration, tskIDLE_PRIORITY + 1, &fpr_net.loop_task);
+        job = _fpr_client_discovery_job;
     }
     else if (fpr_net.current_mode == FPR_MODE_HOST) {
-        result = xTaskCreate(_fpr_handle_host_loop, "FPR_Host_Loop", 4096, (void *)(uintptr_t)duration, tskIDLE_PRIORITY + 1, &fpr_net.loop_task);
+        job = _fpr_host_discovery_job;
     }
     else if (fpr_net.current_mode == FPR_MODE_EXTENDER) {
         return ESP_ERR_NOT_SUPPORTED; // Extender mode does not support loop tasks
@@ -383,25 +487,26 @@ esp_err_t fpr_network_start_loop_task(TickType_t duration, bool force_restart)
         return ESP_ERR_INVALID_STATE; // Invalid mode
     }
 
-    taskYIELD(); // Yield to allow task to start
-    return (result == pdPASS) ? ESP_OK : ESP_ERR_NO_MEM;
+    int64_t now_us = esp_timer_get_time();
+    fpr_net.loop_end_us = (duration == portMAX_DELAY) ? INT64_MAX : now_us + (int64_t)duration * 1000000 / configTICK_RATE_HZ;
+    ESP_LOGI(TAG, "%s loop started for %u ticks", fpr_net.current_mode == FPR_MODE_CLIENT ? "Client" : "Host", (unsigned int)duration);
+    // The client job has nothing to do before the end of the loop
+    _fpr_sched_set(FPR_JOB_DISCOVERY, job, fpr_net.current_mode == FPR_MODE_CLIENT ? fpr_net.loop_end_us : now_us);
+    return ESP_OK;
 }
 
 esp_err_t fpr_network_stop_loop_task() 
 {
-    if (fpr_net.loop_task == NULL) {
-        vTaskDelete(fpr_net.loop_task);
-        fpr_net.loop_task = NULL;
-        return ESP_OK; // Already stopped
-    }
-    else {
+    if (!_fpr_sched_is_armed(FPR_JOB_DISCOVERY)) {
         return ESP_ERR_INVALID_STATE; // No loop task running
     }
+    _fpr_sched_cancel(FPR_JOB_DISCOVERY);
+    return ESP_OK;
 }
 
 bool fpr_network_is_loop_task_running()
 {
-    return (fpr_net.loop_task != NULL);
+    return _fpr_sched_is_armed(FPR_JOB_DISCOVERY);
 }
 
 // ========== ADVANCED SEND OPTIONS ==========
@@ -425,7 +530,17 @@ esp_err_t fpr_send_with_options(uint8_t *peer_address, void *data, int size, con
     esp_err_t last_result = ESP_OK;
     
     // Get sequence number for this transmission (all fragments share same seq)
-    uint32_t seq_num = ++fpr_net.tx_sequence_num;
+    uint32_t seq_num = _fpr_next_sequence_num();
+    
+    // TDMA slots and sleepy-client buffers hold packets back instead of sending now
+    bool deferred = _fpr_services_should_defer(peer_address, options->package_id);
+    
+    // A linked client whose direct path is degraded is reached through the host
+    uint8_t relay_mac[MAC_ADDRESS_LENGTH];
+    const uint8_t *tx_address = peer_address;
+    if (!deferred && _fpr_link_route(peer_address, options->package_id, relay_mac)) {
+        tx_address = relay_mac;
+    }
     
     while (data_remaining > 0) {
         fpr_package_t package = {0};
@@ -459,18 +574,27 @@ esp_err_t fpr_send_with_options(uint8_t *peer_address, void *data, int size, con
         package.max_hops = options->max_hops > 0 ? options->max_hops : FPR_DEFAULT_MAX_HOPS;
         package.version = FPR_NETWORK_VERSION;  // Set protocol version
         
-        last_result = esp_now_send(peer_address, (const uint8_t *)&package, sizeof(package));
+        if (deferred) {
+            last_result = _fpr_services_defer(&package);
+        } else {
+            last_result = _fpr_radio_send(tx_address, &package);
+        }
+        if (!deferred) {
+            _fpr_channel_on_send_queued(last_result);
+            _peer_stats_on_send(tx_address, last_result);
+        }
         if (last_result == ESP_OK) {
-            fpr_net.stats.packets_sent++;
+            if (!deferred) {
+                _fpr_stat_add(FPR_STAT_PACKETS_SENT, 1);
+            }
         } else {
-            fpr_net.stats.send_failures++;
+            _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
             // Log specific error for debugging
-            if (last_result == ESP_ERR_ESPNOW_NO_MEM) {
-                ESP_LOGW(TAG, "ESP-NOW buffer full (NO_MEM), try reducing send rate or increasing receive processing");
+            if (_fpr_transport_is_full(last_result)) {
+                FPR_LOGW_RL(TAG, "Transport buffer full (NO_MEM), try reducing send rate or increasing receive processing");
+            } else {
+                FPR_LOGW_RL(TAG, "Transport send failed: %s (0x%x)", esp_err_to_name(last_result), last_result);
             }
-            #if (FPR_DEBUG == 1)
-            ESP_LOGW(TAG, "esp_now_send failed: %s (0x%x)", esp_err_to_name(last_result), last_result);
-            #endif
             return last_result; // Fail early on send error
         }
 
@@ -480,7 +604,7 @@ esp_err_t fpr_send_with_options(uint8_t *peer_address, void *data, int size, con
         
         // Small delay between fragments to prevent overwhelming the receiver
         // Only needed for multi-packet transfers
-        if (!single_packet && data_remaining > 0) {
+        if (!single_packet && !deferred && data_remaining > 0) {
             vTaskDelay(pdMS_TO_TICKS(2));
         }
     }
@@ -503,15 +627,11 @@ esp_err_t fpr_network_send_to_peer(uint8_t *peer_address, void *data, int size,
     if (package_id != FPR_PACKET_ID_CONTROL) {
         FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_address);
         if (peer == NULL) {
-            #if (FPR_DEBUG == 1)
-            ESP_LOGW(TAG, "Attempting to send to unknown peer " MACSTR, MAC2STR(peer_address));
-            #endif
+            FPR_LOGD_RL(TAG, "Attempting to send to unknown peer " MACSTR, MAC2STR(peer_address));
             return ESP_ERR_NOT_FOUND;
         }
         if (!peer->is_connected) {
-            #if (FPR_DEBUG == 1)
-            ESP_LOGW(TAG, "Attempting to send to disconnected peer %s (" MACSTR ")", peer->name, MAC2STR(peer_address));
-            #endif
+            FPR_LOGD_RL(TAG, "Attempting to send to disconnected peer " MACSTR, MAC2STR(peer_address));
             return ESP_ERR_INVALID_STATE;
         }
     }
@@ -534,6 +654,9 @@ fpr_connect_t make_fpr_info_with_keys(bool include_pwk, bool include_lwk, const
     memcpy(info.peer_info.peer_addr, fpr_net.mac, 6);
     fpr_set_peer_info(&info.peer_info); // Initialize peer_info properly
     info.visibility = fpr_net.access_state;
+    if (fpr_net.current_mode == FPR_MODE_HOST) {
+        _fpr_host_fill_load(&info.load);
+    }
     
     // Include PWK if requested and available
     if (include_pwk && pwk) {
@@ -591,7 +714,10 @@ fpr_visibility_t fpr_network_get_permission_state(void)
 size_t fpr_network_get_peers(fpr_data_receive_cb_t callback, void *user_data)
 {
     if (callback) {
-        return hashmap_foreach(&fpr_net.peers_map, callback, user_data);
+        HashMap *map = &fpr_net.peers_map;
+        size_t count;
+        FPR_APP_CALLBACK(count = hashmap_foreach(map, callback, user_data));
+        return count;
     }
     else {
         return 0;
@@ -632,22 +758,61 @@ void fpr_get_protocol_version_string(char *buf, size_t buf_size)
 void fpr_get_network_stats(fpr_network_stats_t *stats)
 {
     if (stats) {
-        stats->packets_sent = fpr_net.stats.packets_sent;
-        stats->packets_received = fpr_net.stats.packets_received;
-        stats->packets_forwarded = fpr_net.stats.packets_forwarded;
-        stats->packets_dropped = fpr_net.stats.packets_dropped;
-        stats->send_failures = fpr_net.stats.send_failures;
-        stats->replay_attacks_blocked = fpr_net.stats.replay_attacks_blocked;
+        uint64_t total[FPR_STAT_COUNT];
+        taskENTER_CRITICAL(&fpr_net.stats.fold_lock);
+        _stats_fold_locked();
+        memcpy(total, fpr_net.stats.total, sizeof(total));
+        taskEXIT_CRITICAL(&fpr_net.stats.fold_lock);
+        
+        stats->packets_sent = total[FPR_STAT_PACKETS_SENT];
+        stats->packets_received = total[FPR_STAT_PACKETS_RECEIVED];
+        stats->packets_forwarded = total[FPR_STAT_PACKETS_FORWARDED];
+        stats->packets_dropped = total[FPR_STAT_PACKETS_DROPPED];
+        stats->send_failures = total[FPR_STAT_SEND_FAILURES];
+        stats->replay_attacks_blocked = total[FPR_STAT_REPLAY_ATTACKS_BLOCKED];
         stats->peer_count = hashmap_size(&fpr_net.peers_map);
     }
 }
 
 void fpr_reset_network_stats(void)
 {
-    memset(&fpr_net.stats, 0, sizeof(fpr_net.stats));
+    // Live counters keep running; only the widened totals restart
+    taskENTER_CRITICAL(&fpr_net.stats.fold_lock);
+    _stats_fold_locked();
+    memset(fpr_net.stats.total, 0, sizeof(fpr_net.stats.total));
+    taskEXIT_CRITICAL(&fpr_net.stats.fold_lock);
     ESP_LOGI(TAG, "Network statistics reset");
 }
 
+esp_err_t fpr_network_get_peer_stats(const uint8_t *peer_mac, fpr_peer_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(peer_mac != NULL && stats != NULL, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_mac);
+    ESP_RETURN_ON_FALSE(peer != NULL, ESP_ERR_NOT_FOUND, TAG, "Peer not found");
+    
+    taskENTER_CRITICAL(&fpr_net.peer_stats_lock);
+    *stats = peer->stats;
+    taskEXIT_CRITICAL(&fpr_net.peer_stats_lock);
+    return ESP_OK;
+}
+
+esp_err_t fpr_network_reset_peer_stats(const uint8_t *peer_mac)
+{
+    ESP_RETURN_ON_FALSE(peer_mac != NULL, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_mac);
+    ESP_RETURN_ON_FALSE(peer != NULL, ESP_ERR_NOT_FOUND, TAG, "Peer not found");
+    
+    taskENTER_CRITICAL(&fpr_net.peer_stats_lock);
+    memset(&peer->stats, 0, sizeof(peer->stats));
+    peer->stats_last_rx_us = 0;
+    peer->stats_tx_us = 0;
+    peer->rx_link_seq = 0;
+    taskEXIT_CRITICAL(&fpr_net.peer_stats_lock);
+    return ESP_OK;
+}
+
 // ========== PEER DISCOVERY & INFO ==========
 
 esp_err_t fpr_get_peer_info(uint8_t *peer_mac, fpr_peer_info_t *info)
@@ -857,43 +1022,40 @@ bool fpr_network_get_data_from_peer(uint8_t *peer_mac, void *data, int data_size
 
 esp_err_t fpr_network_start_reconnect_task(void)
 {
-    if (fpr_net.reconnect_task != NULL) {
+    if (_fpr_sched_is_armed(FPR_JOB_RECONNECT)) {
         ESP_LOGW(TAG, "Reconnect task already running");
         return ESP_ERR_INVALID_STATE;
     }
 
-    BaseType_t result;
+    int64_t now_us = esp_timer_get_time();
     if (fpr_net.current_mode == FPR_MODE_CLIENT) {
-        // Override protocol handler to keep connection logic active
-        result = xTaskCreatePinnedToCore(_fpr_client_reconnect_task, "FPR_Client_Reconnect", FPR_TASK_STACK_SIZE, NULL, FPR_TASK_PRIORITY, &fpr_net.reconnect_task, FPR_RECONNECT_TASK_CORE_PIN_VALUE);
+        // First keepalive one interval from now, connection checks right away
+        fpr_net.keepalive_sent_us = now_us;
+        _fpr_sched_set(FPR_JOB_RECONNECT, _fpr_client_reconnect_job, now_us);
     }
     else if (fpr_net.current_mode == FPR_MODE_HOST) {
-        // Override protocol handler to keep connection logic active
-        result = xTaskCreatePinnedToCore(_fpr_host_reconnect_task, "FPR_Host_Reconnect", FPR_TASK_STACK_SIZE, NULL, FPR_TASK_PRIORITY, &fpr_net.reconnect_task, FPR_RECONNECT_TASK_CORE_PIN_VALUE);
+        int64_t keep_us = (int64_t)_fpr_get_power_adjusted_interval(FPR_KEEPALIVE_INTERVAL_MS) * 1000;
+        _fpr_sched_set(FPR_JOB_RECONNECT, _fpr_host_reconnect_job, now_us + keep_us);
     }
     else {
         ESP_LOGE(TAG, "Cannot start reconnect task - invalid mode (must be CLIENT or HOST)");
         return ESP_ERR_INVALID_STATE;
     }
 
-    if (result == pdPASS) {
-        ESP_LOGI(TAG, "Reconnect task started for %s mode", fpr_net.current_mode == FPR_MODE_CLIENT ? "client" : "host");
-        return ESP_OK;
-    }
-    return ESP_ERR_NO_MEM;
+    ESP_LOGI(TAG, "Reconnect task started for %s mode", fpr_net.current_mode == FPR_MODE_CLIENT ? "client" : "host");
+    return ESP_OK;
 }
 
 esp_err_t fpr_network_stop_reconnect_task(void)
 {
-    // Intentionally only stops the background reconnect/keepalive task.
+    // Intentionally only stops the background reconnect/keepalive job.
     // Do NOT change protocol handlers or other network state here — stopping
     // reconnect must only remove the automatic reconnection ability.
-    if (fpr_net.reconnect_task == NULL) {
+    if (!_fpr_sched_is_armed(FPR_JOB_RECONNECT)) {
         return ESP_OK; // Already stopped
     }
 
-    vTaskDelete(fpr_net.reconnect_task);
-    fpr_net.reconnect_task = NULL;
+    _fpr_sched_cancel(FPR_JOB_RECONNECT);
 
     ESP_LOGI(TAG, "Reconnect task stopped (handlers/state unchanged)");
     return ESP_OK;
@@ -901,7 +1063,15 @@ esp_err_t fpr_network_stop_reconnect_task(void)
 
 bool fpr_network_is_reconnect_task_running(void)
 {
-    return (fpr_net.reconnect_task != NULL);
+    return _fpr_sched_is_armed(FPR_JOB_RECONNECT);
+}
+
+void fpr_network_get_wakeup_stats(fpr_wakeup_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    _fpr_sched_get_stats(stats);
 }
 
 // ========== NETWORK STATE MANAGEMENT ==========
@@ -1036,23 +1206,6 @@ esp_err_t fpr_get_peer_by_name(const char *peer_name, uint8_t *mac_out)
     return ESP_OK;
 }
 
-static void _clear_all_peers_callback(void *key, void *value, void *user_data)
-{
-    (void)user_data;
-    uint8_t *mac = (uint8_t *)key;
-    FPR_STORE_HASH_TYPE *peer = (FPR_STORE_HASH_TYPE *)value;
-    
-    if (peer) {
-        // Remove from ESP-NOW
-        esp_now_del_peer(mac);
-        
-        // Free response queue if it exists
-        if (peer->response_queue != NULL) {
-            vQueueDelete(peer->response_queue);
-        }
-    }
-}
-
 esp_err_t fpr_clear_all_peers(void)
 {
     size_t peer_count = hashmap_size(&fpr_net.peers_map);
@@ -1062,8 +1215,8 @@ esp_err_t fpr_clear_all_peers(void)
         return ESP_OK;
     }
     
-    // Clean up each peer
-    hashmap_foreach(&fpr_net.peers_map, _clear_all_peers_callback, NULL);
+    // Release slots and service state before the peers go away
+    _reset_all_peers();
     
     // Clear the hashmap
     hashmap_clear(&fpr_net.peers_map);
@@ -0,0 +1,489 @@
+/**
+ * @file fpr_aggregate.c
+ * @brief FPR In-Network Aggregation implementation
+ *
+ * Extender: unicast reports of a registered package ID, and merged frames
+ * built by extenders further down the path, are absorbed into a bucket per
+ * package ID and destination instead of being forwarded. A bucket is sent
+ * on as one FPR_PACKET_ID_AGGREGATE frame when its window ends, or for
+ * CONCAT when the next report no longer fits. Sink: merged frames are split
+ * back into reports and delivered like ordinary data.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_aggregate.h"
+#include "fpr/fpr_lts.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "esp_check.h"
+#include "esp_log.h"
+
+static const char *TAG = "fpr_aggregate";
+
+#define AGG fpr_net.aggregate
+
+extern esp_err_t _fpr_extender_forward(const fpr_package_t *package);
+
+static bool _is_reduce_op(uint8_t op)
+{
+    return op != FPR_AGGREGATE_CONCAT && op != FPR_AGGREGATE_CUSTOM;
+}
+
+// Bytes per record in the frame data
+static size_t _stride(const fpr_aggregate_header_t *header)
+{
+    return header->op == FPR_AGGREGATE_CONCAT ? MAC_ADDRESS_LENGTH + header->record_size : header->record_size;
+}
+
+static uint8_t _capacity(const fpr_aggregate_header_t *header)
+{
+    if (header->op != FPR_AGGREGATE_CONCAT) {
+        return 1;
+    }
+    size_t capacity = FPR_AGGREGATE_DATA_SIZE / _stride(header);
+    return capacity > UINT8_MAX ? UINT8_MAX : (uint8_t)capacity;
+}
+
+// Must be called with the lock held
+static fpr_aggregate_rule_t *_find_rule(fpr_package_id_t id)
+{
+    for (int i = 0; i < FPR_AGGREGATE_MAX_RULES; i++) {
+        if (AGG.rules[i].in_use && AGG.rules[i].id == id) {
+            return &AGG.rules[i];
+        }
+    }
+    return NULL;
+}
+
+// Must be called with the lock held
+static fpr_aggregate_bucket_t *_find_bucket(const fpr_aggregate_header_t *header, const uint8_t *dest)
+{
+    for (int i = 0; i < FPR_AGGREGATE_MAX_BUCKETS; i++) {
+        fpr_aggregate_bucket_t *bucket = &AGG.buckets[i];
+        if (bucket->in_use &&
+            bucket->frame.header.inner_id == header->inner_id &&
+            bucket->frame.header.op == header->op &&
+            bucket->frame.header.record_size == header->record_size &&
+            memcmp(bucket->dest, dest, MAC_ADDRESS_LENGTH) == 0) {
+            return bucket;
+        }
+    }
+    return NULL;
+}
+
+// Turn a package into a one-frame contribution; false if it is not ours to merge
+static bool _normalize(const fpr_package_t *package, fpr_aggregate_frame_t *in, fpr_aggregate_reduce_t *reduce, uint16_t *window_ms)
+{
+    bool is_frame = (package->id == FPR_PACKET_ID_AGGREGATE);
+    const fpr_aggregate_frame_t *frame = (const fpr_aggregate_frame_t *)&package->protocol;
+    fpr_package_id_t id = is_frame ? frame->header.inner_id : package->id;
+
+    taskENTER_CRITICAL(&AGG.lock);
+    fpr_aggregate_rule_t *rule = _find_rule(id);
+    fpr_aggregate_config_t config = rule != NULL ? rule->config : (fpr_aggregate_config_t){0};
+    taskEXIT_CRITICAL(&AGG.lock);
+    if (rule == NULL) {
+        return false;
+    }
+    *reduce = config.reduce;
+    *window_ms = config.window_ms;
+
+    if (is_frame) {
+        // Merged further down the path: only merge again under the same rule
+        if (frame->header.op != config.op || frame->header.record_size != config.record_size ||
+            frame->header.record_count == 0 || frame->header.record_count > _capacity(&frame->header)) {
+            return false;
+        }
+        memcpy(in, frame, sizeof(*in));
+        return true;
+    }
+
+    memset(in, 0, sizeof(*in));
+    in->header.inner_id = id;
+    in->header.op = (uint8_t)config.op;
+    in->header.record_size = config.record_size;
+    in->header.record_count = 1;
+    in->header.contributors = 1;
+    switch (config.op) {
+        case FPR_AGGREGATE_CONCAT:
+            memcpy(in->data, package->origin_mac, MAC_ADDRESS_LENGTH);
+            memcpy(in->data + MAC_ADDRESS_LENGTH, &package->protocol, config.record_size);
+            break;
+        case FPR_AGGREGATE_COUNT: {
+            int32_t one = 1;
+            memcpy(in->data, &one, sizeof(one));
+            break;
+        }
+        default:
+            memcpy(in->data, &package->protocol, config.record_size);
+            break;
+    }
+    return true;
+}
+
+static void _merge(fpr_aggregate_frame_t *acc, const fpr_aggregate_frame_t *in, fpr_aggregate_reduce_t reduce)
+{
+    fpr_aggregate_header_t *header = &acc->header;
+    uint32_t contributors = (uint32_t)header->contributors + in->header.contributors;
+    header->contributors = contributors > UINT16_MAX ? UINT16_MAX : (uint16_t)contributors;
+    if (in->header.delay_ms > header->delay_ms) {
+        header->delay_ms = in->header.delay_ms;
+    }
+
+    if (header->op == FPR_AGGREGATE_CONCAT) {
+        size_t stride = _stride(header);
+        memcpy(acc->data + header->record_count * stride, in->data, in->header.record_count * stride);
+        header->record_count += in->header.record_count;
+        return;
+    }
+    if (header->record_count == 0) {
+        memcpy(acc->data, in->data, header->record_size);
+        header->record_count = 1;
+        return;
+    }
+    if (header->op == FPR_AGGREGATE_CUSTOM) {
+        reduce(acc->data, in->data, header->record_size);
+        return;
+    }
+
+    int32_t a, b;
+    memcpy(&a, acc->data, sizeof(a));
+    memcpy(&b, in->data, sizeof(b));
+    switch (header->op) {
+        case FPR_AGGREGATE_MIN:
+            a = b < a ? b : a;
+            break;
+        case FPR_AGGREGATE_MAX:
+            a = b > a ? b : a;
+            break;
+        default:
+            // SUM, and COUNT whose records are partial counts
+            a = (int32_t)((uint32_t)a + (uint32_t)b);
+            break;
+    }
+    memcpy(acc->data, &a, sizeof(a));
+}
+
+static void _send(fpr_aggregate_frame_t *frame, const uint8_t *dest, int64_t first_us)
+{
+    uint32_t hold_ms = (uint32_t)((esp_timer_get_time() - first_us) / 1000);
+    uint32_t delay_ms = frame->header.delay_ms + hold_ms;
+    frame->header.delay_ms = delay_ms > UINT16_MAX ? UINT16_MAX : (uint16_t)delay_ms;
+
+    fpr_package_t package = {0};
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.id = FPR_PACKET_ID_AGGREGATE;
+    package.payload_size = (uint16_t)(sizeof(frame->header) + frame->header.record_count * _stride(&frame->header));
+    package.sequence_num = _fpr_next_sequence_num();
+    memcpy(&package.protocol, frame, sizeof(*frame));
+    memcpy(package.origin_mac, fpr_net.mac, MAC_ADDRESS_LENGTH);
+    memcpy(package.dest_mac, dest, MAC_ADDRESS_LENGTH);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    package.version = FPR_PROTOCOL_VERSION;
+
+    esp_err_t err = _fpr_extender_forward(&package);
+
+    taskENTER_CRITICAL(&AGG.lock);
+    if (err == ESP_OK) {
+        AGG.stats.frames_out++;
+        AGG.delay_sum_ms += hold_ms;
+        if (hold_ms > AGG.stats.max_delay_ms) {
+            AGG.stats.max_delay_ms = hold_ms;
+        }
+        AGG.stats.avg_delay_ms = (uint32_t)(AGG.delay_sum_ms / AGG.stats.frames_out);
+        AGG.stats.ratio_x100 = (uint32_t)((uint64_t)AGG.stats.reports_in * 100 / AGG.stats.frames_out);
+    } else {
+        AGG.stats.dropped++;
+    }
+    taskEXIT_CRITICAL(&AGG.lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No route for merged frame (id=%ld) to " MACSTR, (long)frame->header.inner_id, MAC2STR(dest));
+    }
+}
+
+// Send buckets whose window ended, or every bucket of *only_id. One bucket
+// is taken at a time so the timer task needs no copy of the whole table.
+static void _flush(const fpr_package_id_t *only_id)
+{
+    for (;;) {
+        fpr_aggregate_frame_t frame;
+        uint8_t dest[MAC_ADDRESS_LENGTH];
+        int64_t first_us = 0;
+        bool found = false;
+        int64_t now_us = esp_timer_get_time();
+
+        taskENTER_CRITICAL(&AGG.lock);
+        for (int i = 0; i < FPR_AGGREGATE_MAX_BUCKETS; i++) {
+            fpr_aggregate_bucket_t *bucket = &AGG.buckets[i];
+            if (!bucket->in_use || bucket->busy) {
+                continue;
+            }
+            bool due = only_id != NULL ? bucket->frame.header.inner_id == *only_id : now_us >= bucket->flush_us;
+            if (due) {
+                frame = bucket->frame;
+                memcpy(dest, bucket->dest, MAC_ADDRESS_LENGTH);
+                first_us = bucket->first_us;
+                bucket->in_use = false;
+                AGG.held--;
+                found = true;
+                break;
+            }
+        }
+        taskEXIT_CRITICAL(&AGG.lock);
+
+        if (!found) {
+            return;
+        }
+        _send(&frame, dest, first_us);
+    }
+}
+
+FPR_INSTANCE_TIMER_CB(_aggregate_timer_cb)
+{
+    if (!AGG.ready) {
+        return;
+    }
+    _flush(NULL);
+
+    taskENTER_CRITICAL(&AGG.lock);
+    bool idle = (AGG.held == 0);
+    taskEXIT_CRITICAL(&AGG.lock);
+    if (idle) {
+        esp_timer_stop(AGG.timer);
+        // A report may have been absorbed between the check and the stop
+        taskENTER_CRITICAL(&AGG.lock);
+        idle = (AGG.held == 0);
+        taskEXIT_CRITICAL(&AGG.lock);
+        if (!idle) {
+            esp_timer_start_periodic(AGG.timer, (uint64_t)FPR_AGGREGATE_TICK_MS * 1000);
+        }
+    }
+}
+
+bool _fpr_aggregate_absorb(const fpr_package_t *package)
+{
+    if (!AGG.ready || AGG.timer == NULL || package->package_type != FPR_PACKAGE_TYPE_SINGLE) {
+        return false;
+    }
+    if (package->id < 0 && package->id != FPR_PACKET_ID_AGGREGATE) {
+        return false;
+    }
+
+    fpr_aggregate_frame_t in;
+    fpr_aggregate_reduce_t reduce = NULL;
+    uint16_t window_ms = 0;
+    if (!_normalize(package, &in, &reduce, &window_ms)) {
+        return false;
+    }
+
+    fpr_aggregate_frame_t full;
+    uint8_t full_dest[MAC_ADDRESS_LENGTH];
+    int64_t full_first_us = 0;
+    bool have_full = false;
+    bool start_timer = false;
+    int64_t now_us = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&AGG.lock);
+    fpr_aggregate_bucket_t *bucket = _find_bucket(&in.header, package->dest_mac);
+    // Only CONCAT fills up; a reduce bucket holds one result until its window ends
+    if (bucket != NULL && in.header.op == FPR_AGGREGATE_CONCAT &&
+        bucket->frame.header.record_count + in.header.record_count > _capacity(&in.header)) {
+        // Full: send what is held and start over with this contribution
+        full = bucket->frame;
+        memcpy(full_dest, bucket->dest, MAC_ADDRESS_LENGTH);
+        full_first_us = bucket->first_us;
+        have_full = true;
+        bucket->first_us = now_us;
+        bucket->flush_us = now_us + (int64_t)window_ms * 1000;
+        bucket->frame.header.record_count = 0;
+        bucket->frame.header.contributors = 0;
+        bucket->frame.header.delay_ms = 0;
+    }
+    for (int i = 0; bucket == NULL && i < FPR_AGGREGATE_MAX_BUCKETS; i++) {
+        if (!AGG.buckets[i].in_use) {
+            bucket = &AGG.buckets[i];
+            bucket->in_use = true;
+            memcpy(bucket->dest, package->dest_mac, MAC_ADDRESS_LENGTH);
+            bucket->first_us = now_us;
+            bucket->flush_us = now_us + (int64_t)window_ms * 1000;
+            bucket->frame.header = in.header;
+            bucket->frame.header.record_count = 0;
+            bucket->frame.header.contributors = 0;
+            bucket->frame.header.delay_ms = 0;
+            start_timer = (AGG.held++ == 0);
+        }
+    }
+    if (bucket != NULL) {
+        bucket->busy = true;
+    }
+    taskEXIT_CRITICAL(&AGG.lock);
+
+    // No bucket left: forward unmerged
+    if (bucket == NULL) {
+        return false;
+    }
+
+    // A custom reduce function must not run inside the critical section
+    _merge(&bucket->frame, &in, reduce);
+
+    taskENTER_CRITICAL(&AGG.lock);
+    bucket->busy = false;
+    AGG.stats.frames_in++;
+    AGG.stats.reports_in += in.header.contributors;
+    taskEXIT_CRITICAL(&AGG.lock);
+
+    if (start_timer) {
+        // ESP_ERR_INVALID_STATE just means the timer is still running
+        esp_timer_start_periodic(AGG.timer, (uint64_t)FPR_AGGREGATE_TICK_MS * 1000);
+    }
+    if (have_full) {
+        _send(&full, full_dest, full_first_us);
+    }
+    return true;
+}
+
+void _fpr_aggregate_deliver(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package)
+{
+    const fpr_aggregate_frame_t *frame = (const fpr_aggregate_frame_t *)&package->protocol;
+    const fpr_aggregate_header_t *header = &frame->header;
+    size_t stride = _stride(header);
+
+    if (header->inner_id < 0 || header->record_size == 0 || stride > FPR_AGGREGATE_DATA_SIZE ||
+        header->record_count > _capacity(header)) {
+        #if (FPR_DEBUG == 1)
+        ESP_LOGW(TAG, "Dropping malformed merged frame from " MACSTR, MAC2STR(peer->peer_info.peer_addr));
+        #endif
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_MALFORMED, peer->peer_info.peer_addr, package);
+        return;
+    }
+
+    taskENTER_CRITICAL(&AGG.lock);
+    if (header->delay_ms > AGG.stats.sink_max_delay_ms) {
+        AGG.stats.sink_max_delay_ms = header->delay_ms;
+    }
+    taskEXIT_CRITICAL(&AGG.lock);
+
+    for (int i = 0; i < header->record_count; i++) {
+        const uint8_t *record = frame->data + i * stride;
+        fpr_package_t report = {0};
+        report.package_type = FPR_PACKAGE_TYPE_SINGLE;
+        report.id = header->inner_id;
+        report.payload_size = header->record_size;
+        report.sequence_num = package->sequence_num;
+        report.hop_count = package->hop_count;
+        report.max_hops = package->max_hops;
+        report.version = package->version;
+        memcpy(report.dest_mac, package->dest_mac, MAC_ADDRESS_LENGTH);
+        if (header->op == FPR_AGGREGATE_CONCAT) {
+            memcpy(report.origin_mac, record, MAC_ADDRESS_LENGTH);
+            record += MAC_ADDRESS_LENGTH;
+        } else {
+            // A reduced result has no single origin; it comes from the last extender
+            memcpy(report.origin_mac, package->origin_mac, MAC_ADDRESS_LENGTH);
+        }
+        memcpy(&report.protocol, record, header->record_size);
+        _deliver_as_origin(peer, &report);
+
+        taskENTER_CRITICAL(&AGG.lock);
+        AGG.stats.delivered++;
+        taskEXIT_CRITICAL(&AGG.lock);
+    }
+}
+
+void _fpr_aggregate_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package)
+{
+    _fpr_aggregate_deliver(peer, package);
+}
+
+void _fpr_aggregate_init(void)
+{
+    memset(&AGG, 0, sizeof(AGG));
+    portMUX_INITIALIZE(&AGG.lock);
+    const esp_timer_create_args_t timer_args = {
+        .callback = _aggregate_timer_cb,
+        .arg = &fpr_net,
+        .name = "fpr_aggregate"
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &AGG.timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create aggregation timer: %s", esp_err_to_name(err));
+        AGG.timer = NULL;
+    }
+    AGG.ready = true;
+}
+
+void _fpr_aggregate_deinit(void)
+{
+    AGG.ready = false;
+    if (AGG.timer != NULL) {
+        esp_timer_stop(AGG.timer);
+        esp_timer_delete(AGG.timer);
+        AGG.timer = NULL;
+    }
+}
+
+esp_err_t fpr_aggregate_register(fpr_package_id_t package_id, const fpr_aggregate_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(AGG.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    ESP_RETURN_ON_FALSE(package_id >= 0, ESP_ERR_INVALID_ARG, TAG, "Reserved package ID");
+    ESP_RETURN_ON_FALSE(config != NULL && config->op <= FPR_AGGREGATE_CUSTOM && config->window_ms > 0,
+                        ESP_ERR_INVALID_ARG, TAG, "Invalid aggregation rule");
+    ESP_RETURN_ON_FALSE(config->op != FPR_AGGREGATE_CUSTOM || config->reduce != NULL,
+                        ESP_ERR_INVALID_ARG, TAG, "Custom rule needs a reduce function");
+
+    fpr_aggregate_config_t rule_config = *config;
+    if (_is_reduce_op(config->op)) {
+        rule_config.record_size = sizeof(int32_t);
+    }
+    size_t stride = rule_config.op == FPR_AGGREGATE_CONCAT ? MAC_ADDRESS_LENGTH + rule_config.record_size : rule_config.record_size;
+    ESP_RETURN_ON_FALSE(rule_config.record_size > 0 && stride <= FPR_AGGREGATE_DATA_SIZE,
+                        ESP_ERR_INVALID_ARG, TAG, "Record size must be 1..%d", (int)(FPR_AGGREGATE_DATA_SIZE - MAC_ADDRESS_LENGTH));
+
+    taskENTER_CRITICAL(&AGG.lock);
+    fpr_aggregate_rule_t *rule = _find_rule(package_id);
+    for (int i = 0; rule == NULL && i < FPR_AGGREGATE_MAX_RULES; i++) {
+        if (!AGG.rules[i].in_use) {
+            rule = &AGG.rules[i];
+        }
+    }
+    if (rule != NULL) {
+        rule->in_use = true;
+        rule->id = package_id;
+        rule->config = rule_config;
+    }
+    taskEXIT_CRITICAL(&AGG.lock);
+
+    ESP_RETURN_ON_FALSE(rule != NULL, ESP_ERR_NO_MEM, TAG, "All %d aggregation rules in use", FPR_AGGREGATE_MAX_RULES);
+    return ESP_OK;
+}
+
+esp_err_t fpr_aggregate_unregister(fpr_package_id_t package_id)
+{
+    ESP_RETURN_ON_FALSE(AGG.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    taskENTER_CRITICAL(&AGG.lock);
+    fpr_aggregate_rule_t *rule = _find_rule(package_id);
+    if (rule != NULL) {
+        rule->in_use = false;
+    }
+    taskEXIT_CRITICAL(&AGG.lock);
+    ESP_RETURN_ON_FALSE(rule != NULL, ESP_ERR_NOT_FOUND, TAG, "No aggregation rule for id %ld", (long)package_id);
+
+    // A bucket being merged right now is sent by the timer once its window ends
+    _flush(&package_id);
+    return ESP_OK;
+}
+
+void fpr_aggregate_get_stats(fpr_aggregate_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&AGG.lock);
+    *stats = AGG.stats;
+    taskEXIT_CRITICAL(&AGG.lock);
+}
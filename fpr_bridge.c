@@ -0,0 +1,517 @@
+/**
+ * @file fpr_bridge.c
+ * @brief FPR Serial Bridge implementation
+ *
+ * Data packages reach _fpr_bridge_on_data() from the receive path and wait
+ * in a queue. The TX task packs as many as fit into one frame whenever
+ * Linux has window left, so records are batched under load and go out
+ * alone when traffic is light. The RX task reads the UART, splits frames
+ * at the 0x00 delimiters and hands records to fpr_network_send_to_peer().
+ * Only the TX task writes to the UART.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_bridge.h"
+#include "fpr/fpr_bridge_proto.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/helpers.h"
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include <string.h>
+
+#if (FPR_BRIDGE_ENABLE == 1)
+
+static const char *TAG = "fpr_bridge";
+
+#define BRIDGE_DEFAULT_BAUD 921600
+#define BRIDGE_DEFAULT_RX_BUFFER 8192
+#define BRIDGE_TX_BUFFER 4096
+#define BRIDGE_READ_CHUNK 256
+#define BRIDGE_READ_TIMEOUT_MS 50       // The RX task checks the stop flag this often
+#define BRIDGE_HELLO_RETRY_MS 1000      // Announce again until Linux answers
+#define BRIDGE_RECORD_MAX (sizeof(((fpr_package_t *)0)->protocol))
+#define BRIDGE_MIN_FRAME (sizeof(fpr_bridge_frame_header_t) + sizeof(fpr_bridge_record_t) + BRIDGE_RECORD_MAX + FPR_BRIDGE_CRC_LEN)
+
+#define BRIDGE_COUNT(field, n) __atomic_fetch_add(&s_bridge.stats.field, (n), __ATOMIC_RELAXED)
+
+// A record exactly as it goes into a DATA frame
+typedef struct {
+    fpr_bridge_record_t rec;
+    uint8_t data[BRIDGE_RECORD_MAX];
+} bridge_item_t;
+
+typedef struct {
+    volatile bool running;
+    uart_port_t port;
+    fpr_network_t *net;             // Instance being bridged
+    QueueHandle_t to_host;          // Kept across stop/start, like the hook that feeds it
+    SemaphoreHandle_t exited;       // Given once by each task
+    TaskHandle_t rx_task;
+    TaskHandle_t tx_task;
+
+    portMUX_TYPE lock;              // Link state below
+    bool connected;
+    bool hello_pending;             // Answer Linux's HELLO
+    uint8_t window;                 // DATA frames our UART buffer holds
+    uint8_t host_window;
+    uint16_t host_max_frame;
+    uint16_t tx_seq;                // Last DATA frame sent
+    uint16_t host_ack;              // Last DATA frame Linux released
+    uint16_t rx_seq;                // Last DATA frame from Linux, released once handled
+    uint16_t ack_sent;
+
+    fpr_bridge_stats_t stats;
+} fpr_bridge_state_t;
+
+static fpr_bridge_state_t s_bridge = { .lock = portMUX_INITIALIZER_UNLOCKED };
+
+// RX task only
+static uint8_t s_rx_chunk[BRIDGE_READ_CHUNK];
+static uint8_t s_rx_frame[FPR_BRIDGE_WIRE_MAX(FPR_BRIDGE_MAX_FRAME)];
+
+// TX task only
+static uint8_t s_tx_frame[FPR_BRIDGE_MAX_FRAME];
+static uint8_t s_tx_wire[FPR_BRIDGE_WIRE_MAX(FPR_BRIDGE_MAX_FRAME)];
+static bridge_item_t s_tx_pending;  // Taken from the queue but did not fit the last frame
+static bool s_tx_has_pending;
+
+// ========== RECEIVE PATH HOOK ==========
+
+void _fpr_bridge_on_data(const uint8_t *peer_mac, const fpr_package_t *package)
+{
+    if (!s_bridge.running || &fpr_net != s_bridge.net) {
+        return;
+    }
+    if (!s_bridge.connected) {
+        BRIDGE_COUNT(to_host_dropped, 1);
+        return;
+    }
+
+    bridge_item_t item;
+    size_t len = package->payload_size;
+    if (len == 0 || len > BRIDGE_RECORD_MAX) {
+        len = BRIDGE_RECORD_MAX; // Older senders leave payload_size at 0
+    }
+    memcpy(item.rec.addr, peer_mac, sizeof(item.rec.addr));
+    item.rec.id = (uint8_t)package->id;
+    item.rec.fragment = (uint8_t)package->package_type;
+    item.rec.len = (uint16_t)len;
+    memcpy(item.data, &package->protocol, len);
+
+    if (xQueueSend(s_bridge.to_host, &item, 0) != pdTRUE) {
+        BRIDGE_COUNT(to_host_dropped, 1);
+        return;
+    }
+    xTaskNotifyGive(s_bridge.tx_task);
+}
+
+// ========== TX TASK ==========
+
+static void _bridge_write_frame(fpr_bridge_frame_header_t *hdr, size_t len)
+{
+    taskENTER_CRITICAL(&s_bridge.lock);
+    if (hdr->type == FPR_BRIDGE_FRAME_DATA) {
+        hdr->seq = ++s_bridge.tx_seq;
+    }
+    hdr->ack = s_bridge.rx_seq;
+    s_bridge.ack_sent = s_bridge.rx_seq;
+    taskEXIT_CRITICAL(&s_bridge.lock);
+
+    memcpy(s_tx_frame, hdr, sizeof(*hdr));
+    size_t wire_len = fpr_bridge_frame_seal(s_tx_frame, len, s_tx_wire);
+    uart_write_bytes(s_bridge.port, s_tx_wire, wire_len);
+}
+
+static void _bridge_send_hello(bool reply)
+{
+    fpr_bridge_frame_header_t hdr = { .type = FPR_BRIDGE_FRAME_HELLO };
+    fpr_bridge_hello_t hello = {
+        .version = FPR_BRIDGE_PROTO_VERSION,
+        .flags = reply ? FPR_BRIDGE_HELLO_REPLY : 0,
+        .window = s_bridge.window,
+        .max_frame = FPR_BRIDGE_MAX_FRAME,
+    };
+    memcpy(s_tx_frame + sizeof(hdr), &hello, sizeof(hello));
+    _bridge_write_frame(&hdr, sizeof(hdr) + sizeof(hello));
+}
+
+// Pack queued records into one DATA frame; false when nothing was sent
+static bool _bridge_send_data(void)
+{
+    taskENTER_CRITICAL(&s_bridge.lock);
+    bool open = s_bridge.connected && (uint16_t)(s_bridge.tx_seq - s_bridge.host_ack) < s_bridge.host_window;
+    size_t limit = s_bridge.host_max_frame < FPR_BRIDGE_MAX_FRAME ? s_bridge.host_max_frame : FPR_BRIDGE_MAX_FRAME;
+    taskEXIT_CRITICAL(&s_bridge.lock);
+    if (!open) {
+        return false;
+    }
+
+    limit -= FPR_BRIDGE_CRC_LEN;
+    fpr_bridge_frame_header_t hdr = { .type = FPR_BRIDGE_FRAME_DATA };
+    size_t len = sizeof(hdr);
+    while (hdr.count < UINT8_MAX) {
+        if (!s_tx_has_pending) {
+            if (xQueueReceive(s_bridge.to_host, &s_tx_pending, 0) != pdTRUE) {
+                break;
+            }
+            s_tx_has_pending = true;
+        }
+        size_t size = sizeof(s_tx_pending.rec) + s_tx_pending.rec.len;
+        if (len + size > limit) {
+            break; // Opens the next frame
+        }
+        memcpy(s_tx_frame + len, &s_tx_pending, size);
+        len += size;
+        hdr.count++;
+        s_tx_has_pending = false;
+    }
+    if (hdr.count == 0) {
+        return false;
+    }
+
+    _bridge_write_frame(&hdr, len);
+    BRIDGE_COUNT(to_host_frames, 1);
+    BRIDGE_COUNT(to_host_records, hdr.count);
+    return true;
+}
+
+static void _bridge_tx_task(void *arg)
+{
+    (void)arg;
+    _fpr_instance_bind(s_bridge.net);
+
+    // Linux may already be listening
+    _bridge_send_hello(false);
+    while (s_bridge.running) {
+        bool connected = s_bridge.connected;
+        // Sleeps until there is something to send; only the HELLO retry is timed
+        bool woken = ulTaskNotifyTake(pdTRUE, connected ? portMAX_DELAY : pdMS_TO_TICKS(BRIDGE_HELLO_RETRY_MS)) > 0;
+        if (!s_bridge.running) {
+            break;
+        }
+
+        taskENTER_CRITICAL(&s_bridge.lock);
+        bool reply = s_bridge.hello_pending;
+        s_bridge.hello_pending = false;
+        connected = s_bridge.connected;
+        taskEXIT_CRITICAL(&s_bridge.lock);
+
+        if (reply) {
+            _bridge_send_hello(true);
+        } else if (!connected && !woken) {
+            _bridge_send_hello(false);
+        }
+
+        while (_bridge_send_data()) {
+        }
+
+        // Nothing to carry the acknowledgement; send it alone
+        taskENTER_CRITICAL(&s_bridge.lock);
+        bool ack = connected && s_bridge.rx_seq != s_bridge.ack_sent;
+        taskEXIT_CRITICAL(&s_bridge.lock);
+        if (ack) {
+            fpr_bridge_frame_header_t hdr = { .type = FPR_BRIDGE_FRAME_ACK };
+            _bridge_write_frame(&hdr, sizeof(hdr));
+        }
+    }
+
+    xSemaphoreGive(s_bridge.exited);
+    vTaskDelete(NULL);
+}
+
+// ========== RX TASK ==========
+
+static void _bridge_on_hello(const uint8_t *body, size_t len)
+{
+    fpr_bridge_hello_t hello;
+    if (len < sizeof(hello)) {
+        BRIDGE_COUNT(bad_frames, 1);
+        return;
+    }
+    memcpy(&hello, body, sizeof(hello));
+    if (hello.version != FPR_BRIDGE_PROTO_VERSION || hello.max_frame < BRIDGE_MIN_FRAME) {
+        ESP_LOGW(TAG, "Ignoring HELLO (version %u, max frame %u)", hello.version, hello.max_frame);
+        return;
+    }
+
+    bool restart = (hello.flags & FPR_BRIDGE_HELLO_REPLY) == 0;
+    taskENTER_CRITICAL(&s_bridge.lock);
+    s_bridge.host_window = hello.window != 0 ? hello.window : 1;
+    s_bridge.host_max_frame = hello.max_frame;
+    if (restart) {
+        // Linux (re)started: both directions count from 1 again
+        s_bridge.tx_seq = 0;
+        s_bridge.host_ack = 0;
+        s_bridge.rx_seq = 0;
+        s_bridge.ack_sent = 0;
+        s_bridge.hello_pending = true;
+    }
+    s_bridge.connected = true;
+    taskEXIT_CRITICAL(&s_bridge.lock);
+
+    if (restart) {
+        ESP_LOGI(TAG, "Linux connected (window %u, max frame %u)", hello.window, hello.max_frame);
+    }
+}
+
+static void _bridge_on_data(const fpr_bridge_frame_header_t *hdr, const uint8_t *body, size_t len)
+{
+    taskENTER_CRITICAL(&s_bridge.lock);
+    bool connected = s_bridge.connected;
+    int16_t gap = (int16_t)(hdr->seq - s_bridge.rx_seq - 1);
+    taskEXIT_CRITICAL(&s_bridge.lock);
+    if (!connected) {
+        return; // Not acknowledged; Linux sends it again after the HELLO exchange
+    }
+    if (gap > 0) {
+        BRIDGE_COUNT(lost_frames, (uint32_t)gap);
+    }
+
+    size_t off = 0;
+    for (uint8_t i = 0; i < hdr->count; i++) {
+        fpr_bridge_record_t rec;
+        if (len - off < sizeof(rec)) {
+            BRIDGE_COUNT(bad_frames, 1);
+            break;
+        }
+        memcpy(&rec, body + off, sizeof(rec));
+        off += sizeof(rec);
+        if (len - off < rec.len) {
+            BRIDGE_COUNT(bad_frames, 1);
+            break;
+        }
+        void *data = (void *)(body + off);
+        off += rec.len;
+
+        esp_err_t err = is_broadcast_address(rec.addr)
+                            ? fpr_network_broadcast(data, rec.len, (fpr_package_id_t)rec.id)
+                            : fpr_network_send_to_peer(rec.addr, data, rec.len, (fpr_package_id_t)rec.id);
+        if (err != ESP_OK) {
+            BRIDGE_COUNT(send_failures, 1);
+        }
+        BRIDGE_COUNT(from_host_records, 1);
+    }
+    BRIDGE_COUNT(from_host_frames, 1);
+
+    // Handled: release it to Linux
+    taskENTER_CRITICAL(&s_bridge.lock);
+    s_bridge.rx_seq = hdr->seq;
+    taskEXIT_CRITICAL(&s_bridge.lock);
+}
+
+static void _bridge_on_frame(size_t wire_len)
+{
+    int len = fpr_bridge_frame_open(s_rx_frame, wire_len);
+    if (len < 0) {
+        BRIDGE_COUNT(bad_frames, 1);
+        return;
+    }
+
+    fpr_bridge_frame_header_t hdr;
+    memcpy(&hdr, s_rx_frame, sizeof(hdr));
+    const uint8_t *body = s_rx_frame + sizeof(hdr);
+    size_t body_len = (size_t)len - sizeof(hdr);
+
+    switch (hdr.type) {
+    case FPR_BRIDGE_FRAME_HELLO:
+        _bridge_on_hello(body, body_len);
+        break;
+    case FPR_BRIDGE_FRAME_DATA:
+        _bridge_on_data(&hdr, body, body_len);
+        // fall through
+    case FPR_BRIDGE_FRAME_ACK:
+        taskENTER_CRITICAL(&s_bridge.lock);
+        if (s_bridge.connected) {
+            s_bridge.host_ack = hdr.ack;
+        }
+        taskEXIT_CRITICAL(&s_bridge.lock);
+        break;
+    default:
+        BRIDGE_COUNT(bad_frames, 1);
+        return;
+    }
+    // A reply, an acknowledgement or an opened window for the TX task
+    xTaskNotifyGive(s_bridge.tx_task);
+}
+
+static void _bridge_rx_task(void *arg)
+{
+    (void)arg;
+    _fpr_instance_bind(s_bridge.net);
+
+    size_t fill = 0;
+    bool overflow = false;
+    while (s_bridge.running) {
+        // Block for the first byte only, then take whatever is buffered
+        size_t avail = 0;
+        uart_get_buffered_data_len(s_bridge.port, &avail);
+        size_t want = avail == 0 ? 1 : (avail < sizeof(s_rx_chunk) ? avail : sizeof(s_rx_chunk));
+        int n = uart_read_bytes(s_bridge.port, s_rx_chunk, want, avail == 0 ? pdMS_TO_TICKS(BRIDGE_READ_TIMEOUT_MS) : 0);
+        if (n <= 0) {
+            continue;
+        }
+
+        const uint8_t *p = s_rx_chunk;
+        const uint8_t *end = s_rx_chunk + n;
+        while (p < end) {
+            const uint8_t *zero = memchr(p, 0x00, (size_t)(end - p));
+            size_t run = (size_t)((zero != NULL ? zero : end) - p);
+            if (!overflow && fill + run <= sizeof(s_rx_frame)) {
+                memcpy(s_rx_frame + fill, p, run);
+                fill += run;
+            } else {
+                overflow = true;
+            }
+            p += run;
+            if (zero != NULL) {
+                if (overflow) {
+                    BRIDGE_COUNT(bad_frames, 1);
+                } else if (fill > 0) {
+                    _bridge_on_frame(fill);
+                }
+                fill = 0;
+                overflow = false;
+                p++;
+            }
+        }
+    }
+
+    xSemaphoreGive(s_bridge.exited);
+    vTaskDelete(NULL);
+}
+
+// ========== PUBLIC API ==========
+
+esp_err_t fpr_bridge_start(const fpr_bridge_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(config != NULL, ESP_ERR_INVALID_ARG, TAG, "Config is NULL");
+    ESP_RETURN_ON_FALSE(!s_bridge.running, ESP_ERR_INVALID_STATE, TAG, "Bridge already running");
+    size_t rx_buffer = config->rx_buffer_size != 0 ? config->rx_buffer_size : BRIDGE_DEFAULT_RX_BUFFER;
+    ESP_RETURN_ON_FALSE(rx_buffer >= FPR_BRIDGE_WIRE_MAX(FPR_BRIDGE_MAX_FRAME), ESP_ERR_INVALID_ARG, TAG,
+                        "RX buffer must hold one frame (%d bytes)", FPR_BRIDGE_WIRE_MAX(FPR_BRIDGE_MAX_FRAME));
+
+    if (s_bridge.to_host == NULL) {
+        s_bridge.to_host = xQueueCreate(FPR_BRIDGE_QUEUE_LENGTH, sizeof(bridge_item_t));
+        s_bridge.exited = xSemaphoreCreateCounting(2, 0);
+        ESP_RETURN_ON_FALSE(s_bridge.to_host != NULL && s_bridge.exited != NULL, ESP_ERR_NO_MEM, TAG, "No memory for the bridge queue");
+    }
+    xQueueReset(s_bridge.to_host);
+
+    uart_port_t port = (uart_port_t)config->uart_port;
+    uart_config_t uart_config = {
+        .baud_rate = config->baud_rate != 0 ? config->baud_rate : BRIDGE_DEFAULT_BAUD,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = config->hw_flow_control ? UART_HW_FLOWCTRL_CTS_RTS : UART_HW_FLOWCTRL_DISABLE,
+        .rx_flow_ctrl_thresh = 100,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+    ESP_RETURN_ON_ERROR(uart_driver_install(port, (int)rx_buffer, BRIDGE_TX_BUFFER, 0, NULL, 0), TAG, "Failed to install the UART driver");
+    esp_err_t err = uart_param_config(port, &uart_config);
+    if (err == ESP_OK) {
+        err = uart_set_pin(port, config->tx_pin, config->rx_pin, config->rts_pin, config->cts_pin);
+    }
+    if (err != ESP_OK) {
+        uart_driver_delete(port);
+        ESP_LOGE(TAG, "Failed to configure UART %d: %s", port, esp_err_to_name(err));
+        return err;
+    }
+
+    size_t window = rx_buffer / FPR_BRIDGE_WIRE_MAX(FPR_BRIDGE_MAX_FRAME);
+    taskENTER_CRITICAL(&s_bridge.lock);
+    s_bridge.port = port;
+    s_bridge.net = &fpr_net;
+    s_bridge.window = (uint8_t)(window > UINT8_MAX ? UINT8_MAX : window);
+    s_bridge.connected = false;
+    s_bridge.hello_pending = false;
+    s_bridge.tx_seq = 0;
+    s_bridge.host_ack = 0;
+    s_bridge.rx_seq = 0;
+    s_bridge.ack_sent = 0;
+    memset(&s_bridge.stats, 0, sizeof(s_bridge.stats));
+    taskEXIT_CRITICAL(&s_bridge.lock);
+    s_tx_has_pending = false;
+
+    s_bridge.running = true;
+    if (xTaskCreate(_bridge_tx_task, "FPR_BridgeTx", FPR_TASK_STACK_SIZE, NULL, FPR_TASK_PRIORITY, &s_bridge.tx_task) != pdPASS) {
+        s_bridge.running = false;
+        uart_driver_delete(port);
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(_bridge_rx_task, "FPR_BridgeRx", FPR_TASK_STACK_SIZE, NULL, FPR_TASK_PRIORITY, &s_bridge.rx_task) != pdPASS) {
+        s_bridge.running = false;
+        xTaskNotifyGive(s_bridge.tx_task);
+        xSemaphoreTake(s_bridge.exited, portMAX_DELAY);
+        uart_driver_delete(port);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Bridge on UART %d at %d baud, window %u", port, uart_config.baud_rate, s_bridge.window);
+    return ESP_OK;
+}
+
+esp_err_t fpr_bridge_stop(void)
+{
+    if (!s_bridge.running) {
+        return ESP_OK;
+    }
+    s_bridge.running = false;
+    xTaskNotifyGive(s_bridge.tx_task);
+    xSemaphoreTake(s_bridge.exited, portMAX_DELAY);
+    xSemaphoreTake(s_bridge.exited, portMAX_DELAY);
+
+    taskENTER_CRITICAL(&s_bridge.lock);
+    s_bridge.connected = false;
+    taskEXIT_CRITICAL(&s_bridge.lock);
+    return uart_driver_delete(s_bridge.port);
+}
+
+bool fpr_bridge_is_connected(void)
+{
+    return s_bridge.running && s_bridge.connected;
+}
+
+void fpr_bridge_get_stats(fpr_bridge_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&s_bridge.lock);
+    *stats = s_bridge.stats;
+    taskEXIT_CRITICAL(&s_bridge.lock);
+}
+
+#else
+
+esp_err_t fpr_bridge_start(const fpr_bridge_config_t *config)
+{
+    (void)config;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t fpr_bridge_stop(void)
+{
+    return ESP_OK;
+}
+
+bool fpr_bridge_is_connected(void)
+{
+    return false;
+}
+
+void fpr_bridge_get_stats(fpr_bridge_stats_t *stats)
+{
+    if (stats != NULL) {
+        memset(stats, 0, sizeof(*stats));
+    }
+}
+
+#endif
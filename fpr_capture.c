@@ -0,0 +1,214 @@
+/**
+ * @file fpr_capture.c
+ * @brief FPR Packet Capture implementation
+ *
+ * Frames reach _fpr_capture_frame() from _fpr_radio_send() and from the
+ * receive trampoline in fpr.c. A mutex keeps each pcap record contiguous
+ * in the sink when several tasks send at once.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_capture.h"
+#include "fpr/internal/helpers.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include <stdio.h>
+#include <string.h>
+
+#if (FPR_CAPTURE_ENABLE == 1)
+
+static const char *TAG = "fpr_capture";
+
+#define CAPTURE_LOCK_WAIT_MS 5
+#define CAPTURE_CONSOLE_LINE 64
+
+_Static_assert(sizeof(fpr_capture_header_t) == 16, "fpr_capture_header_t is a file format");
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version_major;
+    uint16_t version_minor;
+    int32_t thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t linktype;
+} pcap_file_header_t;
+
+typedef struct {
+    uint32_t ts_sec;
+    uint32_t ts_usec;
+    uint32_t incl_len;
+    uint32_t orig_len;
+} pcap_record_header_t;
+
+// Not part of fpr_net: a capture may span fpr_network_deinit()/init
+static SemaphoreHandle_t s_lock;
+static fpr_capture_write_fn_t s_write;
+static void *s_ctx;
+static fpr_capture_stats_t s_stats;
+
+void _fpr_capture_frame(fpr_capture_direction_t direction, const uint8_t *src, const uint8_t *dst,
+                        int8_t rssi, uint8_t channel, const void *frame, size_t len)
+{
+    if (__atomic_load_n(&s_write, __ATOMIC_ACQUIRE) == NULL) {
+        return;
+    }
+    if (xSemaphoreTake(s_lock, pdMS_TO_TICKS(CAPTURE_LOCK_WAIT_MS)) != pdTRUE) {
+        __atomic_fetch_add(&s_stats.skipped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    if (s_write == NULL) {
+        xSemaphoreGive(s_lock);
+        return;
+    }
+
+    if (channel == 0) {
+        wifi_second_chan_t second;
+        esp_wifi_get_channel(&channel, &second);
+    }
+    fpr_capture_header_t meta = {
+        .version = FPR_CAPTURE_VERSION,
+        .direction = (uint8_t)direction,
+        .rssi = rssi,
+        .channel = channel,
+    };
+    memcpy(meta.src, src, sizeof(meta.src));
+    memcpy(meta.dst, dst, sizeof(meta.dst));
+
+    int64_t now = esp_timer_get_time();
+    pcap_record_header_t rec = {
+        .ts_sec = (uint32_t)(now / 1000000),
+        .ts_usec = (uint32_t)(now % 1000000),
+        .incl_len = (uint32_t)(sizeof(meta) + len),
+        .orig_len = (uint32_t)(sizeof(meta) + len),
+    };
+
+    esp_err_t err = s_write(&rec, sizeof(rec), s_ctx);
+    if (err == ESP_OK) {
+        err = s_write(&meta, sizeof(meta), s_ctx);
+    }
+    if (err == ESP_OK) {
+        err = s_write(frame, len, s_ctx);
+    }
+    if (err == ESP_OK) {
+        s_stats.captured++;
+    } else {
+        // A partial record corrupts the rest of the stream, so stop here
+        __atomic_fetch_add(&s_stats.skipped, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&s_write, NULL, __ATOMIC_RELEASE);
+        ESP_LOGW(TAG, "Capture sink failed (%s), capture stopped", esp_err_to_name(err));
+    }
+    xSemaphoreGive(s_lock);
+}
+
+esp_err_t fpr_capture_start(fpr_capture_write_fn_t write, void *ctx)
+{
+    if (write == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_lock == NULL) {
+        s_lock = xSemaphoreCreateMutex();
+        if (s_lock == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (s_write != NULL) {
+        xSemaphoreGive(s_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    pcap_file_header_t header = {
+        .magic = 0xA1B2C3D4,
+        .version_major = 2,
+        .version_minor = 4,
+        .snaplen = sizeof(fpr_capture_header_t) + sizeof(fpr_package_t),
+        .linktype = FPR_CAPTURE_LINKTYPE,
+    };
+    esp_err_t err = write(&header, sizeof(header), ctx);
+    if (err == ESP_OK) {
+        memset(&s_stats, 0, sizeof(s_stats));
+        s_ctx = ctx;
+        __atomic_store_n(&s_write, write, __ATOMIC_RELEASE);
+    }
+    xSemaphoreGive(s_lock);
+    return err;
+}
+
+static esp_err_t _console_write(const void *data, size_t size, void *ctx)
+{
+    (void)ctx;
+    const uint8_t *bytes = (const uint8_t *)data;
+    while (size > 0) {
+        size_t n = size < CAPTURE_CONSOLE_LINE ? size : CAPTURE_CONSOLE_LINE;
+        printf("FPRC ");
+        for (size_t i = 0; i < n; i++) {
+            printf("%02x", bytes[i]);
+        }
+        printf("\n");
+        bytes += n;
+        size -= n;
+    }
+    return ESP_OK;
+}
+
+esp_err_t fpr_capture_start_console(void)
+{
+    printf("FPRC BEGIN\n");
+    return fpr_capture_start(_console_write, NULL);
+}
+
+void fpr_capture_stop(void)
+{
+    if (s_lock == NULL) {
+        return;
+    }
+    // Waits for a frame being written to finish
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    bool console = (s_write == _console_write);
+    __atomic_store_n(&s_write, NULL, __ATOMIC_RELEASE);
+    s_ctx = NULL;
+    xSemaphoreGive(s_lock);
+    if (console) {
+        printf("FPRC END\n");
+    }
+}
+
+void fpr_capture_get_stats(fpr_capture_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    stats->captured = __atomic_load_n(&s_stats.captured, __ATOMIC_RELAXED);
+    stats->skipped = __atomic_load_n(&s_stats.skipped, __ATOMIC_RELAXED);
+}
+
+#else
+
+esp_err_t fpr_capture_start(fpr_capture_write_fn_t write, void *ctx)
+{
+    (void)write;
+    (void)ctx;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t fpr_capture_start_console(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void fpr_capture_stop(void)
+{
+}
+
+void fpr_capture_get_stats(fpr_capture_stats_t *stats)
+{
+    if (stats != NULL) {
+        memset(stats, 0, sizeof(*stats));
+    }
+}
+
+#endif
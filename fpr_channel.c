@@ -0,0 +1,545 @@
+/**
+ * @file fpr_channel.c
+ * @brief FPR Coordinated Channel Migration implementation
+ *
+ * Host: counts transmit results, NO_MEM errors and receive RSSI/noise per
+ * evaluation window, remembers how bad each channel was while in use, and
+ * announces a switch in its beacons once the current channel stays
+ * congested. Client: follows the announcement and switches at the same
+ * instant. Both sides measure the downtime until they hear each other again.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_channel.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_wifi.h"
+
+static const char *TAG = "fpr_channel";
+
+#define CHAN fpr_net.chan
+
+#define FPR_CHANNEL_MIN_SAMPLES     8   // Sends per window before the failure rate counts
+#define FPR_CHANNEL_ANNOUNCEMENTS   5   // Beacons per switch announcement
+#define FPR_CHANNEL_LEAD_BEACONS    3   // Minimum lead time in beacon periods
+
+static const uint8_t default_candidates[] = {1, 6, 11};
+
+static bool _valid_channel(uint8_t channel)
+{
+    return channel >= 1 && channel <= FPR_CHANNEL_MAX;
+}
+
+static uint8_t _popcount(fpr_peer_bitmap_t bits)
+{
+    uint8_t count = 0;
+    for (; bits != 0; bits &= bits - 1) {
+        count++;
+    }
+    return count;
+}
+
+// Switch the radio and bookkeeping to a new channel
+static esp_err_t _apply_channel(uint8_t channel)
+{
+    esp_err_t err = esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to switch to channel %u: %s", channel, esp_err_to_name(err));
+        return err;
+    }
+    fpr_net.channel = channel;
+    return ESP_OK;
+}
+
+// Must be called with the lock held
+static void _reset_window(void)
+{
+    CHAN.tx_ok = 0;
+    CHAN.tx_fail = 0;
+    CHAN.no_mem = 0;
+    CHAN.rssi_sum = 0;
+    CHAN.noise_sum = 0;
+    CHAN.rx_count = 0;
+}
+
+// ========== HOST ==========
+
+// Lead time for an announcement. Beacons driven by TDMA or sleepy clients
+// may be slower than the announcement rate, so give them a few periods.
+static uint32_t _host_lead_ms(void)
+{
+    uint32_t lead_ms = FPR_CHANNEL_SWITCH_DELAY_MS;
+    uint32_t period_us = _fpr_tdma_beacon_period_us();
+    if (period_us == 0) {
+        period_us = _fpr_sleepy_beacon_period_us();
+    }
+    uint32_t beacon_lead_ms = (period_us / 1000) * FPR_CHANNEL_LEAD_BEACONS;
+    return beacon_lead_ms > lead_ms ? beacon_lead_ms : lead_ms;
+}
+
+static void _host_finish_switch(void)
+{
+    taskENTER_CRITICAL(&CHAN.lock);
+    uint8_t lost = _popcount(CHAN.awaiting);
+    CHAN.status.clients_lost += lost;
+    CHAN.awaiting = 0;
+    CHAN.switched_at_us = 0;
+    taskEXIT_CRITICAL(&CHAN.lock);
+
+    if (lost > 0) {
+        ESP_LOGW(TAG, "%u client(s) did not follow the channel switch", lost);
+    }
+}
+
+static esp_err_t _host_announce(uint8_t channel)
+{
+    uint32_t lead_ms = _host_lead_ms();
+
+    taskENTER_CRITICAL(&CHAN.lock);
+    if (CHAN.status.pending_channel != 0) {
+        taskEXIT_CRITICAL(&CHAN.lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    CHAN.status.pending_channel = channel;
+    CHAN.switch_at_us = esp_timer_get_time() + (int64_t)lead_ms * 1000;
+    taskEXIT_CRITICAL(&CHAN.lock);
+
+    // Close the reconnect window of the previous switch before reusing the timer
+    if (esp_timer_is_active(CHAN.switch_timer)) {
+        esp_timer_stop(CHAN.switch_timer);
+        _host_finish_switch();
+    }
+    esp_timer_start_once(CHAN.switch_timer, (uint64_t)lead_ms * 1000);
+    _fpr_beacon_refresh();
+
+    ESP_LOGI(TAG, "Moving network from channel %u to %u in %lu ms",
+             _fpr_get_current_channel(), channel, (unsigned long)lead_ms);
+    return ESP_OK;
+}
+
+static void _host_switch(uint8_t channel, int64_t now)
+{
+    // Every connected client has to be heard again on the new channel
+    fpr_peer_bitmap_t connected = 0;
+    for (uint8_t slot = 0; slot < FPR_MAX_PEER_SLOTS; slot++) {
+        FPR_STORE_HASH_TYPE *peer = _get_peer_by_slot(slot);
+        if (peer != NULL && peer->is_connected) {
+            connected |= FPR_PEER_BIT(slot);
+        }
+    }
+
+    esp_err_t err = _apply_channel(channel);
+
+    taskENTER_CRITICAL(&CHAN.lock);
+    CHAN.status.pending_channel = 0;
+    CHAN.switch_at_us = 0;
+    if (err == ESP_OK) {
+        CHAN.awaiting = connected;
+        CHAN.switched_at_us = now;
+        CHAN.status.migrations++;
+        CHAN.status.last_downtime_ms = 0;
+        CHAN.status.channel = channel;
+        CHAN.status.congested_windows = 0;
+        _reset_window();
+    }
+    taskEXIT_CRITICAL(&CHAN.lock);
+
+    _fpr_beacon_refresh();
+    if (err == ESP_OK && connected != 0) {
+        // Second phase: count the clients that never came back
+        esp_timer_start_once(CHAN.switch_timer, (uint64_t)FPR_RECONNECT_TIMEOUT_MS * 1000);
+    }
+}
+
+static uint8_t _host_pick_channel(uint8_t current)
+{
+    const uint8_t *candidates = CHAN.config.candidates;
+    uint8_t count = CHAN.config.candidate_count;
+    if (count == 0) {
+        candidates = default_candidates;
+        count = sizeof(default_candidates);
+    }
+
+    uint8_t best = 0;
+    uint8_t best_badness = UINT8_MAX;
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t ch = candidates[i];
+        if (!_valid_channel(ch) || ch == current) {
+            continue;
+        }
+        // Untried channels read 0 and win; ties go to the earlier candidate
+        if (best == 0 || CHAN.badness[ch] < best_badness) {
+            best = ch;
+            best_badness = CHAN.badness[ch];
+        }
+    }
+    return best;
+}
+
+FPR_INSTANCE_TIMER_CB(_host_eval_cb)
+{
+    uint8_t current = _fpr_get_current_channel();
+    if (!_valid_channel(current)) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&CHAN.lock);
+    uint32_t failed = CHAN.tx_fail + CHAN.no_mem;
+    uint32_t total = CHAN.tx_ok + failed;
+    uint8_t failure_pct = total > 0 ? (uint8_t)((failed * 100) / total) : 0;
+    int8_t avg_rssi = CHAN.rx_count > 0 ? (int8_t)(CHAN.rssi_sum / (int32_t)CHAN.rx_count) : 0;
+    int8_t avg_noise = CHAN.rx_count > 0 ? (int8_t)(CHAN.noise_sum / (int32_t)CHAN.rx_count) : 0;
+
+    bool congested = (total >= FPR_CHANNEL_MIN_SAMPLES && failure_pct >= CHAN.config.max_failure_pct) ||
+                     (CHAN.rx_count > 0 && avg_noise >= CHAN.config.max_noise_dbm);
+
+    // Failure rate plus 2 points per dB of excess noise, never 0 once measured
+    int badness = failure_pct;
+    if (CHAN.rx_count > 0 && avg_noise > CHAN.config.max_noise_dbm - 10) {
+        badness += (avg_noise - (CHAN.config.max_noise_dbm - 10)) * 2;
+    }
+    if (badness < 1) {
+        badness = 1;
+    }
+    if (badness > UINT8_MAX) {
+        badness = UINT8_MAX;
+    }
+    if (total > 0 || CHAN.rx_count > 0) {
+        CHAN.badness[current] = (uint8_t)badness;
+    }
+    // Old measurements of other channels fade so they are retried eventually
+    for (uint8_t ch = 1; ch <= FPR_CHANNEL_MAX; ch++) {
+        if (ch != current && CHAN.badness[ch] > 0) {
+            CHAN.badness[ch] -= CHAN.badness[ch] / 8 + 1;
+        }
+    }
+
+    CHAN.status.channel = current;
+    CHAN.status.failure_pct = failure_pct;
+    CHAN.status.no_mem = CHAN.no_mem;
+    CHAN.status.avg_rssi = avg_rssi;
+    CHAN.status.avg_noise = avg_noise;
+    if (congested) {
+        if (CHAN.status.congested_windows < UINT8_MAX) {
+            CHAN.status.congested_windows++;
+        }
+    } else {
+        CHAN.status.congested_windows = 0;
+    }
+    bool migrate = CHAN.status.congested_windows >= CHAN.config.bad_windows && CHAN.status.pending_channel == 0;
+    _reset_window();
+    taskEXIT_CRITICAL(&CHAN.lock);
+
+    #if (FPR_DEBUG == 1)
+    ESP_LOGI(TAG, "Channel %u: %u%% failures of %lu, noise %d dBm, rssi %d dBm%s",
+             current, failure_pct, (unsigned long)total, avg_noise, avg_rssi, congested ? " (congested)" : "");
+    #endif
+
+    if (!migrate) {
+        return;
+    }
+    uint8_t target = _host_pick_channel(current);
+    if (target == 0) {
+        ESP_LOGW(TAG, "Channel %u is congested but no other candidate is configured", current);
+        return;
+    }
+    _host_announce(target);
+}
+
+uint32_t _fpr_channel_beacon_period_us(void)
+{
+    if (!CHAN.ready || fpr_net.current_mode != FPR_MODE_HOST || CHAN.status.pending_channel == 0) {
+        return 0;
+    }
+    return (uint32_t)FPR_CHANNEL_SWITCH_DELAY_MS * 1000 / FPR_CHANNEL_ANNOUNCEMENTS;
+}
+
+void _fpr_channel_fill_beacon(fpr_beacon_frame_t *beacon)
+{
+    if (!CHAN.ready) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&CHAN.lock);
+    uint8_t target = CHAN.status.pending_channel;
+    int64_t switch_at_us = CHAN.switch_at_us;
+    taskEXIT_CRITICAL(&CHAN.lock);
+
+    if (target == 0) {
+        return;
+    }
+    int64_t remaining_us = switch_at_us - esp_timer_get_time();
+    if (remaining_us < 0) {
+        remaining_us = 0;
+    }
+    int64_t remaining_ms = remaining_us / 1000;
+    beacon->switch_channel = target;
+    beacon->switch_in_ms = remaining_ms > UINT16_MAX ? UINT16_MAX : (uint16_t)remaining_ms;
+}
+
+// ========== CLIENT ==========
+
+void _fpr_channel_on_beacon(FPR_STORE_HASH_TYPE *peer, const fpr_beacon_frame_t *beacon, int64_t rx_time_us)
+{
+    if (!CHAN.ready || fpr_net.current_mode != FPR_MODE_CLIENT || !peer->is_connected) {
+        return;
+    }
+    if (!_valid_channel(beacon->switch_channel) || beacon->switch_channel == _fpr_get_current_channel()) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&CHAN.lock);
+    bool armed = CHAN.status.pending_channel != 0;
+    if (!armed) {
+        CHAN.status.pending_channel = beacon->switch_channel;
+        CHAN.switch_at_us = rx_time_us + (int64_t)beacon->switch_in_ms * 1000;
+        memcpy(CHAN.host_mac, peer->peer_info.peer_addr, MAC_ADDRESS_LENGTH);
+    }
+    taskEXIT_CRITICAL(&CHAN.lock);
+
+    if (armed) {
+        return;
+    }
+    int64_t delay_us = rx_time_us + (int64_t)beacon->switch_in_ms * 1000 - esp_timer_get_time();
+    esp_timer_stop(CHAN.switch_timer);
+    esp_timer_start_once(CHAN.switch_timer, delay_us > 0 ? (uint64_t)delay_us : 1);
+    ESP_LOGI(TAG, "Host %s moves to channel %u in %u ms", peer->name, beacon->switch_channel, beacon->switch_in_ms);
+}
+
+static void _client_switch(uint8_t channel, int64_t now)
+{
+    esp_err_t err = _apply_channel(channel);
+
+    taskENTER_CRITICAL(&CHAN.lock);
+    CHAN.status.pending_channel = 0;
+    CHAN.switch_at_us = 0;
+    if (err == ESP_OK) {
+        CHAN.switched_at_us = now;
+        CHAN.status.migrations++;
+        CHAN.status.channel = channel;
+    }
+    taskEXIT_CRITICAL(&CHAN.lock);
+}
+
+// ========== SHARED HOOKS ==========
+
+FPR_INSTANCE_TIMER_CB(_switch_cb)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&CHAN.lock);
+    uint8_t target = CHAN.status.pending_channel;
+    taskEXIT_CRITICAL(&CHAN.lock);
+
+    if (target == 0) {
+        // Host only: reconnect window after a switch has passed
+        _host_finish_switch();
+    } else if (fpr_net.current_mode == FPR_MODE_HOST) {
+        _host_switch(target, now);
+    } else {
+        _client_switch(target, now);
+    }
+}
+
+void _fpr_channel_on_rx(const esp_now_recv_info_t *esp_now_info)
+{
+    if (!CHAN.ready) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    FPR_STORE_HASH_TYPE *peer = NULL;
+    if (CHAN.switched_at_us != 0 && fpr_net.current_mode == FPR_MODE_HOST) {
+        peer = _get_peer_from_map(esp_now_info->src_addr);
+    }
+
+    taskENTER_CRITICAL(&CHAN.lock);
+    if (CHAN.eval_timer != NULL && CHAN.status.monitoring) {
+        CHAN.rssi_sum += esp_now_info->rx_ctrl->rssi;
+        CHAN.noise_sum += esp_now_info->rx_ctrl->noise_floor;
+        CHAN.rx_count++;
+    }
+    if (CHAN.switched_at_us != 0) {
+        uint32_t elapsed_ms = (uint32_t)US_TO_MS(now - CHAN.switched_at_us);
+        if (fpr_net.current_mode == FPR_MODE_HOST) {
+            if (peer != NULL && peer->slot < FPR_MAX_PEER_SLOTS && (CHAN.awaiting & FPR_PEER_BIT(peer->slot))) {
+                CHAN.awaiting &= ~FPR_PEER_BIT(peer->slot);
+                // Downtime of the network is set by the slowest client
+                CHAN.status.last_downtime_ms = elapsed_ms;
+            }
+        } else if (memcmp(esp_now_info->src_addr, CHAN.host_mac, MAC_ADDRESS_LENGTH) == 0) {
+            CHAN.status.last_downtime_ms = elapsed_ms;
+            CHAN.switched_at_us = 0;
+        }
+    }
+    taskEXIT_CRITICAL(&CHAN.lock);
+}
+
+void _fpr_channel_on_send_queued(esp_err_t err)
+{
+    if (!CHAN.ready || !_fpr_transport_is_full(err)) {
+        return;
+    }
+    taskENTER_CRITICAL(&CHAN.lock);
+    CHAN.no_mem++;
+    taskEXIT_CRITICAL(&CHAN.lock);
+}
+
+void _fpr_channel_on_send_status(bool success)
+{
+    if (!CHAN.ready) {
+        return;
+    }
+    taskENTER_CRITICAL(&CHAN.lock);
+    if (success) {
+        CHAN.tx_ok++;
+    } else {
+        CHAN.tx_fail++;
+    }
+    taskEXIT_CRITICAL(&CHAN.lock);
+}
+
+void _fpr_channel_on_peer_disconnected(FPR_STORE_HASH_TYPE *peer)
+{
+    if (!CHAN.ready || peer->slot >= FPR_MAX_PEER_SLOTS) {
+        return;
+    }
+    taskENTER_CRITICAL(&CHAN.lock);
+    if (CHAN.awaiting & FPR_PEER_BIT(peer->slot)) {
+        CHAN.awaiting &= ~FPR_PEER_BIT(peer->slot);
+        CHAN.status.clients_lost++;
+    }
+    taskEXIT_CRITICAL(&CHAN.lock);
+}
+
+void _fpr_channel_init(void)
+{
+    memset(&CHAN, 0, sizeof(CHAN));
+    portMUX_INITIALIZE(&CHAN.lock);
+    CHAN.config = fpr_channel_default_config();
+
+    const esp_timer_create_args_t eval_args = {
+        .callback = _host_eval_cb,
+        .arg = &fpr_net,
+        .name = "fpr_chan_eval"
+    };
+    esp_err_t err = esp_timer_create(&eval_args, &CHAN.eval_timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create evaluation timer: %s", esp_err_to_name(err));
+        CHAN.eval_timer = NULL;
+    }
+
+    const esp_timer_create_args_t switch_args = {
+        .callback = _switch_cb,
+        .arg = &fpr_net,
+        .name = "fpr_chan_switch"
+    };
+    err = esp_timer_create(&switch_args, &CHAN.switch_timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create switch timer: %s", esp_err_to_name(err));
+        CHAN.switch_timer = NULL;
+    }
+    CHAN.ready = true;
+}
+
+void _fpr_channel_deinit(void)
+{
+    CHAN.ready = false;
+    CHAN.status.monitoring = false;
+    if (CHAN.eval_timer != NULL) {
+        esp_timer_stop(CHAN.eval_timer);
+        esp_timer_delete(CHAN.eval_timer);
+        CHAN.eval_timer = NULL;
+    }
+    if (CHAN.switch_timer != NULL) {
+        esp_timer_stop(CHAN.switch_timer);
+        esp_timer_delete(CHAN.switch_timer);
+        CHAN.switch_timer = NULL;
+    }
+}
+
+// ========== PUBLIC API ==========
+
+fpr_channel_config_t fpr_channel_default_config(void)
+{
+    fpr_channel_config_t config = {
+        .candidate_count = 0,
+        .max_failure_pct = 30,
+        .max_noise_dbm = -75,
+        .bad_windows = 3
+    };
+    return config;
+}
+
+esp_err_t fpr_channel_monitor_start(const fpr_channel_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(CHAN.ready && CHAN.eval_timer != NULL, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    ESP_RETURN_ON_FALSE(fpr_net.current_mode == FPR_MODE_HOST, ESP_ERR_INVALID_STATE, TAG, "Channel monitoring requires host mode");
+
+    fpr_channel_config_t cfg = config ? *config : fpr_channel_default_config();
+    ESP_RETURN_ON_FALSE(cfg.bad_windows >= 1 && cfg.max_failure_pct <= 100, ESP_ERR_INVALID_ARG, TAG, "Invalid channel config");
+    ESP_RETURN_ON_FALSE(cfg.candidate_count <= sizeof(cfg.candidates), ESP_ERR_INVALID_ARG, TAG, "Too many candidate channels");
+    for (uint8_t i = 0; i < cfg.candidate_count; i++) {
+        ESP_RETURN_ON_FALSE(_valid_channel(cfg.candidates[i]), ESP_ERR_INVALID_ARG, TAG, "Invalid candidate channel %u", cfg.candidates[i]);
+    }
+
+    taskENTER_CRITICAL(&CHAN.lock);
+    CHAN.config = cfg;
+    CHAN.status.monitoring = true;
+    CHAN.status.congested_windows = 0;
+    CHAN.status.channel = _fpr_get_current_channel();
+    _reset_window();
+    taskEXIT_CRITICAL(&CHAN.lock);
+
+    esp_timer_stop(CHAN.eval_timer);
+    esp_timer_start_periodic(CHAN.eval_timer, (uint64_t)FPR_CHANNEL_EVAL_INTERVAL_MS * 1000);
+    ESP_LOGI(TAG, "Channel monitoring started on channel %u", CHAN.status.channel);
+    return ESP_OK;
+}
+
+esp_err_t fpr_channel_monitor_stop(void)
+{
+    ESP_RETURN_ON_FALSE(CHAN.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    taskENTER_CRITICAL(&CHAN.lock);
+    CHAN.status.monitoring = false;
+    taskEXIT_CRITICAL(&CHAN.lock);
+
+    if (CHAN.eval_timer != NULL) {
+        esp_timer_stop(CHAN.eval_timer);
+    }
+    return ESP_OK;
+}
+
+esp_err_t fpr_channel_migrate(uint8_t channel)
+{
+    ESP_RETURN_ON_FALSE(CHAN.ready && CHAN.switch_timer != NULL, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    ESP_RETURN_ON_FALSE(fpr_net.current_mode == FPR_MODE_HOST, ESP_ERR_INVALID_STATE, TAG, "Channel migration requires host mode");
+    ESP_RETURN_ON_FALSE(_valid_channel(channel), ESP_ERR_INVALID_ARG, TAG, "Invalid channel %u", channel);
+    ESP_RETURN_ON_FALSE(channel != _fpr_get_current_channel(), ESP_ERR_INVALID_ARG, TAG, "Already on channel %u", channel);
+
+    esp_err_t err = _host_announce(channel);
+    ESP_RETURN_ON_FALSE(err == ESP_OK, err, TAG, "A channel switch is already pending");
+    return ESP_OK;
+}
+
+void fpr_channel_get_status(fpr_channel_status_t *status)
+{
+    if (status == NULL) {
+        return;
+    }
+    if (!CHAN.ready) {
+        memset(status, 0, sizeof(*status));
+        return;
+    }
+    taskENTER_CRITICAL(&CHAN.lock);
+    *status = CHAN.status;
+    taskEXIT_CRITICAL(&CHAN.lock);
+    if (status->channel == 0) {
+        status->channel = _fpr_get_current_channel();
+    }
+}
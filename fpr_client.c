@@ -12,9 +12,13 @@
 #include "fpr/fpr_client.h"
 #include "fpr/fpr_security.h"
 #include "fpr/fpr_security_handshake.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/scheduler.h"
 #include "esp_timer.h"
+#include "esp_wifi.h"
 #include "esp_log.h"
 #include "esp_check.h"
+#include <limits.h>
 
 typedef struct {
     uint8_t mac[MAC_ADDRESS_LENGTH];
@@ -32,16 +36,22 @@ typedef struct {
 
 static const char *TAG = "fpr_client";
 
+#define SELECT fpr_net.select
+#define STANDBY fpr_net.standby
+
 extern esp_err_t fpr_network_send_device_info(uint8_t *peer_address);
 extern fpr_connect_t make_fpr_info_with_keys(bool include_pwk, bool include_lwk, const uint8_t *pwk, const uint8_t *lwk);
 extern esp_err_t fpr_network_send_to_peer(uint8_t *peer_address, void *data, int size, fpr_package_id_t package_id);
+extern esp_err_t fpr_network_broadcast(void *data, int size, fpr_package_id_t package_id);
+extern esp_err_t fpr_client_get_host_info(uint8_t *mac_out, char *name_out, size_t name_size);
+extern esp_err_t fpr_client_disconnect(void);
 
 static void _check_connected_callback(void *key, void *value, void *user_data)
 {
     (void)key;
     FPR_STORE_HASH_TYPE *peer = (FPR_STORE_HASH_TYPE *)value;
     bool *is_connected = (bool *)user_data;
-    if (peer && peer->is_connected) {
+    if (peer && peer->is_connected && !peer->is_link) {
         *is_connected = true;
     }
 }
@@ -58,15 +68,17 @@ bool fpr_client_is_connected()
 
 static void _add_and_ping_host_from_client(const esp_now_recv_info_t *esp_now_info, const fpr_connect_t *info) 
 {    
-    // Invoke discovery callback if registered
-    if (fpr_net.client_config.discovery_cb) {
-        fpr_net.client_config.discovery_cb(esp_now_info->src_addr, info->name, esp_now_info->rx_ctrl->rssi);
+    // Invoke discovery callback if registered (already done when the selection window saw it)
+    fpr_peer_discovered_cb_t discovery_cb = fpr_net.client_config.discovery_cb;
+    if (discovery_cb && !SELECT.replaying) {
+        FPR_APP_CALLBACK(discovery_cb(esp_now_info->src_addr, info->name, esp_now_info->rx_ctrl->rssi));
     }
 
     // Check if we're already connected to a DIFFERENT host
     // Allow reconnection to the SAME host (e.g., after restart)
     FPR_STORE_HASH_TYPE *existing = _get_peer_from_map(esp_now_info->src_addr);
-    if (!existing && fpr_client_is_connected()) {
+    bool standby_join = STANDBY.acquiring && memcmp(esp_now_info->src_addr, STANDBY.acquire_mac, MAC_ADDRESS_LENGTH) == 0;
+    if (!existing && fpr_client_is_connected() && !standby_join) {
         #if (FPR_DEBUG == 1)
         ESP_LOGW(TAG, "Already connected to a different host - ignoring %s", info->name);
         #endif
@@ -76,8 +88,10 @@ static void _add_and_ping_host_from_client(const esp_now_recv_info_t *esp_now_in
     // In manual mode, consult selection callback if provided. If selection_cb is NULL,
     // treat it as an explicit "decline" and do not auto-connect.
     if (fpr_net.client_config.connection_mode == FPR_CONNECTION_MANUAL) {
-        if (fpr_net.client_config.selection_cb != NULL) {
-            bool should_connect = fpr_net.client_config.selection_cb(esp_now_info->src_addr, info->name, esp_now_info->rx_ctrl->rssi);
+        fpr_host_selection_cb_t selection_cb = fpr_net.client_config.selection_cb;
+        if (selection_cb != NULL) {
+            bool should_connect;
+            FPR_APP_CALLBACK(should_connect = selection_cb(esp_now_info->src_addr, info->name, esp_now_info->rx_ctrl->rssi));
             if (!should_connect) {
                 #if (FPR_DEBUG == 1)
                 ESP_LOGI(TAG, "Application declined connection to host: %s", info->name);
@@ -126,6 +140,400 @@ static void _add_and_ping_host_from_client(const esp_now_recv_info_t *esp_now_in
     }
 }
 
+// ========== ACTIVE PROBING ==========
+
+static esp_err_t _send_probe_request(void)
+{
+    fpr_probe_frame_t req = {
+        .kind = FPR_PROBE_KIND_REQUEST,
+    };
+    return fpr_network_broadcast(&req, sizeof(req), FPR_PACKET_ID_PROBE);
+}
+
+// Returns false if the answer came from a host on another channel
+static bool _record_probe_responder(const esp_now_recv_info_t *esp_now_info, const fpr_probe_frame_t *probe)
+{
+    // Adjacent-channel leakage: we hear the host, but could not talk to it here
+    if (probe->channel != 0 && probe->channel != esp_now_info->rx_ctrl->channel) {
+        return false;
+    }
+
+    TaskHandle_t waiter = NULL;
+    const uint8_t *mac = esp_now_info->src_addr;
+
+    taskENTER_CRITICAL(&fpr_net.probe.lock);
+    bool seen = false;
+    for (int i = 0; i < fpr_net.probe.responder_count; i++) {
+        if (memcmp(fpr_net.probe.responders[i], mac, MAC_ADDRESS_LENGTH) == 0) {
+            fpr_net.probe.responder_rssi[i] = esp_now_info->rx_ctrl->rssi;
+            seen = true;
+            break;
+        }
+    }
+    if (!seen && fpr_net.probe.responder_count < FPR_PROBE_MAX_RESPONDERS) {
+        uint8_t idx = fpr_net.probe.responder_count++;
+        memcpy(fpr_net.probe.responders[idx], mac, MAC_ADDRESS_LENGTH);
+        fpr_net.probe.responder_rssi[idx] = esp_now_info->rx_ctrl->rssi;
+        waiter = fpr_net.probe.waiter;
+    }
+    taskEXIT_CRITICAL(&fpr_net.probe.lock);
+
+    if (waiter != NULL) {
+        xTaskNotifyGive(waiter);
+    }
+    return true;
+}
+
+// Probe until min_hosts distinct hosts answered or timeout passed. Returns hosts found.
+static size_t _probe_collect(size_t min_hosts, TickType_t timeout)
+{
+    taskENTER_CRITICAL(&fpr_net.probe.lock);
+    fpr_net.probe.responder_count = 0;
+    fpr_net.probe.waiter = xTaskGetCurrentTaskHandle();
+    taskEXIT_CRITICAL(&fpr_net.probe.lock);
+    ulTaskNotifyTake(pdTRUE, 0);
+
+    TickType_t start = xTaskGetTickCount();
+    const TickType_t retry_interval = pdMS_TO_TICKS(FPR_PROBE_RETRY_INTERVAL_MS);
+    TickType_t last_probe = start;
+    size_t found = 0;
+
+    _send_probe_request();
+    while (true) {
+        taskENTER_CRITICAL(&fpr_net.probe.lock);
+        found = fpr_net.probe.responder_count;
+        taskEXIT_CRITICAL(&fpr_net.probe.lock);
+
+        TickType_t now = xTaskGetTickCount();
+        if (found >= min_hosts || now - start >= timeout) {
+            break;
+        }
+        // Re-probe in case a request or response was lost
+        if (now - last_probe >= retry_interval) {
+            _send_probe_request();
+            last_probe = now;
+        }
+
+        // Woken early by each new responder
+        TickType_t wait = retry_interval - (now - last_probe);
+        if (wait > timeout - (now - start)) {
+            wait = timeout - (now - start);
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+
+    taskENTER_CRITICAL(&fpr_net.probe.lock);
+    fpr_net.probe.waiter = NULL;
+    taskEXIT_CRITICAL(&fpr_net.probe.lock);
+    return found;
+}
+
+// ========== HOST SELECTION ==========
+
+static void _handle_host_announcement(const esp_now_recv_info_t *esp_now_info, const fpr_connect_t *info);
+
+// Host score 0-100, higher is better. RSSI maps -95..-30 dBm to 0..100 and
+// hosts that do not advertise load count as half loaded.
+static int _host_score(int8_t rssi, const fpr_host_load_t *load, bool joined)
+{
+    int rssi_score = ((int)rssi + 95) * 100 / 65;
+    if (rssi_score < 0) {
+        rssi_score = 0;
+    } else if (rssi_score > 100) {
+        rssi_score = 100;
+    }
+    int load_pct = _fpr_host_load_pct(load);
+    if (load_pct < 0) {
+        load_pct = 50;
+    } else if (load_pct > 100) {
+        load_pct = 100;
+    }
+    int score = ((100 - FPR_HOST_SELECT_LOAD_WEIGHT) * rssi_score + FPR_HOST_SELECT_LOAD_WEIGHT * (100 - load_pct)) / 100;
+
+    // A full host rejects newcomers; only try it when nobody else answered
+    if (!joined && (load->flags & FPR_HOST_LOAD_VALID) && load->connected >= load->capacity) {
+        score -= 100;
+    }
+    return score;
+}
+
+// Must be called with the lock held. Returns the best candidate index or -1.
+// With current_mac, also reports the score of that (already joined) host.
+static int _select_best(const uint8_t *current_mac, int *best_score, int *current_score)
+{
+    int best = -1;
+    for (int i = 0; i < SELECT.candidate_count; i++) {
+        const fpr_host_candidate_t *c = &SELECT.candidates[i];
+        bool joined = current_mac != NULL && memcmp(c->src_addr, current_mac, MAC_ADDRESS_LENGTH) == 0;
+        int score = _host_score(c->rx_ctrl.rssi, &c->info.load, joined);
+        if (joined && current_score != NULL) {
+            *current_score = score;
+        }
+        if (best < 0 || score > *best_score) {
+            best = i;
+            *best_score = score;
+        }
+    }
+    return best;
+}
+
+// Handle a stored announcement as if it had just arrived
+static void _select_join(const fpr_host_candidate_t *c, int score)
+{
+    esp_now_recv_info_t esp_now_info = {
+        .src_addr = (uint8_t *)c->src_addr,
+        .des_addr = (uint8_t *)c->des_addr,
+        .rx_ctrl = (wifi_pkt_rx_ctrl_t *)&c->rx_ctrl,
+    };
+    ESP_LOGI(TAG, "Selected host %s (rssi %d, load %d%%, score %d)", c->info.name, c->rx_ctrl.rssi,
+             _fpr_host_load_pct(&c->info.load), score);
+    SELECT.replaying = true;
+    _handle_host_announcement(&esp_now_info, &c->info);
+    SELECT.replaying = false;
+}
+
+FPR_INSTANCE_TIMER_CB(_select_window_cb)
+{
+    fpr_host_candidate_t chosen;
+    int score = 0;
+
+    taskENTER_CRITICAL(&SELECT.lock);
+    int best = _select_best(NULL, &score, NULL);
+    if (best >= 0) {
+        chosen = SELECT.candidates[best];
+    }
+    SELECT.candidate_count = 0;
+    SELECT.collecting = false;
+    taskEXIT_CRITICAL(&SELECT.lock);
+
+    if (best >= 0 && !fpr_client_is_connected() && fpr_net.current_mode == FPR_MODE_CLIENT) {
+        _select_join(&chosen, score);
+    }
+}
+
+// Auto mode: hold announcements until the selection window closes instead of
+// joining the first host heard. Returns true if the announcement was held.
+static bool _select_offer(const esp_now_recv_info_t *esp_now_info, const fpr_connect_t *info)
+{
+    if (SELECT.replaying || SELECT.window_timer == NULL || fpr_net.client_config.connection_mode != FPR_CONNECTION_AUTO) {
+        return false;
+    }
+    // While connected, only a rebalance or standby probe collects announcements
+    bool connected = fpr_client_is_connected();
+    if (connected ? !SELECT.collecting : FPR_HOST_SELECT_WINDOW_MS == 0) {
+        return false;
+    }
+
+    bool added = false;
+    bool open_window = false;
+    taskENTER_CRITICAL(&SELECT.lock);
+    fpr_host_candidate_t *slot = NULL;
+    for (int i = 0; i < SELECT.candidate_count; i++) {
+        if (memcmp(SELECT.candidates[i].src_addr, esp_now_info->src_addr, MAC_ADDRESS_LENGTH) == 0) {
+            slot = &SELECT.candidates[i];
+            break;
+        }
+    }
+    if (slot == NULL && SELECT.candidate_count < FPR_PROBE_MAX_RESPONDERS) {
+        slot = &SELECT.candidates[SELECT.candidate_count++];
+        added = true;
+    }
+    if (slot != NULL) {
+        memcpy(slot->src_addr, esp_now_info->src_addr, MAC_ADDRESS_LENGTH);
+        memcpy(slot->des_addr, esp_now_info->des_addr, MAC_ADDRESS_LENGTH);
+        slot->rx_ctrl = *esp_now_info->rx_ctrl;
+        slot->info = *info;
+    }
+    if (!SELECT.collecting) {
+        SELECT.collecting = true;
+        open_window = true;
+    }
+    taskEXIT_CRITICAL(&SELECT.lock);
+
+    if (open_window) {
+        esp_timer_start_once(SELECT.window_timer, (uint64_t)FPR_HOST_SELECT_WINDOW_MS * 1000);
+    }
+    fpr_peer_discovered_cb_t discovery_cb = fpr_net.client_config.discovery_cb;
+    if (added && discovery_cb) {
+        FPR_APP_CALLBACK(discovery_cb(esp_now_info->src_addr, info->name, esp_now_info->rx_ctrl->rssi));
+    }
+    return true;
+}
+
+// Probe while connected and keep every answer as a candidate. The reconnect
+// job re-probes and evaluates the answers once the window has passed.
+static void _select_probe_connected(fpr_select_probe_t purpose, int64_t now_us)
+{
+    taskENTER_CRITICAL(&SELECT.lock);
+    SELECT.candidate_count = 0;
+    SELECT.collecting = true;
+    taskEXIT_CRITICAL(&SELECT.lock);
+
+    uint32_t window_ms = FPR_HOST_SELECT_WINDOW_MS > 0 ? FPR_HOST_SELECT_WINDOW_MS : FPR_PROBE_RETRY_INTERVAL_MS * 5;
+    SELECT.probe = purpose;
+    SELECT.probe_end_us = now_us + (int64_t)window_ms * 1000;
+    SELECT.probe_sent_us = now_us;
+    _send_probe_request();
+}
+
+static void _select_probe_abort(void)
+{
+    taskENTER_CRITICAL(&SELECT.lock);
+    SELECT.candidate_count = 0;
+    SELECT.collecting = false;
+    taskEXIT_CRITICAL(&SELECT.lock);
+    SELECT.probe = FPR_SELECT_PROBE_NONE;
+}
+
+// Our host is overloaded: probe, and move later if another host scores clearly better
+static void _select_rebalance(int64_t now_us)
+{
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    if (SELECT.window_timer == NULL || !fpr_client_is_connected() || fpr_client_get_host_info(host_mac, NULL, 0) != ESP_OK) {
+        return;
+    }
+    _select_probe_connected(FPR_SELECT_PROBE_REBALANCE, now_us);
+}
+
+static void _select_rebalance_finish(void)
+{
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    if (!fpr_client_is_connected() || fpr_client_get_host_info(host_mac, NULL, 0) != ESP_OK) {
+        _select_probe_abort();
+        return;
+    }
+
+    fpr_host_candidate_t chosen;
+    int best_score = 0;
+    int current_score = INT_MIN / 2;    // Host did not answer: any other host is better
+    taskENTER_CRITICAL(&SELECT.lock);
+    int best = _select_best(host_mac, &best_score, &current_score);
+    if (best >= 0) {
+        chosen = SELECT.candidates[best];
+    }
+    SELECT.candidate_count = 0;
+    SELECT.collecting = false;
+    taskEXIT_CRITICAL(&SELECT.lock);
+
+    if (best < 0 || memcmp(chosen.src_addr, host_mac, MAC_ADDRESS_LENGTH) == 0 ||
+        best_score < current_score + FPR_HOST_REBALANCE_MARGIN) {
+        ESP_LOGI(TAG, "Rebalance hint: no clearly better host - staying");
+        return;
+    }
+
+    ESP_LOGI(TAG, "Rebalance hint: moving to %s (score %d vs %d)", chosen.info.name, best_score, current_score);
+    fpr_client_disconnect();
+    _select_join(&chosen, best_score);
+}
+
+void _fpr_host_select_init(void)
+{
+    memset(&SELECT, 0, sizeof(SELECT));
+    memset(&STANDBY, 0, sizeof(STANDBY));
+    portMUX_INITIALIZE(&SELECT.lock);
+    const esp_timer_create_args_t timer_args = {
+        .callback = _select_window_cb,
+        .arg = &fpr_net,
+        .name = "fpr_select"
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &SELECT.window_timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create host selection timer: %s", esp_err_to_name(err));
+        SELECT.window_timer = NULL;
+    }
+}
+
+void _fpr_host_select_deinit(void)
+{
+    if (SELECT.window_timer != NULL) {
+        esp_timer_stop(SELECT.window_timer);
+        esp_timer_delete(SELECT.window_timer);
+        SELECT.window_timer = NULL;
+    }
+    SELECT.collecting = false;
+    SELECT.candidate_count = 0;
+    SELECT.probe = FPR_SELECT_PROBE_NONE;
+    // The sweep job was cancelled with the other jobs
+    fpr_net.probe.sweeping = false;
+}
+
+// Host broadcast or probe response: connect to a new host, or reconnect to a known one
+static void _handle_host_announcement(const esp_now_recv_info_t *esp_now_info, const fpr_connect_t *info)
+{
+    // Mid channel sweep the radio leaves this channel again within one dwell
+    if (fpr_net.probe.sweeping) {
+        return;
+    }
+    if (_select_offer(esp_now_info, info)) {
+        return;
+    }
+    
+    // Check if we already know this host
+    FPR_STORE_HASH_TYPE *known_host = _get_peer_from_map(esp_now_info->src_addr);
+    if (known_host == NULL) {
+        #if (FPR_DEBUG == 1)
+        ESP_LOGI(TAG, "Found new host: %s (" MACSTR ")", info->name, MAC2STR(esp_now_info->src_addr));
+        #endif
+        _add_and_ping_host_from_client(esp_now_info, info);
+    } else {
+        // Known host - check if we need to reconnect (e.g., after host restart)
+        // If host restarted, it lost our connection info and is broadcasting again
+        // We should reinitiate connection if not fully connected
+        // BUT: Don't interrupt an in-progress handshake (sec_state > NONE)
+        if (!known_host->is_connected || known_host->sec_state != FPR_SEC_STATE_ESTABLISHED) {
+            // Only reset if we're not already in the middle of a handshake
+            if (known_host->sec_state == FPR_SEC_STATE_NONE) {
+                ESP_LOGI(TAG, "Host %s broadcast received - reinitiating connection (current state=%d, connected=%d)",
+                         info->name, known_host->sec_state, known_host->is_connected);
+                // Reset security state and reconnect (state reset is always safe)
+                known_host->sec_state = FPR_SEC_STATE_NONE;
+                _peer_set_state(known_host, FPR_PEER_STATE_DISCOVERED, FPR_EVENT_REASON_PEER_RESTART);
+                known_host->security.pwk_valid = false;
+                known_host->security.lwk_valid = false;
+                _update_peer_rssi_and_timestamp(known_host, esp_now_info);
+
+                // Decide whether to initiate handshake automatically based on mode
+                if (fpr_net.client_config.connection_mode == FPR_CONNECTION_AUTO) {
+                    esp_err_t err = fpr_network_send_device_info(esp_now_info->src_addr);
+                    if (err == ESP_OK) {
+                        ESP_LOGI(TAG, "Sent reconnection request to host " MACSTR, MAC2STR(esp_now_info->src_addr));
+                    } else {
+                        ESP_LOGE(TAG, "Failed to send reconnection request: %s", esp_err_to_name(err));
+                    }
+                } else {
+                    // Manual mode: consult selection_cb if present; if NULL, do not auto-reconnect
+                    fpr_host_selection_cb_t selection_cb = fpr_net.client_config.selection_cb;
+                    if (selection_cb) {
+                        bool should_connect;
+                        FPR_APP_CALLBACK(should_connect = selection_cb(esp_now_info->src_addr, info->name, esp_now_info->rx_ctrl->rssi));
+                        if (should_connect) {
+                            esp_err_t err = fpr_network_send_device_info(esp_now_info->src_addr);
+                            if (err == ESP_OK) {
+                                ESP_LOGI(TAG, "Sent reconnection request to host " MACSTR, MAC2STR(esp_now_info->src_addr));
+                            } else {
+                                ESP_LOGE(TAG, "Failed to send reconnection request: %s", esp_err_to_name(err));
+                            }
+                        } else {
+                            #if (FPR_DEBUG == 1)
+                            ESP_LOGI(TAG, "Manual mode: application declined reconnect to host: %s", info->name);
+                            #endif
+                        }
+                    } else {
+                        #if (FPR_DEBUG == 1)
+                        ESP_LOGI(TAG, "Manual mode and no selection callback provided - not auto-reconnecting to host: %s", info->name);
+                        #endif
+                    }
+                }
+            }
+            #if (FPR_DEBUG == 1)
+            else {
+                ESP_LOGD(TAG, "Ignoring broadcast - handshake in progress (state=%d)", known_host->sec_state);
+            }
+            #endif
+        }
+    }
+}
+
 void _handle_client_discovery(const esp_now_recv_info_t *esp_now_info, const uint8_t *data, int len)
 {
     #if (FPR_DEBUG_LOG_CLIENT_DATA_RECEIVE == 1)
@@ -148,6 +556,7 @@ void _handle_client_discovery(const esp_now_recv_info_t *esp_now_info, const uin
     if (!fpr_version_handle_version(esp_now_info, data, len, package->version)) {
         return; // Version handler rejected the packet
     }
+    _fpr_channel_on_rx(esp_now_info);
     
     // Connection/handshake packets use FPR_PACKET_ID_CONTROL (-1)
     // Application data packets use other IDs (0 or positive)
@@ -158,70 +567,17 @@ void _handle_client_discovery(const esp_now_recv_info_t *esp_now_info, const uin
     
     // Handle broadcast discovery messages from host (always control packets)
     if (is_broadcast && is_control_packet) {
-        // Check if we already know this host
-        FPR_STORE_HASH_TYPE *known_host = _get_peer_from_map(esp_now_info->src_addr);
-        if (known_host == NULL) {
-            #if (FPR_DEBUG == 1)
-            ESP_LOGI(TAG, "Found new host: %s (" MACSTR ")", info->name, MAC2STR(esp_now_info->src_addr));
-            #endif
-            _add_and_ping_host_from_client(esp_now_info, info);
-        } else {
-            // Known host - check if we need to reconnect (e.g., after host restart)
-            // If host restarted, it lost our connection info and is broadcasting again
-            // We should reinitiate connection if not fully connected
-            // BUT: Don't interrupt an in-progress handshake (sec_state > NONE)
-            if (!known_host->is_connected || known_host->sec_state != FPR_SEC_STATE_ESTABLISHED) {
-                // Only reset if we're not already in the middle of a handshake
-                if (known_host->sec_state == FPR_SEC_STATE_NONE) {
-                    ESP_LOGI(TAG, "Host %s broadcast received - reinitiating connection (current state=%d, connected=%d)",
-                             info->name, known_host->sec_state, known_host->is_connected);
-                    // Reset security state and reconnect (state reset is always safe)
-                    known_host->sec_state = FPR_SEC_STATE_NONE;
-                    known_host->is_connected = false;
-                    known_host->state = FPR_PEER_STATE_DISCOVERED;
-                    known_host->security.pwk_valid = false;
-                    known_host->security.lwk_valid = false;
-                    _update_peer_rssi_and_timestamp(known_host, esp_now_info);
-
-                    // Decide whether to initiate handshake automatically based on mode
-                    if (fpr_net.client_config.connection_mode == FPR_CONNECTION_AUTO) {
-                        esp_err_t err = fpr_network_send_device_info(esp_now_info->src_addr);
-                        if (err == ESP_OK) {
-                            ESP_LOGI(TAG, "Sent reconnection request to host " MACSTR, MAC2STR(esp_now_info->src_addr));
-                        } else {
-                            ESP_LOGE(TAG, "Failed to send reconnection request: %s", esp_err_to_name(err));
-                        }
-                    } else {
-                        // Manual mode: consult selection_cb if present; if NULL, do not auto-reconnect
-                        if (fpr_net.client_config.selection_cb) {
-                            bool should_connect = fpr_net.client_config.selection_cb(esp_now_info->src_addr, info->name, esp_now_info->rx_ctrl->rssi);
-                            if (should_connect) {
-                                esp_err_t err = fpr_network_send_device_info(esp_now_info->src_addr);
-                                if (err == ESP_OK) {
-                                    ESP_LOGI(TAG, "Sent reconnection request to host " MACSTR, MAC2STR(esp_now_info->src_addr));
-                                } else {
-                                    ESP_LOGE(TAG, "Failed to send reconnection request: %s", esp_err_to_name(err));
-                                }
-                            } else {
-                                #if (FPR_DEBUG == 1)
-                                ESP_LOGI(TAG, "Manual mode: application declined reconnect to host: %s", info->name);
-                                #endif
-                            }
-                        } else {
-                            #if (FPR_DEBUG == 1)
-                            ESP_LOGI(TAG, "Manual mode and no selection callback provided - not auto-reconnecting to host: %s", info->name);
-                            #endif
-                        }
-                    }
-                }
-                #if (FPR_DEBUG == 1)
-                else {
-                    ESP_LOGD(TAG, "Ignoring broadcast - handshake in progress (state=%d)", known_host->sec_state);
-                }
-                #endif
-            }
+        _handle_host_announcement(esp_now_info, info);
+    } else if (is_broadcast && package->id == FPR_PACKET_ID_PROBE) {
+        // Answer to our (or another client's) probe request
+        const fpr_probe_frame_t *probe = (const fpr_probe_frame_t *)&package->protocol;
+        if (probe->kind == FPR_PROBE_KIND_RESPONSE && _record_probe_responder(esp_now_info, probe)) {
+            _handle_host_announcement(esp_now_info, &probe->info);
         }
-    } else if (!is_broadcast) {
+    } else if (is_broadcast) {
+        // Host beacons and other broadcast service frames
+        _fpr_service_handle_broadcast(esp_now_info, package);
+    } else {
         // Handle unicast response from host (security handshake or data)
         FPR_STORE_HASH_TYPE *existing = _get_peer_from_map(esp_now_info->src_addr);
         if (existing) {
@@ -241,8 +597,7 @@ void _handle_client_discovery(const esp_now_recv_info_t *esp_now_info, const uin
                         ESP_LOGI(TAG, "Host %s appears to have restarted (received PWK while in state %d) - resetting connection",
                                  existing->name, existing->sec_state);
                         existing->sec_state = FPR_SEC_STATE_NONE;
-                        existing->is_connected = false;
-                        existing->state = FPR_PEER_STATE_DISCOVERED;
+                        _peer_set_state(existing, FPR_PEER_STATE_DISCOVERED, FPR_EVENT_REASON_PEER_RESTART);
                         existing->security.pwk_valid = false;
                         existing->security.lwk_valid = false;
                     }
@@ -286,6 +641,22 @@ void _handle_client_discovery(const esp_now_recv_info_t *esp_now_info, const uin
                 }
             }
             
+            // Linked clients, directly or relayed by the host
+            if (existing->is_connected && !is_control_packet && _fpr_link_on_client_rx(esp_now_info, existing, package)) {
+                return;
+            }
+            
+            // Overloaded host asks us to look for a better one
+            if (package->id == FPR_PACKET_ID_PROBE) {
+                const fpr_probe_frame_t *probe = (const fpr_probe_frame_t *)&package->protocol;
+                if (probe->kind == FPR_PROBE_KIND_REBALANCE && existing->is_connected &&
+                    fpr_net.client_config.connection_mode == FPR_CONNECTION_AUTO) {
+                    SELECT.rebalance_requested = true;
+                    _fpr_sched_post(FPR_JOB_RECONNECT);
+                }
+                return;
+            }
+            
             // If already connected, store application data (non-control packets)
             if (existing->is_connected && !is_control_packet) {
                 // Store data from connected peers (unicast only)
@@ -305,6 +676,13 @@ void _find_host_callback(void *key, void *value, void *user_data)
     host_search_ctx_t *ctx = (host_search_ctx_t *)user_data;
     // Find host that is either fully connected OR in the process of connecting
     // (state >= DISCOVERED means we know about this host)
+    // The standby host never counts as our host until it takes over, linked clients never do
+    if (peer && STANDBY.has_standby && memcmp(peer->peer_info.peer_addr, STANDBY.standby, MAC_ADDRESS_LENGTH) == 0) {
+        return;
+    }
+    if (peer && peer->is_link) {
+        return;
+    }
     if (peer && peer->state >= FPR_PEER_STATE_DISCOVERED && !ctx->found) {
         memcpy(ctx->mac, peer->peer_info.peer_addr, MAC_ADDRESS_LENGTH);
         if (ctx->name_size > 0) {
@@ -333,7 +711,13 @@ esp_err_t fpr_client_get_host_info(uint8_t *mac_out, char *name_out, size_t name
         .found = false
     };
 
-    hashmap_foreach(&fpr_net.peers_map, _find_host_callback, &ctx);
+    // The active host comes first when two hosts are known
+    FPR_STORE_HASH_TYPE *primary = STANDBY.has_primary ? _get_peer_from_map(STANDBY.primary) : NULL;
+    if (primary != NULL && primary->state >= FPR_PEER_STATE_DISCOVERED) {
+        _find_host_callback(NULL, primary, &ctx);
+    } else {
+        hashmap_foreach(&fpr_net.peers_map, _find_host_callback, &ctx);
+    }
 
     if (!ctx.found) {
         return ESP_ERR_NOT_FOUND;
@@ -375,7 +759,7 @@ static void _filter_peers_callback(void *key, void *value, void *user_data)
     FPR_STORE_HASH_TYPE *peer = (FPR_STORE_HASH_TYPE *)value;
     peer_filter_ctx_t *ctx = (peer_filter_ctx_t *)user_data;
     
-    if (ctx->count < ctx->max_peers && peer) {
+    if (ctx->count < ctx->max_peers && peer && !peer->is_link) {
         // Filter based on criteria
         if (ctx->connected_only && peer->state != FPR_PEER_STATE_CONNECTED) {
             return;  // Skip non-connected peers
@@ -449,8 +833,7 @@ esp_err_t fpr_client_disconnect(void)
     if (err == ESP_OK) {
         FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(host_mac);
         if (peer) {
-            peer->is_connected = false;
-            peer->state = FPR_PEER_STATE_DISCOVERED;
+            _peer_set_state(peer, FPR_PEER_STATE_DISCOVERED, FPR_EVENT_REASON_LOCAL);
             ESP_LOGI(TAG, "Disconnected from host: %s", peer->name);
             return ESP_OK;
         }
@@ -471,8 +854,7 @@ size_t fpr_client_scan_for_hosts(TickType_t duration)
     while (xTaskGetTickCount() - start < duration) {
         TickType_t now = xTaskGetTickCount();
         if (now - last_broadcast >= broadcast_interval) {
-            extern esp_err_t fpr_network_broadcast_device_info();
-            fpr_network_broadcast_device_info();
+            _send_probe_request();
             last_broadcast = now;
         }
         vTaskDelay(pdMS_TO_TICKS(FPR_HOST_SCAN_POLL_INTERVAL_MS));
@@ -485,41 +867,510 @@ size_t fpr_client_scan_for_hosts(TickType_t duration)
     return discovered;
 }
 
-void _fpr_client_reconnect_task(void *arg)
+size_t fpr_client_probe_for_hosts(size_t min_hosts, TickType_t timeout)
 {
-    (void)arg;
-    TickType_t last_keep = xTaskGetTickCount();
+    if (min_hosts == 0) {
+        min_hosts = 1;
+    }
+    if (min_hosts > FPR_PROBE_MAX_RESPONDERS) {
+        min_hosts = FPR_PROBE_MAX_RESPONDERS;
+    }
 
-    while (1) {
-        // Get power-adjusted intervals
-        const TickType_t keep_interval_ticks = pdMS_TO_TICKS(_fpr_get_power_adjusted_interval(FPR_KEEPALIVE_INTERVAL_MS));
-        const TickType_t check_interval_ticks = pdMS_TO_TICKS(_fpr_get_power_adjusted_interval(FPR_CLIENT_WAIT_CHECK_INTERVAL_MS));
-        
-        // If connected, send periodic keepalive and check for host timeout
-        uint8_t host_mac[MAC_ADDRESS_LENGTH];
-        if (fpr_client_get_host_info(host_mac, NULL, 0) == ESP_OK) {
-            FPR_STORE_HASH_TYPE *host_peer = _get_peer_from_map(host_mac);
-            if (host_peer && host_peer->is_connected) {
-                // keepalive send periodically
-                if ((xTaskGetTickCount() - last_keep) >= keep_interval_ticks) {
-                    esp_err_t err = fpr_network_send_device_info(host_mac);
-                    if (err != ESP_OK) {
-                        ESP_LOGD(TAG, "Keepalive to host failed: %s", esp_err_to_name(err));
-                    }
-                    last_keep = xTaskGetTickCount();
-                }
+    TickType_t start = xTaskGetTickCount();
+    size_t found = _probe_collect(min_hosts, timeout);
+    ESP_LOGI(TAG, "Probe complete - %zu host(s) answered in %lu ms", found,
+             (unsigned long)pdTICKS_TO_MS(xTaskGetTickCount() - start));
+    return found;
+}
+
+// ========== CHANNEL SWEEP ==========
+
+#define SWEEP fpr_net.probe.sweep
+
+// Next re-probe or the end of the dwell
+static int64_t _sweep_next_us(void)
+{
+    int64_t next_us = SWEEP.last_probe_us + (int64_t)FPR_PROBE_RETRY_INTERVAL_MS * 1000;
+    return next_us < SWEEP.dwell_end_us ? next_us : SWEEP.dwell_end_us;
+}
+
+static void _sweep_listen(int64_t now_us)
+{
+    taskENTER_CRITICAL(&fpr_net.probe.lock);
+    fpr_net.probe.responder_count = 0;
+    taskEXIT_CRITICAL(&fpr_net.probe.lock);
+    SWEEP.dwell_end_us = now_us + (int64_t)FPR_CHANNEL_SCAN_DWELL_MS * 1000;
+    SWEEP.last_probe_us = now_us;
+    _send_probe_request();
+}
+
+// Keep what the channel just probed heard
+static void _sweep_record(void)
+{
+    fpr_channel_scan_report_t *rep = &SWEEP.report;
+    fpr_channel_result_t *result = &rep->channels[SWEEP.index];
+
+    taskENTER_CRITICAL(&fpr_net.probe.lock);
+    result->hosts = fpr_net.probe.responder_count;
+    for (int h = 0; h < result->hosts; h++) {
+        int8_t rssi = fpr_net.probe.responder_rssi[h];
+        if (rssi > result->best_rssi) {
+            result->best_rssi = rssi;
+        }
+        if (rssi > SWEEP.best_rssi) {
+            SWEEP.best_rssi = rssi;
+            rep->locked_channel = result->channel;
+            memcpy(rep->best_host, fpr_net.probe.responders[h], MAC_ADDRESS_LENGTH);
+        }
+    }
+    taskEXIT_CRITICAL(&fpr_net.probe.lock);
+}
+
+static int64_t _sweep_finish(int64_t now_us)
+{
+    fpr_channel_scan_report_t *rep = &SWEEP.report;
+    rep->duration_ms = (uint32_t)US_TO_MS(now_us - SWEEP.start_us);
+    #if (FPR_DEBUG == 1)
+    for (int i = 0; i < rep->channel_count; i++) {
+        ESP_LOGI(TAG, "  ch %2u: %u host(s), best rssi %d", rep->channels[i].channel, rep->channels[i].hosts,
+                 rep->channels[i].hosts ? rep->channels[i].best_rssi : 0);
+    }
+    #endif
+    ESP_LOGI(TAG, "Channel scan of %u channels took %lu ms - locked to channel %u", rep->channel_count,
+             (unsigned long)rep->duration_ms, rep->locked_channel);
+
+    SWEEP.result = rep->locked_channel != 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+    SWEEP.running = false;
+    TaskHandle_t caller = SWEEP.caller;
+    if (caller != NULL) {
+        xTaskNotifyGive(caller);
+    }
+    return 0;
+}
+
+// Service task job: one dwell per channel, without blocking the task
+static int64_t _sweep_job(int64_t now_us)
+{
+    fpr_channel_scan_report_t *rep = &SWEEP.report;
+
+    if (now_us < SWEEP.dwell_end_us) {
+        // Re-probe in case a request or response was lost
+        if (now_us - SWEEP.last_probe_us >= (int64_t)FPR_PROBE_RETRY_INTERVAL_MS * 1000) {
+            _send_probe_request();
+            SWEEP.last_probe_us = now_us;
+        }
+        return _sweep_next_us();
+    }
+
+    if (SWEEP.confirming) {
+        return _sweep_finish(now_us);
+    }
+    if (SWEEP.dwell_end_us != 0) {
+        _sweep_record();
+        SWEEP.index++;
+    }
+
+    // Next channel; one the radio cannot switch to is skipped
+    while (SWEEP.index < SWEEP.channel_count) {
+        uint8_t channel = SWEEP.channels[SWEEP.index];
+        fpr_channel_result_t *result = &rep->channels[rep->channel_count++];
+        result->channel = channel;
+        result->best_rssi = INT8_MIN;
+        if (esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE) == ESP_OK) {
+            _sweep_listen(now_us);
+            return _sweep_next_us();
+        }
+        ESP_LOGW(TAG, "Cannot switch to channel %u - skipping", channel);
+        SWEEP.index++;
+    }
+    fpr_net.probe.sweeping = false;
+
+    if (rep->locked_channel == 0) {
+        if (SWEEP.original_channel != 0) {
+            esp_wifi_set_channel(SWEEP.original_channel, WIFI_SECOND_CHAN_NONE);
+        }
+        return _sweep_finish(now_us);
+    }
+
+    esp_wifi_set_channel(rep->locked_channel, WIFI_SECOND_CHAN_NONE);
+    fpr_net.channel = rep->locked_channel;
+    // Probe once more on the chosen channel so the normal connect path runs
+    SWEEP.confirming = true;
+    _sweep_listen(now_us);
+    return _sweep_next_us();
+}
+
+// Arm the sweep job; the result arrives in SWEEP.report
+static esp_err_t _sweep_start(const uint8_t *channels, size_t channel_count, TaskHandle_t caller)
+{
+    static const uint8_t default_channels[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+
+    ESP_RETURN_ON_FALSE(fpr_net.current_mode == FPR_MODE_CLIENT, ESP_ERR_INVALID_STATE, TAG, "Channel scan requires client mode");
+    ESP_RETURN_ON_FALSE(!fpr_client_is_connected(), ESP_ERR_INVALID_STATE, TAG, "Disconnect before scanning other channels");
+    ESP_RETURN_ON_FALSE(!_fpr_sched_is_armed(FPR_JOB_SCAN), ESP_ERR_INVALID_STATE, TAG, "Channel scan already running");
+    if (channels == NULL || channel_count == 0) {
+        channels = default_channels;
+        channel_count = sizeof(default_channels);
+    }
+    ESP_RETURN_ON_FALSE(channel_count <= FPR_CHANNEL_MAX, ESP_ERR_INVALID_ARG, TAG, "Too many channels");
+
+    memset(&SWEEP, 0, sizeof(SWEEP));
+    memcpy(SWEEP.channels, channels, channel_count);
+    SWEEP.channel_count = (uint8_t)channel_count;
+    SWEEP.original_channel = _fpr_get_current_channel();
+    SWEEP.best_rssi = INT8_MIN;
+    SWEEP.caller = caller;
+    SWEEP.running = true;
+
+    int64_t now_us = esp_timer_get_time();
+    SWEEP.start_us = now_us;
+    fpr_net.probe.sweeping = true;
+    _fpr_sched_set(FPR_JOB_SCAN, _sweep_job, now_us);
+    return ESP_OK;
+}
+
+esp_err_t fpr_client_scan_channels(const uint8_t *channels, size_t channel_count, fpr_channel_scan_report_t *report)
+{
+    ESP_RETURN_ON_FALSE(!_fpr_sched_is_service_task(), ESP_ERR_INVALID_STATE, TAG, "Channel scan cannot wait on the service task");
+
+    ulTaskNotifyTake(pdTRUE, 0);
+    esp_err_t ret = _sweep_start(channels, channel_count, xTaskGetCurrentTaskHandle());
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // The job wakes us when done; stop waiting if it was cancelled by deinit
+    const TickType_t dwell = pdMS_TO_TICKS(FPR_CHANNEL_SCAN_DWELL_MS);
+    while (SWEEP.running && _fpr_sched_is_armed(FPR_JOB_SCAN)) {
+        ulTaskNotifyTake(pdTRUE, dwell);
+    }
+    ret = SWEEP.running ? ESP_ERR_INVALID_STATE : SWEEP.result;
+    SWEEP.running = false;
+    SWEEP.caller = NULL;
+    fpr_net.probe.sweeping = false;
+
+    if (report != NULL) {
+        *report = SWEEP.report;
+    }
+    return ret;
+}
+
+// ========== HOT STANDBY ==========
+
+static void _standby_release(FPR_STORE_HASH_TYPE *peer)
+{
+    _peer_set_state(peer, FPR_PEER_STATE_DISCOVERED, FPR_EVENT_REASON_LOCAL);
+    peer->sec_state = FPR_SEC_STATE_NONE;
+    peer->security.pwk_valid = false;
+    peer->security.lwk_valid = false;
+}
+
+static void _standby_heartbeat(FPR_STORE_HASH_TYPE *peer)
+{
+    fpr_probe_frame_t beat = {
+        .kind = FPR_PROBE_KIND_HEARTBEAT,
+    };
+    uint8_t dest[MAC_ADDRESS_LENGTH];
+    memcpy(dest, peer->peer_info.peer_addr, MAC_ADDRESS_LENGTH);
+    if (fpr_network_send_to_peer(dest, &beat, sizeof(beat), FPR_PACKET_ID_PROBE) == ESP_OK) {
+        STANDBY.stats.heartbeats_sent++;
+    }
+}
 
-                // check last seen timestamp (in microseconds)
-                int64_t age_us = esp_timer_get_time() - host_peer->last_seen;
-                uint32_t timeout_ms = _fpr_get_power_adjusted_interval(FPR_RECONNECT_TIMEOUT_MS);
-                if ((uint64_t)US_TO_MS(age_us) > timeout_ms) {
-                    ESP_LOGW(TAG, "Host timed out (age %llu ms) - marking disconnected for reconnect", (unsigned long long)US_TO_MS(age_us));
-                    host_peer->is_connected = false;
-                    host_peer->state = FPR_PEER_STATE_DISCOVERED;
+// Probe for a second host; _standby_acquire_finish() joins the best one
+static void _standby_acquire(int64_t now_us)
+{
+    STANDBY.last_acquire = xTaskGetTickCount();
+    STANDBY.acquiring = false;
+    _select_probe_connected(FPR_SELECT_PROBE_STANDBY, now_us);
+}
+
+// Join the best host other than the active one as standby
+static void _standby_acquire_finish(void)
+{
+    FPR_STORE_HASH_TYPE *primary = STANDBY.has_primary ? _get_peer_from_map(STANDBY.primary) : NULL;
+    if (!STANDBY.enabled || primary == NULL || !primary->is_connected || STANDBY.has_standby) {
+        _select_probe_abort();
+        return;
+    }
+
+    fpr_host_candidate_t chosen;
+    int score = 0;
+    taskENTER_CRITICAL(&SELECT.lock);
+    for (int i = 0; i < SELECT.candidate_count; i++) {
+        if (memcmp(SELECT.candidates[i].src_addr, primary->peer_info.peer_addr, MAC_ADDRESS_LENGTH) == 0) {
+            SELECT.candidates[i] = SELECT.candidates[--SELECT.candidate_count];
+            break;
+        }
+    }
+    int best = _select_best(NULL, &score, NULL);
+    if (best >= 0) {
+        chosen = SELECT.candidates[best];
+    }
+    SELECT.candidate_count = 0;
+    SELECT.collecting = false;
+    taskEXIT_CRITICAL(&SELECT.lock);
+
+    if (best < 0) {
+        #if (FPR_DEBUG == 1)
+        ESP_LOGI(TAG, "No second host in range for standby");
+        #endif
+        return;
+    }
+    memcpy(STANDBY.acquire_mac, chosen.src_addr, MAC_ADDRESS_LENGTH);
+    STANDBY.acquiring = true;
+    _select_join(&chosen, score);
+}
+
+// Re-probe within the window, then hand the answers to whoever asked
+static void _select_probe_tick(int64_t now_us)
+{
+    if (SELECT.probe == FPR_SELECT_PROBE_NONE) {
+        return;
+    }
+    if (now_us < SELECT.probe_end_us) {
+        if (now_us - SELECT.probe_sent_us >= (int64_t)FPR_PROBE_RETRY_INTERVAL_MS * 1000) {
+            _send_probe_request();
+            SELECT.probe_sent_us = now_us;
+        }
+        return;
+    }
+
+    fpr_select_probe_t purpose = SELECT.probe;
+    SELECT.probe = FPR_SELECT_PROBE_NONE;
+    if (purpose == FPR_SELECT_PROBE_REBALANCE) {
+        _select_rebalance_finish();
+    } else {
+        _standby_acquire_finish();
+    }
+}
+
+// Next re-probe or the end of the window, 0 when no probe is running
+static int64_t _select_probe_next_us(void)
+{
+    if (SELECT.probe == FPR_SELECT_PROBE_NONE) {
+        return 0;
+    }
+    int64_t next_us = SELECT.probe_sent_us + (int64_t)FPR_PROBE_RETRY_INTERVAL_MS * 1000;
+    return next_us < SELECT.probe_end_us ? next_us : SELECT.probe_end_us;
+}
+
+static void _standby_failover(FPR_STORE_HASH_TYPE *old_primary, FPR_STORE_HASH_TYPE *standby)
+{
+    uint32_t outage_ms = (uint32_t)US_TO_MS(esp_timer_get_time() - STANDBY.primary_last_seen_us);
+    if (old_primary != NULL) {
+        _standby_release(old_primary);
+    }
+
+    memcpy(STANDBY.primary, STANDBY.standby, MAC_ADDRESS_LENGTH);
+    STANDBY.has_primary = true;
+    STANDBY.has_standby = false;
+    STANDBY.primary_last_seen_us = standby->last_seen;
+    STANDBY.stats.failovers++;
+    STANDBY.stats.last_failover_ms = outage_ms;
+    STANDBY.stats.standby_ready = false;
+    memcpy(STANDBY.stats.primary_mac, STANDBY.primary, MAC_ADDRESS_LENGTH);
+    memset(STANDBY.stats.standby_mac, 0, MAC_ADDRESS_LENGTH);
+    ESP_LOGW(TAG, "Failover to standby host %s (%lu ms since the old host was heard)", standby->name, (unsigned long)outage_ms);
+
+    // Services attach to the new host as if it had just connected
+    _fpr_services_on_peer_connected(standby);
+}
+
+static void _standby_tick(int64_t now_us)
+{
+    if (!STANDBY.enabled || fpr_net.current_mode != FPR_MODE_CLIENT) {
+        return;
+    }
+    TickType_t now = xTaskGetTickCount();
+    const int64_t lost_us = (int64_t)FPR_STANDBY_HEARTBEAT_MS * FPR_STANDBY_MAX_MISSED_HEARTBEATS * 1000;
+
+    FPR_STORE_HASH_TYPE *primary = STANDBY.has_primary ? _get_peer_from_map(STANDBY.primary) : NULL;
+    FPR_STORE_HASH_TYPE *standby = STANDBY.has_standby ? _get_peer_from_map(STANDBY.standby) : NULL;
+    if (primary != NULL && primary->is_connected) {
+        STANDBY.primary_last_seen_us = primary->last_seen;
+    }
+
+    // A silent standby is dropped and a fresh one acquired later
+    if (standby != NULL && (!standby->is_connected || now_us - standby->last_seen > lost_us)) {
+        ESP_LOGW(TAG, "Standby host %s stopped answering", standby->name);
+        _standby_release(standby);
+        STANDBY.has_standby = false;
+        STANDBY.stats.standby_ready = false;
+        STANDBY.stats.standby_lost++;
+        memset(STANDBY.stats.standby_mac, 0, MAC_ADDRESS_LENGTH);
+        standby = NULL;
+    }
+
+    bool primary_lost = primary == NULL || !primary->is_connected || now_us - primary->last_seen > lost_us;
+    if (primary_lost && standby != NULL) {
+        _standby_failover(primary, standby);
+        primary = standby;
+        standby = NULL;
+    }
+
+    if (now - STANDBY.last_heartbeat >= pdMS_TO_TICKS(FPR_STANDBY_HEARTBEAT_MS)) {
+        STANDBY.last_heartbeat = now;
+        if (primary != NULL && primary->is_connected) {
+            _standby_heartbeat(primary);
+        }
+        if (standby != NULL) {
+            _standby_heartbeat(standby);
+        }
+    }
+
+    if (primary != NULL && primary->is_connected && standby == NULL && SELECT.probe == FPR_SELECT_PROBE_NONE &&
+        now - STANDBY.last_acquire >= pdMS_TO_TICKS(FPR_STANDBY_ACQUIRE_INTERVAL_MS)) {
+        _standby_acquire(now_us);
+    }
+}
+
+bool _fpr_standby_on_host_connected(FPR_STORE_HASH_TYPE *peer)
+{
+    const uint8_t *mac = peer->peer_info.peer_addr;
+    FPR_STORE_HASH_TYPE *primary = STANDBY.has_primary ? _get_peer_from_map(STANDBY.primary) : NULL;
+    bool other_active = primary != NULL && primary != peer && primary->is_connected;
+
+    if (STANDBY.enabled && other_active) {
+        memcpy(STANDBY.standby, mac, MAC_ADDRESS_LENGTH);
+        STANDBY.has_standby = true;
+        STANDBY.acquiring = false;
+        STANDBY.stats.standby_ready = true;
+        memcpy(STANDBY.stats.standby_mac, mac, MAC_ADDRESS_LENGTH);
+        ESP_LOGI(TAG, "Standby host ready: %s", peer->name);
+        return false;
+    }
+
+    memcpy(STANDBY.primary, mac, MAC_ADDRESS_LENGTH);
+    STANDBY.has_primary = true;
+    STANDBY.primary_last_seen_us = peer->last_seen;
+    memcpy(STANDBY.stats.primary_mac, mac, MAC_ADDRESS_LENGTH);
+    return true;
+}
+
+bool _fpr_standby_is_active_host(const uint8_t *mac)
+{
+    return !STANDBY.has_standby || memcmp(mac, STANDBY.standby, MAC_ADDRESS_LENGTH) != 0;
+}
+
+void _fpr_standby_on_peer_removed(FPR_STORE_HASH_TYPE *peer)
+{
+    const uint8_t *mac = peer->peer_info.peer_addr;
+    if (STANDBY.has_standby && memcmp(mac, STANDBY.standby, MAC_ADDRESS_LENGTH) == 0) {
+        STANDBY.has_standby = false;
+        STANDBY.stats.standby_ready = false;
+        memset(STANDBY.stats.standby_mac, 0, MAC_ADDRESS_LENGTH);
+    } else if (STANDBY.has_primary && memcmp(mac, STANDBY.primary, MAC_ADDRESS_LENGTH) == 0) {
+        // Next tick promotes the standby
+        STANDBY.has_primary = false;
+    }
+}
+
+esp_err_t fpr_client_set_standby(bool enable)
+{
+    ESP_RETURN_ON_FALSE(fpr_net.current_mode == FPR_MODE_CLIENT, ESP_ERR_INVALID_STATE, TAG, "Hot standby requires client mode");
+    ESP_RETURN_ON_FALSE(!enable || fpr_net.client_config.connection_mode == FPR_CONNECTION_AUTO, ESP_ERR_INVALID_STATE, TAG,
+                        "Hot standby requires auto connection mode");
+
+    if (!enable && STANDBY.has_standby) {
+        FPR_STORE_HASH_TYPE *standby = _get_peer_from_map(STANDBY.standby);
+        if (standby != NULL) {
+            _standby_release(standby);
+        }
+        STANDBY.has_standby = false;
+        memset(STANDBY.stats.standby_mac, 0, MAC_ADDRESS_LENGTH);
+    }
+    STANDBY.enabled = enable;
+    STANDBY.acquiring = false;
+    STANDBY.stats.enabled = enable;
+    STANDBY.stats.standby_ready = false;
+    // First acquisition attempt on the next reconnect task pass
+    STANDBY.last_acquire = xTaskGetTickCount() - pdMS_TO_TICKS(FPR_STANDBY_ACQUIRE_INTERVAL_MS);
+
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    if (enable && !STANDBY.has_primary && fpr_client_get_host_info(host_mac, NULL, 0) == ESP_OK) {
+        memcpy(STANDBY.primary, host_mac, MAC_ADDRESS_LENGTH);
+        STANDBY.has_primary = true;
+        memcpy(STANDBY.stats.primary_mac, host_mac, MAC_ADDRESS_LENGTH);
+    }
+    return ESP_OK;
+}
+
+void fpr_client_get_standby_stats(fpr_standby_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    *stats = STANDBY.stats;
+}
+
+int64_t _fpr_client_reconnect_job(int64_t now_us)
+{
+    // Answers to an earlier rebalance or standby probe
+    _select_probe_tick(now_us);
+    if (SELECT.rebalance_requested && SELECT.probe == FPR_SELECT_PROBE_NONE) {
+        SELECT.rebalance_requested = false;
+        _select_rebalance(now_us);
+    }
+    _standby_tick(now_us);
+    
+    // Get power-adjusted intervals
+    const int64_t keep_interval_us = (int64_t)_fpr_get_power_adjusted_interval(FPR_KEEPALIVE_INTERVAL_MS) * 1000;
+    const int64_t check_interval_us = (int64_t)_fpr_get_power_adjusted_interval(FPR_CLIENT_WAIT_CHECK_INTERVAL_MS) * 1000;
+    const int64_t timeout_us = (int64_t)_fpr_get_power_adjusted_interval(FPR_RECONNECT_TIMEOUT_MS) * 1000;
+    int64_t next_us = now_us + check_interval_us;
+    
+    // If connected, send periodic keepalive and check for host timeout
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    FPR_STORE_HASH_TYPE *host_peer = NULL;
+    if (fpr_client_get_host_info(host_mac, NULL, 0) == ESP_OK) {
+        host_peer = _get_peer_from_map(host_mac);
+        if (host_peer && host_peer->is_connected) {
+            // keepalive send periodically
+            if (now_us - fpr_net.keepalive_sent_us >= keep_interval_us) {
+                esp_err_t err = fpr_network_send_device_info(host_mac);
+                if (err != ESP_OK) {
+                    ESP_LOGD(TAG, "Keepalive to host failed: %s", esp_err_to_name(err));
                 }
+                fpr_net.keepalive_sent_us = now_us;
+            }
+
+            // check last seen timestamp (in microseconds)
+            int64_t age_us = now_us - host_peer->last_seen;
+            if (age_us > timeout_us) {
+                ESP_LOGW(TAG, "Host timed out (age %llu ms) - marking disconnected for reconnect", (unsigned long long)US_TO_MS(age_us));
+                _peer_set_state(host_peer, FPR_PEER_STATE_DISCOVERED, FPR_EVENT_REASON_TIMEOUT);
+                #if (FPR_CHANNEL_RESCAN_ON_LOSS == 1)
+                // The host may have moved to another channel while we were not listening.
+                // The sweep runs as its own job so keepalives are not held up.
+                _sweep_start(NULL, 0, NULL);
+                #endif
             }
         }
+    }
+    
+    if (host_peer && host_peer->is_connected) {
+        // Nothing to do until the next keepalive or until the host could time out
+        next_us = fpr_net.keepalive_sent_us + keep_interval_us;
+        int64_t timeout_at_us = host_peer->last_seen + timeout_us + 1;
+        if (timeout_at_us < next_us) {
+            next_us = timeout_at_us;
+        }
+    } else if (!fpr_client_is_connected() && !fpr_net.probe.sweeping) {
+        // Ask hosts to announce themselves instead of waiting for their next broadcast
+        _send_probe_request();
+    }
 
-        vTaskDelay(check_interval_ticks);
+    int64_t probe_at_us = _select_probe_next_us();
+    if (probe_at_us != 0 && probe_at_us < next_us) {
+        next_us = probe_at_us;
     }
-}
\ No newline at end of file
+    
+    if (STANDBY.enabled) {
+        int64_t heartbeat_at_us = now_us + (int64_t)FPR_STANDBY_HEARTBEAT_MS * 1000;
+        if (heartbeat_at_us < next_us) {
+            next_us = heartbeat_at_us;
+        }
+    }
+    return next_us;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file fpr_event.c
+ * @brief FPR Connection Event Stream implementation
+ *
+ * Events are raised through _fpr_event_emit() from the peer state helpers,
+ * the handshake, the extender route table and the receive queue. The queue
+ * is created once and kept across fpr_network_deinit(), so a task blocked
+ * in fpr_event_wait() never sees it deleted.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_event.h"
+#include "fpr/internal/helpers.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include <string.h>
+
+static const char *TAG = "fpr_event";
+
+static QueueHandle_t s_queue;
+static portMUX_TYPE s_cb_lock = portMUX_INITIALIZER_UNLOCKED;
+static fpr_event_cb_t s_cb;
+static void *s_cb_user_data;
+static uint32_t s_dropped;
+
+void _fpr_event_init(void)
+{
+    __atomic_store_n(&s_dropped, 0, __ATOMIC_RELAXED);
+    if (s_queue != NULL) {
+        xQueueReset(s_queue);
+        return;
+    }
+    #if (FPR_EVENT_QUEUE_LENGTH > 0)
+    s_queue = xQueueCreate(FPR_EVENT_QUEUE_LENGTH, sizeof(fpr_event_t));
+    if (s_queue == NULL) {
+        ESP_LOGW(TAG, "No memory for the event queue, only the callback will be used");
+    }
+    #endif
+}
+
+void _fpr_event_emit(fpr_event_t *event)
+{
+    event->timestamp_us = esp_timer_get_time();
+    event->network_id = fpr_net.network_id;
+
+    taskENTER_CRITICAL(&s_cb_lock);
+    fpr_event_cb_t cb = s_cb;
+    void *user_data = s_cb_user_data;
+    taskEXIT_CRITICAL(&s_cb_lock);
+    if (cb != NULL) {
+        FPR_APP_CALLBACK(cb(event, user_data));
+    }
+
+    if (s_queue != NULL && xQueueSend(s_queue, event, 0) != pdPASS) {
+        __atomic_fetch_add(&s_dropped, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void _fpr_event_peer(fpr_event_type_t type, const uint8_t *peer_mac)
+{
+    fpr_event_t event = { .type = type };
+    memcpy(event.peer_mac, peer_mac, sizeof(event.peer_mac));
+    _fpr_event_emit(&event);
+}
+
+esp_err_t fpr_event_wait(fpr_event_t *event, TickType_t timeout)
+{
+    ESP_RETURN_ON_FALSE(event != NULL, ESP_ERR_INVALID_ARG, TAG, "Event is NULL");
+    if (s_queue == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return xQueueReceive(s_queue, event, timeout) == pdPASS ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+void fpr_event_register_callback(fpr_event_cb_t cb, void *user_data)
+{
+    taskENTER_CRITICAL(&s_cb_lock);
+    s_cb = cb;
+    s_cb_user_data = user_data;
+    taskEXIT_CRITICAL(&s_cb_lock);
+}
+
+uint32_t fpr_event_get_dropped(void)
+{
+    return __atomic_load_n(&s_dropped, __ATOMIC_RELAXED);
+}
+
+const char *fpr_event_type_to_name(fpr_event_type_t type)
+{
+    switch (type) {
+        case FPR_EVENT_PEER_DISCOVERED: return "discovered";
+        case FPR_EVENT_HANDSHAKE:       return "handshake";
+        case FPR_EVENT_CONNECTED:       return "connected";
+        case FPR_EVENT_DISCONNECTED:    return "disconnected";
+        case FPR_EVENT_BLOCKED:         return "blocked";
+        case FPR_EVENT_ROUTE_CHANGED:   return "route changed";
+        case FPR_EVENT_QUEUE_OVERFLOW:  return "queue overflow";
+        default:                        return "unknown";
+    }
+}
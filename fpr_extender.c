@@ -12,8 +12,16 @@
  */
 
 #include "fpr/fpr_extender.h"
+#include "fpr/internal/log.h"
+#include "fpr/internal/scheduler.h"
 #include "esp_log.h"
 #include "esp_check.h"
+#include <stdlib.h>
+
+extern bool _fpr_aggregate_absorb(const fpr_package_t *package);
+extern void _fpr_aggregate_deliver(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package);
+extern bool _fpr_tree_on_rx(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *package);
+extern bool _fpr_timesync_on_rx(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *package);
 
 // ========== EXTENDER MODE HANDLERS ==========
 //
@@ -69,6 +77,14 @@ static bool _should_forward_packet(fpr_package_t *package, const uint8_t *src_ma
     return (is_broadcast_dest || !is_for_me);
 }
 
+static void _route_changed(const FPR_STORE_HASH_TYPE *peer)
+{
+    fpr_event_t event = { .type = FPR_EVENT_ROUTE_CHANGED, .route.hops = peer->hop_count };
+    memcpy(event.peer_mac, peer->peer_info.peer_addr, sizeof(event.peer_mac));
+    memcpy(event.route.next_hop, peer->next_hop_mac, sizeof(event.route.next_hop));
+    _fpr_event_emit(&event);
+}
+
 static esp_err_t fpr_send_data_full_control(uint8_t *peer_address, void *data, int size, const fpr_send_options_full_control_t *options)
 {
     ESP_RETURN_ON_FALSE(data != NULL && size > 0, ESP_ERR_INVALID_ARG, TAG, "Invalid data or size");
@@ -90,15 +106,636 @@ static esp_err_t fpr_send_data_full_control(uint8_t *peer_address, void *data, i
     package.hop_count = 0;
     package.max_hops = options->max_hops > 0 ? options->max_hops : FPR_DEFAULT_MAX_HOPS;
     
-    esp_err_t result = esp_now_send(peer_address, (const uint8_t *)&package, sizeof(package));
+    esp_err_t result = _fpr_radio_send(peer_address, &package);
     if (result == ESP_OK) {
-        fpr_net.stats.packets_sent++;
+        _fpr_stat_add(FPR_STAT_PACKETS_SENT, 1);
     } else {
-        fpr_net.stats.send_failures++;
+        _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
     }
     return result;
 }
 
+// ========== STORE-AND-FORWARD ==========
+//
+// Undeliverable unicast frames wait here, keyed by dest_mac, until their
+// destination or its next hop is heard again. A frame is undeliverable when
+// there is no route, the route aged out, or the send failed - either at once
+// or in the radio's send result. Expiry is checked lazily on every receive,
+// so no timer is needed.
+
+#define STORE fpr_net.store
+#define STORE_INFLIGHT 4    // Forwarded frames remembered until their send result
+
+static esp_err_t _forward_package(uint8_t *next_hop, fpr_package_t *package)
+{
+    fpr_send_options_full_control_t options = {
+        .package_type = package->package_type,
+        .package_id = package->id,
+        .max_hops = package->max_hops
+    };
+    return fpr_send_data_full_control(next_hop, (void *)&package->protocol, sizeof(package->protocol), &options);
+}
+
+// A route is usable while its next hop keeps being heard
+static bool _route_usable(FPR_STORE_HASH_TYPE *dest_peer, int64_t now)
+{
+    if (dest_peer == NULL || dest_peer->hop_count == 0) {
+        return false;
+    }
+    FPR_STORE_HASH_TYPE *next_hop = _get_peer_from_map(dest_peer->next_hop_mac);
+    int64_t last_heard = next_hop ? next_hop->last_seen : dest_peer->last_seen;
+    if (now - last_heard <= (int64_t)FPR_EXTENDER_ROUTE_MAX_AGE_MS * 1000) {
+        return true;
+    }
+    dest_peer->hop_count = 0;
+    _route_changed(dest_peer);
+    taskENTER_CRITICAL(&STORE.lock);
+    STORE.stats.routes_expired++;
+    taskEXIT_CRITICAL(&STORE.lock);
+    FPR_LOGI_RL(TAG, "Route to " MACSTR " expired", MAC2STR(dest_peer->peer_info.peer_addr));
+    return false;
+}
+
+// Must be called with the lock held
+static void _store_expire(int64_t now)
+{
+    int64_t max_age_us = (int64_t)FPR_EXTENDER_STORE_MAX_AGE_MS * 1000;
+    for (int i = 0; i < FPR_EXTENDER_STORE_SIZE; i++) {
+        if (STORE.entries[i].used && now - STORE.entries[i].stored_us > max_age_us) {
+            STORE.entries[i].used = false;
+            STORE.stats.held--;
+            STORE.stats.expired++;
+        }
+    }
+}
+
+// Returns false if store-and-forward is off and the frame must be dropped
+static bool _store_hold(const fpr_package_t *package)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&STORE.lock);
+    if (STORE.entries == NULL) {
+        taskEXIT_CRITICAL(&STORE.lock);
+        return false;
+    }
+    _store_expire(now);
+
+    // Find a free entry, this destination's oldest frame and the overall oldest
+    int free_idx = -1, oldest_dest = -1, oldest_any = -1, dest_count = 0;
+    for (int i = 0; i < FPR_EXTENDER_STORE_SIZE; i++) {
+        fpr_extender_store_entry_t *entry = &STORE.entries[i];
+        if (!entry->used) {
+            if (free_idx < 0) {
+                free_idx = i;
+            }
+            continue;
+        }
+        if (oldest_any < 0 || entry->stored_us < STORE.entries[oldest_any].stored_us) {
+            oldest_any = i;
+        }
+        if (memcmp(entry->package.dest_mac, package->dest_mac, MAC_ADDRESS_LENGTH) == 0) {
+            dest_count++;
+            if (oldest_dest < 0 || entry->stored_us < STORE.entries[oldest_dest].stored_us) {
+                oldest_dest = i;
+            }
+        }
+    }
+
+    int idx = free_idx;
+    if (dest_count >= FPR_EXTENDER_STORE_PER_DEST) {
+        idx = oldest_dest;
+    } else if (idx < 0) {
+        idx = oldest_any;
+    }
+    if (STORE.entries[idx].used) {
+        STORE.stats.evicted++;
+    } else {
+        STORE.stats.held++;
+    }
+    STORE.entries[idx].used = true;
+    STORE.entries[idx].stored_us = now;
+    STORE.entries[idx].package = *package;
+    STORE.stats.stored++;
+    taskEXIT_CRITICAL(&STORE.lock);
+    return true;
+}
+
+// Remember a forwarded frame until the radio reports its send result. The
+// oldest entry is reused, so a burst larger than STORE_INFLIGHT loses the
+// earliest frames' second chance, not the frames themselves.
+static void _inflight_add(const uint8_t *next_hop, const fpr_package_t *package)
+{
+    taskENTER_CRITICAL(&STORE.lock);
+    if (STORE.inflight == NULL) {
+        taskEXIT_CRITICAL(&STORE.lock);
+        return;
+    }
+    int idx = 0;
+    for (int i = 0; i < STORE_INFLIGHT; i++) {
+        if (!STORE.inflight[i].used) {
+            idx = i;
+            break;
+        }
+        if (STORE.inflight[i].stored_us < STORE.inflight[idx].stored_us) {
+            idx = i;
+        }
+    }
+    fpr_extender_store_entry_t *entry = &STORE.inflight[idx];
+    entry->used = true;
+    entry->stored_us = esp_timer_get_time();
+    memcpy(entry->next_hop, next_hop, MAC_ADDRESS_LENGTH);
+    entry->package = *package;
+    taskEXIT_CRITICAL(&STORE.lock);
+}
+
+void _fpr_extender_on_send_status(const uint8_t *dest, bool success)
+{
+    if (dest == NULL || fpr_net.current_mode != FPR_MODE_EXTENDER) {
+        return;
+    }
+
+    // Results for one neighbour arrive in send order: the oldest frame to it is this one
+    fpr_package_t package;
+    bool failed = false;
+    taskENTER_CRITICAL(&STORE.lock);
+    int idx = -1;
+    for (int i = 0; STORE.inflight != NULL && i < STORE_INFLIGHT; i++) {
+        fpr_extender_store_entry_t *entry = &STORE.inflight[i];
+        if (entry->used && memcmp(entry->next_hop, dest, MAC_ADDRESS_LENGTH) == 0 &&
+            (idx < 0 || entry->stored_us < STORE.inflight[idx].stored_us)) {
+            idx = i;
+        }
+    }
+    if (idx >= 0) {
+        STORE.inflight[idx].used = false;
+        if (!success) {
+            package = STORE.inflight[idx].package;
+            STORE.stats.send_failed++;
+            failed = true;
+        }
+    }
+    taskEXIT_CRITICAL(&STORE.lock);
+    if (!failed) {
+        return;
+    }
+
+    // The neighbour did not acknowledge: stop routing through it until it is heard again
+    FPR_STORE_HASH_TYPE *dest_peer = _get_peer_from_map(package.dest_mac);
+    if (dest_peer != NULL && dest_peer->hop_count > 0 &&
+        memcmp(dest_peer->next_hop_mac, dest, MAC_ADDRESS_LENGTH) == 0) {
+        dest_peer->hop_count = 0;
+        _route_changed(dest_peer);
+    }
+    _store_hold(&package);
+}
+
+// Forward the held frames that heard, just received from, may lead to:
+// frames for it, and frames routed through it
+static void _store_flush(const uint8_t *heard)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&STORE.lock);
+    bool empty = (STORE.entries == NULL || STORE.stats.held == 0);
+    if (!empty) {
+        _store_expire(now);
+    }
+    taskEXIT_CRITICAL(&STORE.lock);
+    if (empty) {
+        return;
+    }
+
+    for (int i = 0; i < FPR_EXTENDER_STORE_SIZE; i++) {
+        fpr_package_t package;
+        FPR_STORE_HASH_TYPE *dest_peer = NULL;
+
+        taskENTER_CRITICAL(&STORE.lock);
+        if (STORE.entries == NULL) {
+            taskEXIT_CRITICAL(&STORE.lock);
+            return;
+        }
+        if (STORE.entries[i].used) {
+            dest_peer = _get_peer_from_map(STORE.entries[i].package.dest_mac);
+            bool via_heard = dest_peer && (memcmp(dest_peer->peer_info.peer_addr, heard, MAC_ADDRESS_LENGTH) == 0 ||
+                                           memcmp(dest_peer->next_hop_mac, heard, MAC_ADDRESS_LENGTH) == 0);
+            if (via_heard && dest_peer->hop_count > 0) {
+                package = STORE.entries[i].package;
+                STORE.entries[i].used = false;
+                STORE.stats.held--;
+            } else {
+                dest_peer = NULL;
+            }
+        }
+        taskEXIT_CRITICAL(&STORE.lock);
+
+        if (dest_peer == NULL) {
+            continue;
+        }
+        if (_forward_package(dest_peer->next_hop_mac, &package) == ESP_OK) {
+            _inflight_add(dest_peer->next_hop_mac, &package);
+            _fpr_stat_add(FPR_STAT_PACKETS_FORWARDED, 1);
+            taskENTER_CRITICAL(&STORE.lock);
+            STORE.stats.delivered++;
+            taskEXIT_CRITICAL(&STORE.lock);
+        } else {
+            // Keep trying when the next hop is heard again, until the frame expires
+            _store_hold(&package);
+        }
+    }
+}
+
+// Send a frame built on this node (merged reports) towards its final
+// destination. Unlike forwarding, origin_mac and dest_mac stay as built.
+esp_err_t _fpr_extender_forward(const fpr_package_t *package)
+{
+    FPR_STORE_HASH_TYPE *dest_peer = _get_peer_from_map(package->dest_mac);
+    if (_route_usable(dest_peer, esp_timer_get_time())) {
+        esp_err_t err = _fpr_radio_send(dest_peer->next_hop_mac, package);
+        if (err == ESP_OK) {
+            _inflight_add(dest_peer->next_hop_mac, package);
+            _fpr_stat_add(FPR_STAT_PACKETS_SENT, 1);
+            return ESP_OK;
+        }
+        _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
+    }
+    return _store_hold(package) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+void _fpr_extender_store_init(void)
+{
+    memset(&STORE, 0, sizeof(STORE));
+    portMUX_INITIALIZE(&STORE.lock);
+}
+
+void _fpr_extender_store_deinit(void)
+{
+    fpr_extender_set_store_and_forward(false);
+}
+
+esp_err_t fpr_extender_set_store_and_forward(bool enable)
+{
+    fpr_extender_store_entry_t *entries = NULL;
+    if (enable) {
+        // Held frames first, then the in-flight ones
+        entries = calloc(FPR_EXTENDER_STORE_SIZE + STORE_INFLIGHT, sizeof(fpr_extender_store_entry_t));
+        ESP_RETURN_ON_FALSE(entries != NULL, ESP_ERR_NO_MEM, TAG, "Failed to allocate store");
+    }
+
+    taskENTER_CRITICAL(&STORE.lock);
+    fpr_extender_store_entry_t *old = STORE.entries;
+    if (enable && old != NULL) {
+        // Already enabled; keep what is held
+        taskEXIT_CRITICAL(&STORE.lock);
+        free(entries);
+        return ESP_OK;
+    }
+    STORE.entries = entries;
+    STORE.inflight = entries ? entries + FPR_EXTENDER_STORE_SIZE : NULL;
+    STORE.stats.enabled = enable;
+    if (!enable) {
+        STORE.stats.held = 0;
+    }
+    taskEXIT_CRITICAL(&STORE.lock);
+
+    free(old);
+    return ESP_OK;
+}
+
+void fpr_extender_get_store_stats(fpr_extender_store_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&STORE.lock);
+    *stats = STORE.stats;
+    taskEXIT_CRITICAL(&STORE.lock);
+}
+
+// ========== BROADCAST RELAYS (MPR) ==========
+//
+// Flooding makes every extender rebroadcast every broadcast. Instead, each
+// extender lists the neighbors it hears in a hello and marks the ones it
+// picked as multipoint relays (MPRs): a small subset of its symmetric
+// neighbors that together reach all of its two-hop neighbors. A broadcast
+// is only rebroadcast by the relays its last sender picked. Senders not yet
+// known from a hello are flooded as before, so the network works while
+// hellos converge. A duplicate cache keyed by origin and sequence number
+// makes each broadcast delivered and rebroadcast at most once.
+
+#define MPR fpr_net.mpr
+
+extern esp_err_t fpr_network_broadcast(void *data, int size, fpr_package_id_t package_id);
+
+// Relay selection runs on a copy so the lock is not held while it loops.
+// Only the hello job selects, so the scratch space can be static.
+static fpr_mpr_neighbor_t s_mpr_snapshot[FPR_MPR_MAX_NEIGHBORS];
+static uint8_t s_mpr_two_hop[FPR_MPR_MAX_NEIGHBORS * FPR_MPR_MAX_NEIGHBORS][MAC_ADDRESS_LENGTH];
+static bool s_mpr_covered[FPR_MPR_MAX_NEIGHBORS * FPR_MPR_MAX_NEIGHBORS];
+
+// Must be called with the lock held
+static fpr_mpr_neighbor_t *_mpr_find(const uint8_t *mac)
+{
+    for (int i = 0; i < FPR_MPR_MAX_NEIGHBORS; i++) {
+        if (MPR.neighbors[i].in_use && memcmp(MPR.neighbors[i].mac, mac, MAC_ADDRESS_LENGTH) == 0) {
+            return &MPR.neighbors[i];
+        }
+    }
+    return NULL;
+}
+
+static bool _mpr_covers(const fpr_mpr_neighbor_t *n, const uint8_t *mac)
+{
+    for (int i = 0; i < n->two_hop_count; i++) {
+        if (memcmp(n->two_hop[i], mac, MAC_ADDRESS_LENGTH) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool _mpr_is_symmetric_neighbor(const uint8_t *mac)
+{
+    for (int i = 0; i < FPR_MPR_MAX_NEIGHBORS; i++) {
+        if (s_mpr_snapshot[i].in_use && s_mpr_snapshot[i].symmetric &&
+            memcmp(s_mpr_snapshot[i].mac, mac, MAC_ADDRESS_LENGTH) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Greedy OLSR heuristic on the snapshot: first every neighbor that is the
+// only way to some two-hop node, then whoever covers the most uncovered
+// two-hop nodes, until all are covered.
+static int _mpr_select(void)
+{
+    int two_hop = 0;
+    for (int i = 0; i < FPR_MPR_MAX_NEIGHBORS; i++) {
+        fpr_mpr_neighbor_t *n = &s_mpr_snapshot[i];
+        n->relay = false;
+        if (!n->in_use || !n->symmetric) {
+            continue;
+        }
+        for (int j = 0; j < n->two_hop_count; j++) {
+            const uint8_t *mac = n->two_hop[j];
+            if (memcmp(mac, fpr_net.mac, MAC_ADDRESS_LENGTH) == 0 || _mpr_is_symmetric_neighbor(mac)) {
+                continue;
+            }
+            bool known = false;
+            for (int k = 0; k < two_hop && !known; k++) {
+                known = memcmp(s_mpr_two_hop[k], mac, MAC_ADDRESS_LENGTH) == 0;
+            }
+            if (!known) {
+                memcpy(s_mpr_two_hop[two_hop], mac, MAC_ADDRESS_LENGTH);
+                s_mpr_covered[two_hop] = false;
+                two_hop++;
+            }
+        }
+    }
+
+    for (int k = 0; k < two_hop; k++) {
+        int only = -1, coverers = 0;
+        for (int i = 0; i < FPR_MPR_MAX_NEIGHBORS; i++) {
+            fpr_mpr_neighbor_t *n = &s_mpr_snapshot[i];
+            if (n->in_use && n->symmetric && _mpr_covers(n, s_mpr_two_hop[k])) {
+                only = i;
+                coverers++;
+            }
+        }
+        if (coverers == 1) {
+            s_mpr_snapshot[only].relay = true;
+        }
+    }
+
+    for (;;) {
+        int best = -1, best_gain = 0;
+        for (int k = 0; k < two_hop; k++) {
+            if (s_mpr_covered[k]) {
+                continue;
+            }
+            for (int i = 0; i < FPR_MPR_MAX_NEIGHBORS; i++) {
+                if (s_mpr_snapshot[i].relay && _mpr_covers(&s_mpr_snapshot[i], s_mpr_two_hop[k])) {
+                    s_mpr_covered[k] = true;
+                    break;
+                }
+            }
+        }
+        for (int i = 0; i < FPR_MPR_MAX_NEIGHBORS; i++) {
+            fpr_mpr_neighbor_t *n = &s_mpr_snapshot[i];
+            if (!n->in_use || !n->symmetric || n->relay) {
+                continue;
+            }
+            int gain = 0;
+            for (int k = 0; k < two_hop; k++) {
+                if (!s_mpr_covered[k] && _mpr_covers(n, s_mpr_two_hop[k])) {
+                    gain++;
+                }
+            }
+            if (gain > best_gain) {
+                best = i;
+                best_gain = gain;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        s_mpr_snapshot[best].relay = true;
+    }
+    return two_hop;
+}
+
+static int64_t _mpr_job(int64_t now)
+{
+    const int64_t next_us = now + (int64_t)FPR_MPR_HELLO_INTERVAL_MS * 1000;
+    if (!MPR.ready || fpr_net.current_mode != FPR_MODE_EXTENDER) {
+        return 0;
+    }
+    const int64_t timeout_us = (int64_t)FPR_MPR_NEIGHBOR_TIMEOUT_MS * 1000;
+
+    taskENTER_CRITICAL(&MPR.lock);
+    for (int i = 0; i < FPR_MPR_MAX_NEIGHBORS; i++) {
+        if (MPR.neighbors[i].in_use && now - MPR.neighbors[i].last_heard_us > timeout_us) {
+            MPR.neighbors[i].in_use = false;
+        }
+    }
+    memcpy(s_mpr_snapshot, MPR.neighbors, sizeof(s_mpr_snapshot));
+    taskEXIT_CRITICAL(&MPR.lock);
+
+    int two_hop = _mpr_select();
+
+    fpr_mpr_hello_t hello = {0};
+    uint8_t neighbors = 0, symmetric = 0, relays = 0, selectors = 0;
+    taskENTER_CRITICAL(&MPR.lock);
+    for (int i = 0; i < FPR_MPR_MAX_NEIGHBORS; i++) {
+        fpr_mpr_neighbor_t *n = &MPR.neighbors[i];
+        if (!n->in_use) {
+            continue;
+        }
+        // The slot may have been reused by a hello since the snapshot
+        n->relay = s_mpr_snapshot[i].in_use && s_mpr_snapshot[i].relay &&
+                   memcmp(s_mpr_snapshot[i].mac, n->mac, MAC_ADDRESS_LENGTH) == 0;
+        memcpy(hello.neighbors[hello.count], n->mac, MAC_ADDRESS_LENGTH);
+        if (n->relay) {
+            hello.relay_bits[hello.count / 8] |= (uint8_t)(1 << (hello.count % 8));
+            relays++;
+        }
+        hello.count++;
+        neighbors++;
+        symmetric += n->symmetric ? 1 : 0;
+        selectors += n->selector ? 1 : 0;
+    }
+    MPR.stats.neighbors = neighbors;
+    MPR.stats.symmetric = symmetric;
+    MPR.stats.two_hop = (uint8_t)(two_hop > UINT8_MAX ? UINT8_MAX : two_hop);
+    MPR.stats.relays = relays;
+    MPR.stats.selectors = selectors;
+    MPR.stats.hellos_tx++;
+    taskEXIT_CRITICAL(&MPR.lock);
+
+    fpr_network_broadcast(&hello, sizeof(hello), FPR_PACKET_ID_MPR);
+    return next_us;
+}
+
+static void _mpr_handle_hello(const esp_now_recv_info_t *esp_now_info, const fpr_mpr_hello_t *hello)
+{
+    uint8_t count = hello->count > FPR_MPR_HELLO_MAX ? FPR_MPR_HELLO_MAX : hello->count;
+
+    taskENTER_CRITICAL(&MPR.lock);
+    fpr_mpr_neighbor_t *n = _mpr_find(esp_now_info->src_addr);
+    for (int i = 0; n == NULL && i < FPR_MPR_MAX_NEIGHBORS; i++) {
+        if (!MPR.neighbors[i].in_use) {
+            n = &MPR.neighbors[i];
+            memset(n, 0, sizeof(*n));
+            n->in_use = true;
+            memcpy(n->mac, esp_now_info->src_addr, MAC_ADDRESS_LENGTH);
+        }
+    }
+    if (n != NULL) {
+        n->last_heard_us = esp_timer_get_time();
+        n->symmetric = false;
+        n->selector = false;
+        n->two_hop_count = 0;
+        for (int i = 0; i < count; i++) {
+            const uint8_t *mac = hello->neighbors[i];
+            if (memcmp(mac, fpr_net.mac, MAC_ADDRESS_LENGTH) == 0) {
+                n->symmetric = true;
+                n->selector = (hello->relay_bits[i / 8] >> (i % 8)) & 1;
+            } else if (n->two_hop_count < FPR_MPR_MAX_NEIGHBORS) {
+                memcpy(n->two_hop[n->two_hop_count++], mac, MAC_ADDRESS_LENGTH);
+            }
+        }
+    }
+    taskEXIT_CRITICAL(&MPR.lock);
+}
+
+// Returns false for a broadcast already handled
+static bool _mpr_first_sight(const fpr_package_t *package)
+{
+    // Legacy senders leave the sequence number at 0: nothing to match on
+    if (package->sequence_num == 0) {
+        return true;
+    }
+    bool seen = false;
+    taskENTER_CRITICAL(&MPR.lock);
+    for (int i = 0; i < FPR_MPR_DUP_CACHE_SIZE && !seen; i++) {
+        seen = MPR.seen[i].sequence_num == package->sequence_num &&
+               memcmp(MPR.seen[i].origin, package->origin_mac, MAC_ADDRESS_LENGTH) == 0;
+    }
+    if (seen) {
+        MPR.stats.duplicates++;
+    } else {
+        memcpy(MPR.seen[MPR.seen_next].origin, package->origin_mac, MAC_ADDRESS_LENGTH);
+        MPR.seen[MPR.seen_next].sequence_num = package->sequence_num;
+        MPR.seen_next = (MPR.seen_next + 1) % FPR_MPR_DUP_CACHE_SIZE;
+        MPR.stats.received++;
+    }
+    taskEXIT_CRITICAL(&MPR.lock);
+    return !seen;
+}
+
+// Whether flooding's rebroadcast of this frame is needed
+static bool _mpr_should_relay(const uint8_t *sender)
+{
+    taskENTER_CRITICAL(&MPR.lock);
+    bool relay = true;
+    if (MPR.enabled) {
+        fpr_mpr_neighbor_t *n = _mpr_find(sender);
+        // Unknown senders are flooded until their hellos arrive
+        relay = (n == NULL || !n->symmetric || n->selector);
+    }
+    if (!relay) {
+        MPR.stats.suppressed++;
+    }
+    taskEXIT_CRITICAL(&MPR.lock);
+    return relay;
+}
+
+// Send a broadcast on unchanged, so origin and sequence still identify it
+static esp_err_t _mpr_rebroadcast(const fpr_package_t *package)
+{
+    const uint8_t broadcast_mac[6] = FPR_BROADCAST_ADDRESS;
+    esp_err_t err = _fpr_radio_send(broadcast_mac, package);
+    if (err == ESP_OK) {
+        _fpr_stat_add(FPR_STAT_PACKETS_SENT, 1);
+        taskENTER_CRITICAL(&MPR.lock);
+        MPR.stats.rebroadcast++;
+        taskEXIT_CRITICAL(&MPR.lock);
+    } else {
+        _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
+    }
+    return err;
+}
+
+void _fpr_extender_mpr_init(void)
+{
+    memset(&MPR, 0, sizeof(MPR));
+    portMUX_INITIALIZE(&MPR.lock);
+    MPR.enabled = FPR_MPR_ENABLE;
+    MPR.stats.mpr_enabled = MPR.enabled;
+    MPR.ready = true;
+}
+
+void _fpr_extender_mpr_on_mode_set(void)
+{
+    if (!MPR.ready) {
+        return;
+    }
+    if (fpr_net.current_mode != FPR_MODE_EXTENDER) {
+        _fpr_sched_cancel(FPR_JOB_MPR);
+    } else if (!_fpr_sched_is_armed(FPR_JOB_MPR)) {
+        // First hello right away so neighbors learn about us without waiting a period
+        _fpr_sched_set(FPR_JOB_MPR, _mpr_job, 0);
+    }
+}
+
+void _fpr_extender_mpr_deinit(void)
+{
+    MPR.ready = false;
+    _fpr_sched_cancel(FPR_JOB_MPR);
+}
+
+esp_err_t fpr_extender_set_mpr(bool enable)
+{
+    ESP_RETURN_ON_FALSE(MPR.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    taskENTER_CRITICAL(&MPR.lock);
+    MPR.enabled = enable;
+    MPR.stats.mpr_enabled = enable;
+    taskEXIT_CRITICAL(&MPR.lock);
+    ESP_LOGI(TAG, "Broadcasts %s", enable ? "rebroadcast by multipoint relays only" : "flooded");
+    return ESP_OK;
+}
+
+void fpr_extender_get_broadcast_stats(fpr_extender_broadcast_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&MPR.lock);
+    *stats = MPR.stats;
+    taskEXIT_CRITICAL(&MPR.lock);
+}
+
 void _handle_extender_receive(const esp_now_recv_info_t *esp_now_info, const uint8_t *data, int len)
 {
     #if (FPR_DEBUG_LOG_EXTENDER_DATA_RECEIVE == 1)
@@ -108,21 +745,25 @@ void _handle_extender_receive(const esp_now_recv_info_t *esp_now_info, const uin
     
     // Check if network is paused
     if (fpr_net.paused) {
-        fpr_net.stats.packets_dropped++;
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_PAUSED, esp_now_info->src_addr, NULL);
         return;  // Drop all packets when paused
     }
     
     if (!is_fpr_package_compatible(len)) {
-        fpr_net.stats.packets_dropped++;
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_MALFORMED, esp_now_info->src_addr, NULL);
         return;
     }
     
-    fpr_net.stats.packets_received++;
+    _fpr_stat_add(FPR_STAT_PACKETS_RECEIVED, 1);
     fpr_package_t *package = (fpr_package_t *)data;
+    FPR_TRACE(FPR_TRACE_RX, package->package_type, esp_now_info->src_addr, package);
     
     // Version handling (using fpr_handle.h)
     if (!fpr_version_handle_version(esp_now_info, data, len, package->version)) {
-        fpr_net.stats.packets_dropped++;
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_VERSION, esp_now_info->src_addr, package);
         return; // Version handler rejected the packet
     }
     
@@ -136,8 +777,9 @@ void _handle_extender_receive(const esp_now_recv_info_t *esp_now_info, const uin
         if (package->hop_count + 1 < peer->hop_count || peer->hop_count == 0) {
             peer->hop_count = package->hop_count + 1;
             memcpy(peer->next_hop_mac, esp_now_info->src_addr, 6);
-            ESP_LOGI(TAG, "Updated route to " MACSTR " via " MACSTR " (hops: %d)", 
-                     MAC2STR(package->origin_mac), MAC2STR(esp_now_info->src_addr), peer->hop_count);
+            _route_changed(peer);
+            FPR_LOGI_RL(TAG, "Updated route to " MACSTR " via " MACSTR " (hops: %d)",
+                        MAC2STR(package->origin_mac), MAC2STR(esp_now_info->src_addr), peer->hop_count);
         }
     } else {
         // Add new peer to routing table
@@ -147,39 +789,85 @@ void _handle_extender_receive(const esp_now_recv_info_t *esp_now_info, const uin
             peer->hop_count = package->hop_count + 1;
             memcpy(peer->next_hop_mac, esp_now_info->src_addr, 6);
             _update_peer_rssi_and_timestamp(peer, esp_now_info);
+            _route_changed(peer);
         }
     }
     
+    // A neighbour we just heard may be the route held frames were waiting for
+    _store_flush(esp_now_info->src_addr);
+    
+    // Tree beacons and upstream data follow the tree, not the route table
+    if (_fpr_tree_on_rx(esp_now_info, package)) {
+        return;
+    }
+    
+    // Time is synced hop by hop, never forwarded
+    if (_fpr_timesync_on_rx(esp_now_info, package)) {
+        return;
+    }
+    
+    // Neighbor hellos only ever travel one hop
+    if (package->id == FPR_PACKET_ID_MPR) {
+        if (is_broadcast_address(esp_now_info->des_addr)) {
+            _mpr_handle_hello(esp_now_info, (const fpr_mpr_hello_t *)&package->protocol);
+        }
+        return;
+    }
+    
     // Check if this packet is for us
     bool is_for_me = (memcmp(package->dest_mac, fpr_net.mac, 6) == 0);
     const uint8_t broadcast_mac[6] = FPR_BROADCAST_ADDRESS;
     bool is_broadcast = (memcmp(package->dest_mac, broadcast_mac, 6) == 0);
     
-    if (is_for_me || is_broadcast) {
+    // Every relay rebroadcasts, so the same broadcast arrives several times
+    if (is_broadcast && !_mpr_first_sight(package)) {
+        return;
+    }
+    
+    if (is_for_me && package->id == FPR_PACKET_ID_AGGREGATE) {
+        // Merged reports for us: unpack like a sink
+        if (peer) {
+            _fpr_aggregate_deliver(peer, package);
+        }
+    } else if (is_for_me || is_broadcast) {
         // Process locally (store in queue if peer exists)
         if (peer && peer->response_queue) {
             // Non-blocking enqueue to avoid delaying RX path
-            xQueueSend(peer->response_queue, data, 0);
+            if (xQueueSend(peer->response_queue, data, 0) == pdPASS) {
+                _peer_stats_on_enqueue(peer, true);
+                FPR_TRACE(FPR_TRACE_ENQUEUE, uxQueueMessagesWaiting(peer->response_queue), esp_now_info->src_addr, package);
+            } else {
+                _peer_stats_on_enqueue(peer, false);
+                FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_QUEUE_FULL, esp_now_info->src_addr, package);
+            }
         }
-        ESP_LOGI(TAG, "Extender received packet from " MACSTR " (hops: %d)", 
-                 MAC2STR(package->origin_mac), package->hop_count);
+        FPR_LOGI_RL(TAG, "Extender received packet from " MACSTR " (hops: %d)",
+                    MAC2STR(package->origin_mac), package->hop_count);
     }
     
     // Forward packet if routing enabled and appropriate
     if (fpr_net.routing_enabled && _should_forward_packet(package, esp_now_info->src_addr)) {
+        // Registered telemetry is held and sent on merged
+        if (!is_broadcast && _fpr_aggregate_absorb(package)) {
+            return;
+        }
+        
         package->hop_count++;  // Increment hop count
         
-        // Determine next hop
-        uint8_t *next_hop = NULL;
         if (is_broadcast) {
-            // Broadcast to all except sender
-            next_hop = (uint8_t *)broadcast_mac;
-        } else {
-            // Look up route to destination
-            FPR_STORE_HASH_TYPE *dest_peer = _get_peer_from_map(package->dest_mac);
-            if (dest_peer && dest_peer->hop_count > 0) {
-                next_hop = dest_peer->next_hop_mac;
+            // Only if the sender picked us as one of its relays
+            if (_mpr_should_relay(esp_now_info->src_addr) && _mpr_rebroadcast(package) == ESP_OK) {
+                _fpr_stat_add(FPR_STAT_PACKETS_FORWARDED, 1);
+                FPR_TRACE(FPR_TRACE_FORWARD, package->hop_count, esp_now_info->src_addr, package);
             }
+            return;
+        }
+        
+        // Look up route to destination
+        uint8_t *next_hop = NULL;
+        FPR_STORE_HASH_TYPE *dest_peer = _get_peer_from_map(package->dest_mac);
+        if (_route_usable(dest_peer, esp_timer_get_time())) {
+            next_hop = dest_peer->next_hop_mac;
         }
         
         if (next_hop) {
@@ -190,16 +878,20 @@ void _handle_extender_receive(const esp_now_recv_info_t *esp_now_info, const uin
             };
             esp_err_t err = fpr_send_data_full_control(next_hop, (void *)&package->protocol, sizeof(package->protocol), &options);
             if (err == ESP_OK) {
-                fpr_net.stats.packets_forwarded++;
-                ESP_LOGD(TAG, "Forwarded packet from " MACSTR " to " MACSTR " (hop %d/%d)",
-                         MAC2STR(package->origin_mac), MAC2STR(next_hop), 
-                         package->hop_count, package->max_hops);
+                _inflight_add(next_hop, package);
+                _fpr_stat_add(FPR_STAT_PACKETS_FORWARDED, 1);
+                FPR_TRACE(FPR_TRACE_FORWARD, package->hop_count, next_hop, package);
+                FPR_LOGD_RL(TAG, "Forwarded packet from " MACSTR " to " MACSTR " (hop %d/%d)",
+                            MAC2STR(package->origin_mac), MAC2STR(next_hop),
+                            package->hop_count, package->max_hops);
             } else {
-                fpr_net.stats.send_failures++;
-                ESP_LOGW(TAG, "Failed to forward packet: %s", esp_err_to_name(err));
+                _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
+                FPR_LOGW_RL(TAG, "Failed to forward packet: %s", esp_err_to_name(err));
+                _store_hold(package);
             }
-        } else {
-            fpr_net.stats.packets_dropped++;
+        } else if (!_store_hold(package)) {
+            _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+            FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_NO_ROUTE, esp_now_info->src_addr, package);
         }
     }
 }
\ No newline at end of file
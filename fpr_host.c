@@ -12,14 +12,166 @@
 #include "fpr/fpr_host.h"
 #include "fpr/fpr_security.h"
 #include "fpr/fpr_security_handshake.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/scheduler.h"
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_random.h"
 
 static const char *TAG = "fpr_host";
 
 extern esp_err_t fpr_network_send_device_info(uint8_t *peer_address);
 extern fpr_connect_t make_fpr_info_with_keys(bool include_pwk, bool include_lwk, const uint8_t *pwk, const uint8_t *lwk);
 extern esp_err_t fpr_network_send_to_peer(uint8_t *peer_address, void *data, int size, fpr_package_id_t package_id);
+extern esp_err_t fpr_network_broadcast(void *data, int size, fpr_package_id_t package_id);
+
+// ========== LOAD ADVERTISING ==========
+
+typedef struct {
+    uint8_t connected;
+    uint8_t queue_pct;
+    FPR_STORE_HASH_TYPE *weakest;   // Connected client with the lowest RSSI
+} host_load_ctx_t;
+
+static void _load_callback(void *key, void *value, void *user_data)
+{
+    (void)key;
+    FPR_STORE_HASH_TYPE *peer = (FPR_STORE_HASH_TYPE *)value;
+    host_load_ctx_t *ctx = (host_load_ctx_t *)user_data;
+    if (peer == NULL || peer->state != FPR_PEER_STATE_CONNECTED) {
+        return;
+    }
+    if (ctx->connected < UINT8_MAX) {
+        ctx->connected++;
+    }
+    if (peer->response_queue != NULL) {
+        uint8_t pct = (uint8_t)((uxQueueMessagesWaiting(peer->response_queue) * 100) / FPR_QUEUE_LENGTH);
+        if (pct > ctx->queue_pct) {
+            ctx->queue_pct = pct;
+        }
+    }
+    if (ctx->weakest == NULL || peer->rssi < ctx->weakest->rssi) {
+        ctx->weakest = peer;
+    }
+}
+
+static void _measure_load(fpr_host_load_t *load, host_load_ctx_t *ctx)
+{
+    hashmap_foreach(&fpr_net.peers_map, _load_callback, ctx);
+    load->flags = FPR_HOST_LOAD_VALID;
+    load->connected = ctx->connected;
+    load->capacity = fpr_net.host_config.max_peers > 0 ? fpr_net.host_config.max_peers : ESP_NOW_MAX_TOTAL_PEER_NUM;
+    load->queue_pct = ctx->queue_pct;
+
+    uint8_t threshold = fpr_net.host_config.rebalance_pct;
+    if (threshold > 0 && _fpr_host_load_pct(load) >= threshold) {
+        load->flags |= FPR_HOST_LOAD_OVERLOADED;
+    }
+}
+
+void _fpr_host_fill_load(fpr_host_load_t *load)
+{
+    host_load_ctx_t ctx = {0};
+    _measure_load(load, &ctx);
+}
+
+// Overloaded: ask the weakest client to look for a better host. One client
+// per period, so the load moves gradually and does not oscillate.
+static int64_t _rebalance_job(int64_t now_us)
+{
+    const int64_t next_us = now_us + (int64_t)FPR_HOST_REBALANCE_INTERVAL_MS * 1000;
+    if (fpr_net.current_mode != FPR_MODE_HOST || fpr_net.host_config.rebalance_pct == 0) {
+        return 0;
+    }
+    if (fpr_net.paused) {
+        return next_us;
+    }
+    host_load_ctx_t ctx = {0};
+    fpr_probe_frame_t hint = {
+        .kind = FPR_PROBE_KIND_REBALANCE,
+        .channel = _fpr_get_current_channel(),
+        .info = make_fpr_info_with_keys(false, false, NULL, NULL),
+    };
+    _measure_load(&hint.info.load, &ctx);
+    if (!(hint.info.load.flags & FPR_HOST_LOAD_OVERLOADED) || ctx.weakest == NULL) {
+        return next_us;
+    }
+
+    uint8_t dest[MAC_ADDRESS_LENGTH];
+    memcpy(dest, ctx.weakest->peer_info.peer_addr, MAC_ADDRESS_LENGTH);
+    ESP_LOGI(TAG, "Load %d%% - asking %s (rssi %d) to move", _fpr_host_load_pct(&hint.info.load), ctx.weakest->name, ctx.weakest->rssi);
+    fpr_network_send_to_peer(dest, &hint, sizeof(hint), FPR_PACKET_ID_PROBE);
+    return next_us;
+}
+
+// The overload check runs only on an initialized host that has a threshold set
+static void _update_rebalance_job(void)
+{
+    if (fpr_net.state == FPR_STATE_UNINITIALIZED || fpr_net.current_mode != FPR_MODE_HOST ||
+        fpr_net.host_config.rebalance_pct == 0) {
+        _fpr_sched_cancel(FPR_JOB_REBALANCE);
+    } else if (!_fpr_sched_is_armed(FPR_JOB_REBALANCE)) {
+        _fpr_sched_set(FPR_JOB_REBALANCE, _rebalance_job, esp_timer_get_time() + (int64_t)FPR_HOST_REBALANCE_INTERVAL_MS * 1000);
+    }
+}
+
+// ========== PROBE RESPONDER ==========
+
+FPR_INSTANCE_TIMER_CB(_probe_response_cb)
+{
+    if (fpr_net.current_mode != FPR_MODE_HOST || fpr_net.paused) {
+        return;
+    }
+    fpr_probe_frame_t resp = {
+        .kind = FPR_PROBE_KIND_RESPONSE,
+        .channel = _fpr_get_current_channel(),
+        .info = make_fpr_info_with_keys(false, false, NULL, NULL),
+    };
+    fpr_network_broadcast(&resp, sizeof(resp), FPR_PACKET_ID_PROBE);
+}
+
+// One response answers every probe that arrives while it is pending
+static void _handle_probe_request(const esp_now_recv_info_t *esp_now_info)
+{
+    if (fpr_net.probe.response_timer == NULL || esp_timer_is_active(fpr_net.probe.response_timer)) {
+        return;
+    }
+    uint32_t jitter_us = (FPR_PROBE_RESPONSE_JITTER_MS > 0) ? esp_random() % (FPR_PROBE_RESPONSE_JITTER_MS * 1000) : 0;
+    esp_timer_start_once(fpr_net.probe.response_timer, jitter_us);
+    #if (FPR_DEBUG == 1)
+    ESP_LOGI(TAG, "Probe from " MACSTR " - answering in %lu us", MAC2STR(esp_now_info->src_addr), (unsigned long)jitter_us);
+    #endif
+}
+
+void _fpr_probe_init(void)
+{
+    portMUX_INITIALIZE(&fpr_net.probe.lock);
+    const esp_timer_create_args_t timer_args = {
+        .callback = _probe_response_cb,
+        .arg = &fpr_net,
+        .name = "fpr_probe"
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &fpr_net.probe.response_timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create probe timer: %s", esp_err_to_name(err));
+        fpr_net.probe.response_timer = NULL;
+    }
+}
+
+void _fpr_probe_deinit(void)
+{
+    if (fpr_net.probe.response_timer != NULL) {
+        esp_timer_stop(fpr_net.probe.response_timer);
+        esp_timer_delete(fpr_net.probe.response_timer);
+        fpr_net.probe.response_timer = NULL;
+    }
+    _fpr_sched_cancel(FPR_JOB_REBALANCE);
+}
+
+void _fpr_probe_on_mode_set(void)
+{
+    _update_rebalance_job();
+}
 
 static void _count_connected_callback(void *key, void *value, void *user_data)
 {
@@ -72,8 +224,7 @@ static void _handle_host_auto_mode(const esp_now_recv_info_t *esp_now_info, cons
     if (existing && existing->is_connected && !info->has_pwk && !info->has_lwk) {
         ESP_LOGI(TAG, "Client %s reconnecting (restarted) - reinitiating handshake", existing->name);
         // Client restarted - reinitiate handshake
-        existing->is_connected = false;
-        existing->state = FPR_PEER_STATE_DISCOVERED;
+        _peer_set_state(existing, FPR_PEER_STATE_DISCOVERED, FPR_EVENT_REASON_PEER_RESTART);
         existing->sec_state = FPR_SEC_STATE_NONE;
         existing->security.pwk_valid = false;
         existing->security.lwk_valid = false;
@@ -176,8 +327,8 @@ esp_err_t fpr_host_approve_peer(uint8_t *peer_mac)
         ESP_LOGI(TAG, "Sent PWK to approved client - waiting for handshake completion");
     } else {
         // No security - mark as connected immediately (legacy mode)
-        peer->is_connected = true;
-        peer->state = FPR_PEER_STATE_CONNECTED;
+        _peer_set_state(peer, FPR_PEER_STATE_CONNECTED, FPR_EVENT_REASON_NONE);
+        _fpr_services_on_peer_connected(peer);
         err = fpr_network_send_device_info(peer_mac);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "Failed to send approval to peer: %s", esp_err_to_name(err));
@@ -194,8 +345,7 @@ esp_err_t fpr_host_reject_peer(uint8_t *peer_mac)
     FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_mac);
     ESP_RETURN_ON_FALSE(peer != NULL, ESP_ERR_NOT_FOUND, TAG, "Peer not found");
     
-    peer->is_connected = false;
-    peer->state = FPR_PEER_STATE_REJECTED;
+    _peer_set_state(peer, FPR_PEER_STATE_REJECTED, FPR_EVENT_REASON_LOCAL);
     ESP_LOGI(TAG, "Peer rejected: %s (" MACSTR ")", peer->name, MAC2STR(peer_mac));
     
     return ESP_OK;
@@ -208,13 +358,12 @@ static void _handle_host_manual_mode(const esp_now_recv_info_t *esp_now_info, co
         if (existing->is_connected && !info->has_pwk && !info->has_lwk) {
             ESP_LOGI(TAG, "Client %s reconnecting (restarted) - resetting for manual approval", existing->name);
             // Reset connection and security state for re-approval
-            existing->is_connected = false;
-            existing->state = FPR_PEER_STATE_PENDING;
+            _peer_set_state(existing, FPR_PEER_STATE_PENDING, FPR_EVENT_REASON_PEER_RESTART);
             existing->sec_state = FPR_SEC_STATE_NONE;
             existing->security.pwk_valid = false;
             existing->security.lwk_valid = false;
         } else if (existing->state != FPR_PEER_STATE_CONNECTED) {
-            existing->state = FPR_PEER_STATE_PENDING;
+            _peer_set_state(existing, FPR_PEER_STATE_PENDING, FPR_EVENT_REASON_NONE);
         }
         _update_peer_rssi_and_timestamp(existing, esp_now_info);
         _safe_string_copy(existing->name, info->name, sizeof(existing->name));
@@ -224,7 +373,7 @@ static void _handle_host_manual_mode(const esp_now_recv_info_t *esp_now_info, co
         if (err == ESP_OK) {
             existing = _get_peer_from_map(esp_now_info->src_addr);
             if (existing) {
-                existing->state = FPR_PEER_STATE_PENDING;
+                _peer_set_state(existing, FPR_PEER_STATE_PENDING, FPR_EVENT_REASON_NONE);
             }
         }
     }
@@ -232,8 +381,10 @@ static void _handle_host_manual_mode(const esp_now_recv_info_t *esp_now_info, co
     ESP_LOGI(TAG, "Connection request from %s - pending manual approval", info->name);
     
     // Invoke approval callback if registered
-    if (fpr_net.host_config.request_cb) {
-        bool approved = fpr_net.host_config.request_cb(esp_now_info->src_addr, info->name, 0);
+    fpr_connection_request_cb_t request_cb = fpr_net.host_config.request_cb;
+    if (request_cb) {
+        bool approved;
+        FPR_APP_CALLBACK(approved = request_cb(esp_now_info->src_addr, info->name, 0));
         if (approved) {
             fpr_host_approve_peer(esp_now_info->src_addr);
         } else {
@@ -265,6 +416,12 @@ void _handle_host_receive(const esp_now_recv_info_t *esp_now_info, const uint8_t
     if (!fpr_version_handle_version(esp_now_info, data, len, package->version)) {
         return; // Version handler rejected the packet
     }
+    _fpr_channel_on_rx(esp_now_info);
+    
+    // Collection tree data and extender time requests come from nodes that never connect
+    if (_fpr_tree_on_rx(esp_now_info, package) || _fpr_timesync_on_rx(esp_now_info, package)) {
+        return;
+    }
     
     bool is_broadcast = is_broadcast_address(esp_now_info->des_addr);
     
@@ -278,6 +435,15 @@ void _handle_host_receive(const esp_now_recv_info_t *esp_now_info, const uint8_t
     
     fpr_connect_t *info = &package->protocol.connect_info;
     
+    // Clients looking for a host
+    if (is_broadcast && package->id == FPR_PACKET_ID_PROBE) {
+        const fpr_probe_frame_t *probe = (const fpr_probe_frame_t *)&package->protocol;
+        if (probe->kind == FPR_PROBE_KIND_REQUEST) {
+            _handle_probe_request(esp_now_info);
+        }
+        return;
+    }
+    
     // Handle unicast messages from clients (connection requests)
     if (!is_broadcast) {
         FPR_STORE_HASH_TYPE *existing = _get_peer_from_map(esp_now_info->src_addr);
@@ -313,6 +479,24 @@ void _handle_host_receive(const esp_now_recv_info_t *esp_now_info, const uint8_t
         else if (existing && existing->is_connected) {
             // Peer already connected - update timestamp and store application data
             _update_peer_rssi_and_timestamp(existing, esp_now_info);
+            
+            // Hot-standby liveness check: answer without touching the session
+            if (package->id == FPR_PACKET_ID_PROBE) {
+                const fpr_probe_frame_t *probe = (const fpr_probe_frame_t *)&package->protocol;
+                if (probe->kind == FPR_PROBE_KIND_HEARTBEAT) {
+                    fpr_probe_frame_t ack = {
+                        .kind = FPR_PROBE_KIND_HEARTBEAT_ACK,
+                        .channel = _fpr_get_current_channel(),
+                    };
+                    fpr_network_send_to_peer(esp_now_info->src_addr, &ack, sizeof(ack), FPR_PACKET_ID_PROBE);
+                }
+                return;
+            }
+            
+            // Client-to-client traffic is passed on, not stored
+            if (_fpr_link_host_relay(existing, package)) {
+                return;
+            }
             #if (FPR_DEBUG == 1)
             ESP_LOGI(TAG, "Received packet from connected peer: %s (id: %d)", existing->name, package->id);
             #endif
@@ -335,8 +519,7 @@ esp_err_t fpr_host_block_peer(uint8_t *peer_mac)
     FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_mac);
     
     if (peer) {
-        peer->is_connected = false;
-        peer->state = FPR_PEER_STATE_BLOCKED;
+        _peer_set_state(peer, FPR_PEER_STATE_BLOCKED, FPR_EVENT_REASON_LOCAL);
         ESP_LOGI(TAG, "Peer blocked: %s (" MACSTR ")", peer->name, MAC2STR(peer_mac));
     } else {
         // Add as blocked even if not in map yet
@@ -344,7 +527,7 @@ esp_err_t fpr_host_block_peer(uint8_t *peer_mac)
         if (err == ESP_OK) {
             peer = _get_peer_from_map(peer_mac);
             if (peer) {
-                peer->state = FPR_PEER_STATE_BLOCKED;
+                _peer_set_state(peer, FPR_PEER_STATE_BLOCKED, FPR_EVENT_REASON_LOCAL);
                 ESP_LOGI(TAG, "Peer blocked: " MACSTR, MAC2STR(peer_mac));
             }
         }
@@ -362,7 +545,7 @@ esp_err_t fpr_host_unblock_peer(uint8_t *peer_mac)
     ESP_RETURN_ON_FALSE(peer != NULL, ESP_ERR_NOT_FOUND, TAG, "Peer not found");
     
     if (peer->state == FPR_PEER_STATE_BLOCKED) {
-        peer->state = FPR_PEER_STATE_DISCOVERED;
+        _peer_set_state(peer, FPR_PEER_STATE_DISCOVERED, FPR_EVENT_REASON_NONE);
         ESP_LOGI(TAG, "Peer unblocked: %s (" MACSTR ")", peer->name, MAC2STR(peer_mac));
         return ESP_OK;
     }
@@ -377,8 +560,7 @@ esp_err_t fpr_host_disconnect_peer(uint8_t *peer_mac)
     FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_mac);
     ESP_RETURN_ON_FALSE(peer != NULL, ESP_ERR_NOT_FOUND, TAG, "Peer not found");
     
-    peer->is_connected = false;
-    peer->state = FPR_PEER_STATE_DISCOVERED;
+    _peer_set_state(peer, FPR_PEER_STATE_DISCOVERED, FPR_EVENT_REASON_LOCAL);
     ESP_LOGI(TAG, "Peer disconnected: %s (" MACSTR ")", peer->name, MAC2STR(peer_mac));
     
     return ESP_OK;
@@ -396,8 +578,7 @@ static void _host_reconnect_and_keepalive_cb(void *key, void *value, void *user_
         uint64_t age_ms = (uint64_t)US_TO_MS(age_us);
         if (age_ms > FPR_RECONNECT_TIMEOUT_MS) {
             ESP_LOGW(TAG, "Client " MACSTR " timed out (age %llu ms) - disconnecting", MAC2STR(peer->peer_info.peer_addr), age_ms);
-            peer->is_connected = false;
-            peer->state = FPR_PEER_STATE_DISCOVERED;
+            _peer_set_state(peer, FPR_PEER_STATE_DISCOVERED, FPR_EVENT_REASON_TIMEOUT);
             return;
         }
 
@@ -409,31 +590,20 @@ static void _host_reconnect_and_keepalive_cb(void *key, void *value, void *user_
     }
 }
 
-void _fpr_host_reconnect_task(void *arg)
+int64_t _fpr_host_reconnect_job(int64_t now_us)
 {
-    (void)arg;
-    TickType_t last_keep = xTaskGetTickCount();
-
-    while (1) {
-        // Get power-adjusted intervals
-        const TickType_t keep_interval_ticks = pdMS_TO_TICKS(_fpr_get_power_adjusted_interval(FPR_KEEPALIVE_INTERVAL_MS));
-        const TickType_t check_interval_ticks = pdMS_TO_TICKS(_fpr_get_power_adjusted_interval(FPR_HOST_SCAN_POLL_INTERVAL_MS));
-        
-        // Periodically run keepalive + reconnect checks for connected clients
-        if ((xTaskGetTickCount() - last_keep) >= keep_interval_ticks) {
-            hashmap_foreach(&fpr_net.peers_map, _host_reconnect_and_keepalive_cb, NULL);
-            last_keep = xTaskGetTickCount();
-        }
-
-        vTaskDelay(check_interval_ticks);
-    }
+    // Keepalive + reconnect checks for connected clients, once per keepalive interval
+    hashmap_foreach(&fpr_net.peers_map, _host_reconnect_and_keepalive_cb, NULL);
+    return now_us + (int64_t)_fpr_get_power_adjusted_interval(FPR_KEEPALIVE_INTERVAL_MS) * 1000;
 }
 
 esp_err_t fpr_host_set_config(const fpr_host_config_t *config)
 {
     ESP_RETURN_ON_FALSE(config != NULL, ESP_ERR_INVALID_ARG, TAG, "Config is NULL");
+    ESP_RETURN_ON_FALSE(config->rebalance_pct <= 100, ESP_ERR_INVALID_ARG, TAG, "Rebalance threshold must be 0-100");
     
     fpr_net.host_config = *config;
+    _update_rebalance_job();
     ESP_LOGI(TAG, "Host config updated: max_peers=%d, mode=%s", 
              config->max_peers, 
              config->connection_mode == FPR_CONNECTION_AUTO ? "AUTO" : "MANUAL");
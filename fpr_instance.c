@@ -0,0 +1,290 @@
+/**
+ * @file fpr_instance.c
+ * @brief FPR Network Instances implementation
+ *
+ * Instances are the fpr_network_t slots of fpr_instances[]; a handle is a
+ * pointer to one. Internal code reaches the instance it works on through
+ * fpr_net. With more than one configured, that is the instance the running
+ * dispatch is bound to: a radio, timer or service task callback, or an
+ * _ex() call, each of which restores the task's previous binding when it
+ * returns. Anything else, application callbacks included, gets the default
+ * instance.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_instance.h"
+#include "fpr/internal/helpers.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include <stddef.h>
+
+#if (FPR_MAX_INSTANCES > 1) && (FPR_INSTANCE_TLS_INDEX >= CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS)
+#error "CONFIG_FPR_INSTANCE_TLS_INDEX must be below CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS"
+#endif
+
+static const char *TAG = "fpr_instance";
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_used[FPR_MAX_INSTANCES] = { true }; // The default instance always exists
+
+fpr_network_t *_fpr_instance_for_frame(const uint8_t *data, int len)
+{
+    // Shorter frames (legacy) carry no network ID and belong to the default network
+    uint8_t network_id = FPR_INSTANCE_DEFAULT_NETWORK_ID;
+    if (len >= (int)sizeof(fpr_package_t)) {
+        network_id = data[offsetof(fpr_package_t, network_id)];
+    }
+    for (int i = 0; i < FPR_MAX_INSTANCES; i++) {
+        if (fpr_instances[i].state != FPR_STATE_UNINITIALIZED && fpr_instances[i].network_id == network_id) {
+            return &fpr_instances[i];
+        }
+    }
+    return NULL;
+}
+
+fpr_network_t *_fpr_instance_for_peer(const uint8_t *mac)
+{
+    for (int i = 1; i < FPR_MAX_INSTANCES; i++) {
+        if (fpr_instances[i].state != FPR_STATE_UNINITIALIZED && hashmap_get(&fpr_instances[i].peers_map, mac) != NULL) {
+            return &fpr_instances[i];
+        }
+    }
+    return &fpr_instances[0];
+}
+
+int _fpr_instance_others_active(void)
+{
+    int count = 0;
+    for (int i = 0; i < FPR_MAX_INSTANCES; i++) {
+        if (&fpr_instances[i] != &fpr_net && fpr_instances[i].state != FPR_STATE_UNINITIALIZED) {
+            count++;
+        }
+    }
+    return count;
+}
+
+fpr_instance_t *fpr_instance_default(void)
+{
+    return (fpr_instance_t *)&fpr_instances[0];
+}
+
+esp_err_t fpr_instance_create(uint8_t network_id, fpr_instance_t **instance)
+{
+    ESP_RETURN_ON_FALSE(instance != NULL, ESP_ERR_INVALID_ARG, TAG, "Instance is NULL");
+    ESP_RETURN_ON_FALSE(network_id != FPR_INSTANCE_DEFAULT_NETWORK_ID, ESP_ERR_INVALID_ARG, TAG,
+                        "Network ID 0 is the default instance");
+
+    int slot = -1;
+    bool duplicate = false;
+    taskENTER_CRITICAL(&s_lock);
+    for (int i = 1; i < FPR_MAX_INSTANCES; i++) {
+        if (!s_used[i]) {
+            if (slot < 0) {
+                slot = i;
+            }
+        } else if (fpr_instances[i].network_id == network_id) {
+            duplicate = true;
+        }
+    }
+    if (!duplicate && slot >= 0) {
+        s_used[slot] = true;
+        fpr_instances[slot].network_id = network_id;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+
+    ESP_RETURN_ON_FALSE(!duplicate, ESP_ERR_INVALID_STATE, TAG, "Network ID %u already in use", network_id);
+    ESP_RETURN_ON_FALSE(slot >= 0, ESP_ERR_NO_MEM, TAG, "All %d instances in use (CONFIG_FPR_MAX_INSTANCES)", FPR_MAX_INSTANCES);
+    *instance = (fpr_instance_t *)&fpr_instances[slot];
+    ESP_LOGI(TAG, "Instance %d created for network %u", slot, network_id);
+    return ESP_OK;
+}
+
+esp_err_t fpr_instance_destroy(fpr_instance_t *instance)
+{
+    fpr_network_t *net = (fpr_network_t *)instance;
+    ESP_RETURN_ON_FALSE(net != NULL && net != &fpr_instances[0], ESP_ERR_INVALID_ARG, TAG, "Cannot destroy the default instance");
+    ESP_RETURN_ON_FALSE(net->state == FPR_STATE_UNINITIALIZED, ESP_ERR_INVALID_STATE, TAG, "Instance still initialized");
+
+    taskENTER_CRITICAL(&s_lock);
+    s_used[net - fpr_instances] = false;
+    net->network_id = FPR_INSTANCE_DEFAULT_NETWORK_ID;
+    taskEXIT_CRITICAL(&s_lock);
+    return ESP_OK;
+}
+
+fpr_instance_t *fpr_instance_current(void)
+{
+    return (fpr_instance_t *)_fpr_instance_raised();
+}
+
+uint8_t fpr_instance_get_network_id(const fpr_instance_t *instance)
+{
+    return instance != NULL ? ((const fpr_network_t *)instance)->network_id : FPR_INSTANCE_DEFAULT_NETWORK_ID;
+}
+
+// ========== PER-INSTANCE API ==========
+
+#define EX_NET(instance) ((instance) != NULL ? (void *)(instance) : (void *)&fpr_instances[0])
+
+// The function without _ex, bound to the instance for the duration of the call
+#define FPR_EX(ret, name, params, args)                 \
+    ret name##_ex params                                \
+    {                                                   \
+        void *prev = _fpr_instance_enter(EX_NET(instance)); \
+        ret result = name args;                         \
+        _fpr_instance_leave(prev);                      \
+        return result;                                  \
+    }
+
+#define FPR_EX_VOID(name, params, args)                 \
+    void name##_ex params                               \
+    {                                                   \
+        void *prev = _fpr_instance_enter(EX_NET(instance)); \
+        name args;                                      \
+        _fpr_instance_leave(prev);                      \
+    }
+
+esp_err_t fpr_instance_init(fpr_instance_t *instance, const char *name, const fpr_init_config_t *config)
+{
+    void *prev = _fpr_instance_enter(EX_NET(instance));
+    esp_err_t ret = config != NULL ? fpr_network_init_ex(name, config) : fpr_network_init(name);
+    _fpr_instance_leave(prev);
+    return ret;
+}
+
+FPR_EX(esp_err_t, fpr_network_deinit, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_network_start, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_network_stop, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_network_pause, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_network_resume, (fpr_instance_t *instance), ())
+FPR_EX(fpr_network_state_t, fpr_network_get_state, (fpr_instance_t *instance), ())
+FPR_EX_VOID(fpr_network_set_power_mode, (fpr_instance_t *instance, fpr_power_mode_t mode), (mode))
+FPR_EX(fpr_power_mode_t, fpr_network_get_power_mode, (fpr_instance_t *instance), ())
+FPR_EX_VOID(fpr_network_set_queue_mode, (fpr_instance_t *instance, fpr_queue_mode_t mode), (mode))
+FPR_EX(fpr_queue_mode_t, fpr_network_get_queue_mode, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_network_set_peer_queue_mode, (fpr_instance_t *instance, uint8_t *peer_mac, fpr_queue_mode_t mode), (peer_mac, mode))
+FPR_EX(uint32_t, fpr_network_get_peer_queued_packets, (fpr_instance_t *instance, uint8_t *peer_mac), (peer_mac))
+FPR_EX_VOID(fpr_network_set_mode, (fpr_instance_t *instance, fpr_mode_type_t mode), (mode))
+FPR_EX(fpr_mode_type_t, fpr_network_get_mode, (fpr_instance_t *instance), ())
+FPR_EX_VOID(fpr_network_set_permission_state, (fpr_instance_t *instance, fpr_visibility_t state), (state))
+FPR_EX(fpr_visibility_t, fpr_network_get_permission_state, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_network_start_loop_task, (fpr_instance_t *instance, TickType_t duration, bool force_restart), (duration, force_restart))
+FPR_EX(esp_err_t, fpr_network_stop_loop_task, (fpr_instance_t *instance), ())
+FPR_EX(bool, fpr_network_is_loop_task_running, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_network_start_reconnect_task, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_network_stop_reconnect_task, (fpr_instance_t *instance), ())
+FPR_EX(bool, fpr_network_is_reconnect_task_running, (fpr_instance_t *instance), ())
+
+FPR_EX(esp_err_t, fpr_network_add_peer, (fpr_instance_t *instance, uint8_t *peer_mac), (peer_mac))
+FPR_EX(esp_err_t, fpr_network_remove_peer, (fpr_instance_t *instance, uint8_t *peer_mac), (peer_mac))
+FPR_EX(esp_err_t, fpr_send_with_options, (fpr_instance_t *instance, uint8_t *peer_address, void *data, int size, const fpr_send_options_t *options),
+       (peer_address, data, size, options))
+FPR_EX(esp_err_t, fpr_network_send_to_peer, (fpr_instance_t *instance, uint8_t *peer_address, void *data, int size, fpr_package_id_t package_id),
+       (peer_address, data, size, package_id))
+FPR_EX(esp_err_t, fpr_network_broadcast, (fpr_instance_t *instance, void *data, int size, fpr_package_id_t package_id), (data, size, package_id))
+FPR_EX(esp_err_t, fpr_network_send_device_info, (fpr_instance_t *instance, uint8_t *peer_address), (peer_address))
+FPR_EX(esp_err_t, fpr_network_broadcast_device_info, (fpr_instance_t *instance), ())
+FPR_EX(bool, fpr_network_get_data_from_peer, (fpr_instance_t *instance, uint8_t *peer_mac, void *data, int data_size, TickType_t timeout),
+       (peer_mac, data, data_size, timeout))
+FPR_EX_VOID(fpr_register_receive_callback, (fpr_instance_t *instance, fpr_data_receive_cb_t callback), (callback))
+FPR_EX(int, fpr_network_get_peer_count, (fpr_instance_t *instance), ())
+FPR_EX(size_t, fpr_network_get_peers, (fpr_instance_t *instance, fpr_data_receive_cb_t callback, void *user_data), (callback, user_data))
+FPR_EX(esp_err_t, fpr_get_peer_by_name, (fpr_instance_t *instance, const char *peer_name, uint8_t *mac_out), (peer_name, mac_out))
+FPR_EX(esp_err_t, fpr_get_peer_info, (fpr_instance_t *instance, uint8_t *peer_mac, fpr_peer_info_t *info), (peer_mac, info))
+FPR_EX(size_t, fpr_list_all_peers, (fpr_instance_t *instance, fpr_peer_info_t *peer_array, size_t max_peers), (peer_array, max_peers))
+FPR_EX(esp_err_t, fpr_clear_all_peers, (fpr_instance_t *instance), ())
+FPR_EX(bool, fpr_is_peer_reachable, (fpr_instance_t *instance, uint8_t *peer_mac, uint32_t timeout_ms), (peer_mac, timeout_ms))
+FPR_EX(size_t, fpr_cleanup_stale_routes, (fpr_instance_t *instance, uint32_t timeout_ms), (timeout_ms))
+FPR_EX_VOID(fpr_print_route_table, (fpr_instance_t *instance), ())
+FPR_EX_VOID(fpr_get_network_stats, (fpr_instance_t *instance, fpr_network_stats_t *stats), (stats))
+FPR_EX_VOID(fpr_reset_network_stats, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_network_get_peer_stats, (fpr_instance_t *instance, const uint8_t *peer_mac, fpr_peer_stats_t *stats), (peer_mac, stats))
+FPR_EX(esp_err_t, fpr_network_reset_peer_stats, (fpr_instance_t *instance, const uint8_t *peer_mac), (peer_mac))
+FPR_EX_VOID(fpr_network_get_wakeup_stats, (fpr_instance_t *instance, fpr_wakeup_stats_t *stats), (stats))
+
+FPR_EX(esp_err_t, fpr_host_set_config, (fpr_instance_t *instance, const fpr_host_config_t *config), (config))
+FPR_EX(esp_err_t, fpr_host_get_config, (fpr_instance_t *instance, fpr_host_config_t *config), (config))
+FPR_EX(size_t, fpr_host_get_connected_count, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_host_approve_peer, (fpr_instance_t *instance, uint8_t *peer_mac), (peer_mac))
+FPR_EX(esp_err_t, fpr_host_reject_peer, (fpr_instance_t *instance, uint8_t *peer_mac), (peer_mac))
+FPR_EX(esp_err_t, fpr_host_block_peer, (fpr_instance_t *instance, uint8_t *peer_mac), (peer_mac))
+FPR_EX(esp_err_t, fpr_host_unblock_peer, (fpr_instance_t *instance, uint8_t *peer_mac), (peer_mac))
+FPR_EX(esp_err_t, fpr_host_disconnect_peer, (fpr_instance_t *instance, uint8_t *peer_mac), (peer_mac))
+FPR_EX(esp_err_t, fpr_client_set_config, (fpr_instance_t *instance, const fpr_client_config_t *config), (config))
+FPR_EX(esp_err_t, fpr_client_get_config, (fpr_instance_t *instance, fpr_client_config_t *config), (config))
+FPR_EX(bool, fpr_client_is_connected, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_client_get_host_info, (fpr_instance_t *instance, uint8_t *mac_out, char *name_out, size_t name_size), (mac_out, name_out, name_size))
+FPR_EX(size_t, fpr_client_list_discovered_hosts, (fpr_instance_t *instance, fpr_peer_info_t *peer_array, size_t max_peers), (peer_array, max_peers))
+FPR_EX(esp_err_t, fpr_client_connect_to_host, (fpr_instance_t *instance, uint8_t *peer_mac, TickType_t timeout), (peer_mac, timeout))
+FPR_EX(esp_err_t, fpr_client_disconnect, (fpr_instance_t *instance), ())
+FPR_EX(size_t, fpr_client_scan_for_hosts, (fpr_instance_t *instance, TickType_t duration), (duration))
+FPR_EX(size_t, fpr_client_probe_for_hosts, (fpr_instance_t *instance, size_t min_hosts, TickType_t timeout), (min_hosts, timeout))
+FPR_EX(esp_err_t, fpr_client_set_standby, (fpr_instance_t *instance, bool enable), (enable))
+FPR_EX_VOID(fpr_client_get_standby_stats, (fpr_instance_t *instance, fpr_standby_stats_t *stats), (stats))
+
+FPR_EX(esp_err_t, fpr_extender_set_store_and_forward, (fpr_instance_t *instance, bool enable), (enable))
+FPR_EX_VOID(fpr_extender_get_store_stats, (fpr_instance_t *instance, fpr_extender_store_stats_t *stats), (stats))
+FPR_EX(esp_err_t, fpr_extender_set_mpr, (fpr_instance_t *instance, bool enable), (enable))
+FPR_EX_VOID(fpr_extender_get_broadcast_stats, (fpr_instance_t *instance, fpr_extender_broadcast_stats_t *stats), (stats))
+
+FPR_EX(esp_err_t, fpr_pubsub_subscribe, (fpr_instance_t *instance, fpr_topic_t topic, fpr_pubsub_cb_t cb, void *user_data), (topic, cb, user_data))
+FPR_EX(esp_err_t, fpr_pubsub_unsubscribe, (fpr_instance_t *instance, fpr_topic_t topic), (topic))
+FPR_EX(esp_err_t, fpr_pubsub_publish, (fpr_instance_t *instance, fpr_topic_t topic, const void *data, size_t len, bool retain), (topic, data, len, retain))
+FPR_EX(esp_err_t, fpr_pubsub_get_retained, (fpr_instance_t *instance, fpr_topic_t topic, void *buf, size_t *len), (topic, buf, len))
+FPR_EX_VOID(fpr_pubsub_get_stats, (fpr_instance_t *instance, fpr_pubsub_stats_t *stats), (stats))
+FPR_EX_VOID(fpr_pubsub_reset_stats, (fpr_instance_t *instance), ())
+
+FPR_EX(esp_err_t, fpr_rpc_register, (fpr_instance_t *instance, fpr_rpc_method_t method, fpr_rpc_handler_t handler, void *user_data),
+       (method, handler, user_data))
+FPR_EX(esp_err_t, fpr_rpc_unregister, (fpr_instance_t *instance, fpr_rpc_method_t method), (method))
+FPR_EX(esp_err_t, fpr_rpc_call_async, (fpr_instance_t *instance, const uint8_t *peer_mac, fpr_rpc_method_t method,
+                                       const void *req, size_t req_len, uint32_t timeout_ms,
+                                       fpr_rpc_response_cb_t cb, void *user_data, uint32_t *call_id_out),
+       (peer_mac, method, req, req_len, timeout_ms, cb, user_data, call_id_out))
+FPR_EX(esp_err_t, fpr_rpc_call, (fpr_instance_t *instance, const uint8_t *peer_mac, fpr_rpc_method_t method,
+                                 const void *req, size_t req_len, void *resp, size_t *resp_len, uint32_t timeout_ms),
+       (peer_mac, method, req, req_len, resp, resp_len, timeout_ms))
+FPR_EX(esp_err_t, fpr_rpc_cancel, (fpr_instance_t *instance, uint32_t call_id), (call_id))
+FPR_EX_VOID(fpr_rpc_get_stats, (fpr_instance_t *instance, fpr_rpc_stats_t *stats), (stats))
+FPR_EX_VOID(fpr_rpc_reset_stats, (fpr_instance_t *instance), ())
+
+FPR_EX(esp_err_t, fpr_timesync_get_time, (fpr_instance_t *instance, int64_t *time_us, uint32_t *error_us), (time_us, error_us))
+FPR_EX(int64_t, fpr_timesync_local_to_network, (fpr_instance_t *instance, int64_t local_us), (local_us))
+FPR_EX(int64_t, fpr_timesync_network_to_local, (fpr_instance_t *instance, int64_t network_us), (network_us))
+FPR_EX(bool, fpr_timesync_is_synced, (fpr_instance_t *instance), ())
+FPR_EX_VOID(fpr_timesync_get_status, (fpr_instance_t *instance, fpr_timesync_status_t *status), (status))
+FPR_EX(esp_err_t, fpr_timesync_trigger, (fpr_instance_t *instance), ())
+
+FPR_EX(esp_err_t, fpr_tdma_host_start, (fpr_instance_t *instance, const fpr_tdma_config_t *config), (config))
+FPR_EX(esp_err_t, fpr_tdma_host_stop, (fpr_instance_t *instance), ())
+FPR_EX_VOID(fpr_tdma_get_status, (fpr_instance_t *instance, fpr_tdma_status_t *status), (status))
+
+FPR_EX(esp_err_t, fpr_sleepy_host_enable, (fpr_instance_t *instance, uint16_t beacon_interval_ms), (beacon_interval_ms))
+FPR_EX(esp_err_t, fpr_sleepy_host_disable, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_sleepy_client_enable, (fpr_instance_t *instance, uint8_t listen_interval), (listen_interval))
+FPR_EX(esp_err_t, fpr_sleepy_client_disable, (fpr_instance_t *instance), ())
+FPR_EX_VOID(fpr_sleepy_get_stats, (fpr_instance_t *instance, fpr_sleepy_stats_t *stats), (stats))
+
+FPR_EX(esp_err_t, fpr_channel_monitor_start, (fpr_instance_t *instance, const fpr_channel_config_t *config), (config))
+FPR_EX(esp_err_t, fpr_channel_monitor_stop, (fpr_instance_t *instance), ())
+FPR_EX(esp_err_t, fpr_channel_migrate, (fpr_instance_t *instance, uint8_t channel), (channel))
+FPR_EX_VOID(fpr_channel_get_status, (fpr_instance_t *instance, fpr_channel_status_t *status), (status))
+
+FPR_EX(esp_err_t, fpr_link_request, (fpr_instance_t *instance, const uint8_t *peer_mac), (peer_mac))
+FPR_EX(esp_err_t, fpr_link_close, (fpr_instance_t *instance, const uint8_t *peer_mac), (peer_mac))
+FPR_EX(esp_err_t, fpr_link_get_info, (fpr_instance_t *instance, const uint8_t *peer_mac, fpr_link_info_t *info), (peer_mac, info))
+FPR_EX_VOID(fpr_link_get_stats, (fpr_instance_t *instance, fpr_link_stats_t *stats), (stats))
+
+FPR_EX(esp_err_t, fpr_aggregate_register, (fpr_instance_t *instance, fpr_package_id_t package_id, const fpr_aggregate_config_t *config),
+       (package_id, config))
+FPR_EX(esp_err_t, fpr_aggregate_unregister, (fpr_instance_t *instance, fpr_package_id_t package_id), (package_id))
+FPR_EX_VOID(fpr_aggregate_get_stats, (fpr_instance_t *instance, fpr_aggregate_stats_t *stats), (stats))
+
+FPR_EX(esp_err_t, fpr_tree_set_sink, (fpr_instance_t *instance, bool enable), (enable))
+FPR_EX(esp_err_t, fpr_tree_send, (fpr_instance_t *instance, const void *data, size_t size, fpr_package_id_t package_id), (data, size, package_id))
+FPR_EX_VOID(fpr_tree_get_info, (fpr_instance_t *instance, fpr_tree_info_t *info), (info))
+FPR_EX_VOID(fpr_tree_get_stats, (fpr_instance_t *instance, fpr_tree_stats_t *stats), (stats))
+
+FPR_EX(esp_err_t, fpr_bridge_start, (fpr_instance_t *instance, const fpr_bridge_config_t *config), (config))
@@ -0,0 +1,649 @@
+/**
+ * @file fpr_link.c
+ * @brief FPR Direct Client Links implementation
+ *
+ * Host: introduces two connected clients on request and relays unicast
+ * packets whose destination is another connected client. Client: keeps a
+ * small link table, sends to linked clients directly while the direct path
+ * is healthy and through the host otherwise, and delivers relayed packets
+ * as if they came from the linked client.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_link.h"
+#include "fpr/fpr_lts.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/scheduler.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_random.h"
+
+static const char *TAG = "fpr_link";
+
+#define LINK fpr_net.link
+
+extern esp_err_t fpr_network_send_to_peer(uint8_t *peer_address, void *data, int size, fpr_package_id_t package_id);
+extern esp_err_t fpr_client_get_host_info(uint8_t *mac_out, char *name_out, size_t name_size);
+
+static bool _is_unicast_dest(const uint8_t *mac)
+{
+    static const uint8_t zero[MAC_ADDRESS_LENGTH] = {0};
+    return !is_broadcast_address(mac) && memcmp(mac, zero, MAC_ADDRESS_LENGTH) != 0;
+}
+
+// Must be called with the lock held
+static fpr_link_entry_t *_find(const uint8_t *mac)
+{
+    for (int i = 0; i < FPR_LINK_MAX; i++) {
+        if (LINK.links[i].in_use && memcmp(LINK.links[i].mac, mac, MAC_ADDRESS_LENGTH) == 0) {
+            return &LINK.links[i];
+        }
+    }
+    return NULL;
+}
+
+// Must be called with the lock held
+static bool _path_is_direct(const fpr_link_entry_t *entry, int64_t now_us)
+{
+    return entry->last_direct_us != 0 &&
+           entry->tx_fail_streak < FPR_LINK_MAX_TX_FAILURES &&
+           now_us - entry->last_direct_us <= (int64_t)FPR_LINK_DEGRADED_MS * 1000;
+}
+
+static int64_t _link_job(int64_t now_us);
+
+// The hello job runs only while at least one link exists
+static void _update_job(void)
+{
+    bool any = false;
+    taskENTER_CRITICAL(&LINK.lock);
+    for (int i = 0; i < FPR_LINK_MAX && !any; i++) {
+        any = LINK.links[i].in_use;
+    }
+    taskEXIT_CRITICAL(&LINK.lock);
+
+    if (!any) {
+        _fpr_sched_cancel(FPR_JOB_LINK);
+    } else if (!_fpr_sched_is_armed(FPR_JOB_LINK)) {
+        _fpr_sched_set(FPR_JOB_LINK, _link_job, esp_timer_get_time() + (int64_t)FPR_LINK_HELLO_INTERVAL_MS * 1000);
+    }
+}
+
+// Link frames bypass the data path routing: they pick their path explicitly
+static esp_err_t _send_frame(const uint8_t *dest, const uint8_t *via, const fpr_link_frame_t *frame)
+{
+    fpr_package_t package = {0};
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.id = FPR_PACKET_ID_LINK;
+    package.payload_size = sizeof(*frame);
+    package.sequence_num = _fpr_next_sequence_num();
+    memcpy(&package.protocol, frame, sizeof(*frame));
+    memcpy(package.origin_mac, fpr_net.mac, MAC_ADDRESS_LENGTH);
+    memcpy(package.dest_mac, dest, MAC_ADDRESS_LENGTH);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    package.version = FPR_PROTOCOL_VERSION;
+
+    esp_err_t err = _fpr_radio_send(via != NULL ? via : dest, &package);
+    if (err == ESP_OK) {
+        _fpr_stat_add(FPR_STAT_PACKETS_SENT, 1);
+    } else {
+        _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
+    }
+    return err;
+}
+
+// Drop the link but keep the peer entry, so a new introduction can reuse it
+static void _release(FPR_STORE_HASH_TYPE *peer, fpr_event_reason_t reason)
+{
+    taskENTER_CRITICAL(&LINK.lock);
+    fpr_link_entry_t *entry = _find(peer->peer_info.peer_addr);
+    if (entry != NULL) {
+        entry->in_use = false;
+    }
+    taskEXIT_CRITICAL(&LINK.lock);
+    _update_job();
+
+    _peer_set_state(peer, FPR_PEER_STATE_DISCOVERED, reason);
+    peer->sec_state = FPR_SEC_STATE_NONE;
+    fpr_security_clear_keys(&peer->security);
+    if (peer->peer_info.encrypt) {
+        peer->peer_info.encrypt = false;
+        memset(peer->peer_info.lmk, 0, sizeof(peer->peer_info.lmk));
+        _fpr_transport_mod_peer(&peer->peer_info);
+    }
+}
+
+// The pairwise key travels under the session key (LWK) of the client it is
+// sent to, bound to the nonce and to the peer it is for
+static esp_err_t _wrap_key(const uint8_t *session_key, const fpr_link_frame_t *frame, const uint8_t *key_in,
+                           uint8_t *key_out, uint8_t *check_out)
+{
+    uint8_t context[sizeof(frame->nonce) + MAC_ADDRESS_LENGTH];
+    memcpy(context, frame->nonce, sizeof(frame->nonce));
+    memcpy(&context[sizeof(frame->nonce)], frame->peer, MAC_ADDRESS_LENGTH);
+    return fpr_security_wrap_key(session_key, context, sizeof(context), key_in, key_out, check_out);
+}
+
+// ========== HOST ==========
+
+static void _host_send_intro(FPR_STORE_HASH_TYPE *to, FPR_STORE_HASH_TYPE *about, const uint8_t *key)
+{
+    fpr_link_frame_t intro = {
+        .kind = FPR_LINK_KIND_INTRO,
+    };
+    memcpy(intro.peer, about->peer_info.peer_addr, MAC_ADDRESS_LENGTH);
+    _safe_string_copy(intro.name, about->name, sizeof(intro.name));
+    esp_fill_random(intro.nonce, sizeof(intro.nonce));
+    if (_wrap_key(to->security.lwk, &intro, key, intro.key, intro.check) == ESP_OK) {
+        fpr_network_send_to_peer(to->peer_info.peer_addr, &intro, sizeof(intro), FPR_PACKET_ID_LINK);
+    }
+}
+
+static void _host_introduce(FPR_STORE_HASH_TYPE *from, const fpr_link_frame_t *req)
+{
+    FPR_STORE_HASH_TYPE *target = _get_peer_from_map(req->peer);
+    fpr_link_frame_t reply = {
+        .kind = FPR_LINK_KIND_REJECT,
+        .status = ESP_OK,
+    };
+    memcpy(reply.peer, req->peer, MAC_ADDRESS_LENGTH);
+
+    if (!FPR_LINK_HOST_INTRODUCE) {
+        reply.status = ESP_ERR_NOT_SUPPORTED;
+    } else if (target == NULL || target == from || target->state != FPR_PEER_STATE_CONNECTED) {
+        reply.status = ESP_ERR_NOT_FOUND;
+    } else if (!from->security.lwk_valid || !target->security.lwk_valid) {
+        reply.status = ESP_ERR_INVALID_STATE; // No session key to send the pairwise key under
+    }
+    if (reply.status != ESP_OK) {
+        ESP_LOGW(TAG, "Refusing link %s -> " MACSTR ": %s", from->name, MAC2STR(req->peer), esp_err_to_name(reply.status));
+        fpr_network_send_to_peer(from->peer_info.peer_addr, &reply, sizeof(reply), FPR_PACKET_ID_LINK);
+        taskENTER_CRITICAL(&LINK.lock);
+        LINK.stats.rejected++;
+        taskEXIT_CRITICAL(&LINK.lock);
+        return;
+    }
+
+    uint8_t key[FPR_KEY_SIZE];
+    esp_fill_random(key, FPR_KEY_SIZE);
+
+    // Target first, so its peer entry tends to exist when the requester says hello
+    _host_send_intro(target, from, key);
+    _host_send_intro(from, target, key);
+    memset(key, 0, FPR_KEY_SIZE);
+
+    taskENTER_CRITICAL(&LINK.lock);
+    LINK.stats.introductions++;
+    taskEXIT_CRITICAL(&LINK.lock);
+    ESP_LOGI(TAG, "Introduced %s to %s", from->name, target->name);
+}
+
+bool _fpr_link_host_relay(FPR_STORE_HASH_TYPE *from, const fpr_package_t *package)
+{
+    if (fpr_net.current_mode != FPR_MODE_HOST || !_is_unicast_dest(package->dest_mac) ||
+        memcmp(package->dest_mac, fpr_net.mac, MAC_ADDRESS_LENGTH) == 0) {
+        return false;
+    }
+
+    FPR_STORE_HASH_TYPE *dest = _get_peer_from_map(package->dest_mac);
+    if (dest == NULL || dest == from || dest->state != FPR_PEER_STATE_CONNECTED || package->hop_count >= package->max_hops) {
+        #if (FPR_DEBUG == 1)
+        ESP_LOGW(TAG, "Cannot relay from %s to " MACSTR, from->name, MAC2STR(package->dest_mac));
+        #endif
+        taskENTER_CRITICAL(&LINK.lock);
+        LINK.stats.relay_dropped++;
+        taskEXIT_CRITICAL(&LINK.lock);
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        FPR_TRACE(FPR_TRACE_DROP, package->hop_count >= package->max_hops ? FPR_TRACE_DROP_HOP_LIMIT : FPR_TRACE_DROP_NO_ROUTE,
+                  from->peer_info.peer_addr, package);
+        return true;
+    }
+
+    fpr_package_t relayed = *package;
+    relayed.hop_count++;
+    esp_err_t err;
+    if (_fpr_services_should_defer(dest->peer_info.peer_addr, relayed.id)) {
+        err = _fpr_services_defer(&relayed);
+    } else {
+        err = _fpr_radio_send(dest->peer_info.peer_addr, &relayed);
+    }
+    if (err == ESP_OK) {
+        _fpr_stat_add(FPR_STAT_PACKETS_FORWARDED, 1);
+        FPR_TRACE(FPR_TRACE_FORWARD, relayed.hop_count, dest->peer_info.peer_addr, &relayed);
+        taskENTER_CRITICAL(&LINK.lock);
+        LINK.stats.relayed++;
+        taskEXIT_CRITICAL(&LINK.lock);
+    } else {
+        _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
+    }
+    return true;
+}
+
+// ========== CLIENT ==========
+
+static void _client_install(FPR_STORE_HASH_TYPE *host, const fpr_link_frame_t *intro)
+{
+    uint8_t mac[MAC_ADDRESS_LENGTH];
+    memcpy(mac, intro->peer, MAC_ADDRESS_LENGTH);
+
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(mac);
+    if (peer != NULL && !peer->is_link) {
+        ESP_LOGW(TAG, "Ignoring introduction to %s - it is one of our hosts", peer->name);
+        return;
+    }
+
+    uint8_t key[FPR_KEY_SIZE];
+    uint8_t check[FPR_KEY_CHECK_SIZE];
+    if (!host->security.lwk_valid || _wrap_key(host->security.lwk, intro, intro->key, key, check) != ESP_OK ||
+        memcmp(check, intro->check, FPR_KEY_CHECK_SIZE) != 0) {
+        ESP_LOGW(TAG, "Ignoring introduction to %s - not sent under our session key", intro->name);
+        taskENTER_CRITICAL(&LINK.lock);
+        LINK.stats.rejected++;
+        taskEXIT_CRITICAL(&LINK.lock);
+        return;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    taskENTER_CRITICAL(&LINK.lock);
+    fpr_link_entry_t *entry = _find(mac);
+    for (int i = 0; entry == NULL && i < FPR_LINK_MAX; i++) {
+        if (!LINK.links[i].in_use) {
+            entry = &LINK.links[i];
+            memset(entry, 0, sizeof(*entry));
+            memcpy(entry->mac, mac, MAC_ADDRESS_LENGTH);
+            entry->in_use = true;
+        }
+    }
+    if (entry != NULL) {
+        // New key: the direct path has to prove itself again
+        entry->last_direct_us = 0;
+        entry->last_heard_us = now_us;
+        entry->tx_fail_streak = 0;
+    }
+    taskEXIT_CRITICAL(&LINK.lock);
+    if (entry == NULL) {
+        ESP_LOGW(TAG, "No free link entry for %s", intro->name);
+        memset(key, 0, FPR_KEY_SIZE);
+        return;
+    }
+
+    if (peer == NULL) {
+        esp_err_t err = _add_discovered_peer(intro->name, mac, 0, false);
+        peer = (err == ESP_OK) ? _get_peer_from_map(mac) : NULL;
+        if (peer == NULL) {
+            ESP_LOGE(TAG, "Failed to add linked peer %s: %s", intro->name, esp_err_to_name(err));
+            taskENTER_CRITICAL(&LINK.lock);
+            entry->in_use = false;
+            taskEXIT_CRITICAL(&LINK.lock);
+            memset(key, 0, FPR_KEY_SIZE);
+            return;
+        }
+    }
+
+    peer->is_link = true;
+    _peer_set_state(peer, FPR_PEER_STATE_CONNECTED, FPR_EVENT_REASON_NONE);
+    peer->sec_state = FPR_SEC_STATE_ESTABLISHED;
+    memcpy(peer->security.pwk, key, FPR_KEY_SIZE);
+    peer->security.pwk_valid = true;
+    peer->last_seq_num = 0;
+    peer->receiving_fragmented = false;
+    peer->fragment_seq_num = 0;
+
+    // The pairwise key becomes the ESP-NOW local master key of this peer
+    peer->peer_info.encrypt = true;
+    memcpy(peer->peer_info.lmk, key, FPR_KEY_SIZE);
+    memset(key, 0, FPR_KEY_SIZE);
+    if (_fpr_transport_mod_peer(&peer->peer_info) != ESP_OK) {
+        ESP_LOGW(TAG, "No encrypted peer slot left - link to %s runs unencrypted", peer->name);
+        peer->peer_info.encrypt = false;
+        memset(peer->peer_info.lmk, 0, sizeof(peer->peer_info.lmk));
+        _fpr_transport_mod_peer(&peer->peer_info);
+    }
+
+    taskENTER_CRITICAL(&LINK.lock);
+    entry->info.encrypted = peer->peer_info.encrypt;
+    taskEXIT_CRITICAL(&LINK.lock);
+
+    ESP_LOGI(TAG, "Link to %s (" MACSTR ") introduced by %s", peer->name, MAC2STR(mac), host->name);
+    fpr_link_frame_t hello = {
+        .kind = FPR_LINK_KIND_HELLO,
+    };
+    _send_frame(mac, NULL, &hello);
+    _update_job();
+}
+
+void _fpr_link_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package)
+{
+    const fpr_link_frame_t *frame = (const fpr_link_frame_t *)&package->protocol;
+
+    if (fpr_net.current_mode == FPR_MODE_HOST) {
+        if (frame->kind == FPR_LINK_KIND_REQUEST) {
+            _host_introduce(peer, frame);
+        }
+        return;
+    }
+    if (fpr_net.current_mode != FPR_MODE_CLIENT) {
+        return;
+    }
+
+    switch (frame->kind) {
+        case FPR_LINK_KIND_INTRO:
+            // Only the active host hands out keys
+            if (!peer->is_link && _fpr_standby_is_active_host(peer->peer_info.peer_addr)) {
+                _client_install(peer, frame);
+            }
+            break;
+        case FPR_LINK_KIND_REJECT:
+            if (!peer->is_link) {
+                ESP_LOGW(TAG, "Host refused link to " MACSTR ": %s", MAC2STR(frame->peer), esp_err_to_name(frame->status));
+                taskENTER_CRITICAL(&LINK.lock);
+                LINK.stats.rejected++;
+                taskEXIT_CRITICAL(&LINK.lock);
+            }
+            break;
+        case FPR_LINK_KIND_HELLO:
+            // Liveness already recorded in _fpr_link_on_client_rx()
+            break;
+        case FPR_LINK_KIND_CLOSE:
+            if (peer->is_link) {
+                ESP_LOGI(TAG, "Link to %s closed by the peer", peer->name);
+                _release(peer, FPR_EVENT_REASON_REMOTE);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool _fpr_link_route(const uint8_t *peer_address, fpr_package_id_t package_id, uint8_t *via_out)
+{
+    if (!LINK.ready || peer_address == NULL || package_id == FPR_PACKET_ID_LINK || fpr_net.current_mode != FPR_MODE_CLIENT) {
+        return false;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    taskENTER_CRITICAL(&LINK.lock);
+    fpr_link_entry_t *entry = _find(peer_address);
+    bool direct = entry == NULL || _path_is_direct(entry, now_us);
+    if (entry != NULL && direct) {
+        entry->info.direct_tx++;
+        LINK.stats.direct_tx++;
+    }
+    taskEXIT_CRITICAL(&LINK.lock);
+    if (direct || fpr_client_get_host_info(via_out, NULL, 0) != ESP_OK) {
+        return false;
+    }
+
+    taskENTER_CRITICAL(&LINK.lock);
+    entry = _find(peer_address);
+    if (entry != NULL) {
+        entry->info.relayed_tx++;
+    }
+    LINK.stats.relayed_tx++;
+    taskEXIT_CRITICAL(&LINK.lock);
+    return true;
+}
+
+bool _fpr_link_on_client_rx(const esp_now_recv_info_t *esp_now_info, FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package)
+{
+    if (fpr_net.current_mode != FPR_MODE_CLIENT || !LINK.ready) {
+        return false;
+    }
+    bool is_data = package->id != FPR_PACKET_ID_LINK;
+    int64_t now_us = esp_timer_get_time();
+
+    // Straight from a linked client
+    if (peer->is_link) {
+        taskENTER_CRITICAL(&LINK.lock);
+        fpr_link_entry_t *entry = _find(peer->peer_info.peer_addr);
+        if (entry != NULL) {
+            entry->last_direct_us = now_us;
+            entry->last_heard_us = now_us;
+            entry->info.rssi = esp_now_info->rx_ctrl->rssi;
+            if (is_data) {
+                entry->info.direct_rx++;
+                LINK.stats.direct_rx++;
+            }
+        }
+        taskEXIT_CRITICAL(&LINK.lock);
+        return false;
+    }
+
+    // Relayed by our host on behalf of a linked client
+    if (memcmp(package->origin_mac, esp_now_info->src_addr, MAC_ADDRESS_LENGTH) == 0 || !_is_unicast_dest(package->origin_mac)) {
+        return false;
+    }
+    FPR_STORE_HASH_TYPE *origin = _get_peer_from_map(package->origin_mac);
+    if (origin == NULL || !origin->is_link || !origin->is_connected) {
+        #if (FPR_DEBUG == 1)
+        ESP_LOGW(TAG, "Dropping relayed packet from unlinked " MACSTR, MAC2STR(package->origin_mac));
+        #endif
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_UNAUTHORIZED, esp_now_info->src_addr, package);
+        return true;
+    }
+
+    taskENTER_CRITICAL(&LINK.lock);
+    fpr_link_entry_t *entry = _find(origin->peer_info.peer_addr);
+    if (entry != NULL) {
+        entry->last_heard_us = now_us;
+        if (is_data) {
+            entry->info.relayed_rx++;
+            LINK.stats.relayed_rx++;
+        }
+    }
+    taskEXIT_CRITICAL(&LINK.lock);
+
+    // Deliver as if the linked client had sent it; its direct RSSI is kept separately
+    esp_now_recv_info_t relayed_info = *esp_now_info;
+    relayed_info.src_addr = origin->peer_info.peer_addr;
+    _store_data_from_peer_helper(&relayed_info, package);
+    return true;
+}
+
+void _fpr_link_on_send_status(const uint8_t *mac, bool success)
+{
+    if (!LINK.ready || mac == NULL || fpr_net.current_mode != FPR_MODE_CLIENT) {
+        return;
+    }
+    taskENTER_CRITICAL(&LINK.lock);
+    fpr_link_entry_t *entry = _find(mac);
+    if (entry != NULL) {
+        if (success) {
+            entry->tx_fail_streak = 0;
+        } else {
+            entry->info.tx_failures++;
+            if (entry->tx_fail_streak < UINT8_MAX) {
+                entry->tx_fail_streak++;
+            }
+        }
+    }
+    taskEXIT_CRITICAL(&LINK.lock);
+}
+
+void _fpr_link_on_peer_removed(FPR_STORE_HASH_TYPE *peer)
+{
+    if (!LINK.ready) {
+        return;
+    }
+    taskENTER_CRITICAL(&LINK.lock);
+    fpr_link_entry_t *entry = _find(peer->peer_info.peer_addr);
+    if (entry != NULL) {
+        entry->in_use = false;
+    }
+    taskEXIT_CRITICAL(&LINK.lock);
+    _update_job();
+}
+
+// Path checks and hellos. While degraded, a hello also goes through the
+// host so the other side keeps hearing from us. Finishes with the last link.
+static int64_t _link_job(int64_t now_us)
+{
+    const int64_t next_us = now_us + (int64_t)FPR_LINK_HELLO_INTERVAL_MS * 1000;
+    if (fpr_net.current_mode != FPR_MODE_CLIENT || fpr_net.paused) {
+        return next_us;
+    }
+
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    bool have_host = fpr_client_get_host_info(host_mac, NULL, 0) == ESP_OK;
+    const int64_t expire_us = (int64_t)FPR_RECONNECT_TIMEOUT_MS * 1000;
+    fpr_link_frame_t hello = {
+        .kind = FPR_LINK_KIND_HELLO,
+    };
+    int links = 0;
+
+    for (int i = 0; i < FPR_LINK_MAX; i++) {
+        uint8_t mac[MAC_ADDRESS_LENGTH];
+        bool was_direct = false;
+        bool direct = false;
+        bool expired = false;
+
+        taskENTER_CRITICAL(&LINK.lock);
+        fpr_link_entry_t *entry = &LINK.links[i];
+        if (!entry->in_use) {
+            taskEXIT_CRITICAL(&LINK.lock);
+            continue;
+        }
+        memcpy(mac, entry->mac, MAC_ADDRESS_LENGTH);
+        was_direct = entry->info.direct;
+        direct = _path_is_direct(entry, now_us);
+        expired = now_us - entry->last_heard_us > expire_us;
+        entry->info.direct = direct;
+        if (was_direct && !direct) {
+            entry->info.fallbacks++;
+            LINK.stats.fallbacks++;
+        } else if (!was_direct && direct && entry->info.fallbacks > 0) {
+            LINK.stats.recoveries++;
+        }
+        taskEXIT_CRITICAL(&LINK.lock);
+
+        FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(mac);
+        if (peer == NULL) {
+            taskENTER_CRITICAL(&LINK.lock);
+            entry->in_use = false;
+            taskEXIT_CRITICAL(&LINK.lock);
+            continue;
+        }
+        if (expired) {
+            ESP_LOGW(TAG, "Link to %s timed out", peer->name);
+            _release(peer, FPR_EVENT_REASON_TIMEOUT);
+            continue;
+        }
+        if (was_direct != direct) {
+            ESP_LOGI(TAG, "Link to %s: %s", peer->name, direct ? "direct path up" : "direct path degraded - relaying through host");
+        }
+
+        _send_frame(mac, NULL, &hello);
+        if (!direct && have_host) {
+            _send_frame(mac, host_mac, &hello);
+        }
+        links++;
+    }
+    return links > 0 ? next_us : 0;
+}
+
+void _fpr_link_init(void)
+{
+    memset(&LINK, 0, sizeof(LINK));
+    portMUX_INITIALIZE(&LINK.lock);
+    LINK.ready = true;
+}
+
+void _fpr_link_deinit(void)
+{
+    LINK.ready = false;
+    _fpr_sched_cancel(FPR_JOB_LINK);
+}
+
+// ========== PUBLIC API ==========
+
+esp_err_t fpr_link_request(const uint8_t *peer_mac)
+{
+    ESP_RETURN_ON_FALSE(peer_mac != NULL, ESP_ERR_INVALID_ARG, TAG, "Peer MAC is NULL");
+    ESP_RETURN_ON_FALSE(LINK.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    ESP_RETURN_ON_FALSE(fpr_net.current_mode == FPR_MODE_CLIENT, ESP_ERR_INVALID_STATE, TAG, "Links require client mode");
+
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    ESP_RETURN_ON_FALSE(fpr_client_get_host_info(host_mac, NULL, 0) == ESP_OK, ESP_ERR_INVALID_STATE, TAG, "Not connected to a host");
+    ESP_RETURN_ON_FALSE(memcmp(peer_mac, host_mac, MAC_ADDRESS_LENGTH) != 0, ESP_ERR_INVALID_ARG, TAG, "Cannot link to our own host");
+
+    taskENTER_CRITICAL(&LINK.lock);
+    bool has_room = _find(peer_mac) != NULL;
+    for (int i = 0; !has_room && i < FPR_LINK_MAX; i++) {
+        has_room = !LINK.links[i].in_use;
+    }
+    taskEXIT_CRITICAL(&LINK.lock);
+    ESP_RETURN_ON_FALSE(has_room, ESP_ERR_NO_MEM, TAG, "All %d link entries in use", FPR_LINK_MAX);
+
+    fpr_link_frame_t req = {
+        .kind = FPR_LINK_KIND_REQUEST,
+    };
+    memcpy(req.peer, peer_mac, MAC_ADDRESS_LENGTH);
+    return fpr_network_send_to_peer(host_mac, &req, sizeof(req), FPR_PACKET_ID_LINK);
+}
+
+esp_err_t fpr_link_close(const uint8_t *peer_mac)
+{
+    ESP_RETURN_ON_FALSE(peer_mac != NULL, ESP_ERR_INVALID_ARG, TAG, "Peer MAC is NULL");
+    ESP_RETURN_ON_FALSE(LINK.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map((uint8_t *)peer_mac);
+    taskENTER_CRITICAL(&LINK.lock);
+    fpr_link_entry_t *entry = _find(peer_mac);
+    bool direct = entry != NULL && _path_is_direct(entry, esp_timer_get_time());
+    taskEXIT_CRITICAL(&LINK.lock);
+    ESP_RETURN_ON_FALSE(entry != NULL && peer != NULL, ESP_ERR_NOT_FOUND, TAG, "No link to " MACSTR, MAC2STR(peer_mac));
+
+    fpr_link_frame_t bye = {
+        .kind = FPR_LINK_KIND_CLOSE,
+    };
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    if (direct || fpr_client_get_host_info(host_mac, NULL, 0) != ESP_OK) {
+        _send_frame(peer->peer_info.peer_addr, NULL, &bye);
+    } else {
+        _send_frame(peer->peer_info.peer_addr, host_mac, &bye);
+    }
+    ESP_LOGI(TAG, "Link to %s closed", peer->name);
+    _release(peer, FPR_EVENT_REASON_LOCAL);
+    return ESP_OK;
+}
+
+esp_err_t fpr_link_get_info(const uint8_t *peer_mac, fpr_link_info_t *info)
+{
+    ESP_RETURN_ON_FALSE(peer_mac != NULL && info != NULL, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    if (!LINK.ready) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    taskENTER_CRITICAL(&LINK.lock);
+    fpr_link_entry_t *entry = _find(peer_mac);
+    if (entry != NULL) {
+        *info = entry->info;
+        info->direct = _path_is_direct(entry, esp_timer_get_time());
+    }
+    taskEXIT_CRITICAL(&LINK.lock);
+    return entry != NULL ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+void fpr_link_get_stats(fpr_link_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    if (!LINK.ready) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    taskENTER_CRITICAL(&LINK.lock);
+    *stats = LINK.stats;
+    stats->links = 0;
+    for (int i = 0; i < FPR_LINK_MAX; i++) {
+        if (LINK.links[i].in_use) {
+            stats->links++;
+        }
+    }
+    taskEXIT_CRITICAL(&LINK.lock);
+}
@@ -0,0 +1,463 @@
+/**
+ * @file fpr_pubsub.c
+ * @brief FPR Publish/Subscribe Service implementation
+ *
+ * The host owns the topic table: per topic it keeps a bitmap of subscribed
+ * peer slots and an optional retained value. Clients only keep their local
+ * subscriptions and replay them to the host whenever they connect, so the
+ * host can treat every new session as starting with no subscriptions.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_pubsub.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "esp_check.h"
+#include "esp_log.h"
+
+static const char *TAG = "fpr_pubsub";
+
+#define PS fpr_net.pubsub
+
+static inline bool _is_host(void)
+{
+    return fpr_net.current_mode == FPR_MODE_HOST;
+}
+
+// Must be called with the lock held
+static fpr_pubsub_topic_t *_find_topic(fpr_topic_t topic, bool create)
+{
+    fpr_pubsub_topic_t *free_entry = NULL;
+    for (int i = 0; i < FPR_PUBSUB_MAX_TOPICS; i++) {
+        if (PS.topics[i].in_use) {
+            if (PS.topics[i].topic == topic) {
+                return &PS.topics[i];
+            }
+        } else if (free_entry == NULL) {
+            free_entry = &PS.topics[i];
+        }
+    }
+    if (create && free_entry != NULL) {
+        memset(free_entry, 0, sizeof(*free_entry));
+        free_entry->topic = topic;
+        free_entry->in_use = true;
+        return free_entry;
+    }
+    return NULL;
+}
+
+// Must be called with the lock held
+static fpr_pubsub_sub_t *_find_sub(fpr_topic_t topic)
+{
+    for (int i = 0; i < FPR_PUBSUB_MAX_SUBSCRIPTIONS; i++) {
+        if (PS.subs[i].in_use && PS.subs[i].topic == topic) {
+            return &PS.subs[i];
+        }
+    }
+    return NULL;
+}
+
+static esp_err_t _send_frame(const uint8_t *peer_mac, const fpr_pubsub_frame_t *frame)
+{
+    uint8_t dest[MAC_ADDRESS_LENGTH];
+    memcpy(dest, peer_mac, MAC_ADDRESS_LENGTH);
+    return fpr_network_send_to_peer(dest, (void *)frame, (int)(FPR_PUBSUB_FRAME_HEADER_SIZE + frame->payload_len), FPR_PACKET_ID_PUBSUB);
+}
+
+static void _deliver_local(fpr_topic_t topic, const void *data, size_t len, bool retained)
+{
+    fpr_pubsub_cb_t cb = NULL;
+    void *user_data = NULL;
+
+    taskENTER_CRITICAL(&PS.lock);
+    fpr_pubsub_sub_t *sub = _find_sub(topic);
+    if (sub) {
+        cb = sub->cb;
+        user_data = sub->user_data;
+        PS.stats.received++;
+    }
+    taskEXIT_CRITICAL(&PS.lock);
+
+    if (cb) {
+        FPR_APP_CALLBACK(cb(topic, data, len, retained, user_data));
+    }
+}
+
+// Host: store retained value and fan out to every subscriber except the origin slot
+static esp_err_t _host_publish(fpr_topic_t topic, const uint8_t *payload, uint16_t len, bool retain, uint8_t origin_slot)
+{
+    fpr_peer_bitmap_t targets = 0;
+    esp_err_t result = ESP_OK;
+
+    taskENTER_CRITICAL(&PS.lock);
+    fpr_pubsub_topic_t *entry = _find_topic(topic, retain);
+    if (entry) {
+        if (retain) {
+            if (len > 0) {
+                memcpy(entry->retained, payload, len);
+            }
+            entry->retained_len = len;
+            entry->has_retained = true;
+        }
+        targets = entry->subscribers;
+    } else if (retain) {
+        PS.stats.dropped++;
+        result = ESP_ERR_NO_MEM;
+    }
+    taskEXIT_CRITICAL(&PS.lock);
+
+    if (origin_slot < FPR_MAX_PEER_SLOTS) {
+        targets &= ~FPR_PEER_BIT(origin_slot);
+    }
+
+    fpr_pubsub_frame_t frame = {
+        .kind = FPR_PUBSUB_KIND_DELIVER,
+        .topic = topic,
+        .payload_len = len,
+    };
+    if (len > 0) {
+        memcpy(frame.payload, payload, len);
+    }
+
+    uint32_t delivered = 0;
+    while (targets) {
+        uint8_t slot = (uint8_t)__builtin_ctzll(targets);
+        targets &= targets - 1;
+        FPR_STORE_HASH_TYPE *peer = _get_peer_by_slot(slot);
+        if (peer && peer->state == FPR_PEER_STATE_CONNECTED &&
+            _send_frame(peer->peer_info.peer_addr, &frame) == ESP_OK) {
+            delivered++;
+        }
+    }
+
+    taskENTER_CRITICAL(&PS.lock);
+    PS.stats.delivered += delivered;
+    taskEXIT_CRITICAL(&PS.lock);
+
+    _deliver_local(topic, payload, len, false);
+    return result;
+}
+
+static void _host_subscribe(FPR_STORE_HASH_TYPE *peer, fpr_topic_t topic)
+{
+    if (peer->slot >= FPR_MAX_PEER_SLOTS) {
+        taskENTER_CRITICAL(&PS.lock);
+        PS.stats.dropped++;
+        taskEXIT_CRITICAL(&PS.lock);
+        return;
+    }
+
+    fpr_pubsub_frame_t frame = {
+        .kind = FPR_PUBSUB_KIND_DELIVER,
+        .flags = FPR_PUBSUB_FLAG_RETAINED,
+        .topic = topic,
+    };
+    bool send_retained = false;
+    bool accepted = false;
+
+    taskENTER_CRITICAL(&PS.lock);
+    fpr_pubsub_topic_t *entry = _find_topic(topic, true);
+    if (entry) {
+        entry->subscribers |= FPR_PEER_BIT(peer->slot);
+        PS.stats.subscribes++;
+        accepted = true;
+        if (entry->has_retained) {
+            memcpy(frame.payload, entry->retained, entry->retained_len);
+            frame.payload_len = entry->retained_len;
+            send_retained = true;
+        }
+    } else {
+        PS.stats.dropped++;
+    }
+    taskEXIT_CRITICAL(&PS.lock);
+
+    if (!accepted) {
+        ESP_LOGW(TAG, "Topic table full - subscribe to %u from %s dropped", topic, peer->name);
+        return;
+    }
+
+    if (send_retained && _send_frame(peer->peer_info.peer_addr, &frame) == ESP_OK) {
+        taskENTER_CRITICAL(&PS.lock);
+        PS.stats.retained_sent++;
+        taskEXIT_CRITICAL(&PS.lock);
+    }
+}
+
+static void _host_unsubscribe(FPR_STORE_HASH_TYPE *peer, fpr_topic_t topic)
+{
+    if (peer->slot >= FPR_MAX_PEER_SLOTS) {
+        return;
+    }
+    taskENTER_CRITICAL(&PS.lock);
+    fpr_pubsub_topic_t *entry = _find_topic(topic, false);
+    if (entry) {
+        entry->subscribers &= ~FPR_PEER_BIT(peer->slot);
+        if (entry->subscribers == 0 && !entry->has_retained) {
+            entry->in_use = false;
+        }
+    }
+    taskEXIT_CRITICAL(&PS.lock);
+}
+
+// Must be called with the lock held
+static void _clear_slot(uint8_t slot)
+{
+    for (int i = 0; i < FPR_PUBSUB_MAX_TOPICS; i++) {
+        fpr_pubsub_topic_t *entry = &PS.topics[i];
+        if (entry->in_use) {
+            entry->subscribers &= ~FPR_PEER_BIT(slot);
+            if (entry->subscribers == 0 && !entry->has_retained) {
+                entry->in_use = false;
+            }
+        }
+    }
+}
+
+static void _client_send_subscription(const uint8_t *host_mac, fpr_topic_t topic, fpr_pubsub_kind_t kind)
+{
+    fpr_pubsub_frame_t frame = {
+        .kind = kind,
+        .topic = topic,
+    };
+    esp_err_t err = _send_frame(host_mac, &frame);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to send subscription for topic %u: %s", topic, esp_err_to_name(err));
+    }
+}
+
+// ========== SERVICE HOOKS ==========
+
+void _fpr_pubsub_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package)
+{
+    if (!PS.ready) {
+        return;
+    }
+
+    const fpr_pubsub_frame_t *frame = (const fpr_pubsub_frame_t *)&package->protocol;
+    if (package->payload_size < FPR_PUBSUB_FRAME_HEADER_SIZE ||
+        frame->payload_len > FPR_PUBSUB_MAX_PAYLOAD ||
+        package->payload_size < FPR_PUBSUB_FRAME_HEADER_SIZE + frame->payload_len) {
+        ESP_LOGW(TAG, "Malformed pub/sub frame from " MACSTR, MAC2STR(peer->peer_info.peer_addr));
+        return;
+    }
+
+    switch (frame->kind) {
+        case FPR_PUBSUB_KIND_SUBSCRIBE:
+            if (_is_host()) {
+                _host_subscribe(peer, frame->topic);
+            }
+            break;
+        case FPR_PUBSUB_KIND_UNSUBSCRIBE:
+            if (_is_host()) {
+                _host_unsubscribe(peer, frame->topic);
+            }
+            break;
+        case FPR_PUBSUB_KIND_PUBLISH:
+            if (_is_host()) {
+                _host_publish(frame->topic, frame->payload, frame->payload_len,
+                              (frame->flags & FPR_PUBSUB_FLAG_RETAIN) != 0, peer->slot);
+            }
+            break;
+        case FPR_PUBSUB_KIND_DELIVER:
+            _deliver_local(frame->topic, frame->payload, frame->payload_len,
+                           (frame->flags & FPR_PUBSUB_FLAG_RETAINED) != 0);
+            break;
+        default:
+            ESP_LOGW(TAG, "Unknown pub/sub frame kind %d", frame->kind);
+            break;
+    }
+}
+
+void _fpr_pubsub_on_peer_connected(FPR_STORE_HASH_TYPE *peer)
+{
+    if (!PS.ready) {
+        return;
+    }
+
+    if (_is_host()) {
+        // New session - the client replays whatever it still wants
+        if (peer->slot < FPR_MAX_PEER_SLOTS) {
+            taskENTER_CRITICAL(&PS.lock);
+            _clear_slot(peer->slot);
+            taskEXIT_CRITICAL(&PS.lock);
+        }
+        return;
+    }
+
+    fpr_topic_t topics[FPR_PUBSUB_MAX_SUBSCRIPTIONS];
+    int count = 0;
+    taskENTER_CRITICAL(&PS.lock);
+    for (int i = 0; i < FPR_PUBSUB_MAX_SUBSCRIPTIONS; i++) {
+        if (PS.subs[i].in_use) {
+            topics[count++] = PS.subs[i].topic;
+        }
+    }
+    taskEXIT_CRITICAL(&PS.lock);
+
+    for (int i = 0; i < count; i++) {
+        _client_send_subscription(peer->peer_info.peer_addr, topics[i], FPR_PUBSUB_KIND_SUBSCRIBE);
+    }
+}
+
+void _fpr_pubsub_on_peer_disconnected(FPR_STORE_HASH_TYPE *peer)
+{
+    if (!PS.ready || peer->slot >= FPR_MAX_PEER_SLOTS) {
+        return;
+    }
+    taskENTER_CRITICAL(&PS.lock);
+    _clear_slot(peer->slot);
+    taskEXIT_CRITICAL(&PS.lock);
+}
+
+void _fpr_pubsub_init(void)
+{
+    memset(&PS, 0, sizeof(PS));
+    portMUX_INITIALIZE(&PS.lock);
+    PS.ready = true;
+}
+
+void _fpr_pubsub_deinit(void)
+{
+    PS.ready = false;
+}
+
+// ========== PUBLIC API ==========
+
+esp_err_t fpr_pubsub_subscribe(fpr_topic_t topic, fpr_pubsub_cb_t cb, void *user_data)
+{
+    ESP_RETURN_ON_FALSE(cb != NULL, ESP_ERR_INVALID_ARG, TAG, "Callback is NULL");
+    ESP_RETURN_ON_FALSE(PS.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    bool added = false;
+    taskENTER_CRITICAL(&PS.lock);
+    fpr_pubsub_sub_t *sub = _find_sub(topic);
+    for (int i = 0; sub == NULL && i < FPR_PUBSUB_MAX_SUBSCRIPTIONS; i++) {
+        if (!PS.subs[i].in_use) {
+            sub = &PS.subs[i];
+        }
+    }
+    if (sub) {
+        sub->topic = topic;
+        sub->cb = cb;
+        sub->user_data = user_data;
+        sub->in_use = true;
+        added = true;
+    }
+    taskEXIT_CRITICAL(&PS.lock);
+
+    ESP_RETURN_ON_FALSE(added, ESP_ERR_NO_MEM, TAG, "Subscription table full");
+
+    if (_is_host()) {
+        uint8_t value[FPR_PUBSUB_MAX_PAYLOAD];
+        size_t len = sizeof(value);
+        if (fpr_pubsub_get_retained(topic, value, &len) == ESP_OK) {
+            _deliver_local(topic, value, len, true);
+        }
+        return ESP_OK;
+    }
+
+    // Not connected yet - the subscription is replayed on connect
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    if (fpr_client_get_host_info(host_mac, NULL, 0) == ESP_OK) {
+        _client_send_subscription(host_mac, topic, FPR_PUBSUB_KIND_SUBSCRIBE);
+    }
+    return ESP_OK;
+}
+
+esp_err_t fpr_pubsub_unsubscribe(fpr_topic_t topic)
+{
+    ESP_RETURN_ON_FALSE(PS.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    bool found = false;
+    taskENTER_CRITICAL(&PS.lock);
+    fpr_pubsub_sub_t *sub = _find_sub(topic);
+    if (sub) {
+        sub->in_use = false;
+        found = true;
+    }
+    taskEXIT_CRITICAL(&PS.lock);
+
+    if (!found) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    if (!_is_host() && fpr_client_get_host_info(host_mac, NULL, 0) == ESP_OK) {
+        _client_send_subscription(host_mac, topic, FPR_PUBSUB_KIND_UNSUBSCRIBE);
+    }
+    return ESP_OK;
+}
+
+esp_err_t fpr_pubsub_publish(fpr_topic_t topic, const void *data, size_t len, bool retain)
+{
+    ESP_RETURN_ON_FALSE(data != NULL || len == 0, ESP_ERR_INVALID_ARG, TAG, "Data is NULL");
+    ESP_RETURN_ON_FALSE(len <= FPR_PUBSUB_MAX_PAYLOAD, ESP_ERR_INVALID_SIZE, TAG, "Payload too large");
+    ESP_RETURN_ON_FALSE(PS.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    taskENTER_CRITICAL(&PS.lock);
+    PS.stats.published++;
+    taskEXIT_CRITICAL(&PS.lock);
+
+    if (_is_host()) {
+        return _host_publish(topic, (const uint8_t *)data, (uint16_t)len, retain, FPR_PEER_SLOT_NONE);
+    }
+
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    ESP_RETURN_ON_FALSE(fpr_client_get_host_info(host_mac, NULL, 0) == ESP_OK, ESP_ERR_INVALID_STATE, TAG, "Not connected to a host");
+
+    fpr_pubsub_frame_t frame = {
+        .kind = FPR_PUBSUB_KIND_PUBLISH,
+        .flags = retain ? FPR_PUBSUB_FLAG_RETAIN : 0,
+        .topic = topic,
+        .payload_len = (uint16_t)len,
+    };
+    if (len > 0) {
+        memcpy(frame.payload, data, len);
+    }
+    return _send_frame(host_mac, &frame);
+}
+
+esp_err_t fpr_pubsub_get_retained(fpr_topic_t topic, void *buf, size_t *len)
+{
+    ESP_RETURN_ON_FALSE(buf != NULL && len != NULL, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    ESP_RETURN_ON_FALSE(PS.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    esp_err_t result = ESP_ERR_NOT_FOUND;
+    taskENTER_CRITICAL(&PS.lock);
+    fpr_pubsub_topic_t *entry = _find_topic(topic, false);
+    if (entry && entry->has_retained) {
+        size_t copy_len = entry->retained_len < *len ? entry->retained_len : *len;
+        memcpy(buf, entry->retained, copy_len);
+        *len = copy_len;
+        result = ESP_OK;
+    }
+    taskEXIT_CRITICAL(&PS.lock);
+    return result;
+}
+
+void fpr_pubsub_get_stats(fpr_pubsub_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    if (!PS.ready) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    taskENTER_CRITICAL(&PS.lock);
+    *stats = PS.stats;
+    taskEXIT_CRITICAL(&PS.lock);
+}
+
+void fpr_pubsub_reset_stats(void)
+{
+    if (!PS.ready) {
+        return;
+    }
+    taskENTER_CRITICAL(&PS.lock);
+    memset(&PS.stats, 0, sizeof(PS.stats));
+    taskEXIT_CRITICAL(&PS.lock);
+}
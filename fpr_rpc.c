@@ -0,0 +1,565 @@
+/**
+ * @file fpr_rpc.c
+ * @brief FPR Request/Response (RPC) Service implementation
+ *
+ * Requests and responses travel as single FPR_PACKET_ID_RPC packets holding
+ * an fpr_rpc_frame_t. Outstanding calls live in a fixed pending table and
+ * are linked into a hashed timing wheel, so expiring calls costs one slot
+ * walk per tick no matter how many calls are outstanding. The wheel timer
+ * only runs while at least one call is pending.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_rpc.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "fpr_rpc";
+
+#define RPC fpr_net.rpc
+
+// Completion captured under the lock and delivered after it is released
+typedef struct {
+    fpr_rpc_response_cb_t cb;
+    void *user_data;
+    uint32_t call_id;
+    uint8_t peer_mac[MAC_ADDRESS_LENGTH];
+} fpr_rpc_completion_t;
+
+// ========== TIMEOUT WHEEL ==========
+
+static inline bool _rpc_ready(void)
+{
+    return RPC.wheel_timer != NULL;
+}
+
+static void _wheel_link(fpr_rpc_pending_t *call, uint32_t timeout_ms)
+{
+    uint32_t ticks = (timeout_ms + FPR_RPC_WHEEL_TICK_MS - 1) / FPR_RPC_WHEEL_TICK_MS;
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    call->slot = (uint16_t)((RPC.wheel_cursor + ticks) % FPR_RPC_WHEEL_SLOTS);
+    call->rounds = (ticks - 1) / FPR_RPC_WHEEL_SLOTS;
+    call->next = RPC.wheel[call->slot];
+    RPC.wheel[call->slot] = call;
+}
+
+static void _wheel_unlink(fpr_rpc_pending_t *call)
+{
+    fpr_rpc_pending_t **link = &RPC.wheel[call->slot];
+    while (*link != NULL) {
+        if (*link == call) {
+            *link = call->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+    call->next = NULL;
+}
+
+// Must be called with the lock held
+static void _release_call(fpr_rpc_pending_t *call, fpr_rpc_completion_t *out)
+{
+    _wheel_unlink(call);
+    if (out) {
+        out->cb = call->cb;
+        out->user_data = call->user_data;
+        out->call_id = call->call_id;
+        memcpy(out->peer_mac, call->peer_mac, MAC_ADDRESS_LENGTH);
+    }
+    call->in_use = false;
+    RPC.stats.pending--;
+}
+
+// Must be called with the lock held
+static fpr_rpc_pending_t *_find_call(uint32_t call_id)
+{
+    for (int i = 0; i < FPR_RPC_MAX_PENDING; i++) {
+        if (RPC.pending[i].in_use && RPC.pending[i].call_id == call_id) {
+            return &RPC.pending[i];
+        }
+    }
+    return NULL;
+}
+
+FPR_INSTANCE_TIMER_CB(_wheel_tick)
+{
+    fpr_rpc_completion_t expired[FPR_RPC_MAX_PENDING];
+    int expired_count = 0;
+    bool idle;
+
+    taskENTER_CRITICAL(&RPC.lock);
+    RPC.timer_task = xTaskGetCurrentTaskHandle();
+    RPC.wheel_cursor = (RPC.wheel_cursor + 1) % FPR_RPC_WHEEL_SLOTS;
+    fpr_rpc_pending_t *call = RPC.wheel[RPC.wheel_cursor];
+    while (call != NULL) {
+        fpr_rpc_pending_t *next = call->next;
+        if (call->rounds == 0) {
+            _release_call(call, &expired[expired_count++]);
+            RPC.stats.timeouts++;
+        } else {
+            call->rounds--;
+        }
+        call = next;
+    }
+    idle = (RPC.stats.pending == 0);
+    taskEXIT_CRITICAL(&RPC.lock);
+
+    for (int i = 0; i < expired_count; i++) {
+        FPR_APP_CALLBACK(expired[i].cb(expired[i].peer_mac, expired[i].call_id, ESP_ERR_TIMEOUT, NULL, 0, expired[i].user_data));
+    }
+
+    if (idle) {
+        esp_timer_stop(RPC.wheel_timer);
+        // A call may have been issued between the check and the stop
+        taskENTER_CRITICAL(&RPC.lock);
+        idle = (RPC.stats.pending == 0);
+        esp_timer_handle_t timer = RPC.wheel_timer;
+        taskEXIT_CRITICAL(&RPC.lock);
+        if (!idle && timer != NULL) {
+            esp_timer_start_periodic(timer, FPR_RPC_WHEEL_TICK_MS * 1000);
+        }
+    }
+}
+
+static void _record_latency(int64_t start_us)
+{
+    int64_t elapsed_ms = (esp_timer_get_time() - start_us) / 1000;
+    int bucket = 0;
+    while (bucket < FPR_RPC_LATENCY_BUCKETS - 1 && elapsed_ms >= ((int64_t)1 << bucket)) {
+        bucket++;
+    }
+    RPC.stats.latency_hist[bucket]++;
+}
+
+// ========== FRAME HANDLING ==========
+
+static esp_err_t _send_frame(const uint8_t *peer_mac, const fpr_rpc_frame_t *frame)
+{
+    uint8_t dest[MAC_ADDRESS_LENGTH];
+    memcpy(dest, peer_mac, MAC_ADDRESS_LENGTH);
+    return fpr_network_send_to_peer(dest, (void *)frame, (int)(FPR_RPC_FRAME_HEADER_SIZE + frame->payload_len), FPR_PACKET_ID_RPC);
+}
+
+static void _handle_request(FPR_STORE_HASH_TYPE *peer, const fpr_rpc_frame_t *req)
+{
+    fpr_rpc_handler_t handler = NULL;
+    void *user_data = NULL;
+
+    taskENTER_CRITICAL(&RPC.lock);
+    for (int i = 0; i < FPR_RPC_MAX_HANDLERS; i++) {
+        if (RPC.handlers[i].in_use && RPC.handlers[i].method == req->method) {
+            handler = RPC.handlers[i].handler;
+            user_data = RPC.handlers[i].user_data;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&RPC.lock);
+
+    fpr_rpc_frame_t resp = {
+        .kind = FPR_RPC_KIND_RESPONSE,
+        .method = req->method,
+        .call_id = req->call_id,
+    };
+
+    esp_err_t status = ESP_ERR_NOT_FOUND;
+    if (handler != NULL) {
+        size_t resp_len = sizeof(resp.payload);
+        FPR_APP_CALLBACK(status = handler(peer->peer_info.peer_addr, req->method, req->payload, req->payload_len,
+                                          resp.payload, &resp_len, user_data));
+        if (status == ESP_OK && resp_len > sizeof(resp.payload)) {
+            status = ESP_ERR_INVALID_SIZE;
+        }
+        if (status == ESP_OK) {
+            resp.payload_len = (uint16_t)resp_len;
+        }
+        taskENTER_CRITICAL(&RPC.lock);
+        RPC.stats.requests_handled++;
+        taskEXIT_CRITICAL(&RPC.lock);
+    }
+
+    if (status != ESP_OK) {
+        resp.kind = FPR_RPC_KIND_ERROR;
+        resp.status = status;
+        resp.payload_len = 0;
+    }
+
+    esp_err_t err = _send_frame(peer->peer_info.peer_addr, &resp);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to send response for call %lu: %s", (unsigned long)req->call_id, esp_err_to_name(err));
+    }
+}
+
+static void _handle_response(FPR_STORE_HASH_TYPE *peer, const fpr_rpc_frame_t *resp)
+{
+    fpr_rpc_completion_t done;
+    bool matched = false;
+
+    taskENTER_CRITICAL(&RPC.lock);
+    fpr_rpc_pending_t *call = _find_call(resp->call_id);
+    if (call && memcmp(call->peer_mac, peer->peer_info.peer_addr, MAC_ADDRESS_LENGTH) == 0) {
+        _record_latency(call->start_us);
+        _release_call(call, &done);
+        if (resp->kind == FPR_RPC_KIND_RESPONSE) {
+            RPC.stats.responses_received++;
+        } else {
+            RPC.stats.errors_received++;
+        }
+        matched = true;
+    } else {
+        RPC.stats.unmatched_responses++;
+    }
+    taskEXIT_CRITICAL(&RPC.lock);
+
+    if (!matched) {
+        #if (FPR_DEBUG == 1)
+        ESP_LOGW(TAG, "Unmatched response for call %lu from " MACSTR, (unsigned long)resp->call_id, MAC2STR(peer->peer_info.peer_addr));
+        #endif
+        return;
+    }
+
+    if (resp->kind == FPR_RPC_KIND_RESPONSE) {
+        FPR_APP_CALLBACK(done.cb(done.peer_mac, done.call_id, ESP_OK, resp->payload, resp->payload_len, done.user_data));
+    } else {
+        FPR_APP_CALLBACK(done.cb(done.peer_mac, done.call_id, (esp_err_t)resp->status, NULL, 0, done.user_data));
+    }
+}
+
+void _fpr_rpc_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package)
+{
+    if (!_rpc_ready()) {
+        return;
+    }
+
+    const fpr_rpc_frame_t *frame = (const fpr_rpc_frame_t *)&package->protocol;
+    if (package->payload_size < FPR_RPC_FRAME_HEADER_SIZE ||
+        frame->payload_len > FPR_RPC_MAX_PAYLOAD ||
+        package->payload_size < FPR_RPC_FRAME_HEADER_SIZE + frame->payload_len) {
+        ESP_LOGW(TAG, "Malformed RPC frame from " MACSTR, MAC2STR(peer->peer_info.peer_addr));
+        return;
+    }
+
+    switch (frame->kind) {
+        case FPR_RPC_KIND_REQUEST:
+            _handle_request(peer, frame);
+            break;
+        case FPR_RPC_KIND_RESPONSE:
+        case FPR_RPC_KIND_ERROR:
+            _handle_response(peer, frame);
+            break;
+        default:
+            ESP_LOGW(TAG, "Unknown RPC frame kind %d", frame->kind);
+            break;
+    }
+}
+
+// ========== LIFECYCLE ==========
+
+void _fpr_rpc_init(void)
+{
+    memset(&RPC, 0, sizeof(RPC));
+    portMUX_INITIALIZE(&RPC.lock);
+    RPC.next_call_id = 1;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = _wheel_tick,
+        .arg = &fpr_net,
+        .name = "fpr_rpc_wheel"
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &RPC.wheel_timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create RPC wheel timer: %s", esp_err_to_name(err));
+        RPC.wheel_timer = NULL;
+    }
+}
+
+void _fpr_rpc_deinit(void)
+{
+    fpr_rpc_completion_t aborted[FPR_RPC_MAX_PENDING];
+    int aborted_count = 0;
+
+    // Clear the handle first so no new call can link or start the wheel
+    taskENTER_CRITICAL(&RPC.lock);
+    esp_timer_handle_t timer = RPC.wheel_timer;
+    RPC.wheel_timer = NULL;
+    for (int i = 0; timer != NULL && i < FPR_RPC_MAX_PENDING; i++) {
+        if (RPC.pending[i].in_use) {
+            _release_call(&RPC.pending[i], &aborted[aborted_count++]);
+        }
+    }
+    taskEXIT_CRITICAL(&RPC.lock);
+
+    if (timer == NULL) {
+        return;
+    }
+
+    // A call that linked before the handle was cleared may still be starting it
+    for (;;) {
+        taskENTER_CRITICAL(&RPC.lock);
+        bool starting = RPC.starting > 0;
+        taskEXIT_CRITICAL(&RPC.lock);
+        if (!starting) {
+            break;
+        }
+        vTaskDelay(1);
+    }
+    esp_timer_stop(timer);
+    esp_timer_delete(timer);
+
+    // Wake every caller so blocking calls do not outlive the network
+    for (int i = 0; i < aborted_count; i++) {
+        FPR_APP_CALLBACK(aborted[i].cb(aborted[i].peer_mac, aborted[i].call_id, ESP_ERR_INVALID_STATE, NULL, 0, aborted[i].user_data));
+    }
+}
+
+// ========== PUBLIC API ==========
+
+esp_err_t fpr_rpc_register(fpr_rpc_method_t method, fpr_rpc_handler_t handler, void *user_data)
+{
+    ESP_RETURN_ON_FALSE(handler != NULL, ESP_ERR_INVALID_ARG, TAG, "Handler is NULL");
+    ESP_RETURN_ON_FALSE(_rpc_ready(), ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    esp_err_t result = ESP_ERR_NO_MEM;
+    taskENTER_CRITICAL(&RPC.lock);
+    fpr_rpc_handler_entry_t *slot = NULL;
+    for (int i = 0; i < FPR_RPC_MAX_HANDLERS; i++) {
+        if (RPC.handlers[i].in_use && RPC.handlers[i].method == method) {
+            slot = &RPC.handlers[i];
+            break;
+        }
+        if (!RPC.handlers[i].in_use && slot == NULL) {
+            slot = &RPC.handlers[i];
+        }
+    }
+    if (slot != NULL) {
+        slot->method = method;
+        slot->handler = handler;
+        slot->user_data = user_data;
+        slot->in_use = true;
+        result = ESP_OK;
+    }
+    taskEXIT_CRITICAL(&RPC.lock);
+
+    ESP_RETURN_ON_FALSE(result == ESP_OK, result, TAG, "Handler table full");
+    return ESP_OK;
+}
+
+esp_err_t fpr_rpc_unregister(fpr_rpc_method_t method)
+{
+    ESP_RETURN_ON_FALSE(_rpc_ready(), ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    esp_err_t result = ESP_ERR_NOT_FOUND;
+    taskENTER_CRITICAL(&RPC.lock);
+    for (int i = 0; i < FPR_RPC_MAX_HANDLERS; i++) {
+        if (RPC.handlers[i].in_use && RPC.handlers[i].method == method) {
+            RPC.handlers[i].in_use = false;
+            result = ESP_OK;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&RPC.lock);
+    return result;
+}
+
+esp_err_t fpr_rpc_call_async(const uint8_t *peer_mac, fpr_rpc_method_t method,
+                             const void *req, size_t req_len, uint32_t timeout_ms,
+                             fpr_rpc_response_cb_t cb, void *user_data, uint32_t *call_id_out)
+{
+    ESP_RETURN_ON_FALSE(peer_mac != NULL, ESP_ERR_INVALID_ARG, TAG, "Peer MAC is NULL");
+    ESP_RETURN_ON_FALSE(cb != NULL, ESP_ERR_INVALID_ARG, TAG, "Callback is NULL");
+    ESP_RETURN_ON_FALSE(req != NULL || req_len == 0, ESP_ERR_INVALID_ARG, TAG, "Request is NULL");
+    ESP_RETURN_ON_FALSE(req_len <= FPR_RPC_MAX_PAYLOAD, ESP_ERR_INVALID_SIZE, TAG, "Request too large");
+    ESP_RETURN_ON_FALSE(timeout_ms > 0, ESP_ERR_INVALID_ARG, TAG, "Timeout must be non-zero");
+
+    fpr_rpc_frame_t frame = {
+        .kind = FPR_RPC_KIND_REQUEST,
+        .method = method,
+        .payload_len = (uint16_t)req_len,
+    };
+    if (req_len > 0) {
+        memcpy(frame.payload, req, req_len);
+    }
+
+    // Link the call before sending so a fast response always finds it.
+    // Readiness is checked under the lock so a racing deinit either sees
+    // the call and aborts it, or the call sees no wheel and fails.
+    fpr_rpc_pending_t *call = NULL;
+    bool start_wheel = false;
+    taskENTER_CRITICAL(&RPC.lock);
+    esp_timer_handle_t timer = RPC.wheel_timer;
+    for (int i = 0; timer != NULL && i < FPR_RPC_MAX_PENDING; i++) {
+        if (!RPC.pending[i].in_use) {
+            call = &RPC.pending[i];
+            break;
+        }
+    }
+    if (call != NULL) {
+        call->in_use = true;
+        call->call_id = RPC.next_call_id++;
+        if (RPC.next_call_id == 0) {
+            RPC.next_call_id = 1;
+        }
+        call->start_us = esp_timer_get_time();
+        memcpy(call->peer_mac, peer_mac, MAC_ADDRESS_LENGTH);
+        call->cb = cb;
+        call->user_data = user_data;
+        _wheel_link(call, timeout_ms);
+        frame.call_id = call->call_id;
+        start_wheel = (RPC.stats.pending++ == 0);
+        if (start_wheel) {
+            RPC.starting++;
+        }
+    }
+    taskEXIT_CRITICAL(&RPC.lock);
+
+    ESP_RETURN_ON_FALSE(timer != NULL, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    ESP_RETURN_ON_FALSE(call != NULL, ESP_ERR_NO_MEM, TAG, "Too many outstanding calls");
+
+    if (start_wheel) {
+        // ESP_ERR_INVALID_STATE just means the wheel is still running
+        esp_timer_start_periodic(timer, FPR_RPC_WHEEL_TICK_MS * 1000);
+        taskENTER_CRITICAL(&RPC.lock);
+        RPC.starting--;
+        taskEXIT_CRITICAL(&RPC.lock);
+    }
+
+    uint32_t call_id = frame.call_id;
+    esp_err_t err = _send_frame(peer_mac, &frame);
+    if (err != ESP_OK) {
+        taskENTER_CRITICAL(&RPC.lock);
+        call = _find_call(call_id);
+        if (call) {
+            _release_call(call, NULL);
+        }
+        taskEXIT_CRITICAL(&RPC.lock);
+        // Gone already: the wheel expired it during the send and cb has reported it
+        if (call) {
+            return err;
+        }
+        if (call_id_out) {
+            *call_id_out = call_id;
+        }
+        return ESP_OK;
+    }
+
+    taskENTER_CRITICAL(&RPC.lock);
+    RPC.stats.calls_sent++;
+    taskEXIT_CRITICAL(&RPC.lock);
+
+    if (call_id_out) {
+        *call_id_out = call_id;
+    }
+    return ESP_OK;
+}
+
+typedef struct {
+    SemaphoreHandle_t done;
+    esp_err_t status;
+    void *resp;
+    size_t *resp_len;
+} fpr_rpc_sync_ctx_t;
+
+static void _sync_call_complete(const uint8_t *peer_mac, uint32_t call_id, esp_err_t status,
+                                const void *resp, size_t resp_len, void *user_data)
+{
+    (void)peer_mac;
+    (void)call_id;
+    fpr_rpc_sync_ctx_t *ctx = (fpr_rpc_sync_ctx_t *)user_data;
+    ctx->status = status;
+    if (ctx->resp_len) {
+        size_t copy_len = 0;
+        if (status == ESP_OK && ctx->resp) {
+            copy_len = resp_len < *ctx->resp_len ? resp_len : *ctx->resp_len;
+            memcpy(ctx->resp, resp, copy_len);
+        }
+        *ctx->resp_len = copy_len;
+    }
+    xSemaphoreGive(ctx->done);
+}
+
+esp_err_t fpr_rpc_call(const uint8_t *peer_mac, fpr_rpc_method_t method,
+                       const void *req, size_t req_len,
+                       void *resp, size_t *resp_len, uint32_t timeout_ms)
+{
+    ESP_RETURN_ON_FALSE(resp == NULL || resp_len != NULL, ESP_ERR_INVALID_ARG, TAG, "Response length is NULL");
+    ESP_RETURN_ON_FALSE(!xPortInIsrContext(), ESP_ERR_INVALID_STATE, TAG, "Blocking call from an ISR");
+    // The result is delivered on these tasks, so waiting on them never ends
+    ESP_RETURN_ON_FALSE(!_fpr_is_receive_task(), ESP_ERR_INVALID_STATE, TAG, "Blocking call from the receive path");
+    ESP_RETURN_ON_FALSE(RPC.timer_task == NULL || xTaskGetCurrentTaskHandle() != RPC.timer_task,
+                        ESP_ERR_INVALID_STATE, TAG, "Blocking call from an esp_timer callback");
+
+    fpr_rpc_sync_ctx_t ctx = {
+        .done = xSemaphoreCreateBinary(),
+        .status = ESP_FAIL,
+        .resp = resp,
+        .resp_len = resp_len,
+    };
+    ESP_RETURN_ON_FALSE(ctx.done != NULL, ESP_ERR_NO_MEM, TAG, "Failed to create semaphore");
+
+    uint32_t call_id = 0;
+    esp_err_t err = fpr_rpc_call_async(peer_mac, method, req, req_len, timeout_ms, _sync_call_complete, &ctx, &call_id);
+    if (err == ESP_OK) {
+        // The wheel expires the call within two ticks of its deadline. Waiting
+        // longer means the wheel cannot run on this task, so give up on the call.
+        TickType_t wait = pdMS_TO_TICKS(timeout_ms + 2 * FPR_RPC_WHEEL_TICK_MS) + 1;
+        if (xSemaphoreTake(ctx.done, wait) == pdTRUE) {
+            err = ctx.status;
+        } else if (fpr_rpc_cancel(call_id) == ESP_OK) {
+            err = ESP_ERR_TIMEOUT;
+        } else {
+            // Completing on another task right now; its callback still uses ctx
+            xSemaphoreTake(ctx.done, portMAX_DELAY);
+            err = ctx.status;
+        }
+    }
+    vSemaphoreDelete(ctx.done);
+    return err;
+}
+
+esp_err_t fpr_rpc_cancel(uint32_t call_id)
+{
+    ESP_RETURN_ON_FALSE(_rpc_ready(), ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    esp_err_t result = ESP_ERR_NOT_FOUND;
+    taskENTER_CRITICAL(&RPC.lock);
+    fpr_rpc_pending_t *call = _find_call(call_id);
+    if (call) {
+        _release_call(call, NULL);
+        result = ESP_OK;
+    }
+    taskEXIT_CRITICAL(&RPC.lock);
+    return result;
+}
+
+void fpr_rpc_get_stats(fpr_rpc_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    if (!_rpc_ready()) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    taskENTER_CRITICAL(&RPC.lock);
+    *stats = RPC.stats;
+    taskEXIT_CRITICAL(&RPC.lock);
+}
+
+void fpr_rpc_reset_stats(void)
+{
+    if (!_rpc_ready()) {
+        return;
+    }
+    taskENTER_CRITICAL(&RPC.lock);
+    uint32_t pending = RPC.stats.pending;
+    memset(&RPC.stats, 0, sizeof(RPC.stats));
+    RPC.stats.pending = pending;
+    taskEXIT_CRITICAL(&RPC.lock);
+}
@@ -13,6 +13,7 @@
 #include "esp_random.h"
 #include "esp_check.h"
 #include "esp_log.h"
+#include "mbedtls/md.h"
 #include <string.h>
 
 static const char *TAG = "fpr_security";
@@ -111,3 +112,25 @@ void fpr_security_clear_keys(fpr_security_keys_t *keys)
         ESP_LOGD(TAG, "Security keys cleared");
     }
 }
+
+esp_err_t fpr_security_wrap_key(const uint8_t *session_key, const uint8_t *nonce, size_t nonce_len,
+                                const uint8_t *key_in, uint8_t *key_out, uint8_t *check_out)
+{
+    ESP_RETURN_ON_FALSE(session_key != NULL && nonce != NULL && key_in != NULL && key_out != NULL,
+                        ESP_ERR_INVALID_ARG, TAG, "Wrap argument is NULL");
+
+    // First FPR_KEY_SIZE bytes of the MAC are the keystream, the next ones the check value
+    uint8_t stream[32];
+    int ret = mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), session_key, FPR_KEY_SIZE,
+                              nonce, nonce_len, stream);
+    ESP_RETURN_ON_FALSE(ret == 0, ESP_FAIL, TAG, "HMAC failed: %d", ret);
+
+    for (int i = 0; i < FPR_KEY_SIZE; i++) {
+        key_out[i] = key_in[i] ^ stream[i];
+    }
+    if (check_out != NULL) {
+        memcpy(check_out, &stream[FPR_KEY_SIZE], FPR_KEY_CHECK_SIZE);
+    }
+    memset(stream, 0, sizeof(stream));
+    return ESP_OK;
+}
@@ -11,6 +11,8 @@
 
 #include "fpr/fpr_security_handshake.h"
 #include "fpr/fpr_security.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
 #include "esp_log.h"
 #include "esp_check.h"
 #include <string.h>
@@ -20,6 +22,15 @@ static const char *TAG = "fpr_sec_handshake";
 extern fpr_connect_t make_fpr_info_with_keys(bool include_pwk, bool include_lwk, const uint8_t *pwk, const uint8_t *lwk);
 extern esp_err_t fpr_network_send_to_peer(uint8_t *peer_address, void *data, int size, fpr_package_id_t package_id);
 
+// Record a handshake step in the trace and the event stream
+static void _step(const uint8_t *peer_mac, uint8_t step, bool failed)
+{
+    FPR_TRACE(FPR_TRACE_HANDSHAKE, step | (failed ? FPR_TRACE_HANDSHAKE_FAILED : 0), peer_mac, NULL);
+    fpr_event_t event = { .type = FPR_EVENT_HANDSHAKE, .handshake = { .step = step, .failed = failed } };
+    memcpy(event.peer_mac, peer_mac, sizeof(event.peer_mac));
+    _fpr_event_emit(&event);
+}
+
 esp_err_t fpr_sec_host_send_pwk(const uint8_t *peer_mac, FPR_STORE_HASH_TYPE *peer, const uint8_t *host_pwk)
 {
     ESP_RETURN_ON_FALSE(peer_mac != NULL && peer != NULL && host_pwk != NULL, 
@@ -28,6 +39,7 @@ esp_err_t fpr_sec_host_send_pwk(const uint8_t *peer_mac, FPR_STORE_HASH_TYPE *pe
     ESP_LOGI(TAG, "Sending PWK to client: %s", peer->name);
     fpr_connect_t response = make_fpr_info_with_keys(true, false, host_pwk, NULL);
     esp_err_t err = fpr_network_send_to_peer((uint8_t *)peer_mac, &response, sizeof(response), FPR_PACKET_ID_CONTROL);
+    _step(peer_mac, 1, err != ESP_OK);
     
     if (err == ESP_OK) {
         peer->sec_state = FPR_SEC_STATE_PWK_SENT;
@@ -45,6 +57,7 @@ esp_err_t fpr_sec_host_verify_and_ack(const uint8_t *peer_mac, FPR_STORE_HASH_TY
     
     // Verify PWK from client
     if (!fpr_security_verify_pwk(info->pwk, host_pwk)) {
+        _step(peer_mac, 3, true);
         ESP_LOGW(TAG, "PWK verification failed from client");
         return ESP_ERR_INVALID_ARG;
     }
@@ -57,13 +70,13 @@ esp_err_t fpr_sec_host_verify_and_ack(const uint8_t *peer_mac, FPR_STORE_HASH_TY
     // Send acknowledgment with PWK + LWK back to client
     fpr_connect_t response = make_fpr_info_with_keys(true, true, host_pwk, peer->security.lwk);
     esp_err_t err = fpr_network_send_to_peer((uint8_t *)peer_mac, &response, sizeof(response), FPR_PACKET_ID_CONTROL);
+    _step(peer_mac, 3, err != ESP_OK);
     
     if (err == ESP_OK) {
         peer->sec_state = FPR_SEC_STATE_LWK_SENT;
         // Mark as connected on host side
-        peer->is_connected = true;
-        peer->state = FPR_PEER_STATE_CONNECTED;
         peer->sec_state = FPR_SEC_STATE_ESTABLISHED;
+        _peer_set_state(peer, FPR_PEER_STATE_CONNECTED, FPR_EVENT_REASON_NONE);
         
         // Reset sequence tracking for new session (handles peer restarts)
         peer->last_seq_num = 0;
@@ -77,6 +90,7 @@ esp_err_t fpr_sec_host_verify_and_ack(const uint8_t *peer_mac, FPR_STORE_HASH_TY
         }
         
         ESP_LOGI(TAG, "Host: Peer connected with mutual keys: %s", peer->name);
+        _fpr_services_on_peer_connected(peer);
     }
     
     return err;
@@ -94,6 +108,7 @@ esp_err_t fpr_sec_client_handle_pwk(const uint8_t *peer_mac, FPR_STORE_HASH_TYPE
     
     // Generate client's own LWK (client contributes randomness)
     if (fpr_security_generate_lwk(peer->security.lwk) != ESP_OK) {
+        _step(peer_mac, 2, true);
         ESP_LOGE(TAG, "Failed to generate client LWK");
         return ESP_FAIL;
     }
@@ -103,6 +118,7 @@ esp_err_t fpr_sec_client_handle_pwk(const uint8_t *peer_mac, FPR_STORE_HASH_TYPE
     // Send device info back with PWK + client's LWK
     fpr_connect_t response = make_fpr_info_with_keys(true, true, peer->security.pwk, peer->security.lwk);
     esp_err_t err = fpr_network_send_to_peer((uint8_t *)peer_mac, &response, sizeof(response), FPR_PACKET_ID_CONTROL);
+    _step(peer_mac, 2, err != ESP_OK);
     
     if (err == ESP_OK) {
         peer->sec_state = FPR_SEC_STATE_LWK_SENT;
@@ -119,22 +135,24 @@ esp_err_t fpr_sec_client_verify_ack(const uint8_t *peer_mac, FPR_STORE_HASH_TYPE
     
     // Verify PWK in acknowledgment
     if (!fpr_security_verify_pwk(info->pwk, peer->security.pwk)) {
+        _step(peer_mac, 4, true);
         ESP_LOGW(TAG, "PWK verification failed in host ack");
         return ESP_ERR_INVALID_ARG;
     }
     
     // Verify host echoed back our LWK correctly
     if (!fpr_security_verify_lwk(info->lwk, peer->security.lwk)) {
+        _step(peer_mac, 4, true);
         ESP_LOGW(TAG, "LWK verification failed in host ack");
         return ESP_ERR_INVALID_ARG;
     }
     
     ESP_LOGI(TAG, "Received acknowledgment from host: %s", peer->name);
+    _step(peer_mac, 4, false);
     
     // Mark as connected
-    peer->is_connected = true;
-    peer->state = FPR_PEER_STATE_CONNECTED;
     peer->sec_state = FPR_SEC_STATE_ESTABLISHED;
+    _peer_set_state(peer, FPR_PEER_STATE_CONNECTED, FPR_EVENT_REASON_NONE);
     
     // Reset sequence tracking for new session (handles host restarts)
     peer->last_seq_num = 0;
@@ -149,6 +167,7 @@ esp_err_t fpr_sec_client_verify_ack(const uint8_t *peer_mac, FPR_STORE_HASH_TYPE
     }
     
     ESP_LOGI(TAG, "Client: Connection established with %s (mutual keys)", peer->name);
+    _fpr_services_on_peer_connected(peer);
     
     return ESP_OK;
 }
@@ -0,0 +1,533 @@
+/**
+ * @file fpr_sleepy.c
+ * @brief FPR Sleepy Clients implementation
+ *
+ * Host: keeps a bounded downlink queue per registered sleepy client, sets
+ * the client's bit in each beacon while its queue is non-empty, and drains
+ * the queue when the client polls. Client: keeps the radio in connectionless
+ * power save between beacons and only stays awake for a beacon that flags
+ * pending data.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_sleepy.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "esp_check.h"
+#include "esp_log.h"
+
+static const char *TAG = "fpr_sleepy";
+
+#define SLEEPY fpr_net.sleepy
+
+#define FPR_SLEEPY_MIN_INTERVAL_MS 20
+#define FPR_SLEEPY_WINDOW_AWAKE    65535   // Radio stays on for the whole wake interval
+
+// Package IDs that bypass the downlink buffer. Time sync and the service
+// control frames only flow while the client is awake anyway.
+static bool _is_unbuffered_id(fpr_package_id_t package_id)
+{
+    return package_id == FPR_PACKET_ID_CONTROL || package_id == FPR_PACKET_ID_TIMESYNC ||
+           package_id == FPR_PACKET_ID_BEACON || package_id == FPR_PACKET_ID_TDMA ||
+           package_id == FPR_PACKET_ID_SLEEPY;
+}
+
+static void _send_frame(const uint8_t *mac, fpr_sleepy_frame_t *frame)
+{
+    uint8_t dest[MAC_ADDRESS_LENGTH];
+    memcpy(dest, mac, MAC_ADDRESS_LENGTH);
+    fpr_network_send_to_peer(dest, frame, sizeof(*frame), FPR_PACKET_ID_SLEEPY);
+}
+
+// ========== HOST ==========
+
+// Frames that bypassed the buffer meanwhile carry newer sequence numbers
+static void _host_send_raw(fpr_package_t *package, uint32_t *message_seq)
+{
+    _fpr_restamp_sequence(package, message_seq);
+    esp_err_t err = _fpr_radio_send(package->dest_mac, package);
+    if (err == ESP_OK) {
+        _fpr_stat_add(FPR_STAT_PACKETS_SENT, 1);
+    } else {
+        _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
+    }
+}
+
+static void _host_drain(uint8_t slot)
+{
+    QueueHandle_t queue = SLEEPY.downlink[slot];
+    if (queue == NULL) {
+        return;
+    }
+    fpr_package_t package;
+    uint32_t message_seq = 0;
+    while (xQueueReceive(queue, &package, 0) == pdPASS) {
+        _host_send_raw(&package, &message_seq);
+    }
+}
+
+// Drop the client's sleepy registration. With flush, buffered data is sent first.
+static void _host_release_slot(uint8_t slot, bool flush)
+{
+    if (slot >= FPR_MAX_PEER_SLOTS) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&SLEEPY.lock);
+    bool was_sleepy = (SLEEPY.sleepy_peers & FPR_PEER_BIT(slot)) != 0;
+    SLEEPY.sleepy_peers &= ~FPR_PEER_BIT(slot);
+    if (was_sleepy && SLEEPY.stats.sleepy_peers > 0) {
+        SLEEPY.stats.sleepy_peers--;
+    }
+    QueueHandle_t queue = SLEEPY.downlink[slot];
+    SLEEPY.downlink[slot] = NULL;
+    taskEXIT_CRITICAL(&SLEEPY.lock);
+
+    if (queue == NULL) {
+        return;
+    }
+    if (flush) {
+        fpr_package_t package;
+        uint32_t message_seq = 0;
+        while (xQueueReceive(queue, &package, 0) == pdPASS) {
+            _host_send_raw(&package, &message_seq);
+        }
+    }
+    vQueueDelete(queue);
+}
+
+static void _host_handle_register(FPR_STORE_HASH_TYPE *peer, const fpr_sleepy_frame_t *frame)
+{
+    uint8_t slot = peer->slot;
+    if (!SLEEPY.host_enabled || slot >= FPR_MAX_PEER_SLOTS) {
+        return;
+    }
+    if (frame->listen_interval == 0) {
+        // Client stopped duty-cycling and is listening again
+        _host_release_slot(slot, true);
+        return;
+    }
+
+    if (SLEEPY.downlink[slot] == NULL) {
+        QueueHandle_t queue = xQueueCreate(FPR_SLEEPY_BUFFER_DEPTH, sizeof(fpr_package_t));
+        if (queue == NULL) {
+            ESP_LOGE(TAG, "Failed to create downlink buffer for %s", peer->name);
+            return;
+        }
+        SLEEPY.downlink[slot] = queue;
+    }
+
+    taskENTER_CRITICAL(&SLEEPY.lock);
+    if ((SLEEPY.sleepy_peers & FPR_PEER_BIT(slot)) == 0) {
+        SLEEPY.sleepy_peers |= FPR_PEER_BIT(slot);
+        SLEEPY.stats.sleepy_peers++;
+    }
+    taskEXIT_CRITICAL(&SLEEPY.lock);
+
+    ESP_LOGI(TAG, "%s is sleepy (listen interval %u)", peer->name, frame->listen_interval);
+
+    fpr_sleepy_frame_t ack = {
+        .kind = FPR_SLEEPY_KIND_REGISTER_ACK,
+        .slot = slot,
+    };
+    _send_frame(peer->peer_info.peer_addr, &ack);
+}
+
+static void _host_handle_poll(FPR_STORE_HASH_TYPE *peer)
+{
+    uint8_t slot = peer->slot;
+    if (slot >= FPR_MAX_PEER_SLOTS) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&SLEEPY.lock);
+    SLEEPY.stats.polls++;
+    taskEXIT_CRITICAL(&SLEEPY.lock);
+
+    _host_drain(slot);
+
+    fpr_sleepy_frame_t end = {
+        .kind = FPR_SLEEPY_KIND_END,
+        .slot = slot,
+    };
+    _send_frame(peer->peer_info.peer_addr, &end);
+}
+
+uint32_t _fpr_sleepy_beacon_period_us(void)
+{
+    if (!SLEEPY.ready || !SLEEPY.host_enabled) {
+        return 0;
+    }
+    return (uint32_t)SLEEPY.beacon_interval_ms * 1000;
+}
+
+void _fpr_sleepy_fill_beacon(fpr_beacon_frame_t *beacon)
+{
+    if (!SLEEPY.ready || !SLEEPY.host_enabled) {
+        return;
+    }
+
+    fpr_peer_bitmap_t pending = 0;
+    taskENTER_CRITICAL(&SLEEPY.lock);
+    fpr_peer_bitmap_t sleepy = SLEEPY.sleepy_peers;
+    taskEXIT_CRITICAL(&SLEEPY.lock);
+
+    for (uint8_t slot = 0; sleepy != 0; slot++, sleepy >>= 1) {
+        if ((sleepy & 1) && SLEEPY.downlink[slot] != NULL && uxQueueMessagesWaiting(SLEEPY.downlink[slot]) > 0) {
+            pending |= FPR_PEER_BIT(slot);
+        }
+    }
+
+    beacon->flags |= FPR_BEACON_FLAG_SLEEPY;
+    beacon->pending = pending;
+}
+
+bool _fpr_sleepy_should_defer(const uint8_t *peer_address, fpr_package_id_t package_id)
+{
+    if (!SLEEPY.ready || !SLEEPY.host_enabled || peer_address == NULL || _is_unbuffered_id(package_id)) {
+        return false;
+    }
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_address);
+    if (peer == NULL || peer->slot >= FPR_MAX_PEER_SLOTS) {
+        return false;
+    }
+    taskENTER_CRITICAL(&SLEEPY.lock);
+    bool defer = (SLEEPY.sleepy_peers & FPR_PEER_BIT(peer->slot)) != 0;
+    taskEXIT_CRITICAL(&SLEEPY.lock);
+    return defer;
+}
+
+esp_err_t _fpr_sleepy_enqueue(const fpr_package_t *package)
+{
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(package->dest_mac);
+    ESP_RETURN_ON_FALSE(peer != NULL && peer->slot < FPR_MAX_PEER_SLOTS, ESP_ERR_NOT_FOUND, TAG, "Sleepy peer not found");
+    QueueHandle_t queue = SLEEPY.downlink[peer->slot];
+    ESP_RETURN_ON_FALSE(queue != NULL, ESP_ERR_NO_MEM, TAG, "No downlink buffer for %s", peer->name);
+
+    // Newest data wins: a sleeper cares about the latest state, not a backlog
+    bool dropped = false;
+    if (xQueueSend(queue, package, 0) != pdPASS) {
+        fpr_package_t oldest;
+        dropped = (xQueueReceive(queue, &oldest, 0) == pdPASS);
+        xQueueSend(queue, package, 0);
+    }
+
+    taskENTER_CRITICAL(&SLEEPY.lock);
+    SLEEPY.stats.buffered++;
+    if (dropped) {
+        SLEEPY.stats.buffer_dropped++;
+    }
+    taskEXIT_CRITICAL(&SLEEPY.lock);
+    return ESP_OK;
+}
+
+// ========== CLIENT ==========
+
+static void _client_set_radio(fpr_sleepy_radio_t radio)
+{
+    SLEEPY.radio = radio;
+    uint16_t window = (radio == FPR_SLEEPY_RADIO_ASLEEP) ? (uint16_t)(FPR_SLEEPY_WAKE_GUARD_MS * 2) : FPR_SLEEPY_WINDOW_AWAKE;
+    esp_err_t err = _fpr_transport_set_wake_window(window);
+    if (err != ESP_OK) {
+        #if (FPR_DEBUG == 1)
+        ESP_LOGW(TAG, "Failed to set wake window: %s", esp_err_to_name(err));
+        #endif
+    }
+}
+
+static void _client_register(void)
+{
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    if (fpr_client_get_host_info(host_mac, NULL, 0) != ESP_OK) {
+        return;
+    }
+    fpr_sleepy_frame_t req = {
+        .kind = FPR_SLEEPY_KIND_REGISTER,
+        .listen_interval = SLEEPY.listen_interval,
+    };
+    _send_frame(host_mac, &req);
+}
+
+// Radio off until just before the beacon we listen for
+static void _client_sleep(int64_t last_beacon_us)
+{
+    int64_t wake_at = last_beacon_us + (int64_t)SLEEPY.interval_ms * SLEEPY.listen_interval * 1000 -
+                      (int64_t)FPR_SLEEPY_WAKE_GUARD_MS * 1000;
+    int64_t delay = wake_at - esp_timer_get_time();
+
+    _client_set_radio(FPR_SLEEPY_RADIO_ASLEEP);
+    esp_timer_stop(SLEEPY.wake_timer);
+    esp_timer_start_once(SLEEPY.wake_timer, delay > 0 ? (uint64_t)delay : 0);
+}
+
+FPR_INSTANCE_TIMER_CB(_client_wake_cb)
+{
+    if (!SLEEPY.client_enabled) {
+        return;
+    }
+
+    if (SLEEPY.radio == FPR_SLEEPY_RADIO_FETCHING) {
+        // Host never finished draining; try again on the next flagged beacon
+        SLEEPY.stats.missed_fetches++;
+        _client_sleep(SLEEPY.last_beacon_us);
+        return;
+    }
+
+    // Stay awake until a beacon arrives. A missed beacon costs radio time,
+    // never the schedule.
+    SLEEPY.stats.wakeups++;
+    _client_set_radio(FPR_SLEEPY_RADIO_AWAKE);
+}
+
+void _fpr_sleepy_on_beacon(FPR_STORE_HASH_TYPE *peer, const fpr_beacon_frame_t *beacon, int64_t rx_time_us)
+{
+    if (!SLEEPY.ready || !SLEEPY.client_enabled || fpr_net.current_mode != FPR_MODE_CLIENT || SLEEPY.wake_timer == NULL) {
+        return;
+    }
+    if (!(beacon->flags & FPR_BEACON_FLAG_SLEEPY) || beacon->interval_ms == 0 || SLEEPY.host_slot >= FPR_MAX_PEER_SLOTS) {
+        // Host is not buffering for us (yet); sleeping would lose data
+        if (SLEEPY.radio != FPR_SLEEPY_RADIO_AWAKE) {
+            _client_set_radio(FPR_SLEEPY_RADIO_AWAKE);
+        }
+        return;
+    }
+    if (SLEEPY.radio == FPR_SLEEPY_RADIO_FETCHING) {
+        return;
+    }
+
+    if (SLEEPY.interval_ms != beacon->interval_ms) {
+        SLEEPY.interval_ms = beacon->interval_ms;
+        // The transport takes 16 bits; waking early only costs radio time, the wake timer keeps the schedule
+        uint32_t wake_interval = (uint32_t)beacon->interval_ms * SLEEPY.listen_interval;
+        if (wake_interval > UINT16_MAX) {
+            ESP_LOGW(TAG, "Wake interval %lu ms clamped to %u ms", (unsigned long)wake_interval, UINT16_MAX);
+            wake_interval = UINT16_MAX;
+        }
+        _fpr_transport_set_wake_interval((uint16_t)wake_interval);
+    }
+    SLEEPY.last_beacon_us = rx_time_us;
+    memcpy(SLEEPY.host_mac, peer->peer_info.peer_addr, MAC_ADDRESS_LENGTH);
+
+    if ((beacon->pending & FPR_PEER_BIT(SLEEPY.host_slot)) == 0) {
+        _client_sleep(rx_time_us);
+        return;
+    }
+
+    // Data waiting: stay up until END, or give up after one beacon interval
+    _client_set_radio(FPR_SLEEPY_RADIO_FETCHING);
+    SLEEPY.stats.polls++;
+    fpr_sleepy_frame_t poll = {
+        .kind = FPR_SLEEPY_KIND_POLL,
+    };
+    _send_frame(SLEEPY.host_mac, &poll);
+    esp_timer_stop(SLEEPY.wake_timer);
+    esp_timer_start_once(SLEEPY.wake_timer, (uint64_t)SLEEPY.interval_ms * 1000);
+}
+
+static void _client_handle_frame(const fpr_sleepy_frame_t *frame)
+{
+    switch (frame->kind) {
+        case FPR_SLEEPY_KIND_REGISTER_ACK:
+            SLEEPY.host_slot = frame->slot;
+            SLEEPY.stats.client_registered = true;
+            ESP_LOGI(TAG, "Registered as sleepy client (slot %u)", frame->slot);
+            break;
+        case FPR_SLEEPY_KIND_END:
+            if (SLEEPY.radio == FPR_SLEEPY_RADIO_FETCHING) {
+                _client_sleep(SLEEPY.last_beacon_us);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// ========== SERVICE HOOKS ==========
+
+void _fpr_sleepy_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package)
+{
+    if (!SLEEPY.ready || package->payload_size < sizeof(fpr_sleepy_frame_t)) {
+        return;
+    }
+
+    const fpr_sleepy_frame_t *frame = (const fpr_sleepy_frame_t *)&package->protocol;
+    if (fpr_net.current_mode == FPR_MODE_HOST) {
+        switch (frame->kind) {
+            case FPR_SLEEPY_KIND_REGISTER:
+                _host_handle_register(peer, frame);
+                break;
+            case FPR_SLEEPY_KIND_POLL:
+                _host_handle_poll(peer);
+                break;
+            default:
+                ESP_LOGW(TAG, "Unknown sleepy frame kind %d", frame->kind);
+                break;
+        }
+    } else if (fpr_net.current_mode == FPR_MODE_CLIENT && SLEEPY.client_enabled) {
+        _client_handle_frame(frame);
+    }
+}
+
+void _fpr_sleepy_on_peer_connected(FPR_STORE_HASH_TYPE *peer)
+{
+    if (!SLEEPY.ready) {
+        return;
+    }
+    if (fpr_net.current_mode == FPR_MODE_HOST) {
+        // New session: the client registers again if it still sleeps
+        _host_release_slot(peer->slot, false);
+    } else if (SLEEPY.client_enabled) {
+        SLEEPY.host_slot = FPR_PEER_SLOT_NONE;
+        SLEEPY.stats.client_registered = false;
+        _client_set_radio(FPR_SLEEPY_RADIO_AWAKE);
+        _client_register();
+    }
+}
+
+void _fpr_sleepy_on_peer_disconnected(FPR_STORE_HASH_TYPE *peer)
+{
+    if (!SLEEPY.ready) {
+        return;
+    }
+    if (fpr_net.current_mode == FPR_MODE_HOST) {
+        _host_release_slot(peer->slot, false);
+    } else if (SLEEPY.client_enabled && memcmp(peer->peer_info.peer_addr, SLEEPY.host_mac, MAC_ADDRESS_LENGTH) == 0) {
+        // Lost the host: stay awake so reconnection is not slowed down
+        esp_timer_stop(SLEEPY.wake_timer);
+        SLEEPY.host_slot = FPR_PEER_SLOT_NONE;
+        SLEEPY.stats.client_registered = false;
+        _client_set_radio(FPR_SLEEPY_RADIO_AWAKE);
+    }
+}
+
+void _fpr_sleepy_init(void)
+{
+    memset(&SLEEPY, 0, sizeof(SLEEPY));
+    portMUX_INITIALIZE(&SLEEPY.lock);
+    SLEEPY.host_slot = FPR_PEER_SLOT_NONE;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = _client_wake_cb,
+        .arg = &fpr_net,
+        .name = "fpr_sleepy"
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &SLEEPY.wake_timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create wake timer: %s", esp_err_to_name(err));
+        SLEEPY.wake_timer = NULL;
+    }
+    SLEEPY.ready = true;
+}
+
+void _fpr_sleepy_deinit(void)
+{
+    SLEEPY.ready = false;
+    SLEEPY.host_enabled = false;
+    SLEEPY.client_enabled = false;
+    if (SLEEPY.wake_timer != NULL) {
+        esp_timer_stop(SLEEPY.wake_timer);
+        esp_timer_delete(SLEEPY.wake_timer);
+        SLEEPY.wake_timer = NULL;
+    }
+    for (int i = 0; i < FPR_MAX_PEER_SLOTS; i++) {
+        if (SLEEPY.downlink[i] != NULL) {
+            vQueueDelete(SLEEPY.downlink[i]);
+            SLEEPY.downlink[i] = NULL;
+        }
+    }
+    SLEEPY.sleepy_peers = 0;
+}
+
+// ========== PUBLIC API ==========
+
+esp_err_t fpr_sleepy_host_enable(uint16_t beacon_interval_ms)
+{
+    ESP_RETURN_ON_FALSE(SLEEPY.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    ESP_RETURN_ON_FALSE(fpr_net.current_mode == FPR_MODE_HOST, ESP_ERR_INVALID_STATE, TAG, "Sleepy buffering requires host mode");
+    ESP_RETURN_ON_FALSE(beacon_interval_ms >= FPR_SLEEPY_MIN_INTERVAL_MS, ESP_ERR_INVALID_ARG, TAG, "Beacon interval must be at least %d ms", FPR_SLEEPY_MIN_INTERVAL_MS);
+
+    taskENTER_CRITICAL(&SLEEPY.lock);
+    SLEEPY.beacon_interval_ms = beacon_interval_ms;
+    SLEEPY.host_enabled = true;
+    SLEEPY.stats.host_enabled = true;
+    taskEXIT_CRITICAL(&SLEEPY.lock);
+
+    _fpr_beacon_refresh();
+    ESP_LOGI(TAG, "Sleepy clients enabled: beacon every %u ms", beacon_interval_ms);
+    return ESP_OK;
+}
+
+esp_err_t fpr_sleepy_host_disable(void)
+{
+    ESP_RETURN_ON_FALSE(SLEEPY.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    taskENTER_CRITICAL(&SLEEPY.lock);
+    SLEEPY.host_enabled = false;
+    SLEEPY.stats.host_enabled = false;
+    taskEXIT_CRITICAL(&SLEEPY.lock);
+
+    for (uint8_t slot = 0; slot < FPR_MAX_PEER_SLOTS; slot++) {
+        _host_release_slot(slot, true);
+    }
+
+    _fpr_beacon_refresh();
+    return ESP_OK;
+}
+
+esp_err_t fpr_sleepy_client_enable(uint8_t listen_interval)
+{
+    ESP_RETURN_ON_FALSE(SLEEPY.ready && SLEEPY.wake_timer != NULL, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    ESP_RETURN_ON_FALSE(fpr_net.current_mode == FPR_MODE_CLIENT, ESP_ERR_INVALID_STATE, TAG, "Duty-cycling requires client mode");
+    ESP_RETURN_ON_FALSE(listen_interval >= 1, ESP_ERR_INVALID_ARG, TAG, "Listen interval must be at least 1");
+
+    SLEEPY.listen_interval = listen_interval;
+    SLEEPY.host_slot = FPR_PEER_SLOT_NONE;
+    SLEEPY.interval_ms = 0;
+    SLEEPY.client_enabled = true;
+    SLEEPY.stats.client_enabled = true;
+    SLEEPY.stats.client_registered = false;
+    _client_set_radio(FPR_SLEEPY_RADIO_AWAKE);
+
+    if (fpr_client_is_connected()) {
+        _client_register();
+    }
+    return ESP_OK;
+}
+
+esp_err_t fpr_sleepy_client_disable(void)
+{
+    ESP_RETURN_ON_FALSE(SLEEPY.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    bool registered = SLEEPY.client_enabled && SLEEPY.host_slot < FPR_MAX_PEER_SLOTS;
+    SLEEPY.client_enabled = false;
+    SLEEPY.stats.client_enabled = false;
+    SLEEPY.stats.client_registered = false;
+    if (SLEEPY.wake_timer != NULL) {
+        esp_timer_stop(SLEEPY.wake_timer);
+    }
+    _client_set_radio(FPR_SLEEPY_RADIO_AWAKE);
+
+    // Listen interval 0 asks the host to flush and stop buffering
+    if (registered) {
+        SLEEPY.listen_interval = 0;
+        _client_register();
+    }
+    return ESP_OK;
+}
+
+void fpr_sleepy_get_stats(fpr_sleepy_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    if (!SLEEPY.ready) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    taskENTER_CRITICAL(&SLEEPY.lock);
+    *stats = SLEEPY.stats;
+    taskEXIT_CRITICAL(&SLEEPY.lock);
+}
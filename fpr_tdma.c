@@ -0,0 +1,457 @@
+/**
+ * @file fpr_tdma.c
+ * @brief FPR Host-Coordinated TDMA Scheduling implementation
+ *
+ * Host: owns the slot table, reclaims idle slots when building each beacon
+ * and answers slot requests. Client: asks for a slot whenever the beacon
+ * does not show it as the owner, and drains its slot queue from a one-shot
+ * timer armed relative to each superframe start.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_tdma.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "esp_check.h"
+#include "esp_log.h"
+
+static const char *TAG = "fpr_tdma";
+
+#define TDMA fpr_net.tdma
+
+_Static_assert(FPR_TDMA_MAX_SLOTS <= FPR_MAX_PEER_SLOTS, "CONFIG_FPR_TDMA_MAX_SLOTS cannot exceed the peer slot limit");
+
+// Slot queues live outside fpr_net and are kept across fpr_network_deinit(),
+// so a sender racing with deinit never touches a deleted queue
+static QueueHandle_t s_tx_queues[FPR_MAX_INSTANCES];
+#define TX_QUEUE s_tx_queues[_fpr_instance_index()]
+
+static inline uint32_t _superframe_us(uint16_t slot_count, uint32_t slot_us)
+{
+    return (uint32_t)(slot_count + 1) * slot_us;
+}
+
+// ========== HOST ==========
+
+// Must be called with the lock held
+static void _host_reclaim_idle_slots(int64_t now)
+{
+    int64_t idle_limit_us = (int64_t)TDMA.config.idle_superframes * _superframe_us(TDMA.slot_count, TDMA.config.slot_us);
+    uint16_t highest = 0;
+
+    for (int i = 0; i < FPR_TDMA_MAX_SLOTS; i++) {
+        if (!TDMA.owned[i]) {
+            continue;
+        }
+        FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(TDMA.owners[i]);
+        if (peer == NULL || peer->state != FPR_PEER_STATE_CONNECTED || now - peer->last_seen > idle_limit_us) {
+            TDMA.owned[i] = false;
+            TDMA.stats.slots_reclaimed++;
+            continue;
+        }
+        highest = (uint16_t)(i + 1);
+    }
+    TDMA.slot_count = highest;
+}
+
+// Must be called with the lock held. Draws the next assignment tag for a
+// slot: never 0 (free), never the slot's previous tag, and never a tag
+// another owned slot carries, so a client still holding a reclaimed or
+// reassigned slot always sees a mismatch in the next beacon.
+static uint8_t _host_next_tag(int slot)
+{
+    for (;;) {
+        uint8_t tag = ++TDMA.next_tag;
+        if (tag == 0 || tag == TDMA.tags[slot]) {
+            continue;
+        }
+        bool in_use = false;
+        for (int i = 0; i < FPR_TDMA_MAX_SLOTS && !in_use; i++) {
+            in_use = TDMA.owned[i] && TDMA.tags[i] == tag;
+        }
+        if (!in_use) {
+            return tag;
+        }
+    }
+}
+
+// Must be called with the lock held. Returns the 1-based slot or 0.
+static uint8_t _host_assign_slot(const uint8_t *mac)
+{
+    int free_slot = -1;
+    for (int i = 0; i < FPR_TDMA_MAX_SLOTS; i++) {
+        if (TDMA.owned[i]) {
+            if (memcmp(TDMA.owners[i], mac, MAC_ADDRESS_LENGTH) == 0) {
+                return (uint8_t)(i + 1);
+            }
+        } else if (free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0) {
+        return 0;
+    }
+    memcpy(TDMA.owners[free_slot], mac, MAC_ADDRESS_LENGTH);
+    TDMA.tags[free_slot] = _host_next_tag(free_slot);
+    TDMA.owned[free_slot] = true;
+    TDMA.stats.slots_assigned++;
+    if (free_slot + 1 > TDMA.slot_count) {
+        TDMA.slot_count = (uint16_t)(free_slot + 1);
+    }
+    return (uint8_t)(free_slot + 1);
+}
+
+static void _host_handle_slot_request(FPR_STORE_HASH_TYPE *peer)
+{
+    fpr_tdma_frame_t resp = {
+        .kind = FPR_TDMA_KIND_SLOT_ASSIGN,
+    };
+
+    taskENTER_CRITICAL(&TDMA.lock);
+    bool running = TDMA.host_running;
+    if (running) {
+        resp.slot = _host_assign_slot(peer->peer_info.peer_addr);
+        if (resp.slot != 0) {
+            resp.tag = TDMA.tags[resp.slot - 1];
+        }
+    }
+    taskEXIT_CRITICAL(&TDMA.lock);
+
+    if (!running) {
+        return;
+    }
+    if (resp.slot == 0) {
+        ESP_LOGW(TAG, "No free slot for %s", peer->name);
+    }
+    fpr_network_send_to_peer(peer->peer_info.peer_addr, &resp, sizeof(resp), FPR_PACKET_ID_TDMA);
+}
+
+uint32_t _fpr_tdma_beacon_period_us(void)
+{
+    if (!TDMA.ready) {
+        return 0;
+    }
+    taskENTER_CRITICAL(&TDMA.lock);
+    uint32_t period = TDMA.host_running ? _superframe_us(TDMA.slot_count, TDMA.config.slot_us) : 0;
+    taskEXIT_CRITICAL(&TDMA.lock);
+    return period;
+}
+
+void _fpr_tdma_fill_beacon(fpr_beacon_frame_t *beacon)
+{
+    if (!TDMA.ready) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&TDMA.lock);
+    if (TDMA.host_running) {
+        _host_reclaim_idle_slots(now);
+        beacon->flags |= FPR_BEACON_FLAG_TDMA;
+        beacon->slot_count = TDMA.slot_count;
+        beacon->slot_us = TDMA.config.slot_us;
+        beacon->packets_per_slot = TDMA.config.packets_per_slot;
+        for (int i = 0; i < TDMA.slot_count; i++) {
+            beacon->owner_tag[i] = TDMA.owned[i] ? TDMA.tags[i] : 0;
+        }
+        TDMA.stats.slot_count = TDMA.slot_count;
+        TDMA.stats.superframe_us = _superframe_us(TDMA.slot_count, TDMA.config.slot_us);
+        TDMA.stats.beacons++;
+    }
+    taskEXIT_CRITICAL(&TDMA.lock);
+}
+
+// ========== CLIENT ==========
+
+static void _client_send_now(fpr_package_t *package)
+{
+    _fpr_restamp_sequence(package, &TDMA.tx_message_seq);
+    esp_err_t err = _fpr_radio_send(package->dest_mac, package);
+    if (err == ESP_OK) {
+        _fpr_stat_add(FPR_STAT_PACKETS_SENT, 1);
+    } else {
+        _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
+    }
+}
+
+// Leave scheduled mode and release everything that was waiting for the slot
+static void _client_flush(void)
+{
+    if (TX_QUEUE == NULL) {
+        return;
+    }
+    fpr_package_t package;
+    while (xQueueReceive(TX_QUEUE, &package, 0) == pdPASS) {
+        _client_send_now(&package);
+    }
+}
+
+FPR_INSTANCE_TIMER_CB(_client_slot_cb)
+{
+    taskENTER_CRITICAL(&TDMA.lock);
+    bool scheduled = TDMA.scheduled;
+    uint8_t budget = TDMA.packets_per_slot;
+    taskEXIT_CRITICAL(&TDMA.lock);
+
+    if (!scheduled) {
+        return;
+    }
+
+    fpr_package_t package;
+    for (uint8_t i = 0; i < budget && TX_QUEUE != NULL && xQueueReceive(TX_QUEUE, &package, 0) == pdPASS; i++) {
+        _client_send_now(&package);
+    }
+
+    // Keep the slot running through a missed beacon, but not indefinitely
+    bool fallback = false;
+    uint32_t next_us = 0;
+    taskENTER_CRITICAL(&TDMA.lock);
+    if (++TDMA.missed_beacons > FPR_TDMA_MAX_MISSED_BEACONS) {
+        TDMA.scheduled = false;
+        TDMA.stats.fallbacks++;
+        fallback = true;
+    } else {
+        next_us = TDMA.superframe_us;
+    }
+    taskEXIT_CRITICAL(&TDMA.lock);
+
+    if (fallback) {
+        ESP_LOGW(TAG, "Lost host beacons - reverting to unscheduled sends");
+        _client_flush();
+    } else {
+        esp_timer_start_once(TDMA.slot_timer, next_us);
+    }
+}
+
+static void _client_request_slot(const uint8_t *host_mac)
+{
+    fpr_tdma_frame_t req = {
+        .kind = FPR_TDMA_KIND_SLOT_REQUEST,
+    };
+    uint8_t dest[MAC_ADDRESS_LENGTH];
+    memcpy(dest, host_mac, MAC_ADDRESS_LENGTH);
+    fpr_network_send_to_peer(dest, &req, sizeof(req), FPR_PACKET_ID_TDMA);
+}
+
+void _fpr_tdma_on_beacon(FPR_STORE_HASH_TYPE *peer, const fpr_beacon_frame_t *beacon, int64_t rx_time_us)
+{
+    if (!TDMA.ready || fpr_net.current_mode != FPR_MODE_CLIENT || TDMA.slot_timer == NULL) {
+        return;
+    }
+
+    bool tdma = (beacon->flags & FPR_BEACON_FLAG_TDMA) && beacon->slot_us > 0;
+    bool was_scheduled;
+    bool request_slot = false;
+    int64_t slot_start_local = 0;
+
+    taskENTER_CRITICAL(&TDMA.lock);
+    was_scheduled = TDMA.scheduled;
+    TDMA.stats.beacons++;
+    if (tdma) {
+        memcpy(TDMA.host_mac, peer->peer_info.peer_addr, MAC_ADDRESS_LENGTH);
+        TDMA.slot_us = beacon->slot_us;
+        TDMA.superframe_us = _superframe_us(beacon->slot_count, beacon->slot_us);
+        TDMA.packets_per_slot = beacon->packets_per_slot ? beacon->packets_per_slot : 1;
+        TDMA.missed_beacons = 0;
+        TDMA.stats.slot_count = beacon->slot_count;
+        TDMA.stats.superframe_us = TDMA.superframe_us;
+
+        // Owner tags may extend past our own FPR_TDMA_MAX_SLOTS if the host is configured larger
+        size_t tag_offset = offsetof(fpr_beacon_frame_t, owner_tag) + TDMA.slot - 1;
+        bool owner = TDMA.slot > 0 && TDMA.slot <= beacon->slot_count && tag_offset < FPR_PROTOCOL_SIZE &&
+                     ((const uint8_t *)beacon)[tag_offset] == TDMA.tag;
+        if (owner) {
+            // Superframe start in local time: exact when synchronized, beacon arrival otherwise
+            int64_t start = fpr_timesync_is_synced() ? fpr_timesync_network_to_local(beacon->epoch_us) : rx_time_us;
+            slot_start_local = start + (int64_t)TDMA.slot * TDMA.slot_us;
+            TDMA.scheduled = true;
+        } else {
+            TDMA.slot = 0;
+            TDMA.scheduled = false;
+            request_slot = true;
+        }
+    } else {
+        TDMA.slot = 0;
+        TDMA.scheduled = false;
+    }
+    bool scheduled = TDMA.scheduled;
+    TDMA.stats.scheduled = scheduled;
+    TDMA.stats.slot = TDMA.slot;
+    taskEXIT_CRITICAL(&TDMA.lock);
+
+    esp_timer_stop(TDMA.slot_timer);
+    if (scheduled) {
+        int64_t delay = slot_start_local - esp_timer_get_time();
+        esp_timer_start_once(TDMA.slot_timer, delay > 0 ? (uint64_t)delay : 0);
+    } else if (was_scheduled) {
+        _client_flush();
+    }
+
+    if (request_slot) {
+        _client_request_slot(peer->peer_info.peer_addr);
+    }
+}
+
+bool _fpr_tdma_should_defer(const uint8_t *peer_address, fpr_package_id_t package_id)
+{
+    // Only application data is scheduled; handshakes and services use slot 0
+    if (!TDMA.ready || TX_QUEUE == NULL || package_id < 0 || peer_address == NULL || fpr_net.current_mode != FPR_MODE_CLIENT) {
+        return false;
+    }
+    taskENTER_CRITICAL(&TDMA.lock);
+    bool defer = TDMA.scheduled && memcmp(peer_address, TDMA.host_mac, MAC_ADDRESS_LENGTH) == 0;
+    taskEXIT_CRITICAL(&TDMA.lock);
+    return defer;
+}
+
+esp_err_t _fpr_tdma_enqueue(const fpr_package_t *package)
+{
+    bool queued = (xQueueSend(TX_QUEUE, package, 0) == pdPASS);
+    taskENTER_CRITICAL(&TDMA.lock);
+    if (queued) {
+        TDMA.stats.deferred++;
+    } else {
+        TDMA.stats.queue_full++;
+    }
+    taskEXIT_CRITICAL(&TDMA.lock);
+    return queued ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+// ========== SERVICE HOOKS ==========
+
+void _fpr_tdma_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package)
+{
+    if (!TDMA.ready || package->payload_size < sizeof(fpr_tdma_frame_t)) {
+        return;
+    }
+
+    const fpr_tdma_frame_t *frame = (const fpr_tdma_frame_t *)&package->protocol;
+    switch (frame->kind) {
+        case FPR_TDMA_KIND_SLOT_REQUEST:
+            if (fpr_net.current_mode == FPR_MODE_HOST) {
+                _host_handle_slot_request(peer);
+            }
+            break;
+        case FPR_TDMA_KIND_SLOT_ASSIGN:
+            if (fpr_net.current_mode == FPR_MODE_CLIENT) {
+                // Takes effect once a beacon confirms ownership
+                taskENTER_CRITICAL(&TDMA.lock);
+                TDMA.slot = frame->slot;
+                TDMA.tag = frame->tag;
+                taskEXIT_CRITICAL(&TDMA.lock);
+                ESP_LOGI(TAG, "Assigned TDMA slot %u by %s", frame->slot, peer->name);
+            }
+            break;
+        default:
+            ESP_LOGW(TAG, "Unknown TDMA frame kind %d", frame->kind);
+            break;
+    }
+}
+
+void _fpr_tdma_init(void)
+{
+    memset(&TDMA, 0, sizeof(TDMA));
+    portMUX_INITIALIZE(&TDMA.lock);
+    TDMA.config = fpr_tdma_default_config();
+
+    if (TX_QUEUE == NULL) {
+        TX_QUEUE = xQueueCreate(FPR_TDMA_TX_QUEUE_LENGTH, sizeof(fpr_package_t));
+        if (TX_QUEUE == NULL) {
+            ESP_LOGE(TAG, "Failed to create slot queue - client sends stay unscheduled");
+        }
+    } else {
+        xQueueReset(TX_QUEUE);
+    }
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = _client_slot_cb,
+        .arg = &fpr_net,
+        .name = "fpr_tdma_slot"
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &TDMA.slot_timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create slot timer: %s", esp_err_to_name(err));
+        TDMA.slot_timer = NULL;
+    }
+    TDMA.ready = true;
+}
+
+void _fpr_tdma_deinit(void)
+{
+    TDMA.ready = false;
+    TDMA.host_running = false;
+    TDMA.scheduled = false;
+    if (TDMA.slot_timer != NULL) {
+        esp_timer_stop(TDMA.slot_timer);
+        esp_timer_delete(TDMA.slot_timer);
+        TDMA.slot_timer = NULL;
+    }
+    // Packets still waiting for the slot are dropped; the queue itself is reused
+    if (TX_QUEUE != NULL) {
+        xQueueReset(TX_QUEUE);
+    }
+}
+
+// ========== PUBLIC API ==========
+
+fpr_tdma_config_t fpr_tdma_default_config(void)
+{
+    fpr_tdma_config_t config = {
+        .slot_us = 5000,
+        .packets_per_slot = 2,
+        .idle_superframes = 8
+    };
+    return config;
+}
+
+esp_err_t fpr_tdma_host_start(const fpr_tdma_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(TDMA.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    ESP_RETURN_ON_FALSE(fpr_net.current_mode == FPR_MODE_HOST, ESP_ERR_INVALID_STATE, TAG, "TDMA scheduling requires host mode");
+
+    fpr_tdma_config_t cfg = config ? *config : fpr_tdma_default_config();
+    ESP_RETURN_ON_FALSE(cfg.slot_us >= 1000, ESP_ERR_INVALID_ARG, TAG, "Slot must be at least 1000 us");
+    ESP_RETURN_ON_FALSE(cfg.packets_per_slot >= 1 && cfg.idle_superframes >= 1, ESP_ERR_INVALID_ARG, TAG, "Invalid TDMA config");
+
+    taskENTER_CRITICAL(&TDMA.lock);
+    TDMA.config = cfg;
+    TDMA.host_running = true;
+    TDMA.stats.host_running = true;
+    taskEXIT_CRITICAL(&TDMA.lock);
+
+    _fpr_beacon_refresh();
+    ESP_LOGI(TAG, "TDMA started: slot=%lu us, %u pkt/slot", (unsigned long)cfg.slot_us, cfg.packets_per_slot);
+    return ESP_OK;
+}
+
+esp_err_t fpr_tdma_host_stop(void)
+{
+    ESP_RETURN_ON_FALSE(TDMA.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    taskENTER_CRITICAL(&TDMA.lock);
+    TDMA.host_running = false;
+    TDMA.stats.host_running = false;
+    memset(TDMA.owned, 0, sizeof(TDMA.owned));
+    TDMA.slot_count = 0;
+    taskEXIT_CRITICAL(&TDMA.lock);
+
+    _fpr_beacon_refresh();
+    return ESP_OK;
+}
+
+void fpr_tdma_get_status(fpr_tdma_status_t *status)
+{
+    if (status == NULL) {
+        return;
+    }
+    if (!TDMA.ready) {
+        memset(status, 0, sizeof(*status));
+        return;
+    }
+    taskENTER_CRITICAL(&TDMA.lock);
+    *status = TDMA.stats;
+    taskEXIT_CRITICAL(&TDMA.lock);
+}
@@ -0,0 +1,486 @@
+/**
+ * @file fpr_timesync.c
+ * @brief FPR Network Time Synchronization implementation
+ *
+ * Each accepted exchange produces an (offset, rtt) sample. The estimate is
+ * anchored to the window sample with the smallest error bound, where a
+ * sample's bound is rtt/2 plus the drift it may have accumulated since it
+ * was taken. Drift is measured between anchors at least
+ * FPR_TIMESYNC_DRIFT_SPAN_US apart and smoothed, since offset noise over a
+ * short span would dominate the slope.
+ *
+ * Clients sync to their host over the connection. Extenders never connect,
+ * so they sync hop by hop with neighbour frames. These are sent as
+ * broadcasts and addressed in the package header, so neither side needs a
+ * peer entry. An extender without a server broadcasts its request and
+ * locks to the first neighbour that answers: the host, or an extender
+ * that is itself synced. It drops that server after
+ * FPR_TIMESYNC_SERVER_MISSES unanswered requests. Every response carries
+ * the server's stratum and its own error bound, which is added to the
+ * sample's, so the bound grows along the chain.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_timesync.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "esp_check.h"
+#include "esp_log.h"
+
+static const char *TAG = "fpr_timesync";
+
+#define TS fpr_net.timesync
+
+// Residual drift assumed after compensation when computing the error bound
+#define FPR_TIMESYNC_RESIDUAL_PPB 5000
+// Minimum spacing between anchors used for a drift measurement
+#define FPR_TIMESYNC_DRIFT_SPAN_US (10 * 1000 * 1000LL)
+// Drift smoothing: new = old + (measured - old) / FPR_TIMESYNC_DRIFT_SMOOTHING
+#define FPR_TIMESYNC_DRIFT_SMOOTHING 8
+// Nodes this many hops from the reference no longer serve time, which also ends loops
+#define FPR_TIMESYNC_MAX_STRATUM 8
+// Unanswered requests before an extender looks for another server
+#define FPR_TIMESYNC_SERVER_MISSES 3
+
+static inline bool _is_reference(void)
+{
+    return fpr_net.current_mode == FPR_MODE_HOST;
+}
+
+static inline int64_t _abs64(int64_t v)
+{
+    return v < 0 ? -v : v;
+}
+
+// Must be called with the lock held
+static uint32_t _sample_error(const fpr_timesync_sample_t *sample, int64_t now)
+{
+    int64_t age = _abs64(now - sample->local_us);
+    return sample->server_error_us + sample->rtt_us / 2 + (uint32_t)((age * FPR_TIMESYNC_RESIDUAL_PPB) / 1000000000LL);
+}
+
+// Must be called with the lock held
+static uint8_t _stratum(void)
+{
+    return _is_reference() ? 0 : (uint8_t)(TS.best.stratum + 1);
+}
+
+// Must be called with the lock held
+static int64_t _to_network(int64_t local_us)
+{
+    if (_is_reference() || !TS.synced) {
+        return local_us;
+    }
+    int64_t elapsed = local_us - TS.best.local_us;
+    return local_us + TS.best.offset_us + (elapsed * TS.drift_ppb) / 1000000000LL;
+}
+
+// Must be called with the lock held
+static void _update_estimate(int64_t now)
+{
+    const fpr_timesync_sample_t *best = NULL;
+    uint32_t best_error = UINT32_MAX;
+    for (int i = 0; i < TS.window_count; i++) {
+        uint32_t error = _sample_error(&TS.window[i], now);
+        if (error < best_error) {
+            best_error = error;
+            best = &TS.window[i];
+        }
+    }
+    if (best == NULL) {
+        return;
+    }
+
+    TS.best = *best;
+    TS.synced = true;
+
+    if (!TS.drift_valid && TS.drift_anchor.local_us == 0) {
+        TS.drift_anchor = *best;
+        return;
+    }
+
+    int64_t span = best->local_us - TS.drift_anchor.local_us;
+    if (span < FPR_TIMESYNC_DRIFT_SPAN_US) {
+        return;
+    }
+
+    int32_t measured = (int32_t)(((best->offset_us - TS.drift_anchor.offset_us) * 1000000000LL) / span);
+    if (TS.drift_valid) {
+        TS.drift_ppb += (measured - TS.drift_ppb) / FPR_TIMESYNC_DRIFT_SMOOTHING;
+    } else {
+        TS.drift_ppb = measured;
+        TS.drift_valid = true;
+    }
+    TS.drift_anchor = *best;
+}
+
+// Must be called with the lock held
+static void _reset_estimate(void)
+{
+    TS.synced = false;
+    TS.window_pos = 0;
+    TS.window_count = 0;
+    TS.drift_ppb = 0;
+    memset(&TS.best, 0, sizeof(TS.best));
+    memset(&TS.drift_anchor, 0, sizeof(TS.drift_anchor));
+    TS.drift_valid = false;
+}
+
+// Must be called with the lock held
+static void _use_server(const uint8_t *mac)
+{
+    if (memcmp(TS.server_mac, mac, MAC_ADDRESS_LENGTH) != 0) {
+        // Different host, different clock
+        _reset_estimate();
+        memcpy(TS.server_mac, mac, MAC_ADDRESS_LENGTH);
+    }
+}
+
+// Fill the response; false if this node has no time to give the requester
+static bool _serve(const uint8_t *requester, const fpr_timesync_frame_t *req, int64_t rx_time_us, fpr_timesync_frame_t *resp)
+{
+    resp->seq = req->seq;
+    resp->t1 = req->t1;
+
+    taskENTER_CRITICAL(&TS.lock);
+    bool can_serve = _is_reference() ||
+                     (TS.synced && _stratum() < FPR_TIMESYNC_MAX_STRATUM &&
+                      memcmp(requester, TS.server_mac, MAC_ADDRESS_LENGTH) != 0);
+    resp->stratum = _stratum();
+    resp->t2 = _to_network(rx_time_us);
+    int64_t now = esp_timer_get_time();
+    resp->error_us = _is_reference() ? 0 : _sample_error(&TS.best, now);
+    resp->t3 = _to_network(now);
+    taskEXIT_CRITICAL(&TS.lock);
+    return can_serve;
+}
+
+static void _handle_request(FPR_STORE_HASH_TYPE *peer, const fpr_timesync_frame_t *req, int64_t rx_time_us)
+{
+    fpr_timesync_frame_t resp = {
+        .kind = FPR_TIMESYNC_KIND_RESPONSE,
+    };
+    if (_serve(peer->peer_info.peer_addr, req, rx_time_us, &resp)) {
+        fpr_network_send_to_peer(peer->peer_info.peer_addr, &resp, sizeof(resp), FPR_PACKET_ID_TIMESYNC);
+    }
+}
+
+// One hop only: broadcast, with the addressee in the header
+static esp_err_t _send_neighbor_frame(const uint8_t *dest, const fpr_timesync_frame_t *frame)
+{
+    fpr_package_t package = {0};
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.id = FPR_PACKET_ID_TIMESYNC;
+    package.payload_size = sizeof(*frame);
+    memcpy(&package.protocol, frame, sizeof(*frame));
+    memcpy(package.origin_mac, fpr_net.mac, MAC_ADDRESS_LENGTH);
+    memcpy(package.dest_mac, dest, MAC_ADDRESS_LENGTH);
+    package.max_hops = 1;
+    package.version = FPR_PROTOCOL_VERSION;
+
+    const uint8_t broadcast[MAC_ADDRESS_LENGTH] = FPR_BROADCAST_ADDRESS;
+    esp_err_t err = _fpr_radio_send(broadcast, &package);
+    if (err == ESP_OK) {
+        _fpr_stat_add(FPR_STAT_PACKETS_SENT, 1);
+    } else {
+        _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
+    }
+    return err;
+}
+
+static void _handle_response(const uint8_t *server, const fpr_timesync_frame_t *resp, int64_t t4)
+{
+    taskENTER_CRITICAL(&TS.lock);
+    bool from_server = memcmp(server, TS.server_mac, MAC_ADDRESS_LENGTH) == 0;
+    // A neighbour request without a server goes to whoever answers first
+    bool adopt = resp->kind == FPR_TIMESYNC_KIND_NEIGHBOR_RESPONSE && !TS.has_server;
+    if (resp->seq != TS.seq || resp->t1 != TS.request_t1 || (!from_server && !adopt) ||
+        resp->stratum >= FPR_TIMESYNC_MAX_STRATUM) {
+        TS.rejected++;
+        taskEXIT_CRITICAL(&TS.lock);
+        return;
+    }
+    // Consume the request so a duplicated response cannot be counted twice
+    TS.seq++;
+    if (adopt) {
+        // Neighbour servers all give network time: keep the samples taken so far
+        memcpy(TS.server_mac, server, MAC_ADDRESS_LENGTH);
+        TS.has_server = true;
+    }
+    TS.misses = 0;
+
+    int64_t rtt = (t4 - resp->t1) - (resp->t3 - resp->t2);
+    if (rtt < 0 || rtt > FPR_TIMESYNC_MAX_RTT_US) {
+        TS.rejected++;
+        taskEXIT_CRITICAL(&TS.lock);
+        return;
+    }
+
+    fpr_timesync_sample_t *sample = &TS.window[TS.window_pos];
+    sample->local_us = t4;
+    sample->offset_us = ((resp->t2 - resp->t1) + (resp->t3 - t4)) / 2;
+    sample->rtt_us = (uint32_t)rtt;
+    sample->server_error_us = resp->error_us;
+    sample->stratum = resp->stratum;
+    TS.window_pos = (TS.window_pos + 1) % FPR_TIMESYNC_WINDOW;
+    if (TS.window_count < FPR_TIMESYNC_WINDOW) {
+        TS.window_count++;
+    }
+    TS.samples++;
+    _update_estimate(t4);
+    taskEXIT_CRITICAL(&TS.lock);
+}
+
+FPR_INSTANCE_TIMER_CB(_timesync_timer_cb)
+{
+    if (fpr_timesync_trigger() == ESP_ERR_INVALID_STATE) {
+        // Lost the host - resume when the next connection completes
+        esp_timer_stop(TS.timer);
+    }
+}
+
+// ========== SERVICE HOOKS ==========
+
+void _fpr_timesync_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package, int64_t rx_time_us)
+{
+    if (!TS.ready) {
+        return;
+    }
+    if (package->payload_size < sizeof(fpr_timesync_frame_t)) {
+        ESP_LOGW(TAG, "Malformed time sync frame from " MACSTR, MAC2STR(peer->peer_info.peer_addr));
+        return;
+    }
+
+    const fpr_timesync_frame_t *frame = (const fpr_timesync_frame_t *)&package->protocol;
+    switch (frame->kind) {
+        case FPR_TIMESYNC_KIND_REQUEST:
+            _handle_request(peer, frame, rx_time_us);
+            break;
+        case FPR_TIMESYNC_KIND_RESPONSE:
+            _handle_response(peer->peer_info.peer_addr, frame, rx_time_us);
+            break;
+        default:
+            ESP_LOGW(TAG, "Unknown time sync frame kind %d", frame->kind);
+            break;
+    }
+}
+
+void _fpr_timesync_on_peer_connected(FPR_STORE_HASH_TYPE *peer)
+{
+    if (!TS.ready || _is_reference() || TS.timer == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&TS.lock);
+    _use_server(peer->peer_info.peer_addr);
+    taskEXIT_CRITICAL(&TS.lock);
+
+    // ESP_ERR_INVALID_STATE just means the timer is already running
+    esp_timer_start_periodic(TS.timer, (uint64_t)FPR_TIMESYNC_INTERVAL_MS * 1000);
+    fpr_timesync_trigger();
+}
+
+bool _fpr_timesync_on_rx(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *package)
+{
+    int64_t rx_time_us = esp_timer_get_time();
+    const fpr_timesync_frame_t *frame = (const fpr_timesync_frame_t *)&package->protocol;
+    if (package->id != FPR_PACKET_ID_TIMESYNC ||
+        (frame->kind != FPR_TIMESYNC_KIND_NEIGHBOR_REQUEST && frame->kind != FPR_TIMESYNC_KIND_NEIGHBOR_RESPONSE)) {
+        return false;
+    }
+    if (!TS.ready || package->package_type != FPR_PACKAGE_TYPE_SINGLE ||
+        (!is_broadcast_address(package->dest_mac) && memcmp(package->dest_mac, fpr_net.mac, MAC_ADDRESS_LENGTH) != 0)) {
+        return true;
+    }
+
+    if (frame->kind == FPR_TIMESYNC_KIND_NEIGHBOR_REQUEST) {
+        fpr_timesync_frame_t resp = {
+            .kind = FPR_TIMESYNC_KIND_NEIGHBOR_RESPONSE,
+        };
+        if (fpr_net.current_mode != FPR_MODE_CLIENT && _serve(esp_now_info->src_addr, frame, rx_time_us, &resp)) {
+            _send_neighbor_frame(esp_now_info->src_addr, &resp);
+        }
+    } else if (fpr_net.current_mode == FPR_MODE_EXTENDER) {
+        _handle_response(esp_now_info->src_addr, frame, rx_time_us);
+    }
+    return true;
+}
+
+void _fpr_timesync_on_mode_set(void)
+{
+    if (!TS.ready || TS.timer == NULL) {
+        return;
+    }
+    if (fpr_net.current_mode == FPR_MODE_EXTENDER) {
+        // ESP_ERR_INVALID_STATE just means the timer is already running
+        esp_timer_start_periodic(TS.timer, (uint64_t)FPR_TIMESYNC_INTERVAL_MS * 1000);
+        fpr_timesync_trigger();
+    } else if (fpr_net.current_mode == FPR_MODE_HOST) {
+        esp_timer_stop(TS.timer);
+    }
+}
+
+void _fpr_timesync_init(void)
+{
+    memset(&TS, 0, sizeof(TS));
+    portMUX_INITIALIZE(&TS.lock);
+    _reset_estimate();
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = _timesync_timer_cb,
+        .arg = &fpr_net,
+        .name = "fpr_timesync"
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &TS.timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create time sync timer: %s", esp_err_to_name(err));
+        TS.timer = NULL;
+    }
+    TS.ready = true;
+}
+
+void _fpr_timesync_deinit(void)
+{
+    TS.ready = false;
+    if (TS.timer != NULL) {
+        esp_timer_stop(TS.timer);
+        esp_timer_delete(TS.timer);
+        TS.timer = NULL;
+    }
+}
+
+// ========== PUBLIC API ==========
+
+esp_err_t fpr_timesync_get_time(int64_t *time_us, uint32_t *error_us)
+{
+    ESP_RETURN_ON_FALSE(time_us != NULL, ESP_ERR_INVALID_ARG, TAG, "Output is NULL");
+    ESP_RETURN_ON_FALSE(TS.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    int64_t now = esp_timer_get_time();
+    esp_err_t result = ESP_OK;
+
+    taskENTER_CRITICAL(&TS.lock);
+    if (_is_reference()) {
+        *time_us = now;
+        if (error_us) {
+            *error_us = 0;
+        }
+    } else if (TS.synced) {
+        *time_us = _to_network(now);
+        if (error_us) {
+            *error_us = _sample_error(&TS.best, now);
+        }
+    } else {
+        result = ESP_ERR_INVALID_STATE;
+    }
+    taskEXIT_CRITICAL(&TS.lock);
+    return result;
+}
+
+int64_t fpr_timesync_local_to_network(int64_t local_us)
+{
+    if (!TS.ready) {
+        return local_us;
+    }
+    taskENTER_CRITICAL(&TS.lock);
+    int64_t network_us = _to_network(local_us);
+    taskEXIT_CRITICAL(&TS.lock);
+    return network_us;
+}
+
+int64_t fpr_timesync_network_to_local(int64_t network_us)
+{
+    if (!TS.ready) {
+        return network_us;
+    }
+    taskENTER_CRITICAL(&TS.lock);
+    int64_t local_us = network_us;
+    if (!_is_reference() && TS.synced) {
+        // One fixed-point step is exact to well below a microsecond for ppm-level drift
+        int64_t guess = network_us - TS.best.offset_us;
+        local_us = network_us - TS.best.offset_us - ((guess - TS.best.local_us) * TS.drift_ppb) / 1000000000LL;
+    }
+    taskEXIT_CRITICAL(&TS.lock);
+    return local_us;
+}
+
+bool fpr_timesync_is_synced(void)
+{
+    return TS.ready && (_is_reference() || TS.synced);
+}
+
+void fpr_timesync_get_status(fpr_timesync_status_t *status)
+{
+    if (status == NULL) {
+        return;
+    }
+    memset(status, 0, sizeof(*status));
+    if (!TS.ready) {
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&TS.lock);
+    status->is_reference = _is_reference();
+    status->synced = status->is_reference || TS.synced;
+    status->samples = TS.samples;
+    status->rejected = TS.rejected;
+    if (!status->is_reference && TS.synced) {
+        status->stratum = _stratum();
+        status->offset_us = TS.best.offset_us;
+        status->drift_ppb = TS.drift_ppb;
+        status->rtt_us = TS.best.rtt_us;
+        status->error_us = _sample_error(&TS.best, now);
+        status->last_sync_age_us = now - TS.best.local_us;
+    }
+    taskEXIT_CRITICAL(&TS.lock);
+}
+
+esp_err_t fpr_timesync_trigger(void)
+{
+    ESP_RETURN_ON_FALSE(TS.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    if (_is_reference()) {
+        return ESP_OK;
+    }
+
+    fpr_timesync_frame_t req = {
+        .kind = FPR_TIMESYNC_KIND_REQUEST,
+    };
+
+    if (fpr_net.current_mode == FPR_MODE_EXTENDER) {
+        uint8_t dest[MAC_ADDRESS_LENGTH] = FPR_BROADCAST_ADDRESS;
+        req.kind = FPR_TIMESYNC_KIND_NEIGHBOR_REQUEST;
+        taskENTER_CRITICAL(&TS.lock);
+        if (TS.has_server && TS.misses >= FPR_TIMESYNC_SERVER_MISSES) {
+            TS.has_server = false; // Gone quiet: ask everyone again
+        }
+        if (TS.has_server) {
+            memcpy(dest, TS.server_mac, MAC_ADDRESS_LENGTH);
+            TS.misses++;
+        }
+        req.seq = ++TS.seq;
+        TS.request_t1 = esp_timer_get_time();
+        req.t1 = TS.request_t1;
+        taskEXIT_CRITICAL(&TS.lock);
+        return _send_neighbor_frame(dest, &req);
+    }
+
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    if (fpr_client_get_host_info(host_mac, NULL, 0) != ESP_OK) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&TS.lock);
+    // Also covers a host switch the connected hook has not seen yet
+    _use_server(host_mac);
+    req.seq = ++TS.seq;
+    // Taken last so queuing ahead of the send stays out of the RTT
+    TS.request_t1 = esp_timer_get_time();
+    req.t1 = TS.request_t1;
+    taskEXIT_CRITICAL(&TS.lock);
+
+    return fpr_network_send_to_peer(host_mac, &req, sizeof(req), FPR_PACKET_ID_TIMESYNC);
+}
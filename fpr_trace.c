@@ -0,0 +1,199 @@
+/**
+ * @file fpr_trace.c
+ * @brief FPR Packet-Event Trace implementation
+ *
+ * A power-of-two ring of fixed-size records. A writer claims the next
+ * position with an atomic add, marks the slot busy, fills it and publishes
+ * a tag (position + 1) last. Readers accept a slot only if it holds the tag
+ * they expect before and after copying it, so half-written or overwritten
+ * records are skipped instead of returned torn. An empty or busy slot holds
+ * the tag of the position after it, which belongs to the next slot and so
+ * never matches a position this slot can hold.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_trace.h"
+#include "fpr/internal/helpers.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+
+#if (FPR_TRACE_ENABLE == 1)
+
+_Static_assert((FPR_TRACE_RING_SIZE & (FPR_TRACE_RING_SIZE - 1)) == 0, "CONFIG_FPR_TRACE_RING_SIZE must be a power of two");
+_Static_assert(sizeof(fpr_trace_record_t) == 24, "fpr_trace_record_t is a dump format");
+_Static_assert(sizeof(fpr_trace_file_header_t) == 16, "fpr_trace_file_header_t is a dump format");
+
+#define TRACE_MASK (FPR_TRACE_RING_SIZE - 1)
+#define TRACE_TAG(pos) ((pos) + 1)
+#define TRACE_TAG_NONE(pos) TRACE_TAG((pos) + 1)
+#define TRACE_DUMP_CHUNK 16
+#define TRACE_CONSOLE_LINE 48
+
+// Not part of fpr_net: the ring must outlive fpr_network_deinit() so a
+// failed run can still be dumped
+static fpr_trace_record_t s_ring[FPR_TRACE_RING_SIZE];
+static uint32_t s_head;
+static bool s_enabled = true;
+
+void _fpr_trace(fpr_trace_event_t event, uint8_t arg, const uint8_t *peer, const fpr_package_t *package)
+{
+    if (!__atomic_load_n(&s_enabled, __ATOMIC_RELAXED)) {
+        return;
+    }
+    uint32_t pos = __atomic_fetch_add(&s_head, 1, __ATOMIC_RELAXED);
+    fpr_trace_record_t *r = &s_ring[pos & TRACE_MASK];
+
+    __atomic_store_n(&r->seq, TRACE_TAG_NONE(pos), __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    r->timestamp_us = (uint32_t)esp_timer_get_time();
+    r->sequence_num = package ? package->sequence_num : 0;
+    r->package_id = package ? package->id : 0;
+    if (peer) {
+        memcpy(r->peer, peer, sizeof(r->peer));
+    } else {
+        memset(r->peer, 0, sizeof(r->peer));
+    }
+    r->event = (uint8_t)event;
+    r->arg = arg;
+    __atomic_store_n(&r->seq, TRACE_TAG(pos), __ATOMIC_RELEASE);
+}
+
+void fpr_trace_set_enabled(bool enable)
+{
+    __atomic_store_n(&s_enabled, enable, __ATOMIC_RELAXED);
+}
+
+// Read from *cursor up to, not past, end
+static size_t _trace_read_until(uint32_t *cursor, uint32_t end, fpr_trace_record_t *records, size_t max)
+{
+    uint32_t head = __atomic_load_n(&s_head, __ATOMIC_ACQUIRE);
+    uint32_t pos = *cursor;
+    if (head - pos > FPR_TRACE_RING_SIZE) {
+        pos = head - FPR_TRACE_RING_SIZE;
+    }
+    // Writers lapped the window: nothing of it is left
+    if (pos - *cursor > end - *cursor) {
+        *cursor = end;
+        return 0;
+    }
+
+    size_t count = 0;
+    for (; pos != end && count < max; pos++) {
+        const fpr_trace_record_t *r = &s_ring[pos & TRACE_MASK];
+        if (__atomic_load_n(&r->seq, __ATOMIC_ACQUIRE) != TRACE_TAG(pos)) {
+            continue;
+        }
+        records[count] = *r;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&r->seq, __ATOMIC_RELAXED) != TRACE_TAG(pos)) {
+            continue;
+        }
+        records[count].seq = pos;
+        count++;
+    }
+    *cursor = pos;
+    return count;
+}
+
+size_t fpr_trace_read(uint32_t *cursor, fpr_trace_record_t *records, size_t max)
+{
+    if (cursor == NULL || records == NULL) {
+        return 0;
+    }
+    return _trace_read_until(cursor, __atomic_load_n(&s_head, __ATOMIC_ACQUIRE), records, max);
+}
+
+esp_err_t fpr_trace_dump(fpr_trace_write_fn_t write, void *ctx)
+{
+    if (write == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    fpr_trace_file_header_t header = {
+        .magic = { 'F', 'P', 'R', 'T' },
+        .version = FPR_TRACE_FILE_VERSION,
+        .record_size = sizeof(fpr_trace_record_t),
+    };
+    memcpy(header.node_mac, fpr_net.mac, sizeof(header.node_mac));
+    esp_err_t err = write(&header, sizeof(header), ctx);
+
+    // Only what was in the ring when the dump started
+    uint32_t end = __atomic_load_n(&s_head, __ATOMIC_ACQUIRE);
+    uint32_t cursor = end > FPR_TRACE_RING_SIZE ? end - FPR_TRACE_RING_SIZE : 0;
+    fpr_trace_record_t chunk[TRACE_DUMP_CHUNK];
+    while (err == ESP_OK && cursor != end) {
+        size_t n = _trace_read_until(&cursor, end, chunk, TRACE_DUMP_CHUNK);
+        if (n > 0) {
+            err = write(chunk, n * sizeof(chunk[0]), ctx);
+        }
+    }
+    return err;
+}
+
+static esp_err_t _console_write(const void *data, size_t size, void *ctx)
+{
+    (void)ctx;
+    const uint8_t *bytes = (const uint8_t *)data;
+    while (size > 0) {
+        size_t n = size < TRACE_CONSOLE_LINE ? size : TRACE_CONSOLE_LINE;
+        printf("FPRT ");
+        for (size_t i = 0; i < n; i++) {
+            printf("%02x", bytes[i]);
+        }
+        printf("\n");
+        bytes += n;
+        size -= n;
+    }
+    return ESP_OK;
+}
+
+esp_err_t fpr_trace_dump_console(void)
+{
+    printf("FPRT BEGIN\n");
+    esp_err_t err = fpr_trace_dump(_console_write, NULL);
+    printf("FPRT END\n");
+    return err;
+}
+
+void fpr_trace_clear(void)
+{
+    // Invalidate every slot; the head keeps counting so cursors stay valid
+    for (size_t i = 0; i < FPR_TRACE_RING_SIZE; i++) {
+        __atomic_store_n(&s_ring[i].seq, TRACE_TAG_NONE((uint32_t)i), __ATOMIC_RELAXED);
+    }
+}
+
+#else
+
+void fpr_trace_set_enabled(bool enable)
+{
+    (void)enable;
+}
+
+size_t fpr_trace_read(uint32_t *cursor, fpr_trace_record_t *records, size_t max)
+{
+    (void)cursor;
+    (void)records;
+    (void)max;
+    return 0;
+}
+
+esp_err_t fpr_trace_dump(fpr_trace_write_fn_t write, void *ctx)
+{
+    (void)write;
+    (void)ctx;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t fpr_trace_dump_console(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void fpr_trace_clear(void)
+{
+}
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * @file fpr_transport.c
+ * @brief FPR Transport selection and the ESP-NOW transport
+ *
+ * The transport is shared by all network instances, like the radio it
+ * usually drives. It can only be changed while no instance is initialized.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/internal/transport.h"
+#include "fpr/internal/private_defs.h"
+#include "esp_wifi.h"
+#include "esp_mac.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include <string.h>
+
+static const char *TAG = "fpr_transport";
+
+// ========== ESP-NOW ==========
+
+static fpr_transport_rx_cb_t s_espnow_rx;
+static fpr_transport_tx_done_cb_t s_espnow_tx_done;
+
+static void _espnow_recv(const esp_now_recv_info_t *esp_now_info, const uint8_t *data, int len)
+{
+    fpr_transport_rx_cb_t rx = s_espnow_rx;
+    if (rx == NULL) {
+        return;
+    }
+    fpr_transport_rx_info_t info = {
+        .src_addr = esp_now_info->src_addr,
+        .dest_addr = esp_now_info->des_addr,
+    };
+    if (esp_now_info->rx_ctrl != NULL) {
+        info.rssi = (int8_t)esp_now_info->rx_ctrl->rssi;
+        info.noise_floor = (int8_t)esp_now_info->rx_ctrl->noise_floor;
+        info.channel = (uint8_t)esp_now_info->rx_ctrl->channel;
+    }
+    rx(&info, data, len);
+}
+
+static void _espnow_send_done(const wifi_tx_info_t *tx_info, esp_now_send_status_t status)
+{
+    fpr_transport_tx_done_cb_t tx_done = s_espnow_tx_done;
+    if (tx_done != NULL) {
+        tx_done(tx_info->des_addr, status == ESP_NOW_SEND_SUCCESS);
+    }
+}
+
+static esp_err_t _espnow_init(void *ctx)
+{
+    (void)ctx;
+    return esp_now_init();
+}
+
+static esp_err_t _espnow_deinit(void *ctx)
+{
+    (void)ctx;
+    s_espnow_rx = NULL;
+    s_espnow_tx_done = NULL;
+    return esp_now_deinit();
+}
+
+static esp_err_t _espnow_set_callbacks(void *ctx, fpr_transport_rx_cb_t rx, fpr_transport_tx_done_cb_t tx_done)
+{
+    (void)ctx;
+    s_espnow_rx = rx;
+    s_espnow_tx_done = tx_done;
+    ESP_RETURN_ON_ERROR(esp_now_register_send_cb(_espnow_send_done), TAG, "Failed to register send callback");
+    ESP_RETURN_ON_ERROR(esp_now_register_recv_cb(_espnow_recv), TAG, "Failed to register receive callback");
+    return ESP_OK;
+}
+
+static esp_err_t _espnow_send(void *ctx, const uint8_t *dest_addr, const uint8_t *data, size_t len)
+{
+    (void)ctx;
+    return esp_now_send(dest_addr, data, len);
+}
+
+static void _espnow_peer_info(const fpr_transport_peer_t *peer, esp_now_peer_info_t *info)
+{
+    memset(info, 0, sizeof(*info));
+    memcpy(info->peer_addr, peer->addr, ESP_NOW_ETH_ALEN);
+    memcpy(info->lmk, peer->lmk, ESP_NOW_KEY_LEN);
+    info->channel = peer->channel;
+    info->encrypt = peer->encrypt;
+    info->ifidx = WIFI_IF_STA;
+}
+
+static esp_err_t _espnow_add_peer(void *ctx, const fpr_transport_peer_t *peer)
+{
+    (void)ctx;
+    esp_now_peer_info_t info;
+    _espnow_peer_info(peer, &info);
+    return esp_now_add_peer(&info);
+}
+
+static esp_err_t _espnow_mod_peer(void *ctx, const fpr_transport_peer_t *peer)
+{
+    (void)ctx;
+    esp_now_peer_info_t info;
+    _espnow_peer_info(peer, &info);
+    return esp_now_mod_peer(&info);
+}
+
+static esp_err_t _espnow_del_peer(void *ctx, const uint8_t *addr)
+{
+    (void)ctx;
+    return esp_now_del_peer(addr);
+}
+
+static size_t _espnow_mtu(void *ctx)
+{
+    (void)ctx;
+    return ESP_NOW_MAX_DATA_LEN;
+}
+
+static esp_err_t _espnow_get_addr(void *ctx, uint8_t addr[FPR_TRANSPORT_ADDR_LEN])
+{
+    (void)ctx;
+    return esp_read_mac(addr, ESP_MAC_WIFI_STA);
+}
+
+static esp_err_t _espnow_set_wake_window(void *ctx, uint16_t window_ms)
+{
+    (void)ctx;
+    return esp_now_set_wake_window(window_ms);
+}
+
+static esp_err_t _espnow_set_wake_interval(void *ctx, uint16_t interval_ms)
+{
+    (void)ctx;
+    return esp_wifi_connectionless_module_set_wake_interval(interval_ms);
+}
+
+static const fpr_transport_ops_t s_espnow_ops = {
+    .name = "esp-now",
+    .init = _espnow_init,
+    .deinit = _espnow_deinit,
+    .set_callbacks = _espnow_set_callbacks,
+    .send = _espnow_send,
+    .add_peer = _espnow_add_peer,
+    .mod_peer = _espnow_mod_peer,
+    .del_peer = _espnow_del_peer,
+    .mtu = _espnow_mtu,
+    .get_addr = _espnow_get_addr,
+    .set_wake_window = _espnow_set_wake_window,
+    .set_wake_interval = _espnow_set_wake_interval,
+};
+
+static const fpr_transport_t s_espnow = { .ops = &s_espnow_ops, .ctx = NULL };
+
+// ========== SELECTION ==========
+
+static const fpr_transport_t *s_transport = &s_espnow;
+
+static bool _any_instance_initialized(void)
+{
+    for (int i = 0; i < FPR_MAX_INSTANCES; i++) {
+        if (fpr_instances[i].state != FPR_STATE_UNINITIALIZED) {
+            return true;
+        }
+    }
+    return false;
+}
+
+esp_err_t fpr_transport_set(const fpr_transport_t *transport)
+{
+    ESP_RETURN_ON_FALSE(!_any_instance_initialized(), ESP_ERR_INVALID_STATE, TAG, "Deinitialize every network first");
+    ESP_RETURN_ON_FALSE(transport == NULL || (transport->ops != NULL && transport->ops->send != NULL), ESP_ERR_INVALID_ARG,
+                        TAG, "Transport has no send operation");
+    s_transport = transport != NULL ? transport : &s_espnow;
+    return ESP_OK;
+}
+
+const fpr_transport_t *fpr_transport_get(void)
+{
+    return s_transport;
+}
+
+const fpr_transport_t *fpr_transport_espnow(void)
+{
+    return &s_espnow;
+}
+
+// ========== INTERNAL ==========
+
+static void _peer_from_info(const esp_now_peer_info_t *info, fpr_transport_peer_t *peer)
+{
+    memcpy(peer->addr, info->peer_addr, FPR_TRANSPORT_ADDR_LEN);
+    memcpy(peer->lmk, info->lmk, FPR_TRANSPORT_KEY_LEN);
+    peer->channel = info->channel;
+    peer->encrypt = info->encrypt;
+}
+
+esp_err_t _fpr_transport_init(fpr_transport_rx_cb_t rx, fpr_transport_tx_done_cb_t tx_done)
+{
+    const fpr_transport_t *t = s_transport;
+    size_t mtu = t->ops->mtu != NULL ? t->ops->mtu(t->ctx) : 0;
+    ESP_RETURN_ON_FALSE(mtu >= sizeof(fpr_package_t), ESP_ERR_INVALID_SIZE, TAG, "%s MTU %u is below the package size %u",
+                        t->ops->name, (unsigned)mtu, (unsigned)sizeof(fpr_package_t));
+    if (t->ops->init != NULL) {
+        ESP_RETURN_ON_ERROR(t->ops->init(t->ctx), TAG, "Failed to start the %s transport", t->ops->name);
+    }
+    if (t->ops->set_callbacks != NULL) {
+        esp_err_t err = t->ops->set_callbacks(t->ctx, rx, tx_done);
+        if (err != ESP_OK) {
+            if (t->ops->deinit != NULL) {
+                t->ops->deinit(t->ctx);
+            }
+            return err;
+        }
+    }
+    ESP_LOGI(TAG, "Transport: %s", t->ops->name);
+    return ESP_OK;
+}
+
+esp_err_t _fpr_transport_deinit(void)
+{
+    const fpr_transport_t *t = s_transport;
+    return t->ops->deinit != NULL ? t->ops->deinit(t->ctx) : ESP_OK;
+}
+
+esp_err_t _fpr_transport_send(const uint8_t *dest, const uint8_t *data, size_t len)
+{
+    const fpr_transport_t *t = s_transport;
+    return t->ops->send(t->ctx, dest, data, len);
+}
+
+esp_err_t _fpr_transport_add_peer(const esp_now_peer_info_t *info)
+{
+    const fpr_transport_t *t = s_transport;
+    if (t->ops->add_peer == NULL) {
+        return ESP_OK;
+    }
+    fpr_transport_peer_t peer;
+    _peer_from_info(info, &peer);
+    return t->ops->add_peer(t->ctx, &peer);
+}
+
+esp_err_t _fpr_transport_mod_peer(const esp_now_peer_info_t *info)
+{
+    const fpr_transport_t *t = s_transport;
+    if (t->ops->mod_peer == NULL) {
+        return ESP_OK;
+    }
+    fpr_transport_peer_t peer;
+    _peer_from_info(info, &peer);
+    return t->ops->mod_peer(t->ctx, &peer);
+}
+
+esp_err_t _fpr_transport_del_peer(const uint8_t *addr)
+{
+    const fpr_transport_t *t = s_transport;
+    return t->ops->del_peer != NULL ? t->ops->del_peer(t->ctx, addr) : ESP_OK;
+}
+
+esp_err_t _fpr_transport_get_addr(uint8_t addr[FPR_TRANSPORT_ADDR_LEN])
+{
+    const fpr_transport_t *t = s_transport;
+    if (t->ops->get_addr == NULL) {
+        return esp_read_mac(addr, ESP_MAC_WIFI_STA);
+    }
+    return t->ops->get_addr(t->ctx, addr);
+}
+
+esp_err_t _fpr_transport_set_wake_window(uint16_t window_ms)
+{
+    const fpr_transport_t *t = s_transport;
+    return t->ops->set_wake_window != NULL ? t->ops->set_wake_window(t->ctx, window_ms) : ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t _fpr_transport_set_wake_interval(uint16_t interval_ms)
+{
+    const fpr_transport_t *t = s_transport;
+    return t->ops->set_wake_interval != NULL ? t->ops->set_wake_interval(t->ctx, interval_ms) : ESP_ERR_NOT_SUPPORTED;
+}
@@ -0,0 +1,618 @@
+/**
+ * @file fpr_transport_udp.c
+ * @brief FPR UDP Transport implementation (Linux)
+ *
+ * Two sockets per node: one bound to the multicast group, shared with
+ * every other node on the host, and one unicast socket of its own that
+ * all datagrams are sent from. The unicast socket's address is what other
+ * nodes learn and reply to.
+ *
+ * The I/O task sleeps in epoll_wait() on both sockets and an eventfd that
+ * send() writes when it queues the first frame of a burst. Each wake-up
+ * drains readable sockets with recvmmsg() and the send queue with
+ * sendmmsg(), a batch at a time.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // recvmmsg(), sendmmsg()
+#endif
+
+#include "fpr/fpr_transport_udp.h"
+#include "fpr/fpr_config.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *TAG = "fpr_udp";
+
+#define UDP_MAGIC 0x46505255u       // "FPRU"
+#define UDP_POLL_MS 10              // Longest single epoll wait; the stop flag is checked in between
+#define UDP_DEFAULT_QUEUE_LEN 64
+#define UDP_EPOLL_EVENTS 3          // Group socket, unicast socket, eventfd
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;                         // Network byte order
+    uint8_t src[FPR_TRANSPORT_ADDR_LEN];
+    uint8_t dst[FPR_TRANSPORT_ADDR_LEN];
+} udp_header_t;
+
+typedef struct {
+    uint8_t dst[FPR_TRANSPORT_ADDR_LEN];
+    uint16_t len;
+    uint8_t data[FPR_TRANSPORT_UDP_MTU];
+} udp_frame_t;
+
+typedef struct {
+    uint8_t addr[FPR_TRANSPORT_ADDR_LEN];
+    struct sockaddr_in sin;
+    bool used;
+    bool fixed;                             // From fpr_transport_udp_add_route(), never relearned
+} udp_route_t;
+
+typedef struct {
+    fpr_transport_t transport;              // Handed out to the application
+    uint8_t addr[FPR_TRANSPORT_ADDR_LEN];
+    struct sockaddr_in group;
+    struct in_addr interface;
+    uint16_t unicast_port;
+    uint8_t batch;
+    uint8_t ttl;
+    uint16_t queue_len;
+
+    int group_fd;
+    int unicast_fd;
+    int wake_fd;
+    int epoll_fd;
+    TaskHandle_t task;
+    SemaphoreHandle_t stopped;
+    QueueHandle_t tx_queue;
+    atomic_bool stopping;
+    atomic_bool wake_pending;               // eventfd written, I/O task not yet draining
+    fpr_transport_rx_cb_t rx;
+    fpr_transport_tx_done_cb_t tx_done;
+
+    portMUX_TYPE lock;                      // routes, next_route, stats
+    udp_route_t routes[FPR_TRANSPORT_UDP_MAX_ROUTES];
+    int next_route;                         // Next learned route to evict when full
+    fpr_transport_udp_stats_t stats;
+
+    // Batches, I/O task only
+    struct mmsghdr rx_msgs[FPR_TRANSPORT_UDP_MAX_BATCH];
+    struct iovec rx_iov[FPR_TRANSPORT_UDP_MAX_BATCH];
+    struct sockaddr_in rx_from[FPR_TRANSPORT_UDP_MAX_BATCH];
+    uint8_t rx_buf[FPR_TRANSPORT_UDP_MAX_BATCH][sizeof(udp_header_t) + FPR_TRANSPORT_UDP_MTU];
+    struct mmsghdr tx_msgs[FPR_TRANSPORT_UDP_MAX_BATCH];
+    struct iovec tx_iov[FPR_TRANSPORT_UDP_MAX_BATCH][2];
+    struct sockaddr_in tx_to[FPR_TRANSPORT_UDP_MAX_BATCH];
+    udp_header_t tx_hdr[FPR_TRANSPORT_UDP_MAX_BATCH];
+    udp_frame_t tx[FPR_TRANSPORT_UDP_MAX_BATCH];
+} udp_ctx_t;
+
+static const uint8_t s_broadcast[FPR_TRANSPORT_ADDR_LEN] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+// ========== ROUTES ==========
+
+// Caller holds udp->lock
+static udp_route_t *_route_find(udp_ctx_t *udp, const uint8_t *addr)
+{
+    for (int i = 0; i < FPR_TRANSPORT_UDP_MAX_ROUTES; i++) {
+        if (udp->routes[i].used && memcmp(udp->routes[i].addr, addr, FPR_TRANSPORT_ADDR_LEN) == 0) {
+            return &udp->routes[i];
+        }
+    }
+    return NULL;
+}
+
+// Caller holds udp->lock. A full table gives up its oldest learned route.
+static udp_route_t *_route_claim(udp_ctx_t *udp, const uint8_t *addr)
+{
+    udp_route_t *route = _route_find(udp, addr);
+    if (route != NULL) {
+        return route;
+    }
+    for (int i = 0; i < FPR_TRANSPORT_UDP_MAX_ROUTES; i++) {
+        if (!udp->routes[i].used) {
+            route = &udp->routes[i];
+            break;
+        }
+    }
+    for (int tries = 0; route == NULL && tries < FPR_TRANSPORT_UDP_MAX_ROUTES; tries++) {
+        udp_route_t *candidate = &udp->routes[udp->next_route];
+        udp->next_route = (udp->next_route + 1) % FPR_TRANSPORT_UDP_MAX_ROUTES;
+        if (!candidate->fixed) {
+            route = candidate;
+        }
+    }
+    if (route != NULL) {
+        memset(route, 0, sizeof(*route));
+        memcpy(route->addr, addr, FPR_TRANSPORT_ADDR_LEN);
+        route->used = true;
+    }
+    return route;
+}
+
+static void _route_learn(udp_ctx_t *udp, const uint8_t *addr, const struct sockaddr_in *from)
+{
+    taskENTER_CRITICAL(&udp->lock);
+    udp_route_t *route = _route_claim(udp, addr);
+    if (route != NULL && !route->fixed) {
+        route->sin = *from;
+    }
+    taskEXIT_CRITICAL(&udp->lock);
+}
+
+// Unicast to a known node, everything else to the group
+static void _route_resolve(udp_ctx_t *udp, const uint8_t *dst, struct sockaddr_in *to)
+{
+    *to = udp->group;
+    if (memcmp(dst, s_broadcast, FPR_TRANSPORT_ADDR_LEN) == 0) {
+        return;
+    }
+    taskENTER_CRITICAL(&udp->lock);
+    udp_route_t *route = _route_find(udp, dst);
+    if (route != NULL) {
+        *to = route->sin;
+    }
+    taskEXIT_CRITICAL(&udp->lock);
+}
+
+// ========== I/O TASK ==========
+
+static void _udp_deliver(udp_ctx_t *udp, const uint8_t *buf, size_t len, const struct sockaddr_in *from)
+{
+    udp_header_t hdr;
+    if (len < sizeof(hdr)) {
+        goto drop;
+    }
+    memcpy(&hdr, buf, sizeof(hdr));
+    if (ntohl(hdr.magic) != UDP_MAGIC) {
+        goto drop;
+    }
+    // Our own group datagrams loop back to us
+    if (memcmp(hdr.src, udp->addr, FPR_TRANSPORT_ADDR_LEN) == 0) {
+        goto drop;
+    }
+    // Unicasts for a node we have not heard from yet go to the whole group
+    if (memcmp(hdr.dst, udp->addr, FPR_TRANSPORT_ADDR_LEN) != 0 &&
+        memcmp(hdr.dst, s_broadcast, FPR_TRANSPORT_ADDR_LEN) != 0) {
+        goto drop;
+    }
+
+    _route_learn(udp, hdr.src, from);
+    fpr_transport_rx_cb_t rx = udp->rx;
+    if (rx != NULL) {
+        fpr_transport_rx_info_t info = {
+            .src_addr = hdr.src,
+            .dest_addr = hdr.dst,
+        };
+        rx(&info, buf + sizeof(hdr), (int)(len - sizeof(hdr)));
+    }
+    return;
+
+drop:
+    taskENTER_CRITICAL(&udp->lock);
+    udp->stats.rx_dropped++;
+    taskEXIT_CRITICAL(&udp->lock);
+}
+
+static void _udp_receive(udp_ctx_t *udp, int fd)
+{
+    for (;;) {
+        for (int i = 0; i < udp->batch; i++) {
+            udp->rx_iov[i].iov_base = udp->rx_buf[i];
+            udp->rx_iov[i].iov_len = sizeof(udp->rx_buf[i]);
+            memset(&udp->rx_msgs[i], 0, sizeof(udp->rx_msgs[i]));
+            udp->rx_msgs[i].msg_hdr.msg_iov = &udp->rx_iov[i];
+            udp->rx_msgs[i].msg_hdr.msg_iovlen = 1;
+            udp->rx_msgs[i].msg_hdr.msg_name = &udp->rx_from[i];
+            udp->rx_msgs[i].msg_hdr.msg_namelen = sizeof(udp->rx_from[i]);
+        }
+        int n = recvmmsg(fd, udp->rx_msgs, udp->batch, MSG_DONTWAIT, NULL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                ESP_LOGW(TAG, "recvmmsg failed: %s", strerror(errno));
+            }
+            return;
+        }
+        if (n == 0) {
+            return;
+        }
+
+        taskENTER_CRITICAL(&udp->lock);
+        udp->stats.rx_frames += (uint64_t)n;
+        udp->stats.rx_batches++;
+        taskEXIT_CRITICAL(&udp->lock);
+
+        for (int i = 0; i < n; i++) {
+            _udp_deliver(udp, udp->rx_buf[i], udp->rx_msgs[i].msg_len, &udp->rx_from[i]);
+        }
+        if (n < udp->batch) {
+            return; // Socket drained
+        }
+    }
+}
+
+static void _udp_tx_done(udp_ctx_t *udp, const uint8_t *dst, bool success)
+{
+    fpr_transport_tx_done_cb_t tx_done = udp->tx_done;
+    if (tx_done != NULL) {
+        tx_done(dst, success);
+    }
+}
+
+static void _udp_flush(udp_ctx_t *udp)
+{
+    // Frames queued from here on are either seen below or wake the task again
+    atomic_store(&udp->wake_pending, false);
+
+    for (;;) {
+        int count = 0;
+        while (count < udp->batch && xQueueReceive(udp->tx_queue, &udp->tx[count], 0) == pdTRUE) {
+            udp_frame_t *frame = &udp->tx[count];
+            udp_header_t *hdr = &udp->tx_hdr[count];
+            hdr->magic = htonl(UDP_MAGIC);
+            memcpy(hdr->src, udp->addr, FPR_TRANSPORT_ADDR_LEN);
+            memcpy(hdr->dst, frame->dst, FPR_TRANSPORT_ADDR_LEN);
+            _route_resolve(udp, frame->dst, &udp->tx_to[count]);
+
+            udp->tx_iov[count][0].iov_base = hdr;
+            udp->tx_iov[count][0].iov_len = sizeof(*hdr);
+            udp->tx_iov[count][1].iov_base = frame->data;
+            udp->tx_iov[count][1].iov_len = frame->len;
+            memset(&udp->tx_msgs[count], 0, sizeof(udp->tx_msgs[count]));
+            udp->tx_msgs[count].msg_hdr.msg_iov = udp->tx_iov[count];
+            udp->tx_msgs[count].msg_hdr.msg_iovlen = 2;
+            udp->tx_msgs[count].msg_hdr.msg_name = &udp->tx_to[count];
+            udp->tx_msgs[count].msg_hdr.msg_namelen = sizeof(udp->tx_to[count]);
+            count++;
+        }
+        if (count == 0) {
+            return;
+        }
+
+        int sent = 0;
+        int failed = 0;
+        int calls = 0;
+        while (sent < count) {
+            int n = sendmmsg(udp->unicast_fd, &udp->tx_msgs[sent], (unsigned int)(count - sent), 0);
+            calls++;
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // The first datagram of the rest was refused; report it and go on
+                ESP_LOGD(TAG, "sendmmsg failed: %s", strerror(errno));
+                _udp_tx_done(udp, udp->tx[sent].dst, false);
+                sent++;
+                failed++;
+                continue;
+            }
+            for (int i = sent; i < sent + n; i++) {
+                _udp_tx_done(udp, udp->tx[i].dst, true);
+            }
+            sent += n;
+        }
+
+        taskENTER_CRITICAL(&udp->lock);
+        udp->stats.tx_frames += (uint64_t)(count - failed);
+        udp->stats.tx_failed += (uint64_t)failed;
+        udp->stats.tx_batches += (uint64_t)calls;
+        taskEXIT_CRITICAL(&udp->lock);
+
+        if (count < udp->batch) {
+            return; // Queue drained
+        }
+    }
+}
+
+static void _udp_task(void *arg)
+{
+    udp_ctx_t *udp = (udp_ctx_t *)arg;
+    struct epoll_event events[UDP_EPOLL_EVENTS];
+
+    while (!atomic_load(&udp->stopping)) {
+        int n = epoll_wait(udp->epoll_fd, events, UDP_EPOLL_EVENTS, UDP_POLL_MS);
+        if (n < 0) {
+            // The FreeRTOS POSIX port interrupts blocking calls on every tick
+            if (errno != EINTR) {
+                ESP_LOGE(TAG, "epoll_wait failed: %s", strerror(errno));
+                vTaskDelay(1);
+            }
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == udp->wake_fd) {
+                uint64_t count;
+                (void)read(fd, &count, sizeof(count));
+            } else {
+                _udp_receive(udp, fd);
+            }
+        }
+        _udp_flush(udp);
+    }
+
+    xSemaphoreGive(udp->stopped);
+    vTaskDelete(NULL);
+}
+
+// ========== OPERATIONS ==========
+
+static void _udp_close(udp_ctx_t *udp)
+{
+    int *fds[] = { &udp->epoll_fd, &udp->wake_fd, &udp->unicast_fd, &udp->group_fd };
+    for (size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); i++) {
+        if (*fds[i] >= 0) {
+            close(*fds[i]);
+            *fds[i] = -1;
+        }
+    }
+    if (udp->tx_queue != NULL) {
+        vQueueDelete(udp->tx_queue);
+        udp->tx_queue = NULL;
+    }
+    if (udp->stopped != NULL) {
+        vSemaphoreDelete(udp->stopped);
+        udp->stopped = NULL;
+    }
+}
+
+static esp_err_t _udp_open_sockets(udp_ctx_t *udp)
+{
+    const int on = 1;
+
+    udp->group_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    ESP_RETURN_ON_FALSE(udp->group_fd >= 0, ESP_FAIL, TAG, "Group socket: %s", strerror(errno));
+    setsockopt(udp->group_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(udp->group_fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+    // Bound to the group address, so only group datagrams arrive here
+    ESP_RETURN_ON_FALSE(bind(udp->group_fd, (const struct sockaddr *)&udp->group, sizeof(udp->group)) == 0, ESP_FAIL,
+                        TAG, "Bind to group port %u: %s", ntohs(udp->group.sin_port), strerror(errno));
+    struct ip_mreq mreq = { .imr_multiaddr = udp->group.sin_addr, .imr_interface = udp->interface };
+    ESP_RETURN_ON_FALSE(setsockopt(udp->group_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == 0, ESP_FAIL,
+                        TAG, "Join group: %s", strerror(errno));
+
+    udp->unicast_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    ESP_RETURN_ON_FALSE(udp->unicast_fd >= 0, ESP_FAIL, TAG, "Unicast socket: %s", strerror(errno));
+    struct sockaddr_in local = {
+        .sin_family = AF_INET,
+        .sin_port = htons(udp->unicast_port),
+        .sin_addr = udp->interface,
+    };
+    ESP_RETURN_ON_FALSE(bind(udp->unicast_fd, (const struct sockaddr *)&local, sizeof(local)) == 0, ESP_FAIL,
+                        TAG, "Bind to unicast port %u: %s", udp->unicast_port, strerror(errno));
+    int ttl = udp->ttl;
+    setsockopt(udp->unicast_fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    // Other nodes on this host are reached through loopback
+    setsockopt(udp->unicast_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &on, sizeof(on));
+    if (udp->interface.s_addr != htonl(INADDR_ANY)) {
+        setsockopt(udp->unicast_fd, IPPROTO_IP, IP_MULTICAST_IF, &udp->interface, sizeof(udp->interface));
+    }
+
+    udp->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ESP_RETURN_ON_FALSE(udp->wake_fd >= 0, ESP_FAIL, TAG, "eventfd: %s", strerror(errno));
+    udp->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    ESP_RETURN_ON_FALSE(udp->epoll_fd >= 0, ESP_FAIL, TAG, "epoll_create1: %s", strerror(errno));
+    const int watched[] = { udp->group_fd, udp->unicast_fd, udp->wake_fd };
+    for (size_t i = 0; i < sizeof(watched) / sizeof(watched[0]); i++) {
+        struct epoll_event ev = { .events = EPOLLIN, .data.fd = watched[i] };
+        ESP_RETURN_ON_FALSE(epoll_ctl(udp->epoll_fd, EPOLL_CTL_ADD, watched[i], &ev) == 0, ESP_FAIL,
+                            TAG, "epoll_ctl: %s", strerror(errno));
+    }
+    return ESP_OK;
+}
+
+static esp_err_t _udp_init(void *ctx)
+{
+    udp_ctx_t *udp = (udp_ctx_t *)ctx;
+    ESP_RETURN_ON_FALSE(udp->task == NULL, ESP_ERR_INVALID_STATE, TAG, "Already started");
+
+    udp->group_fd = udp->unicast_fd = udp->wake_fd = udp->epoll_fd = -1;
+    atomic_store(&udp->stopping, false);
+    atomic_store(&udp->wake_pending, false);
+
+    esp_err_t err = _udp_open_sockets(udp);
+    if (err == ESP_OK) {
+        udp->tx_queue = xQueueCreate(udp->queue_len, sizeof(udp_frame_t));
+        udp->stopped = xSemaphoreCreateBinary();
+        if (udp->tx_queue == NULL || udp->stopped == NULL) {
+            err = ESP_ERR_NO_MEM;
+        }
+    }
+    if (err == ESP_OK && xTaskCreate(_udp_task, "FPR_UDP", FPR_TASK_STACK_SIZE, udp, FPR_TASK_PRIORITY, &udp->task) != pdPASS) {
+        udp->task = NULL;
+        err = ESP_ERR_NO_MEM;
+    }
+    if (err != ESP_OK) {
+        _udp_close(udp);
+        return err;
+    }
+
+    struct sockaddr_in local;
+    socklen_t local_len = sizeof(local);
+    getsockname(udp->unicast_fd, (struct sockaddr *)&local, &local_len);
+    char group[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &udp->group.sin_addr, group, sizeof(group));
+    ESP_LOGI(TAG, "UDP transport on group %s:%u, unicast port %u, batch %u", group, ntohs(udp->group.sin_port),
+             ntohs(local.sin_port), udp->batch);
+    return ESP_OK;
+}
+
+static esp_err_t _udp_deinit(void *ctx)
+{
+    udp_ctx_t *udp = (udp_ctx_t *)ctx;
+    if (udp->task == NULL) {
+        return ESP_OK;
+    }
+    atomic_store(&udp->stopping, true);
+    const uint64_t one = 1;
+    (void)write(udp->wake_fd, &one, sizeof(one));
+    xSemaphoreTake(udp->stopped, portMAX_DELAY);
+    udp->task = NULL;
+    udp->rx = NULL;
+    udp->tx_done = NULL;
+    _udp_close(udp);
+    return ESP_OK;
+}
+
+static esp_err_t _udp_set_callbacks(void *ctx, fpr_transport_rx_cb_t rx, fpr_transport_tx_done_cb_t tx_done)
+{
+    udp_ctx_t *udp = (udp_ctx_t *)ctx;
+    udp->rx = rx;
+    udp->tx_done = tx_done;
+    return ESP_OK;
+}
+
+static esp_err_t _udp_send(void *ctx, const uint8_t *dest_addr, const uint8_t *data, size_t len)
+{
+    udp_ctx_t *udp = (udp_ctx_t *)ctx;
+    if (len > FPR_TRANSPORT_UDP_MTU) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (udp->task == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    udp_frame_t frame;
+    memcpy(frame.dst, dest_addr, FPR_TRANSPORT_ADDR_LEN);
+    frame.len = (uint16_t)len;
+    memcpy(frame.data, data, len);
+    if (xQueueSend(udp->tx_queue, &frame, 0) != pdTRUE) {
+        return ESP_ERR_NO_MEM;
+    }
+    // One eventfd write per burst; the task clears the flag before draining
+    if (!atomic_exchange(&udp->wake_pending, true)) {
+        const uint64_t one = 1;
+        (void)write(udp->wake_fd, &one, sizeof(one));
+    }
+    return ESP_OK;
+}
+
+static size_t _udp_mtu(void *ctx)
+{
+    (void)ctx;
+    return FPR_TRANSPORT_UDP_MTU;
+}
+
+static esp_err_t _udp_get_addr(void *ctx, uint8_t addr[FPR_TRANSPORT_ADDR_LEN])
+{
+    udp_ctx_t *udp = (udp_ctx_t *)ctx;
+    memcpy(addr, udp->addr, FPR_TRANSPORT_ADDR_LEN);
+    return ESP_OK;
+}
+
+// No peer table: any node in the group is reachable, and keys are not used
+static const fpr_transport_ops_t s_udp_ops = {
+    .name = "udp",
+    .init = _udp_init,
+    .deinit = _udp_deinit,
+    .set_callbacks = _udp_set_callbacks,
+    .send = _udp_send,
+    .mtu = _udp_mtu,
+    .get_addr = _udp_get_addr,
+};
+
+// ========== PUBLIC API ==========
+
+esp_err_t fpr_transport_udp_create(const fpr_transport_udp_config_t *config, fpr_transport_t **transport)
+{
+    ESP_RETURN_ON_FALSE(config != NULL && transport != NULL, ESP_ERR_INVALID_ARG, TAG, "Config or transport is NULL");
+
+    struct in_addr group;
+    const char *group_str = config->group != NULL ? config->group : FPR_TRANSPORT_UDP_DEFAULT_GROUP;
+    ESP_RETURN_ON_FALSE(inet_pton(AF_INET, group_str, &group) == 1 && IN_MULTICAST(ntohl(group.s_addr)),
+                        ESP_ERR_INVALID_ARG, TAG, "Not an IPv4 multicast group: %s", group_str);
+    struct in_addr interface = { .s_addr = htonl(INADDR_ANY) };
+    ESP_RETURN_ON_FALSE(config->interface == NULL || inet_pton(AF_INET, config->interface, &interface) == 1,
+                        ESP_ERR_INVALID_ARG, TAG, "Not an IPv4 address: %s", config->interface);
+    ESP_RETURN_ON_FALSE(config->batch <= FPR_TRANSPORT_UDP_MAX_BATCH, ESP_ERR_INVALID_ARG, TAG,
+                        "Batch above %d", FPR_TRANSPORT_UDP_MAX_BATCH);
+
+    udp_ctx_t *udp = calloc(1, sizeof(udp_ctx_t));
+    ESP_RETURN_ON_FALSE(udp != NULL, ESP_ERR_NO_MEM, TAG, "No memory for the UDP transport");
+
+    memcpy(udp->addr, config->addr, FPR_TRANSPORT_ADDR_LEN);
+    udp->group.sin_family = AF_INET;
+    udp->group.sin_port = htons(config->port != 0 ? config->port : FPR_TRANSPORT_UDP_DEFAULT_PORT);
+    udp->group.sin_addr = group;
+    udp->interface = interface;
+    udp->unicast_port = config->unicast_port;
+    udp->batch = config->batch != 0 ? config->batch : FPR_TRANSPORT_UDP_MAX_BATCH;
+    udp->ttl = config->ttl != 0 ? config->ttl : 1;
+    udp->queue_len = config->queue_len != 0 ? config->queue_len : UDP_DEFAULT_QUEUE_LEN;
+    portMUX_INITIALIZE(&udp->lock);
+    udp->group_fd = udp->unicast_fd = udp->wake_fd = udp->epoll_fd = -1;
+    udp->transport.ops = &s_udp_ops;
+    udp->transport.ctx = udp;
+
+    *transport = &udp->transport;
+    return ESP_OK;
+}
+
+void fpr_transport_udp_destroy(fpr_transport_t *transport)
+{
+    if (transport == NULL || transport->ops != &s_udp_ops) {
+        return;
+    }
+    if (fpr_transport_get() == transport) {
+        ESP_LOGE(TAG, "Transport still in use; call fpr_transport_set(NULL) first");
+        return;
+    }
+    udp_ctx_t *udp = (udp_ctx_t *)transport->ctx;
+    _udp_deinit(udp);
+    free(udp);
+}
+
+esp_err_t fpr_transport_udp_add_route(fpr_transport_t *transport, const uint8_t addr[FPR_TRANSPORT_ADDR_LEN],
+                                      const char *ip, uint16_t port)
+{
+    ESP_RETURN_ON_FALSE(transport != NULL && transport->ops == &s_udp_ops && addr != NULL && ip != NULL,
+                        ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+    struct sockaddr_in sin = { .sin_family = AF_INET, .sin_port = htons(port) };
+    ESP_RETURN_ON_FALSE(inet_pton(AF_INET, ip, &sin.sin_addr) == 1, ESP_ERR_INVALID_ARG, TAG, "Not an IPv4 address: %s", ip);
+
+    udp_ctx_t *udp = (udp_ctx_t *)transport->ctx;
+    taskENTER_CRITICAL(&udp->lock);
+    udp_route_t *route = _route_claim(udp, addr);
+    if (route != NULL) {
+        route->sin = sin;
+        route->fixed = true;
+    }
+    taskEXIT_CRITICAL(&udp->lock);
+    ESP_RETURN_ON_FALSE(route != NULL, ESP_ERR_NO_MEM, TAG, "All %d routes are fixed", FPR_TRANSPORT_UDP_MAX_ROUTES);
+    return ESP_OK;
+}
+
+void fpr_transport_udp_get_stats(const fpr_transport_t *transport, fpr_transport_udp_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    if (transport == NULL || transport->ops != &s_udp_ops) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    udp_ctx_t *udp = (udp_ctx_t *)transport->ctx;
+    taskENTER_CRITICAL(&udp->lock);
+    *stats = udp->stats;
+    taskEXIT_CRITICAL(&udp->lock);
+}
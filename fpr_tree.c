@@ -0,0 +1,499 @@
+/**
+ * @file fpr_tree.c
+ * @brief FPR Collection Tree Routing implementation
+ *
+ * Sink: broadcasts cost-0 beacons and delivers tree data to the application.
+ * Node (extender): keeps a small neighbor table with a delivery ratio
+ * estimate per neighbor, picks the parent with the lowest path cost, and
+ * passes data from children and from fpr_tree_send() to that parent.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_tree.h"
+#include "fpr/fpr_lts.h"
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/scheduler.h"
+#include "esp_check.h"
+#include "esp_log.h"
+
+static const char *TAG = "fpr_tree";
+
+#define TREE fpr_net.tree
+
+// Delivery ratio estimate: exponential average with weight 1/8
+#define PRR_FULL 1000
+#define PRR_MIN 50
+#define PRR_MAX_GAP 8
+
+extern esp_err_t fpr_network_broadcast(void *data, int size, fpr_package_id_t package_id);
+
+static bool _is_router(void)
+{
+    return fpr_net.current_mode == FPR_MODE_EXTENDER;
+}
+
+static void _prr_update(fpr_tree_neighbor_t *n, bool success)
+{
+    n->prr_x1000 = (uint16_t)((n->prr_x1000 * 7 + (success ? PRR_FULL : 0)) / 8);
+}
+
+// ETX x10 of the link to a neighbor
+static uint16_t _link_cost(const fpr_tree_neighbor_t *n)
+{
+    uint16_t prr = n->prr_x1000 < PRR_MIN ? PRR_MIN : n->prr_x1000;
+    return (uint16_t)(10 * PRR_FULL / prr);
+}
+
+static uint16_t _path_cost(const fpr_tree_neighbor_t *n)
+{
+    if (n->cost == FPR_TREE_COST_INFINITE || n->rssi < FPR_TREE_MIN_RSSI) {
+        return FPR_TREE_COST_INFINITE;
+    }
+    uint32_t cost = (uint32_t)n->cost + _link_cost(n);
+    return cost >= FPR_TREE_COST_INFINITE ? FPR_TREE_COST_INFINITE - 1 : (uint16_t)cost;
+}
+
+// Must be called with the lock held
+static fpr_tree_neighbor_t *_find(const uint8_t *mac)
+{
+    for (int i = 0; i < FPR_TREE_MAX_NEIGHBORS; i++) {
+        if (TREE.neighbors[i].in_use && memcmp(TREE.neighbors[i].mac, mac, MAC_ADDRESS_LENGTH) == 0) {
+            return &TREE.neighbors[i];
+        }
+    }
+    return NULL;
+}
+
+// Must be called with the lock held. Returns true if the parent or the
+// reachability of the sink changed, which neighbors should hear about soon.
+static bool _select_parent(int64_t now_us)
+{
+    const int64_t timeout_us = (int64_t)FPR_TREE_NEIGHBOR_TIMEOUT_MS * 1000;
+    for (int i = 0; i < FPR_TREE_MAX_NEIGHBORS; i++) {
+        fpr_tree_neighbor_t *n = &TREE.neighbors[i];
+        if (n->in_use && now_us - n->last_heard_us > timeout_us) {
+            n->in_use = false;
+            if (TREE.parent == i) {
+                TREE.parent = -1;
+            }
+        }
+    }
+    if (TREE.is_sink) {
+        TREE.cost = 0;
+        return false;
+    }
+
+    int best = -1;
+    uint16_t best_cost = FPR_TREE_COST_INFINITE;
+    for (int i = 0; i < FPR_TREE_MAX_NEIGHBORS; i++) {
+        if (!TREE.neighbors[i].in_use) {
+            continue;
+        }
+        uint16_t cost = _path_cost(&TREE.neighbors[i]);
+        if (cost < best_cost) {
+            best = i;
+            best_cost = cost;
+        }
+    }
+
+    int8_t old_parent = TREE.parent;
+    uint16_t old_cost = TREE.cost;
+    uint16_t current_cost = TREE.parent >= 0 ? _path_cost(&TREE.neighbors[TREE.parent]) : FPR_TREE_COST_INFINITE;
+    if (current_cost == FPR_TREE_COST_INFINITE ||
+        (best >= 0 && best != TREE.parent && (uint32_t)best_cost + FPR_TREE_SWITCH_THRESHOLD < current_cost)) {
+        TREE.parent = (int8_t)best;
+        current_cost = best_cost;
+    }
+    TREE.cost = TREE.parent >= 0 ? current_cost : FPR_TREE_COST_INFINITE;
+
+    if (TREE.parent != old_parent) {
+        TREE.stats.parent_changes++;
+        #if (FPR_DEBUG == 1)
+        if (TREE.parent >= 0) {
+            ESP_LOGI(TAG, "Parent " MACSTR " (cost %u)", MAC2STR(TREE.neighbors[TREE.parent].mac), TREE.cost);
+        } else {
+            ESP_LOGW(TAG, "Lost parent, sink unreachable");
+        }
+        #endif
+        return true;
+    }
+    return (old_cost == FPR_TREE_COST_INFINITE) != (TREE.cost == FPR_TREE_COST_INFINITE);
+}
+
+static void _send_beacon(void)
+{
+    fpr_tree_frame_t frame = {0};
+    frame.header.kind = FPR_TREE_KIND_BEACON;
+
+    taskENTER_CRITICAL(&TREE.lock);
+    frame.header.cost = TREE.cost;
+    frame.header.seq = ++TREE.beacon_seq;
+    if (TREE.is_sink) {
+        memcpy(frame.header.sink, fpr_net.mac, MAC_ADDRESS_LENGTH);
+    } else if (TREE.parent >= 0) {
+        memcpy(frame.header.sink, TREE.neighbors[TREE.parent].sink, MAC_ADDRESS_LENGTH);
+    }
+    TREE.last_beacon_us = esp_timer_get_time();
+    TREE.stats.beacons_tx++;
+    taskEXIT_CRITICAL(&TREE.lock);
+
+    fpr_network_broadcast(&frame, sizeof(frame.header), FPR_PACKET_ID_TREE);
+}
+
+// Beacon outside the regular period, at most four times per period
+static void _beacon_soon(void)
+{
+    taskENTER_CRITICAL(&TREE.lock);
+    bool due = esp_timer_get_time() - TREE.last_beacon_us >= (int64_t)FPR_TREE_BEACON_INTERVAL_MS * 250;
+    taskEXIT_CRITICAL(&TREE.lock);
+    if (due) {
+        _send_beacon();
+    }
+}
+
+// Must be called with the lock held. Only a sink and a router attached to
+// the tree have anything to beacon; a detached router rejoins on the next
+// beacon it hears.
+static bool _job_needed(void)
+{
+    return TREE.is_sink || (_is_router() && TREE.parent >= 0);
+}
+
+static int64_t _tree_job(int64_t now_us)
+{
+    if (!TREE.ready || (!_is_router() && !TREE.is_sink)) {
+        return 0;
+    }
+    taskENTER_CRITICAL(&TREE.lock);
+    bool changed = _select_parent(now_us);
+    // A node that just lost its parent beacons once more to poison its children
+    bool advertise = TREE.is_sink || TREE.parent >= 0 || changed;
+    bool needed = _job_needed();
+    taskEXIT_CRITICAL(&TREE.lock);
+    if (advertise) {
+        _send_beacon();
+    }
+    return needed ? now_us + (int64_t)FPR_TREE_BEACON_INTERVAL_MS * 1000 : 0;
+}
+
+static void _update_job(void)
+{
+    taskENTER_CRITICAL(&TREE.lock);
+    bool needed = TREE.ready && _job_needed();
+    taskEXIT_CRITICAL(&TREE.lock);
+
+    if (!needed) {
+        _fpr_sched_cancel(FPR_JOB_TREE);
+    } else if (!_fpr_sched_is_armed(FPR_JOB_TREE)) {
+        _fpr_sched_set(FPR_JOB_TREE, _tree_job, esp_timer_get_time() + (int64_t)FPR_TREE_BEACON_INTERVAL_MS * 1000);
+    }
+}
+
+static void _handle_beacon(const esp_now_recv_info_t *esp_now_info, const fpr_tree_header_t *header)
+{
+    int64_t now_us = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&TREE.lock);
+    TREE.stats.beacons_rx++;
+    fpr_tree_neighbor_t *n = _find(esp_now_info->src_addr);
+    if (n == NULL) {
+        // Take a free entry, else the most expensive one that is not the parent
+        int victim = -1;
+        for (int i = 0; i < FPR_TREE_MAX_NEIGHBORS; i++) {
+            if (!TREE.neighbors[i].in_use) {
+                victim = i;
+                break;
+            }
+            if (i != TREE.parent && (victim < 0 || _path_cost(&TREE.neighbors[i]) > _path_cost(&TREE.neighbors[victim]))) {
+                victim = i;
+            }
+        }
+        if (victim >= 0) {
+            n = &TREE.neighbors[victim];
+            memset(n, 0, sizeof(*n));
+            n->in_use = true;
+            memcpy(n->mac, esp_now_info->src_addr, MAC_ADDRESS_LENGTH);
+            n->prr_x1000 = PRR_FULL / 2;
+            n->last_seq = header->seq - 1;
+        }
+    }
+    bool changed = false;
+    if (n != NULL) {
+        uint16_t gap = (uint16_t)(header->seq - n->last_seq);
+        for (uint16_t missed = 1; missed < gap && missed <= PRR_MAX_GAP; missed++) {
+            _prr_update(n, false);
+        }
+        _prr_update(n, true);
+        n->last_seq = header->seq;
+        n->cost = header->cost;
+        memcpy(n->sink, header->sink, MAC_ADDRESS_LENGTH);
+        n->rssi = esp_now_info->rx_ctrl->rssi;
+        n->last_heard_us = now_us;
+        changed = _select_parent(now_us);
+    }
+    taskEXIT_CRITICAL(&TREE.lock);
+
+    if (changed && _is_router()) {
+        _beacon_soon();
+        _update_job();
+    }
+}
+
+static void _deliver(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *package, const fpr_tree_header_t *header)
+{
+    const fpr_tree_frame_t *frame = (const fpr_tree_frame_t *)&package->protocol;
+    if (header->inner_id < 0 || header->payload_len > FPR_TREE_PAYLOAD_SIZE) {
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_MALFORMED, esp_now_info->src_addr, package);
+        return;
+    }
+
+    fpr_package_t report = {0};
+    report.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    report.id = header->inner_id;
+    report.payload_size = header->payload_len;
+    report.sequence_num = package->sequence_num;
+    report.hop_count = package->hop_count;
+    report.max_hops = package->max_hops;
+    report.version = package->version;
+    memcpy(report.origin_mac, package->origin_mac, MAC_ADDRESS_LENGTH);
+    memcpy(report.dest_mac, fpr_net.mac, MAC_ADDRESS_LENGTH);
+    memcpy(&report.protocol, frame->payload, header->payload_len);
+
+    _deliver_as_origin(_get_peer_from_map(esp_now_info->src_addr), &report);
+
+    taskENTER_CRITICAL(&TREE.lock);
+    TREE.stats.delivered++;
+    taskEXIT_CRITICAL(&TREE.lock);
+}
+
+// Stamp our cost on the frame and hand it to the parent
+static esp_err_t _send_up(fpr_package_t *package)
+{
+    uint8_t parent_mac[MAC_ADDRESS_LENGTH];
+
+    taskENTER_CRITICAL(&TREE.lock);
+    bool has_parent = TREE.parent >= 0;
+    if (has_parent) {
+        memcpy(parent_mac, TREE.neighbors[TREE.parent].mac, MAC_ADDRESS_LENGTH);
+        memcpy(package->dest_mac, TREE.neighbors[TREE.parent].sink, MAC_ADDRESS_LENGTH);
+        ((fpr_tree_frame_t *)&package->protocol)->header.cost = TREE.cost;
+    } else {
+        TREE.stats.no_parent++;
+    }
+    taskEXIT_CRITICAL(&TREE.lock);
+    if (!has_parent) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t err = _fpr_radio_send(parent_mac, package);
+    if (err == ESP_OK) {
+        _fpr_stat_add(FPR_STAT_PACKETS_SENT, 1);
+    } else {
+        _fpr_stat_add(FPR_STAT_SEND_FAILURES, 1);
+    }
+    return err;
+}
+
+static void _handle_data(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *package, const fpr_tree_header_t *header)
+{
+    if (TREE.is_sink) {
+        _deliver(esp_now_info, package, header);
+        return;
+    }
+    if (!_is_router()) {
+        return;
+    }
+    if (package->hop_count + 1 >= package->max_hops) {
+        taskENTER_CRITICAL(&TREE.lock);
+        TREE.stats.hop_limit++;
+        taskEXIT_CRITICAL(&TREE.lock);
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_HOP_LIMIT, esp_now_info->src_addr, package);
+        return;
+    }
+
+    // A child must be further from the sink than we are
+    taskENTER_CRITICAL(&TREE.lock);
+    bool loop = header->cost <= TREE.cost && TREE.cost != FPR_TREE_COST_INFINITE;
+    if (loop) {
+        TREE.stats.loops++;
+        fpr_tree_neighbor_t *n = _find(esp_now_info->src_addr);
+        if (n != NULL && TREE.parent >= 0 && n == &TREE.neighbors[TREE.parent]) {
+            // Our parent routes through us: its advertised cost is stale
+            n->cost = FPR_TREE_COST_INFINITE;
+            _select_parent(esp_timer_get_time());
+        }
+    }
+    taskEXIT_CRITICAL(&TREE.lock);
+    if (loop) {
+        #if (FPR_DEBUG == 1)
+        ESP_LOGW(TAG, "Loop detected via " MACSTR " (cost %u <= %u)", MAC2STR(esp_now_info->src_addr), header->cost, TREE.cost);
+        #endif
+        _beacon_soon();
+    }
+
+    fpr_package_t forward = *package;
+    forward.hop_count++;
+    if (_send_up(&forward) == ESP_OK) {
+        _fpr_stat_add(FPR_STAT_PACKETS_FORWARDED, 1);
+        FPR_TRACE(FPR_TRACE_FORWARD, forward.hop_count, esp_now_info->src_addr, &forward);
+        taskENTER_CRITICAL(&TREE.lock);
+        TREE.stats.forwarded++;
+        taskEXIT_CRITICAL(&TREE.lock);
+    } else {
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_NO_ROUTE, esp_now_info->src_addr, package);
+    }
+}
+
+bool _fpr_tree_on_rx(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *package)
+{
+    if (package->id != FPR_PACKET_ID_TREE) {
+        return false;
+    }
+    if (!TREE.ready || package->package_type != FPR_PACKAGE_TYPE_SINGLE) {
+        return true;
+    }
+    const fpr_tree_header_t *header = &((const fpr_tree_frame_t *)&package->protocol)->header;
+    switch (header->kind) {
+        case FPR_TREE_KIND_BEACON:
+            if (!TREE.is_sink && _is_router()) {
+                _handle_beacon(esp_now_info, header);
+            }
+            break;
+        case FPR_TREE_KIND_DATA:
+            if (!is_broadcast_address(esp_now_info->des_addr)) {
+                _handle_data(esp_now_info, package, header);
+            }
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+void _fpr_tree_on_send_status(const uint8_t *mac, bool success)
+{
+    if (!TREE.ready || mac == NULL || is_broadcast_address(mac)) {
+        return;
+    }
+    taskENTER_CRITICAL(&TREE.lock);
+    fpr_tree_neighbor_t *n = _find(mac);
+    if (n != NULL) {
+        _prr_update(n, success);
+    }
+    taskEXIT_CRITICAL(&TREE.lock);
+}
+
+void _fpr_tree_init(void)
+{
+    memset(&TREE, 0, sizeof(TREE));
+    portMUX_INITIALIZE(&TREE.lock);
+    TREE.parent = -1;
+    TREE.cost = FPR_TREE_COST_INFINITE;
+    TREE.ready = true;
+}
+
+void _fpr_tree_deinit(void)
+{
+    TREE.ready = false;
+    _fpr_sched_cancel(FPR_JOB_TREE);
+}
+
+void _fpr_tree_on_mode_set(void)
+{
+    _update_job();
+}
+
+esp_err_t fpr_tree_set_sink(bool enable)
+{
+    ESP_RETURN_ON_FALSE(TREE.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+
+    taskENTER_CRITICAL(&TREE.lock);
+    TREE.is_sink = enable;
+    TREE.parent = -1;
+    TREE.cost = enable ? 0 : FPR_TREE_COST_INFINITE;
+    taskEXIT_CRITICAL(&TREE.lock);
+
+    // Let nodes attach (or detach) without waiting a full period
+    _send_beacon();
+    _update_job();
+    ESP_LOGI(TAG, "Collection tree sink %s", enable ? "enabled" : "disabled");
+    return ESP_OK;
+}
+
+esp_err_t fpr_tree_send(const void *data, size_t size, fpr_package_id_t package_id)
+{
+    ESP_RETURN_ON_FALSE(TREE.ready, ESP_ERR_INVALID_STATE, TAG, "Network not initialized");
+    ESP_RETURN_ON_FALSE(data != NULL || size == 0, ESP_ERR_INVALID_ARG, TAG, "Data cannot be NULL");
+    ESP_RETURN_ON_FALSE(package_id >= 0, ESP_ERR_INVALID_ARG, TAG, "Reserved package ID");
+    ESP_RETURN_ON_FALSE(size <= FPR_TREE_PAYLOAD_SIZE, ESP_ERR_INVALID_SIZE, TAG, "Tree data is limited to %d bytes", (int)FPR_TREE_PAYLOAD_SIZE);
+    ESP_RETURN_ON_FALSE(!TREE.is_sink, ESP_ERR_INVALID_STATE, TAG, "The sink has no parent");
+
+    fpr_package_t package = {0};
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.id = FPR_PACKET_ID_TREE;
+    package.payload_size = (uint16_t)(sizeof(fpr_tree_header_t) + size);
+    package.sequence_num = _fpr_next_sequence_num();
+    memcpy(package.origin_mac, fpr_net.mac, MAC_ADDRESS_LENGTH);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    package.version = FPR_PROTOCOL_VERSION;
+
+    fpr_tree_frame_t *frame = (fpr_tree_frame_t *)&package.protocol;
+    frame->header.kind = FPR_TREE_KIND_DATA;
+    frame->header.inner_id = package_id;
+    frame->header.payload_len = (uint16_t)size;
+    if (size > 0) {
+        memcpy(frame->payload, data, size);
+    }
+
+    esp_err_t err = _send_up(&package);
+    ESP_RETURN_ON_FALSE(err != ESP_ERR_INVALID_STATE, err, TAG, "No parent in the collection tree");
+    if (err == ESP_OK) {
+        taskENTER_CRITICAL(&TREE.lock);
+        TREE.stats.sent++;
+        taskEXIT_CRITICAL(&TREE.lock);
+    }
+    return err;
+}
+
+void fpr_tree_get_info(fpr_tree_info_t *info)
+{
+    if (info == NULL) {
+        return;
+    }
+    memset(info, 0, sizeof(*info));
+    taskENTER_CRITICAL(&TREE.lock);
+    info->is_sink = TREE.is_sink;
+    info->cost = TREE.cost;
+    if (TREE.is_sink) {
+        memcpy(info->sink_mac, fpr_net.mac, MAC_ADDRESS_LENGTH);
+    } else if (TREE.parent >= 0) {
+        const fpr_tree_neighbor_t *parent = &TREE.neighbors[TREE.parent];
+        info->has_parent = true;
+        memcpy(info->parent_mac, parent->mac, MAC_ADDRESS_LENGTH);
+        memcpy(info->sink_mac, parent->sink, MAC_ADDRESS_LENGTH);
+        info->parent_link_cost = _link_cost(parent);
+        info->parent_rssi = parent->rssi;
+    }
+    for (int i = 0; i < FPR_TREE_MAX_NEIGHBORS; i++) {
+        if (TREE.neighbors[i].in_use) {
+            info->neighbors++;
+        }
+    }
+    taskEXIT_CRITICAL(&TREE.lock);
+}
+
+void fpr_tree_get_stats(fpr_tree_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&TREE.lock);
+    *stats = TREE.stats;
+    taskEXIT_CRITICAL(&TREE.lock);
+}
@@ -190,12 +190,14 @@ esp_err_t fpr_network_remove_peer(uint8_t *peer_mac);
  * @param force_restart If true, restarts the task even if already running.
  * @return ESP_OK on success, ESP_ERR_INVALID_STATE if already running and force_restart is false.
  * @note This task handles periodic discovery broadcasts and connection maintenance.
+ * It runs as a job on the FPR service task, which wakes only for the host's
+ * broadcasts and for the end of the loop.
  */
 esp_err_t fpr_network_start_loop_task(TickType_t duration, bool force_restart);
 
 /**
  * @brief Stop the network discovery/maintenance loop task.
- * @return ESP_OK on success, error code otherwise.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if no loop is running.
  */
 esp_err_t fpr_network_stop_loop_task();
 
@@ -345,6 +347,23 @@ void fpr_get_network_stats(fpr_network_stats_t *stats);
  */
 void fpr_reset_network_stats(void);
 
+/**
+ * @brief Copy one peer's counters and histograms (no allocation).
+ * @param peer_mac MAC address of the peer.
+ * @param stats Pointer to structure to fill.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if peer not found.
+ * @note seq_lost counts gaps in the per-link frame counter, so it only
+ * covers frames the peer sent to this node.
+ */
+esp_err_t fpr_network_get_peer_stats(const uint8_t *peer_mac, fpr_peer_stats_t *stats);
+
+/**
+ * @brief Reset one peer's counters and histograms.
+ * @param peer_mac MAC address of the peer.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if peer not found.
+ */
+esp_err_t fpr_network_reset_peer_stats(const uint8_t *peer_mac);
+
 /**
  * @brief Get detailed information about a specific peer.
  * @param peer_mac MAC address of the peer.
@@ -473,6 +492,59 @@ extern esp_err_t fpr_client_disconnect(void);
  */
 extern size_t fpr_client_scan_for_hosts(TickType_t duration);
 
+/**
+ * @brief Actively probe for hosts and return as soon as enough answer (client mode).
+ * 
+ * Broadcasts a probe request every FPR_PROBE_RETRY_INTERVAL_MS. Hosts answer
+ * after a short random delay, and each answer is handled like a host
+ * broadcast (auto mode joins the best host when the selection window closes).
+ * 
+ * @param min_hosts Return once this many distinct hosts answered (1..8).
+ * @param timeout Maximum time to wait.
+ * @return Number of distinct hosts that answered.
+ */
+extern size_t fpr_client_probe_for_hosts(size_t min_hosts, TickType_t timeout);
+
+/**
+ * @brief Keep a second, pre-authenticated host for instant failover (client mode).
+ * 
+ * While connected, the client periodically probes for another host and
+ * completes the handshake with the best one, then only sends it heartbeats
+ * every CONFIG_FPR_STANDBY_HEARTBEAT_MS. When the active host misses
+ * FPR_STANDBY_MAX_MISSED_HEARTBEATS intervals, the standby becomes the
+ * active host: fpr_client_get_host_info() returns it and services
+ * (time sync, TDMA, sleepy, pub/sub) re-attach to it.
+ * 
+ * @param enable true to keep a standby host, false to release it.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not a client in auto mode.
+ */
+extern esp_err_t fpr_client_set_standby(bool enable);
+
+/**
+ * @brief Get hot-standby state and failover statistics (client mode).
+ * @param stats Pointer to structure to fill.
+ */
+extern void fpr_client_get_standby_stats(fpr_standby_stats_t *stats);
+
+/**
+ * @brief Find hosts across several WiFi channels and lock onto the best one (client mode).
+ * 
+ * Probes each channel for CONFIG_FPR_CHANNEL_SCAN_DWELL_MS and keeps the
+ * channel of the strongest host. Answers overheard from adjacent channels
+ * are ignored. In auto mode the client starts connecting once locked.
+ * The sweep runs on the FPR service task one dwell at a time; this call
+ * waits for it to finish.
+ * 
+ * @param channels Channels to sweep, or NULL for 1-13.
+ * @param channel_count Entries in channels (max FPR_CHANNEL_MAX).
+ * @param report Optional per-channel results and total scan time.
+ * @return ESP_OK if a host was found, ESP_ERR_NOT_FOUND if none (original
+ *         channel restored), ESP_ERR_INVALID_STATE if not a disconnected client,
+ *         a sweep is already running, or called from an FPR callback on the
+ *         service task.
+ */
+extern esp_err_t fpr_client_scan_channels(const uint8_t *channels, size_t channel_count, fpr_channel_scan_report_t *report);
+
 /**
  * @brief Wait for and retrieve data from a specific peer (blocking).
  * @param peer_mac MAC address of the peer to receive data from.
@@ -504,6 +576,15 @@ esp_err_t fpr_network_stop_reconnect_task(void);
  */
 bool fpr_network_is_reconnect_task_running(void);
 
+/**
+ * @brief Get wake-up counters of the FPR service task, which runs the loop
+ * and reconnect/keepalive work of both roles.
+ * @param stats Pointer to structure to fill.
+ * @note The task sleeps until a keepalive, timeout, probe or broadcast is
+ * due, or until work is posted to it; last_minute shows how often that is.
+ */
+void fpr_network_get_wakeup_stats(fpr_wakeup_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+/**
+ * @file fpr_aggregate.h
+ * @brief FPR In-Network Aggregation at Extenders
+ *
+ * Telemetry from many sensors converges on one sink, so extenders close to
+ * it forward most of the traffic. With aggregation, an extender holds
+ * reports of a registered package ID for a short window and sends them on
+ * as one merged frame per destination:
+ *
+ * - FPR_AGGREGATE_CONCAT packs the reports (with their origin MAC) into one
+ *   frame. The sink hands each report to the application as if it had
+ *   arrived on its own.
+ * - FPR_AGGREGATE_MIN / MAX / SUM reduce an int32_t at the start of each
+ *   report, FPR_AGGREGATE_COUNT only counts reports, and
+ *   FPR_AGGREGATE_CUSTOM applies a registered reduce function. The sink
+ *   receives a single report holding the result.
+ *
+ * Merged frames are merged again by extenders further up the path, so
+ * airtime near the sink drops roughly with the fan-in.
+ *
+ * Limitations:
+ * - Only single-packet reports are merged; fragmented data passes through
+ * - A custom reduce function must be associative, because partial results
+ *   of different extenders are reduced again
+ * - The sink must be reachable by the extender's route table, like any
+ *   forwarded traffic
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include "fpr/fpr_def.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    FPR_AGGREGATE_CONCAT = 0,   // Pack reports into one frame
+    FPR_AGGREGATE_MIN,          // Smallest int32_t
+    FPR_AGGREGATE_MAX,          // Largest int32_t
+    FPR_AGGREGATE_SUM,          // Sum of int32_t
+    FPR_AGGREGATE_COUNT,        // Number of reports (int32_t)
+    FPR_AGGREGATE_CUSTOM        // Registered reduce function
+} fpr_aggregate_op_t;
+
+/**
+ * @brief Reduce function for FPR_AGGREGATE_CUSTOM.
+ * @param acc Accumulated result, record_size bytes. Holds the first report initially.
+ * @param record Next report or partial result, record_size bytes.
+ * @param record_size Report size.
+ * @note Runs in the ESP-NOW receive context.
+ */
+typedef void (*fpr_aggregate_reduce_t)(void *acc, const void *record, size_t record_size);
+
+/**
+ * @brief Aggregation rule for one package ID.
+ */
+typedef struct {
+    fpr_aggregate_op_t op;
+    uint8_t record_size;            // Report bytes kept (CONCAT, CUSTOM); MIN/MAX/SUM/COUNT use an int32_t
+    uint16_t window_ms;             // Longest time a report is held
+    fpr_aggregate_reduce_t reduce;  // FPR_AGGREGATE_CUSTOM only
+} fpr_aggregate_config_t;
+
+/**
+ * @brief Aggregation statistics.
+ */
+typedef struct {
+    uint32_t reports_in;        // Reports merged, counting those inside merged frames (extender)
+    uint32_t frames_in;         // Frames absorbed into a merge (extender)
+    uint32_t frames_out;        // Merged frames sent (extender)
+    uint32_t ratio_x100;        // reports_in * 100 / frames_out (extender)
+    uint32_t avg_delay_ms;      // Average hold time per merged frame (extender)
+    uint32_t max_delay_ms;      // Longest hold time (extender)
+    uint32_t dropped;           // Merged frames without a route (extender)
+    uint32_t delivered;         // Reports handed to the application (sink)
+    uint32_t sink_max_delay_ms; // Largest hold time added along a path (sink)
+} fpr_aggregate_stats_t;
+
+/**
+ * @brief Merge reports of a package ID while forwarding (extender mode).
+ * @param package_id Application package ID (>= 0).
+ * @param config Aggregation rule.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad rule,
+ * ESP_ERR_NO_MEM if CONFIG_FPR_AGGREGATE_MAX_RULES rules exist.
+ * @note Registering an ID again replaces its rule. Sinks need no registration.
+ */
+esp_err_t fpr_aggregate_register(fpr_package_id_t package_id, const fpr_aggregate_config_t *config);
+
+/**
+ * @brief Stop merging a package ID. Reports already held are sent now.
+ * @param package_id Application package ID.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the ID has no rule.
+ */
+esp_err_t fpr_aggregate_unregister(fpr_package_id_t package_id);
+
+/**
+ * @brief Get aggregation statistics.
+ * @param stats Pointer to structure to fill.
+ */
+void fpr_aggregate_get_stats(fpr_aggregate_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+
+/**
+ * @file fpr_bridge.h
+ * @brief FPR Serial Bridge
+ *
+ * Moves FPR application data between this node and a Linux machine on a
+ * UART (or a USB-UART adapter), typically a host node attached to a
+ * gateway. Every data package the node receives is forwarded to Linux with
+ * its source MAC, and records Linux writes are sent to the addressed peer
+ * or broadcast.
+ *
+ * Records travel in batched, COBS-framed, CRC-checked frames with
+ * window-based flow control (see fpr_bridge_proto.h). The Linux side is
+ * tools/fpr_bridge/fpr_bridge_host.h.
+ *
+ * Flow:
+ * 1. Enable CONFIG_FPR_BRIDGE_ENABLE
+ * 2. fpr_network_init() / fpr_network_start() as usual
+ * 3. fpr_bridge_start(), or fpr_bridge_start_ex() for another instance
+ * 4. The Linux library connects with a HELLO exchange; records flow both
+ *    ways until fpr_bridge_stop()
+ *
+ * Limitations:
+ * - One bridge per device, on one network instance
+ * - Packages of a multi-package send arrive as separate records, marked
+ *   START / CONTINUED / END in fpr_bridge_record_t.fragment
+ * - Records received while Linux is not connected or is behind by more
+ *   than CONFIG_FPR_BRIDGE_QUEUE_LENGTH are dropped and counted
+ * - The application receive callback and peer queues still get the data
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int uart_port;              // uart_port_t
+    int baud_rate;              // 0 = 921600
+    int tx_pin;                 // -1 keeps the current pin
+    int rx_pin;
+    int rts_pin;
+    int cts_pin;
+    bool hw_flow_control;       // RTS/CTS
+    size_t rx_buffer_size;      // UART driver receive buffer, 0 = 8192. Sets the window offered to Linux
+} fpr_bridge_config_t;
+
+#define FPR_BRIDGE_CONFIG_DEFAULT() {   \
+    .uart_port = 1,                     \
+    .baud_rate = 0,                     \
+    .tx_pin = -1,                       \
+    .rx_pin = -1,                       \
+    .rts_pin = -1,                      \
+    .cts_pin = -1,                      \
+    .hw_flow_control = false,           \
+    .rx_buffer_size = 0,                \
+}
+
+typedef struct {
+    uint32_t to_host_records;
+    uint32_t to_host_frames;
+    uint32_t to_host_dropped;   // Queue full or Linux not connected
+    uint32_t from_host_records;
+    uint32_t from_host_frames;
+    uint32_t send_failures;     // Records FPR could not send
+    uint32_t bad_frames;        // CRC or framing errors
+    uint32_t lost_frames;       // Gaps in the DATA sequence from Linux
+} fpr_bridge_stats_t;
+
+/**
+ * @brief Start bridging the default network instance.
+ * @param config UART configuration.
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already running,
+ * ESP_ERR_NOT_SUPPORTED without CONFIG_FPR_BRIDGE_ENABLE, or a UART driver error.
+ */
+esp_err_t fpr_bridge_start(const fpr_bridge_config_t *config);
+
+/**
+ * @brief Stop the bridge and release the UART driver.
+ */
+esp_err_t fpr_bridge_stop(void);
+
+/**
+ * @brief Check whether Linux has completed the HELLO exchange.
+ */
+bool fpr_bridge_is_connected(void);
+
+/**
+ * @brief Copy the bridge counters since fpr_bridge_start().
+ */
+void fpr_bridge_get_stats(fpr_bridge_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
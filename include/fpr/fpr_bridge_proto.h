@@ -0,0 +1,103 @@
+#pragma once
+
+/**
+ * @file fpr_bridge_proto.h
+ * @brief FPR Serial Bridge wire format
+ *
+ * Shared by the device (fpr_bridge.c) and the Linux host library
+ * (tools/fpr_bridge). Plain C, no ESP-IDF dependencies.
+ *
+ * A frame on the wire is COBS-encoded and ends with one 0x00 byte, so a
+ * reader resynchronizes at the next zero after any corruption. Decoded,
+ * a frame is:
+ *
+ *     fpr_bridge_frame_header_t | body | CRC-16/CCITT-FALSE (little endian)
+ *
+ * HELLO frames carry an fpr_bridge_hello_t. DATA frames carry `count`
+ * records, each an fpr_bridge_record_t followed by its data. ACK frames
+ * have no body. All fields are little endian.
+ *
+ * Flow control: each side announces in HELLO how many DATA frames it can
+ * hold unreleased (window). DATA frames are numbered from 1 after a HELLO,
+ * and every frame's `ack` is the last DATA sequence number its sender has
+ * released. A side only sends DATA while fewer than the peer's window are
+ * unacknowledged. A HELLO without FPR_BRIDGE_HELLO_REPLY means the sender
+ * (re)started: the receiver resets both directions and answers with a
+ * HELLO that has the flag set.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FPR_BRIDGE_PROTO_VERSION 1
+#define FPR_BRIDGE_MAX_FRAME 1024               // Decoded frame, header to CRC
+#define FPR_BRIDGE_CRC_LEN 2
+#define FPR_BRIDGE_HELLO_REPLY 0x01
+
+/**
+ * @brief Largest wire size of a decoded frame of n bytes, delimiter included.
+ */
+#define FPR_BRIDGE_WIRE_MAX(n) ((n) + (n) / 254 + 2)
+
+typedef enum {
+    FPR_BRIDGE_FRAME_HELLO = 1,
+    FPR_BRIDGE_FRAME_DATA = 2,
+    FPR_BRIDGE_FRAME_ACK = 3,
+} fpr_bridge_frame_type_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t type;               // fpr_bridge_frame_type_t
+    uint8_t count;              // DATA: records in the frame
+    uint16_t seq;               // DATA: sequence number, otherwise 0
+    uint16_t ack;               // Last DATA sequence number released by the sender
+} fpr_bridge_frame_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t version;            // FPR_BRIDGE_PROTO_VERSION
+    uint8_t flags;              // FPR_BRIDGE_HELLO_*
+    uint8_t window;             // DATA frames the sender holds unreleased
+    uint8_t reserved;
+    uint16_t max_frame;         // Largest decoded frame the sender accepts
+} fpr_bridge_hello_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t addr[6];            // Device to host: source peer. Host to device: destination, FF:FF:FF:FF:FF:FF broadcasts
+    uint8_t id;                 // fpr_package_id_t
+    uint8_t fragment;           // Device to host: fpr_package_type_t of the package
+    uint16_t len;               // Data bytes that follow
+} fpr_bridge_record_t;
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF).
+ */
+uint16_t fpr_bridge_crc16(const uint8_t *data, size_t len);
+
+/**
+ * @brief Add the CRC to a decoded frame and encode it for the wire.
+ * @param frame Header and body; FPR_BRIDGE_CRC_LEN bytes after len are
+ * overwritten with the CRC.
+ * @param len Header and body length.
+ * @param out At least FPR_BRIDGE_WIRE_MAX(len + FPR_BRIDGE_CRC_LEN) bytes.
+ * @return Bytes written to out, delimiter included.
+ */
+size_t fpr_bridge_frame_seal(uint8_t *frame, size_t len, uint8_t *out);
+
+/**
+ * @brief Decode a frame in place and check its CRC.
+ * @param buf Wire bytes up to, not including, the 0x00 delimiter.
+ * @param len Their length.
+ * @return Header and body length now at buf, or -1 for a bad frame.
+ */
+int fpr_bridge_frame_open(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
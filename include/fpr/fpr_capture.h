@@ -0,0 +1,108 @@
+#pragma once
+
+/**
+ * @file fpr_capture.h
+ * @brief FPR Packet Capture (pcap)
+ *
+ * Records every FPR frame sent or received by this node, with radio
+ * metadata, as a pcap stream that Wireshark opens directly.
+ *
+ * Flow:
+ * 1. Enable CONFIG_FPR_CAPTURE_ENABLE
+ * 2. Call fpr_capture_start() with a byte sink (a file, a UART, a socket),
+ *    or fpr_capture_start_console() to stream over the serial console
+ * 3. The sink receives a pcap global header, then one record per frame
+ * 4. Open the file in Wireshark with tools/wireshark/fpr.lua loaded. A
+ *    console stream is first turned into a file with tools/fpr_capture.py
+ *
+ * Each pcap packet (link type USER1, 148) is an fpr_capture_header_t
+ * followed by the frame exactly as it went over the air. Timestamps are
+ * esp_timer_get_time(), i.e. time since boot.
+ *
+ * Limitations:
+ * - The sink runs on the sending task or the Wi-Fi receive task, so a slow
+ *   sink slows the data path. The console sink prints about 500 characters
+ *   per frame and is only for low rates
+ * - Frames arriving while another task is inside the sink for more than a
+ *   few milliseconds are not captured; see fpr_capture_stats_t.skipped
+ * - Transmit RSSI is 0 and the transmit channel is read back from the driver
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FPR_CAPTURE_LINKTYPE 148    // LINKTYPE_USER1
+#define FPR_CAPTURE_VERSION 1
+
+/**
+ * @brief Direction of a captured frame.
+ */
+typedef enum {
+    FPR_CAPTURE_RX = 0,
+    FPR_CAPTURE_TX = 1,
+} fpr_capture_direction_t;
+
+/**
+ * @brief Metadata in front of every captured frame.
+ */
+typedef struct {
+    uint8_t version;            // FPR_CAPTURE_VERSION
+    uint8_t direction;          // fpr_capture_direction_t
+    int8_t rssi;                // dBm (receive only)
+    uint8_t channel;            // Wi-Fi channel
+    uint8_t src[6];             // Radio source address
+    uint8_t dst[6];             // Radio destination address
+} fpr_capture_header_t;
+
+/**
+ * @brief Capture counters since the last fpr_capture_start().
+ */
+typedef struct {
+    uint32_t captured;          // Frames written to the sink
+    uint32_t skipped;           // Frames lost because the sink was busy or failed
+} fpr_capture_stats_t;
+
+/**
+ * @brief Byte sink for captured data.
+ * @return ESP_OK to continue; anything else stops the capture.
+ */
+typedef esp_err_t (*fpr_capture_write_fn_t)(const void *data, size_t size, void *ctx);
+
+/**
+ * @brief Start capturing into a sink. Writes the pcap global header first.
+ * @param write Sink, e.g. a wrapper around fwrite() or uart_write_bytes().
+ * @param ctx Passed to write.
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if a capture is running,
+ * ESP_ERR_NOT_SUPPORTED if capture is compiled out.
+ */
+esp_err_t fpr_capture_start(fpr_capture_write_fn_t write, void *ctx);
+
+/**
+ * @brief Start capturing to the console as hex lines prefixed "FPRC ".
+ * @return Same as fpr_capture_start().
+ */
+esp_err_t fpr_capture_start_console(void);
+
+/**
+ * @brief Stop capturing. The sink is not called after this returns.
+ */
+void fpr_capture_stop(void);
+
+/**
+ * @brief Get capture counters.
+ * @param stats Pointer to structure to fill.
+ */
+void fpr_capture_get_stats(fpr_capture_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,102 @@
+#pragma once
+
+/**
+ * @file fpr_channel.h
+ * @brief FPR Coordinated Channel Migration
+ *
+ * Moves a live network to a less congested WiFi channel. The host keeps
+ * per-window channel quality figures: transmit failures reported by the
+ * transport's send callback, transport-full (ESP_ERR_ESPNOW_NO_MEM) events,
+ * and RSSI and noise floor from received frames. When the current channel stays congested,
+ * the host picks the candidate channel with the best recorded quality
+ * (channels it has not tried yet count as clean).
+ *
+ * Flow:
+ * 1. Host announces the target channel and the time left until the switch
+ *    in its beacons (sent every FPR_CHANNEL_SWITCH_DELAY_MS / 5 meanwhile)
+ * 2. Host and clients switch at the same instant
+ * 3. The host measures downtime until every client is heard again
+ * 4. Clients that missed the announcement lose their host and, with
+ *    CONFIG_FPR_CHANNEL_RESCAN_ON_LOSS, find it again with a channel scan
+ *
+ * Limitations:
+ * - Quality of a channel is only known after the network has used it
+ * - Transmit failures are taken from FPR's ESP-NOW send callback; they are
+ *   not seen if the application registers its own
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Host channel monitoring configuration.
+ */
+typedef struct {
+    uint8_t candidates[14];     // Channels the network may move to
+    uint8_t candidate_count;    // 0 = channels 1, 6 and 11
+    uint8_t max_failure_pct;    // Transmit failure rate that marks a window congested
+    int8_t max_noise_dbm;       // Average noise floor that marks a window congested
+    uint8_t bad_windows;        // Consecutive congested windows before migrating (>= 1)
+} fpr_channel_config_t;
+
+/**
+ * @brief Channel quality and migration status.
+ */
+typedef struct {
+    bool monitoring;            // Host is evaluating its channel
+    uint8_t channel;            // Current channel
+    uint8_t pending_channel;    // Announced target, 0 if none
+    uint8_t failure_pct;        // Transmit failure rate in the last window
+    uint32_t no_mem;            // NO_MEM send errors in the last window
+    int8_t avg_rssi;            // Average RSSI in the last window
+    int8_t avg_noise;           // Average noise floor in the last window
+    uint8_t congested_windows;  // Consecutive congested windows so far
+    uint32_t migrations;        // Completed channel switches
+    uint32_t last_downtime_ms;  // Host: until the last client returned. Client: until the host was heard.
+    uint32_t clients_lost;      // Host: clients that did not return after a switch
+} fpr_channel_status_t;
+
+/**
+ * @brief Get the default monitoring configuration.
+ * @return Channels 1/6/11, 30 % failures or -75 dBm noise, 3 windows.
+ */
+fpr_channel_config_t fpr_channel_default_config(void);
+
+/**
+ * @brief Start channel quality monitoring (host mode).
+ * @param config Configuration (NULL for defaults).
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not in host mode.
+ */
+esp_err_t fpr_channel_monitor_start(const fpr_channel_config_t *config);
+
+/**
+ * @brief Stop channel quality monitoring (host mode). A switch already
+ * announced still happens.
+ * @return ESP_OK on success.
+ */
+esp_err_t fpr_channel_monitor_stop(void);
+
+/**
+ * @brief Move the network to a channel now (host mode).
+ * @param channel Target channel (1-14).
+ * @return ESP_OK if announced, ESP_ERR_INVALID_STATE if a switch is already pending.
+ */
+esp_err_t fpr_channel_migrate(uint8_t channel);
+
+/**
+ * @brief Get channel quality and migration status.
+ * @param status Pointer to structure to fill.
+ */
+void fpr_channel_get_status(fpr_channel_status_t *status);
+
+#ifdef __cplusplus
+}
+#endif
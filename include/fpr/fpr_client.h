@@ -59,16 +59,32 @@ void _handle_client_discovery(const esp_now_recv_info_t *esp_now_info, const uin
 void _find_host_callback(void *key, void *value, void *user_data);
 
 /**
- * @brief Background task for client reconnection/keepalive
+ * @brief Client reconnection/keepalive job for the FPR service task
  * 
- * @warning Internal function - started via fpr_network_start_reconnect_task().
+ * @warning Internal function - armed via fpr_network_start_reconnect_task().
  * 
  * Monitors connection state and attempts reconnection if disconnected.
  * Also sends periodic keepalives to maintain connection.
  * 
- * @param arg Task arguments (unused)
+ * @param now_us Current time (esp_timer_get_time())
+ * @return Time of the next run: the next keepalive or host timeout while
+ * connected, the next probe while not
  */
-void _fpr_client_reconnect_task(void *arg);
+int64_t _fpr_client_reconnect_job(int64_t now_us);
+
+/**
+ * @brief Initialize host selection state (selection window timer).
+ * 
+ * @warning Internal function - called from fpr_network_init_ex().
+ */
+void _fpr_host_select_init(void);
+
+/**
+ * @brief Release host selection state.
+ * 
+ * @warning Internal function - called from fpr_network_deinit().
+ */
+void _fpr_host_select_deinit(void);
 
 #ifdef __cplusplus
 }
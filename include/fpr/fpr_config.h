@@ -29,6 +29,9 @@
 #else
 #define FPR_WIFI_CHANNEL CONFIG_FPR_WIFI_CHANNEL
 #endif
+#define FPR_CHANNEL_SCAN_DWELL_MS CONFIG_FPR_CHANNEL_SCAN_DWELL_MS
+#define FPR_STANDBY_HEARTBEAT_MS CONFIG_FPR_STANDBY_HEARTBEAT_MS
+#define FPR_STANDBY_ACQUIRE_INTERVAL_MS CONFIG_FPR_STANDBY_ACQUIRE_INTERVAL_MS
 
 // Power management - uses numeric values to avoid circular dependency with fpr_def.h
 // 0 = FPR_POWER_NORMAL, 1 = FPR_POWER_LOW
@@ -58,8 +61,99 @@
 #define FPR_MANUAL_CONNECT_RETRY_INTERVAL_MS CONFIG_FPR_MANUAL_CONNECT_RETRY_INTERVAL_MS
 #define FPR_HOST_SCAN_BROADCAST_INTERVAL_MS CONFIG_FPR_HOST_SCAN_BROADCAST_INTERVAL_MS
 #define FPR_HOST_SCAN_POLL_INTERVAL_MS CONFIG_FPR_HOST_SCAN_POLL_INTERVAL_MS
+#define FPR_PROBE_RETRY_INTERVAL_MS CONFIG_FPR_PROBE_RETRY_INTERVAL_MS
+#define FPR_PROBE_RESPONSE_JITTER_MS CONFIG_FPR_PROBE_RESPONSE_JITTER_MS
+#define FPR_HOST_SELECT_WINDOW_MS CONFIG_FPR_HOST_SELECT_WINDOW_MS
+#define FPR_HOST_SELECT_LOAD_WEIGHT CONFIG_FPR_HOST_SELECT_LOAD_WEIGHT
+#define FPR_HOST_REBALANCE_INTERVAL_MS CONFIG_FPR_HOST_REBALANCE_INTERVAL_MS
+#define FPR_HOST_REBALANCE_MARGIN CONFIG_FPR_HOST_REBALANCE_MARGIN
 #define FPR_RECONNECT_TIMEOUT_MS CONFIG_FPR_RECONNECT_TIMEOUT_MS
 #define FPR_KEEPALIVE_INTERVAL_MS CONFIG_FPR_KEEPALIVE_INTERVAL_MS
+#define FPR_RPC_MAX_PENDING CONFIG_FPR_RPC_MAX_PENDING
+#define FPR_RPC_MAX_HANDLERS CONFIG_FPR_RPC_MAX_HANDLERS
+#define FPR_RPC_WHEEL_TICK_MS CONFIG_FPR_RPC_WHEEL_TICK_MS
+#define FPR_PUBSUB_MAX_TOPICS CONFIG_FPR_PUBSUB_MAX_TOPICS
+#define FPR_PUBSUB_MAX_SUBSCRIPTIONS CONFIG_FPR_PUBSUB_MAX_SUBSCRIPTIONS
+#define FPR_TIMESYNC_INTERVAL_MS CONFIG_FPR_TIMESYNC_INTERVAL_MS
+#define FPR_TIMESYNC_MAX_RTT_US CONFIG_FPR_TIMESYNC_MAX_RTT_US
+#define FPR_TDMA_MAX_SLOTS CONFIG_FPR_TDMA_MAX_SLOTS
+#define FPR_TDMA_TX_QUEUE_LENGTH CONFIG_FPR_TDMA_TX_QUEUE_LENGTH
+#define FPR_SLEEPY_BUFFER_DEPTH CONFIG_FPR_SLEEPY_BUFFER_DEPTH
+#define FPR_SLEEPY_WAKE_GUARD_MS CONFIG_FPR_SLEEPY_WAKE_GUARD_MS
+#define FPR_EXTENDER_STORE_SIZE CONFIG_FPR_EXTENDER_STORE_SIZE
+#define FPR_EXTENDER_STORE_PER_DEST CONFIG_FPR_EXTENDER_STORE_PER_DEST
+#define FPR_EXTENDER_STORE_MAX_AGE_MS CONFIG_FPR_EXTENDER_STORE_MAX_AGE_MS
+#define FPR_EXTENDER_ROUTE_MAX_AGE_MS CONFIG_FPR_EXTENDER_ROUTE_MAX_AGE_MS
+
+#ifdef CONFIG_FPR_MPR_ENABLE
+#define FPR_MPR_ENABLE 1
+#else
+#define FPR_MPR_ENABLE 0
+#endif
+#define FPR_MPR_MAX_NEIGHBORS CONFIG_FPR_MPR_MAX_NEIGHBORS
+#define FPR_MPR_HELLO_INTERVAL_MS CONFIG_FPR_MPR_HELLO_INTERVAL_MS
+#define FPR_MPR_NEIGHBOR_TIMEOUT_MS CONFIG_FPR_MPR_NEIGHBOR_TIMEOUT_MS
+#define FPR_MPR_DUP_CACHE_SIZE CONFIG_FPR_MPR_DUP_CACHE_SIZE
+#define FPR_CHANNEL_EVAL_INTERVAL_MS CONFIG_FPR_CHANNEL_EVAL_INTERVAL_MS
+#define FPR_CHANNEL_SWITCH_DELAY_MS CONFIG_FPR_CHANNEL_SWITCH_DELAY_MS
+#define FPR_CHANNEL_RESCAN_ON_LOSS CONFIG_FPR_CHANNEL_RESCAN_ON_LOSS
+#define FPR_TREE_MAX_NEIGHBORS CONFIG_FPR_TREE_MAX_NEIGHBORS
+#define FPR_TREE_BEACON_INTERVAL_MS CONFIG_FPR_TREE_BEACON_INTERVAL_MS
+#define FPR_TREE_NEIGHBOR_TIMEOUT_MS CONFIG_FPR_TREE_NEIGHBOR_TIMEOUT_MS
+#define FPR_TREE_SWITCH_THRESHOLD CONFIG_FPR_TREE_SWITCH_THRESHOLD
+#define FPR_TREE_MIN_RSSI CONFIG_FPR_TREE_MIN_RSSI
+#define FPR_AGGREGATE_MAX_RULES CONFIG_FPR_AGGREGATE_MAX_RULES
+#define FPR_AGGREGATE_MAX_BUCKETS CONFIG_FPR_AGGREGATE_MAX_BUCKETS
+#define FPR_AGGREGATE_TICK_MS CONFIG_FPR_AGGREGATE_TICK_MS
+#define FPR_LINK_MAX CONFIG_FPR_LINK_MAX
+#define FPR_LINK_HELLO_INTERVAL_MS CONFIG_FPR_LINK_HELLO_INTERVAL_MS
+#define FPR_LINK_DEGRADED_MS CONFIG_FPR_LINK_DEGRADED_MS
+#define FPR_LINK_MAX_TX_FAILURES CONFIG_FPR_LINK_MAX_TX_FAILURES
+
+#ifdef CONFIG_FPR_LINK_HOST_INTRODUCE
+#define FPR_LINK_HOST_INTRODUCE 1
+#else
+#define FPR_LINK_HOST_INTRODUCE 0
+#endif
+
+#ifdef CONFIG_FPR_TRACE_ENABLE
+#define FPR_TRACE_ENABLE 1
+#define FPR_TRACE_RING_SIZE CONFIG_FPR_TRACE_RING_SIZE
+#else
+#define FPR_TRACE_ENABLE 0
+#endif
+
+#ifdef CONFIG_FPR_CAPTURE_ENABLE
+#define FPR_CAPTURE_ENABLE 1
+#else
+#define FPR_CAPTURE_ENABLE 0
+#endif
+
+#ifdef CONFIG_FPR_BRIDGE_ENABLE
+#define FPR_BRIDGE_ENABLE 1
+#define FPR_BRIDGE_QUEUE_LENGTH CONFIG_FPR_BRIDGE_QUEUE_LENGTH
+#else
+#define FPR_BRIDGE_ENABLE 0
+#endif
+
+#define FPR_EVENT_QUEUE_LENGTH CONFIG_FPR_EVENT_QUEUE_LENGTH
+
+#define FPR_MAX_INSTANCES CONFIG_FPR_MAX_INSTANCES
+#if (FPR_MAX_INSTANCES > 1)
+#define FPR_INSTANCE_TLS_INDEX CONFIG_FPR_INSTANCE_TLS_INDEX
+#endif
+
+#define FPR_LOG_LEVEL CONFIG_FPR_LOG_LEVEL
+#define FPR_LOG_RATE_PER_SEC CONFIG_FPR_LOG_RATE_PER_SEC
+#define FPR_LOG_BURST CONFIG_FPR_LOG_BURST
+
+#ifdef CONFIG_FPR_LOG_DEFERRED
+#define FPR_LOG_DEFERRED 1
+#define FPR_LOG_QUEUE_LENGTH CONFIG_FPR_LOG_QUEUE_LENGTH
+#define FPR_LOG_SUMMARY_INTERVAL_MS CONFIG_FPR_LOG_SUMMARY_INTERVAL_MS
+#else
+#define FPR_LOG_DEFERRED 0
+#endif
 #define FPR_DEBUG CONFIG_FPR_DEBUG
 #define FPR_TASK_PRIORITY CONFIG_FPR_TASK_PRIORITY
 #define FPR_TASK_STACK_SIZE CONFIG_FPR_TASK_STACK_SIZE
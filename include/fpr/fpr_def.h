@@ -76,6 +76,64 @@ typedef int fpr_package_id_t;
  */
 #define FPR_PACKET_ID_CONTROL (-1)
 
+/**
+ * @brief Reserved packet ID for RPC request/response frames (see fpr_rpc.h).
+ * 
+ * Frames with reserved service IDs are consumed internally and never
+ * reach the application queue or data callback.
+ */
+#define FPR_PACKET_ID_RPC (-2)
+
+/**
+ * @brief Reserved packet ID for publish/subscribe frames (see fpr_pubsub.h).
+ */
+#define FPR_PACKET_ID_PUBSUB (-3)
+
+/**
+ * @brief Reserved packet ID for time synchronization frames (see fpr_timesync.h).
+ */
+#define FPR_PACKET_ID_TIMESYNC (-4)
+
+/**
+ * @brief Reserved packet ID for the host superframe beacon (broadcast).
+ */
+#define FPR_PACKET_ID_BEACON (-5)
+
+/**
+ * @brief Reserved packet ID for TDMA slot requests and assignments (see fpr_tdma.h).
+ */
+#define FPR_PACKET_ID_TDMA (-6)
+
+/**
+ * @brief Reserved packet ID for sleepy-client registration and polling (see fpr_sleepy.h).
+ */
+#define FPR_PACKET_ID_SLEEPY (-7)
+
+/**
+ * @brief Reserved packet ID for active host discovery (probe request/response).
+ */
+#define FPR_PACKET_ID_PROBE (-8)
+
+/**
+ * @brief Reserved packet ID for direct client link setup and keepalive (see fpr_link.h).
+ */
+#define FPR_PACKET_ID_LINK (-9)
+
+/**
+ * @brief Reserved packet ID for reports merged by extenders (see fpr_aggregate.h).
+ */
+#define FPR_PACKET_ID_AGGREGATE (-10)
+
+/**
+ * @brief Reserved packet ID for collection tree beacons and upstream data (see fpr_tree.h).
+ */
+#define FPR_PACKET_ID_TREE (-11)
+
+/**
+ * @brief Reserved packet ID for extender neighbor hellos (multipoint relay selection).
+ */
+#define FPR_PACKET_ID_MPR (-12)
+
 typedef enum {
     FPR_MODE_DEFUALT = 0,
     FPR_MODE_CLIENT,
@@ -136,18 +194,103 @@ typedef struct {
     int8_t rssi;
     uint64_t last_seen_ms;
     uint32_t packets_received;
+    uint8_t channel;            // WiFi channel the peer was last heard on
 } fpr_peer_info_t;
 
+#define FPR_CHANNEL_MAX 14
+
+/**
+ * @brief Per-channel result of a multi-channel host scan.
+ */
 typedef struct {
-    uint32_t packets_sent;
-    uint32_t packets_received;
-    uint32_t packets_forwarded;
-    uint32_t packets_dropped;
-    uint32_t send_failures;
-    uint32_t replay_attacks_blocked;  // Packets dropped due to replay protection
+    uint8_t channel;
+    uint8_t hosts;              // Hosts that answered on this channel
+    int8_t best_rssi;           // Strongest answer (INT8_MIN if none)
+} fpr_channel_result_t;
+
+/**
+ * @brief Multi-channel host scan report.
+ */
+typedef struct {
+    uint8_t channel_count;                          // Entries used in channels[]
+    fpr_channel_result_t channels[FPR_CHANNEL_MAX];
+    uint8_t locked_channel;                         // Channel the client stays on, 0 if no host answered
+    uint8_t best_host[MAC_ADDRESS_LENGTH];          // Strongest host on locked_channel
+    uint32_t duration_ms;                           // Total scan time
+} fpr_channel_scan_report_t;
+
+/** Missed heartbeat periods after which a host counts as lost (hot standby) */
+#define FPR_STANDBY_MAX_MISSED_HEARTBEATS 3
+
+typedef struct {
+    bool enabled;                                   // Client keeps a standby host
+    bool standby_ready;                             // Standby is connected and answering heartbeats
+    uint8_t primary_mac[MAC_ADDRESS_LENGTH];        // Host that carries traffic
+    uint8_t standby_mac[MAC_ADDRESS_LENGTH];        // Pre-authenticated second host
+    uint32_t failovers;                             // Switches to the standby
+    uint32_t last_failover_ms;                      // Last heard from the old host until traffic moved
+    uint32_t heartbeats_sent;
+    uint32_t standby_lost;                          // Standby hosts dropped for missing heartbeats
+} fpr_standby_stats_t;
+
+/**
+ * @brief Network-wide counters. Exact under concurrent updates from any task
+ * or core, and 64 bits wide so they do not wrap.
+ */
+typedef struct {
+    uint64_t packets_sent;
+    uint64_t packets_received;
+    uint64_t packets_forwarded;
+    uint64_t packets_dropped;
+    uint64_t send_failures;
+    uint64_t replay_attacks_blocked;  // Packets dropped due to replay protection
     size_t peer_count;
 } fpr_network_stats_t;
 
+/**
+ * @brief Wake-ups of the FPR service task that runs the discovery loop and
+ * the reconnect/keepalive work (see fpr_network_get_wakeup_stats()).
+ */
+typedef struct {
+    uint64_t wakeups;               // Since fpr_network_init()
+    uint64_t timer_wakeups;         // A job deadline expired
+    uint64_t posted_wakeups;        // A job was started or work was posted to it
+    uint32_t last_minute;           // Wake-ups in the last full minute
+} fpr_wakeup_stats_t;
+
+/**
+ * Number of buckets in each per-peer histogram. Buckets are powers of two:
+ * bucket 0 counts values below the histogram's base unit, bucket i values
+ * below base << i, and the last bucket everything above.
+ */
+#define FPR_PEER_HIST_BUCKETS 12
+
+typedef enum {
+    FPR_FRAG_DROP_LATEST_ONLY = 0,  // Fragment arrived while the peer is in latest-only queue mode
+    FPR_FRAG_DROP_SUPERSEDED,       // Incomplete message discarded when a new one started
+    FPR_FRAG_DROP_ORPHAN,           // Continuation without a matching start
+    FPR_FRAG_DROP_REASONS
+} fpr_frag_drop_reason_t;
+
+/**
+ * @brief Per-peer counters and histograms (see fpr_network_get_peer_stats()).
+ */
+typedef struct {
+    uint32_t packets_received;      // Accepted from this peer
+    uint32_t packets_acked;         // Sent to this peer and acknowledged
+    uint32_t send_failures;         // Sends refused locally or not acknowledged
+    uint32_t replay_rejects;        // Dropped for an old sequence number
+    uint32_t seq_lost;              // Frames missing from the link sequence, summed over all gaps
+    uint32_t seq_gaps;              // Gaps seen in the link sequence
+    uint32_t frag_drops[FPR_FRAG_DROP_REASONS];
+    uint32_t queue_full_drops;      // Dropped because the receive queue was full
+    uint32_t queue_high_water;      // Deepest receive queue seen
+    uint32_t rtt_hist[FPR_PEER_HIST_BUCKETS];           // Send to ESP-NOW ack, base 250 us
+    uint32_t interarrival_hist[FPR_PEER_HIST_BUCKETS];  // Between accepted packets, base 1 ms
+    uint32_t gap_hist[FPR_PEER_HIST_BUCKETS];           // Frames lost per gap, base 2
+    uint32_t queue_depth_hist[FPR_PEER_HIST_BUCKETS];   // Queue depth after each enqueue, base 1
+} fpr_peer_stats_t;
+
 typedef struct {
     fpr_package_id_t package_id;
     uint8_t max_hops;
@@ -157,6 +300,7 @@ typedef struct {
     uint8_t max_peers;                          // Maximum peers allowed (0 = unlimited)
     fpr_connection_mode_t connection_mode;      // Auto or manual connection approval
     fpr_connection_request_cb_t request_cb;     // Callback for manual approval (NULL for auto)
+    uint8_t rebalance_pct;                      // Ask a client to move when load reaches this percent (0 = never)
 } fpr_host_config_t;
 
 typedef struct {
@@ -0,0 +1,132 @@
+#pragma once
+
+/**
+ * @file fpr_event.h
+ * @brief FPR Connection Event Stream
+ *
+ * Reports peer and connection changes as typed events, so applications can
+ * block on one queue instead of polling fpr_client_is_connected(),
+ * fpr_host_get_connected_count() or the peer list.
+ *
+ * Flow:
+ * 1. fpr_network_init() creates the event queue
+ *    (CONFIG_FPR_EVENT_QUEUE_LENGTH entries)
+ * 2. One application task loops on fpr_event_wait(), or
+ *    fpr_event_register_callback() is used for immediate notification
+ * 3. FPR posts an event when a peer is first seen, at every handshake step,
+ *    when a peer connects, disconnects, times out or is blocked, when the
+ *    extender route to a peer changes, and when a peer's receive queue
+ *    starts dropping packets
+ *
+ * Limitations:
+ * - Events are posted without waiting. When the queue is full new events
+ *   are dropped and counted; after a drop, re-read the current state with
+ *   fpr_list_all_peers()
+ * - The callback runs on the task that caused the event, often the Wi-Fi
+ *   task. It must not block or call back into FPR
+ * - Queue overflow is reported once per episode: again only after the
+ *   peer's queue has accepted a packet
+ * - Queued events from before fpr_network_deinit() are discarded by the
+ *   next fpr_network_init()
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Event types.
+ */
+typedef enum {
+    FPR_EVENT_PEER_DISCOVERED = 1,  // New peer entry (host, client or route)
+    FPR_EVENT_HANDSHAKE,            // Security handshake step; see .handshake
+    FPR_EVENT_CONNECTED,            // Peer is connected and can exchange data
+    FPR_EVENT_DISCONNECTED,         // Peer was connected and no longer is; see .disconnected
+    FPR_EVENT_BLOCKED,              // Peer was blocked
+    FPR_EVENT_ROUTE_CHANGED,        // Extender route to the peer changed; see .route
+    FPR_EVENT_QUEUE_OVERFLOW,       // Peer receive queue full, packets dropped; see .overflow
+} fpr_event_type_t;
+
+/**
+ * @brief Why a peer was disconnected.
+ */
+typedef enum {
+    FPR_EVENT_REASON_NONE = 0,
+    FPR_EVENT_REASON_LOCAL,         // This node disconnected, rejected or blocked it
+    FPR_EVENT_REASON_REMOTE,        // The peer closed the connection
+    FPR_EVENT_REASON_TIMEOUT,       // Not heard from within the reconnect timeout
+    FPR_EVENT_REASON_PEER_RESTART,  // The peer restarted and is handshaking again
+    FPR_EVENT_REASON_REMOVED,       // Peer entry removed
+} fpr_event_reason_t;
+
+/**
+ * @brief One event.
+ */
+typedef struct {
+    fpr_event_type_t type;
+    uint8_t peer_mac[6];
+    uint8_t network_id;             // Instance that raised it, see fpr_instance.h
+    int64_t timestamp_us;           // esp_timer_get_time() when posted
+    union {
+        struct {
+            uint8_t step;           // 1-4, see fpr_security_handshake.h
+            bool failed;
+        } handshake;
+        struct {
+            fpr_event_reason_t reason;
+        } disconnected;
+        struct {
+            uint8_t next_hop[6];
+            uint8_t hops;
+        } route;
+        struct {
+            uint32_t dropped;       // Queue-full drops for this peer so far
+        } overflow;
+    };
+} fpr_event_t;
+
+/**
+ * @brief Event callback.
+ * @param event The event. Only valid during the call.
+ * @param user_data User data passed at registration.
+ */
+typedef void (*fpr_event_cb_t)(const fpr_event_t *event, void *user_data);
+
+/**
+ * @brief Wait for the next event.
+ * @param event Filled with the event.
+ * @param timeout Maximum time to wait (FreeRTOS ticks, portMAX_DELAY for ever).
+ * @return ESP_OK, ESP_ERR_TIMEOUT, ESP_ERR_INVALID_STATE if the queue was
+ * never created (network not initialized or CONFIG_FPR_EVENT_QUEUE_LENGTH is 0).
+ * @note Only one task should wait; each event is delivered once.
+ */
+esp_err_t fpr_event_wait(fpr_event_t *event, TickType_t timeout);
+
+/**
+ * @brief Register a callback invoked for every event, in addition to the queue.
+ * @param cb Callback, NULL to unregister.
+ * @param user_data User data passed to the callback.
+ */
+void fpr_event_register_callback(fpr_event_cb_t cb, void *user_data);
+
+/**
+ * @brief Events dropped because the queue was full, since fpr_network_init().
+ */
+uint32_t fpr_event_get_dropped(void);
+
+/**
+ * @brief Short name of an event type, for logs.
+ */
+const char *fpr_event_type_to_name(fpr_event_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
@@ -18,8 +18,26 @@
  * Current Status (v1.0.0):
  * - Basic packet forwarding structure is implemented
  * - Route table management is in place
+ * - Optional store-and-forward for unreachable destinations
  * - Full mesh networking requires additional testing
  * 
+ * Store-and-forward:
+ * When enabled, unicast frames without a route (or whose send fails) are
+ * held in a bounded store instead of dropped. A send counts as failed when
+ * the radio reports it was not acknowledged, not only when it is refused
+ * at once. Routes whose next hop is silent for
+ * CONFIG_FPR_EXTENDER_ROUTE_MAX_AGE_MS expire. Each destination may hold
+ * at most CONFIG_FPR_EXTENDER_STORE_PER_DEST frames (oldest dropped first),
+ * and frames older than CONFIG_FPR_EXTENDER_STORE_MAX_AGE_MS expire. Held
+ * frames are sent when their destination or its next hop is heard again.
+ * 
+ * Broadcast relays:
+ * Extenders exchange hellos listing the neighbors they hear and pick
+ * multipoint relays (MPRs), a small set of neighbors that reaches every
+ * two-hop neighbor. Only the relays picked by a broadcast's last sender
+ * rebroadcast it; senders not yet known from a hello are flooded. Each
+ * broadcast is delivered and rebroadcast at most once per extender.
+ * 
  * @version 1.0.0 (Under Development)
  * @date December 2024
  */
@@ -47,6 +65,72 @@ extern "C" {
  */
 void _handle_extender_receive(const esp_now_recv_info_t *esp_now_info, const uint8_t *data, int len);
 
+/**
+ * @brief Initialize the store-and-forward state. Called from fpr_network_init_ex().
+ * @warning Internal function - do not call directly.
+ */
+void _fpr_extender_store_init(void);
+
+/**
+ * @brief Free held frames. Called from fpr_network_deinit().
+ * @warning Internal function - do not call directly.
+ */
+void _fpr_extender_store_deinit(void);
+
+/**
+ * @brief Radio send result. A forwarded frame the next hop did not
+ * acknowledge is held, and the route through that neighbour dropped.
+ * @warning Internal function - do not call directly.
+ */
+void _fpr_extender_on_send_status(const uint8_t *dest, bool success);
+
+/**
+ * @brief Initialize the neighbor table. Called from fpr_network_init_ex().
+ * @warning Internal function - do not call directly.
+ */
+void _fpr_extender_mpr_init(void);
+
+/**
+ * @brief Arm the neighbor hello job in extender mode and cancel it in any
+ * other. Called from fpr_network_set_mode().
+ * @warning Internal function - do not call directly.
+ */
+void _fpr_extender_mpr_on_mode_set(void);
+
+/**
+ * @brief Cancel the neighbor hello job. Called from fpr_network_deinit().
+ * @warning Internal function - do not call directly.
+ */
+void _fpr_extender_mpr_deinit(void);
+
+/**
+ * @brief Enable or disable store-and-forward of undeliverable unicast frames.
+ * @param enable true to hold frames, false to drop held frames and stop.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the store cannot be allocated.
+ */
+esp_err_t fpr_extender_set_store_and_forward(bool enable);
+
+/**
+ * @brief Get store-and-forward statistics.
+ * @param stats Pointer to structure to fill.
+ */
+void fpr_extender_get_store_stats(fpr_extender_store_stats_t *stats);
+
+/**
+ * @brief Choose between multipoint relays and plain flooding for broadcasts.
+ * @param enable true to rebroadcast only when picked as relay, false to flood.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the network is not initialized.
+ * @note Hellos continue either way, so relay selection stays current for comparisons.
+ */
+esp_err_t fpr_extender_set_mpr(bool enable);
+
+/**
+ * @brief Get broadcast relay statistics. suppressed counts the rebroadcasts
+ * saved compared with flooding.
+ * @param stats Pointer to structure to fill.
+ */
+void fpr_extender_get_broadcast_stats(fpr_extender_broadcast_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -47,16 +47,48 @@ extern "C" {
 void _handle_host_receive(const esp_now_recv_info_t *esp_now_info, const uint8_t *data, int len);
 
 /**
- * @brief Background task for host reconnection/keepalive
+ * @brief Host reconnection/keepalive job for the FPR service task
  * 
- * @warning Internal function - started via fpr_network_start_reconnect_task().
+ * @warning Internal function - armed via fpr_network_start_reconnect_task().
  * 
  * Monitors connection state and sends periodic keepalives to maintain
  * connections with clients.
  * 
- * @param arg Task arguments (unused)
+ * @param now_us Current time (esp_timer_get_time())
+ * @return Time of the next run, one keepalive interval later
  */
-void _fpr_host_reconnect_task(void *arg);
+int64_t _fpr_host_reconnect_job(int64_t now_us);
+
+/**
+ * @brief Fill in the host's current load for an announcement.
+ * 
+ * @warning Internal function - used when building connection info in host mode.
+ * 
+ * @param load Load fields to fill.
+ */
+void _fpr_host_fill_load(fpr_host_load_t *load);
+
+/**
+ * @brief Initialize probe state (host responder timer, client scan wait).
+ * 
+ * @warning Internal function - called from fpr_network_init_ex().
+ */
+void _fpr_probe_init(void);
+
+/**
+ * @brief Release probe state.
+ * 
+ * @warning Internal function - called from fpr_network_deinit().
+ */
+void _fpr_probe_deinit(void);
+
+/**
+ * @brief Arm the overload check on a host with a rebalance threshold and
+ * cancel it otherwise.
+ * 
+ * @warning Internal function - called from fpr_network_set_mode().
+ */
+void _fpr_probe_on_mode_set(void);
 
 #ifdef __cplusplus
 }
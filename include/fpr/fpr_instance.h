@@ -0,0 +1,266 @@
+#pragma once
+
+/**
+ * @file fpr_instance.h
+ * @brief FPR Network Instances
+ *
+ * A device can be part of several independent FPR networks at once, for
+ * example a gateway bridging a private control network and a public
+ * telemetry network with different visibility, keys and connection policy.
+ * Each instance has its own peers, mode, keys, services and statistics.
+ * The frame header carries the instance's network ID, and received frames
+ * are handed to the instance on that network.
+ *
+ * Flow:
+ * 1. fpr_instance_create() claims an instance for a network ID
+ * 2. Every per-network function has an _ex() form taking the handle first:
+ *    fpr_instance_init(), fpr_network_start_ex(), fpr_network_send_to_peer_ex(),
+ *    fpr_pubsub_publish_ex() ...
+ * 3. fpr_instance_destroy() after fpr_network_deinit_ex()
+ *
+ * The functions without _ex act on the default instance (network ID 0),
+ * in every task and inside every callback, so single-network applications
+ * need no change. A callback raised by another instance tells which one
+ * through fpr_instance_current() and calls back into it with the _ex()
+ * forms.
+ *
+ * Limitations:
+ * - All instances share the radio: one Wi-Fi channel, one ESP-NOW peer
+ *   table. Channel migration and channel scans move every instance
+ * - The same peer MAC in two instances shares one ESP-NOW peer entry
+ * - Send results go to the instance that has the destination as a peer,
+ *   broadcasts to the default instance
+ * - Event, trace, capture and data path logging streams are shared;
+ *   fpr_event_t.network_id tells instances apart
+ * - Nodes from before network IDs send 0 and reach the default instance only
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "fpr/fpr.h"
+#include "fpr/fpr_extender.h"
+#include "fpr/fpr_pubsub.h"
+#include "fpr/fpr_rpc.h"
+#include "fpr/fpr_timesync.h"
+#include "fpr/fpr_tdma.h"
+#include "fpr/fpr_sleepy.h"
+#include "fpr/fpr_channel.h"
+#include "fpr/fpr_link.h"
+#include "fpr/fpr_aggregate.h"
+#include "fpr/fpr_tree.h"
+#include "fpr/fpr_bridge.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Network ID of the default instance.
+ */
+#define FPR_INSTANCE_DEFAULT_NETWORK_ID 0
+
+/**
+ * @brief Instance handle.
+ */
+typedef struct fpr_instance fpr_instance_t;
+
+/**
+ * @brief The default instance, used by tasks that never selected one.
+ */
+fpr_instance_t *fpr_instance_default(void);
+
+/**
+ * @brief Claim an instance for a network.
+ * @param network_id Network ID stamped on every frame (1-255, unique per device).
+ * @param instance Filled with the handle.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for ID 0 or NULL, ESP_ERR_INVALID_STATE
+ * if another instance uses the ID, ESP_ERR_NO_MEM if all
+ * CONFIG_FPR_MAX_INSTANCES are in use.
+ * @note The instance starts uninitialized; call fpr_instance_init().
+ */
+esp_err_t fpr_instance_create(uint8_t network_id, fpr_instance_t **instance);
+
+/**
+ * @brief Release an instance.
+ * @param instance Instance from fpr_instance_create().
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for the default instance,
+ * ESP_ERR_INVALID_STATE if it is still initialized (call fpr_network_deinit_ex()).
+ */
+esp_err_t fpr_instance_destroy(fpr_instance_t *instance);
+
+/**
+ * @brief The instance that raised the running FPR callback.
+ * @return The default instance outside FPR callbacks.
+ */
+fpr_instance_t *fpr_instance_current(void);
+
+/**
+ * @brief Network ID of an instance.
+ */
+uint8_t fpr_instance_get_network_id(const fpr_instance_t *instance);
+
+/**
+ * @brief Initialize an instance, as fpr_network_init_ex().
+ * @param instance Instance, NULL for the default instance.
+ * @param name Device name.
+ * @param config Init configuration, NULL for fpr_network_init() defaults.
+ */
+esp_err_t fpr_instance_init(fpr_instance_t *instance, const char *name, const fpr_init_config_t *config);
+
+/*
+ * Per-instance forms of the network API. Each one behaves as the function
+ * without _ex, on @p instance (NULL for the default instance). Callbacks
+ * registered through them are raised for that instance.
+ */
+
+// fpr.h: lifecycle, mode and state
+esp_err_t fpr_network_deinit_ex(fpr_instance_t *instance);
+esp_err_t fpr_network_start_ex(fpr_instance_t *instance);
+esp_err_t fpr_network_stop_ex(fpr_instance_t *instance);
+esp_err_t fpr_network_pause_ex(fpr_instance_t *instance);
+esp_err_t fpr_network_resume_ex(fpr_instance_t *instance);
+fpr_network_state_t fpr_network_get_state_ex(fpr_instance_t *instance);
+void fpr_network_set_power_mode_ex(fpr_instance_t *instance, fpr_power_mode_t mode);
+fpr_power_mode_t fpr_network_get_power_mode_ex(fpr_instance_t *instance);
+void fpr_network_set_queue_mode_ex(fpr_instance_t *instance, fpr_queue_mode_t mode);
+fpr_queue_mode_t fpr_network_get_queue_mode_ex(fpr_instance_t *instance);
+esp_err_t fpr_network_set_peer_queue_mode_ex(fpr_instance_t *instance, uint8_t *peer_mac, fpr_queue_mode_t mode);
+uint32_t fpr_network_get_peer_queued_packets_ex(fpr_instance_t *instance, uint8_t *peer_mac);
+void fpr_network_set_mode_ex(fpr_instance_t *instance, fpr_mode_type_t mode);
+fpr_mode_type_t fpr_network_get_mode_ex(fpr_instance_t *instance);
+void fpr_network_set_permission_state_ex(fpr_instance_t *instance, fpr_visibility_t state);
+fpr_visibility_t fpr_network_get_permission_state_ex(fpr_instance_t *instance);
+esp_err_t fpr_network_start_loop_task_ex(fpr_instance_t *instance, TickType_t duration, bool force_restart);
+esp_err_t fpr_network_stop_loop_task_ex(fpr_instance_t *instance);
+bool fpr_network_is_loop_task_running_ex(fpr_instance_t *instance);
+esp_err_t fpr_network_start_reconnect_task_ex(fpr_instance_t *instance);
+esp_err_t fpr_network_stop_reconnect_task_ex(fpr_instance_t *instance);
+bool fpr_network_is_reconnect_task_running_ex(fpr_instance_t *instance);
+
+// fpr.h: peers, data and statistics
+esp_err_t fpr_network_add_peer_ex(fpr_instance_t *instance, uint8_t *peer_mac);
+esp_err_t fpr_network_remove_peer_ex(fpr_instance_t *instance, uint8_t *peer_mac);
+esp_err_t fpr_send_with_options_ex(fpr_instance_t *instance, uint8_t *peer_address, void *data, int size, const fpr_send_options_t *options);
+esp_err_t fpr_network_send_to_peer_ex(fpr_instance_t *instance, uint8_t *peer_address, void *data, int size, fpr_package_id_t package_id);
+esp_err_t fpr_network_broadcast_ex(fpr_instance_t *instance, void *data, int size, fpr_package_id_t package_id);
+esp_err_t fpr_network_send_device_info_ex(fpr_instance_t *instance, uint8_t *peer_address);
+esp_err_t fpr_network_broadcast_device_info_ex(fpr_instance_t *instance);
+bool fpr_network_get_data_from_peer_ex(fpr_instance_t *instance, uint8_t *peer_mac, void *data, int data_size, TickType_t timeout);
+void fpr_register_receive_callback_ex(fpr_instance_t *instance, fpr_data_receive_cb_t callback);
+int fpr_network_get_peer_count_ex(fpr_instance_t *instance);
+size_t fpr_network_get_peers_ex(fpr_instance_t *instance, fpr_data_receive_cb_t callback, void *user_data);
+esp_err_t fpr_get_peer_by_name_ex(fpr_instance_t *instance, const char *peer_name, uint8_t *mac_out);
+esp_err_t fpr_get_peer_info_ex(fpr_instance_t *instance, uint8_t *peer_mac, fpr_peer_info_t *info);
+size_t fpr_list_all_peers_ex(fpr_instance_t *instance, fpr_peer_info_t *peer_array, size_t max_peers);
+esp_err_t fpr_clear_all_peers_ex(fpr_instance_t *instance);
+bool fpr_is_peer_reachable_ex(fpr_instance_t *instance, uint8_t *peer_mac, uint32_t timeout_ms);
+size_t fpr_cleanup_stale_routes_ex(fpr_instance_t *instance, uint32_t timeout_ms);
+void fpr_print_route_table_ex(fpr_instance_t *instance);
+void fpr_get_network_stats_ex(fpr_instance_t *instance, fpr_network_stats_t *stats);
+void fpr_reset_network_stats_ex(fpr_instance_t *instance);
+esp_err_t fpr_network_get_peer_stats_ex(fpr_instance_t *instance, const uint8_t *peer_mac, fpr_peer_stats_t *stats);
+esp_err_t fpr_network_reset_peer_stats_ex(fpr_instance_t *instance, const uint8_t *peer_mac);
+void fpr_network_get_wakeup_stats_ex(fpr_instance_t *instance, fpr_wakeup_stats_t *stats);
+
+// fpr.h: host and client
+esp_err_t fpr_host_set_config_ex(fpr_instance_t *instance, const fpr_host_config_t *config);
+esp_err_t fpr_host_get_config_ex(fpr_instance_t *instance, fpr_host_config_t *config);
+size_t fpr_host_get_connected_count_ex(fpr_instance_t *instance);
+esp_err_t fpr_host_approve_peer_ex(fpr_instance_t *instance, uint8_t *peer_mac);
+esp_err_t fpr_host_reject_peer_ex(fpr_instance_t *instance, uint8_t *peer_mac);
+esp_err_t fpr_host_block_peer_ex(fpr_instance_t *instance, uint8_t *peer_mac);
+esp_err_t fpr_host_unblock_peer_ex(fpr_instance_t *instance, uint8_t *peer_mac);
+esp_err_t fpr_host_disconnect_peer_ex(fpr_instance_t *instance, uint8_t *peer_mac);
+esp_err_t fpr_client_set_config_ex(fpr_instance_t *instance, const fpr_client_config_t *config);
+esp_err_t fpr_client_get_config_ex(fpr_instance_t *instance, fpr_client_config_t *config);
+bool fpr_client_is_connected_ex(fpr_instance_t *instance);
+esp_err_t fpr_client_get_host_info_ex(fpr_instance_t *instance, uint8_t *mac_out, char *name_out, size_t name_size);
+size_t fpr_client_list_discovered_hosts_ex(fpr_instance_t *instance, fpr_peer_info_t *peer_array, size_t max_peers);
+esp_err_t fpr_client_connect_to_host_ex(fpr_instance_t *instance, uint8_t *peer_mac, TickType_t timeout);
+esp_err_t fpr_client_disconnect_ex(fpr_instance_t *instance);
+size_t fpr_client_scan_for_hosts_ex(fpr_instance_t *instance, TickType_t duration);
+size_t fpr_client_probe_for_hosts_ex(fpr_instance_t *instance, size_t min_hosts, TickType_t timeout);
+esp_err_t fpr_client_set_standby_ex(fpr_instance_t *instance, bool enable);
+void fpr_client_get_standby_stats_ex(fpr_instance_t *instance, fpr_standby_stats_t *stats);
+
+// fpr_extender.h
+esp_err_t fpr_extender_set_store_and_forward_ex(fpr_instance_t *instance, bool enable);
+void fpr_extender_get_store_stats_ex(fpr_instance_t *instance, fpr_extender_store_stats_t *stats);
+esp_err_t fpr_extender_set_mpr_ex(fpr_instance_t *instance, bool enable);
+void fpr_extender_get_broadcast_stats_ex(fpr_instance_t *instance, fpr_extender_broadcast_stats_t *stats);
+
+// fpr_pubsub.h
+esp_err_t fpr_pubsub_subscribe_ex(fpr_instance_t *instance, fpr_topic_t topic, fpr_pubsub_cb_t cb, void *user_data);
+esp_err_t fpr_pubsub_unsubscribe_ex(fpr_instance_t *instance, fpr_topic_t topic);
+esp_err_t fpr_pubsub_publish_ex(fpr_instance_t *instance, fpr_topic_t topic, const void *data, size_t len, bool retain);
+esp_err_t fpr_pubsub_get_retained_ex(fpr_instance_t *instance, fpr_topic_t topic, void *buf, size_t *len);
+void fpr_pubsub_get_stats_ex(fpr_instance_t *instance, fpr_pubsub_stats_t *stats);
+void fpr_pubsub_reset_stats_ex(fpr_instance_t *instance);
+
+// fpr_rpc.h
+esp_err_t fpr_rpc_register_ex(fpr_instance_t *instance, fpr_rpc_method_t method, fpr_rpc_handler_t handler, void *user_data);
+esp_err_t fpr_rpc_unregister_ex(fpr_instance_t *instance, fpr_rpc_method_t method);
+esp_err_t fpr_rpc_call_async_ex(fpr_instance_t *instance, const uint8_t *peer_mac, fpr_rpc_method_t method,
+                                const void *req, size_t req_len, uint32_t timeout_ms,
+                                fpr_rpc_response_cb_t cb, void *user_data, uint32_t *call_id_out);
+esp_err_t fpr_rpc_call_ex(fpr_instance_t *instance, const uint8_t *peer_mac, fpr_rpc_method_t method,
+                          const void *req, size_t req_len,
+                          void *resp, size_t *resp_len, uint32_t timeout_ms);
+esp_err_t fpr_rpc_cancel_ex(fpr_instance_t *instance, uint32_t call_id);
+void fpr_rpc_get_stats_ex(fpr_instance_t *instance, fpr_rpc_stats_t *stats);
+void fpr_rpc_reset_stats_ex(fpr_instance_t *instance);
+
+// fpr_timesync.h
+esp_err_t fpr_timesync_get_time_ex(fpr_instance_t *instance, int64_t *time_us, uint32_t *error_us);
+int64_t fpr_timesync_local_to_network_ex(fpr_instance_t *instance, int64_t local_us);
+int64_t fpr_timesync_network_to_local_ex(fpr_instance_t *instance, int64_t network_us);
+bool fpr_timesync_is_synced_ex(fpr_instance_t *instance);
+void fpr_timesync_get_status_ex(fpr_instance_t *instance, fpr_timesync_status_t *status);
+esp_err_t fpr_timesync_trigger_ex(fpr_instance_t *instance);
+
+// fpr_tdma.h
+esp_err_t fpr_tdma_host_start_ex(fpr_instance_t *instance, const fpr_tdma_config_t *config);
+esp_err_t fpr_tdma_host_stop_ex(fpr_instance_t *instance);
+void fpr_tdma_get_status_ex(fpr_instance_t *instance, fpr_tdma_status_t *status);
+
+// fpr_sleepy.h
+esp_err_t fpr_sleepy_host_enable_ex(fpr_instance_t *instance, uint16_t beacon_interval_ms);
+esp_err_t fpr_sleepy_host_disable_ex(fpr_instance_t *instance);
+esp_err_t fpr_sleepy_client_enable_ex(fpr_instance_t *instance, uint8_t listen_interval);
+esp_err_t fpr_sleepy_client_disable_ex(fpr_instance_t *instance);
+void fpr_sleepy_get_stats_ex(fpr_instance_t *instance, fpr_sleepy_stats_t *stats);
+
+// fpr_channel.h
+esp_err_t fpr_channel_monitor_start_ex(fpr_instance_t *instance, const fpr_channel_config_t *config);
+esp_err_t fpr_channel_monitor_stop_ex(fpr_instance_t *instance);
+esp_err_t fpr_channel_migrate_ex(fpr_instance_t *instance, uint8_t channel);
+void fpr_channel_get_status_ex(fpr_instance_t *instance, fpr_channel_status_t *status);
+
+// fpr_link.h
+esp_err_t fpr_link_request_ex(fpr_instance_t *instance, const uint8_t *peer_mac);
+esp_err_t fpr_link_close_ex(fpr_instance_t *instance, const uint8_t *peer_mac);
+esp_err_t fpr_link_get_info_ex(fpr_instance_t *instance, const uint8_t *peer_mac, fpr_link_info_t *info);
+void fpr_link_get_stats_ex(fpr_instance_t *instance, fpr_link_stats_t *stats);
+
+// fpr_aggregate.h
+esp_err_t fpr_aggregate_register_ex(fpr_instance_t *instance, fpr_package_id_t package_id, const fpr_aggregate_config_t *config);
+esp_err_t fpr_aggregate_unregister_ex(fpr_instance_t *instance, fpr_package_id_t package_id);
+void fpr_aggregate_get_stats_ex(fpr_instance_t *instance, fpr_aggregate_stats_t *stats);
+
+// fpr_tree.h
+esp_err_t fpr_tree_set_sink_ex(fpr_instance_t *instance, bool enable);
+esp_err_t fpr_tree_send_ex(fpr_instance_t *instance, const void *data, size_t size, fpr_package_id_t package_id);
+void fpr_tree_get_info_ex(fpr_instance_t *instance, fpr_tree_info_t *info);
+void fpr_tree_get_stats_ex(fpr_instance_t *instance, fpr_tree_stats_t *stats);
+
+// fpr_bridge.h: the bridge serves the instance it was started on
+esp_err_t fpr_bridge_start_ex(fpr_instance_t *instance, const fpr_bridge_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
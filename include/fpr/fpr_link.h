@@ -0,0 +1,112 @@
+#pragma once
+
+/**
+ * @file fpr_link.h
+ * @brief FPR Direct Client Links
+ *
+ * In host/client mode, clients normally only talk to their host. A direct
+ * link lets two clients of the same host exchange data without the host
+ * in the path, which halves airtime and latency for nearby clients.
+ *
+ * Flow:
+ * 1. Client A calls fpr_link_request() with the MAC of client B
+ * 2. The host checks that both are connected, generates a pairwise key and
+ *    sends each client the other's MAC, name and the key, encrypted under
+ *    that client's session key (LWK) with a check value
+ * 3. Both clients add each other as ESP-NOW peers with the key as the
+ *    local master key (LMK) and exchange hellos directly
+ * 4. fpr_network_send_to_peer() to the other client goes out directly once
+ *    a hello was heard, and through the host otherwise
+ *
+ * The direct path counts as degraded after CONFIG_FPR_LINK_MAX_TX_FAILURES
+ * failed direct sends in a row, or when nothing was heard directly for
+ * CONFIG_FPR_LINK_DEGRADED_MS. Traffic then goes through the host until the
+ * direct path recovers. Hellos keep probing it meanwhile.
+ *
+ * Limitations:
+ * - Up to CONFIG_FPR_LINK_MAX links per client
+ * - ESP-NOW allows few encrypted peers; when none is left the link runs
+ *   unencrypted
+ * - Relayed traffic is not scheduled into TDMA slots
+ * - The pairwise key is as confidential as the two session keys it is sent
+ *   under. The connect handshake carries those in the clear, so a listener
+ *   who captured the connect of either client can recover the link key;
+ *   one who only heard the introduction cannot
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief State and traffic counters of one direct link.
+ */
+typedef struct {
+    bool direct;                // Traffic currently goes straight to the peer
+    bool encrypted;             // Pairwise key installed as the ESP-NOW LMK
+    int8_t rssi;                // RSSI of the last frame heard directly
+    uint32_t direct_tx;         // Sends that went straight to the peer
+    uint32_t relayed_tx;        // Sends that went through the host
+    uint32_t direct_rx;         // Packets received straight from the peer
+    uint32_t relayed_rx;        // Packets received through the host
+    uint32_t tx_failures;       // Failed direct sends
+    uint32_t fallbacks;         // Times the direct path degraded
+} fpr_link_info_t;
+
+/**
+ * @brief Direct link statistics.
+ */
+typedef struct {
+    uint8_t links;              // Active links (client)
+    uint32_t direct_tx;         // Sends over direct links (client)
+    uint32_t relayed_tx;        // Sends to linked clients through the host (client)
+    uint32_t direct_rx;         // Packets received over direct links (client)
+    uint32_t relayed_rx;        // Packets from linked clients received through the host (client)
+    uint32_t fallbacks;         // Direct paths that degraded (client)
+    uint32_t recoveries;        // Direct paths that came back (client)
+    uint32_t rejected;          // Introductions refused (both)
+    uint32_t introductions;     // Client pairs introduced (host)
+    uint32_t relayed;           // Client-to-client packets passed on (host)
+    uint32_t relay_dropped;     // Packets for clients that are not connected (host)
+} fpr_link_stats_t;
+
+/**
+ * @brief Ask the host to introduce this client to another client (client mode).
+ * @param peer_mac MAC of a client connected to the same host.
+ * @return ESP_OK if the request was sent, ESP_ERR_INVALID_STATE if not connected
+ * to a host, ESP_ERR_NO_MEM if all link entries are in use.
+ * @note The link appears asynchronously; poll fpr_link_get_info().
+ */
+esp_err_t fpr_link_request(const uint8_t *peer_mac);
+
+/**
+ * @brief Tear down a direct link (client mode). The other client is told.
+ * @param peer_mac MAC of the linked client.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there is no such link.
+ */
+esp_err_t fpr_link_close(const uint8_t *peer_mac);
+
+/**
+ * @brief Get the state of a direct link (client mode).
+ * @param peer_mac MAC of the linked client.
+ * @param info Pointer to structure to fill.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there is no such link.
+ */
+esp_err_t fpr_link_get_info(const uint8_t *peer_mac, fpr_link_info_t *info);
+
+/**
+ * @brief Get direct link statistics.
+ * @param stats Pointer to structure to fill.
+ */
+void fpr_link_get_stats(fpr_link_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
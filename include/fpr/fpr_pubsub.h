@@ -0,0 +1,120 @@
+#pragma once
+
+/**
+ * @file fpr_pubsub.h
+ * @brief FPR Publish/Subscribe Service
+ *
+ * Topic-based fan-out through the host. Clients register interest in
+ * compact topic IDs and the host forwards publications only to peers that
+ * subscribed, instead of every client polling the host for shared state.
+ *
+ * Flow:
+ * 1. Client calls fpr_pubsub_subscribe() - the subscription is sent to the host
+ *    now and re-sent automatically every time the client (re)connects
+ * 2. Any node calls fpr_pubsub_publish() - clients send to the host, the host
+ *    delivers to its local subscriber and every subscribed client
+ * 3. Publications flagged retain are kept at the host and delivered to new
+ *    subscribers immediately, so they start from current state
+ *
+ * Pub/sub frames use the reserved FPR_PACKET_ID_PUBSUB package ID and never
+ * reach the application receive queue or data callback.
+ *
+ * Limitations:
+ * - Payloads must fit in a single packet (FPR_PUBSUB_MAX_PAYLOAD)
+ * - Host/client modes only; the host tracks at most FPR_PUBSUB_MAX_TOPICS topics
+ * - A publishing client does not receive its own publication back
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum payload carried by a single publication */
+#define FPR_PUBSUB_MAX_PAYLOAD 160
+
+typedef uint16_t fpr_topic_t;
+
+/**
+ * @brief Delivery callback for a subscribed topic.
+ * @param topic Topic ID.
+ * @param data Published payload.
+ * @param len Payload length.
+ * @param retained True if this is the host's retained value delivered on subscribe.
+ * @param user_data User data given at subscription.
+ * @note Runs in the ESP-NOW receive context (or the publisher's task on the host).
+ */
+typedef void (*fpr_pubsub_cb_t)(fpr_topic_t topic, const void *data, size_t len, bool retained, void *user_data);
+
+/**
+ * @brief Pub/sub statistics.
+ */
+typedef struct {
+    uint32_t published;         // Publications issued locally
+    uint32_t delivered;         // Deliveries sent to subscribed peers (host)
+    uint32_t received;          // Deliveries handed to local callbacks
+    uint32_t subscribes;        // Subscribe requests accepted (host)
+    uint32_t retained_sent;     // Retained values sent on subscribe (host)
+    uint32_t dropped;           // Requests dropped (topic table full, peer without slot)
+} fpr_pubsub_stats_t;
+
+/**
+ * @brief Subscribe to a topic.
+ * @param topic Topic ID.
+ * @param cb Delivery callback.
+ * @param user_data User data passed to the callback.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the subscription table is full.
+ * @note Subscribing to an already subscribed topic replaces its callback.
+ * On a client the subscription survives reconnects; on the host a retained
+ * value, if any, is delivered to the callback right away.
+ */
+esp_err_t fpr_pubsub_subscribe(fpr_topic_t topic, fpr_pubsub_cb_t cb, void *user_data);
+
+/**
+ * @brief Unsubscribe from a topic.
+ * @param topic Topic ID.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if not subscribed.
+ */
+esp_err_t fpr_pubsub_unsubscribe(fpr_topic_t topic);
+
+/**
+ * @brief Publish to a topic.
+ * @param topic Topic ID.
+ * @param data Payload (may be NULL if len is 0).
+ * @param len Payload length (<= FPR_PUBSUB_MAX_PAYLOAD).
+ * @param retain Keep this value at the host for future subscribers.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not in host mode and not
+ * connected to a host.
+ */
+esp_err_t fpr_pubsub_publish(fpr_topic_t topic, const void *data, size_t len, bool retain);
+
+/**
+ * @brief Read the retained value of a topic (host mode).
+ * @param topic Topic ID.
+ * @param buf Output buffer.
+ * @param len In: buffer capacity. Out: value length (truncated to capacity).
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if no value is retained.
+ */
+esp_err_t fpr_pubsub_get_retained(fpr_topic_t topic, void *buf, size_t *len);
+
+/**
+ * @brief Get pub/sub statistics.
+ * @param stats Pointer to structure to fill.
+ */
+void fpr_pubsub_get_stats(fpr_pubsub_stats_t *stats);
+
+/**
+ * @brief Reset pub/sub statistics.
+ */
+void fpr_pubsub_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
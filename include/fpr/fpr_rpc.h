@@ -0,0 +1,171 @@
+#pragma once
+
+/**
+ * @file fpr_rpc.h
+ * @brief FPR Request/Response (RPC) Service
+ *
+ * Lightweight RPC layer on top of FPR unicast data. Each call carries a
+ * correlation ID so that many requests can be outstanding to the same peer
+ * at once and responses are matched in the receive path instead of being
+ * polled out of the peer queue with fpr_network_get_data_from_peer().
+ *
+ * Flow:
+ * 1. Server registers a handler for a method ID with fpr_rpc_register()
+ * 2. Client issues fpr_rpc_call() / fpr_rpc_call_async() with a deadline
+ * 3. Server handler runs in the receive path and fills in the response
+ * 4. Client matches the response by call ID, or the timeout wheel expires it
+ *
+ * RPC frames use the reserved FPR_PACKET_ID_RPC package ID and never reach
+ * the application receive queue or data callback.
+ *
+ * Limitations:
+ * - Request and response payloads must fit in a single packet (FPR_RPC_MAX_PAYLOAD)
+ * - Peers must be connected (host/client modes)
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum request/response payload carried by a single RPC frame */
+#define FPR_RPC_MAX_PAYLOAD 160
+
+/**
+ * Number of latency histogram buckets.
+ * Bucket i counts calls that completed in less than 2^i ms (bucket 0: < 1 ms),
+ * the last bucket counts everything at or above 2^(FPR_RPC_LATENCY_BUCKETS - 2) ms.
+ */
+#define FPR_RPC_LATENCY_BUCKETS 12
+
+typedef uint16_t fpr_rpc_method_t;
+
+/**
+ * @brief Server-side method handler.
+ * @param peer_mac MAC address of the calling peer.
+ * @param method Method ID being invoked.
+ * @param req Request payload.
+ * @param req_len Request payload length.
+ * @param resp Response buffer (FPR_RPC_MAX_PAYLOAD bytes).
+ * @param resp_len In: response buffer capacity. Out: response length.
+ * @param user_data User data given at registration.
+ * @return ESP_OK to send the response, any other code is returned to the caller as the call status.
+ * @note Runs in the ESP-NOW receive context - must be short and non-blocking.
+ */
+typedef esp_err_t (*fpr_rpc_handler_t)(const uint8_t *peer_mac, fpr_rpc_method_t method,
+                                       const void *req, size_t req_len,
+                                       void *resp, size_t *resp_len, void *user_data);
+
+/**
+ * @brief Completion callback for asynchronous calls.
+ * @param peer_mac MAC address of the called peer.
+ * @param call_id Correlation ID returned by fpr_rpc_call_async().
+ * @param status ESP_OK, ESP_ERR_TIMEOUT, or the error returned by the remote handler.
+ * @param resp Response payload (NULL unless status is ESP_OK).
+ * @param resp_len Response payload length.
+ * @param user_data User data given when the call was issued.
+ * @note Runs in the receive context (response) or esp_timer task (timeout).
+ */
+typedef void (*fpr_rpc_response_cb_t)(const uint8_t *peer_mac, uint32_t call_id, esp_err_t status,
+                                      const void *resp, size_t resp_len, void *user_data);
+
+/**
+ * @brief RPC statistics.
+ */
+typedef struct {
+    uint32_t calls_sent;            // Requests sent
+    uint32_t responses_received;    // Successful responses matched to a pending call
+    uint32_t errors_received;       // Error responses matched to a pending call
+    uint32_t timeouts;              // Calls expired by the timeout wheel
+    uint32_t requests_handled;      // Requests served by local handlers
+    uint32_t unmatched_responses;   // Responses with no pending call (late or duplicate)
+    uint32_t pending;               // Calls currently outstanding
+    uint32_t latency_hist[FPR_RPC_LATENCY_BUCKETS]; // Round-trip latency histogram
+} fpr_rpc_stats_t;
+
+/**
+ * @brief Register a handler for a method ID.
+ * @param method Method ID.
+ * @param handler Handler function.
+ * @param user_data User data passed to the handler.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the handler table is full.
+ * @note Registering an already registered method replaces its handler.
+ */
+esp_err_t fpr_rpc_register(fpr_rpc_method_t method, fpr_rpc_handler_t handler, void *user_data);
+
+/**
+ * @brief Unregister a method handler.
+ * @param method Method ID.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if not registered.
+ */
+esp_err_t fpr_rpc_unregister(fpr_rpc_method_t method);
+
+/**
+ * @brief Issue an asynchronous call.
+ * @param peer_mac Destination peer (must be connected).
+ * @param method Method ID.
+ * @param req Request payload (may be NULL if req_len is 0).
+ * @param req_len Request payload length (<= FPR_RPC_MAX_PAYLOAD).
+ * @param timeout_ms Deadline relative to now.
+ * @param cb Completion callback (required).
+ * @param user_data User data passed to the callback.
+ * @param call_id_out Optional output for the correlation ID.
+ * @return ESP_OK if the call was started, ESP_ERR_NO_MEM if too many calls are outstanding,
+ * or the send error.
+ * @note The callback is invoked exactly once for every call that returned ESP_OK, and never
+ * for one that did not. A call that times out while its send fails returns ESP_OK; the
+ * callback reports ESP_ERR_TIMEOUT.
+ */
+esp_err_t fpr_rpc_call_async(const uint8_t *peer_mac, fpr_rpc_method_t method,
+                             const void *req, size_t req_len, uint32_t timeout_ms,
+                             fpr_rpc_response_cb_t cb, void *user_data, uint32_t *call_id_out);
+
+/**
+ * @brief Issue a blocking call.
+ * @param peer_mac Destination peer (must be connected).
+ * @param method Method ID.
+ * @param req Request payload (may be NULL if req_len is 0).
+ * @param req_len Request payload length (<= FPR_RPC_MAX_PAYLOAD).
+ * @param resp Response buffer (may be NULL if no response payload is expected).
+ * @param resp_len In: response buffer capacity. Out: response length (truncated to capacity).
+ * @param timeout_ms Deadline relative to now.
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT, the error returned by the remote handler,
+ * or ESP_ERR_INVALID_STATE when called from a context the result is delivered on.
+ * @note Must not be called from an ISR, the receive callback, an RPC handler or an
+ * esp_timer callback: the result arrives on those contexts, so the call would never
+ * complete. Such calls are refused where they can be detected. An esp_timer callback
+ * issuing the first call is only caught by the wait bound, which gives up shortly
+ * after timeout_ms and returns ESP_ERR_TIMEOUT. Use fpr_rpc_call_async() there.
+ */
+esp_err_t fpr_rpc_call(const uint8_t *peer_mac, fpr_rpc_method_t method,
+                       const void *req, size_t req_len,
+                       void *resp, size_t *resp_len, uint32_t timeout_ms);
+
+/**
+ * @brief Cancel an outstanding asynchronous call.
+ * @param call_id Correlation ID.
+ * @return ESP_OK if cancelled (callback will not be invoked), ESP_ERR_NOT_FOUND otherwise.
+ */
+esp_err_t fpr_rpc_cancel(uint32_t call_id);
+
+/**
+ * @brief Get RPC statistics.
+ * @param stats Pointer to structure to fill.
+ */
+void fpr_rpc_get_stats(fpr_rpc_stats_t *stats);
+
+/**
+ * @brief Reset RPC statistics (pending count is preserved).
+ */
+void fpr_rpc_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
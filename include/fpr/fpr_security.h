@@ -29,6 +29,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "esp_err.h"
 
 #ifdef __cplusplus
@@ -36,6 +37,7 @@ extern "C" {
 #endif
 
 #define FPR_KEY_SIZE 16  // 128-bit keys
+#define FPR_KEY_CHECK_SIZE 4  // Key check value of a wrapped key
 
 /**
  * @brief Security key structure for FPR peer authentication
@@ -108,6 +110,24 @@ void fpr_security_init_keys(fpr_security_keys_t *keys);
  */
 void fpr_security_clear_keys(fpr_security_keys_t *keys);
 
+/**
+ * @brief Encrypt or decrypt a key sent under a session key both sides hold
+ *
+ * The key is XORed with a keystream of HMAC-SHA256(session_key, nonce), so
+ * the same call on the receiving side restores it.
+ *
+ * @param session_key Session key shared with the other side (FPR_KEY_SIZE bytes)
+ * @param nonce Fresh random value sent along with the wrapped key
+ * @param nonce_len Length of nonce
+ * @param key_in Key to encrypt or decrypt (FPR_KEY_SIZE bytes)
+ * @param key_out Result (FPR_KEY_SIZE bytes), may be key_in
+ * @param check_out FPR_KEY_CHECK_SIZE bytes that only match on both sides
+ *                  when they used the same session key and nonce, or NULL
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t fpr_security_wrap_key(const uint8_t *session_key, const uint8_t *nonce, size_t nonce_len,
+                                const uint8_t *key_in, uint8_t *key_out, uint8_t *check_out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,93 @@
+#pragma once
+
+/**
+ * @file fpr_sleepy.h
+ * @brief FPR Sleepy Clients with Host Downlink Buffering
+ *
+ * Duty-cycled operation for battery clients. Unlike FPR_POWER_LOW, which
+ * only stretches polling intervals, a sleepy client keeps its radio in
+ * ESP-NOW connectionless power save and wakes for one host beacon every
+ * listen_interval beacons.
+ *
+ * Flow:
+ * 1. Host enables beacons with fpr_sleepy_host_enable()
+ * 2. Client calls fpr_sleepy_client_enable() and registers with its host
+ * 3. The host buffers all data for the client in a bounded per-client queue
+ *    (drop-oldest) and flags it in the beacon's pending-data bitmap
+ * 4. The client wakes for a beacon. If its bit is set it polls, stays awake
+ *    until the host signals the buffer is drained, then sleeps again
+ *
+ * Trade-off: worst-case downlink latency is about
+ * beacon_interval * listen_interval. Radio-on time per period is about the
+ * wake guard plus beacon airtime, plus one poll exchange when data is pending.
+ *
+ * Limitations:
+ * - Host/client modes only; up to FPR_MAX_PEER_SLOTS sleepy clients per host
+ * - Handshake control packets bypass the buffer
+ * - Uses ESP-NOW connectionless power save (esp_now_set_wake_window)
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sleepy-client statistics.
+ */
+typedef struct {
+    bool host_enabled;          // Host is beaconing for sleepy clients
+    bool client_enabled;        // This client is duty-cycling
+    bool client_registered;     // Host acknowledged this client as sleepy
+    uint32_t sleepy_peers;      // Registered sleepy clients (host)
+    uint32_t buffered;          // Packets buffered for sleepy clients (host)
+    uint32_t buffer_dropped;    // Packets dropped from full buffers (host, oldest first)
+    uint32_t polls;             // Polls served (host) or sent (client)
+    uint32_t wakeups;           // Wake-ups for a beacon (client)
+    uint32_t missed_fetches;    // Polls that timed out before the buffer drained (client)
+} fpr_sleepy_stats_t;
+
+/**
+ * @brief Enable beacons for sleepy clients (host mode).
+ * @param beacon_interval_ms Beacon interval (>= 20 ms). Ignored while TDMA
+ * runs, because the superframe beacon is used instead.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not in host mode.
+ */
+esp_err_t fpr_sleepy_host_enable(uint16_t beacon_interval_ms);
+
+/**
+ * @brief Disable sleepy-client support (host mode). Buffered data is flushed
+ * to its destinations.
+ * @return ESP_OK on success.
+ */
+esp_err_t fpr_sleepy_host_disable(void);
+
+/**
+ * @brief Start duty-cycling (client mode).
+ * @param listen_interval Wake for every Nth beacon (>= 1).
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not in client mode.
+ * @note Registration with the host happens now if connected, otherwise on connect.
+ */
+esp_err_t fpr_sleepy_client_enable(uint8_t listen_interval);
+
+/**
+ * @brief Stop duty-cycling and keep the radio on (client mode).
+ * @return ESP_OK on success.
+ */
+esp_err_t fpr_sleepy_client_disable(void);
+
+/**
+ * @brief Get sleepy-client statistics.
+ * @param stats Pointer to structure to fill.
+ */
+void fpr_sleepy_get_stats(fpr_sleepy_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,95 @@
+#pragma once
+
+/**
+ * @file fpr_tdma.h
+ * @brief FPR Host-Coordinated TDMA Scheduling
+ *
+ * Optional scheduled mode for dense networks. The host broadcasts a beacon
+ * at the start of every superframe and gives each client its own transmit
+ * slot. Clients queue application data and release it only during their
+ * slot, so uplink traffic no longer contends for the medium.
+ *
+ * Superframe layout:
+ *   | slot 0: beacon + unscheduled | slot 1 | slot 2 | ... | slot N |
+ *
+ * Slot 0 carries the beacon, connection handshakes and service traffic.
+ * The superframe grows and shrinks with the highest assigned slot.
+ * Clients that stay silent for idle_superframes lose their slot, and the
+ * slot is handed to the next client that asks for one.
+ *
+ * Clients follow the schedule automatically whenever their host runs TDMA.
+ * Slot timing uses network time (fpr_timesync.h) when synchronized and
+ * falls back to beacon arrival time otherwise. A client that misses
+ * FPR_TDMA_MAX_MISSED_BEACONS beacons in a row reverts to unscheduled sends.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Consecutive missed beacons after which a client stops using its slot */
+#define FPR_TDMA_MAX_MISSED_BEACONS 3
+
+/**
+ * @brief Host TDMA configuration.
+ */
+typedef struct {
+    uint32_t slot_us;           // Slot length including guard time (>= 1000)
+    uint8_t packets_per_slot;   // Packets a client may send per slot (>= 1)
+    uint8_t idle_superframes;   // Silent superframes before a slot is reclaimed (>= 1)
+} fpr_tdma_config_t;
+
+/**
+ * @brief TDMA status.
+ */
+typedef struct {
+    bool host_running;          // Host is scheduling (host mode)
+    bool scheduled;             // Client is sending in its slot (client mode)
+    uint8_t slot;               // Assigned slot (client), 0 if none
+    uint16_t slot_count;        // Slots in the current superframe
+    uint32_t superframe_us;     // Current superframe length
+    uint32_t beacons;           // Beacons sent (host) or received (client)
+    uint32_t slots_assigned;    // Slot assignments made (host)
+    uint32_t slots_reclaimed;   // Idle slots reclaimed (host)
+    uint32_t deferred;          // Packets queued for a slot (client)
+    uint32_t queue_full;        // Packets rejected because the slot queue was full (client)
+    uint32_t fallbacks;         // Reverts to unscheduled sending (client)
+} fpr_tdma_status_t;
+
+/**
+ * @brief Get the default host TDMA configuration.
+ * @return 5 ms slots, 2 packets per slot, reclaim after 8 idle superframes.
+ */
+fpr_tdma_config_t fpr_tdma_default_config(void);
+
+/**
+ * @brief Start TDMA scheduling (host mode).
+ * @param config Configuration (NULL for defaults).
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not in host mode.
+ */
+esp_err_t fpr_tdma_host_start(const fpr_tdma_config_t *config);
+
+/**
+ * @brief Stop TDMA scheduling (host mode).
+ * @return ESP_OK on success.
+ * @note Clients revert to unscheduled sending on the next beacon or after
+ * FPR_TDMA_MAX_MISSED_BEACONS superframes.
+ */
+esp_err_t fpr_tdma_host_stop(void);
+
+/**
+ * @brief Get TDMA status.
+ * @param status Pointer to structure to fill.
+ */
+void fpr_tdma_get_status(fpr_tdma_status_t *status);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+ * @file fpr_timesync.h
+ * @brief FPR Network Time Synchronization
+ *
+ * Gives every node a shared clock derived from the host's esp_timer.
+ * Clients periodically exchange four timestamps with their host
+ * (NTP-style), keep the lowest round-trip sample of a small window to
+ * estimate the offset, and track crystal drift between exchanges.
+ *
+ * Offset from one exchange:
+ *   offset = ((t2 - t1) + (t3 - t4)) / 2,  rtt = (t4 - t1) - (t3 - t2)
+ * where t1/t4 are client send/receive times and t2/t3 are host
+ * receive/send times.
+ *
+ * The host is the time reference (always synced, zero error).
+ *
+ * Across hops: extenders sync with one-hop neighbour frames that are never
+ * forwarded. An extender locks to the first neighbour that answers: the
+ * host, or an extender that is itself synced. Each response carries the
+ * server's stratum and error bound, which is added to the sample's, so the
+ * bound grows with every hop.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Time synchronization status.
+ */
+typedef struct {
+    bool synced;                // Network time available
+    bool is_reference;          // This node is the time reference (host)
+    uint8_t stratum;            // Hops from the reference: 0 on the host, 1 on its clients
+    int64_t offset_us;          // Network time minus local time at last sync
+    int32_t drift_ppb;          // Estimated drift of the reference relative to local clock
+    uint32_t rtt_us;            // Round-trip time of the sample in use
+    uint32_t error_us;          // Current error bound
+    uint32_t samples;           // Accepted samples
+    uint32_t rejected;          // Samples rejected (RTT above limit, stale)
+    int64_t last_sync_age_us;   // Time since the sample in use was taken
+} fpr_timesync_status_t;
+
+/**
+ * @brief Get the current network time.
+ * @param time_us Output network time in microseconds.
+ * @param error_us Optional output error bound in microseconds.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not synchronized yet.
+ */
+esp_err_t fpr_timesync_get_time(int64_t *time_us, uint32_t *error_us);
+
+/**
+ * @brief Convert a local esp_timer timestamp to network time.
+ * @param local_us Local time (esp_timer_get_time()).
+ * @return Network time, or local_us unchanged if not synchronized.
+ */
+int64_t fpr_timesync_local_to_network(int64_t local_us);
+
+/**
+ * @brief Convert a network timestamp to local esp_timer time.
+ * @param network_us Network time.
+ * @return Local time, or network_us unchanged if not synchronized.
+ * @note Useful for scheduling a local action at a network-wide instant.
+ */
+int64_t fpr_timesync_network_to_local(int64_t network_us);
+
+/**
+ * @brief Check whether network time is available.
+ * @return true if synchronized (always true on the host).
+ */
+bool fpr_timesync_is_synced(void);
+
+/**
+ * @brief Get detailed synchronization status.
+ * @param status Pointer to structure to fill.
+ */
+void fpr_timesync_get_status(fpr_timesync_status_t *status);
+
+/**
+ * @brief Send a synchronization request now: to the host (client mode), or
+ * to the server neighbour, broadcast while there is none (extender mode).
+ * @return ESP_OK if sent, ESP_ERR_INVALID_STATE if a client is not connected to a host.
+ */
+esp_err_t fpr_timesync_trigger(void);
+
+#ifdef __cplusplus
+}
+#endif
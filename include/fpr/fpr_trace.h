@@ -0,0 +1,156 @@
+#pragma once
+
+/**
+ * @file fpr_trace.h
+ * @brief FPR Packet-Event Trace
+ *
+ * With FPR_DEBUG the data path prints text for every frame, and the UART
+ * time alone changes timing enough to hide the problem being chased. The
+ * trace instead records each event as a fixed-size binary record in a RAM
+ * ring, so it costs a few stores per frame and can stay on in the field.
+ *
+ * Flow:
+ * 1. Enable CONFIG_FPR_TRACE_ENABLE. Without it the hooks compile to
+ *    nothing and the functions below do nothing
+ * 2. The data path records rx, enqueue, drop (with a reason), tx,
+ *    tx-complete, forward and handshake events
+ * 3. Read records incrementally with fpr_trace_read(), or dump the whole
+ *    ring with fpr_trace_dump() (any byte sink) or fpr_trace_dump_console()
+ * 4. tools/fpr_trace.py decodes a dump, or a console log containing one,
+ *    to JSON or pcap
+ *
+ * Writers claim a slot with one atomic add and never block, so records can
+ * come from the Wi-Fi task, application tasks and both cores at once. Once
+ * full, the ring overwrites its oldest records.
+ *
+ * Limitations:
+ * - A record whose writer is still filling it when the ring is read is
+ *   skipped by that read
+ * - Timestamps are the low 32 bits of esp_timer_get_time() and wrap every
+ *   ~71 minutes; the decoder unwraps them assuming records are in order
+ * - The ring survives fpr_network_deinit() but not a reset
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FPR_TRACE_FILE_MAGIC "FPRT"
+#define FPR_TRACE_FILE_VERSION 1
+
+/**
+ * @brief Trace event types.
+ */
+typedef enum {
+    FPR_TRACE_RX = 1,           // Frame received; arg = package type
+    FPR_TRACE_ENQUEUE,          // Frame queued for the application; arg = queue depth
+    FPR_TRACE_DROP,             // Frame dropped; arg = fpr_trace_drop_t
+    FPR_TRACE_TX,               // Frame handed to ESP-NOW; arg = 0 ok, 1 failed
+    FPR_TRACE_TX_DONE,          // Send callback; arg = 0 acked, 1 not acked
+    FPR_TRACE_FORWARD,          // Frame relayed for another node; arg = hop count
+    FPR_TRACE_HANDSHAKE,        // Handshake step 1-4; arg bit 7 set on failure
+} fpr_trace_event_t;
+
+/**
+ * @brief Reasons recorded with FPR_TRACE_DROP.
+ */
+typedef enum {
+    FPR_TRACE_DROP_PAUSED = 1,  // Network paused
+    FPR_TRACE_DROP_MALFORMED,   // Wrong size or invalid header
+    FPR_TRACE_DROP_VERSION,     // Rejected by the version handler
+    FPR_TRACE_DROP_REPLAY,      // Sequence number older than the last one seen
+    FPR_TRACE_DROP_QUEUE_FULL,  // Peer receive queue full
+    FPR_TRACE_DROP_LATEST_ONLY, // Fragment or stale packet in latest-only mode
+    FPR_TRACE_DROP_SUPERSEDED,  // Partial message replaced by a new one
+    FPR_TRACE_DROP_ORPHAN,      // Fragment without its start
+    FPR_TRACE_DROP_NO_ROUTE,    // Nowhere to forward to
+    FPR_TRACE_DROP_HOP_LIMIT,   // max_hops reached
+    FPR_TRACE_DROP_UNAUTHORIZED,// Relayed by a node we are not linked with
+} fpr_trace_drop_t;
+
+#define FPR_TRACE_HANDSHAKE_FAILED 0x80
+
+/**
+ * @brief One trace record. The layout is the on-wire dump format
+ * (little-endian) and does not change within FPR_TRACE_FILE_VERSION.
+ */
+typedef struct {
+    uint32_t seq;               // Position in the ring, counts every record ever written
+    uint32_t timestamp_us;      // Low 32 bits of esp_timer_get_time()
+    uint32_t sequence_num;      // Frame sequence number (0 if no frame)
+    int32_t package_id;         // Frame package ID (0 if no frame)
+    uint8_t peer[6];            // Neighbor involved: sender, next hop or handshake peer
+    uint8_t event;              // fpr_trace_event_t
+    uint8_t arg;                // Event-specific, see fpr_trace_event_t
+} fpr_trace_record_t;
+
+/**
+ * @brief Header at the start of every dump.
+ */
+typedef struct {
+    char magic[4];              // FPR_TRACE_FILE_MAGIC
+    uint16_t version;           // FPR_TRACE_FILE_VERSION
+    uint16_t record_size;       // sizeof(fpr_trace_record_t)
+    uint8_t node_mac[6];        // Node the trace was taken on
+    uint16_t reserved;
+} fpr_trace_file_header_t;
+
+/**
+ * @brief Byte sink for fpr_trace_dump().
+ * @return ESP_OK to continue, anything else aborts the dump.
+ */
+typedef esp_err_t (*fpr_trace_write_fn_t)(const void *data, size_t size, void *ctx);
+
+/**
+ * @brief Pause or resume recording. Recording starts enabled.
+ * @param enable true to record.
+ */
+void fpr_trace_set_enabled(bool enable);
+
+/**
+ * @brief Copy records written since a cursor.
+ *
+ * Start with *cursor = 0. Records already overwritten are skipped, and the
+ * difference between the first returned seq and the cursor is the number lost.
+ *
+ * @param cursor In: first seq wanted. Out: seq to pass on the next call.
+ * @param records Destination array.
+ * @param max Capacity of records.
+ * @return Number of records copied (0 if tracing is compiled out).
+ */
+size_t fpr_trace_read(uint32_t *cursor, fpr_trace_record_t *records, size_t max);
+
+/**
+ * @brief Write a header followed by every record in the ring to a byte sink.
+ * @param write Sink, e.g. a wrapper around fwrite() or uart_write_bytes().
+ * @param ctx Passed to write.
+ * @return ESP_OK, the sink's error, or ESP_ERR_NOT_SUPPORTED if tracing is compiled out.
+ */
+esp_err_t fpr_trace_dump(fpr_trace_write_fn_t write, void *ctx);
+
+/**
+ * @brief Dump the ring to the console as hex lines prefixed "FPRT ".
+ *
+ * The lines survive being mixed with other log output, so a saved monitor
+ * log can be fed to tools/fpr_trace.py directly.
+ *
+ * @return ESP_OK, or ESP_ERR_NOT_SUPPORTED if tracing is compiled out.
+ */
+esp_err_t fpr_trace_dump_console(void);
+
+/**
+ * @brief Discard all records.
+ */
+void fpr_trace_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,121 @@
+#pragma once
+
+/**
+ * @file fpr_transport.h
+ * @brief FPR Transport Interface
+ *
+ * Everything FPR puts on or takes off the air goes through one transport:
+ * frame send, peer registration, received frames and send results. ESP-NOW
+ * is the default. Another transport (fpr_transport_udp.h on Linux, or an
+ * application's own) carries the same frames over a different link.
+ *
+ * Flow:
+ * 1. Optionally fpr_transport_set() before the first fpr_network_init()
+ * 2. fpr_network_init() calls init() and then set_callbacks()
+ * 3. Frames are handed to send(); the transport reports each one through
+ *    the tx-done callback, and every frame it receives through the rx
+ *    callback
+ * 4. The last fpr_network_deinit() calls deinit()
+ *
+ * Limitations:
+ * - Channel scanning, channel migration and the Wi-Fi channel setting in
+ *   fpr_init_config_t still talk to the Wi-Fi driver directly
+ * - mtu() must be at least one FPR package; FPR never sends more than that
+ *   in one frame
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FPR_TRANSPORT_ADDR_LEN 6
+#define FPR_TRANSPORT_KEY_LEN 16
+
+/**
+ * @brief Link metadata of a received frame.
+ */
+typedef struct {
+    const uint8_t *src_addr;
+    const uint8_t *dest_addr;   // Own address or broadcast
+    int8_t rssi;                // dBm, 0 if the link has no signal strength
+    int8_t noise_floor;         // dBm, 0 if unknown
+    uint8_t channel;            // 0 if the link has no channels
+} fpr_transport_rx_info_t;
+
+/**
+ * @brief A peer the transport should be able to reach.
+ */
+typedef struct {
+    uint8_t addr[FPR_TRANSPORT_ADDR_LEN];
+    uint8_t channel;            // 0 = current channel
+    bool encrypt;               // Link-layer encryption with lmk
+    uint8_t lmk[FPR_TRANSPORT_KEY_LEN];
+} fpr_transport_peer_t;
+
+/**
+ * @brief Called for every received frame. May run on the transport's own
+ * task; data is only valid during the call.
+ */
+typedef void (*fpr_transport_rx_cb_t)(const fpr_transport_rx_info_t *info, const uint8_t *data, int len);
+
+/**
+ * @brief Called once per frame accepted by send(), when its fate is known.
+ */
+typedef void (*fpr_transport_tx_done_cb_t)(const uint8_t *dest_addr, bool success);
+
+/**
+ * @brief Transport operations. ctx is fpr_transport_t.ctx.
+ */
+typedef struct {
+    const char *name;
+    esp_err_t (*init)(void *ctx);
+    esp_err_t (*deinit)(void *ctx);
+    esp_err_t (*set_callbacks)(void *ctx, fpr_transport_rx_cb_t rx, fpr_transport_tx_done_cb_t tx_done);
+    /** Queue one frame. ESP_ERR_NO_MEM (ESP-NOW: ESP_ERR_ESPNOW_NO_MEM) when momentarily full. */
+    esp_err_t (*send)(void *ctx, const uint8_t *dest_addr, const uint8_t *data, size_t len);
+    esp_err_t (*add_peer)(void *ctx, const fpr_transport_peer_t *peer);
+    esp_err_t (*mod_peer)(void *ctx, const fpr_transport_peer_t *peer);
+    esp_err_t (*del_peer)(void *ctx, const uint8_t *addr);
+    /** Largest frame send() accepts, in bytes. */
+    size_t (*mtu)(void *ctx);
+    /** Optional, NULL for the Wi-Fi station MAC: this node's address on the link. Called before init(). */
+    esp_err_t (*get_addr)(void *ctx, uint8_t addr[FPR_TRANSPORT_ADDR_LEN]);
+    /** Optional, NULL if unsupported: how long the receiver stays on per wake interval. */
+    esp_err_t (*set_wake_window)(void *ctx, uint16_t window_ms);
+    /** Optional, NULL if unsupported: how often the receiver wakes. */
+    esp_err_t (*set_wake_interval)(void *ctx, uint16_t interval_ms);
+} fpr_transport_ops_t;
+
+typedef struct {
+    const fpr_transport_ops_t *ops;
+    void *ctx;
+} fpr_transport_t;
+
+/**
+ * @brief Use a transport for all FPR traffic.
+ * @param transport Transport, NULL for ESP-NOW. Must stay valid while in use.
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if a network is initialized.
+ */
+esp_err_t fpr_transport_set(const fpr_transport_t *transport);
+
+/**
+ * @brief The transport in use.
+ */
+const fpr_transport_t *fpr_transport_get(void);
+
+/**
+ * @brief The ESP-NOW transport.
+ */
+const fpr_transport_t *fpr_transport_espnow(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+
+/**
+ * @file fpr_transport_udp.h
+ * @brief FPR UDP Transport (Linux)
+ *
+ * Carries FPR frames in UDP datagrams so Linux machines (ESP-IDF linux
+ * target) can take part in a network: gateway boxes running a host at
+ * high packet rates, or several processes on one machine talking over
+ * loopback in integration tests.
+ *
+ * Each datagram is a small header (magic, source and destination address)
+ * followed by the FPR frame. Broadcasts, and unicasts to an address not
+ * yet heard from, go to an IPv4 multicast group every node joins.
+ * Unicasts to a known address go straight to the socket it sent from.
+ * Each node sends from its own unicast socket, so any number of nodes can
+ * share one host and one group port.
+ *
+ * One I/O task waits on both sockets and the send queue with epoll, and
+ * moves datagrams with recvmmsg()/sendmmsg() in batches.
+ *
+ * Flow:
+ * 1. fpr_transport_udp_create() with a unique address for this node
+ * 2. fpr_transport_set() with the returned transport
+ * 3. fpr_network_init() / fpr_network_start() as usual
+ * 4. After the last fpr_network_deinit(): fpr_transport_set(NULL) and
+ *    fpr_transport_udp_destroy()
+ *
+ * Limitations:
+ * - Linux only. The component builds it for CONFIG_IDF_TARGET_LINUX
+ * - A send result only means the kernel accepted the datagram; UDP has
+ *   no link-layer acknowledgement
+ * - No link encryption: peer keys are ignored, use FPR security
+ * - RSSI, noise floor and channel of received frames are 0
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_transport.h"
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FPR_TRANSPORT_UDP_DEFAULT_PORT 47820
+#define FPR_TRANSPORT_UDP_DEFAULT_GROUP "239.255.70.82"
+#define FPR_TRANSPORT_UDP_MAX_BATCH 32
+#define FPR_TRANSPORT_UDP_MTU 512               // Largest FPR frame carried
+#define FPR_TRANSPORT_UDP_MAX_ROUTES 64         // Addresses remembered for unicast
+
+typedef struct {
+    uint8_t addr[FPR_TRANSPORT_ADDR_LEN];       // This node's FPR address, unique on the network
+    uint16_t port;                              // Group port, 0 = FPR_TRANSPORT_UDP_DEFAULT_PORT
+    uint16_t unicast_port;                      // 0 = any free port
+    const char *group;                          // IPv4 multicast group, NULL = FPR_TRANSPORT_UDP_DEFAULT_GROUP
+    const char *interface;                      // IPv4 address of the interface to use, NULL = default route
+    uint8_t batch;                              // Datagrams per recvmmsg()/sendmmsg(), 0 = FPR_TRANSPORT_UDP_MAX_BATCH
+    uint8_t ttl;                                // Multicast TTL, 0 = 1 (this link only)
+    uint16_t queue_len;                         // Frames waiting to be sent, 0 = 64
+} fpr_transport_udp_config_t;
+
+typedef struct {
+    uint64_t rx_frames;
+    uint64_t rx_batches;        // recvmmsg() calls that returned frames
+    uint64_t rx_dropped;        // Bad header, own frames, other destinations
+    uint64_t tx_frames;
+    uint64_t tx_batches;        // sendmmsg() calls
+    uint64_t tx_failed;
+} fpr_transport_udp_stats_t;
+
+/**
+ * @brief Create a UDP transport. Sockets are opened by fpr_network_init().
+ * @param config Configuration.
+ * @param transport Filled with the transport, for fpr_transport_set().
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM.
+ */
+esp_err_t fpr_transport_udp_create(const fpr_transport_udp_config_t *config, fpr_transport_t **transport);
+
+/**
+ * @brief Free a UDP transport. It must not be the transport in use.
+ */
+void fpr_transport_udp_destroy(fpr_transport_t *transport);
+
+/**
+ * @brief Send unicasts for an address to a fixed endpoint instead of
+ * learning it from received frames.
+ * @param transport UDP transport.
+ * @param addr FPR address.
+ * @param ip IPv4 address of the node.
+ * @param port Its unicast port.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM if the route table is full.
+ */
+esp_err_t fpr_transport_udp_add_route(fpr_transport_t *transport, const uint8_t addr[FPR_TRANSPORT_ADDR_LEN],
+                                      const char *ip, uint16_t port);
+
+/**
+ * @brief Copy the transport's counters.
+ */
+void fpr_transport_udp_get_stats(const fpr_transport_t *transport, fpr_transport_udp_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,110 @@
+#pragma once
+
+/**
+ * @file fpr_tree.h
+ * @brief FPR Collection Tree Routing
+ *
+ * Most mesh traffic flows from many nodes to one sink. Instead of learning
+ * a route per destination from observed traffic, extenders build a tree
+ * rooted at the sink and send upstream data to their parent.
+ *
+ * Flow:
+ * 1. The sink (a host or an extender) calls fpr_tree_set_sink() and
+ *    broadcasts beacons with path cost 0
+ * 2. Every node estimates the delivery ratio of each neighbor from beacon
+ *    sequence gaps and send acknowledgements. The link cost is the expected
+ *    number of transmissions (ETX, x10)
+ * 3. A node's parent is the neighbor with the lowest advertised cost plus
+ *    link cost. The node then advertises that sum in its own beacons
+ * 4. fpr_tree_send() hands data to the parent, and each node passes it on
+ *    to its own parent until it reaches the sink
+ *
+ * Every data frame carries the sender's cost. A node receiving data from a
+ * neighbor whose cost is not above its own has found a loop: it beacons
+ * right away so the neighbor learns the real cost, and drops the parent if
+ * the frame came from it. Frames are dropped after FPR_DEFAULT_MAX_HOPS.
+ *
+ * Nodes keep no state per destination, only CONFIG_FPR_TREE_MAX_NEIGHBORS
+ * neighbor entries.
+ *
+ * Limitations:
+ * - Only single-packet data travels the tree
+ * - Reliability comes from ESP-NOW link retries and parent changes; there
+ *   is no end-to-end acknowledgement
+ * - A host sink accepts tree data from nodes that are not connected peers
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "esp_err.h"
+#include "fpr/fpr_def.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Position of this node in the collection tree.
+ */
+typedef struct {
+    bool is_sink;
+    bool has_parent;
+    uint8_t parent_mac[6];
+    uint8_t sink_mac[6];
+    uint16_t cost;              // Path cost to the sink, ETX x10 (0xFFFF without a parent)
+    uint16_t parent_link_cost;  // Link cost to the parent, ETX x10
+    int8_t parent_rssi;
+    uint8_t neighbors;          // Neighbor entries in use
+} fpr_tree_info_t;
+
+/**
+ * @brief Collection tree statistics.
+ */
+typedef struct {
+    uint32_t beacons_tx;
+    uint32_t beacons_rx;
+    uint32_t parent_changes;
+    uint32_t sent;              // Data originated here
+    uint32_t forwarded;         // Data passed on for children
+    uint32_t delivered;         // Data handed to the application (sink)
+    uint32_t no_parent;         // Data dropped for lack of a parent
+    uint32_t loops;             // Loops detected
+    uint32_t hop_limit;         // Data dropped after FPR_DEFAULT_MAX_HOPS
+} fpr_tree_stats_t;
+
+/**
+ * @brief Make this node the root of the collection tree (host or extender mode).
+ * @param enable true to start advertising cost 0, false to stop.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the network is not initialized.
+ */
+esp_err_t fpr_tree_set_sink(bool enable);
+
+/**
+ * @brief Send data toward the sink along the tree (extender mode).
+ * @param data Payload.
+ * @param size Payload size; must fit in a single packet.
+ * @param package_id Application package ID (>= 0), seen by the sink.
+ * @return ESP_OK if handed to the parent, ESP_ERR_INVALID_STATE without a parent,
+ * ESP_ERR_INVALID_SIZE if the data does not fit.
+ */
+esp_err_t fpr_tree_send(const void *data, size_t size, fpr_package_id_t package_id);
+
+/**
+ * @brief Get this node's position in the tree.
+ * @param info Pointer to structure to fill.
+ */
+void fpr_tree_get_info(fpr_tree_info_t *info);
+
+/**
+ * @brief Get collection tree statistics.
+ * @param stats Pointer to structure to fill.
+ */
+void fpr_tree_get_stats(fpr_tree_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
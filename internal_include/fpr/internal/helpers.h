@@ -15,7 +15,12 @@
  */
 
 #include "fpr/internal/private_defs.h"
+#include "fpr/fpr_trace.h"
+#include "fpr/fpr_capture.h"
+#include "fpr/fpr_event.h"
+#include "fpr/internal/transport.h"
 #include "esp_timer.h"
+#include "esp_wifi.h"
 
 // Helper: Safe string copy with NUL termination
 static inline void _safe_string_copy(char *dest, const char *src, size_t dest_size)
@@ -32,13 +37,41 @@ static inline FPR_STORE_HASH_TYPE *_get_peer_from_map(const uint8_t *peer_mac)
     return (FPR_STORE_HASH_TYPE *)hashmap_get(&fpr_net.peers_map, peer_mac);
 }
 
+// Helper: Get peer by compact slot index
+static inline FPR_STORE_HASH_TYPE *_get_peer_by_slot(uint8_t slot)
+{
+    return (slot < FPR_MAX_PEER_SLOTS) ? fpr_net.peer_slots[slot] : NULL;
+}
+
 // Helper: Update peer RSSI and timestamp from ESP-NOW info
 static inline void _update_peer_rssi_and_timestamp(FPR_STORE_HASH_TYPE *peer, const esp_now_recv_info_t *esp_now_info)
 {
     if (peer && esp_now_info) {
         peer->last_seen = esp_timer_get_time();
         peer->rssi = esp_now_info->rx_ctrl->rssi;
+        peer->channel = esp_now_info->rx_ctrl->channel;
+    }
+}
+
+// Helper: Get the channel the radio is on now (0 if unknown)
+static inline uint8_t _fpr_get_current_channel(void)
+{
+    uint8_t primary = 0;
+    wifi_second_chan_t second;
+    if (esp_wifi_get_channel(&primary, &second) != ESP_OK) {
+        return 0;
     }
+    return primary;
+}
+
+// Helper: Host load in percent from an announcement, -1 if the host does not report it
+static inline int _fpr_host_load_pct(const fpr_host_load_t *load)
+{
+    if (!(load->flags & FPR_HOST_LOAD_VALID) || load->capacity == 0) {
+        return -1;
+    }
+    int pct = (load->connected * 100) / load->capacity;
+    return pct > load->queue_pct ? pct : load->queue_pct;
 }
 
 // Helper: Get interval adjusted for power mode
@@ -50,6 +83,76 @@ static inline uint32_t _fpr_get_power_adjusted_interval(uint32_t base_interval_m
     return base_interval_ms;
 }
 
+// Packet-event trace hooks; compiled out unless CONFIG_FPR_TRACE_ENABLE
+#if (FPR_TRACE_ENABLE == 1)
+void _fpr_trace(fpr_trace_event_t event, uint8_t arg, const uint8_t *peer, const fpr_package_t *package);
+#define FPR_TRACE(event, arg, peer, package) _fpr_trace((event), (uint8_t)(arg), (peer), (package))
+#else
+#define FPR_TRACE(event, arg, peer, package) ((void)0)
+#endif
+
+#if (FPR_CAPTURE_ENABLE == 1)
+void _fpr_capture_frame(fpr_capture_direction_t direction, const uint8_t *src, const uint8_t *dst,
+                        int8_t rssi, uint8_t channel, const void *frame, size_t len);
+#endif
+
+#if (FPR_BRIDGE_ENABLE == 1)
+// Forward an application data package to the serial bridge (fpr_bridge.c)
+void _fpr_bridge_on_data(const uint8_t *peer_mac, const fpr_package_t *package);
+#endif
+
+// Connection event stream (fpr_event.c). Must not be called inside a critical section.
+void _fpr_event_init(void);
+void _fpr_event_emit(fpr_event_t *event);
+void _fpr_event_peer(fpr_event_type_t type, const uint8_t *peer_mac);
+
+/**
+ * @brief Put one frame on the air. Every FPR transmission goes through here
+ * so tracing and capture see all of them.
+ */
+esp_err_t _fpr_radio_send(const uint8_t *dest, const fpr_package_t *package);
+
+// True on the task the transport delivers received frames on (fpr.c)
+bool _fpr_is_receive_task(void);
+
+// Fold live counters into the 64-bit totals (fpr.c)
+void _fpr_stats_fold(void);
+
+// Hot-path statistics increment: one relaxed atomic add, no lock. Crossing
+// half the 32-bit range folds, which happens once per 2^31 counts.
+static inline void _fpr_stat_add(fpr_stat_id_t id, uint32_t n)
+{
+    uint32_t prev = __atomic_fetch_add(&fpr_net.stats.live[id], n, __ATOMIC_RELAXED);
+    if (((prev + n) ^ prev) & 0x80000000u) {
+        _fpr_stats_fold();
+    }
+}
+
+// Next outgoing sequence number. Senders run on several tasks and timers.
+static inline uint32_t _fpr_next_sequence_num(void)
+{
+    return __atomic_add_fetch(&fpr_net.tx_sequence_num, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Renumber a held-back package as it finally goes out.
+ *
+ * Frames sent while it waited carry newer numbers, and receivers drop older
+ * ones as replays. Fragments keep sharing one number per message: it is
+ * drawn at SINGLE/START and carried in message_seq for the rest.
+ */
+static inline void _fpr_restamp_sequence(fpr_package_t *package, uint32_t *message_seq)
+{
+    if (package->sequence_num == 0) {
+        return;
+    }
+    if (package->package_type == FPR_PACKAGE_TYPE_SINGLE || package->package_type == FPR_PACKAGE_TYPE_START ||
+        *message_seq == 0) {
+        *message_seq = _fpr_next_sequence_num();
+    }
+    package->sequence_num = *message_seq;
+}
+
 static inline bool is_broadcast_address(const uint8_t *mac)
 {
     const uint8_t broadcast_addr[6] = FPR_BROADCAST_ADDRESS;
@@ -76,8 +179,30 @@ static inline void fpr_set_peer_info(esp_now_peer_info_t *gen_info)
 
 void _store_data_from_peer_helper(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *data);
 
+// Per-peer statistics (fpr_store_hash_t.stats). All take fpr_net.peer_stats_lock.
+void _peer_stats_on_rx(FPR_STORE_HASH_TYPE *peer);
+void _peer_stats_on_replay(FPR_STORE_HASH_TYPE *peer);
+void _peer_stats_on_link_frame(const uint8_t *peer_mac, const fpr_package_t *package);
+void _peer_stats_on_frag_drop(FPR_STORE_HASH_TYPE *peer, fpr_frag_drop_reason_t reason, uint32_t fragments);
+void _peer_stats_on_enqueue(FPR_STORE_HASH_TYPE *peer, bool queued);
+void _peer_stats_on_send(const uint8_t *peer_mac, esp_err_t err);
+void _peer_stats_on_send_status(const uint8_t *peer_mac, bool success);
+
+// Hand a report that reached us through other nodes to the application, as
+// coming from report->origin_mac. Queued under the origin if it is a known
+// peer, else under fallback (may be NULL: callback only).
+void _deliver_as_origin(FPR_STORE_HASH_TYPE *fallback, fpr_package_t *report);
+
 esp_err_t _add_peer_internal(uint8_t *peer_mac, const char *name, bool is_connected, uint32_t key);
 
+// Change peer->state (and is_connected with it), posting connected,
+// disconnected and blocked events on transitions. reason is used when a
+// connected peer leaves FPR_PEER_STATE_CONNECTED. The peer's slot is
+// assigned on entering FPR_PEER_STATE_CONNECTED and released on leaving it.
+void _peer_set_state(FPR_STORE_HASH_TYPE *peer, fpr_peer_state_t state, fpr_event_reason_t reason);
+
+void _peer_slot_release(FPR_STORE_HASH_TYPE *peer);
+
 esp_err_t _add_discovered_peer(const char *name, uint8_t *address, uint32_t key, bool is_connected);
 
 void _copy_peer_to_info(const FPR_STORE_HASH_TYPE *peer, fpr_peer_info_t *info);
@@ -0,0 +1,89 @@
+#pragma once
+
+/**
+ * @file log.h
+ * @brief FPR Rate-Limited Data Path Logging
+ *
+ * Log sites on the data path run once per frame. Each FPR_LOGx_RL() site
+ * gets its own token bucket (CONFIG_FPR_LOG_RATE_PER_SEC, bursts of
+ * CONFIG_FPR_LOG_BURST). Messages over the limit are counted, not printed.
+ * The count is reported with the site's next message, and periodically for
+ * sites that went quiet.
+ *
+ * Sites above CONFIG_FPR_LOG_LEVEL compile to nothing. With
+ * CONFIG_FPR_LOG_DEFERRED the calling task only copies the arguments into
+ * a queue, and a low-priority task does the formatting and the UART write.
+ *
+ * Deferred arguments are copied as 32-bit words, so they must be integers
+ * of at most 32 bits or pointers to strings that stay valid (literals,
+ * esp_err_to_name()), never a buffer that may be reused. At most
+ * FPR_LOG_MAX_ARGS arguments (a MACSTR counts as six).
+ * 
+ * @warning Internal API - subject to change without notice.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_config.h"
+#include "esp_log.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FPR_LOG_MAX_ARGS 16
+
+typedef struct fpr_log_site {
+    const char *file;
+    const char *tag;                // Set on first use; TAGs are not constant expressions
+    struct fpr_log_site *next;      // Sites that ever suppressed, for summaries
+    int64_t last_us;                // Last refill
+    uint32_t tokens;                // Tokens x1000
+    uint32_t suppressed;            // Suppressed since last reported
+    uint16_t line;
+    bool listed;
+} fpr_log_site_t;
+
+bool _fpr_log_admit(fpr_log_site_t *site, const char *tag, uint32_t *suppressed);
+void _fpr_log_emit(const fpr_log_site_t *site, esp_log_level_t level, const char *tag, uint32_t suppressed,
+                   const char *fmt, int nargs, ...) __attribute__((format(printf, 5, 7)));
+
+/**
+ * @brief Start the deferred log task. Safe to call more than once.
+ */
+void _fpr_log_init(void);
+
+#define _FPR_LOG_NARGS(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) N
+#define FPR_LOG_NARGS(...) _FPR_LOG_NARGS(0, ##__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+#define FPR_LOG_RL(level, tag, fmt, ...) do {                                                   \
+    static fpr_log_site_t _fpr_log_site = { .file = __FILE__, .line = __LINE__ };                \
+    uint32_t _fpr_log_suppressed;                                                                \
+    if (_fpr_log_admit(&_fpr_log_site, (tag), &_fpr_log_suppressed)) {                           \
+        _fpr_log_emit(&_fpr_log_site, (level), (tag), _fpr_log_suppressed, fmt,                  \
+                      FPR_LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__);                                \
+    }                                                                                            \
+} while (0)
+
+#if (FPR_LOG_LEVEL >= 1)
+#define FPR_LOGE_RL(tag, fmt, ...) FPR_LOG_RL(ESP_LOG_ERROR, tag, fmt, ##__VA_ARGS__)
+#else
+#define FPR_LOGE_RL(tag, fmt, ...) ((void)0)
+#endif
+
+#if (FPR_LOG_LEVEL >= 2)
+#define FPR_LOGW_RL(tag, fmt, ...) FPR_LOG_RL(ESP_LOG_WARN, tag, fmt, ##__VA_ARGS__)
+#else
+#define FPR_LOGW_RL(tag, fmt, ...) ((void)0)
+#endif
+
+#if (FPR_LOG_LEVEL >= 3)
+#define FPR_LOGI_RL(tag, fmt, ...) FPR_LOG_RL(ESP_LOG_INFO, tag, fmt, ##__VA_ARGS__)
+#else
+#define FPR_LOGI_RL(tag, fmt, ...) ((void)0)
+#endif
+
+#if (FPR_LOG_LEVEL >= 4)
+#define FPR_LOGD_RL(tag, fmt, ...) FPR_LOG_RL(ESP_LOG_DEBUG, tag, fmt, ##__VA_ARGS__)
+#else
+#define FPR_LOGD_RL(tag, fmt, ...) ((void)0)
+#endif
@@ -18,14 +18,26 @@
 #include "fpr/fpr_def.h"
 #include "fpr/fpr_config.h"
 #include "fpr/fpr_security.h"
+#include "fpr/fpr_rpc.h"
+#include "fpr/fpr_pubsub.h"
+#include "fpr/fpr_timesync.h"
+#include "fpr/fpr_tdma.h"
+#include "fpr/fpr_transport.h"
+#include "fpr/fpr_sleepy.h"
+#include "fpr/fpr_channel.h"
+#include "fpr/fpr_link.h"
+#include "fpr/fpr_aggregate.h"
+#include "fpr/fpr_tree.h"
 #include "lib/version_control.h"
 #include "lib/hashmap.h"
 #include "lib/hashmap_presets.h"
 #include "lib/base_macros.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/task.h"
 #include "esp_now.h"
 #include "esp_mac.h"
+#include "esp_timer.h"
 #include <string.h>
 
 #define MAC_ADDRESS_LENGTH 6
@@ -33,6 +45,17 @@
 
 #define FPR_DEFAULT_MAX_HOPS 10
 
+#define FPR_HOST_LOAD_VALID         0x01    // Load fields below are filled in
+#define FPR_HOST_LOAD_OVERLOADED    0x02    // Host is above its rebalance threshold
+
+// Host load carried in discovery broadcasts and probe responses
+typedef struct {
+    uint8_t flags;              // FPR_HOST_LOAD_*, 0 from older hosts
+    uint8_t connected;          // Connected clients
+    uint8_t capacity;           // max_peers, or the ESP-NOW peer limit when unlimited
+    uint8_t queue_pct;          // Fill level of the fullest client receive queue
+} fpr_host_load_t;
+
 typedef struct {
     char name[FPR_CONNECT_NAME_SIZE];
     esp_now_peer_info_t peer_info;
@@ -41,6 +64,7 @@ typedef struct {
     uint8_t lwk[FPR_KEY_SIZE];  // Local Working Key
     bool has_pwk;               // PWK is included
     bool has_lwk;               // LWK is included
+    fpr_host_load_t load;       // Host mode only
 } fpr_connect_t;
 
 typedef enum {
@@ -68,10 +92,27 @@ typedef struct {
     fpr_queue_mode_t queue_mode; // Queue mode for this peer (defaults to global setting)
     bool receiving_fragmented;   // True if currently receiving a multi-fragment message
     uint32_t fragment_seq_num;   // Sequence number of the fragmented message being received
+    uint8_t slot;                // Compact peer index while connected (FPR_PEER_SLOT_NONE otherwise)
+    uint8_t channel;             // WiFi channel the peer was last heard on
+    bool is_link;                // Client: another client reached over a direct link, not a host
+    fpr_peer_stats_t stats;      // Guarded by fpr_net.peer_stats_lock
+    int64_t stats_last_rx_us;    // Last accepted packet, for inter-arrival times
+    int64_t stats_tx_us;         // Last data send awaiting its ack, 0 if none
+    uint16_t tx_link_seq;        // Last link_seq stamped on a frame to this peer
+    uint16_t rx_link_seq;        // Last link_seq heard from this peer; guarded by peer_stats_lock
+    bool queue_overflowing;      // Queue-full drops since the last successful enqueue; guarded by peer_stats_lock
 } fpr_store_hash_t;
 
 #define FPR_STORE_HASH_TYPE fpr_store_hash_t
 
+// Connected peers get a compact slot index so services can track peer sets as bitmaps
+#define FPR_MAX_PEER_SLOTS 64
+#define FPR_PEER_SLOT_NONE 0xFF
+
+typedef uint64_t fpr_peer_bitmap_t;
+
+#define FPR_PEER_BIT(slot) ((fpr_peer_bitmap_t)1 << (slot))
+
 #define FPR_BROADCAST_ADDRESS {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}
 #define FPR_QUEUE_LENGTH 20 // for enough data for incoming packets
 
@@ -97,21 +138,682 @@ typedef struct {
     
     uint16_t payload_size;      // Actual bytes used in protocol union for this packet
     uint32_t sequence_num;      // Sequence number for replay protection
+    uint8_t network_id;         // Instance the frame belongs to (0 = default network)
+    uint16_t link_seq;          // Per sender-receiver frame counter for loss stats (0 = broadcast or unstamped)
 
-    uint8_t reserved[10]; // Padding for alignment (reduced to account for sequence_num)
+    uint8_t reserved[7]; // Padding for alignment (reduced to account for sequence_num, network_id, link_seq)
 } fpr_package_t;
 
 _Static_assert(ESP_NOW_MAX_DATA_LEN > sizeof(fpr_package_t), "ESP_NOW_MAX_DATA_LEN must be greater than sizeof(fpr_package_t)");
 
+#define FPR_PROTOCOL_SIZE sizeof(((fpr_package_t *)0)->protocol)
+
+// ========== RPC SERVICE ==========
+
+typedef enum {
+    FPR_RPC_KIND_REQUEST = 0,
+    FPR_RPC_KIND_RESPONSE,
+    FPR_RPC_KIND_ERROR
+} fpr_rpc_kind_t;
+
+// Carried in the protocol union of FPR_PACKET_ID_RPC packets
+typedef struct __attribute__((packed)) {
+    uint8_t kind;               // fpr_rpc_kind_t
+    uint8_t reserved;
+    fpr_rpc_method_t method;
+    uint32_t call_id;           // Correlation ID chosen by the caller
+    int32_t status;             // Remote esp_err_t (FPR_RPC_KIND_ERROR only)
+    uint16_t payload_len;
+    uint8_t payload[FPR_RPC_MAX_PAYLOAD];
+} fpr_rpc_frame_t;
+
+_Static_assert(sizeof(fpr_rpc_frame_t) <= FPR_PROTOCOL_SIZE, "fpr_rpc_frame_t must fit in the protocol union");
+
+#define FPR_RPC_FRAME_HEADER_SIZE offsetof(fpr_rpc_frame_t, payload)
+#define FPR_RPC_WHEEL_SLOTS 32
+
+typedef struct fpr_rpc_pending {
+    struct fpr_rpc_pending *next;   // Next call expiring in the same wheel slot
+    uint32_t call_id;
+    uint32_t rounds;                // Wheel revolutions left before expiry
+    int64_t start_us;               // Send time (latency histogram)
+    uint8_t peer_mac[MAC_ADDRESS_LENGTH];
+    uint16_t slot;                  // Wheel slot this call is linked into
+    bool in_use;
+    fpr_rpc_response_cb_t cb;
+    void *user_data;
+} fpr_rpc_pending_t;
+
+typedef struct {
+    fpr_rpc_method_t method;
+    fpr_rpc_handler_t handler;
+    void *user_data;
+    bool in_use;
+} fpr_rpc_handler_entry_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    fpr_rpc_handler_entry_t handlers[FPR_RPC_MAX_HANDLERS];
+    fpr_rpc_pending_t pending[FPR_RPC_MAX_PENDING];
+    fpr_rpc_pending_t *wheel[FPR_RPC_WHEEL_SLOTS];  // Timeout wheel, one chain per tick slot
+    uint16_t wheel_cursor;
+    uint32_t next_call_id;
+    esp_timer_handle_t wheel_timer; // Runs only while calls are outstanding
+    TaskHandle_t timer_task;        // Task the wheel ticks on, once it has ticked
+    uint32_t starting;              // Callers between linking a call and starting the wheel
+    fpr_rpc_stats_t stats;
+} fpr_rpc_state_t;
+
+// ========== PUB/SUB SERVICE ==========
+
+typedef enum {
+    FPR_PUBSUB_KIND_SUBSCRIBE = 0,  // Client -> host
+    FPR_PUBSUB_KIND_UNSUBSCRIBE,    // Client -> host
+    FPR_PUBSUB_KIND_PUBLISH,        // Client -> host
+    FPR_PUBSUB_KIND_DELIVER         // Host -> subscriber
+} fpr_pubsub_kind_t;
+
+#define FPR_PUBSUB_FLAG_RETAIN   0x01   // Host keeps this value for late subscribers
+#define FPR_PUBSUB_FLAG_RETAINED 0x02   // Delivery of a retained value on subscribe
+
+// Carried in the protocol union of FPR_PACKET_ID_PUBSUB packets
+typedef struct __attribute__((packed)) {
+    uint8_t kind;               // fpr_pubsub_kind_t
+    uint8_t flags;
+    fpr_topic_t topic;
+    uint16_t payload_len;
+    uint8_t payload[FPR_PUBSUB_MAX_PAYLOAD];
+} fpr_pubsub_frame_t;
+
+_Static_assert(sizeof(fpr_pubsub_frame_t) <= FPR_PROTOCOL_SIZE, "fpr_pubsub_frame_t must fit in the protocol union");
+
+#define FPR_PUBSUB_FRAME_HEADER_SIZE offsetof(fpr_pubsub_frame_t, payload)
+
+// Host-side topic entry
+typedef struct {
+    fpr_topic_t topic;
+    bool in_use;
+    bool has_retained;
+    uint16_t retained_len;
+    fpr_peer_bitmap_t subscribers;  // Bit per peer slot
+    uint8_t retained[FPR_PUBSUB_MAX_PAYLOAD];
+} fpr_pubsub_topic_t;
+
+// Local subscription (either mode)
+typedef struct {
+    fpr_topic_t topic;
+    bool in_use;
+    fpr_pubsub_cb_t cb;
+    void *user_data;
+} fpr_pubsub_sub_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    bool ready;
+    fpr_pubsub_topic_t topics[FPR_PUBSUB_MAX_TOPICS];
+    fpr_pubsub_sub_t subs[FPR_PUBSUB_MAX_SUBSCRIPTIONS];
+    fpr_pubsub_stats_t stats;
+} fpr_pubsub_state_t;
+
+// ========== TIME SYNC SERVICE ==========
+
+typedef enum {
+    FPR_TIMESYNC_KIND_REQUEST = 0,      // Client -> host, over the connection
+    FPR_TIMESYNC_KIND_RESPONSE,
+    FPR_TIMESYNC_KIND_NEIGHBOR_REQUEST, // Extender -> any neighbour, one hop, see fpr_timesync.c
+    FPR_TIMESYNC_KIND_NEIGHBOR_RESPONSE
+} fpr_timesync_kind_t;
+
+// Carried in the protocol union of FPR_PACKET_ID_TIMESYNC packets
+typedef struct __attribute__((packed)) {
+    uint8_t kind;               // fpr_timesync_kind_t
+    uint8_t stratum;            // Server's hops from the reference (response)
+    uint8_t reserved[2];
+    uint32_t seq;               // Matches a response to its request
+    int64_t t1;                 // Client send time (client clock)
+    int64_t t2;                 // Server receive time (network clock)
+    int64_t t3;                 // Server send time (network clock)
+    uint32_t error_us;          // Server's own error bound at t3 (response)
+} fpr_timesync_frame_t;
+
+_Static_assert(sizeof(fpr_timesync_frame_t) <= FPR_PROTOCOL_SIZE, "fpr_timesync_frame_t must fit in the protocol union");
+
+#define FPR_TIMESYNC_WINDOW 8
+
+typedef struct {
+    int64_t local_us;           // Local time the sample was taken (t4)
+    int64_t offset_us;
+    uint32_t rtt_us;
+    uint32_t server_error_us;   // Server's error bound, added to ours
+    uint8_t stratum;            // Server's stratum
+} fpr_timesync_sample_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    bool ready;
+    esp_timer_handle_t timer;           // Periodic requests while connected to a host or in extender mode
+    uint8_t server_mac[MAC_ADDRESS_LENGTH];
+    bool has_server;                    // Extender: locked to server_mac, else requests are broadcast
+    uint8_t misses;                     // Extender: requests to server_mac left unanswered
+    uint32_t seq;                       // Sequence of the outstanding request
+    int64_t request_t1;                 // Send time of the outstanding request
+    fpr_timesync_sample_t window[FPR_TIMESYNC_WINDOW];
+    uint8_t window_pos;
+    uint8_t window_count;
+    bool synced;
+    fpr_timesync_sample_t best;         // Sample the estimate is anchored to
+    fpr_timesync_sample_t drift_anchor; // Previous anchor used for the drift slope
+    bool drift_valid;
+    int32_t drift_ppb;
+    uint32_t samples;
+    uint32_t rejected;
+} fpr_timesync_state_t;
+
+// ========== HOST BEACON ==========
+
+#define FPR_BEACON_FLAG_TDMA   0x01 // Superframe schedule below is valid
+#define FPR_BEACON_FLAG_SLEEPY 0x02 // Pending bitmap below is valid
+
+// Broadcast by the host under FPR_PACKET_ID_BEACON at the start of every superframe
+typedef struct __attribute__((packed)) {
+    uint8_t flags;
+    uint8_t packets_per_slot;
+    uint16_t slot_count;        // Scheduled slots after slot 0
+    uint32_t seq;
+    int64_t epoch_us;           // Host network time at superframe start
+    uint32_t slot_us;
+    uint16_t interval_ms;       // Time until the next beacon
+    uint8_t channel;            // Host's channel, checked against the receive channel
+    uint8_t switch_channel;     // Channel the network is moving to, 0 = none
+    fpr_peer_bitmap_t pending;  // Per host peer slot: sleepy client has buffered data
+    uint16_t switch_in_ms;      // Time from this beacon until the switch
+    uint8_t reserved[2];
+    uint8_t owner_tag[FPR_TDMA_MAX_SLOTS];  // Per slot: assignment tag of the owner, 0 = free
+} fpr_beacon_frame_t;
+
+_Static_assert(sizeof(fpr_beacon_frame_t) <= FPR_PROTOCOL_SIZE, "fpr_beacon_frame_t must fit in the protocol union");
+
+typedef struct {
+    esp_timer_handle_t timer;   // One-shot, re-armed every beacon with the current period
+    bool running;
+    uint32_t seq;
+} fpr_beacon_state_t;
+
+// ========== TDMA ==========
+
+typedef enum {
+    FPR_TDMA_KIND_SLOT_REQUEST = 0, // Client -> host
+    FPR_TDMA_KIND_SLOT_ASSIGN       // Host -> client
+} fpr_tdma_kind_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t kind;               // fpr_tdma_kind_t
+    uint8_t slot;               // 1-based slot, 0 = none available
+    uint8_t tag;                // Assignment tag the beacon will carry for this slot
+} fpr_tdma_frame_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    bool ready;
+    
+    // Host
+    bool host_running;
+    fpr_tdma_config_t config;
+    uint8_t owners[FPR_TDMA_MAX_SLOTS][MAC_ADDRESS_LENGTH];
+    bool owned[FPR_TDMA_MAX_SLOTS];
+    uint8_t tags[FPR_TDMA_MAX_SLOTS];   // Assignment tag per slot, kept after release
+    uint8_t next_tag;                   // Assignment counter
+    uint16_t slot_count;
+    
+    // Client
+    bool scheduled;             // Slot confirmed by the last beacon
+    uint8_t slot;               // 1-based, 0 = none
+    uint8_t tag;
+    uint8_t packets_per_slot;
+    uint8_t missed_beacons;
+    uint32_t slot_us;
+    uint32_t superframe_us;
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    esp_timer_handle_t slot_timer;
+    uint32_t tx_message_seq;    // Sequence number of the message being drained
+    
+    fpr_tdma_status_t stats;
+} fpr_tdma_state_t;
+
+// ========== SLEEPY CLIENTS ==========
+
+typedef enum {
+    FPR_SLEEPY_KIND_REGISTER = 0,   // Client -> host, listen interval 0 unregisters
+    FPR_SLEEPY_KIND_REGISTER_ACK,   // Host -> client, carries the pending bitmap slot
+    FPR_SLEEPY_KIND_POLL,           // Client -> host
+    FPR_SLEEPY_KIND_END             // Host -> client, buffer drained
+} fpr_sleepy_kind_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t kind;               // fpr_sleepy_kind_t
+    uint8_t slot;               // Peer slot on the host (REGISTER_ACK)
+    uint8_t listen_interval;    // REGISTER
+} fpr_sleepy_frame_t;
+
+_Static_assert(sizeof(fpr_sleepy_frame_t) <= FPR_PROTOCOL_SIZE, "fpr_sleepy_frame_t must fit in the protocol union");
+
+typedef enum {
+    FPR_SLEEPY_RADIO_AWAKE = 0, // Not duty-cycling yet, or waiting for a beacon
+    FPR_SLEEPY_RADIO_FETCHING,  // Polled, waiting for the buffer to drain
+    FPR_SLEEPY_RADIO_ASLEEP
+} fpr_sleepy_radio_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    bool ready;
+    
+    // Host
+    bool host_enabled;
+    uint16_t beacon_interval_ms;
+    fpr_peer_bitmap_t sleepy_peers;                 // Per peer slot
+    QueueHandle_t downlink[FPR_MAX_PEER_SLOTS];     // Created on registration
+    
+    // Client
+    bool client_enabled;
+    uint8_t listen_interval;
+    uint8_t host_slot;          // Our bit in the beacon pending bitmap, FPR_PEER_SLOT_NONE until acknowledged
+    fpr_sleepy_radio_t radio;
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];
+    int64_t last_beacon_us;
+    uint16_t interval_ms;       // Beacon interval announced by the host
+    esp_timer_handle_t wake_timer;
+    
+    fpr_sleepy_stats_t stats;
+} fpr_sleepy_state_t;
+
+// ========== CHANNEL MIGRATION ==========
+
+typedef struct {
+    portMUX_TYPE lock;
+    bool ready;
+    fpr_channel_config_t config;
+    esp_timer_handle_t eval_timer;      // Host: periodic quality window
+    esp_timer_handle_t switch_timer;    // One-shot at the announced switch time
+    
+    // Current window
+    uint32_t tx_ok;
+    uint32_t tx_fail;
+    uint32_t no_mem;
+    int32_t rssi_sum;
+    int32_t noise_sum;
+    uint32_t rx_count;
+    
+    uint8_t badness[FPR_CHANNEL_MAX + 1];   // Last measured badness per channel (0 = clean or unknown)
+    int64_t switch_at_us;               // Announced switch time (local)
+    int64_t switched_at_us;             // Time of the last switch, 0 when not measuring downtime
+    fpr_peer_bitmap_t awaiting;         // Host: clients not heard since the switch
+    uint8_t host_mac[MAC_ADDRESS_LENGTH];   // Client: host that announced the switch
+    
+    fpr_channel_status_t status;
+} fpr_channel_state_t;
+
+// ========== DIRECT CLIENT LINKS ==========
+
+typedef enum {
+    FPR_LINK_KIND_REQUEST = 0,  // Client -> host: introduce me to peer
+    FPR_LINK_KIND_INTRO,        // Host -> both clients: the other's MAC, name and pairwise key
+    FPR_LINK_KIND_REJECT,       // Host -> client: introduction refused
+    FPR_LINK_KIND_HELLO,        // Client <-> client keepalive, direct and (while degraded) relayed
+    FPR_LINK_KIND_CLOSE         // Client <-> client: link torn down
+} fpr_link_kind_t;
+
+// Carried in the protocol union of FPR_PACKET_ID_LINK packets
+typedef struct __attribute__((packed)) {
+    uint8_t kind;               // fpr_link_kind_t
+    uint8_t reserved;
+    int32_t status;             // esp_err_t (REJECT)
+    uint8_t peer[MAC_ADDRESS_LENGTH];
+    char name[FPR_CONNECT_NAME_SIZE];
+    uint8_t key[FPR_KEY_SIZE];  // Pairwise key under the recipient's session key (INTRO)
+    uint8_t nonce[8];           // Random per INTRO, keys the wrap
+    uint8_t check[FPR_KEY_CHECK_SIZE]; // Wrap check value (INTRO)
+} fpr_link_frame_t;
+
+_Static_assert(sizeof(fpr_link_frame_t) <= FPR_PROTOCOL_SIZE, "fpr_link_frame_t must fit in the protocol union");
+
+typedef struct {
+    bool in_use;
+    uint8_t mac[MAC_ADDRESS_LENGTH];
+    uint8_t tx_fail_streak;     // Failed direct sends in a row
+    int64_t last_direct_us;     // Last frame heard straight from the peer, 0 = never
+    int64_t last_heard_us;      // Last frame heard by either path
+    fpr_link_info_t info;
+} fpr_link_entry_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    bool ready;
+    fpr_link_entry_t links[FPR_LINK_MAX];
+    fpr_link_stats_t stats;
+} fpr_link_state_t;
+
+// ========== AGGREGATION ==========
+
+// Carried in the protocol union of FPR_PACKET_ID_AGGREGATE packets
+typedef struct __attribute__((packed)) {
+    int32_t inner_id;           // Package ID of the merged reports
+    uint8_t op;                 // fpr_aggregate_op_t
+    uint8_t record_size;
+    uint8_t record_count;       // Records in data (CONCAT: origin MAC + report each, otherwise 1 result)
+    uint8_t reserved;
+    uint16_t contributors;      // Original reports behind this frame
+    uint16_t delay_ms;          // Hold time added along the path so far
+} fpr_aggregate_header_t;
+
+#define FPR_AGGREGATE_DATA_SIZE (FPR_PROTOCOL_SIZE - sizeof(fpr_aggregate_header_t))
+
+typedef struct __attribute__((packed)) {
+    fpr_aggregate_header_t header;
+    uint8_t data[FPR_AGGREGATE_DATA_SIZE];
+} fpr_aggregate_frame_t;
+
+_Static_assert(sizeof(fpr_aggregate_frame_t) <= FPR_PROTOCOL_SIZE, "fpr_aggregate_frame_t must fit in the protocol union");
+
+typedef struct {
+    bool in_use;
+    fpr_package_id_t id;
+    fpr_aggregate_config_t config;
+} fpr_aggregate_rule_t;
+
+// Reports of one package ID on their way to one destination
+typedef struct {
+    bool in_use;
+    bool busy;                  // Being merged outside the lock; not flushed meanwhile
+    uint8_t dest[MAC_ADDRESS_LENGTH];
+    int64_t first_us;           // Arrival of the oldest held report
+    int64_t flush_us;           // first_us + rule window
+    fpr_aggregate_frame_t frame;
+} fpr_aggregate_bucket_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    bool ready;
+    esp_timer_handle_t timer;   // Runs only while reports are held
+    fpr_aggregate_rule_t rules[FPR_AGGREGATE_MAX_RULES];
+    fpr_aggregate_bucket_t buckets[FPR_AGGREGATE_MAX_BUCKETS];
+    uint8_t held;               // Buckets in use
+    uint64_t delay_sum_ms;
+    fpr_aggregate_stats_t stats;
+} fpr_aggregate_state_t;
+
+// ========== COLLECTION TREE ==========
+
+#define FPR_TREE_COST_INFINITE 0xFFFF
+
+typedef enum {
+    FPR_TREE_KIND_BEACON = 0,   // Path cost advertisement (broadcast)
+    FPR_TREE_KIND_DATA,         // Upstream data (unicast to the parent)
+} fpr_tree_kind_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t kind;               // fpr_tree_kind_t
+    uint8_t reserved;
+    uint16_t cost;              // Sender's path cost to the sink (ETX x10)
+    uint8_t sink[MAC_ADDRESS_LENGTH];
+    uint16_t seq;               // Beacon sequence (BEACON)
+    int32_t inner_id;           // Application package ID (DATA)
+    uint16_t payload_len;       // DATA
+} fpr_tree_header_t;
+
+#define FPR_TREE_PAYLOAD_SIZE (FPR_PROTOCOL_SIZE - sizeof(fpr_tree_header_t))
+
+typedef struct __attribute__((packed)) {
+    fpr_tree_header_t header;
+    uint8_t payload[FPR_TREE_PAYLOAD_SIZE];
+} fpr_tree_frame_t;
+
+_Static_assert(sizeof(fpr_tree_frame_t) <= FPR_PROTOCOL_SIZE, "fpr_tree_frame_t must fit in the protocol union");
+
+typedef struct {
+    bool in_use;
+    uint8_t mac[MAC_ADDRESS_LENGTH];
+    uint8_t sink[MAC_ADDRESS_LENGTH];
+    uint16_t cost;              // Advertised path cost
+    uint16_t last_seq;
+    uint16_t prr_x1000;         // Delivery ratio estimate (beacons heard, data acked)
+    int8_t rssi;
+    int64_t last_heard_us;
+} fpr_tree_neighbor_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    bool ready;
+    bool is_sink;
+    fpr_tree_neighbor_t neighbors[FPR_TREE_MAX_NEIGHBORS];
+    int8_t parent;              // Index into neighbors, -1 if none
+    uint16_t cost;              // Own path cost (0 at the sink)
+    uint16_t beacon_seq;
+    int64_t last_beacon_us;
+    fpr_tree_stats_t stats;
+} fpr_tree_state_t;
+
+// ========== HOST PROBING ==========
+
+#define FPR_PROBE_MAX_RESPONDERS 8
+
+typedef enum {
+    FPR_PROBE_KIND_REQUEST = 0,     // Client broadcast
+    FPR_PROBE_KIND_RESPONSE,        // Host broadcast, jittered and coalesced
+    FPR_PROBE_KIND_REBALANCE,       // Host -> client unicast: look for a less loaded host
+    FPR_PROBE_KIND_HEARTBEAT,       // Client -> host unicast liveness check (hot standby)
+    FPR_PROBE_KIND_HEARTBEAT_ACK    // Host -> client answer
+} fpr_probe_kind_t;
+
+typedef struct {
+    uint8_t kind;               // fpr_probe_kind_t
+    uint8_t channel;            // Host's channel (RESPONSE), checked against the receive channel
+    uint8_t reserved[2];
+    fpr_connect_t info;         // Host announcement (RESPONSE)
+} fpr_probe_frame_t;
+
+_Static_assert(sizeof(fpr_probe_frame_t) <= FPR_PROTOCOL_SIZE, "fpr_probe_frame_t must fit in the protocol union");
+
+// Client: channel sweep run by the service task, one dwell per step
+typedef struct {
+    uint8_t channels[FPR_CHANNEL_MAX];
+    uint8_t channel_count;
+    uint8_t index;                      // Channel being probed
+    uint8_t original_channel;           // Restored if no host answers
+    bool confirming;                    // Final probe on the locked channel
+    bool running;
+    int8_t best_rssi;
+    int64_t start_us;
+    int64_t dwell_end_us;
+    int64_t last_probe_us;
+    TaskHandle_t caller;                // fpr_client_scan_channels() waiting for the result
+    esp_err_t result;
+    fpr_channel_scan_report_t report;
+} fpr_channel_sweep_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    esp_timer_handle_t response_timer;  // Host: pending jittered response
+    TaskHandle_t waiter;                // Client: task blocked in a probe scan
+    bool sweeping;                      // Client: channel sweep, record answers without connecting
+    fpr_channel_sweep_t sweep;
+    uint8_t responders[FPR_PROBE_MAX_RESPONDERS][MAC_ADDRESS_LENGTH];
+    int8_t responder_rssi[FPR_PROBE_MAX_RESPONDERS];
+    uint8_t responder_count;
+} fpr_probe_state_t;
+
+// ========== HOST SELECTION ==========
+
+// Announcement kept until the selection window closes
+typedef struct {
+    uint8_t src_addr[MAC_ADDRESS_LENGTH];
+    uint8_t des_addr[MAC_ADDRESS_LENGTH];
+    wifi_pkt_rx_ctrl_t rx_ctrl;
+    fpr_connect_t info;
+} fpr_host_candidate_t;
+
+// Probe sent while connected, evaluated by a later reconnect job run
+typedef enum {
+    FPR_SELECT_PROBE_NONE = 0,
+    FPR_SELECT_PROBE_REBALANCE,         // Host hinted us to move
+    FPR_SELECT_PROBE_STANDBY,           // Looking for a standby host
+} fpr_select_probe_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    esp_timer_handle_t window_timer;    // Closes the selection window
+    bool collecting;                    // Window open (or rebalance probe running)
+    bool replaying;                     // Chosen announcement is being handled
+    bool rebalance_requested;           // Host hinted us to move, handled by the reconnect task
+    fpr_select_probe_t probe;           // Probe in progress while connected
+    int64_t probe_end_us;
+    int64_t probe_sent_us;
+    fpr_host_candidate_t candidates[FPR_PROBE_MAX_RESPONDERS];
+    uint8_t candidate_count;
+} fpr_host_select_t;
+
+// ========== HOT STANDBY ==========
+
+typedef struct {
+    bool enabled;
+    bool has_primary;
+    bool has_standby;                   // Standby handshake completed
+    bool acquiring;                     // Joining acquire_mac as standby while connected
+    uint8_t acquire_mac[MAC_ADDRESS_LENGTH];
+    uint8_t primary[MAC_ADDRESS_LENGTH];
+    uint8_t standby[MAC_ADDRESS_LENGTH];
+    int64_t primary_last_seen_us;       // Last contact with the active host, for failover time
+    TickType_t last_heartbeat;
+    TickType_t last_acquire;
+    fpr_standby_stats_t stats;
+} fpr_standby_state_t;
+
+// ========== NETWORK STATISTICS ==========
+
+typedef enum {
+    FPR_STAT_PACKETS_SENT = 0,
+    FPR_STAT_PACKETS_RECEIVED,
+    FPR_STAT_PACKETS_FORWARDED,
+    FPR_STAT_PACKETS_DROPPED,
+    FPR_STAT_SEND_FAILURES,
+    FPR_STAT_REPLAY_ATTACKS_BLOCKED,
+    FPR_STAT_COUNT
+} fpr_stat_id_t;
+
+// Counters are bumped lock-free from any task or core with relaxed 32-bit
+// atomics (see _fpr_stat_add()). Readers widen them to 64 bits by folding
+// the delta since the previous fold into a total under fold_lock. The hot
+// path only folds when a counter crosses half its range, so no counter can
+// wrap twice between folds even when nobody reads the stats.
+typedef struct {
+    uint32_t live[FPR_STAT_COUNT];      // Atomic access only; wraps
+    uint32_t folded[FPR_STAT_COUNT];    // live at the last fold
+    uint64_t total[FPR_STAT_COUNT];     // Count up to the last fold
+    portMUX_TYPE fold_lock;
+} fpr_stats_t;
+
+// ========== EXTENDER STORE-AND-FORWARD ==========
+
+/**
+ * @brief Store-and-forward statistics (see fpr_extender.h).
+ */
+typedef struct {
+    bool enabled;               // Store-and-forward is active
+    uint32_t held;              // Frames currently in the store
+    uint32_t stored;            // Frames put into the store
+    uint32_t delivered;         // Stored frames forwarded after a route reappeared
+    uint32_t expired;           // Frames dropped for age
+    uint32_t evicted;           // Frames dropped for a full quota or store (oldest first)
+    uint32_t send_failed;       // Forwarded frames held after the radio reported a failed send
+    uint32_t routes_expired;    // Routes dropped because their next hop went quiet
+} fpr_extender_store_stats_t;
+
+typedef struct {
+    bool used;
+    int64_t stored_us;
+    uint8_t next_hop[MAC_ADDRESS_LENGTH];   // In-flight frames: neighbour it was sent to
+    fpr_package_t package;      // Hop count already advanced
+} fpr_extender_store_entry_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    fpr_extender_store_entry_t *entries;    // FPR_EXTENDER_STORE_SIZE, allocated while enabled
+    fpr_extender_store_entry_t *inflight;   // Forwarded frames awaiting their send result
+    fpr_extender_store_stats_t stats;
+} fpr_extender_store_t;
+
+// ========== EXTENDER BROADCAST RELAYS ==========
+
+/**
+ * @brief Broadcast relay statistics (see fpr_extender.h).
+ */
+typedef struct {
+    bool mpr_enabled;           // Relays used instead of flooding
+    uint8_t neighbors;          // One-hop neighbors heard
+    uint8_t symmetric;          // Neighbors that hear us too
+    uint8_t two_hop;            // Two-hop neighbors to cover
+    uint8_t relays;             // Neighbors we picked as relays
+    uint8_t selectors;          // Neighbors that picked us as relay
+    uint32_t received;          // Broadcasts received for the first time
+    uint32_t duplicates;        // Copies of broadcasts already seen
+    uint32_t rebroadcast;       // Broadcasts sent on
+    uint32_t suppressed;        // Rebroadcasts flooding would have sent but relays did not
+    uint32_t hellos_tx;
+} fpr_extender_broadcast_stats_t;
+
+#define FPR_MPR_HELLO_MAX 24
+
+// Carried in the protocol union of FPR_PACKET_ID_MPR packets
+typedef struct __attribute__((packed)) {
+    uint8_t count;
+    uint8_t reserved;
+    uint8_t relay_bits[(FPR_MPR_HELLO_MAX + 7) / 8];    // Bit i: sender picked neighbors[i] as relay
+    uint8_t neighbors[FPR_MPR_HELLO_MAX][MAC_ADDRESS_LENGTH];
+} fpr_mpr_hello_t;
+
+_Static_assert(sizeof(fpr_mpr_hello_t) <= FPR_PROTOCOL_SIZE, "fpr_mpr_hello_t must fit in the protocol union");
+_Static_assert(FPR_MPR_MAX_NEIGHBORS <= FPR_MPR_HELLO_MAX, "CONFIG_FPR_MPR_MAX_NEIGHBORS exceeds the hello size");
+
+typedef struct {
+    bool in_use;
+    bool symmetric;             // Our MAC is in its hello
+    bool relay;                 // We picked it as relay
+    bool selector;              // It picked us as relay
+    uint8_t mac[MAC_ADDRESS_LENGTH];
+    int64_t last_heard_us;
+    uint8_t two_hop_count;
+    uint8_t two_hop[FPR_MPR_MAX_NEIGHBORS][MAC_ADDRESS_LENGTH];
+} fpr_mpr_neighbor_t;
+
+typedef struct {
+    uint8_t origin[MAC_ADDRESS_LENGTH];
+    uint32_t sequence_num;
+} fpr_mpr_seen_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    bool ready;
+    bool enabled;
+    fpr_mpr_neighbor_t neighbors[FPR_MPR_MAX_NEIGHBORS];
+    fpr_mpr_seen_t seen[FPR_MPR_DUP_CACHE_SIZE];
+    uint16_t seen_next;
+    fpr_extender_broadcast_stats_t stats;
+} fpr_extender_mpr_t;
+
 typedef struct {
     HashMap peers_map;
     char name[PEER_NAME_MAX_LENGTH];
     uint8_t mac[MAC_ADDRESS_LENGTH];
     fpr_visibility_t access_state;
-    esp_now_send_cb_t sender;
+    fpr_transport_tx_done_cb_t sender;
     esp_now_recv_cb_t receiver;
     fpr_mode_type_t current_mode;
     bool routing_enabled;       // Enable mesh routing/forwarding
+    fpr_extender_store_t store; // Held frames for unreachable destinations (extender)
+    fpr_extender_mpr_t mpr;     // Broadcast relay selection (extender)
+    portMUX_TYPE peer_stats_lock;   // Guards fpr_store_hash_t.stats of every peer
+    fpr_probe_state_t probe;    // Active host discovery
+    fpr_host_select_t select;   // Client: host choice by load and RSSI
+    fpr_standby_state_t standby; // Client: pre-authenticated second host
     
     // Application data callback
     fpr_data_receive_cb_t data_callback;
@@ -123,19 +825,12 @@ typedef struct {
     fpr_client_config_t client_config;
     
     // Network statistics
-    struct {
-        uint32_t packets_sent;
-        uint32_t packets_received;
-        uint32_t packets_forwarded;
-        uint32_t packets_dropped;
-        uint32_t send_failures;
-        uint32_t replay_attacks_blocked;  // Replay attack counter
-    } stats;
+    fpr_stats_t stats;
 
     uint8_t host_pwk[FPR_KEY_SIZE];  // Host's Primary Working Key (host mode only)
     bool host_pwk_valid;              // Host PWK has been generated
-    TaskHandle_t loop_task;
-    TaskHandle_t reconnect_task;
+    int64_t loop_end_us;              // Discovery loop end (INT64_MAX = no end), see scheduler.h
+    int64_t keepalive_sent_us;        // Client: last keepalive to the host
     fpr_network_state_t state;        // Current network state
     bool paused;                      // Paused flag
     
@@ -146,7 +841,120 @@ typedef struct {
     
     // Queue management
     fpr_queue_mode_t default_queue_mode;  // Default queue mode for new peers
+    
+    // Services
+    fpr_rpc_state_t rpc;              // Request/response service
+    fpr_pubsub_state_t pubsub;        // Topic publish/subscribe service
+    fpr_timesync_state_t timesync;    // Network time synchronization
+    fpr_beacon_state_t beacon;        // Host superframe beacon
+    fpr_tdma_state_t tdma;            // Slot scheduling
+    fpr_sleepy_state_t sleepy;        // Duty-cycled clients and downlink buffering
+    fpr_channel_state_t chan;         // Channel quality and migration
+    fpr_link_state_t link;            // Direct client-to-client links
+    fpr_aggregate_state_t aggregate;  // Report merging at extenders
+    fpr_tree_state_t tree;            // Collection tree toward a sink
+    
+    // Peer slot table (index -> peer), see FPR_MAX_PEER_SLOTS
+    FPR_STORE_HASH_TYPE *peer_slots[FPR_MAX_PEER_SLOTS];
+
+    uint8_t network_id;               // Stamped on every frame sent; kept across deinit
 } fpr_network_t;
 
+extern fpr_network_t fpr_instances[FPR_MAX_INSTANCES]; // [0] is the default instance
+
+#if (FPR_MAX_INSTANCES > 1)
+// Set in the thread-local binding while an application callback runs: the
+// callback's plain API calls act on the default instance, and
+// fpr_instance_current() still reports the instance that raised it
+#define FPR_INSTANCE_APP_TAG ((uintptr_t)1)
+
+// The instance the calling task works on: the one a radio, timer or service
+// task callback or an _ex() call was dispatched for. Application code and
+// application callbacks get the default instance.
+static inline fpr_network_t *_fpr_current(void)
+{
+    uintptr_t bound = (uintptr_t)pvTaskGetThreadLocalStoragePointer(NULL, FPR_INSTANCE_TLS_INDEX);
+    return (bound != 0 && (bound & FPR_INSTANCE_APP_TAG) == 0) ? (fpr_network_t *)bound : &fpr_instances[0];
+}
+
+// Binding for tasks the library owns and runs nothing else on
+static inline void _fpr_instance_bind(void *net)
+{
+    vTaskSetThreadLocalStoragePointer(NULL, FPR_INSTANCE_TLS_INDEX, net);
+}
+
+// Bind for one dispatch and return the previous binding for
+// _fpr_instance_leave(); timer and radio tasks are shared with application
+// code, which must find them as they were
+static inline void *_fpr_instance_enter(void *net)
+{
+    void *prev = pvTaskGetThreadLocalStoragePointer(NULL, FPR_INSTANCE_TLS_INDEX);
+    vTaskSetThreadLocalStoragePointer(NULL, FPR_INSTANCE_TLS_INDEX, net);
+    return prev;
+}
+
+static inline void _fpr_instance_leave(void *prev)
+{
+    vTaskSetThreadLocalStoragePointer(NULL, FPR_INSTANCE_TLS_INDEX, prev);
+}
+
+// Around an application callback raised by the current instance
+static inline void *_fpr_instance_enter_app(void)
+{
+    return _fpr_instance_enter((void *)((uintptr_t)_fpr_current() | FPR_INSTANCE_APP_TAG));
+}
+
+// The instance the running dispatch or application callback is for
+static inline fpr_network_t *_fpr_instance_raised(void)
+{
+    uintptr_t bound = (uintptr_t)pvTaskGetThreadLocalStoragePointer(NULL, FPR_INSTANCE_TLS_INDEX);
+    bound &= ~FPR_INSTANCE_APP_TAG;
+    return bound != 0 ? (fpr_network_t *)bound : &fpr_instances[0];
+}
+
+#define fpr_net (*_fpr_current())
+#else
+#define fpr_net (fpr_instances[0])
+#define _fpr_instance_bind(net) ((void)(net))
+#define _fpr_instance_enter(net) ((void)(net), (void *)NULL)
+#define _fpr_instance_leave(prev) ((void)(prev))
+#define _fpr_instance_enter_app() ((void *)NULL)
+#define _fpr_instance_raised() (&fpr_instances[0])
+#endif
 
-extern fpr_network_t fpr_net;
\ No newline at end of file
+// An esp_timer callback that runs bound to the instance passed as its arg
+#define FPR_INSTANCE_TIMER_CB(name)                 \
+    static void name##_bound(void);                 \
+    static void name(void *arg)                     \
+    {                                               \
+        void *prev = _fpr_instance_enter(arg);      \
+        name##_bound();                             \
+        _fpr_instance_leave(prev);                  \
+    }                                               \
+    static void name##_bound(void)
+
+// Run an application callback; read everything it needs from fpr_net first
+#define FPR_APP_CALLBACK(call)                              \
+    do {                                                    \
+        void *_app_prev = _fpr_instance_enter_app();        \
+        call;                                               \
+        _fpr_instance_leave(_app_prev);                     \
+    } while (0)
+
+#define _fpr_instance_index() ((size_t)(&fpr_net - fpr_instances))
+
+/**
+ * @brief Instance a received frame belongs to, by the network ID in its header.
+ * @return The instance, or NULL if no initialized instance is on that network.
+ */
+fpr_network_t *_fpr_instance_for_frame(const uint8_t *data, int len);
+
+/**
+ * @brief Instance that has a peer entry for a MAC, the default instance if none.
+ */
+fpr_network_t *_fpr_instance_for_peer(const uint8_t *mac);
+
+/**
+ * @brief Number of initialized instances other than the caller's.
+ */
+int _fpr_instance_others_active(void);
\ No newline at end of file
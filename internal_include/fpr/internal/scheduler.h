@@ -0,0 +1,95 @@
+#pragma once
+
+/**
+ * @file scheduler.h
+ * @brief FPR Service Task
+ *
+ * One task runs the discovery loop, the reconnect/keepalive work of both
+ * roles and the periodic protocol work (link and MPR hellos, tree
+ * beacons, host rebalancing), for every network instance. Jobs belong to the instance
+ * the caller works on (fpr_net) and run bound to it. Each job returns the
+ * absolute time it next needs to run, and the task sleeps on its notification until the earliest of those
+ * deadlines or until work is posted. Nothing wakes it just to check.
+ *
+ * The task is created once and kept across fpr_network_deinit(); only
+ * the jobs are cancelled.
+ *
+ * @warning Internal API - subject to change without notice.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/internal/private_defs.h"
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    FPR_JOB_DISCOVERY = 0,  // fpr_network_start_loop_task()
+    FPR_JOB_RECONNECT,      // fpr_network_start_reconnect_task()
+    FPR_JOB_SCAN,           // Client channel sweep
+    FPR_JOB_LINK,           // Direct link hellos and path checks
+    FPR_JOB_MPR,            // Extender MPR hellos
+    FPR_JOB_TREE,           // Collection tree beacons
+    FPR_JOB_REBALANCE,      // Host overload check
+    FPR_JOB_COUNT
+} fpr_job_id_t;
+
+/**
+ * @brief Job body.
+ * @param now_us esp_timer_get_time() when the task woke.
+ * @return Absolute time (esp_timer_get_time() base) of the next run, or 0
+ * when the job is finished.
+ */
+typedef int64_t (*fpr_job_fn_t)(int64_t now_us);
+
+/**
+ * @brief Create the service task if needed and reset the wake-up counters.
+ * Called from fpr_network_init_ex().
+ * @return ESP_OK, ESP_ERR_NO_MEM if the task could not be created.
+ */
+esp_err_t _fpr_sched_init(void);
+
+/**
+ * @brief Cancel the instance's jobs and wait for a running one to return.
+ * Called from fpr_network_deinit() before peers are freed.
+ */
+void _fpr_sched_deinit(void);
+
+/**
+ * @brief Arm a job, replacing it if already armed.
+ * @param id Job slot.
+ * @param fn Job body.
+ * @param deadline_us First run; 0 or a past time runs it on the next wake-up.
+ */
+void _fpr_sched_set(fpr_job_id_t id, fpr_job_fn_t fn, int64_t deadline_us);
+
+/**
+ * @brief Disarm a job. A run already in progress completes, but its return
+ * value is ignored.
+ */
+void _fpr_sched_cancel(fpr_job_id_t id);
+
+/**
+ * @brief Check whether a job is armed.
+ */
+bool _fpr_sched_is_armed(fpr_job_id_t id);
+
+/**
+ * @brief Run an armed job now instead of at its deadline. Does nothing if
+ * the job is not armed. A post made while the job runs makes it run again
+ * afterwards. Safe from any task, not from an ISR.
+ */
+void _fpr_sched_post(fpr_job_id_t id);
+
+/**
+ * @brief Check whether the caller is the service task. Jobs and the
+ * callbacks they invoke must not block on other jobs.
+ */
+bool _fpr_sched_is_service_task(void);
+
+/**
+ * @brief Copy the service task wake-up counters.
+ */
+void _fpr_sched_get_stats(fpr_wakeup_stats_t *stats);
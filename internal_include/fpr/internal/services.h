@@ -0,0 +1,167 @@
+#pragma once
+
+/**
+ * @file services.h
+ * @brief FPR Internal Service Hooks
+ * 
+ * Services (RPC, ...) exchange frames under reserved negative package IDs.
+ * Those frames are handed to the service dispatcher from the receive path
+ * and never reach the application queue or data callback.
+ * 
+ * @warning Internal API - subject to change without notice.
+ * 
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/internal/private_defs.h"
+
+/**
+ * @brief Initialize all service state. Called from fpr_network_init_ex().
+ */
+void _fpr_services_init(void);
+
+/**
+ * @brief Tear down all service state. Called from fpr_network_deinit() before the
+ * network structure is cleared.
+ */
+void _fpr_services_deinit(void);
+
+/**
+ * @brief Dispatch a frame received from a connected peer to its service.
+ * @param esp_now_info Receive info from ESP-NOW.
+ * @param peer Sending peer (connected).
+ * @param package Received package.
+ * @return true if the frame belonged to a service and was consumed.
+ */
+bool _fpr_service_handle_frame(const esp_now_recv_info_t *esp_now_info, FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package);
+
+/**
+ * @brief Dispatch a broadcast service frame (host beacon) from a connected peer.
+ * @param esp_now_info Receive info from ESP-NOW.
+ * @param package Received package.
+ * @return true if the frame belonged to a service and was consumed.
+ */
+bool _fpr_service_handle_broadcast(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *package);
+
+/**
+ * @brief Check whether an outgoing packet must be held back (TDMA slot queue,
+ * sleepy-client downlink buffer) instead of sent now.
+ * @param peer_address Destination.
+ * @param package_id Package ID being sent.
+ * @return true if the packet should be handed to _fpr_services_defer().
+ */
+bool _fpr_services_should_defer(const uint8_t *peer_address, fpr_package_id_t package_id);
+
+/**
+ * @brief Hold back a built packet.
+ * @param package Packet to send later.
+ * @return ESP_OK if held, ESP_ERR_NO_MEM if it could not be queued.
+ */
+esp_err_t _fpr_services_defer(const fpr_package_t *package);
+
+/**
+ * @brief Notify services that a peer completed connection (new session).
+ * @param peer Peer that just became connected.
+ */
+void _fpr_services_on_peer_connected(FPR_STORE_HASH_TYPE *peer);
+
+/**
+ * @brief Notify services that a peer left the connected state and its slot
+ * is about to be released.
+ * @param peer Peer that was connected.
+ */
+void _fpr_services_on_peer_disconnected(FPR_STORE_HASH_TYPE *peer);
+
+/**
+ * @brief Notify services that a peer is being removed from the peer map.
+ * @param peer Peer being removed.
+ */
+void _fpr_services_on_peer_removed(FPR_STORE_HASH_TYPE *peer);
+
+// RPC service (fpr_rpc.c)
+void _fpr_rpc_init(void);
+void _fpr_rpc_deinit(void);
+void _fpr_rpc_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package);
+
+// Pub/sub service (fpr_pubsub.c)
+void _fpr_pubsub_init(void);
+void _fpr_pubsub_deinit(void);
+void _fpr_pubsub_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package);
+void _fpr_pubsub_on_peer_connected(FPR_STORE_HASH_TYPE *peer);
+void _fpr_pubsub_on_peer_disconnected(FPR_STORE_HASH_TYPE *peer);
+
+// Time sync service (fpr_timesync.c)
+void _fpr_timesync_init(void);
+void _fpr_timesync_deinit(void);
+void _fpr_timesync_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package, int64_t rx_time_us);
+void _fpr_timesync_on_peer_connected(FPR_STORE_HASH_TYPE *peer);
+// Neighbour time frames from nodes that never connect (host and extender receive paths)
+bool _fpr_timesync_on_rx(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *package);
+void _fpr_timesync_on_mode_set(void);
+
+// Host beacon (internal_src/beacon.c)
+void _fpr_beacon_init(void);
+void _fpr_beacon_deinit(void);
+void _fpr_beacon_refresh(void);
+void _fpr_beacon_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package, int64_t rx_time_us);
+
+// TDMA (fpr_tdma.c)
+void _fpr_tdma_init(void);
+void _fpr_tdma_deinit(void);
+void _fpr_tdma_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package);
+uint32_t _fpr_tdma_beacon_period_us(void);
+void _fpr_tdma_fill_beacon(fpr_beacon_frame_t *beacon);
+void _fpr_tdma_on_beacon(FPR_STORE_HASH_TYPE *peer, const fpr_beacon_frame_t *beacon, int64_t rx_time_us);
+bool _fpr_tdma_should_defer(const uint8_t *peer_address, fpr_package_id_t package_id);
+esp_err_t _fpr_tdma_enqueue(const fpr_package_t *package);
+
+// Hot standby (fpr_client.c)
+bool _fpr_standby_on_host_connected(FPR_STORE_HASH_TYPE *peer);
+bool _fpr_standby_is_active_host(const uint8_t *mac);
+void _fpr_standby_on_peer_removed(FPR_STORE_HASH_TYPE *peer);
+
+// Channel migration (fpr_channel.c)
+void _fpr_channel_init(void);
+void _fpr_channel_deinit(void);
+void _fpr_channel_on_rx(const esp_now_recv_info_t *esp_now_info);
+void _fpr_channel_on_send_queued(esp_err_t err);
+void _fpr_channel_on_send_status(bool success);
+uint32_t _fpr_channel_beacon_period_us(void);
+void _fpr_channel_fill_beacon(fpr_beacon_frame_t *beacon);
+void _fpr_channel_on_beacon(FPR_STORE_HASH_TYPE *peer, const fpr_beacon_frame_t *beacon, int64_t rx_time_us);
+void _fpr_channel_on_peer_disconnected(FPR_STORE_HASH_TYPE *peer);
+
+// Direct client links (fpr_link.c)
+void _fpr_link_init(void);
+void _fpr_link_deinit(void);
+void _fpr_link_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package);
+bool _fpr_link_host_relay(FPR_STORE_HASH_TYPE *from, const fpr_package_t *package);
+bool _fpr_link_route(const uint8_t *peer_address, fpr_package_id_t package_id, uint8_t *via_out);
+bool _fpr_link_on_client_rx(const esp_now_recv_info_t *esp_now_info, FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package);
+void _fpr_link_on_send_status(const uint8_t *mac, bool success);
+void _fpr_link_on_peer_removed(FPR_STORE_HASH_TYPE *peer);
+
+// In-network aggregation (fpr_aggregate.c)
+void _fpr_aggregate_init(void);
+void _fpr_aggregate_deinit(void);
+void _fpr_aggregate_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package);
+
+// Collection tree (fpr_tree.c)
+void _fpr_tree_init(void);
+void _fpr_tree_deinit(void);
+void _fpr_tree_on_mode_set(void);
+bool _fpr_tree_on_rx(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *package);
+void _fpr_tree_on_send_status(const uint8_t *mac, bool success);
+
+// Sleepy clients (fpr_sleepy.c)
+void _fpr_sleepy_init(void);
+void _fpr_sleepy_deinit(void);
+void _fpr_sleepy_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package);
+uint32_t _fpr_sleepy_beacon_period_us(void);
+void _fpr_sleepy_fill_beacon(fpr_beacon_frame_t *beacon);
+void _fpr_sleepy_on_beacon(FPR_STORE_HASH_TYPE *peer, const fpr_beacon_frame_t *beacon, int64_t rx_time_us);
+void _fpr_sleepy_on_peer_connected(FPR_STORE_HASH_TYPE *peer);
+void _fpr_sleepy_on_peer_disconnected(FPR_STORE_HASH_TYPE *peer);
+bool _fpr_sleepy_should_defer(const uint8_t *peer_address, fpr_package_id_t package_id);
+esp_err_t _fpr_sleepy_enqueue(const fpr_package_t *package);
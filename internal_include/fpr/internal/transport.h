@@ -0,0 +1,51 @@
+#pragma once
+
+/**
+ * @file transport.h
+ * @brief FPR Transport Calls
+ *
+ * Thin wrappers over the selected fpr_transport_t. Peers are kept as
+ * esp_now_peer_info_t inside FPR (it is also part of the connect frame)
+ * and converted here.
+ *
+ * @warning Internal API - subject to change without notice.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_transport.h"
+#include "esp_now.h"
+
+/**
+ * @brief Start the transport and route its callbacks to FPR. Called by the
+ * first fpr_network_init().
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if its MTU cannot hold a package,
+ * or the transport's error.
+ */
+esp_err_t _fpr_transport_init(fpr_transport_rx_cb_t rx, fpr_transport_tx_done_cb_t tx_done);
+
+/**
+ * @brief Stop the transport. Called by the last fpr_network_deinit().
+ */
+esp_err_t _fpr_transport_deinit(void);
+
+esp_err_t _fpr_transport_send(const uint8_t *dest, const uint8_t *data, size_t len);
+esp_err_t _fpr_transport_add_peer(const esp_now_peer_info_t *info);
+esp_err_t _fpr_transport_mod_peer(const esp_now_peer_info_t *info);
+esp_err_t _fpr_transport_del_peer(const uint8_t *addr);
+esp_err_t _fpr_transport_set_wake_window(uint16_t window_ms);
+esp_err_t _fpr_transport_set_wake_interval(uint16_t interval_ms);
+
+/**
+ * @brief This node's address on the transport, used as the FPR MAC.
+ */
+esp_err_t _fpr_transport_get_addr(uint8_t addr[FPR_TRANSPORT_ADDR_LEN]);
+
+/**
+ * @brief Check whether a send error means the transport is momentarily full.
+ */
+static inline bool _fpr_transport_is_full(esp_err_t err)
+{
+    return err == ESP_ERR_NO_MEM || err == ESP_ERR_ESPNOW_NO_MEM;
+}
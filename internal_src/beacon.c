@@ -0,0 +1,132 @@
+/**
+ * @file beacon.c
+ * @brief FPR Host Superframe Beacon
+ * 
+ * The host broadcasts one beacon per superframe while any service needs
+ * it. Services fill their part of the frame on the host and parse it on
+ * the client. The period is re-read every beacon, so schedules that grow
+ * or shrink take effect at the next superframe boundary.
+ * 
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/fpr.h"
+#include "esp_log.h"
+
+static const char *TAG = "fpr_beacon";
+
+#define BEACON fpr_net.beacon
+
+static uint32_t _beacon_period_us(void)
+{
+    if (fpr_net.current_mode != FPR_MODE_HOST) {
+        return 0;
+    }
+    // The TDMA superframe sets the pace when it runs
+    uint32_t period_us = _fpr_tdma_beacon_period_us();
+    if (period_us == 0) {
+        period_us = _fpr_sleepy_beacon_period_us();
+    }
+    if (period_us == 0) {
+        period_us = _fpr_channel_beacon_period_us();
+    }
+    return period_us;
+}
+
+FPR_INSTANCE_TIMER_CB(_beacon_tick)
+{
+    if (!BEACON.running) {
+        return;
+    }
+
+    fpr_beacon_frame_t frame = {0};
+    frame.seq = ++BEACON.seq;
+    frame.epoch_us = fpr_timesync_local_to_network(esp_timer_get_time());
+    frame.channel = _fpr_get_current_channel();
+    _fpr_tdma_fill_beacon(&frame);
+    _fpr_sleepy_fill_beacon(&frame);
+    _fpr_channel_fill_beacon(&frame);
+
+    // Re-arm first so send time does not stretch the superframe.
+    // Read after filling, since TDMA may have just shrunk the superframe.
+    uint32_t period_us = _beacon_period_us();
+    frame.interval_ms = (uint16_t)(period_us / 1000);
+    if (period_us > 0) {
+        esp_timer_start_once(BEACON.timer, period_us);
+    } else {
+        BEACON.running = false;
+    }
+
+    esp_err_t err = fpr_network_broadcast(&frame, sizeof(frame), FPR_PACKET_ID_BEACON);
+    if (err != ESP_OK) {
+        #if (FPR_DEBUG == 1)
+        ESP_LOGW(TAG, "Beacon %lu send failed: %s", (unsigned long)frame.seq, esp_err_to_name(err));
+        #endif
+    }
+}
+
+void _fpr_beacon_refresh(void)
+{
+    if (BEACON.timer == NULL) {
+        return;
+    }
+
+    bool needed = _beacon_period_us() > 0;
+    if (needed && !BEACON.running) {
+        BEACON.running = true;
+        esp_timer_start_once(BEACON.timer, 1000);
+    } else if (!needed && BEACON.running) {
+        BEACON.running = false;
+        esp_timer_stop(BEACON.timer);
+    }
+}
+
+void _fpr_beacon_handle_frame(FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package, int64_t rx_time_us)
+{
+    if (package->payload_size < offsetof(fpr_beacon_frame_t, owner_tag)) {
+        ESP_LOGW(TAG, "Malformed beacon from " MACSTR, MAC2STR(peer->peer_info.peer_addr));
+        return;
+    }
+
+    const fpr_beacon_frame_t *frame = (const fpr_beacon_frame_t *)&package->protocol;
+    
+    // Overheard from an adjacent channel; its timing is not ours
+    if (frame->channel != 0 && peer->channel != 0 && frame->channel != peer->channel) {
+        #if (FPR_DEBUG == 1)
+        ESP_LOGW(TAG, "Beacon for channel %u received on channel %u - ignoring", frame->channel, peer->channel);
+        #endif
+        return;
+    }
+    _fpr_tdma_on_beacon(peer, frame, rx_time_us);
+    _fpr_sleepy_on_beacon(peer, frame, rx_time_us);
+    _fpr_channel_on_beacon(peer, frame, rx_time_us);
+}
+
+void _fpr_beacon_init(void)
+{
+    memset(&BEACON, 0, sizeof(BEACON));
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = _beacon_tick,
+        .arg = &fpr_net,
+        .name = "fpr_beacon"
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &BEACON.timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create beacon timer: %s", esp_err_to_name(err));
+        BEACON.timer = NULL;
+    }
+}
+
+void _fpr_beacon_deinit(void)
+{
+    BEACON.running = false;
+    if (BEACON.timer != NULL) {
+        esp_timer_stop(BEACON.timer);
+        esp_timer_delete(BEACON.timer);
+        BEACON.timer = NULL;
+    }
+}
@@ -10,11 +10,181 @@
  */
 
 #include "fpr/internal/helpers.h"
+#include "fpr/internal/services.h"
 #include "esp_check.h"
 #include "esp_log.h"
 
 static const char *TAG = "fpr_helpers";
 
+// ========== PER-PEER STATISTICS ==========
+
+// Must be called with the lock held
+static void _hist_add(uint32_t *hist, uint64_t value, uint32_t base)
+{
+    int bucket = 0;
+    while (bucket < FPR_PEER_HIST_BUCKETS - 1 && value >= ((uint64_t)base << bucket)) {
+        bucket++;
+    }
+    hist[bucket]++;
+}
+
+void _peer_stats_on_rx(FPR_STORE_HASH_TYPE *peer)
+{
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&fpr_net.peer_stats_lock);
+    peer->stats.packets_received++;
+    if (peer->stats_last_rx_us != 0) {
+        _hist_add(peer->stats.interarrival_hist, (uint64_t)(now - peer->stats_last_rx_us) / 1000, 1);
+    }
+    peer->stats_last_rx_us = now;
+    taskEXIT_CRITICAL(&fpr_net.peer_stats_lock);
+}
+
+// Every frame the peer sent us, before any handler can drop it. link_seq
+// counts only frames on this link, so a jump is a loss.
+void _peer_stats_on_link_frame(const uint8_t *peer_mac, const fpr_package_t *package)
+{
+    if (package->link_seq == 0) {
+        return;
+    }
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_mac);
+    if (peer == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&fpr_net.peer_stats_lock);
+    uint16_t step = (uint16_t)(package->link_seq - peer->rx_link_seq);
+    if (peer->rx_link_seq != 0 && step > 1 && step < 0x8000) {
+        uint32_t lost = step - 1;
+        peer->stats.seq_lost += lost;
+        peer->stats.seq_gaps++;
+        _hist_add(peer->stats.gap_hist, lost, 2);
+    }
+    // A step back means the peer restarted its counter: follow it
+    if (step != 0) {
+        peer->rx_link_seq = package->link_seq;
+    }
+    taskEXIT_CRITICAL(&fpr_net.peer_stats_lock);
+}
+
+void _peer_stats_on_replay(FPR_STORE_HASH_TYPE *peer)
+{
+    taskENTER_CRITICAL(&fpr_net.peer_stats_lock);
+    peer->stats.replay_rejects++;
+    taskEXIT_CRITICAL(&fpr_net.peer_stats_lock);
+}
+
+void _peer_stats_on_frag_drop(FPR_STORE_HASH_TYPE *peer, fpr_frag_drop_reason_t reason, uint32_t fragments)
+{
+    taskENTER_CRITICAL(&fpr_net.peer_stats_lock);
+    peer->stats.frag_drops[reason] += fragments;
+    taskEXIT_CRITICAL(&fpr_net.peer_stats_lock);
+}
+
+void _peer_stats_on_enqueue(FPR_STORE_HASH_TYPE *peer, bool queued)
+{
+    UBaseType_t depth = queued ? uxQueueMessagesWaiting(peer->response_queue) : 0;
+    bool overflow_started = false;
+    uint32_t drops;
+    taskENTER_CRITICAL(&fpr_net.peer_stats_lock);
+    if (queued) {
+        if (depth > peer->stats.queue_high_water) {
+            peer->stats.queue_high_water = depth;
+        }
+        _hist_add(peer->stats.queue_depth_hist, depth, 1);
+        peer->queue_overflowing = false;
+    } else {
+        peer->stats.queue_full_drops++;
+        overflow_started = !peer->queue_overflowing;
+        peer->queue_overflowing = true;
+    }
+    drops = peer->stats.queue_full_drops;
+    taskEXIT_CRITICAL(&fpr_net.peer_stats_lock);
+
+    if (overflow_started) {
+        fpr_event_t event = { .type = FPR_EVENT_QUEUE_OVERFLOW, .overflow.dropped = drops };
+        memcpy(event.peer_mac, peer->peer_info.peer_addr, sizeof(event.peer_mac));
+        _fpr_event_emit(&event);
+    }
+}
+
+void _peer_stats_on_send(const uint8_t *peer_mac, esp_err_t err)
+{
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_mac);
+    if (peer == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&fpr_net.peer_stats_lock);
+    if (err != ESP_OK) {
+        peer->stats.send_failures++;
+    } else if (peer->stats_tx_us == 0) {
+        // Only the oldest unacknowledged send is timed; acks arrive in order
+        peer->stats_tx_us = esp_timer_get_time();
+    }
+    taskEXIT_CRITICAL(&fpr_net.peer_stats_lock);
+}
+
+void _peer_stats_on_send_status(const uint8_t *peer_mac, bool success)
+{
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_mac);
+    if (peer == NULL) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&fpr_net.peer_stats_lock);
+    if (success) {
+        peer->stats.packets_acked++;
+        if (peer->stats_tx_us != 0) {
+            _hist_add(peer->stats.rtt_hist, (uint64_t)(now - peer->stats_tx_us), 250);
+        }
+    } else {
+        peer->stats.send_failures++;
+    }
+    peer->stats_tx_us = 0;
+    taskEXIT_CRITICAL(&fpr_net.peer_stats_lock);
+}
+
+#if (FPR_TRACE_ENABLE == 1)
+static uint8_t _trace_depth(FPR_STORE_HASH_TYPE *store)
+{
+    UBaseType_t depth = uxQueueMessagesWaiting(store->response_queue);
+    return depth > UINT8_MAX ? UINT8_MAX : (uint8_t)depth;
+}
+#endif
+
+esp_err_t _fpr_radio_send(const uint8_t *dest, const fpr_package_t *package)
+{
+    fpr_package_t stamped;
+    #if (FPR_MAX_INSTANCES > 1)
+    // Packages are built zeroed all over; stamp the network here, once
+    if (package->network_id != fpr_net.network_id) {
+        stamped = *package;
+        stamped.network_id = fpr_net.network_id;
+        package = &stamped;
+    }
+    #endif
+    // Unicast to a known peer: number the frame on this link for the receiver's loss stats
+    FPR_STORE_HASH_TYPE *peer = (dest == NULL || is_broadcast_address(dest)) ? NULL : _get_peer_from_map(dest);
+    if (peer != NULL) {
+        uint16_t link_seq = __atomic_add_fetch(&peer->tx_link_seq, 1, __ATOMIC_RELAXED);
+        if (link_seq == 0) {
+            link_seq = __atomic_add_fetch(&peer->tx_link_seq, 1, __ATOMIC_RELAXED);
+        }
+        if (package != &stamped) {
+            stamped = *package;
+            package = &stamped;
+        }
+        stamped.link_seq = link_seq;
+    }
+    esp_err_t err = _fpr_transport_send(dest, (const uint8_t *)package, sizeof(*package));
+    FPR_TRACE(FPR_TRACE_TX, err != ESP_OK, dest, package);
+    #if (FPR_CAPTURE_ENABLE == 1)
+    if (err == ESP_OK) {
+        _fpr_capture_frame(FPR_CAPTURE_TX, fpr_net.mac, dest, 0, 0, package, sizeof(*package));
+    }
+    #endif
+    return err;
+}
+
 static void _store_data_with_mode(FPR_STORE_HASH_TYPE *store, const fpr_package_t *data, uint8_t *peer_address) 
 {
     // Determine packet type characteristics
@@ -39,7 +209,9 @@ static void _store_data_with_mode(FPR_STORE_HASH_TYPE *store, const fpr_package_
                      " (type=%d). Use NORMAL mode for large data.",
                      MAC2STR(peer_address), data->package_type);
             #endif
-            fpr_net.stats.packets_dropped++;
+            _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+            _peer_stats_on_frag_drop(store, FPR_FRAG_DROP_LATEST_ONLY, 1);
+            FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_LATEST_ONLY, peer_address, data);
             // Reset any partial fragment state
             store->receiving_fragmented = false;
             store->fragment_seq_num = 0;
@@ -53,10 +225,11 @@ static void _store_data_with_mode(FPR_STORE_HASH_TYPE *store, const fpr_package_
             // Drain all existing packets from queue and count them
             while (xQueueReceive(store->response_queue, &discard_pkg, 0) == pdPASS) {
                 dropped++;
+                FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_LATEST_ONLY, peer_address, &discard_pkg);
             }
             store->queued_packets = 0;
             if (dropped > 0) {
-                fpr_net.stats.packets_dropped += dropped;
+                _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, dropped);
             }
         }
     } else if (!is_control_packet) {
@@ -73,7 +246,9 @@ static void _store_data_with_mode(FPR_STORE_HASH_TYPE *store, const fpr_package_
                 while (xQueueReceive(store->response_queue, &discard_pkg, 0) == pdPASS) {
                     // Check if this was part of old incomplete sequence
                     if (discard_pkg.sequence_num == store->fragment_seq_num) {
-                        fpr_net.stats.packets_dropped++;
+                        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+                        _peer_stats_on_frag_drop(store, FPR_FRAG_DROP_SUPERSEDED, 1);
+                        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_SUPERSEDED, peer_address, &discard_pkg);
                     } else {
                         // This was a complete packet, put it back (shouldn't happen often)
                         xQueueSendToFront(store->response_queue, &discard_pkg, 0);
@@ -92,7 +267,9 @@ static void _store_data_with_mode(FPR_STORE_HASH_TYPE *store, const fpr_package_
                          MAC2STR(peer_address), (unsigned long)store->fragment_seq_num,
                          (unsigned long)data->sequence_num);
                 #endif
-                fpr_net.stats.packets_dropped++;
+                _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+                _peer_stats_on_frag_drop(store, FPR_FRAG_DROP_ORPHAN, 1);
+                FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_ORPHAN, peer_address, data);
                 return;
             }
             if (is_fragment_end) {
@@ -106,8 +283,9 @@ static void _store_data_with_mode(FPR_STORE_HASH_TYPE *store, const fpr_package_
 
 void _store_data_from_peer_helper(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *data) 
 {
-    fpr_net.stats.packets_received++;
+    _fpr_stat_add(FPR_STAT_PACKETS_RECEIVED, 1);
     uint8_t *peer_address = (uint8_t *)esp_now_info->src_addr;
+    FPR_TRACE(FPR_TRACE_RX, data->package_type, peer_address, data);
     FPR_STORE_HASH_TYPE *store = _get_peer_from_map(peer_address);
     
     if (store && store->state == FPR_PEER_STATE_CONNECTED) {
@@ -119,7 +297,9 @@ void _store_data_from_peer_helper(const esp_now_recv_info_t *esp_now_info, const
         // Block packets with OLDER sequence numbers (replay attacks)
         if (data->sequence_num != 0 && data->sequence_num < store->last_seq_num) {
             // Potential replay attack - drop packet with old sequence
-            fpr_net.stats.replay_attacks_blocked++;
+            _fpr_stat_add(FPR_STAT_REPLAY_ATTACKS_BLOCKED, 1);
+            _peer_stats_on_replay(store);
+            FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_REPLAY, peer_address, data);
             #if (FPR_DEBUG == 1)
             ESP_LOGW(TAG, "Replay attack blocked from " MACSTR " (seq %lu < last %lu)",
                      MAC2STR(peer_address), (unsigned long)data->sequence_num, 
@@ -128,6 +308,8 @@ void _store_data_from_peer_helper(const esp_now_recv_info_t *esp_now_info, const
             return;
         }
         
+        _peer_stats_on_rx(store);
+        
         // Update last seen sequence number (only if newer)
         if (data->sequence_num > store->last_seq_num) {
             store->last_seq_num = data->sequence_num;
@@ -135,6 +317,11 @@ void _store_data_from_peer_helper(const esp_now_recv_info_t *esp_now_info, const
         
         store->packets_received++;
 
+        // Service frames (RPC, ...) are consumed here and never queued
+        if (_fpr_service_handle_frame(esp_now_info, store, data)) {
+            return;
+        }
+
         // Check if this is a control packet
         bool is_control_packet = (data->id == FPR_PACKET_ID_CONTROL);
         
@@ -148,12 +335,18 @@ void _store_data_from_peer_helper(const esp_now_recv_info_t *esp_now_info, const
         }
         
         // Call application callback if registered (do this before queue send to avoid blocking delays)
-        if (fpr_net.data_callback) {
+        fpr_data_receive_cb_t data_callback = fpr_net.data_callback;
+        if (data_callback) {
             fpr_package_t *package = (fpr_package_t *)data;
             // Pass the protocol payload size to the application callback
             int data_len = (int)sizeof(package->protocol);
-            fpr_net.data_callback(peer_address, &package->protocol, &data_len);
+            FPR_APP_CALLBACK(data_callback(peer_address, &package->protocol, &data_len));
+        }
+        #if (FPR_BRIDGE_ENABLE == 1)
+        if (!is_control_packet) {
+            _fpr_bridge_on_data(peer_address, data);
         }
+        #endif
 
         // Store in queue (non-blocking) - do not block the receiver on queue availability
         if (xQueueSend(store->response_queue, (void*)data, 0) == pdPASS) {
@@ -161,9 +354,13 @@ void _store_data_from_peer_helper(const esp_now_recv_info_t *esp_now_info, const
             if (is_complete_packet) {
                 store->queued_packets++;
             }
+            _peer_stats_on_enqueue(store, true);
+            FPR_TRACE(FPR_TRACE_ENQUEUE, _trace_depth(store), peer_address, data);
         } else {
+            _peer_stats_on_enqueue(store, false);
+            FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_QUEUE_FULL, peer_address, data);
             // Queue full - increment dropped counter
-            fpr_net.stats.packets_dropped++;
+            _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
             #if (FPR_DEBUG == 1)
             ESP_LOGW(TAG, "Queue full, packet dropped from " MACSTR, MAC2STR(peer_address));
             #endif
@@ -171,6 +368,62 @@ void _store_data_from_peer_helper(const esp_now_recv_info_t *esp_now_info, const
     }
 }
 
+void _deliver_as_origin(FPR_STORE_HASH_TYPE *fallback, fpr_package_t *report)
+{
+    FPR_STORE_HASH_TYPE *target = _get_peer_from_map(report->origin_mac);
+    if (target == NULL || target->response_queue == NULL) {
+        target = fallback;
+    }
+
+    fpr_data_receive_cb_t data_callback = fpr_net.data_callback;
+    if (data_callback) {
+        int data_len = (int)sizeof(report->protocol);
+        FPR_APP_CALLBACK(data_callback(report->origin_mac, &report->protocol, &data_len));
+    }
+    #if (FPR_BRIDGE_ENABLE == 1)
+    _fpr_bridge_on_data(report->origin_mac, report);
+    #endif
+    if (target == NULL || target->response_queue == NULL) {
+        return;
+    }
+    if (xQueueSend(target->response_queue, report, 0) == pdPASS) {
+        target->queued_packets++;
+        _peer_stats_on_enqueue(target, true);
+        FPR_TRACE(FPR_TRACE_ENQUEUE, _trace_depth(target), report->origin_mac, report);
+    } else {
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        _peer_stats_on_enqueue(target, false);
+        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_QUEUE_FULL, report->origin_mac, report);
+    }
+}
+
+// Slots are held while connected only, so discovered and blocked peers
+// do not use up the bitmap
+static void _peer_slot_assign(FPR_STORE_HASH_TYPE *peer)
+{
+    if (peer->slot < FPR_MAX_PEER_SLOTS && fpr_net.peer_slots[peer->slot] == peer) {
+        return;
+    }
+    peer->slot = FPR_PEER_SLOT_NONE;
+    for (uint8_t i = 0; i < FPR_MAX_PEER_SLOTS; i++) {
+        if (fpr_net.peer_slots[i] == NULL) {
+            fpr_net.peer_slots[i] = peer;
+            peer->slot = i;
+            return;
+        }
+    }
+    ESP_LOGW(TAG, "No free peer slot for " MACSTR " - services will ignore it", MAC2STR(peer->peer_info.peer_addr));
+}
+
+void _peer_slot_release(FPR_STORE_HASH_TYPE *peer)
+{
+    if (peer->slot < FPR_MAX_PEER_SLOTS && fpr_net.peer_slots[peer->slot] == peer) {
+        _fpr_services_on_peer_disconnected(peer);
+        fpr_net.peer_slots[peer->slot] = NULL;
+    }
+    peer->slot = FPR_PEER_SLOT_NONE;
+}
+
 esp_err_t _add_peer_internal(uint8_t *peer_mac, const char *name, bool is_connected, uint32_t key)
 {
     ESP_RETURN_ON_FALSE(peer_mac != NULL, ESP_ERR_INVALID_ARG, TAG, "Peer MAC is NULL");
@@ -209,14 +462,22 @@ esp_err_t _add_peer_internal(uint8_t *peer_mac, const char *name, bool is_connec
     // This ensures the key remains valid as long as the peer entry exists
     bool success = hashmap_put(&fpr_net.peers_map, store->peer_info.peer_addr, store);
     if (success) {
-        esp_now_del_peer(store->peer_info.peer_addr);
-        esp_err_t err = esp_now_add_peer(&store->peer_info);
+        if (is_connected) {
+            _peer_slot_assign(store);
+        }
+        _fpr_transport_del_peer(store->peer_info.peer_addr);
+        esp_err_t err = _fpr_transport_add_peer(&store->peer_info);
         if (err != ESP_OK) {
+            _peer_slot_release(store);
             hashmap_remove(&fpr_net.peers_map, store->peer_info.peer_addr);
             vQueueDelete(store->response_queue);
             heap_caps_free(store);
             return err;
         }
+        _fpr_event_peer(FPR_EVENT_PEER_DISCOVERED, store->peer_info.peer_addr);
+        if (is_connected) {
+            _fpr_event_peer(FPR_EVENT_CONNECTED, store->peer_info.peer_addr);
+        }
         return ESP_OK;
     }
     else {
@@ -226,6 +487,32 @@ esp_err_t _add_peer_internal(uint8_t *peer_mac, const char *name, bool is_connec
     }
 }
 
+void _peer_set_state(FPR_STORE_HASH_TYPE *peer, fpr_peer_state_t state, fpr_event_reason_t reason)
+{
+    fpr_peer_state_t old = peer->state;
+    peer->state = state;
+    peer->is_connected = (state == FPR_PEER_STATE_CONNECTED);
+    if (state == old) {
+        return;
+    }
+
+    if (state == FPR_PEER_STATE_CONNECTED) {
+        _peer_slot_assign(peer);
+    } else if (old == FPR_PEER_STATE_CONNECTED) {
+        _peer_slot_release(peer);
+    }
+    if (state == FPR_PEER_STATE_CONNECTED) {
+        _fpr_event_peer(FPR_EVENT_CONNECTED, peer->peer_info.peer_addr);
+    } else if (old == FPR_PEER_STATE_CONNECTED) {
+        fpr_event_t event = { .type = FPR_EVENT_DISCONNECTED, .disconnected.reason = reason };
+        memcpy(event.peer_mac, peer->peer_info.peer_addr, sizeof(event.peer_mac));
+        _fpr_event_emit(&event);
+    }
+    if (state == FPR_PEER_STATE_BLOCKED) {
+        _fpr_event_peer(FPR_EVENT_BLOCKED, peer->peer_info.peer_addr);
+    }
+}
+
 // used by multiple modes
 esp_err_t _add_discovered_peer(const char *name, uint8_t *address, uint32_t key, bool is_connected) 
 {
@@ -244,4 +531,5 @@ void _copy_peer_to_info(const FPR_STORE_HASH_TYPE *peer, fpr_peer_info_t *info)
     info->rssi = peer->rssi;
     info->last_seen_ms = (uint64_t)US_TO_MS(esp_timer_get_time() - peer->last_seen);
     info->packets_received = peer->packets_received;
+    info->channel = peer->channel;
 }
\ No newline at end of file
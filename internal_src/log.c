@@ -0,0 +1,224 @@
+/**
+ * @file log.c
+ * @brief FPR Rate-Limited Data Path Logging
+ *
+ * Token buckets per log site, suppressed-count summaries, and the deferred
+ * log task. Sites are static storage in the functions that log, so once a
+ * site is linked into the summary list it stays there.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/internal/log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+static const char *TAG = "fpr_log";
+
+#define LOG_LINE_MAX 160
+#define LOG_TOKEN 1000
+
+// Arguments are replayed as 32-bit words, which only matches the caller's
+// types on a 32-bit target
+#if (FPR_LOG_DEFERRED == 1) && (UINTPTR_MAX == UINT32_MAX)
+#define LOG_CAN_DEFER 1
+#else
+#define LOG_CAN_DEFER 0
+#endif
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static fpr_log_site_t *s_sites;
+
+bool _fpr_log_admit(fpr_log_site_t *site, const char *tag, uint32_t *suppressed)
+{
+    int64_t now = esp_timer_get_time();
+    bool admit;
+
+    taskENTER_CRITICAL(&s_lock);
+    if (site->last_us == 0) {
+        site->tag = tag;
+        site->tokens = FPR_LOG_BURST * LOG_TOKEN;
+    } else {
+        uint64_t refill = (uint64_t)(now - site->last_us) * FPR_LOG_RATE_PER_SEC / 1000;
+        uint64_t tokens = site->tokens + refill;
+        site->tokens = tokens > FPR_LOG_BURST * LOG_TOKEN ? FPR_LOG_BURST * LOG_TOKEN : (uint32_t)tokens;
+    }
+    site->last_us = now;
+
+    admit = site->tokens >= LOG_TOKEN;
+    if (admit) {
+        site->tokens -= LOG_TOKEN;
+        *suppressed = site->suppressed;
+        site->suppressed = 0;
+    } else {
+        site->suppressed++;
+        if (!site->listed) {
+            site->listed = true;
+            site->next = s_sites;
+            s_sites = site;
+        }
+    }
+    taskEXIT_CRITICAL(&s_lock);
+    return admit;
+}
+
+static char _level_letter(esp_log_level_t level)
+{
+    switch (level) {
+        case ESP_LOG_ERROR: return 'E';
+        case ESP_LOG_WARN:  return 'W';
+        case ESP_LOG_INFO:  return 'I';
+        case ESP_LOG_DEBUG: return 'D';
+        default:            return 'V';
+    }
+}
+
+static void _print(esp_log_level_t level, const char *tag, uint32_t timestamp_ms, const char *line, uint32_t suppressed)
+{
+    if (suppressed > 0) {
+        esp_log_write(level, tag, "%c (%" PRIu32 ") %s: %s (+%" PRIu32 " suppressed)\n",
+                      _level_letter(level), timestamp_ms, tag, line, suppressed);
+    } else {
+        esp_log_write(level, tag, "%c (%" PRIu32 ") %s: %s\n", _level_letter(level), timestamp_ms, tag, line);
+    }
+}
+
+#if (LOG_CAN_DEFER == 1)
+
+typedef struct {
+    const fpr_log_site_t *site;
+    const char *tag;
+    const char *fmt;
+    uint32_t timestamp_ms;
+    uint32_t suppressed;
+    uint8_t level;
+    uint32_t args[FPR_LOG_MAX_ARGS];
+} fpr_log_record_t;
+
+static QueueHandle_t s_queue;
+static uint32_t s_dropped;
+
+static const char *_basename(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+static void _print_summaries(void)
+{
+    uint32_t dropped = __atomic_exchange_n(&s_dropped, 0, __ATOMIC_RELAXED);
+    if (dropped > 0) {
+        ESP_LOGW(TAG, "%" PRIu32 " log lines lost (queue full)", dropped);
+    }
+
+    taskENTER_CRITICAL(&s_lock);
+    fpr_log_site_t *site = s_sites;
+    taskEXIT_CRITICAL(&s_lock);
+    // Sites are only ever pushed at the head, so the rest of the list is stable
+    for (; site != NULL; site = site->next) {
+        taskENTER_CRITICAL(&s_lock);
+        uint32_t suppressed = site->suppressed;
+        site->suppressed = 0;
+        taskEXIT_CRITICAL(&s_lock);
+        if (suppressed > 0) {
+            ESP_LOGW(site->tag, "%s:%u: %" PRIu32 " messages suppressed", _basename(site->file), site->line, suppressed);
+        }
+    }
+}
+
+static void _log_task(void *arg)
+{
+    (void)arg;
+    const TickType_t interval = pdMS_TO_TICKS(FPR_LOG_SUMMARY_INTERVAL_MS);
+    TickType_t summary_at = xTaskGetTickCount() + interval;
+    fpr_log_record_t rec;
+    char line[LOG_LINE_MAX];
+
+    for (;;) {
+        int32_t remaining = (int32_t)(summary_at - xTaskGetTickCount());
+        TickType_t wait = remaining > 0 ? (TickType_t)remaining : 0;
+        if (xQueueReceive(s_queue, &rec, wait) == pdPASS) {
+            // Unused trailing words are zero and ignored by the format
+            const uint32_t *a = rec.args;
+            snprintf(line, sizeof(line), rec.fmt, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7],
+                     a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15]);
+            _print((esp_log_level_t)rec.level, rec.tag, rec.timestamp_ms, line, rec.suppressed);
+        }
+        if ((int32_t)(xTaskGetTickCount() - summary_at) >= 0) {
+            _print_summaries();
+            summary_at = xTaskGetTickCount() + interval;
+        }
+    }
+}
+
+void _fpr_log_init(void)
+{
+    if (s_queue != NULL) {
+        return;
+    }
+    // Kept across fpr_network_deinit(): a log site may still be running on
+    // another task, and the queue must not disappear under it
+    QueueHandle_t queue = xQueueCreate(FPR_LOG_QUEUE_LENGTH, sizeof(fpr_log_record_t));
+    if (queue == NULL) {
+        ESP_LOGW(TAG, "No memory for the log queue, data path logs are formatted inline");
+        return;
+    }
+    s_queue = queue;
+    if (xTaskCreate(_log_task, "FPR_Log", 3072, NULL, tskIDLE_PRIORITY + 1, NULL) != pdPASS) {
+        ESP_LOGW(TAG, "Failed to start the log task, data path logs are formatted inline");
+        s_queue = NULL;
+        vQueueDelete(queue);
+    }
+}
+
+#else
+
+void _fpr_log_init(void)
+{
+}
+
+#endif
+
+void _fpr_log_emit(const fpr_log_site_t *site, esp_log_level_t level, const char *tag, uint32_t suppressed,
+                   const char *fmt, int nargs, ...)
+{
+    va_list ap;
+    va_start(ap, nargs);
+
+    #if (LOG_CAN_DEFER == 1)
+    QueueHandle_t queue = s_queue;
+    if (queue != NULL) {
+        fpr_log_record_t rec = {
+            .site = site,
+            .tag = tag,
+            .fmt = fmt,
+            .timestamp_ms = esp_log_timestamp(),
+            .suppressed = suppressed,
+            .level = (uint8_t)level,
+        };
+        for (int i = 0; i < nargs && i < FPR_LOG_MAX_ARGS; i++) {
+            rec.args[i] = va_arg(ap, uint32_t);
+        }
+        va_end(ap);
+        if (xQueueSend(queue, &rec, 0) != pdPASS) {
+            __atomic_fetch_add(&s_dropped, 1, __ATOMIC_RELAXED);
+        }
+        return;
+    }
+    #else
+    (void)site;
+    (void)nargs;
+    #endif
+
+    char line[LOG_LINE_MAX];
+    vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    _print(level, tag, esp_log_timestamp(), line, suppressed);
+}
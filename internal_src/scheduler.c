@@ -0,0 +1,257 @@
+/**
+ * @file scheduler.c
+ * @brief FPR Service Task
+ *
+ * Deadline-driven job slots on one task, one set per network instance.
+ * Jobs run outside the lock, bound to their instance; a generation count
+ * per slot keeps a set or cancel made while the job runs from being
+ * overwritten by the job's own return value, and a posted flag does the
+ * same for a post.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/internal/scheduler.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "fpr_sched";
+
+#define SCHED_MINUTE_US (60LL * 1000 * 1000)
+
+typedef struct {
+    fpr_job_fn_t fn;
+    int64_t deadline_us;    // 0 = due now
+    uint32_t generation;
+    bool armed;
+    bool posted;            // Posted since the job last started
+} fpr_job_t;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_task;
+static fpr_job_t s_jobs[FPR_MAX_INSTANCES][FPR_JOB_COUNT];
+static int s_running = -1;  // Instance whose job is running
+
+// Written by the service task only, read under s_lock
+static uint64_t s_wakeups;
+static uint64_t s_timer_wakeups;
+static uint64_t s_posted_wakeups;
+static int64_t s_window_start_us;
+static uint32_t s_window_count;
+static uint32_t s_last_minute;
+
+static void _count_wakeup(int64_t now_us, bool posted)
+{
+    taskENTER_CRITICAL(&s_lock);
+    s_wakeups++;
+    if (posted) {
+        s_posted_wakeups++;
+    } else {
+        s_timer_wakeups++;
+    }
+    if (now_us - s_window_start_us >= SCHED_MINUTE_US) {
+        s_last_minute = now_us - s_window_start_us < 2 * SCHED_MINUTE_US ? s_window_count : 0;
+        s_window_count = 0;
+        s_window_start_us = now_us;
+    }
+    s_window_count++;
+    taskEXIT_CRITICAL(&s_lock);
+}
+
+static TickType_t _ticks_until_next(int64_t now_us)
+{
+    int64_t next_us = INT64_MAX;
+
+    taskENTER_CRITICAL(&s_lock);
+    for (int n = 0; n < FPR_MAX_INSTANCES; n++) {
+        for (int i = 0; i < FPR_JOB_COUNT; i++) {
+            if (s_jobs[n][i].armed && s_jobs[n][i].deadline_us < next_us) {
+                next_us = s_jobs[n][i].deadline_us;
+            }
+        }
+    }
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (next_us == INT64_MAX) {
+        return portMAX_DELAY;
+    }
+    if (next_us <= now_us) {
+        return 0;
+    }
+    // Round up so the job is never woken just before its deadline
+    uint64_t ticks = ((uint64_t)(next_us - now_us) * configTICK_RATE_HZ + 999999) / 1000000;
+    return ticks >= portMAX_DELAY ? portMAX_DELAY - 1 : (TickType_t)ticks;
+}
+
+static void _run_due_jobs(int n, int64_t now_us)
+{
+    for (int i = 0; i < FPR_JOB_COUNT; i++) {
+        fpr_job_t *slot = &s_jobs[n][i];
+        taskENTER_CRITICAL(&s_lock);
+        fpr_job_t job = *slot;
+        bool due = job.armed && job.deadline_us <= now_us;
+        if (due) {
+            slot->posted = false;
+            s_running = n;
+        }
+        taskEXIT_CRITICAL(&s_lock);
+        if (!due) {
+            continue;
+        }
+
+        _fpr_instance_bind(&fpr_instances[n]);
+        int64_t next_us = job.fn(now_us);
+
+        taskENTER_CRITICAL(&s_lock);
+        if (slot->generation == job.generation) {
+            if (slot->posted) {
+                // Posted while running: the job may have missed the new work
+                slot->deadline_us = 0;
+            } else if (next_us == 0) {
+                slot->armed = false;
+            } else {
+                // A job that asks for a time already passed still yields first
+                slot->deadline_us = next_us > now_us ? next_us : now_us + 1;
+            }
+        }
+        s_running = -1;
+        taskEXIT_CRITICAL(&s_lock);
+    }
+}
+
+static void _sched_task(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        TickType_t wait = _ticks_until_next(esp_timer_get_time());
+        bool posted = ulTaskNotifyTake(pdTRUE, wait) > 0;
+        int64_t now_us = esp_timer_get_time();
+        _count_wakeup(now_us, posted);
+        for (int n = 0; n < FPR_MAX_INSTANCES; n++) {
+            _run_due_jobs(n, now_us);
+        }
+    }
+}
+
+esp_err_t _fpr_sched_init(void)
+{
+    taskENTER_CRITICAL(&s_lock);
+    s_wakeups = 0;
+    s_timer_wakeups = 0;
+    s_posted_wakeups = 0;
+    s_window_start_us = esp_timer_get_time();
+    s_window_count = 0;
+    s_last_minute = 0;
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (s_task != NULL) {
+        return ESP_OK;
+    }
+    if (xTaskCreatePinnedToCore(_sched_task, "FPR_Service", FPR_TASK_STACK_SIZE, NULL, FPR_TASK_PRIORITY,
+                                &s_task, FPR_RECONNECT_TASK_CORE_PIN_VALUE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the service task");
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void _fpr_sched_deinit(void)
+{
+    for (int i = 0; i < FPR_JOB_COUNT; i++) {
+        _fpr_sched_cancel((fpr_job_id_t)i);
+    }
+    if (s_task == NULL || xTaskGetCurrentTaskHandle() == s_task) {
+        return;
+    }
+    // A job may be half way through a peer walk; let it finish before peers are freed
+    const int instance = (int)_fpr_instance_index();
+    for (;;) {
+        taskENTER_CRITICAL(&s_lock);
+        bool running = s_running == instance;
+        taskEXIT_CRITICAL(&s_lock);
+        if (!running) {
+            break;
+        }
+        vTaskDelay(1);
+    }
+}
+
+void _fpr_sched_set(fpr_job_id_t id, fpr_job_fn_t fn, int64_t deadline_us)
+{
+    fpr_job_t *job = &s_jobs[_fpr_instance_index()][id];
+    taskENTER_CRITICAL(&s_lock);
+    job->fn = fn;
+    job->deadline_us = deadline_us;
+    job->generation++;
+    job->armed = true;
+    job->posted = false;
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+}
+
+void _fpr_sched_cancel(fpr_job_id_t id)
+{
+    fpr_job_t *job = &s_jobs[_fpr_instance_index()][id];
+    taskENTER_CRITICAL(&s_lock);
+    job->generation++;
+    job->armed = false;
+    taskEXIT_CRITICAL(&s_lock);
+}
+
+bool _fpr_sched_is_armed(fpr_job_id_t id)
+{
+    fpr_job_t *job = &s_jobs[_fpr_instance_index()][id];
+    taskENTER_CRITICAL(&s_lock);
+    bool armed = job->armed;
+    taskEXIT_CRITICAL(&s_lock);
+    return armed;
+}
+
+void _fpr_sched_post(fpr_job_id_t id)
+{
+    fpr_job_t *job = &s_jobs[_fpr_instance_index()][id];
+    taskENTER_CRITICAL(&s_lock);
+    bool armed = job->armed;
+    if (armed) {
+        job->deadline_us = 0;
+        job->posted = true;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (armed && s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+}
+
+bool _fpr_sched_is_service_task(void)
+{
+    return s_task != NULL && xTaskGetCurrentTaskHandle() == s_task;
+}
+
+void _fpr_sched_get_stats(fpr_wakeup_stats_t *stats)
+{
+    int64_t now_us = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&s_lock);
+    stats->wakeups = s_wakeups;
+    stats->timer_wakeups = s_timer_wakeups;
+    stats->posted_wakeups = s_posted_wakeups;
+    // The window only rolls over when the task wakes, so an idle task has
+    // to be accounted for here
+    int64_t age_us = now_us - s_window_start_us;
+    if (age_us < SCHED_MINUTE_US) {
+        stats->last_minute = s_last_minute;
+    } else if (age_us < 2 * SCHED_MINUTE_US) {
+        stats->last_minute = s_window_count;
+    } else {
+        stats->last_minute = 0;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+}
@@ -0,0 +1,171 @@
+/**
+ * @file services.c
+ * @brief FPR Internal Service Dispatcher
+ * 
+ * Routes frames carrying reserved service package IDs to the owning
+ * service module and manages service lifetime alongside the network.
+ * 
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/internal/services.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/log.h"
+#include "esp_log.h"
+
+static const char *TAG = "fpr_services";
+
+void _fpr_services_init(void)
+{
+    _fpr_rpc_init();
+    _fpr_pubsub_init();
+    _fpr_timesync_init();
+    _fpr_tdma_init();
+    _fpr_sleepy_init();
+    _fpr_channel_init();
+    _fpr_link_init();
+    _fpr_aggregate_init();
+    _fpr_tree_init();
+    _fpr_beacon_init();
+}
+
+void _fpr_services_deinit(void)
+{
+    _fpr_beacon_deinit();
+    _fpr_tree_deinit();
+    _fpr_aggregate_deinit();
+    _fpr_link_deinit();
+    _fpr_channel_deinit();
+    _fpr_sleepy_deinit();
+    _fpr_tdma_deinit();
+    _fpr_timesync_deinit();
+    _fpr_pubsub_deinit();
+    _fpr_rpc_deinit();
+}
+
+void _fpr_services_on_peer_connected(FPR_STORE_HASH_TYPE *peer)
+{
+    // A standby host only gets heartbeats until it takes over
+    if (fpr_net.current_mode == FPR_MODE_CLIENT && !_fpr_standby_on_host_connected(peer)) {
+        return;
+    }
+    _fpr_pubsub_on_peer_connected(peer);
+    _fpr_timesync_on_peer_connected(peer);
+    _fpr_sleepy_on_peer_connected(peer);
+}
+
+void _fpr_services_on_peer_disconnected(FPR_STORE_HASH_TYPE *peer)
+{
+    _fpr_pubsub_on_peer_disconnected(peer);
+    _fpr_sleepy_on_peer_disconnected(peer);
+    _fpr_channel_on_peer_disconnected(peer);
+}
+
+void _fpr_services_on_peer_removed(FPR_STORE_HASH_TYPE *peer)
+{
+    _fpr_standby_on_peer_removed(peer);
+    _fpr_link_on_peer_removed(peer);
+}
+
+bool _fpr_services_should_defer(const uint8_t *peer_address, fpr_package_id_t package_id)
+{
+    if (fpr_net.current_mode == FPR_MODE_HOST) {
+        return _fpr_sleepy_should_defer(peer_address, package_id);
+    }
+    return _fpr_tdma_should_defer(peer_address, package_id);
+}
+
+esp_err_t _fpr_services_defer(const fpr_package_t *package)
+{
+    if (fpr_net.current_mode == FPR_MODE_HOST) {
+        return _fpr_sleepy_enqueue(package);
+    }
+    return _fpr_tdma_enqueue(package);
+}
+
+bool _fpr_service_handle_frame(const esp_now_recv_info_t *esp_now_info, FPR_STORE_HASH_TYPE *peer, const fpr_package_t *package)
+{
+    (void)esp_now_info;
+    
+    // Taken first so time sync sees the least possible processing delay
+    int64_t rx_time_us = esp_timer_get_time();
+    
+    switch (package->id) {
+        case FPR_PACKET_ID_RPC:
+        case FPR_PACKET_ID_PUBSUB:
+        case FPR_PACKET_ID_TIMESYNC:
+        case FPR_PACKET_ID_BEACON:
+        case FPR_PACKET_ID_TDMA:
+        case FPR_PACKET_ID_SLEEPY:
+        case FPR_PACKET_ID_LINK:
+        case FPR_PACKET_ID_AGGREGATE:
+            break;
+        default:
+            return false;
+    }
+    
+    // Service frames always fit in a single packet
+    if (package->package_type != FPR_PACKAGE_TYPE_SINGLE) {
+        FPR_LOGW_RL(TAG, "Dropping fragmented service frame (id=%d) from " MACSTR, package->id, MAC2STR(peer->peer_info.peer_addr));
+        _fpr_stat_add(FPR_STAT_PACKETS_DROPPED, 1);
+        FPR_TRACE(FPR_TRACE_DROP, FPR_TRACE_DROP_MALFORMED, peer->peer_info.peer_addr, package);
+        return true;
+    }
+    
+    switch (package->id) {
+        case FPR_PACKET_ID_RPC:
+            _fpr_rpc_handle_frame(peer, package);
+            break;
+        case FPR_PACKET_ID_PUBSUB:
+            _fpr_pubsub_handle_frame(peer, package);
+            break;
+        case FPR_PACKET_ID_TIMESYNC:
+            _fpr_timesync_handle_frame(peer, package, rx_time_us);
+            break;
+        case FPR_PACKET_ID_BEACON:
+            _fpr_beacon_handle_frame(peer, package, rx_time_us);
+            break;
+        case FPR_PACKET_ID_TDMA:
+            _fpr_tdma_handle_frame(peer, package);
+            break;
+        case FPR_PACKET_ID_SLEEPY:
+            _fpr_sleepy_handle_frame(peer, package);
+            break;
+        case FPR_PACKET_ID_LINK:
+            _fpr_link_handle_frame(peer, package);
+            break;
+        case FPR_PACKET_ID_AGGREGATE:
+            _fpr_aggregate_handle_frame(peer, package);
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+bool _fpr_service_handle_broadcast(const esp_now_recv_info_t *esp_now_info, const fpr_package_t *package)
+{
+    int64_t rx_time_us = esp_timer_get_time();
+    
+    if (package->id != FPR_PACKET_ID_BEACON) {
+        return false;
+    }
+    
+    // Only the host we are connected to may drive our schedule
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(esp_now_info->src_addr);
+    if (peer == NULL || peer->state != FPR_PEER_STATE_CONNECTED) {
+        return true;
+    }
+    
+    // A beacon is proof of life for the host
+    _update_peer_rssi_and_timestamp(peer, esp_now_info);
+    
+    // A standby host's schedule is not ours until failover
+    if (fpr_net.current_mode == FPR_MODE_CLIENT && !_fpr_standby_is_active_host(peer->peer_info.peer_addr)) {
+        return true;
+    }
+    
+    _fpr_beacon_handle_frame(peer, package, rx_time_us);
+    return true;
+}
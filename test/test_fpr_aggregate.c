@@ -0,0 +1,144 @@
+/**
+ * @file test_fpr_aggregate.c
+ * @brief FPR In-Network Aggregation Test Implementation
+ *
+ * Feeds reports straight into the extender merge path, so no other device
+ * is needed. The sink address has no route, so the merged frame is counted
+ * as dropped rather than sent; either way exactly one frame must leave.
+ */
+
+#include "test_fpr_aggregate.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include "esp_netif.h"
+#include "esp_event.h"
+#include "nvs_flash.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_aggregate.h"
+#include "fpr/fpr_lts.h"
+#include "fpr/internal/private_defs.h"
+
+static const char *TAG = "FPR_AGGREGATE_TEST";
+
+#define TEST_PACKAGE_ID     42
+#define TEST_REPORTS        20
+#define TEST_WINDOW_MS      200
+
+extern bool _fpr_aggregate_absorb(const fpr_package_t *package);
+
+static esp_err_t wifi_init(void)
+{
+    esp_err_t ret = esp_netif_init();
+    if (ret != ESP_OK) return ret;
+
+    ret = esp_event_loop_create_default();
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) return ret;
+
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ret = esp_wifi_init(&cfg);
+    if (ret != ESP_OK) return ret;
+
+    ret = esp_wifi_set_storage(WIFI_STORAGE_RAM);
+    if (ret != ESP_OK) return ret;
+
+    ret = esp_wifi_set_mode(WIFI_MODE_STA);
+    if (ret != ESP_OK) return ret;
+
+    return esp_wifi_start();
+}
+
+static void build_report(fpr_package_t *package, uint8_t sensor, int32_t value)
+{
+    const uint8_t sink[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+    memset(package, 0, sizeof(*package));
+    package->package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package->id = TEST_PACKAGE_ID;
+    package->payload_size = sizeof(value);
+    package->sequence_num = 1;
+    memcpy(&package->protocol, &value, sizeof(value));
+    const uint8_t origin[6] = { 0x02, 0x00, 0x00, 0x00, 0x01, sensor };
+    memcpy(package->origin_mac, origin, sizeof(origin));
+    memcpy(package->dest_mac, sink, sizeof(sink));
+    package->max_hops = FPR_DEFAULT_MAX_HOPS;
+    package->version = FPR_PROTOCOL_VERSION;
+}
+
+esp_err_t fpr_aggregate_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Aggregation Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        ret = nvs_flash_init();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "NVS init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = wifi_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = fpr_network_init("FPR-Aggregate-Test");
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "FPR init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    fpr_network_set_mode(FPR_MODE_EXTENDER);
+
+    fpr_aggregate_config_t rule = {
+        .op = FPR_AGGREGATE_SUM,
+        .window_ms = TEST_WINDOW_MS,
+    };
+    ret = fpr_aggregate_register(TEST_PACKAGE_ID, &rule);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Rule registration failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    fpr_aggregate_stats_t before;
+    fpr_aggregate_get_stats(&before);
+
+    // [TEST 1] All reports of one window are absorbed
+    uint32_t absorbed = 0;
+    for (int i = 0; i < TEST_REPORTS; i++) {
+        fpr_package_t package;
+        build_report(&package, (uint8_t)i, i + 1);
+        absorbed += _fpr_aggregate_absorb(&package) ? 1 : 0;
+    }
+
+    // [TEST 2] Nothing leaves before the window ends
+    fpr_aggregate_stats_t during;
+    fpr_aggregate_get_stats(&during);
+    uint32_t early = (during.frames_out + during.dropped) - (before.frames_out + before.dropped);
+
+    vTaskDelay(pdMS_TO_TICKS(TEST_WINDOW_MS * 2 + FPR_AGGREGATE_TICK_MS));
+
+    // [TEST 3] One merged frame carries every report
+    fpr_aggregate_stats_t after;
+    fpr_aggregate_get_stats(&after);
+    uint32_t frames = (after.frames_out + after.dropped) - (before.frames_out + before.dropped);
+    uint32_t reports = after.reports_in - before.reports_in;
+
+    bool passed = (absorbed == TEST_REPORTS) && (early == 0) && (frames == 1) && (reports == TEST_REPORTS);
+
+    ESP_LOGI(TAG, "Absorbed:         %lu / %d", (unsigned long)absorbed, TEST_REPORTS);
+    ESP_LOGI(TAG, "Frames in window: %lu (expected 0)", (unsigned long)early);
+    ESP_LOGI(TAG, "Frames out:       %lu (expected 1)", (unsigned long)frames);
+    ESP_LOGI(TAG, "Reports merged:   %lu (expected %d)", (unsigned long)reports, TEST_REPORTS);
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "Result: %s", passed ? "PASSED" : "FAILED");
+    ESP_LOGI(TAG, "========================================");
+
+    fpr_aggregate_unregister(TEST_PACKAGE_ID);
+    fpr_network_deinit();
+    return passed ? ESP_OK : ESP_FAIL;
+}
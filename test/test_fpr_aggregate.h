@@ -0,0 +1,33 @@
+/**
+ * @file test_fpr_aggregate.h
+ * @brief FPR In-Network Aggregation Test API
+ *
+ * Single-device check of the extender merge path: reports of a reduce
+ * rule must leave as one merged frame per window.
+ */
+
+#ifndef TEST_FPR_AGGREGATE_H
+#define TEST_FPR_AGGREGATE_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the aggregation test
+ *
+ * Initializes WiFi and FPR as an extender, feeds reports of a SUM rule
+ * into the merge path and checks that exactly one frame comes out once
+ * the window ends.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_aggregate_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_AGGREGATE_H
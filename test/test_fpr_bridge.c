@@ -0,0 +1,136 @@
+/**
+ * @file test_fpr_bridge.c
+ * @brief FPR Serial Bridge Framing Test Implementation
+ *
+ * Frames are sealed and opened with the wire format functions both ends of
+ * the bridge share, and read back from a byte stream the way the Linux
+ * library splits it at the delimiters. No UART is opened.
+ */
+
+#include "test_fpr_bridge.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_bridge.h"
+#include "fpr/fpr_bridge_proto.h"
+
+static const char *TAG = "FPR_BRIDGE_TEST";
+
+#define TEST_MAX_BODY 600
+#define TEST_STREAM_SIZE (2 * FPR_BRIDGE_WIRE_MAX(FPR_BRIDGE_MAX_FRAME))
+
+static uint8_t s_frame[FPR_BRIDGE_MAX_FRAME];
+static uint8_t s_wire[FPR_BRIDGE_WIRE_MAX(FPR_BRIDGE_MAX_FRAME)];
+static uint8_t s_stream[TEST_STREAM_SIZE];
+
+// Seal len bytes of s_frame into s_wire, check the encoding, open it in
+// place and compare with the original
+static bool round_trip(size_t len)
+{
+    static uint8_t original[FPR_BRIDGE_MAX_FRAME];
+    memcpy(original, s_frame, len);
+    size_t wire_len = fpr_bridge_frame_seal(s_frame, len, s_wire);
+    if (wire_len > FPR_BRIDGE_WIRE_MAX(len + FPR_BRIDGE_CRC_LEN) || s_wire[wire_len - 1] != 0x00 ||
+        memchr(s_wire, 0x00, wire_len - 1) != NULL) {
+        return false;
+    }
+    int opened = fpr_bridge_frame_open(s_wire, wire_len - 1);
+    return opened == (int)len && memcmp(s_wire, original, len) == 0;
+}
+
+// A DATA frame with one record of n payload bytes, zeros included
+static size_t build_data_frame(uint16_t seq, size_t n)
+{
+    fpr_bridge_frame_header_t header = { .type = FPR_BRIDGE_FRAME_DATA, .count = 1, .seq = seq, .ack = 0 };
+    fpr_bridge_record_t record = { .addr = { 0x02, 0x00, 0x00, 0x00, 0x00, 0xD1 }, .id = 1, .len = (uint16_t)n };
+    size_t len = 0;
+    memcpy(&s_frame[len], &header, sizeof(header));
+    len += sizeof(header);
+    memcpy(&s_frame[len], &record, sizeof(record));
+    len += sizeof(record);
+    for (size_t i = 0; i < n; i++) {
+        s_frame[len++] = (uint8_t)(i % 3 == 0 ? 0 : i);
+    }
+    return len;
+}
+
+esp_err_t fpr_bridge_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Serial Bridge Framing Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Bridge-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    bool passed = true;
+
+    // [TEST 1] The CRC matches the CCITT-FALSE check value
+    passed &= fpr_test_check(TAG, "CRC check value", fpr_bridge_crc16((const uint8_t *)"123456789", 9) == 0x29B1);
+
+    // [TEST 2] Frames of every size survive the round trip, with and without zeros
+    bool all_ok = true;
+    for (size_t len = sizeof(fpr_bridge_frame_header_t); len <= TEST_MAX_BODY && all_ok; len++) {
+        for (size_t i = 0; i < len; i++) {
+            s_frame[i] = (uint8_t)(i % 255 + 1);
+        }
+        all_ok &= round_trip(len);
+        for (size_t i = 0; i < len; i++) {
+            s_frame[i] = (uint8_t)(i % 100 == 0 ? 0 : i);
+        }
+        all_ok &= round_trip(len);
+    }
+    passed &= fpr_test_check(TAG, "Every frame size round-trips", all_ok);
+    size_t len = build_data_frame(1, FPR_BRIDGE_MAX_FRAME - sizeof(fpr_bridge_frame_header_t) -
+                                         sizeof(fpr_bridge_record_t) - FPR_BRIDGE_CRC_LEN);
+    passed &= fpr_test_check(TAG, "Largest DATA frame round-trips", round_trip(len));
+
+    // [TEST 3] Damaged frames are rejected
+    len = build_data_frame(1, 40);
+    size_t wire_len = fpr_bridge_frame_seal(s_frame, len, s_wire);
+    s_wire[1]++;    // The frame type byte: 2 on the wire, never 0 after the change
+    bool corrupted = fpr_bridge_frame_open(s_wire, wire_len - 1) < 0;
+    len = build_data_frame(1, 40);
+    wire_len = fpr_bridge_frame_seal(s_frame, len, s_wire);
+    bool truncated = fpr_bridge_frame_open(s_wire, (wire_len - 1) / 2) < 0;
+    bool empty = fpr_bridge_frame_open(s_wire, 0) < 0;
+    passed &= fpr_test_check(TAG, "Bad CRC, truncated and empty frames are rejected", corrupted && truncated && empty);
+
+    // [TEST 4] A reader resynchronizes at the delimiter after a damaged frame
+    len = build_data_frame(1, 40);
+    size_t stream_len = fpr_bridge_frame_seal(s_frame, len, s_stream);
+    s_stream[1]++;
+    len = build_data_frame(2, 80);
+    stream_len += fpr_bridge_frame_seal(s_frame, len, &s_stream[stream_len]);
+    int good = 0;
+    int bad = 0;
+    uint16_t last_seq = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < stream_len; i++) {
+        if (s_stream[i] != 0x00) {
+            continue;
+        }
+        int opened = fpr_bridge_frame_open(&s_stream[start], i - start);
+        if (opened >= (int)sizeof(fpr_bridge_frame_header_t)) {
+            fpr_bridge_frame_header_t header;
+            memcpy(&header, &s_stream[start], sizeof(header));
+            last_seq = header.seq;
+            good++;
+        } else {
+            bad++;
+        }
+        start = i + 1;
+    }
+    passed &= fpr_test_check(TAG, "Stream resynchronizes after a bad frame", bad == 1 && good == 1 && last_seq == 2);
+
+    // [TEST 5] The bridge is idle until started
+    fpr_bridge_stats_t stats;
+    fpr_bridge_get_stats(&stats);
+    passed &= fpr_test_check(TAG, "Bridge is idle until started",
+                             !fpr_bridge_is_connected() && stats.to_host_records == 0 && stats.from_host_frames == 0);
+
+    return fpr_test_finish(TAG, passed);
+}
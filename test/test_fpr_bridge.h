@@ -0,0 +1,31 @@
+/**
+ * @file test_fpr_bridge.h
+ * @brief FPR Serial Bridge Framing Test API
+ *
+ * Single-device check of the bridge wire format: CRC, COBS round trips
+ * across frame sizes, rejection of damaged frames and stream resync.
+ */
+
+#ifndef TEST_FPR_BRIDGE_H
+#define TEST_FPR_BRIDGE_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the serial bridge framing test
+ *
+ * Initializes WiFi and FPR but opens no UART, so it needs no wiring.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_bridge_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_BRIDGE_H
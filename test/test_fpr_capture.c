@@ -0,0 +1,177 @@
+/**
+ * @file test_fpr_capture.c
+ * @brief FPR Packet Capture Test Implementation
+ *
+ * A capture runs into a memory sink while a frame from a client that does
+ * not exist is received and one is sent to it. The stream is then parsed
+ * back as pcap. A failing sink and a stopped capture must leave the stream
+ * untouched.
+ */
+
+#include "test_fpr_capture.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_capture.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_CAPTURE_TEST";
+
+#define TEST_DATA_ID 9
+#define TEST_STREAM_SIZE 8192
+
+// pcap layout, as written by fpr_capture.c
+typedef struct {
+    uint32_t magic;
+    uint16_t version_major;
+    uint16_t version_minor;
+    int32_t thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t linktype;
+} pcap_file_header_t;
+
+typedef struct {
+    uint32_t ts_sec;
+    uint32_t ts_usec;
+    uint32_t incl_len;
+    uint32_t orig_len;
+} pcap_record_header_t;
+
+// Keeps the first TEST_STREAM_SIZE bytes; background frames may follow
+static uint8_t s_stream[TEST_STREAM_SIZE];
+static size_t s_stream_len;
+static bool s_fail;
+
+static esp_err_t memory_sink(const void *data, size_t size, void *ctx)
+{
+    (void)ctx;
+    if (s_fail) {
+        return ESP_FAIL;
+    }
+    size_t room = TEST_STREAM_SIZE - (s_stream_len < TEST_STREAM_SIZE ? s_stream_len : TEST_STREAM_SIZE);
+    memcpy(&s_stream[TEST_STREAM_SIZE - room], data, size < room ? size : room);
+    s_stream_len += size;
+    return ESP_OK;
+}
+
+// Walk the records and keep the first one matching direction and peer
+static bool find_frame(fpr_capture_direction_t direction, const uint8_t *peer, pcap_record_header_t *rec_out,
+                       fpr_capture_header_t *meta_out, fpr_package_t *frame_out)
+{
+    size_t end = s_stream_len < TEST_STREAM_SIZE ? s_stream_len : TEST_STREAM_SIZE;
+    size_t pos = sizeof(pcap_file_header_t);
+    while (pos + sizeof(pcap_record_header_t) <= end) {
+        pcap_record_header_t rec;
+        memcpy(&rec, &s_stream[pos], sizeof(rec));
+        size_t body = pos + sizeof(rec);
+        if (rec.incl_len < sizeof(fpr_capture_header_t) || body + rec.incl_len > end) {
+            return false;
+        }
+        fpr_capture_header_t meta;
+        memcpy(&meta, &s_stream[body], sizeof(meta));
+        const uint8_t *other = (direction == FPR_CAPTURE_RX) ? meta.src : meta.dst;
+        if (meta.direction == direction && memcmp(other, peer, 6) == 0 &&
+            rec.incl_len == sizeof(meta) + sizeof(fpr_package_t)) {
+            *rec_out = rec;
+            *meta_out = meta;
+            memcpy(frame_out, &s_stream[body + sizeof(meta)], sizeof(*frame_out));
+            return true;
+        }
+        pos = body + rec.incl_len;
+    }
+    return false;
+}
+
+static void receive(const uint8_t *client, fpr_package_t *package)
+{
+    memset(package, 0, sizeof(*package));
+    package->id = TEST_DATA_ID;
+    package->package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package->payload_size = sizeof(int);
+    memcpy(package->origin_mac, client, 6);
+    memcpy(package->dest_mac, fpr_net.mac, 6);
+    package->max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_transport_receive(client, fpr_net.mac, package);
+}
+
+esp_err_t fpr_capture_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Packet Capture Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Capture-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint8_t client[6];
+    ret = fpr_network_start();
+    if (ret == ESP_OK) {
+        fpr_network_set_mode(FPR_MODE_HOST);
+        ret = fpr_test_add_fake_peer(0xA6, client);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    pcap_record_header_t rec;
+    fpr_capture_header_t meta;
+    fpr_package_t frame;
+    fpr_capture_stats_t stats;
+
+    // [TEST 1] Starting writes the pcap global header
+    ret = fpr_capture_start(memory_sink, NULL);
+    pcap_file_header_t header;
+    memcpy(&header, s_stream, sizeof(header));
+    passed &= fpr_test_check(TAG, "Global header is written",
+                             ret == ESP_OK && s_stream_len >= sizeof(header) && header.magic == 0xA1B2C3D4 &&
+                             header.linktype == FPR_CAPTURE_LINKTYPE &&
+                             header.snaplen == sizeof(fpr_capture_header_t) + sizeof(fpr_package_t));
+    passed &= fpr_test_check(TAG, "Second start is refused",
+                             fpr_capture_start(memory_sink, NULL) == ESP_ERR_INVALID_STATE);
+
+    // [TEST 2] A received frame is captured as it arrived, with link metadata
+    fpr_package_t received;
+    receive(client, &received);
+    bool found = find_frame(FPR_CAPTURE_RX, client, &rec, &meta, &frame);
+    passed &= fpr_test_check(TAG, "Received frame is captured",
+                             found && meta.version == FPR_CAPTURE_VERSION && meta.rssi == -40 &&
+                             memcmp(meta.dst, fpr_net.mac, 6) == 0 && rec.orig_len == rec.incl_len &&
+                             memcmp(&frame, &received, sizeof(frame)) == 0);
+
+    // [TEST 3] A sent frame is captured with the channel read back from the driver
+    int value = 1;
+    fpr_network_send_to_peer(client, &value, sizeof(value), TEST_DATA_ID);
+    found = find_frame(FPR_CAPTURE_TX, client, &rec, &meta, &frame);
+    passed &= fpr_test_check(TAG, "Sent frame is captured",
+                             found && meta.rssi == 0 && meta.channel == _fpr_get_current_channel() &&
+                             memcmp(meta.src, fpr_net.mac, 6) == 0 && frame.id == TEST_DATA_ID);
+    fpr_capture_get_stats(&stats);
+    passed &= fpr_test_check(TAG, "Captured frames are counted", stats.captured >= 2 && stats.skipped == 0);
+
+    // [TEST 4] A failing sink stops the capture after one skipped frame
+    s_fail = true;
+    receive(client, &received);
+    s_fail = false;
+    size_t len = s_stream_len;
+    receive(client, &received);
+    fpr_capture_get_stats(&stats);
+    passed &= fpr_test_check(TAG, "Failing sink stops the capture", stats.skipped == 1 && s_stream_len == len);
+
+    // [TEST 5] A new capture can start, and nothing is written after stop
+    s_stream_len = 0;
+    ret = fpr_capture_start(memory_sink, NULL);
+    fpr_capture_stop();
+    len = s_stream_len;
+    receive(client, &received);
+    fpr_network_send_to_peer(client, &value, sizeof(value), TEST_DATA_ID);
+    passed &= fpr_test_check(TAG, "Stopped capture writes nothing",
+                             ret == ESP_OK && len >= sizeof(pcap_file_header_t) && s_stream_len == len);
+
+    return fpr_test_finish(TAG, passed);
+}
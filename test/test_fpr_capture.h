@@ -0,0 +1,32 @@
+/**
+ * @file test_fpr_capture.h
+ * @brief FPR Packet Capture Test API
+ *
+ * Single-device check of the pcap stream: the global header, received and
+ * sent records with their metadata, a failing sink, restart and stop.
+ */
+
+#ifndef TEST_FPR_CAPTURE_H
+#define TEST_FPR_CAPTURE_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the packet capture test
+ *
+ * Initializes WiFi and FPR as a host with one injected client. Needs
+ * CONFIG_FPR_CAPTURE_ENABLE.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_capture_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_CAPTURE_H
@@ -0,0 +1,136 @@
+/**
+ * @file test_fpr_channel.c
+ * @brief FPR Channel Migration Test Implementation
+ *
+ * Congestion is simulated by reporting failed sends through the test
+ * transport. Clients exist only in the local peer table; "hearing" one on
+ * the new channel is an injected frame.
+ */
+
+#include "test_fpr_channel.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_channel.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/services.h"
+
+static const char *TAG = "FPR_CHANNEL_TEST";
+
+#define TEST_DATA_ID        1
+#define TEST_START_CHANNEL  1
+#define TEST_FAILED_SENDS   20
+#define TEST_SLACK_MS       300
+#define TEST_CLIENT_LEAD_MS 50
+
+static void hear(const uint8_t *mac)
+{
+    fpr_package_t package = {0};
+    package.id = TEST_DATA_ID;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(int);
+    memcpy(package.origin_mac, mac, 6);
+    memcpy(package.dest_mac, fpr_net.mac, 6);
+    fpr_test_receive(mac, fpr_net.mac, &package);
+}
+
+esp_err_t fpr_channel_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Channel Migration Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Channel-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    esp_wifi_set_channel(TEST_START_CHANNEL, WIFI_SECOND_CHAN_NONE);
+    // Started, so send results reach the channel monitor
+    ret = fpr_network_start();
+    fpr_network_set_mode(FPR_MODE_HOST);
+
+    uint8_t mac_a[6], mac_b[6];
+    if (ret == ESP_OK) {
+        ret = fpr_test_add_fake_peer(0xA0, mac_a);
+    }
+    if (ret == ESP_OK) {
+        ret = fpr_test_add_fake_peer(0xA1, mac_b);
+    }
+    fpr_channel_config_t config = fpr_channel_default_config();
+    config.candidates[0] = 1;
+    config.candidates[1] = 6;
+    config.candidates[2] = 11;
+    config.candidate_count = 3;
+    config.bad_windows = 1;
+    if (ret == ESP_OK) {
+        ret = fpr_channel_monitor_start(&config);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    fpr_channel_status_t status;
+    fpr_beacon_frame_t beacon = {0};
+
+    // [TEST 1] A window of failed sends announces a move to an untried channel
+    for (int i = 0; i < TEST_FAILED_SENDS; i++) {
+        fpr_test_send_done(mac_a, false);
+    }
+    vTaskDelay(pdMS_TO_TICKS(FPR_CHANNEL_EVAL_INTERVAL_MS + TEST_SLACK_MS));
+    fpr_channel_monitor_stop();
+    fpr_channel_get_status(&status);
+    _fpr_channel_fill_beacon(&beacon);
+    passed &= fpr_test_check(TAG, "Failed sends mark the window congested", status.failure_pct == 100);
+    passed &= fpr_test_check(TAG, "Host announces the first untried candidate", status.pending_channel == 6);
+    passed &= fpr_test_check(TAG, "Beacons carry the announcement",
+                             beacon.switch_channel == 6 && beacon.switch_in_ms > 0 &&
+                             beacon.switch_in_ms <= FPR_CHANNEL_SWITCH_DELAY_MS);
+    passed &= fpr_test_check(TAG, "A second switch cannot be announced meanwhile",
+                             fpr_channel_migrate(11) == ESP_ERR_INVALID_STATE);
+
+    // [TEST 2] The host switches when the lead time is up
+    vTaskDelay(pdMS_TO_TICKS(FPR_CHANNEL_SWITCH_DELAY_MS + TEST_SLACK_MS));
+    fpr_channel_get_status(&status);
+    memset(&beacon, 0, sizeof(beacon));
+    _fpr_channel_fill_beacon(&beacon);
+    passed &= fpr_test_check(TAG, "Host is on the new channel", _fpr_get_current_channel() == 6 && status.channel == 6);
+    passed &= fpr_test_check(TAG, "Migration is counted and no longer announced",
+                             status.migrations == 1 && status.pending_channel == 0 && beacon.switch_channel == 0);
+
+    // [TEST 3] Downtime ends with the last client heard; a client that never returns is lost
+    vTaskDelay(pdMS_TO_TICKS(20));
+    hear(mac_a);
+    fpr_channel_get_status(&status);
+    passed &= fpr_test_check(TAG, "Returning client sets the downtime", status.last_downtime_ms >= 20);
+    fpr_host_disconnect_peer(mac_b);
+    fpr_channel_get_status(&status);
+    passed &= fpr_test_check(TAG, "Client that never returned is lost", status.clients_lost == 1);
+
+    // [TEST 4] A client follows its host's announcement at the announced time
+    fpr_network_set_mode(FPR_MODE_CLIENT);
+    FPR_STORE_HASH_TYPE *host = _get_peer_from_map(mac_a);
+    memset(&beacon, 0, sizeof(beacon));
+    beacon.switch_channel = 11;
+    beacon.switch_in_ms = TEST_CLIENT_LEAD_MS;
+    _fpr_channel_on_beacon(host, &beacon, esp_timer_get_time());
+    _fpr_channel_on_beacon(host, &beacon, esp_timer_get_time());
+    fpr_channel_get_status(&status);
+    passed &= fpr_test_check(TAG, "Client arms the announced switch", status.pending_channel == 11);
+    passed &= fpr_test_check(TAG, "Client stays put until the switch time", _fpr_get_current_channel() == 6);
+    vTaskDelay(pdMS_TO_TICKS(TEST_CLIENT_LEAD_MS + TEST_SLACK_MS));
+    hear(mac_a);
+    fpr_channel_get_status(&status);
+    passed &= fpr_test_check(TAG, "Client switches once for repeated announcements",
+                             _fpr_get_current_channel() == 11 && status.migrations == 2);
+    passed &= fpr_test_check(TAG, "Client measures the downtime until its host is heard",
+                             status.last_downtime_ms >= TEST_SLACK_MS / 2);
+
+    return fpr_test_finish(TAG, passed);
+}
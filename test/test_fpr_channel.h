@@ -0,0 +1,35 @@
+/**
+ * @file test_fpr_channel.h
+ * @brief FPR Channel Migration Test API
+ *
+ * Single-device check of coordinated channel migration: congestion
+ * detection, the announced switch and the downtime bookkeeping on both
+ * the host and the client side.
+ */
+
+#ifndef TEST_FPR_CHANNEL_H
+#define TEST_FPR_CHANNEL_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the channel migration test
+ *
+ * Initializes WiFi and FPR as a host with two injected clients, makes the
+ * channel look congested and follows the migration it triggers, then
+ * follows a host's announcement as a client. Takes one channel evaluation
+ * window (CONFIG_FPR_CHANNEL_EVAL_INTERVAL_MS) plus about a second.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_channel_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_CHANNEL_H
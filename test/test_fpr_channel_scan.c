@@ -0,0 +1,124 @@
+/**
+ * @file test_fpr_channel_scan.c
+ * @brief FPR Multi-Channel Scan Test Implementation
+ *
+ * A helper task follows the radio through the sweep and, shortly after
+ * each channel change, injects the probe responses a host on that channel
+ * would send. One of them claims a different channel than it arrives on,
+ * as a frame leaking in from an adjacent channel does.
+ */
+
+#include "test_fpr_channel_scan.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_CHAN_SCAN_TEST";
+
+// Answer well inside the dwell, after the sweep reset its responder list
+#define TEST_ANSWER_DELAY_MS 5
+#define TEST_WEAK_RSSI      (-70)
+#define TEST_STRONG_RSSI    (-50)
+#define TEST_LEAK_RSSI      (-30)
+#define TEST_START_CHANNEL  13
+
+static const uint8_t s_channels[] = { 1, 6, 11 };
+static const uint8_t s_host_strong[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x90 };
+static const uint8_t s_host_weak[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x91 };
+static const uint8_t s_host_leak[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x92 };
+static const uint8_t s_broadcast[6] = FPR_BROADCAST_ADDRESS;
+
+static volatile bool s_scan_done;
+
+static void answer(const uint8_t *host, uint8_t host_channel, uint8_t rx_channel, int8_t rssi)
+{
+    fpr_package_t package = {0};
+    fpr_probe_frame_t *probe = (fpr_probe_frame_t *)&package.protocol;
+    probe->kind = FPR_PROBE_KIND_RESPONSE;
+    probe->channel = host_channel;
+    strlcpy(probe->info.name, "Scan-Host", sizeof(probe->info.name));
+    package.id = FPR_PACKET_ID_PROBE;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(*probe);
+    memcpy(package.origin_mac, host, 6);
+    memcpy(package.dest_mac, s_broadcast, 6);
+    fpr_test_receive_on(host, s_broadcast, rssi, rx_channel, &package);
+}
+
+// Strong host on 6, weak host on 11, and on 1 a loud host from 6 leaking in
+static void hosts_task(void *arg)
+{
+    uint8_t last = 0;
+    while (!s_scan_done) {
+        uint8_t channel = _fpr_get_current_channel();
+        if (channel != last) {
+            last = channel;
+            vTaskDelay(pdMS_TO_TICKS(TEST_ANSWER_DELAY_MS));
+            if (channel == 1) {
+                answer(s_host_leak, 6, 1, TEST_LEAK_RSSI);
+            } else if (channel == 6) {
+                answer(s_host_strong, 6, 6, TEST_STRONG_RSSI);
+            } else if (channel == 11) {
+                answer(s_host_weak, 11, 11, TEST_WEAK_RSSI);
+            }
+        }
+        vTaskDelay(1);
+    }
+    xTaskNotifyGive((TaskHandle_t)arg);
+    vTaskDelete(NULL);
+}
+
+esp_err_t fpr_channel_scan_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Multi-Channel Scan Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-ChanScan-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = fpr_network_start();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Start failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    // Start off every swept channel, so the helper sees each one arrive
+    esp_wifi_set_channel(TEST_START_CHANNEL, WIFI_SECOND_CHAN_NONE);
+    s_scan_done = false;
+    if (xTaskCreate(hosts_task, "scan_hosts", 4096, xTaskGetCurrentTaskHandle(), 5, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create host task");
+        return fpr_test_finish(TAG, false);
+    }
+    fpr_channel_scan_report_t report;
+    ret = fpr_client_scan_channels(s_channels, sizeof(s_channels), &report);
+    s_scan_done = true;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    bool passed = true;
+    passed &= fpr_test_check(TAG, "Scan finds a host", ret == ESP_OK);
+    passed &= fpr_test_check(TAG, "Report covers every channel", report.channel_count == sizeof(s_channels));
+    passed &= fpr_test_check(TAG, "Answer from another channel is ignored", report.channels[0].hosts == 0);
+    passed &= fpr_test_check(TAG, "Each host is counted on its channel",
+                             report.channels[1].hosts == 1 && report.channels[1].best_rssi == TEST_STRONG_RSSI &&
+                             report.channels[2].hosts == 1 && report.channels[2].best_rssi == TEST_WEAK_RSSI);
+    passed &= fpr_test_check(TAG, "Client locks onto the strongest host's channel",
+                             report.locked_channel == 6 && memcmp(report.best_host, s_host_strong, 6) == 0);
+    passed &= fpr_test_check(TAG, "Radio stays on the locked channel", _fpr_get_current_channel() == 6);
+    passed &= fpr_test_check(TAG, "Scan time covers every dwell",
+                             report.duration_ms >= sizeof(s_channels) * FPR_CHANNEL_SCAN_DWELL_MS);
+
+    // A sweep where nobody answers puts the radio back where it was
+    const uint8_t silent_channel = 1;
+    ret = fpr_client_scan_channels(&silent_channel, 1, &report);
+    passed &= fpr_test_check(TAG, "Empty sweep reports no host", ret == ESP_ERR_NOT_FOUND && report.locked_channel == 0);
+    passed &= fpr_test_check(TAG, "Empty sweep restores the channel", _fpr_get_current_channel() == 6);
+
+    return fpr_test_finish(TAG, passed);
+}
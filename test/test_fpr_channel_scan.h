@@ -0,0 +1,33 @@
+/**
+ * @file test_fpr_channel_scan.h
+ * @brief FPR Multi-Channel Scan Test API
+ *
+ * Single-device check of the client's channel sweep: per-channel results,
+ * rejection of answers overheard from another channel and locking onto
+ * the strongest host's channel.
+ */
+
+#ifndef TEST_FPR_CHANNEL_SCAN_H
+#define TEST_FPR_CHANNEL_SCAN_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the multi-channel scan test
+ *
+ * Initializes WiFi and FPR as a client and sweeps three channels while
+ * injected hosts answer on two of them.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_channel_scan_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_CHANNEL_SCAN_H
@@ -23,7 +23,9 @@
 #include "nvs_flash.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
 #include "fpr/fpr.h"
+#include "fpr/fpr_event.h"
 #include "esp_mac.h"
 
 static const char *TAG = "FPR_CLIENT_TEST";
@@ -34,8 +36,10 @@ static uint32_t test_scan_duration_ms = 5000;
 static uint32_t test_message_interval_ms = 5000;
 static bool test_use_latest_only_mode = false;
 
-// Connection state
+// Connection state, kept current by event_task
 static bool is_connected = false;
+static EventGroupHandle_t conn_events = NULL;
+#define CONNECTED_BIT (1 << 0)
 static uint8_t connected_host_mac[6];
 static char connected_host_name[32];
 
@@ -54,6 +58,7 @@ static TaskHandle_t stats_task_handle = NULL;
 static TaskHandle_t message_task_handle = NULL;
 static TaskHandle_t manual_conn_task_handle = NULL;
 static TaskHandle_t auto_connect_task_handle = NULL;
+static TaskHandle_t event_task_handle = NULL;
 
 /**
  * Client callback: Host discovered
@@ -162,15 +167,10 @@ static void client_loop_task(void *pvParameters)
         ESP_LOGE(TAG, "[RECONNECT] Failed to start reconnect task: %s", esp_err_to_name(reconnect_err));
     }
     
-    // Check if connected
-    is_connected = fpr_client_is_connected();
+    // is_connected is maintained by event_task
     if (is_connected) {
-        successful_connections++;
-        esp_err_t info_err = fpr_client_get_host_info(connected_host_mac, connected_host_name, sizeof(connected_host_name));
-        if (info_err == ESP_OK) {
-            ESP_LOGI(TAG, "[LOOP] Successfully connected to host: %s (" MACSTR ")", 
-                     connected_host_name, MAC2STR(connected_host_mac));
-        }
+        ESP_LOGI(TAG, "[LOOP] Successfully connected to host: %s (" MACSTR ")", 
+                 connected_host_name, MAC2STR(connected_host_mac));
     } else {
         ESP_LOGW(TAG, "[LOOP] Loop completed but no connection established");
     }
@@ -210,41 +210,78 @@ static void message_task(void *pvParameters)
     }
 }
 
+static const char *event_reason_name(fpr_event_reason_t reason)
+{
+    switch (reason) {
+        case FPR_EVENT_REASON_LOCAL: return "local";
+        case FPR_EVENT_REASON_REMOTE: return "remote";
+        case FPR_EVENT_REASON_TIMEOUT: return "timeout";
+        case FPR_EVENT_REASON_PEER_RESTART: return "peer restart";
+        case FPR_EVENT_REASON_REMOVED: return "removed";
+        default: return "none";
+    }
+}
+
+/**
+ * Event task - tracks the host connection from FPR events, no polling
+ */
+static void event_task(void *pvParameters)
+{
+    fpr_event_t event;
+    
+    while (fpr_event_wait(&event, portMAX_DELAY) == ESP_OK) {
+        switch (event.type) {
+            case FPR_EVENT_CONNECTED:
+                // Direct client links also connect; only the host counts here
+                if (fpr_client_get_host_info(connected_host_mac, connected_host_name, sizeof(connected_host_name)) != ESP_OK ||
+                    memcmp(connected_host_mac, event.peer_mac, 6) != 0) {
+                    break;
+                }
+                if (successful_connections > 0) {
+                    successful_reconnections++;
+                    ESP_LOGI(TAG, "[RECONNECT] Successfully reconnected! (reconnection #%lu)", successful_reconnections);
+                }
+                successful_connections++;
+                is_connected = true;
+                xEventGroupSetBits(conn_events, CONNECTED_BIT);
+                ESP_LOGI(TAG, "[EVENT] Connected to host: %s (" MACSTR ")", connected_host_name, MAC2STR(connected_host_mac));
+                break;
+            case FPR_EVENT_DISCONNECTED:
+                if (is_connected && memcmp(connected_host_mac, event.peer_mac, 6) == 0) {
+                    is_connected = false;
+                    xEventGroupClearBits(conn_events, CONNECTED_BIT);
+                    connection_drops++;
+                    ESP_LOGW(TAG, "[DISCONNECT] Connection dropped (%s)! (drop #%lu)",
+                             event_reason_name(event.disconnected.reason), connection_drops);
+                }
+                break;
+            case FPR_EVENT_HANDSHAKE:
+                ESP_LOGI(TAG, "[EVENT] Handshake step %u with " MACSTR "%s", event.handshake.step,
+                         MAC2STR(event.peer_mac), event.handshake.failed ? " FAILED" : "");
+                break;
+            case FPR_EVENT_QUEUE_OVERFLOW:
+                ESP_LOGW(TAG, "[EVENT] Receive queue for " MACSTR " overflowing (%lu dropped)",
+                         MAC2STR(event.peer_mac), (unsigned long)event.overflow.dropped);
+                break;
+            default:
+                ESP_LOGD(TAG, "[EVENT] %s " MACSTR, fpr_event_type_to_name(event.type), MAC2STR(event.peer_mac));
+                break;
+        }
+    }
+    ESP_LOGE(TAG, "[EVENT] No event queue (CONFIG_FPR_EVENT_QUEUE_LENGTH is 0)");
+    event_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
 /**
  * Statistics task
  */
 static void stats_task(void *pvParameters)
 {
     TickType_t last_wake = xTaskGetTickCount();
-    TickType_t last_stats_print = xTaskGetTickCount();
-    bool was_connected = false;
     
     while (1) {
-        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(1000)); // Every 1 second - check connection frequently
-        
-        // Update connection status frequently for fast reconnection
-        bool currently_connected = fpr_client_is_connected();
-        
-        // Detect connection state changes
-        if (currently_connected && !was_connected) {
-            if (successful_connections > 0) {
-                successful_reconnections++;
-                ESP_LOGI(TAG, "[RECONNECT] Successfully reconnected! (reconnection #%lu)", successful_reconnections);
-            }
-        } else if (!currently_connected && was_connected) {
-            connection_drops++;
-            ESP_LOGW(TAG, "[DISCONNECT] Connection dropped! (drop #%lu)", connection_drops);
-        }
-        
-        is_connected = currently_connected;
-        was_connected = currently_connected;
-        
-        // Print statistics only every 10 seconds
-        TickType_t now = xTaskGetTickCount();
-        if ((now - last_stats_print) < pdMS_TO_TICKS(10000)) {
-            continue; // Skip printing, but keep updating connection status
-        }
-        last_stats_print = now;
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(10000)); // Every 10 seconds
         
         ESP_LOGI(TAG, "========== STATISTICS ==========");
         ESP_LOGI(TAG, "Mode: %s", test_auto_mode ? "AUTO" : "MANUAL");
@@ -269,14 +306,19 @@ static void stats_task(void *pvParameters)
         ESP_LOGI(TAG, "Reconnection attempts: %lu", reconnection_attempts);
         ESP_LOGI(TAG, "Successful reconnections: %lu", successful_reconnections);
         ESP_LOGI(TAG, "Connection drops: %lu", connection_drops);
+        ESP_LOGI(TAG, "Events lost: %lu", (unsigned long)fpr_event_get_dropped());
         ESP_LOGI(TAG, "Messages sent: %lu", messages_sent);
         ESP_LOGI(TAG, "Messages received: %lu", messages_received);
         
         // Show network stats including queue-related metrics
         fpr_network_stats_t net_stats;
         fpr_get_network_stats(&net_stats);
-        ESP_LOGI(TAG, "Packets dropped (queue overflow/latest-only): %lu", (unsigned long)net_stats.packets_dropped);
-        ESP_LOGI(TAG, "Replay attacks blocked: %lu", (unsigned long)net_stats.replay_attacks_blocked);
+        ESP_LOGI(TAG, "Packets dropped (queue overflow/latest-only): %llu", (unsigned long long)net_stats.packets_dropped);
+        ESP_LOGI(TAG, "Replay attacks blocked: %llu", (unsigned long long)net_stats.replay_attacks_blocked);
+        fpr_wakeup_stats_t wake_stats;
+        fpr_network_get_wakeup_stats(&wake_stats);
+        ESP_LOGI(TAG, "Service task wake-ups: %lu/min (%llu timer, %llu posted)", (unsigned long)wake_stats.last_minute,
+                 (unsigned long long)wake_stats.timer_wakeups, (unsigned long long)wake_stats.posted_wakeups);
         ESP_LOGI(TAG, "================================");
     }
 }
@@ -332,9 +374,7 @@ static void monitor_task(void *pvParameters)
 static void queue_mode_stress_test_task(void *pvParameters)
 {
     // Wait for connection to be established
-    while (!is_connected) {
-        vTaskDelay(pdMS_TO_TICKS(1000));
-    }
+    xEventGroupWaitBits(conn_events, CONNECTED_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
     
     // Wait a bit more for stable connection
     vTaskDelay(pdMS_TO_TICKS(3000));
@@ -638,16 +678,6 @@ esp_err_t fpr_client_test_start(const fpr_client_test_config_t *config)
     fpr_network_set_mode(FPR_MODE_CLIENT);
     ESP_LOGI(TAG, "Mode set to CLIENT");
     
-    // Check connection status periodically
-    is_connected = fpr_client_is_connected();
-    if (is_connected) {
-        esp_err_t info_err = fpr_client_get_host_info(connected_host_mac, connected_host_name, sizeof(connected_host_name));
-        if (info_err == ESP_OK) {
-            successful_connections++;
-            ESP_LOGI(TAG, "[CONNECT] Already connected to: %s (" MACSTR ")", connected_host_name, MAC2STR(connected_host_mac));
-        }
-    }
-    
     ESP_LOGI(TAG, "========================================");
     ESP_LOGI(TAG, "FPR Client is now RUNNING");
     if (test_auto_mode) {
@@ -657,7 +687,15 @@ esp_err_t fpr_client_test_start(const fpr_client_test_config_t *config)
     }
     ESP_LOGI(TAG, "========================================");
     
+    if (conn_events == NULL) {
+        conn_events = xEventGroupCreate();
+        if (conn_events == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    
     // Start tasks
+    xTaskCreate(event_task, "client_events", 4096, NULL, 6, &event_task_handle);
     xTaskCreate(stats_task, "client_stats", 4096, NULL, 5, &stats_task_handle);
     xTaskCreate(message_task, "client_msg", 4096, NULL, 5, &message_task_handle);
     xTaskCreate(monitor_task, "client_mon", 4096, NULL, 5, NULL);
@@ -691,11 +729,19 @@ void fpr_client_test_stop(void)
         manual_conn_task_handle = NULL;
     }
     
+    if (event_task_handle != NULL) {
+        vTaskDelete(event_task_handle);
+        event_task_handle = NULL;
+    }
+    
     // Properly deinitialize FPR network to clean up all state
     fpr_network_deinit();
     
     // Reset all static variables for clean reinitialization
     is_connected = false;
+    if (conn_events != NULL) {
+        xEventGroupClearBits(conn_events, CONNECTED_BIT);
+    }
     hosts_found = 0;
     messages_sent = 0;
     messages_received = 0;
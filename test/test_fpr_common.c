@@ -0,0 +1,225 @@
+/**
+ * @file test_fpr_common.c
+ * @brief Shared setup for the single-device FPR tests
+ */
+
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include "esp_netif.h"
+#include "esp_event.h"
+#include "nvs_flash.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_lts.h"
+#include "fpr/fpr_transport.h"
+#include "fpr/internal/helpers.h"
+
+static esp_err_t wifi_init(void)
+{
+    esp_err_t ret = esp_netif_init();
+    if (ret != ESP_OK) return ret;
+
+    ret = esp_event_loop_create_default();
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) return ret;
+
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ret = esp_wifi_init(&cfg);
+    if (ret != ESP_OK) return ret;
+
+    ret = esp_wifi_set_storage(WIFI_STORAGE_RAM);
+    if (ret != ESP_OK) return ret;
+
+    ret = esp_wifi_set_mode(WIFI_MODE_STA);
+    if (ret != ESP_OK) return ret;
+
+    return esp_wifi_start();
+}
+
+// ESP-NOW for peers and receive, but sent frames only go into the log.
+// Nothing reaches the air, so send results come from fpr_test_send_done().
+static fpr_transport_ops_t s_recording_ops;
+static fpr_transport_t s_recording;
+static fpr_transport_rx_cb_t s_rx;
+static fpr_transport_tx_done_cb_t s_tx_done;
+static fpr_test_sent_t s_sent[FPR_TEST_SENT_LOG_SIZE];
+static size_t s_sent_total;
+static portMUX_TYPE s_sent_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_err_t recording_set_callbacks(void *ctx, fpr_transport_rx_cb_t rx, fpr_transport_tx_done_cb_t tx_done)
+{
+    s_rx = rx;
+    s_tx_done = tx_done;
+    return fpr_transport_espnow()->ops->set_callbacks(ctx, rx, tx_done);
+}
+
+static esp_err_t recording_send(void *ctx, const uint8_t *dest_addr, const uint8_t *data, size_t len)
+{
+    taskENTER_CRITICAL(&s_sent_lock);
+    if (len >= sizeof(fpr_package_t)) {
+        fpr_test_sent_t *entry = &s_sent[s_sent_total % FPR_TEST_SENT_LOG_SIZE];
+        memcpy(entry->dest, dest_addr, sizeof(entry->dest));
+        memcpy(&entry->package, data, sizeof(fpr_package_t));
+        s_sent_total++;
+    }
+    taskEXIT_CRITICAL(&s_sent_lock);
+    return ESP_OK;
+}
+
+static esp_err_t use_recording_transport(void)
+{
+    const fpr_transport_t *espnow = fpr_transport_espnow();
+    s_recording_ops = *espnow->ops;
+    s_recording_ops.name = "test-recording";
+    s_recording_ops.set_callbacks = recording_set_callbacks;
+    s_recording_ops.send = recording_send;
+    s_recording.ops = &s_recording_ops;
+    s_recording.ctx = espnow->ctx;
+    fpr_test_sent_reset();
+    return fpr_transport_set(&s_recording);
+}
+
+void fpr_test_send_done(const uint8_t dest[6], bool success)
+{
+    fpr_transport_tx_done_cb_t tx_done = s_tx_done;
+    if (tx_done != NULL) {
+        tx_done(dest, success);
+    }
+}
+
+void fpr_test_sent_reset(void)
+{
+    taskENTER_CRITICAL(&s_sent_lock);
+    s_sent_total = 0;
+    taskEXIT_CRITICAL(&s_sent_lock);
+}
+
+size_t fpr_test_sent_count(void)
+{
+    taskENTER_CRITICAL(&s_sent_lock);
+    size_t count = s_sent_total < FPR_TEST_SENT_LOG_SIZE ? s_sent_total : FPR_TEST_SENT_LOG_SIZE;
+    taskEXIT_CRITICAL(&s_sent_lock);
+    return count;
+}
+
+const fpr_test_sent_t *fpr_test_sent_get(size_t index)
+{
+    taskENTER_CRITICAL(&s_sent_lock);
+    size_t count = s_sent_total < FPR_TEST_SENT_LOG_SIZE ? s_sent_total : FPR_TEST_SENT_LOG_SIZE;
+    size_t total = s_sent_total;
+    taskEXIT_CRITICAL(&s_sent_lock);
+    return index < count ? &s_sent[(total - count + index) % FPR_TEST_SENT_LOG_SIZE] : NULL;
+}
+
+esp_err_t fpr_test_bring_up(const char *name)
+{
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        ret = nvs_flash_init();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(name, "NVS init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = wifi_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(name, "WiFi init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = use_recording_transport();
+    if (ret != ESP_OK) {
+        ESP_LOGE(name, "Transport setup failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = fpr_network_init(name);
+    if (ret != ESP_OK) {
+        ESP_LOGE(name, "FPR init failed: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+esp_err_t fpr_test_add_fake_peer(uint8_t last_octet, uint8_t mac_out[6])
+{
+    const uint8_t mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, last_octet };
+    memcpy(mac_out, mac, sizeof(mac));
+    return _add_peer_internal(mac_out, "FPR-Fake-Peer", true, 0);
+}
+
+static uint32_t s_sequence_num = 1;
+
+void fpr_test_inject(const uint8_t src[6], fpr_package_t *package)
+{
+    wifi_pkt_rx_ctrl_t rx_ctrl = { .rssi = -40 };
+    const esp_now_recv_info_t info = {
+        .src_addr = (uint8_t *)src,
+        .des_addr = fpr_net.mac,
+        .rx_ctrl = &rx_ctrl,
+    };
+    package->sequence_num = s_sequence_num++;
+    package->version = FPR_PROTOCOL_VERSION;
+    memcpy(package->origin_mac, src, MAC_ADDRESS_LENGTH);
+    _store_data_from_peer_helper(&info, package);
+}
+
+void fpr_test_receive(const uint8_t src[6], const uint8_t dest[6], fpr_package_t *package)
+{
+    fpr_test_receive_on(src, dest, -40, _fpr_get_current_channel(), package);
+}
+
+void fpr_test_receive_on(const uint8_t src[6], const uint8_t dest[6], int8_t rssi, uint8_t channel,
+                         fpr_package_t *package)
+{
+    wifi_pkt_rx_ctrl_t rx_ctrl = { .rssi = rssi, .channel = channel };
+    const esp_now_recv_info_t info = {
+        .src_addr = (uint8_t *)src,
+        .des_addr = (uint8_t *)dest,
+        .rx_ctrl = &rx_ctrl,
+    };
+    if (package->sequence_num == 0) {
+        package->sequence_num = s_sequence_num++;
+    }
+    package->version = FPR_PROTOCOL_VERSION;
+    esp_now_recv_cb_t receiver = fpr_net.receiver;
+    if (receiver != NULL) {
+        receiver(&info, (const uint8_t *)package, sizeof(*package));
+    }
+}
+
+void fpr_test_transport_receive(const uint8_t src[6], const uint8_t dest[6], fpr_package_t *package)
+{
+    const fpr_transport_rx_info_t info = {
+        .src_addr = src,
+        .dest_addr = dest,
+        .rssi = -40,
+        .channel = _fpr_get_current_channel(),
+    };
+    if (package->sequence_num == 0) {
+        package->sequence_num = s_sequence_num++;
+    }
+    package->version = FPR_PROTOCOL_VERSION;
+    fpr_transport_rx_cb_t rx = s_rx;
+    if (rx != NULL) {
+        rx(&info, (const uint8_t *)package, sizeof(*package));
+    }
+}
+
+bool fpr_test_check(const char *tag, const char *what, bool ok)
+{
+    if (ok) {
+        ESP_LOGI(tag, "[PASS] %s", what);
+    } else {
+        ESP_LOGE(tag, "[FAIL] %s", what);
+    }
+    return ok;
+}
+
+esp_err_t fpr_test_finish(const char *tag, bool passed)
+{
+    ESP_LOGI(tag, "========================================");
+    ESP_LOGI(tag, "Result: %s", passed ? "PASSED" : "FAILED");
+    ESP_LOGI(tag, "========================================");
+    fpr_network_deinit();
+    return passed ? ESP_OK : ESP_FAIL;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file test_fpr_common.h
+ * @brief Shared setup for the single-device FPR tests
+ *
+ * The single-device tests drive one feature through its public API and,
+ * where a second device would be needed, inject frames straight into the
+ * internal receive hooks. They share the bring-up and result reporting
+ * declared here.
+ */
+
+#ifndef TEST_FPR_COMMON_H
+#define TEST_FPR_COMMON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <esp_err.h>
+#include "fpr/internal/private_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FPR_TEST_SENT_LOG_SIZE 32
+
+/**
+ * @brief Initialize NVS, WiFi in STA mode and FPR under the given name
+ *
+ * @param name Network name passed to fpr_network_init()
+ * @return ESP_OK, or the first init error
+ */
+esp_err_t fpr_test_bring_up(const char *name);
+
+/**
+ * @brief Add a connected peer that exists only in the peer table
+ *
+ * Sends to it succeed locally and are never answered, which is what the
+ * timeout and retention checks need.
+ *
+ * @param last_octet Last byte of the locally administered MAC 02:00:00:00:00:xx
+ * @param mac_out Filled with the peer's MAC
+ * @return ESP_OK, or the error from adding the peer
+ */
+esp_err_t fpr_test_add_fake_peer(uint8_t last_octet, uint8_t mac_out[6]);
+
+/**
+ * @brief Feed a frame into the data receive path as if it came from src
+ *
+ * The frame goes through replay checks, service hooks and the peer queue
+ * exactly like a received one. The sequence number is stamped here.
+ *
+ * @param src Sending peer
+ * @param package Frame to deliver
+ */
+void fpr_test_inject(const uint8_t src[6], fpr_package_t *package);
+
+/**
+ * @brief Hand a frame to the current mode's receive handler as if it came off the air
+ *
+ * Unlike fpr_test_inject() the frame keeps its routing fields, so it can
+ * be one relayed for another node. A zero sequence number is stamped here.
+ *
+ * @param src Neighbor the frame arrives from
+ * @param dest Radio destination: this node's MAC or broadcast
+ * @param package Frame to deliver
+ */
+void fpr_test_receive(const uint8_t src[6], const uint8_t dest[6], fpr_package_t *package);
+
+/**
+ * @brief fpr_test_receive() with the link metadata of the frame
+ *
+ * fpr_test_receive() uses -40 dBm and the channel the radio is on.
+ *
+ * @param src Neighbor the frame arrives from
+ * @param dest Radio destination: this node's MAC or broadcast
+ * @param rssi Signal strength the frame arrives with
+ * @param channel Channel the frame arrives on
+ * @param package Frame to deliver
+ */
+void fpr_test_receive_on(const uint8_t src[6], const uint8_t dest[6], int8_t rssi, uint8_t channel,
+                         fpr_package_t *package);
+
+/**
+ * @brief Hand a frame to FPR the way the transport reports a received one
+ *
+ * Unlike fpr_test_receive() the frame also passes the steps that run for
+ * every frame before the mode handler: per-link loss accounting, capture
+ * and, with several instances, the choice of instance by network ID. A
+ * zero sequence number is stamped here.
+ *
+ * @param src Neighbor the frame arrives from
+ * @param dest Radio destination: this node's MAC or broadcast
+ * @param package Frame to deliver
+ */
+void fpr_test_transport_receive(const uint8_t src[6], const uint8_t dest[6], fpr_package_t *package);
+
+/**
+ * @brief A frame handed to the transport, as recorded by the send log
+ */
+typedef struct {
+    uint8_t dest[6];
+    fpr_package_t package;
+} fpr_test_sent_t;
+
+/**
+ * @brief Forget every frame recorded so far
+ *
+ * fpr_test_bring_up() installs a transport that uses ESP-NOW for peers and
+ * receive but only records sent frames; nothing goes on air. The log keeps
+ * the last FPR_TEST_SENT_LOG_SIZE frames since a reset.
+ */
+void fpr_test_sent_reset(void);
+
+/**
+ * @brief Number of frames recorded since the last reset
+ */
+size_t fpr_test_sent_count(void);
+
+/**
+ * @brief A recorded frame
+ *
+ * @param index 0 for the oldest frame still in the log
+ * @return The frame, or NULL past the end of the log
+ */
+const fpr_test_sent_t *fpr_test_sent_get(size_t index);
+
+/**
+ * @brief Report a send result as the radio would
+ *
+ * Sends are never reported on their own, since they never go on air.
+ *
+ * @param dest Destination of the frame the result is for
+ * @param success Whether the frame was acknowledged
+ */
+void fpr_test_send_done(const uint8_t dest[6], bool success);
+
+/**
+ * @brief Log one check and return its outcome
+ *
+ * @param tag Log tag of the calling test
+ * @param what Short description of the check
+ * @param ok Outcome
+ * @return ok
+ */
+bool fpr_test_check(const char *tag, const char *what, bool ok);
+
+/**
+ * @brief Log the final result line, deinit FPR and map the result
+ *
+ * @param tag Log tag of the calling test
+ * @param passed Whether every check passed
+ * @return ESP_OK if passed, ESP_FAIL otherwise
+ */
+esp_err_t fpr_test_finish(const char *tag, bool passed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_COMMON_H
@@ -411,10 +411,10 @@ static void stats_task(void *pvParameters)
         fpr_network_stats_t net_stats;
         fpr_get_network_stats(&net_stats);
         ESP_LOGI(TAG, "  FPR Stats:");
-        ESP_LOGI(TAG, "    Packets Sent:      %lu", net_stats.packets_sent);
-        ESP_LOGI(TAG, "    Packets Received:  %lu", net_stats.packets_received);
-        ESP_LOGI(TAG, "    Packets Dropped:   %lu", net_stats.packets_dropped);
-        ESP_LOGI(TAG, "    Send Failures:     %lu", net_stats.send_failures);
+        ESP_LOGI(TAG, "    Packets Sent:      %llu", (unsigned long long)net_stats.packets_sent);
+        ESP_LOGI(TAG, "    Packets Received:  %llu", (unsigned long long)net_stats.packets_received);
+        ESP_LOGI(TAG, "    Packets Dropped:   %llu", (unsigned long long)net_stats.packets_dropped);
+        ESP_LOGI(TAG, "    Send Failures:     %llu", (unsigned long long)net_stats.send_failures);
     }
 }
 
@@ -0,0 +1,147 @@
+/**
+ * @file test_fpr_event.c
+ * @brief FPR Connection Event Stream Test Implementation
+ *
+ * Peers that do not exist are added, blocked and flooded with injected
+ * frames, and the events they raise are read back from the queue and the
+ * callback. Events for other peers, from the host's own discovery, are
+ * skipped.
+ */
+
+#include "test_fpr_event.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_event.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_EVENT_TEST";
+
+#define TEST_DATA_ID 1
+#define TEST_WAIT_MS 100
+#define TEST_EXTRA_EVENTS 3
+
+// The MAC fpr_test_add_fake_peer(0xA7) gives
+static const uint8_t s_watched[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0xA7 };
+static int s_callback_count;
+
+static void on_event(const fpr_event_t *event, void *user_data)
+{
+    if (memcmp(event->peer_mac, s_watched, 6) == 0) {
+        (*(int *)user_data)++;
+    }
+}
+
+// Next queued event for peer, skipping everyone else's
+static bool next_event(const uint8_t *peer, fpr_event_t *out)
+{
+    while (fpr_event_wait(out, pdMS_TO_TICKS(TEST_WAIT_MS)) == ESP_OK) {
+        if (memcmp(out->peer_mac, peer, 6) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void drain_events(void)
+{
+    fpr_event_t event;
+    while (fpr_event_wait(&event, 0) == ESP_OK) {
+    }
+}
+
+static void inject(const uint8_t *client)
+{
+    fpr_package_t package = {0};
+    package.id = TEST_DATA_ID;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(int);
+    memcpy(package.dest_mac, fpr_net.mac, 6);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_inject(client, &package);
+}
+
+esp_err_t fpr_event_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Connection Event Stream Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Event-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = fpr_network_start();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+    fpr_network_set_mode(FPR_MODE_HOST);
+
+    bool passed = true;
+    fpr_event_t event;
+    uint8_t client[6];
+    uint8_t flooder[6];
+
+    // [TEST 1] A new connected peer is reported as discovered, then connected
+    drain_events();
+    fpr_event_register_callback(on_event, &s_callback_count);
+    ret = fpr_test_add_fake_peer(0xA7, client);
+    bool discovered = next_event(client, &event) && event.type == FPR_EVENT_PEER_DISCOVERED &&
+                      event.network_id == fpr_net.network_id;
+    int64_t discovered_us = event.timestamp_us;
+    passed &= fpr_test_check(TAG, "Discovery is reported", ret == ESP_OK && discovered);
+    passed &= fpr_test_check(TAG, "Connection follows discovery",
+                             next_event(client, &event) && event.type == FPR_EVENT_CONNECTED &&
+                             event.timestamp_us >= discovered_us);
+    passed &= fpr_test_check(TAG, "Callback sees the same events", s_callback_count == 2);
+
+    // [TEST 2] Blocking a connected peer reports the disconnect with its reason
+    fpr_host_block_peer(client);
+    passed &= fpr_test_check(TAG, "Block disconnects locally",
+                             next_event(client, &event) && event.type == FPR_EVENT_DISCONNECTED &&
+                             event.disconnected.reason == FPR_EVENT_REASON_LOCAL);
+    passed &= fpr_test_check(TAG, "Block is reported", next_event(client, &event) && event.type == FPR_EVENT_BLOCKED);
+    fpr_event_register_callback(NULL, NULL);
+
+    // [TEST 3] A full receive queue is reported once per episode
+    ret = fpr_test_add_fake_peer(0xA8, flooder);
+    drain_events();
+    for (int i = 0; i < FPR_QUEUE_LENGTH + TEST_EXTRA_EVENTS; i++) {
+        inject(flooder);
+    }
+    passed &= fpr_test_check(TAG, "Overflow is reported with the drop count",
+                             ret == ESP_OK && next_event(flooder, &event) && event.type == FPR_EVENT_QUEUE_OVERFLOW &&
+                             event.overflow.dropped == 1);
+    passed &= fpr_test_check(TAG, "Further drops are not reported again", !next_event(flooder, &event));
+    fpr_package_t package;
+    fpr_network_get_data_from_peer(flooder, &package.protocol, sizeof(package.protocol), 0);
+    inject(flooder);
+    inject(flooder);
+    passed &= fpr_test_check(TAG, "Overflow after an accepted frame is a new episode",
+                             next_event(flooder, &event) && event.type == FPR_EVENT_QUEUE_OVERFLOW &&
+                             event.overflow.dropped == TEST_EXTRA_EVENTS + 1);
+
+    // [TEST 4] Events posted to a full queue are dropped and counted
+    drain_events();
+    uint32_t dropped = fpr_event_get_dropped();
+    for (int i = 0; i < FPR_EVENT_QUEUE_LENGTH + TEST_EXTRA_EVENTS; i++) {
+        _fpr_event_peer(FPR_EVENT_ROUTE_CHANGED, client);
+    }
+    int queued = 0;
+    while (fpr_event_wait(&event, 0) == ESP_OK) {
+        queued++;
+    }
+    passed &= fpr_test_check(TAG, "Full queue drops and counts events",
+                             queued >= FPR_EVENT_QUEUE_LENGTH &&
+                             fpr_event_get_dropped() - dropped >= TEST_EXTRA_EVENTS);
+
+    // [TEST 5] Event names
+    passed &= fpr_test_check(TAG, "Event types are named",
+                             strcmp(fpr_event_type_to_name(FPR_EVENT_QUEUE_OVERFLOW), "queue overflow") == 0 &&
+                             strcmp(fpr_event_type_to_name((fpr_event_type_t)0), "unknown") == 0);
+
+    return fpr_test_finish(TAG, passed);
+}
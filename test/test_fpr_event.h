@@ -0,0 +1,32 @@
+/**
+ * @file test_fpr_event.h
+ * @brief FPR Connection Event Stream Test API
+ *
+ * Single-device check of the event stream: discovery, connection, block,
+ * receive queue overflow episodes and event queue overflow.
+ */
+
+#ifndef TEST_FPR_EVENT_H
+#define TEST_FPR_EVENT_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the connection event stream test
+ *
+ * Initializes WiFi and FPR as a host with injected clients. Needs a
+ * non-zero CONFIG_FPR_EVENT_QUEUE_LENGTH.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_event_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_EVENT_H
@@ -19,6 +19,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "fpr/fpr.h"
+#include "fpr/fpr_extender.h"
 #include "esp_mac.h"
 
 static const char *TAG = "FPR_EXTENDER_TEST";
@@ -51,14 +52,26 @@ static void stats_task(void *pvParameters)
         fpr_get_network_stats(&stats);
         
         ESP_LOGI(TAG, "========== STATISTICS ==========");
-        ESP_LOGI(TAG, "Packets sent: %lu", (unsigned long)stats.packets_sent);
-        ESP_LOGI(TAG, "Packets received: %lu", (unsigned long)stats.packets_received);
-        ESP_LOGI(TAG, "Packets forwarded: %lu", (unsigned long)stats.packets_forwarded);
-        ESP_LOGI(TAG, "Packets dropped: %lu", (unsigned long)stats.packets_dropped);
-        ESP_LOGI(TAG, "Send failures: %lu", (unsigned long)stats.send_failures);
-        ESP_LOGI(TAG, "Replay attacks blocked: %lu", (unsigned long)stats.replay_attacks_blocked);
+        ESP_LOGI(TAG, "Packets sent: %llu", (unsigned long long)stats.packets_sent);
+        ESP_LOGI(TAG, "Packets received: %llu", (unsigned long long)stats.packets_received);
+        ESP_LOGI(TAG, "Packets forwarded: %llu", (unsigned long long)stats.packets_forwarded);
+        ESP_LOGI(TAG, "Packets dropped: %llu", (unsigned long long)stats.packets_dropped);
+        ESP_LOGI(TAG, "Send failures: %llu", (unsigned long long)stats.send_failures);
+        ESP_LOGI(TAG, "Replay attacks blocked: %llu", (unsigned long long)stats.replay_attacks_blocked);
         ESP_LOGI(TAG, "Known peers: %zu", stats.peer_count);
         
+        // Rebroadcasts saved by multipoint relays compared with flooding
+        fpr_extender_broadcast_stats_t bcast;
+        fpr_extender_get_broadcast_stats(&bcast);
+        uint32_t flooded = bcast.rebroadcast + bcast.suppressed;
+        ESP_LOGI(TAG, "Broadcasts: %lu received, %lu duplicates, %lu rebroadcast, %lu saved (%lu%% of flooding)",
+                 (unsigned long)bcast.received, (unsigned long)bcast.duplicates,
+                 (unsigned long)bcast.rebroadcast, (unsigned long)bcast.suppressed,
+                 (unsigned long)(flooded > 0 ? bcast.suppressed * 100 / flooded : 0));
+        ESP_LOGI(TAG, "Relays (%s): %u neighbors (%u symmetric), %u two-hop, %u picked, picked by %u",
+                 bcast.mpr_enabled ? "MPR" : "flooding", bcast.neighbors, bcast.symmetric,
+                 bcast.two_hop, bcast.relays, bcast.selectors);
+        
         // Show queue depths for all known peers
         fpr_peer_info_t peers[10];
         size_t count = fpr_list_all_peers(peers, 10);
@@ -73,7 +86,7 @@ static void stats_task(void *pvParameters)
         ESP_LOGI(TAG, "================================");
         
         // Update local counters for get_stats API
-        messages_relayed = stats.packets_forwarded;
+        messages_relayed = (uint32_t)stats.packets_forwarded;
         bytes_relayed = 0;  // Byte count not available in network stats
     }
 }
@@ -117,8 +130,8 @@ static void monitor_task(void *pvParameters)
         fpr_network_stats_t stats;
         fpr_get_network_stats(&stats);
         
-        ESP_LOGI(TAG, "[MONITOR] Extender running, %lu messages forwarded", 
-                 (unsigned long)stats.packets_forwarded);
+        ESP_LOGI(TAG, "[MONITOR] Extender running, %llu messages forwarded", 
+                 (unsigned long long)stats.packets_forwarded);
     }
 }
 
@@ -24,6 +24,8 @@
 #include "nvs_flash.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "fpr/fpr_event.h"
 #include "esp_mac.h"
 
 static const char *TAG = "FPR_HOST_TEST";
@@ -41,9 +43,19 @@ static uint32_t peers_reconnected = 0;
 static uint32_t messages_received = 0;
 static uint32_t bytes_received = 0;
 
+// Clients that have connected at least once, to count reconnections
+#define MAX_TRACKED_CLIENTS 10
+static uint8_t known_clients[MAX_TRACKED_CLIENTS][6];
+static size_t known_client_count = 0;
+
+// Set by event_task once any client has connected
+static EventGroupHandle_t conn_events = NULL;
+#define CLIENT_CONNECTED_BIT (1 << 0)
+
 // Task handles
 static TaskHandle_t stats_task_handle = NULL;
 static TaskHandle_t main_test_task_handle = NULL;
+static TaskHandle_t event_task_handle = NULL;
 
 /**
  * Manual approval callback (only called in manual mode)
@@ -157,6 +169,64 @@ static void print_peer_list(void)
     }
 }
 
+static bool client_seen_before(const uint8_t *mac)
+{
+    for (size_t i = 0; i < known_client_count; i++) {
+        if (memcmp(known_clients[i], mac, 6) == 0) {
+            return true;
+        }
+    }
+    if (known_client_count < MAX_TRACKED_CLIENTS) {
+        memcpy(known_clients[known_client_count++], mac, 6);
+    }
+    return false;
+}
+
+/**
+ * Event task - reacts to client connections as they happen, no polling
+ */
+static void event_task(void *pvParameters)
+{
+    fpr_event_t event;
+    
+    while (fpr_event_wait(&event, portMAX_DELAY) == ESP_OK) {
+        switch (event.type) {
+            case FPR_EVENT_PEER_DISCOVERED:
+                // Manual mode counts requests in host_connection_request_cb
+                if (test_auto_mode) {
+                    peers_discovered++;
+                }
+                break;
+            case FPR_EVENT_CONNECTED:
+                if (client_seen_before(event.peer_mac)) {
+                    peers_reconnected++;
+                    ESP_LOGI(TAG, "[EVENT] Client " MACSTR " reconnected (#%lu)", MAC2STR(event.peer_mac), peers_reconnected);
+                } else {
+                    if (test_auto_mode) {
+                        peers_connected++;
+                    }
+                    ESP_LOGI(TAG, "[EVENT] Client " MACSTR " connected", MAC2STR(event.peer_mac));
+                }
+                xEventGroupSetBits(conn_events, CLIENT_CONNECTED_BIT);
+                break;
+            case FPR_EVENT_DISCONNECTED:
+                ESP_LOGW(TAG, "[EVENT] Client " MACSTR " disconnected (reason %d)",
+                         MAC2STR(event.peer_mac), event.disconnected.reason);
+                break;
+            case FPR_EVENT_QUEUE_OVERFLOW:
+                ESP_LOGW(TAG, "[EVENT] Receive queue for " MACSTR " overflowing (%lu dropped)",
+                         MAC2STR(event.peer_mac), (unsigned long)event.overflow.dropped);
+                break;
+            default:
+                ESP_LOGD(TAG, "[EVENT] %s " MACSTR, fpr_event_type_to_name(event.type), MAC2STR(event.peer_mac));
+                break;
+        }
+    }
+    ESP_LOGE(TAG, "[EVENT] No event queue (CONFIG_FPR_EVENT_QUEUE_LENGTH is 0)");
+    event_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
 /**
  * Statistics task
  */
@@ -167,15 +237,7 @@ static void stats_task(void *pvParameters)
     while (1) {
         vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(10000)); // Every 10 seconds
         
-        // In AUTO mode, counters aren't updated by callback, so count from peer list
         size_t current_connected = fpr_host_get_connected_count();
-        size_t total_peers = (size_t)fpr_network_get_peer_count();
-        
-        // Update counters for auto mode (manual mode uses callback)
-        if (test_auto_mode) {
-            peers_discovered = (uint32_t)total_peers;
-            peers_connected = (uint32_t)current_connected;
-        }
         
         ESP_LOGI(TAG, "========== STATISTICS ==========");
         ESP_LOGI(TAG, "Mode: %s", test_auto_mode ? "AUTO" : "MANUAL");
@@ -190,8 +252,12 @@ static void stats_task(void *pvParameters)
         // Show network stats including queue-related metrics
         fpr_network_stats_t net_stats;
         fpr_get_network_stats(&net_stats);
-        ESP_LOGI(TAG, "Packets dropped (queue overflow/latest-only): %lu", (unsigned long)net_stats.packets_dropped);
-        ESP_LOGI(TAG, "Replay attacks blocked: %lu", (unsigned long)net_stats.replay_attacks_blocked);
+        ESP_LOGI(TAG, "Packets dropped (queue overflow/latest-only): %llu", (unsigned long long)net_stats.packets_dropped);
+        ESP_LOGI(TAG, "Replay attacks blocked: %llu", (unsigned long long)net_stats.replay_attacks_blocked);
+        fpr_wakeup_stats_t wake_stats;
+        fpr_network_get_wakeup_stats(&wake_stats);
+        ESP_LOGI(TAG, "Service task wake-ups: %lu/min (%llu timer, %llu posted)", (unsigned long)wake_stats.last_minute,
+                 (unsigned long long)wake_stats.timer_wakeups, (unsigned long long)wake_stats.posted_wakeups);
         ESP_LOGI(TAG, "================================");
         
         print_peer_list();
@@ -229,44 +295,42 @@ static void host_loop_task(void *pvParameters)
         ESP_LOGE(TAG, "[RECONNECT] Failed to start reconnect task: %s", esp_err_to_name(reconnect_err));
     }
     
-    // Check connected peers
-    size_t connected_count = fpr_host_get_connected_count();
-    ESP_LOGI(TAG, "[LOOP] Connected peers: %zu", connected_count);
+    // Block until event_task has seen a client connect
+    if ((xEventGroupGetBits(conn_events) & CLIENT_CONNECTED_BIT) == 0) {
+        ESP_LOGW(TAG, "[LOOP] No clients connected after loop - waiting for one");
+    }
+    xEventGroupWaitBits(conn_events, CLIENT_CONNECTED_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+    ESP_LOGI(TAG, "[LOOP] Connected peers: %zu", fpr_host_get_connected_count());
     
-    if (connected_count > 0) {
-        // List all peers
-        print_peer_list();
-        
-        // Send data to all connected peers periodically
-        ESP_LOGI(TAG, "[LOOP] Starting to send data to connected clients...");
+    // List all peers
+    print_peer_list();
+    
+    // Send data to all connected peers periodically
+    ESP_LOGI(TAG, "[LOOP] Starting to send data to connected clients...");
+    
+    uint32_t msg_count = 0;
+    while (1) {
+        // Get all connected peers
+        fpr_peer_info_t peers[10];
+        size_t count = fpr_list_all_peers(peers, 10);
         
-        uint32_t msg_count = 0;
-        while (1) {
-            // Get all connected peers
-            fpr_peer_info_t peers[10];
-            size_t count = fpr_list_all_peers(peers, 10);
-            
-            for (size_t i = 0; i < count; i++) {
-                if (peers[i].state == FPR_PEER_STATE_CONNECTED) {
-                    // Send test message to this peer
-                    char message[100];
-                    snprintf(message, sizeof(message), "Host message #%lu to %s", ++msg_count, peers[i].name);
-                    
-                    esp_err_t ret = fpr_network_send_to_peer(peers[i].mac, (uint8_t*)message, 
-                                                             strlen(message) + 1, 0);
-                    if (ret == ESP_OK) {
-                        ESP_LOGI(TAG, "[SEND] Sent to %s: %s", peers[i].name, message);
-                    } else {
-                        ESP_LOGE(TAG, "[SEND] Failed to send to %s: %s", peers[i].name, esp_err_to_name(ret));
-                    }
+        for (size_t i = 0; i < count; i++) {
+            if (peers[i].state == FPR_PEER_STATE_CONNECTED) {
+                // Send test message to this peer
+                char message[100];
+                snprintf(message, sizeof(message), "Host message #%lu to %s", ++msg_count, peers[i].name);
+                
+                esp_err_t ret = fpr_network_send_to_peer(peers[i].mac, (uint8_t*)message, 
+                                                         strlen(message) + 1, 0);
+                if (ret == ESP_OK) {
+                    ESP_LOGI(TAG, "[SEND] Sent to %s: %s", peers[i].name, message);
+                } else {
+                    ESP_LOGE(TAG, "[SEND] Failed to send to %s: %s", peers[i].name, esp_err_to_name(ret));
                 }
             }
-            
-            vTaskDelay(pdMS_TO_TICKS(5000)); // Send every 5 seconds
         }
-    } else {
-        ESP_LOGW(TAG, "[LOOP] No clients connected after loop");
-        vTaskDelay(portMAX_DELAY);
+        
+        vTaskDelay(pdMS_TO_TICKS(5000)); // Send every 5 seconds
     }
 }
 
@@ -306,9 +370,7 @@ static esp_err_t wifi_init(void)
 static void host_queue_mode_stress_test_task(void *pvParameters)
 {
     // Wait for at least one client to connect
-    while (fpr_host_get_connected_count() == 0) {
-        vTaskDelay(pdMS_TO_TICKS(2000));
-    }
+    xEventGroupWaitBits(conn_events, CLIENT_CONNECTED_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
     
     // Wait a bit more for stable connection
     vTaskDelay(pdMS_TO_TICKS(3000));
@@ -599,6 +661,16 @@ esp_err_t fpr_host_test_start(const fpr_host_test_config_t *config)
     ESP_LOGI(TAG, "Waiting for client connections...");
     ESP_LOGI(TAG, "========================================");
     
+    if (conn_events == NULL) {
+        conn_events = xEventGroupCreate();
+        if (conn_events == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    
+    // Start event task first so no connection is missed
+    xTaskCreate(event_task, "host_events", 4096, NULL, 6, &event_task_handle);
+    
     // Start statistics task
     xTaskCreate(stats_task, "host_stats", 4096, NULL, 5, &stats_task_handle);
     
@@ -623,6 +695,11 @@ void fpr_host_test_stop(void)
         main_test_task_handle = NULL;
     }
     
+    if (event_task_handle != NULL) {
+        vTaskDelete(event_task_handle);
+        event_task_handle = NULL;
+    }
+    
     // Properly deinitialize FPR network to clean up all state
     fpr_network_deinit();
     
@@ -632,6 +709,10 @@ void fpr_host_test_stop(void)
     peers_reconnected = 0;
     messages_received = 0;
     bytes_received = 0;
+    known_client_count = 0;
+    if (conn_events != NULL) {
+        xEventGroupClearBits(conn_events, CLIENT_CONNECTED_BIT);
+    }
     
     ESP_LOGI(TAG, "FPR Host Test stopped and reset");
 }
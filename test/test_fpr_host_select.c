@@ -0,0 +1,160 @@
+/**
+ * @file test_fpr_host_select.c
+ * @brief FPR Host Load Selection Test Implementation
+ *
+ * Client side: probe responses from three hosts that do not exist are
+ * injected within one selection window. The strongest host is full, so a
+ * weaker, lightly loaded one should win. Host side: the load this device
+ * advertises and the rebalance hint it sends are read from the send log.
+ */
+
+#include "test_fpr_host_select.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/scheduler.h"
+
+static const char *TAG = "FPR_HOST_SELECT_TEST";
+
+#define TEST_CAPACITY       10
+#define TEST_MAX_PEERS      4
+#define TEST_REBALANCE_PCT  50
+#define TEST_SLACK_MS       100
+
+static const uint8_t s_host_full[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0xB0 };
+static const uint8_t s_host_light[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0xB1 };
+static const uint8_t s_host_far[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0xB2 };
+static const uint8_t s_broadcast[6] = FPR_BROADCAST_ADDRESS;
+
+static void announce(const uint8_t *host, int8_t rssi, uint8_t connected)
+{
+    fpr_package_t package = {0};
+    fpr_probe_frame_t *probe = (fpr_probe_frame_t *)&package.protocol;
+    probe->kind = FPR_PROBE_KIND_RESPONSE;
+    strlcpy(probe->info.name, "Select-Host", sizeof(probe->info.name));
+    probe->info.load.flags = FPR_HOST_LOAD_VALID;
+    probe->info.load.connected = connected;
+    probe->info.load.capacity = TEST_CAPACITY;
+    package.id = FPR_PACKET_ID_PROBE;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(*probe);
+    memcpy(package.origin_mac, host, 6);
+    memcpy(package.dest_mac, s_broadcast, 6);
+    fpr_test_receive_on(host, s_broadcast, rssi, _fpr_get_current_channel(), &package);
+}
+
+static bool sent_control_to(const uint8_t *mac)
+{
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        if (sent->package.id == FPR_PACKET_ID_CONTROL && memcmp(sent->dest, mac, 6) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Last probe frame of the given kind sent to dest
+static const fpr_probe_frame_t *sent_probe(fpr_probe_kind_t kind, const uint8_t *dest)
+{
+    const fpr_probe_frame_t *found = NULL;
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        const fpr_probe_frame_t *probe = (const fpr_probe_frame_t *)&sent->package.protocol;
+        if (sent->package.id == FPR_PACKET_ID_PROBE && probe->kind == kind && memcmp(sent->dest, dest, 6) == 0) {
+            found = probe;
+        }
+    }
+    return found;
+}
+
+esp_err_t fpr_host_select_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Host Load Selection Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Select-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    fpr_client_config_t client_config;
+    ret = fpr_network_start();
+    if (ret == ESP_OK) {
+        ret = fpr_client_get_config(&client_config);
+    }
+    if (ret == ESP_OK) {
+        client_config.connection_mode = FPR_CONNECTION_AUTO;
+        ret = fpr_client_set_config(&client_config);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+
+    // [TEST 1] A client joins the best-scoring host, not the first or the loudest
+    fpr_test_sent_reset();
+    announce(s_host_full, -40, TEST_CAPACITY);
+    announce(s_host_light, -60, 2);
+    announce(s_host_far, -85, 0);
+    passed &= fpr_test_check(TAG, "No host is joined while the window is open", !sent_control_to(s_host_full));
+    vTaskDelay(pdMS_TO_TICKS(FPR_HOST_SELECT_WINDOW_MS + TEST_SLACK_MS));
+    passed &= fpr_test_check(TAG, "Client joins the lightly loaded host", sent_control_to(s_host_light));
+    passed &= fpr_test_check(TAG, "Full and distant hosts are passed over",
+                             !sent_control_to(s_host_full) && !sent_control_to(s_host_far) &&
+                             _get_peer_from_map(s_host_full) == NULL && _get_peer_from_map(s_host_far) == NULL);
+
+    // [TEST 2] A host advertises its load in probe responses
+    fpr_network_set_mode(FPR_MODE_HOST);
+    bool idle = !_fpr_sched_is_armed(FPR_JOB_REBALANCE);
+    fpr_host_config_t host_config;
+    fpr_host_get_config(&host_config);
+    host_config.max_peers = TEST_MAX_PEERS;
+    host_config.rebalance_pct = TEST_REBALANCE_PCT;
+    fpr_host_set_config(&host_config);
+    passed &= fpr_test_check(TAG, "Overload check runs only with a threshold set",
+                             idle && _fpr_sched_is_armed(FPR_JOB_REBALANCE));
+
+    uint8_t near[6], weak[6];
+    ret = fpr_test_add_fake_peer(0xC0, near);
+    if (ret == ESP_OK) {
+        ret = fpr_test_add_fake_peer(0xC1, weak);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Adding clients failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+    _get_peer_from_map(near)->rssi = -40;
+    _get_peer_from_map(weak)->rssi = -80;
+
+    fpr_test_sent_reset();
+    fpr_package_t request = {0};
+    ((fpr_probe_frame_t *)&request.protocol)->kind = FPR_PROBE_KIND_REQUEST;
+    request.id = FPR_PACKET_ID_PROBE;
+    request.payload_size = sizeof(fpr_probe_frame_t);
+    memcpy(request.origin_mac, near, 6);
+    memcpy(request.dest_mac, s_broadcast, 6);
+    fpr_test_receive(near, s_broadcast, &request);
+    vTaskDelay(pdMS_TO_TICKS(FPR_PROBE_RESPONSE_JITTER_MS + TEST_SLACK_MS));
+    const fpr_probe_frame_t *response = sent_probe(FPR_PROBE_KIND_RESPONSE, s_broadcast);
+    passed &= fpr_test_check(TAG, "Probe response carries the load",
+                             response != NULL && (response->info.load.flags & FPR_HOST_LOAD_VALID) &&
+                             response->info.load.connected == 2 && response->info.load.capacity == TEST_MAX_PEERS);
+    passed &= fpr_test_check(TAG, "Load at the threshold is flagged overloaded",
+                             response != NULL && (response->info.load.flags & FPR_HOST_LOAD_OVERLOADED));
+
+    // [TEST 3] An overloaded host asks its weakest client to move
+    fpr_test_sent_reset();
+    vTaskDelay(pdMS_TO_TICKS(FPR_HOST_REBALANCE_INTERVAL_MS + TEST_SLACK_MS));
+    passed &= fpr_test_check(TAG, "Weakest client gets the rebalance hint",
+                             sent_probe(FPR_PROBE_KIND_REBALANCE, weak) != NULL);
+    passed &= fpr_test_check(TAG, "Stronger client is left alone", sent_probe(FPR_PROBE_KIND_REBALANCE, near) == NULL);
+
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,33 @@
+/**
+ * @file test_fpr_host_select.h
+ * @brief FPR Host Load Selection Test API
+ *
+ * Single-device check of host load advertising and of the client's choice
+ * between several hosts by load and RSSI.
+ */
+
+#ifndef TEST_FPR_HOST_SELECT_H
+#define TEST_FPR_HOST_SELECT_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the host load selection test
+ *
+ * Initializes WiFi and FPR as an auto-mode client that hears three injected
+ * hosts, then as a host with injected clients advertising its load. Waits
+ * for one rebalance period (CONFIG_FPR_HOST_REBALANCE_INTERVAL_MS).
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_host_select_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_HOST_SELECT_H
@@ -0,0 +1,153 @@
+/**
+ * @file test_fpr_instance.c
+ * @brief FPR Network Instances Test Implementation
+ *
+ * The default instance and a second one each get a client that does not
+ * exist. Frames are handed in the way the transport reports them, so the
+ * network ID in their header decides which instance gets them.
+ */
+
+#include "test_fpr_instance.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_instance.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_INSTANCE_TEST";
+
+#define TEST_NETWORK_ID 7
+#define TEST_UNKNOWN_NETWORK_ID 9
+#define TEST_DATA_ID 1
+
+static fpr_instance_t *s_raised;
+
+static void on_data(void *peer_addr, void *data, void *user_data)
+{
+    (void)peer_addr;
+    (void)data;
+    (void)user_data;
+    s_raised = fpr_instance_current();
+}
+
+static void receive(const uint8_t *client, uint8_t network_id, int value)
+{
+    fpr_package_t package = {0};
+    package.protocol.data_int[0] = value;
+    package.id = TEST_DATA_ID;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(int);
+    package.network_id = network_id;
+    memcpy(package.origin_mac, client, 6);
+    memcpy(package.dest_mac, fpr_net.mac, 6);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_transport_receive(client, fpr_net.mac, &package);
+}
+
+// Network ID of the newest frame sent to dest, or -1
+static int sent_network_id(const uint8_t *dest)
+{
+    for (size_t i = fpr_test_sent_count(); i-- > 0;) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        if (sent != NULL && memcmp(sent->dest, dest, 6) == 0 && sent->package.id == TEST_DATA_ID) {
+            return sent->package.network_id;
+        }
+    }
+    return -1;
+}
+
+esp_err_t fpr_instance_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Network Instances Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Instance-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    bool passed = true;
+    fpr_instance_t *other = NULL;
+    uint8_t client[6];
+    uint8_t other_client[6];
+
+    // [TEST 1] Network IDs are claimed once, and 0 stays the default's
+    fpr_instance_t *duplicate = NULL;
+    ret = fpr_instance_create(TEST_NETWORK_ID, &other);
+    passed &= fpr_test_check(TAG, "Instance is created for a network",
+                             ret == ESP_OK && fpr_instance_get_network_id(other) == TEST_NETWORK_ID);
+    passed &= fpr_test_check(TAG, "Network IDs are unique",
+                             fpr_instance_create(TEST_NETWORK_ID, &duplicate) == ESP_ERR_INVALID_STATE &&
+                             fpr_instance_create(FPR_INSTANCE_DEFAULT_NETWORK_ID, &duplicate) == ESP_ERR_INVALID_ARG);
+    if (ret != ESP_OK) {
+        return fpr_test_finish(TAG, false);
+    }
+
+    ret = fpr_network_start();
+    if (ret == ESP_OK) {
+        fpr_network_set_mode(FPR_MODE_HOST);
+        ret = fpr_test_add_fake_peer(0xB1, client);
+    }
+    if (ret == ESP_OK) {
+        ret = fpr_instance_init(other, "FPR-Instance-Other", NULL);
+    }
+    if (ret == ESP_OK) {
+        ret = fpr_network_start_ex(other);
+    }
+    if (ret == ESP_OK) {
+        fpr_network_set_mode_ex(other, FPR_MODE_HOST);
+        void *prev = _fpr_instance_enter(other);
+        ret = fpr_test_add_fake_peer(0xB2, other_client);
+        _fpr_instance_leave(prev);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        fpr_network_deinit_ex(other);
+        fpr_instance_destroy(other);
+        return fpr_test_finish(TAG, false);
+    }
+
+    // [TEST 2] Each instance has its own peers
+    fpr_peer_info_t info;
+    passed &= fpr_test_check(TAG, "Peers stay in their instance",
+                             fpr_get_peer_info_ex(other, other_client, &info) == ESP_OK &&
+                             fpr_get_peer_info_ex(other, client, &info) != ESP_OK &&
+                             fpr_get_peer_info(other_client, &info) != ESP_OK);
+
+    // [TEST 3] A received frame goes to the instance on its network ID
+    int value = 0;
+    fpr_register_receive_callback_ex(other, on_data);
+    receive(other_client, TEST_NETWORK_ID, 31);
+    bool got = fpr_network_get_data_from_peer_ex(other, other_client, &value, sizeof(value), 0);
+    passed &= fpr_test_check(TAG, "Frame reaches the instance on its network", got && value == 31);
+    passed &= fpr_test_check(TAG, "Callback is told the raising instance", s_raised == other);
+    fpr_register_receive_callback_ex(other, NULL);
+    receive(client, FPR_INSTANCE_DEFAULT_NETWORK_ID, 32);
+    got = fpr_network_get_data_from_peer(client, &value, sizeof(value), 0);
+    passed &= fpr_test_check(TAG, "Network ID 0 reaches the default instance", got && value == 32);
+
+    // [TEST 4] A frame for a network this device is not on is dropped
+    receive(client, TEST_UNKNOWN_NETWORK_ID, 33);
+    receive(other_client, TEST_UNKNOWN_NETWORK_ID, 33);
+    passed &= fpr_test_check(TAG, "Unknown network is dropped",
+                             fpr_network_get_peer_queued_packets(client) == 0 &&
+                             fpr_network_get_peer_queued_packets_ex(other, other_client) == 0);
+
+    // [TEST 5] Sent frames carry the sending instance's network ID
+    fpr_test_sent_reset();
+    fpr_network_send_to_peer_ex(other, other_client, &value, sizeof(value), TEST_DATA_ID);
+    fpr_network_send_to_peer(client, &value, sizeof(value), TEST_DATA_ID);
+    passed &= fpr_test_check(TAG, "Sent frames are stamped with the network ID",
+                             sent_network_id(other_client) == TEST_NETWORK_ID &&
+                             sent_network_id(client) == FPR_INSTANCE_DEFAULT_NETWORK_ID);
+
+    // [TEST 6] An instance is destroyed only once deinitialized
+    passed &= fpr_test_check(TAG, "Initialized instance is not destroyed",
+                             fpr_instance_destroy(other) == ESP_ERR_INVALID_STATE);
+    fpr_network_deinit_ex(other);
+    passed &= fpr_test_check(TAG, "Deinitialized instance is destroyed", fpr_instance_destroy(other) == ESP_OK);
+
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,33 @@
+/**
+ * @file test_fpr_instance.h
+ * @brief FPR Network Instances Test API
+ *
+ * Single-device check of two network instances: network ID claims, peer
+ * separation, receive demux by network ID, send stamping and teardown.
+ */
+
+#ifndef TEST_FPR_INSTANCE_H
+#define TEST_FPR_INSTANCE_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the network instances test
+ *
+ * Initializes WiFi and FPR as a host on the default instance and on a
+ * second one, each with one injected client. Needs CONFIG_FPR_MAX_INSTANCES
+ * of at least 2.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_instance_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_INSTANCE_H
@@ -0,0 +1,236 @@
+/**
+ * @file test_fpr_link.c
+ * @brief FPR Direct Client Link Test Implementation
+ *
+ * Client side: an injected host sends an introduction wrapped under a
+ * session key the test sets, then frames from the linked client arrive
+ * directly or through the host. The path each send takes is read from the
+ * send log. Host side: a link request and a client-to-client frame from
+ * injected clients are checked against the send log as well.
+ */
+
+#include "test_fpr_link.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_link.h"
+#include "fpr/fpr_security.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_LINK_TEST";
+
+#define TEST_DATA_ID 1
+
+// Introduction to peer under session_key, as the host builds it
+static void introduce(const uint8_t *host, const uint8_t *session_key, const uint8_t *peer, bool tamper)
+{
+    fpr_package_t package = {0};
+    fpr_link_frame_t *intro = (fpr_link_frame_t *)&package.protocol;
+    uint8_t key[FPR_KEY_SIZE];
+    uint8_t context[sizeof(intro->nonce) + 6];
+    intro->kind = FPR_LINK_KIND_INTRO;
+    memcpy(intro->peer, peer, 6);
+    strlcpy(intro->name, "Link-Peer", sizeof(intro->name));
+    esp_fill_random(intro->nonce, sizeof(intro->nonce));
+    esp_fill_random(key, sizeof(key));
+    memcpy(context, intro->nonce, sizeof(intro->nonce));
+    memcpy(&context[sizeof(intro->nonce)], peer, 6);
+    fpr_security_wrap_key(session_key, context, sizeof(context), key, intro->key, intro->check);
+    if (tamper) {
+        intro->check[0] ^= 0xFF;
+    }
+    package.id = FPR_PACKET_ID_LINK;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(*intro);
+    memcpy(package.origin_mac, host, 6);
+    memcpy(package.dest_mac, fpr_net.mac, 6);
+    fpr_test_receive(host, fpr_net.mac, &package);
+}
+
+// A frame from origin that reaches this node through src
+static void receive_from(const uint8_t *src, const uint8_t *origin, const uint8_t *dest, fpr_package_id_t id, int value)
+{
+    fpr_package_t package = {0};
+    package.protocol.data_int[0] = value;
+    package.id = id;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = id == FPR_PACKET_ID_LINK ? sizeof(fpr_link_frame_t) : sizeof(int);
+    memcpy(package.origin_mac, origin, 6);
+    memcpy(package.dest_mac, dest, 6);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    if (id == FPR_PACKET_ID_LINK) {
+        ((fpr_link_frame_t *)&package.protocol)->kind = FPR_LINK_KIND_HELLO;
+    }
+    fpr_test_receive(src, fpr_net.mac, &package);
+}
+
+// Last frame with the given ID and end-to-end destination handed to the radio
+static const fpr_test_sent_t *last_sent(fpr_package_id_t id, const uint8_t *dest_mac)
+{
+    const fpr_test_sent_t *found = NULL;
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        if (sent->package.id == id && memcmp(sent->package.dest_mac, dest_mac, 6) == 0) {
+            found = sent;
+        }
+    }
+    return found;
+}
+
+static esp_err_t add_keyed_peer(uint8_t last_octet, uint8_t mac_out[6], uint8_t lwk_out[FPR_KEY_SIZE])
+{
+    esp_err_t ret = fpr_test_add_fake_peer(last_octet, mac_out);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(mac_out);
+    esp_fill_random(peer->security.lwk, FPR_KEY_SIZE);
+    peer->security.lwk_valid = true;
+    if (lwk_out != NULL) {
+        memcpy(lwk_out, peer->security.lwk, FPR_KEY_SIZE);
+    }
+    return ESP_OK;
+}
+
+esp_err_t fpr_link_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Direct Link Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Link-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint8_t host[6], lwk[FPR_KEY_SIZE];
+    ret = fpr_network_start();
+    if (ret == ESP_OK) {
+        fpr_network_set_mode(FPR_MODE_CLIENT);
+        ret = add_keyed_peer(0xE0, host, lwk);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    const uint8_t linked[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0xE1 };
+    const uint8_t forged[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0xE2 };
+    fpr_link_stats_t stats;
+    fpr_link_info_t info;
+    int value = 0;
+
+    // [TEST 1] An introduction under our session key installs the link
+    fpr_test_sent_reset();
+    introduce(host, lwk, linked, false);
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(linked);
+    passed &= fpr_test_check(TAG, "Linked client is added as a connected peer",
+                             peer != NULL && peer->is_link && peer->is_connected);
+    passed &= fpr_test_check(TAG, "Hello goes straight to the linked client",
+                             last_sent(FPR_PACKET_ID_LINK, linked) != NULL &&
+                             memcmp(last_sent(FPR_PACKET_ID_LINK, linked)->dest, linked, 6) == 0);
+
+    // [TEST 2] An introduction that fails the key check is refused
+    introduce(host, lwk, forged, true);
+    fpr_link_get_stats(&stats);
+    passed &= fpr_test_check(TAG, "Forged introduction is refused",
+                             _get_peer_from_map(forged) == NULL && stats.rejected == 1 && stats.links == 1);
+
+    // [TEST 3] Until a hello is heard directly, sends go through the host
+    fpr_test_sent_reset();
+    value = 1;
+    fpr_network_send_to_peer((uint8_t *)linked, &value, sizeof(value), TEST_DATA_ID);
+    const fpr_test_sent_t *sent = last_sent(TEST_DATA_ID, linked);
+    passed &= fpr_test_check(TAG, "Unproven link is relayed by the host", sent != NULL && memcmp(sent->dest, host, 6) == 0);
+
+    // [TEST 4] Once heard directly, sends go straight to the linked client
+    receive_from(linked, linked, fpr_net.mac, FPR_PACKET_ID_LINK, 0);
+    fpr_test_sent_reset();
+    value = 2;
+    fpr_network_send_to_peer((uint8_t *)linked, &value, sizeof(value), TEST_DATA_ID);
+    sent = last_sent(TEST_DATA_ID, linked);
+    passed &= fpr_test_check(TAG, "Proven link is used directly", sent != NULL && memcmp(sent->dest, linked, 6) == 0);
+
+    // [TEST 5] Frames arrive from the linked client either way
+    int received = 0;
+    receive_from(linked, linked, fpr_net.mac, TEST_DATA_ID, 10);
+    receive_from(host, linked, fpr_net.mac, TEST_DATA_ID, 11);
+    bool first = fpr_network_get_data_from_peer((uint8_t *)linked, &received, sizeof(received), pdMS_TO_TICKS(100)) &&
+                 received == 10;
+    bool second = fpr_network_get_data_from_peer((uint8_t *)linked, &received, sizeof(received), pdMS_TO_TICKS(100)) &&
+                  received == 11;
+    passed &= fpr_test_check(TAG, "Direct and relayed frames are delivered from the linked client", first && second);
+
+    // [TEST 6] Failed direct sends move traffic back to the host
+    for (int i = 0; i < FPR_LINK_MAX_TX_FAILURES; i++) {
+        fpr_test_send_done(linked, false);
+    }
+    fpr_test_sent_reset();
+    value = 3;
+    fpr_network_send_to_peer((uint8_t *)linked, &value, sizeof(value), TEST_DATA_ID);
+    sent = last_sent(TEST_DATA_ID, linked);
+    passed &= fpr_test_check(TAG, "Degraded link falls back to the host", sent != NULL && memcmp(sent->dest, host, 6) == 0);
+
+    fpr_link_get_stats(&stats);
+    ret = fpr_link_get_info(linked, &info);
+    passed &= fpr_test_check(TAG, "Direct and relayed traffic are counted",
+                             stats.direct_tx == 1 && stats.relayed_tx == 2 && stats.direct_rx == 1 && stats.relayed_rx == 1);
+    passed &= fpr_test_check(TAG, "Per-link counters match",
+                             ret == ESP_OK && !info.direct && info.direct_tx == 1 && info.relayed_tx == 2 &&
+                             info.tx_failures == FPR_LINK_MAX_TX_FAILURES);
+
+    // [TEST 7] Closing the link releases the peer
+    ret = fpr_link_close(linked);
+    fpr_link_get_stats(&stats);
+    passed &= fpr_test_check(TAG, "Closed link is released",
+                             ret == ESP_OK && stats.links == 0 && !_get_peer_from_map(linked)->is_connected);
+
+    // [TEST 8] A host introduces two connected clients to each other
+    fpr_network_set_mode(FPR_MODE_HOST);
+    uint8_t client_a[6], client_b[6];
+    ret = add_keyed_peer(0xE3, client_a, NULL);
+    if (ret == ESP_OK) {
+        ret = add_keyed_peer(0xE4, client_b, NULL);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Adding clients failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+    fpr_link_stats_t before;
+    fpr_link_get_stats(&before);
+
+    fpr_test_sent_reset();
+    fpr_package_t request = {0};
+    fpr_link_frame_t *req = (fpr_link_frame_t *)&request.protocol;
+    req->kind = FPR_LINK_KIND_REQUEST;
+    memcpy(req->peer, client_b, 6);
+    request.id = FPR_PACKET_ID_LINK;
+    request.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    request.payload_size = sizeof(*req);
+    memcpy(request.origin_mac, client_a, 6);
+    memcpy(request.dest_mac, fpr_net.mac, 6);
+    fpr_test_receive(client_a, fpr_net.mac, &request);
+    const fpr_test_sent_t *to_a = last_sent(FPR_PACKET_ID_LINK, client_a);
+    const fpr_test_sent_t *to_b = last_sent(FPR_PACKET_ID_LINK, client_b);
+    const fpr_link_frame_t *intro_a = to_a != NULL ? (const fpr_link_frame_t *)&to_a->package.protocol : NULL;
+    const fpr_link_frame_t *intro_b = to_b != NULL ? (const fpr_link_frame_t *)&to_b->package.protocol : NULL;
+    passed &= fpr_test_check(TAG, "Each client is told about the other",
+                             intro_a != NULL && intro_a->kind == FPR_LINK_KIND_INTRO && memcmp(intro_a->peer, client_b, 6) == 0 &&
+                             intro_b != NULL && intro_b->kind == FPR_LINK_KIND_INTRO && memcmp(intro_b->peer, client_a, 6) == 0);
+
+    // [TEST 9] A host passes client-to-client frames on
+    fpr_test_sent_reset();
+    receive_from(client_a, client_a, client_b, TEST_DATA_ID, 20);
+    sent = last_sent(TEST_DATA_ID, client_b);
+    passed &= fpr_test_check(TAG, "Frame for another client is relayed",
+                             sent != NULL && memcmp(sent->dest, client_b, 6) == 0 && sent->package.hop_count == 1);
+
+    fpr_link_get_stats(&stats);
+    passed &= fpr_test_check(TAG, "Host counts the introduction and the relay",
+                             stats.introductions == before.introductions + 1 && stats.relayed == before.relayed + 1);
+
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,32 @@
+/**
+ * @file test_fpr_link.h
+ * @brief FPR Direct Client Link Test API
+ *
+ * Single-device check of host-introduced client links: the introduction on
+ * both sides, the direct and relayed paths and the fallback between them.
+ */
+
+#ifndef TEST_FPR_LINK_H
+#define TEST_FPR_LINK_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the direct client link test
+ *
+ * Initializes WiFi and FPR as a client with an injected host that
+ * introduces an injected client, then as a host with two injected clients.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_link_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_LINK_H
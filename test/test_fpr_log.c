@@ -0,0 +1,156 @@
+/**
+ * @file test_fpr_log.c
+ * @brief FPR Rate-Limited Logging Test Implementation
+ *
+ * Token buckets are driven directly on sites owned by the test, with their
+ * refill time shifted instead of waited for. Emitted lines and summaries
+ * are caught with a log output hook that still passes them to the console.
+ */
+
+#include "test_fpr_log.h"
+#include "test_fpr_common.h"
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/log.h"
+
+static const char *TAG = "FPR_LOG_TEST";
+
+#define TEST_TOKEN_US (1000000 / FPR_LOG_RATE_PER_SEC)
+#define TEST_SUPPRESSED 3
+#define TEST_OUTPUT_WAIT_MS 500
+#define TEST_CAPTURE_SIZE 2048
+
+static char s_capture[TEST_CAPTURE_SIZE];
+static size_t s_capture_len;
+static portMUX_TYPE s_capture_lock = portMUX_INITIALIZER_UNLOCKED;
+static vprintf_like_t s_prev_vprintf;
+
+static int capture_vprintf(const char *fmt, va_list args)
+{
+    char line[192];
+    va_list copy;
+    va_copy(copy, args);
+    int n = vsnprintf(line, sizeof(line), fmt, copy);
+    va_end(copy);
+    if (n > 0) {
+        size_t len = (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1;
+        taskENTER_CRITICAL(&s_capture_lock);
+        if (s_capture_len + len < TEST_CAPTURE_SIZE) {
+            memcpy(&s_capture[s_capture_len], line, len);
+            s_capture_len += len;
+            s_capture[s_capture_len] = '\0';
+        }
+        taskEXIT_CRITICAL(&s_capture_lock);
+    }
+    return s_prev_vprintf(fmt, args);
+}
+
+static void capture_reset(void)
+{
+    taskENTER_CRITICAL(&s_capture_lock);
+    s_capture_len = 0;
+    s_capture[0] = '\0';
+    taskEXIT_CRITICAL(&s_capture_lock);
+}
+
+// Deferred lines are printed by the log task, so poll for a while
+static bool capture_wait_for(const char *text, uint32_t timeout_ms)
+{
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(timeout_ms);
+    do {
+        taskENTER_CRITICAL(&s_capture_lock);
+        bool found = strstr(s_capture, text) != NULL;
+        taskEXIT_CRITICAL(&s_capture_lock);
+        if (found) {
+            return true;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    } while ((int32_t)(deadline - xTaskGetTickCount()) > 0);
+    return false;
+}
+
+// No time passes between back-to-back calls, so nothing refills
+static bool admit_now(fpr_log_site_t *site, uint32_t *suppressed)
+{
+    if (site->last_us != 0) {
+        site->last_us = esp_timer_get_time();
+    }
+    return _fpr_log_admit(site, TAG, suppressed);
+}
+
+// Sites stay linked into the summary list once they suppress, so they must
+// outlive the test
+static fpr_log_site_t s_burst_site = { .file = __FILE__, .line = __LINE__ };
+static fpr_log_site_t s_summary_site = { .file = __FILE__, .line = __LINE__ };
+
+esp_err_t fpr_log_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Rate-Limited Logging Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Log-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    bool passed = true;
+    uint32_t suppressed = 0;
+
+    // [TEST 1] A quiet site prints a full burst, then suppresses
+    int admitted = 0;
+    for (int i = 0; i < FPR_LOG_BURST; i++) {
+        admitted += admit_now(&s_burst_site, &suppressed) ? 1 : 0;
+    }
+    passed &= fpr_test_check(TAG, "Quiet site admits a full burst", admitted == FPR_LOG_BURST && suppressed == 0);
+    bool over = false;
+    for (int i = 0; i < TEST_SUPPRESSED; i++) {
+        over |= admit_now(&s_burst_site, &suppressed);
+    }
+    passed &= fpr_test_check(TAG, "Messages over the burst are counted",
+                             !over && s_burst_site.suppressed == TEST_SUPPRESSED);
+
+    // [TEST 2] One token interval later the count comes with the next message
+    s_burst_site.last_us -= TEST_TOKEN_US;
+    bool admit = _fpr_log_admit(&s_burst_site, TAG, &suppressed);
+    passed &= fpr_test_check(TAG, "Refilled token reports the suppressed count",
+                             admit && suppressed == TEST_SUPPRESSED && s_burst_site.suppressed == 0);
+
+    // [TEST 3] A long quiet spell refills no more than one burst
+    s_burst_site.last_us -= 3600LL * 1000000;
+    admitted = _fpr_log_admit(&s_burst_site, TAG, &suppressed) ? 1 : 0;
+    for (int i = 1; i < FPR_LOG_BURST + TEST_SUPPRESSED; i++) {
+        admitted += admit_now(&s_burst_site, &suppressed) ? 1 : 0;
+    }
+    passed &= fpr_test_check(TAG, "Refill is capped at the burst", admitted == FPR_LOG_BURST);
+
+    // [TEST 4] Admitted messages are printed, with the suppressed count
+    s_prev_vprintf = esp_log_set_vprintf(capture_vprintf);
+    capture_reset();
+    FPR_LOG_RL(ESP_LOG_WARN, TAG, "rl-test %d", 42);
+    passed &= fpr_test_check(TAG, "Site message is printed", capture_wait_for("rl-test 42", TEST_OUTPUT_WAIT_MS));
+    char expected[48];
+    snprintf(expected, sizeof(expected), "rl-test 43 (+%d suppressed)", TEST_SUPPRESSED);
+    _fpr_log_emit(&s_burst_site, ESP_LOG_WARN, TAG, TEST_SUPPRESSED, "rl-test %d", 1, 43);
+    passed &= fpr_test_check(TAG, "Suppressed count is appended", capture_wait_for(expected, TEST_OUTPUT_WAIT_MS));
+
+    #if (FPR_LOG_DEFERRED == 1)
+    // [TEST 5] A site that went quiet reports its count in the summary
+    capture_reset();
+    for (int i = 0; i <= FPR_LOG_BURST + TEST_SUPPRESSED; i++) {
+        admit_now(&s_summary_site, &suppressed);
+    }
+    snprintf(expected, sizeof(expected), ":%u: %d messages suppressed", (unsigned)s_summary_site.line,
+             TEST_SUPPRESSED + 1);
+    bool summarized = capture_wait_for(expected, FPR_LOG_SUMMARY_INTERVAL_MS + TEST_OUTPUT_WAIT_MS);
+    passed &= fpr_test_check(TAG, "Quiet site is summarized", summarized && s_summary_site.suppressed == 0);
+    #endif
+    esp_log_set_vprintf(s_prev_vprintf);
+
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,32 @@
+/**
+ * @file test_fpr_log.h
+ * @brief FPR Rate-Limited Logging Test API
+ *
+ * Single-device check of the data path log sites: bursts, suppressed
+ * counts, refill, printed lines and the periodic summary.
+ */
+
+#ifndef TEST_FPR_LOG_H
+#define TEST_FPR_LOG_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the rate-limited logging test
+ *
+ * Initializes WiFi and FPR, which starts the deferred log task. With
+ * CONFIG_FPR_LOG_DEFERRED the test waits one summary interval.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_log_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_LOG_H
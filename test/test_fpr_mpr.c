@@ -0,0 +1,187 @@
+/**
+ * @file test_fpr_mpr.c
+ * @brief FPR Broadcast Relay Test Implementation
+ *
+ * Hellos from two neighbors that do not exist are injected: one picked this
+ * device as its relay, the other did not. Broadcasts from each, from an
+ * unknown sender and a repeated one are then injected, and the rebroadcasts
+ * are read from the send log. This device's own hello shows the relays it
+ * picked.
+ */
+
+#include "test_fpr_mpr.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_extender.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/scheduler.h"
+
+static const char *TAG = "FPR_MPR_TEST";
+
+#define TEST_DATA_ID 1
+#define TEST_SLACK_MS 200
+
+static const uint8_t s_selector[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x90 };
+static const uint8_t s_other[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x91 };
+static const uint8_t s_unknown[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x92 };
+static const uint8_t s_far_x[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x9A };
+static const uint8_t s_far_y[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x9B };
+static const uint8_t s_broadcast[6] = FPR_BROADCAST_ADDRESS;
+
+// Hello from a neighbor that hears us and the given two-hop nodes
+static void hello(const uint8_t *from, bool picked_us, const uint8_t *const *two_hop, int two_hop_count)
+{
+    fpr_package_t package = {0};
+    fpr_mpr_hello_t *frame = (fpr_mpr_hello_t *)&package.protocol;
+    memcpy(frame->neighbors[frame->count], fpr_net.mac, 6);
+    if (picked_us) {
+        frame->relay_bits[0] |= 1;
+    }
+    frame->count++;
+    for (int i = 0; i < two_hop_count; i++) {
+        memcpy(frame->neighbors[frame->count++], two_hop[i], 6);
+    }
+    package.id = FPR_PACKET_ID_MPR;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(*frame);
+    memcpy(package.origin_mac, from, 6);
+    memcpy(package.dest_mac, s_broadcast, 6);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_receive(from, s_broadcast, &package);
+}
+
+// Broadcast from origin, heard from sender
+static void broadcast(const uint8_t *sender, const uint8_t *origin, uint32_t seq)
+{
+    fpr_package_t package = {0};
+    package.protocol.data_int[0] = (int)seq;
+    package.id = TEST_DATA_ID;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(int);
+    package.sequence_num = seq;
+    memcpy(package.origin_mac, origin, 6);
+    memcpy(package.dest_mac, s_broadcast, 6);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_receive(sender, s_broadcast, &package);
+}
+
+static size_t count_rebroadcasts(const fpr_test_sent_t **last_out)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        if (sent->package.id == TEST_DATA_ID && memcmp(sent->dest, s_broadcast, 6) == 0) {
+            count++;
+            if (last_out != NULL) {
+                *last_out = sent;
+            }
+        }
+    }
+    return count;
+}
+
+// Last hello this device sent
+static const fpr_mpr_hello_t *own_hello(void)
+{
+    const fpr_mpr_hello_t *found = NULL;
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        if (sent->package.id == FPR_PACKET_ID_MPR) {
+            found = (const fpr_mpr_hello_t *)&sent->package.protocol;
+        }
+    }
+    return found;
+}
+
+static bool hello_picks(const fpr_mpr_hello_t *frame, const uint8_t *mac)
+{
+    for (int i = 0; i < frame->count; i++) {
+        if (memcmp(frame->neighbors[i], mac, 6) == 0) {
+            return (frame->relay_bits[i / 8] >> (i % 8)) & 1;
+        }
+    }
+    return false;
+}
+
+esp_err_t fpr_mpr_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Broadcast Relay Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-MPR-Test");
+    if (ret == ESP_OK) {
+        ret = fpr_network_start();
+    }
+    if (ret == ESP_OK) {
+        fpr_network_set_mode(FPR_MODE_EXTENDER);
+        ret = fpr_extender_set_mpr(true);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+    fpr_net.routing_enabled = true;
+
+    bool passed = true;
+    fpr_extender_broadcast_stats_t stats;
+    const uint8_t *selector_reach[] = { s_far_x, s_far_y };
+    const uint8_t *other_reach[] = { s_far_y };
+    hello(s_selector, true, selector_reach, 2);
+    hello(s_other, false, other_reach, 1);
+
+    // [TEST 1] A broadcast from a neighbor that picked us is sent on unchanged
+    fpr_test_sent_reset();
+    broadcast(s_selector, s_selector, 100);
+    const fpr_test_sent_t *sent = NULL;
+    passed &= fpr_test_check(TAG, "Selector's broadcast is rebroadcast", count_rebroadcasts(&sent) == 1);
+    passed &= fpr_test_check(TAG, "Origin and sequence are kept",
+                             sent != NULL && memcmp(sent->package.origin_mac, s_selector, 6) == 0 &&
+                             sent->package.sequence_num == 100 && sent->package.hop_count == 1);
+
+    // [TEST 2] A copy of the same broadcast is dropped
+    broadcast(s_other, s_selector, 100);
+    passed &= fpr_test_check(TAG, "Duplicate is not rebroadcast", count_rebroadcasts(NULL) == 1);
+
+    // [TEST 3] A neighbor that did not pick us gets no rebroadcast
+    broadcast(s_other, s_other, 101);
+    passed &= fpr_test_check(TAG, "Non-selector's broadcast is suppressed", count_rebroadcasts(NULL) == 1);
+
+    // [TEST 4] A sender without a hello yet is flooded
+    broadcast(s_unknown, s_unknown, 102);
+    passed &= fpr_test_check(TAG, "Unknown sender is flooded", count_rebroadcasts(NULL) == 2);
+
+    fpr_extender_get_broadcast_stats(&stats);
+    passed &= fpr_test_check(TAG, "Broadcast counters match",
+                             stats.received == 3 && stats.duplicates == 1 && stats.rebroadcast == 2 && stats.suppressed == 1);
+
+    // [TEST 5] With relays off every broadcast is flooded
+    fpr_extender_set_mpr(false);
+    broadcast(s_other, s_other, 103);
+    fpr_extender_set_mpr(true);
+    passed &= fpr_test_check(TAG, "Flooding rebroadcasts the non-selector", count_rebroadcasts(NULL) == 3);
+
+    // [TEST 6] The relay set covers every two-hop node with as few neighbors as possible
+    fpr_test_sent_reset();
+    hello(s_selector, true, selector_reach, 2);
+    hello(s_other, false, other_reach, 1);
+    vTaskDelay(pdMS_TO_TICKS(FPR_MPR_HELLO_INTERVAL_MS + TEST_SLACK_MS));
+    const fpr_mpr_hello_t *ours = own_hello();
+    fpr_extender_get_broadcast_stats(&stats);
+    passed &= fpr_test_check(TAG, "Hello lists both neighbors", ours != NULL && ours->count == 2);
+    passed &= fpr_test_check(TAG, "Only the neighbor covering both two-hop nodes is picked",
+                             ours != NULL && hello_picks(ours, s_selector) && !hello_picks(ours, s_other));
+    passed &= fpr_test_check(TAG, "Neighborhood is counted",
+                             stats.symmetric == 2 && stats.two_hop == 2 && stats.relays == 1 && stats.selectors == 1);
+
+    // [TEST 7] Hellos only run in extender mode
+    bool armed = _fpr_sched_is_armed(FPR_JOB_MPR);
+    fpr_network_set_mode(FPR_MODE_CLIENT);
+    passed &= fpr_test_check(TAG, "Hello job runs only in extender mode", armed && !_fpr_sched_is_armed(FPR_JOB_MPR));
+
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,33 @@
+/**
+ * @file test_fpr_mpr.h
+ * @brief FPR Broadcast Relay Test API
+ *
+ * Single-device check of extender broadcast relaying through multipoint
+ * relays: relay selection from neighbor hellos, suppression and duplicates.
+ */
+
+#ifndef TEST_FPR_MPR_H
+#define TEST_FPR_MPR_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the broadcast relay test
+ *
+ * Initializes WiFi and FPR as an extender that hears injected neighbor
+ * hellos and broadcasts. Waits one hello period
+ * (CONFIG_FPR_MPR_HELLO_INTERVAL_MS).
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_mpr_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_MPR_H
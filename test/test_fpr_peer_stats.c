@@ -0,0 +1,145 @@
+/**
+ * @file test_fpr_peer_stats.c
+ * @brief FPR Per-Peer Statistics Test Implementation
+ *
+ * Frames from a client that does not exist enter through the transport
+ * receive path, so the per-link frame counter is checked like on air. The
+ * link counter of sent frames is read from the send log and their results
+ * are reported by hand.
+ */
+
+#include "test_fpr_peer_stats.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_PEER_STATS_TEST";
+
+#define TEST_DATA_ID 1
+#define TEST_LOST 3
+
+static uint32_t s_seq = 1000;
+
+static void receive(const uint8_t *client, uint16_t link_seq, uint32_t seq)
+{
+    fpr_package_t package = {0};
+    package.protocol.data_int[0] = (int)link_seq;
+    package.id = TEST_DATA_ID;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(int);
+    package.sequence_num = seq;
+    package.link_seq = link_seq;
+    memcpy(package.origin_mac, client, 6);
+    memcpy(package.dest_mac, fpr_net.mac, 6);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_transport_receive(client, fpr_net.mac, &package);
+}
+
+static uint32_t hist_total(const uint32_t *hist)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < FPR_PEER_HIST_BUCKETS; i++) {
+        total += hist[i];
+    }
+    return total;
+}
+
+static void drain(uint8_t *client)
+{
+    fpr_package_t package;
+    while (fpr_network_get_data_from_peer(client, &package.protocol, sizeof(package.protocol), 0)) {
+    }
+}
+
+esp_err_t fpr_peer_stats_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Per-Peer Statistics Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-PeerStats-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint8_t client[6];
+    ret = fpr_network_start();
+    if (ret == ESP_OK) {
+        fpr_network_set_mode(FPR_MODE_HOST);
+        ret = fpr_test_add_fake_peer(0xF0, client);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    fpr_peer_stats_t stats;
+    uint16_t link_seq = 0;
+
+    // [TEST 1] A jump in the link frame counter is counted as loss
+    receive(client, ++link_seq, s_seq++);
+    receive(client, ++link_seq, s_seq++);
+    link_seq += TEST_LOST;
+    receive(client, ++link_seq, s_seq++);
+    fpr_network_get_peer_stats(client, &stats);
+    passed &= fpr_test_check(TAG, "Received frames are counted", stats.packets_received == 3);
+    passed &= fpr_test_check(TAG, "Gap is counted with its length",
+                             stats.seq_gaps == 1 && stats.seq_lost == TEST_LOST && stats.gap_hist[1] == 1);
+    passed &= fpr_test_check(TAG, "Inter-arrival times are recorded", hist_total(stats.interarrival_hist) == 2);
+
+    // [TEST 2] An old sequence number is rejected and counted
+    receive(client, ++link_seq, s_seq - 2);
+    fpr_network_get_peer_stats(client, &stats);
+    passed &= fpr_test_check(TAG, "Replay is counted", stats.replay_rejects == 1 && stats.packets_received == 3);
+    passed &= fpr_test_check(TAG, "Replay does not look like loss", stats.seq_gaps == 1);
+
+    // [TEST 3] Queue depth is tracked until the queue overflows
+    drain(client);
+    for (int i = 0; i <= FPR_QUEUE_LENGTH; i++) {
+        receive(client, ++link_seq, s_seq++);
+    }
+    fpr_network_get_peer_stats(client, &stats);
+    passed &= fpr_test_check(TAG, "Overflow is counted", stats.queue_full_drops == 1);
+    passed &= fpr_test_check(TAG, "High-water mark is the queue length", stats.queue_high_water == FPR_QUEUE_LENGTH);
+    passed &= fpr_test_check(TAG, "Every enqueue lands in the depth histogram",
+                             hist_total(stats.queue_depth_hist) == 3 + FPR_QUEUE_LENGTH);
+    drain(client);
+
+    // [TEST 4] Sent frames are numbered per link and their results counted
+    fpr_test_sent_reset();
+    int value = 1;
+    fpr_network_send_to_peer(client, &value, sizeof(value), TEST_DATA_ID);
+    fpr_test_send_done(client, true);
+    fpr_network_send_to_peer(client, &value, sizeof(value), TEST_DATA_ID);
+    fpr_test_send_done(client, false);
+    const fpr_test_sent_t *first = NULL, *second = NULL;
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        if (sent->package.id == TEST_DATA_ID && memcmp(sent->dest, client, 6) == 0) {
+            first = first == NULL ? sent : first;
+            second = sent != first ? sent : second;
+        }
+    }
+    passed &= fpr_test_check(TAG, "Sent frames carry consecutive link numbers",
+                             first != NULL && second != NULL && first->package.link_seq != 0 &&
+                             (uint16_t)(second->package.link_seq - first->package.link_seq) == 1);
+    fpr_network_get_peer_stats(client, &stats);
+    passed &= fpr_test_check(TAG, "Ack and failure are counted", stats.packets_acked == 1 && stats.send_failures == 1);
+    passed &= fpr_test_check(TAG, "Round trip is recorded", hist_total(stats.rtt_hist) == 1);
+
+    // [TEST 5] Reset clears everything, and the next frame starts a fresh sequence
+    ret = fpr_network_reset_peer_stats(client);
+    receive(client, link_seq + 10, s_seq++);
+    fpr_network_get_peer_stats(client, &stats);
+    passed &= fpr_test_check(TAG, "Reset clears the counters",
+                             ret == ESP_OK && stats.packets_received == 1 && stats.seq_gaps == 0 && stats.replay_rejects == 0 &&
+                             stats.queue_full_drops == 0 && stats.packets_acked == 0 && hist_total(stats.rtt_hist) == 0);
+    const uint8_t unknown[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0xF1 };
+    passed &= fpr_test_check(TAG, "Unknown peer is not found",
+                             fpr_network_get_peer_stats(unknown, &stats) == ESP_ERR_NOT_FOUND);
+
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,32 @@
+/**
+ * @file test_fpr_peer_stats.h
+ * @brief FPR Per-Peer Statistics Test API
+ *
+ * Single-device check of the per-peer counters and histograms: link loss,
+ * replays, queue depth and overflow, acknowledgements and reset.
+ */
+
+#ifndef TEST_FPR_PEER_STATS_H
+#define TEST_FPR_PEER_STATS_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the per-peer statistics test
+ *
+ * Initializes WiFi and FPR as a host with one injected client whose frames
+ * and send results are injected.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_peer_stats_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_PEER_STATS_H
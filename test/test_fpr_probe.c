@@ -0,0 +1,132 @@
+/**
+ * @file test_fpr_probe.c
+ * @brief FPR Probe Discovery Test Implementation
+ *
+ * Probe responses from two hosts that do not exist are injected by a
+ * helper task while the client waits in fpr_client_probe_for_hosts().
+ * Requests and responses this device sends are read from the send log.
+ */
+
+#include "test_fpr_probe.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/private_defs.h"
+
+static const char *TAG = "FPR_PROBE_TEST";
+
+#define TEST_NAME           "FPR-Probe-Test"
+#define TEST_ANSWER_DELAY_MS 30
+#define TEST_PROBE_TIMEOUT_MS 1000
+#define TEST_SILENT_TIMEOUT_MS 100
+
+static const uint8_t s_host_a[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x80 };
+static const uint8_t s_host_b[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x81 };
+static const uint8_t s_broadcast[6] = FPR_BROADCAST_ADDRESS;
+
+static void receive_probe(const uint8_t *src, fpr_probe_kind_t kind, const char *name)
+{
+    fpr_package_t package = {0};
+    fpr_probe_frame_t *probe = (fpr_probe_frame_t *)&package.protocol;
+    probe->kind = kind;
+    if (name != NULL) {
+        strlcpy(probe->info.name, name, sizeof(probe->info.name));
+    }
+    package.id = FPR_PACKET_ID_PROBE;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(*probe);
+    memcpy(package.origin_mac, src, 6);
+    memcpy(package.dest_mac, s_broadcast, 6);
+    fpr_test_receive(src, s_broadcast, &package);
+}
+
+// Both hosts answer while the client waits
+static void answer_task(void *arg)
+{
+    vTaskDelay(pdMS_TO_TICKS(TEST_ANSWER_DELAY_MS));
+    receive_probe(s_host_a, FPR_PROBE_KIND_RESPONSE, "Host-A");
+    receive_probe(s_host_a, FPR_PROBE_KIND_RESPONSE, "Host-A");
+    receive_probe(s_host_b, FPR_PROBE_KIND_RESPONSE, "Host-B");
+    xTaskNotifyGive((TaskHandle_t)arg);
+    vTaskDelete(NULL);
+}
+
+static size_t count_sent_probes(fpr_probe_kind_t kind)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        const fpr_probe_frame_t *probe = (const fpr_probe_frame_t *)&sent->package.protocol;
+        if (sent->package.id == FPR_PACKET_ID_PROBE && probe->kind == kind &&
+            memcmp(sent->dest, s_broadcast, 6) == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+esp_err_t fpr_probe_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Probe Discovery Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up(TEST_NAME);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = fpr_network_start();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Start failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+
+    // [TEST 1] The probe returns once two distinct hosts answered, long before the deadline
+    fpr_test_sent_reset();
+    if (xTaskCreate(answer_task, "probe_answer", 4096, xTaskGetCurrentTaskHandle(), 5, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create answer task");
+        return fpr_test_finish(TAG, false);
+    }
+    TickType_t start = xTaskGetTickCount();
+    size_t found = fpr_client_probe_for_hosts(2, pdMS_TO_TICKS(TEST_PROBE_TIMEOUT_MS));
+    uint32_t elapsed_ms = pdTICKS_TO_MS(xTaskGetTickCount() - start);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    ESP_LOGI(TAG, "Probe found %zu host(s) in %lu ms", found, (unsigned long)elapsed_ms);
+    passed &= fpr_test_check(TAG, "Probe request is broadcast", count_sent_probes(FPR_PROBE_KIND_REQUEST) >= 1);
+    passed &= fpr_test_check(TAG, "Duplicate answers count once", found == 2);
+    passed &= fpr_test_check(TAG, "Probe returns early", elapsed_ms < TEST_PROBE_TIMEOUT_MS / 2);
+
+    // [TEST 2] Without answers the probe retries until its deadline
+    fpr_test_sent_reset();
+    start = xTaskGetTickCount();
+    found = fpr_client_probe_for_hosts(1, pdMS_TO_TICKS(TEST_SILENT_TIMEOUT_MS));
+    elapsed_ms = pdTICKS_TO_MS(xTaskGetTickCount() - start);
+    passed &= fpr_test_check(TAG, "Silent probe finds nothing", found == 0);
+    passed &= fpr_test_check(TAG, "Silent probe waits out its deadline", elapsed_ms >= TEST_SILENT_TIMEOUT_MS);
+    passed &= fpr_test_check(TAG, "Lost requests are retried",
+                             TEST_SILENT_TIMEOUT_MS <= FPR_PROBE_RETRY_INTERVAL_MS || count_sent_probes(FPR_PROBE_KIND_REQUEST) >= 2);
+
+    // [TEST 3] A host answers a burst of probes with one jittered broadcast
+    fpr_network_set_mode(FPR_MODE_HOST);
+    fpr_test_sent_reset();
+    receive_probe(s_host_a, FPR_PROBE_KIND_REQUEST, NULL);
+    receive_probe(s_host_b, FPR_PROBE_KIND_REQUEST, NULL);
+    vTaskDelay(pdMS_TO_TICKS(FPR_PROBE_RESPONSE_JITTER_MS + 20));
+    passed &= fpr_test_check(TAG, "Burst of probes gets one response", count_sent_probes(FPR_PROBE_KIND_RESPONSE) == 1);
+    bool named = false;
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        const fpr_probe_frame_t *probe = (const fpr_probe_frame_t *)&sent->package.protocol;
+        if (sent->package.id == FPR_PACKET_ID_PROBE && probe->kind == FPR_PROBE_KIND_RESPONSE) {
+            named = strcmp(probe->info.name, TEST_NAME) == 0;
+        }
+    }
+    passed &= fpr_test_check(TAG, "Response announces this host", named);
+
+    return fpr_test_finish(TAG, passed);
+}
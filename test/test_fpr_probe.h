@@ -0,0 +1,32 @@
+/**
+ * @file test_fpr_probe.h
+ * @brief FPR Probe Discovery Test API
+ *
+ * Single-device check of active host discovery: the client's probe
+ * requests and early return, and the host's coalesced probe response.
+ */
+
+#ifndef TEST_FPR_PROBE_H
+#define TEST_FPR_PROBE_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the probe discovery test
+ *
+ * Initializes WiFi and FPR, probes as a client while injected hosts answer,
+ * then answers injected probes as a host.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_probe_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_PROBE_H
@@ -0,0 +1,125 @@
+/**
+ * @file test_fpr_pubsub.c
+ * @brief FPR Publish/Subscribe Test Implementation
+ *
+ * Subscriptions arrive as injected frames from a peer that exists only in
+ * the local peer table. Sends to it succeed locally, so the host's
+ * delivered and retained_sent counters show what was fanned out.
+ */
+
+#include "test_fpr_pubsub.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_pubsub.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_PUBSUB_TEST";
+
+#define TEST_TOPIC          0x0101
+#define TEST_VALUE          0x11223344u
+
+static uint8_t peer_mac[6];
+
+static void inject_subscribe(fpr_topic_t topic)
+{
+    fpr_package_t package = {0};
+    fpr_pubsub_frame_t *frame = (fpr_pubsub_frame_t *)&package.protocol;
+    frame->kind = FPR_PUBSUB_KIND_SUBSCRIBE;
+    frame->topic = topic;
+    package.id = FPR_PACKET_ID_PUBSUB;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = FPR_PUBSUB_FRAME_HEADER_SIZE;
+    fpr_test_inject(peer_mac, &package);
+}
+
+static void inject_fragment_start(void)
+{
+    fpr_package_t package = {0};
+    package.id = 1;
+    package.package_type = FPR_PACKAGE_TYPE_START;
+    package.payload_size = FPR_PROTOCOL_SIZE;
+    fpr_test_inject(peer_mac, &package);
+}
+
+static uint32_t deliveries_after_publish(void)
+{
+    fpr_pubsub_stats_t before, after;
+    uint32_t value = TEST_VALUE;
+    fpr_pubsub_get_stats(&before);
+    fpr_pubsub_publish(TEST_TOPIC, &value, sizeof(value), false);
+    fpr_pubsub_get_stats(&after);
+    return after.delivered - before.delivered;
+}
+
+static bool no_slot_in_use(void)
+{
+    for (int i = 0; i < FPR_MAX_PEER_SLOTS; i++) {
+        if (fpr_net.peer_slots[i] != NULL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t fpr_pubsub_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Pub/Sub Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-PubSub-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    fpr_network_set_mode(FPR_MODE_HOST);
+    ret = fpr_test_add_fake_peer(0x20, peer_mac);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Adding peer failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    fpr_pubsub_stats_t before, after;
+
+    // [TEST 1] A retained publication is kept at the host
+    uint32_t value = TEST_VALUE;
+    passed &= fpr_test_check(TAG, "Retained publish succeeds",
+                             fpr_pubsub_publish(TEST_TOPIC, &value, sizeof(value), true) == ESP_OK);
+    uint32_t readback = 0;
+    size_t len = sizeof(readback);
+    passed &= fpr_test_check(TAG, "Retained value reads back",
+                             fpr_pubsub_get_retained(TEST_TOPIC, &readback, &len) == ESP_OK &&
+                             len == sizeof(readback) && readback == TEST_VALUE);
+
+    // [TEST 2] A new subscriber gets the retained value right away
+    fpr_pubsub_get_stats(&before);
+    inject_subscribe(TEST_TOPIC);
+    fpr_pubsub_get_stats(&after);
+    passed &= fpr_test_check(TAG, "Subscribe is accepted", after.subscribes == before.subscribes + 1);
+    passed &= fpr_test_check(TAG, "Retained value is replayed on subscribe",
+                             after.retained_sent == before.retained_sent + 1);
+
+    // [TEST 3] Later publications reach the subscriber
+    passed &= fpr_test_check(TAG, "Publication is delivered to the subscriber", deliveries_after_publish() == 1);
+
+    // [TEST 4] A fragment dropped in latest-only mode keeps the peer's slot
+    FPR_STORE_HASH_TYPE *peer = _get_peer_from_map(peer_mac);
+    uint8_t slot = peer->slot;
+    fpr_network_set_peer_queue_mode(peer_mac, FPR_QUEUE_MODE_LATEST_ONLY);
+    inject_fragment_start();
+    passed &= fpr_test_check(TAG, "Fragment drop keeps the slot",
+                             peer->slot == slot && fpr_net.peer_slots[slot] == peer);
+    passed &= fpr_test_check(TAG, "Subscription survives the fragment drop", deliveries_after_publish() == 1);
+
+    // [TEST 5] Clearing all peers releases their slots and subscriptions
+    fpr_clear_all_peers();
+    passed &= fpr_test_check(TAG, "No slot points at a cleared peer", no_slot_in_use());
+    ret = fpr_test_add_fake_peer(0x21, peer_mac);
+    peer = _get_peer_from_map(peer_mac);
+    passed &= fpr_test_check(TAG, "Next peer reuses the released slot", ret == ESP_OK && peer != NULL && peer->slot == slot);
+    passed &= fpr_test_check(TAG, "Next peer inherits no subscription", deliveries_after_publish() == 0);
+
+    return fpr_test_finish(TAG, passed);
+}
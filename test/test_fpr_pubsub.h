@@ -0,0 +1,34 @@
+/**
+ * @file test_fpr_pubsub.h
+ * @brief FPR Publish/Subscribe Test API
+ *
+ * Single-device check of the host side of pub/sub: retained replay,
+ * fan-out to subscribed slots, and slot cleanup.
+ */
+
+#ifndef TEST_FPR_PUBSUB_H
+#define TEST_FPR_PUBSUB_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the pub/sub test
+ *
+ * Initializes WiFi and FPR as a host, subscribes an injected peer to a
+ * retained topic and checks what the host sends it. Also checks that a
+ * dropped fragment keeps the peer's subscription and that clearing all
+ * peers leaves no slot behind.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_pubsub_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_PUBSUB_H
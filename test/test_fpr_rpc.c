@@ -0,0 +1,148 @@
+/**
+ * @file test_fpr_rpc.c
+ * @brief FPR Request/Response Test Implementation
+ *
+ * The peer exists only in the local peer table, so requests go out and are
+ * never answered. Responses are fed straight into the RPC receive hook.
+ */
+
+#include "test_fpr_rpc.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_rpc.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/services.h"
+
+static const char *TAG = "FPR_RPC_TEST";
+
+#define TEST_METHOD         7
+#define TEST_TIMEOUT_MS     100
+#define TEST_REPLY          0x5A5AA5A5u
+
+typedef struct {
+    SemaphoreHandle_t done;
+    int calls;
+    esp_err_t status;
+    uint32_t value;
+} async_result_t;
+
+static uint8_t peer_mac[6];
+
+static void async_cb(const uint8_t *mac, uint32_t call_id, esp_err_t status,
+                     const void *resp, size_t resp_len, void *user_data)
+{
+    (void)mac;
+    (void)call_id;
+    async_result_t *result = (async_result_t *)user_data;
+    result->calls++;
+    result->status = status;
+    if (status == ESP_OK && resp_len == sizeof(result->value)) {
+        memcpy(&result->value, resp, sizeof(result->value));
+    }
+    xSemaphoreGive(result->done);
+}
+
+static void inject_response(uint32_t call_id, uint32_t value)
+{
+    fpr_package_t package = {0};
+    fpr_rpc_frame_t *frame = (fpr_rpc_frame_t *)&package.protocol;
+    frame->kind = FPR_RPC_KIND_RESPONSE;
+    frame->method = TEST_METHOD;
+    frame->call_id = call_id;
+    frame->payload_len = sizeof(value);
+    memcpy(frame->payload, &value, sizeof(value));
+    package.id = FPR_PACKET_ID_RPC;
+    package.payload_size = FPR_RPC_FRAME_HEADER_SIZE + sizeof(value);
+    _fpr_rpc_handle_frame(_get_peer_from_map(peer_mac), &package);
+}
+
+static esp_err_t timer_call_status;
+static SemaphoreHandle_t timer_call_done;
+
+static void blocking_call_from_timer(void *arg)
+{
+    (void)arg;
+    timer_call_status = fpr_rpc_call(peer_mac, TEST_METHOD, NULL, 0, NULL, NULL, TEST_TIMEOUT_MS);
+    xSemaphoreGive(timer_call_done);
+}
+
+esp_err_t fpr_rpc_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR RPC Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-RPC-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    fpr_network_set_mode(FPR_MODE_HOST);
+    ret = fpr_test_add_fake_peer(0x10, peer_mac);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Adding peer failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    fpr_rpc_stats_t before, after;
+
+    // [TEST 1] An unanswered blocking call times out near its deadline
+    fpr_rpc_get_stats(&before);
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = fpr_rpc_call(peer_mac, TEST_METHOD, NULL, 0, NULL, NULL, TEST_TIMEOUT_MS);
+    int64_t elapsed_ms = (esp_timer_get_time() - start_us) / 1000;
+    fpr_rpc_get_stats(&after);
+    ESP_LOGI(TAG, "Timed out after %lld ms", (long long)elapsed_ms);
+    passed &= fpr_test_check(TAG, "Unanswered call returns ESP_ERR_TIMEOUT", err == ESP_ERR_TIMEOUT);
+    passed &= fpr_test_check(TAG, "Timeout fires within two wheel ticks of the deadline",
+                             elapsed_ms >= TEST_TIMEOUT_MS && elapsed_ms <= TEST_TIMEOUT_MS + 2 * FPR_RPC_WHEEL_TICK_MS + 10);
+    passed &= fpr_test_check(TAG, "Timeout is counted", after.timeouts == before.timeouts + 1);
+
+    // [TEST 2] A response completes the call it names, once
+    async_result_t result = { .done = xSemaphoreCreateBinary() };
+    uint32_t call_id = 0;
+    fpr_rpc_get_stats(&before);
+    err = fpr_rpc_call_async(peer_mac, TEST_METHOD, NULL, 0, 1000, async_cb, &result, &call_id);
+    passed &= fpr_test_check(TAG, "Async call starts", err == ESP_OK);
+    inject_response(call_id, TEST_REPLY);
+    bool completed = xSemaphoreTake(result.done, pdMS_TO_TICKS(100)) == pdTRUE;
+    passed &= fpr_test_check(TAG, "Matching response completes the call with its payload",
+                             completed && result.status == ESP_OK && result.value == TEST_REPLY);
+
+    // [TEST 3] A duplicate response is unmatched and does not complete it again
+    inject_response(call_id, TEST_REPLY);
+    vTaskDelay(pdMS_TO_TICKS(20));
+    fpr_rpc_get_stats(&after);
+    passed &= fpr_test_check(TAG, "Callback runs exactly once", result.calls == 1);
+    passed &= fpr_test_check(TAG, "Duplicate response is counted as unmatched",
+                             after.responses_received == before.responses_received + 1 &&
+                             after.unmatched_responses == before.unmatched_responses + 1);
+    passed &= fpr_test_check(TAG, "Nothing is left pending", after.pending == 0);
+    vSemaphoreDelete(result.done);
+
+    // [TEST 4] A blocking call from an esp_timer callback is refused, not stuck
+    timer_call_done = xSemaphoreCreateBinary();
+    timer_call_status = ESP_OK;
+    const esp_timer_create_args_t timer_args = {
+        .callback = blocking_call_from_timer,
+        .name = "rpc_test"
+    };
+    esp_timer_handle_t timer = NULL;
+    esp_timer_create(&timer_args, &timer);
+    esp_timer_start_once(timer, 1000);
+    bool returned = xSemaphoreTake(timer_call_done, pdMS_TO_TICKS(TEST_TIMEOUT_MS * 4)) == pdTRUE;
+    passed &= fpr_test_check(TAG, "Blocking call from esp_timer returns ESP_ERR_INVALID_STATE",
+                             returned && timer_call_status == ESP_ERR_INVALID_STATE);
+    if (returned) {
+        esp_timer_delete(timer);
+        vSemaphoreDelete(timer_call_done);
+    }
+
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,33 @@
+/**
+ * @file test_fpr_rpc.h
+ * @brief FPR Request/Response Test API
+ *
+ * Single-device check of the RPC layer: timeouts, response matching and
+ * refusal of blocking calls from the contexts results are delivered on.
+ */
+
+#ifndef TEST_FPR_RPC_H
+#define TEST_FPR_RPC_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the RPC test
+ *
+ * Initializes WiFi and FPR as a host with one peer that never answers,
+ * lets a call time out, completes another by injecting its response, and
+ * issues a blocking call from an esp_timer callback.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_rpc_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_RPC_H
@@ -0,0 +1,123 @@
+/**
+ * @file test_fpr_sched.c
+ * @brief FPR Service Task Scheduler Test Implementation
+ *
+ * Test jobs are armed in the client scan slot, which nothing else uses
+ * while the network is not started. A job can be held inside its run so
+ * that a post or cancel lands while it is running.
+ */
+
+#include "test_fpr_sched.h"
+#include "test_fpr_common.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/scheduler.h"
+
+static const char *TAG = "FPR_SCHED_TEST";
+
+#define TEST_JOB FPR_JOB_SCAN
+#define TEST_SETTLE_MS 100
+#define TEST_FAR_US (10 * 1000 * 1000)
+
+static volatile int s_runs;
+static volatile bool s_hold;
+static volatile int64_t s_next_us;
+static SemaphoreHandle_t s_started;
+static SemaphoreHandle_t s_release;
+
+// Counts its runs and asks for s_next_us, relative to now. With s_hold set
+// the first run waits for the test to release it.
+static int64_t test_job(int64_t now_us)
+{
+    s_runs++;
+    if (s_hold) {
+        s_hold = false;
+        xSemaphoreGive(s_started);
+        xSemaphoreTake(s_release, pdMS_TO_TICKS(1000));
+    }
+    return s_next_us == 0 ? 0 : now_us + s_next_us;
+}
+
+static void arm(int64_t delay_us, int64_t next_us, bool hold)
+{
+    s_runs = 0;
+    s_next_us = next_us;
+    s_hold = hold;
+    _fpr_sched_set(TEST_JOB, test_job, esp_timer_get_time() + delay_us);
+}
+
+static void settle(void)
+{
+    vTaskDelay(pdMS_TO_TICKS(TEST_SETTLE_MS));
+}
+
+esp_err_t fpr_sched_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Service Task Scheduler Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Sched-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    s_started = xSemaphoreCreateBinary();
+    s_release = xSemaphoreCreateBinary();
+    if (s_started == NULL || s_release == NULL) {
+        ESP_LOGE(TAG, "Setup failed: no memory for semaphores");
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+
+    // [TEST 1] A job runs at its deadline and a finished job is disarmed
+    arm(TEST_SETTLE_MS * 1000 / 2, 0, false);
+    settle();
+    settle();
+    passed &= fpr_test_check(TAG, "Job runs once at its deadline", s_runs == 1 && !_fpr_sched_is_armed(TEST_JOB));
+
+    // [TEST 2] A post runs a job long before its deadline
+    fpr_wakeup_stats_t before;
+    fpr_wakeup_stats_t after;
+    arm(TEST_FAR_US, TEST_FAR_US, false);
+    settle();
+    fpr_network_get_wakeup_stats(&before);
+    _fpr_sched_post(TEST_JOB);
+    settle();
+    fpr_network_get_wakeup_stats(&after);
+    passed &= fpr_test_check(TAG, "Post runs the job now",
+                             s_runs == 1 && _fpr_sched_is_armed(TEST_JOB));
+    passed &= fpr_test_check(TAG, "Post is counted as a posted wake-up",
+                             after.posted_wakeups > before.posted_wakeups);
+
+    // [TEST 3] A post made while the job runs is not lost to its return value
+    arm(0, TEST_FAR_US, true);
+    bool started = xSemaphoreTake(s_started, pdMS_TO_TICKS(TEST_SETTLE_MS)) == pdTRUE;
+    _fpr_sched_post(TEST_JOB);
+    xSemaphoreGive(s_release);
+    settle();
+    passed &= fpr_test_check(TAG, "Post during a run runs the job again", started && s_runs == 2);
+
+    // [TEST 4] A cancel made while the job runs wins over its return value
+    arm(0, TEST_FAR_US, true);
+    started = xSemaphoreTake(s_started, pdMS_TO_TICKS(TEST_SETTLE_MS)) == pdTRUE;
+    _fpr_sched_cancel(TEST_JOB);
+    xSemaphoreGive(s_release);
+    settle();
+    passed &= fpr_test_check(TAG, "Cancel during a run disarms the job",
+                             started && s_runs == 1 && !_fpr_sched_is_armed(TEST_JOB));
+
+    // [TEST 5] Posting a job that is not armed does nothing
+    _fpr_sched_post(TEST_JOB);
+    settle();
+    passed &= fpr_test_check(TAG, "Post of a disarmed job is ignored",
+                             s_runs == 1 && !_fpr_sched_is_armed(TEST_JOB));
+
+    ret = fpr_test_finish(TAG, passed);
+    vSemaphoreDelete(s_started);
+    vSemaphoreDelete(s_release);
+    return ret;
+}
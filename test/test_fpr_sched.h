@@ -0,0 +1,32 @@
+/**
+ * @file test_fpr_sched.h
+ * @brief FPR Service Task Scheduler Test API
+ *
+ * Single-device check of the service task job slots: deadlines, posts,
+ * and a post or cancel made while the job is running.
+ */
+
+#ifndef TEST_FPR_SCHED_H
+#define TEST_FPR_SCHED_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the service task scheduler test
+ *
+ * Initializes WiFi and FPR without starting the network, so the test
+ * jobs have the service task to themselves.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_sched_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_SCHED_H
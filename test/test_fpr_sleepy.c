@@ -0,0 +1,158 @@
+/**
+ * @file test_fpr_sleepy.c
+ * @brief FPR Sleepy Client Test Implementation
+ *
+ * The client exists only in the local peer table; its REGISTER and POLL
+ * frames are injected. What the host sends back is read from the send log.
+ */
+
+#include "test_fpr_sleepy.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_sleepy.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/services.h"
+
+static const char *TAG = "FPR_SLEEPY_TEST";
+
+#define TEST_BEACON_MS      100
+#define TEST_DATA_ID        1
+// One more than fits, so the oldest frame is dropped
+#define TEST_SENDS          (FPR_SLEEPY_BUFFER_DEPTH + 1)
+
+static void inject_sleepy(const uint8_t *mac, fpr_sleepy_kind_t kind, uint8_t listen_interval)
+{
+    fpr_package_t package = {0};
+    fpr_sleepy_frame_t *frame = (fpr_sleepy_frame_t *)&package.protocol;
+    frame->kind = kind;
+    frame->listen_interval = listen_interval;
+    package.id = FPR_PACKET_ID_SLEEPY;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(*frame);
+    fpr_test_inject(mac, &package);
+}
+
+static bool pending_for(uint8_t slot)
+{
+    fpr_beacon_frame_t beacon = {0};
+    _fpr_sleepy_fill_beacon(&beacon);
+    return (beacon.pending & FPR_PEER_BIT(slot)) != 0;
+}
+
+static esp_err_t send_value(uint8_t *mac, int value)
+{
+    return fpr_network_send_to_peer(mac, &value, sizeof(value), TEST_DATA_ID);
+}
+
+// First logged frame to mac with the given ID, from index on
+static const fpr_test_sent_t *find_sent(const uint8_t *mac, fpr_package_id_t id, size_t *index)
+{
+    for (; *index < fpr_test_sent_count(); (*index)++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(*index);
+        if (sent->package.id == id && memcmp(sent->dest, mac, 6) == 0) {
+            (*index)++;
+            return sent;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t fpr_sleepy_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Sleepy Client Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Sleepy-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    fpr_network_set_mode(FPR_MODE_HOST);
+
+    uint8_t mac[6];
+    ret = fpr_sleepy_host_enable(TEST_BEACON_MS);
+    if (ret == ESP_OK) {
+        ret = fpr_test_add_fake_peer(0x50, mac);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+    uint8_t slot = _get_peer_from_map(mac)->slot;
+
+    bool passed = true;
+    fpr_sleepy_stats_t stats;
+    size_t index = 0;
+
+    // [TEST 1] Registration is acknowledged with the client's peer slot
+    fpr_test_sent_reset();
+    inject_sleepy(mac, FPR_SLEEPY_KIND_REGISTER, 2);
+    fpr_sleepy_get_stats(&stats);
+    const fpr_test_sent_t *ack = find_sent(mac, FPR_PACKET_ID_SLEEPY, &index);
+    passed &= fpr_test_check(TAG, "Client is registered as sleepy", stats.sleepy_peers == 1);
+    passed &= fpr_test_check(TAG, "REGISTER_ACK carries the client's slot",
+                             ack != NULL && ((const fpr_sleepy_frame_t *)&ack->package.protocol)->slot == slot);
+
+    // [TEST 2] Data waits in the buffer and the beacon flags it
+    fpr_test_sent_reset();
+    bool sends_ok = true;
+    for (int i = 0; i < TEST_SENDS; i++) {
+        sends_ok &= (send_value(mac, i) == ESP_OK);
+    }
+    fpr_sleepy_get_stats(&stats);
+    index = 0;
+    passed &= fpr_test_check(TAG, "Sends to a sleeper succeed", sends_ok);
+    passed &= fpr_test_check(TAG, "Nothing goes on air before the poll", find_sent(mac, TEST_DATA_ID, &index) == NULL);
+    passed &= fpr_test_check(TAG, "Every send is buffered", stats.buffered == TEST_SENDS);
+    passed &= fpr_test_check(TAG, "A full buffer drops one frame", stats.buffer_dropped == 1);
+    passed &= fpr_test_check(TAG, "Beacon flags pending data", pending_for(slot));
+
+    // A control frame bypasses the buffer and takes a newer sequence number
+    fpr_sleepy_frame_t end = { .kind = FPR_SLEEPY_KIND_END };
+    fpr_network_send_to_peer(mac, &end, sizeof(end), FPR_PACKET_ID_SLEEPY);
+    index = 0;
+    const fpr_test_sent_t *bypass = find_sent(mac, FPR_PACKET_ID_SLEEPY, &index);
+    passed &= fpr_test_check(TAG, "Unbuffered frame goes out at once", bypass != NULL);
+    uint32_t bypass_seq = bypass != NULL ? bypass->package.sequence_num : UINT32_MAX;
+
+    // [TEST 3] A poll drains the buffer oldest first, renumbered, then END
+    fpr_test_sent_reset();
+    inject_sleepy(mac, FPR_SLEEPY_KIND_POLL, 0);
+    fpr_sleepy_get_stats(&stats);
+    index = 0;
+    int expected = 1;   // Value 0 was dropped
+    uint32_t last_seq = bypass_seq;
+    bool order_ok = true;
+    bool renumbered = true;
+    size_t drained = 0;
+    const fpr_test_sent_t *sent;
+    while ((sent = find_sent(mac, TEST_DATA_ID, &index)) != NULL) {
+        order_ok &= (sent->package.protocol.data_int[0] == expected++);
+        renumbered &= (sent->package.sequence_num > last_seq);
+        last_seq = sent->package.sequence_num;
+        drained++;
+    }
+    const fpr_test_sent_t *last = fpr_test_sent_get(fpr_test_sent_count() - 1);
+    passed &= fpr_test_check(TAG, "Poll is counted", stats.polls == 1);
+    passed &= fpr_test_check(TAG, "Poll drains a full buffer", drained == FPR_SLEEPY_BUFFER_DEPTH);
+    passed &= fpr_test_check(TAG, "Drained frames keep their order", order_ok);
+    passed &= fpr_test_check(TAG, "Drained frames are newer than the bypassing one", renumbered);
+    passed &= fpr_test_check(TAG, "END follows the drained data",
+                             last != NULL && last->package.id == FPR_PACKET_ID_SLEEPY &&
+                             ((const fpr_sleepy_frame_t *)&last->package.protocol)->kind == FPR_SLEEPY_KIND_END);
+    passed &= fpr_test_check(TAG, "Beacon no longer flags data", !pending_for(slot));
+
+    // [TEST 4] A client that stops sleeping gets its data directly again
+    inject_sleepy(mac, FPR_SLEEPY_KIND_REGISTER, 0);
+    fpr_sleepy_get_stats(&stats);
+    fpr_test_sent_reset();
+    send_value(mac, 42);
+    index = 0;
+    passed &= fpr_test_check(TAG, "Client is no longer sleepy", stats.sleepy_peers == 0);
+    passed &= fpr_test_check(TAG, "Data goes out without a poll", find_sent(mac, TEST_DATA_ID, &index) != NULL);
+
+    fpr_sleepy_host_disable();
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,34 @@
+/**
+ * @file test_fpr_sleepy.h
+ * @brief FPR Sleepy Client Test API
+ *
+ * Single-device check of the host side of sleepy clients: registration,
+ * downlink buffering, the beacon pending bit and the drain on poll.
+ */
+
+#ifndef TEST_FPR_SLEEPY_H
+#define TEST_FPR_SLEEPY_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the sleepy client test
+ *
+ * Initializes WiFi and FPR as a host buffering for sleepy clients, registers
+ * an injected client and checks that data for it waits for its poll, that
+ * the oldest frame goes when the buffer is full, and that drained frames
+ * carry sequence numbers newer than anything sent meanwhile.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_sleepy_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_SLEEPY_H
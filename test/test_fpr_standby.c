@@ -0,0 +1,140 @@
+/**
+ * @file test_fpr_standby.c
+ * @brief FPR Hot Standby Test Implementation
+ *
+ * Two hosts that do not exist are added as connected peers and reported
+ * connected in turn, so the first becomes the active host and the second
+ * the standby. Heartbeats are read from the send log and answered by
+ * injecting acks; a host goes quiet by moving its last-seen time back.
+ */
+
+#include "test_fpr_standby.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/services.h"
+
+static const char *TAG = "FPR_STANDBY_TEST";
+
+#define TEST_SLACK_MS 200
+#define TEST_LOST_US ((int64_t)FPR_STANDBY_HEARTBEAT_MS * FPR_STANDBY_MAX_MISSED_HEARTBEATS * 1000)
+
+static void heartbeat_ack(const uint8_t *host)
+{
+    fpr_package_t package = {0};
+    fpr_probe_frame_t *probe = (fpr_probe_frame_t *)&package.protocol;
+    probe->kind = FPR_PROBE_KIND_HEARTBEAT_ACK;
+    package.id = FPR_PACKET_ID_PROBE;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(*probe);
+    memcpy(package.origin_mac, host, 6);
+    memcpy(package.dest_mac, fpr_net.mac, 6);
+    fpr_test_receive(host, fpr_net.mac, &package);
+}
+
+static bool sent_heartbeat_to(const uint8_t *mac)
+{
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        const fpr_probe_frame_t *probe = (const fpr_probe_frame_t *)&sent->package.protocol;
+        if (sent->package.id == FPR_PACKET_ID_PROBE && probe->kind == FPR_PROBE_KIND_HEARTBEAT &&
+            memcmp(sent->dest, mac, 6) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+esp_err_t fpr_standby_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Hot Standby Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Standby-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    fpr_client_config_t client_config;
+    uint8_t primary[6], standby[6], spare[6];
+    ret = fpr_network_start();
+    if (ret == ESP_OK) {
+        ret = fpr_client_get_config(&client_config);
+    }
+    if (ret == ESP_OK) {
+        client_config.connection_mode = FPR_CONNECTION_AUTO;
+        ret = fpr_client_set_config(&client_config);
+    }
+    if (ret == ESP_OK) {
+        ret = fpr_client_set_standby(true);
+    }
+    if (ret == ESP_OK) {
+        ret = fpr_test_add_fake_peer(0xD0, primary);
+    }
+    if (ret == ESP_OK) {
+        ret = fpr_test_add_fake_peer(0xD1, standby);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    fpr_standby_stats_t stats;
+
+    // [TEST 1] The first host to connect carries traffic, the second stands by
+    _fpr_services_on_peer_connected(_get_peer_from_map(primary));
+    _fpr_services_on_peer_connected(_get_peer_from_map(standby));
+    fpr_client_get_standby_stats(&stats);
+    passed &= fpr_test_check(TAG, "Standby is ready", stats.enabled && stats.standby_ready);
+    passed &= fpr_test_check(TAG, "Roles follow the connect order",
+                             memcmp(stats.primary_mac, primary, 6) == 0 && memcmp(stats.standby_mac, standby, 6) == 0);
+
+    // [TEST 2] Both hosts get heartbeats, and acks keep them alive
+    fpr_test_sent_reset();
+    for (int i = 0; i < 2; i++) {
+        vTaskDelay(pdMS_TO_TICKS(FPR_STANDBY_HEARTBEAT_MS));
+        heartbeat_ack(primary);
+        heartbeat_ack(standby);
+    }
+    fpr_client_get_standby_stats(&stats);
+    passed &= fpr_test_check(TAG, "Heartbeats go to both hosts", sent_heartbeat_to(primary) && sent_heartbeat_to(standby));
+    passed &= fpr_test_check(TAG, "Heartbeats are counted", stats.heartbeats_sent >= 2);
+    passed &= fpr_test_check(TAG, "No failover while both answer", stats.failovers == 0 && stats.standby_ready);
+
+    // [TEST 3] A silent active host hands traffic to the standby
+    _get_peer_from_map(primary)->last_seen = esp_timer_get_time() - TEST_LOST_US - 1000000;
+    heartbeat_ack(standby);
+    vTaskDelay(pdMS_TO_TICKS(FPR_STANDBY_HEARTBEAT_MS + TEST_SLACK_MS));
+    fpr_client_get_standby_stats(&stats);
+    passed &= fpr_test_check(TAG, "Traffic moves to the standby",
+                             stats.failovers == 1 && memcmp(stats.primary_mac, standby, 6) == 0);
+    passed &= fpr_test_check(TAG, "Failover time covers the outage", stats.last_failover_ms >= TEST_LOST_US / 1000);
+    passed &= fpr_test_check(TAG, "Old host is released", !_get_peer_from_map(primary)->is_connected);
+    passed &= fpr_test_check(TAG, "No standby is left", !stats.standby_ready);
+
+    // [TEST 4] A standby that stops answering is dropped
+    ret = fpr_test_add_fake_peer(0xD2, spare);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Adding spare host failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+    _fpr_services_on_peer_connected(_get_peer_from_map(spare));
+    fpr_client_get_standby_stats(&stats);
+    passed &= fpr_test_check(TAG, "Spare host becomes the standby",
+                             stats.standby_ready && memcmp(stats.standby_mac, spare, 6) == 0);
+    _get_peer_from_map(spare)->last_seen = esp_timer_get_time() - TEST_LOST_US - 1000000;
+    heartbeat_ack(standby);
+    vTaskDelay(pdMS_TO_TICKS(FPR_STANDBY_HEARTBEAT_MS + TEST_SLACK_MS));
+    fpr_client_get_standby_stats(&stats);
+    passed &= fpr_test_check(TAG, "Silent standby is dropped", stats.standby_lost == 1 && !stats.standby_ready);
+    passed &= fpr_test_check(TAG, "Active host is kept",
+                             stats.failovers == 1 && memcmp(stats.primary_mac, standby, 6) == 0);
+
+    return fpr_test_finish(TAG, passed);
+}
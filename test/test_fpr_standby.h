@@ -0,0 +1,33 @@
+/**
+ * @file test_fpr_standby.h
+ * @brief FPR Hot Standby Test API
+ *
+ * Single-device check of the standby host heartbeats and of the switch to
+ * the standby when the active host goes quiet.
+ */
+
+#ifndef TEST_FPR_STANDBY_H
+#define TEST_FPR_STANDBY_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the hot standby test
+ *
+ * Initializes WiFi and FPR as an auto-mode client with two injected hosts,
+ * one active and one standby. Waits a few heartbeat periods
+ * (CONFIG_FPR_STANDBY_HEARTBEAT_MS).
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_standby_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_STANDBY_H
@@ -0,0 +1,116 @@
+/**
+ * @file test_fpr_stats.c
+ * @brief FPR Network Statistics Test Implementation
+ *
+ * Bumps the replay counter directly, which nothing else touches while the
+ * network is not started: from two tasks at once, and from live values set
+ * just below the 32-bit wrap and the half-range fold point.
+ */
+
+#include "test_fpr_stats.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_STATS_TEST";
+
+#define TEST_STAT FPR_STAT_REPLAY_ATTACKS_BLOCKED
+#define TEST_ADDS_PER_TASK 100000
+#define TEST_TASKS 2
+
+static SemaphoreHandle_t s_done;
+
+static void add_task(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < TEST_ADDS_PER_TASK; i++) {
+        _fpr_stat_add(TEST_STAT, 1);
+    }
+    xSemaphoreGive(s_done);
+    vTaskDelete(NULL);
+}
+
+static uint64_t stat_total(void)
+{
+    fpr_network_stats_t stats;
+    fpr_get_network_stats(&stats);
+    return stats.replay_attacks_blocked;
+}
+
+// Live counter at value, with everything up to it already folded
+static void set_live(uint32_t value)
+{
+    _fpr_stats_fold();
+    taskENTER_CRITICAL(&fpr_net.stats.fold_lock);
+    __atomic_store_n(&fpr_net.stats.live[TEST_STAT], value, __ATOMIC_RELAXED);
+    fpr_net.stats.folded[TEST_STAT] = value;
+    taskEXIT_CRITICAL(&fpr_net.stats.fold_lock);
+}
+
+esp_err_t fpr_stats_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Network Statistics Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Stats-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    s_done = xSemaphoreCreateCounting(TEST_TASKS, 0);
+    if (s_done == NULL) {
+        ESP_LOGE(TAG, "Failed to create semaphore");
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+
+    // [TEST 1] Adds from several tasks at once are all counted
+    uint64_t before = stat_total();
+    bool started = true;
+    for (int i = 0; i < TEST_TASKS; i++) {
+        // One per core where there are two, so the adds really overlap
+        started &= xTaskCreatePinnedToCore(add_task, "stats_add", 2048, NULL, uxTaskPriorityGet(NULL), NULL,
+                                           i % portNUM_PROCESSORS) == pdPASS;
+    }
+    bool finished = started;
+    for (int i = 0; started && i < TEST_TASKS; i++) {
+        finished &= xSemaphoreTake(s_done, pdMS_TO_TICKS(10000)) == pdTRUE;
+    }
+    passed &= fpr_test_check(TAG, "Concurrent adds are exact",
+                             finished && stat_total() - before == (uint64_t)TEST_TASKS * TEST_ADDS_PER_TASK);
+
+    // [TEST 2] A live counter that wraps between reads is still counted
+    before = stat_total();
+    set_live(UINT32_MAX - 0x0F);
+    _fpr_stat_add(TEST_STAT, 0x20);
+    passed &= fpr_test_check(TAG, "Wrap is absorbed", stat_total() - before == 0x20);
+
+    // [TEST 3] Crossing half the range folds without a reader
+    set_live(0x7FFFFFF0);
+    _fpr_stat_add(TEST_STAT, 0x20);
+    passed &= fpr_test_check(TAG, "Half-range crossing folds on the spot",
+                             fpr_net.stats.folded[TEST_STAT] == 0x80000010);
+
+    // [TEST 4] Totals stay exact past 32 bits with no reads in between
+    before = stat_total();
+    for (int i = 0; i < 5; i++) {
+        _fpr_stat_add(TEST_STAT, 0x40000000);
+    }
+    passed &= fpr_test_check(TAG, "Totals widen past 32 bits", stat_total() - before == 5ULL * 0x40000000);
+
+    // [TEST 5] Reset restarts the totals, later adds count from zero
+    fpr_reset_network_stats();
+    passed &= fpr_test_check(TAG, "Reset clears the total", stat_total() == 0);
+    _fpr_stat_add(TEST_STAT, 3);
+    passed &= fpr_test_check(TAG, "Counting resumes after reset", stat_total() == 3);
+
+    vSemaphoreDelete(s_done);
+    s_done = NULL;
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,32 @@
+/**
+ * @file test_fpr_stats.h
+ * @brief FPR Network Statistics Test API
+ *
+ * Single-device check that the network counters stay exact under updates
+ * from several tasks, across 32-bit wraps and over a reset.
+ */
+
+#ifndef TEST_FPR_STATS_H
+#define TEST_FPR_STATS_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the network statistics test
+ *
+ * Initializes WiFi and FPR without starting it, so no traffic moves the
+ * counter under test.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_stats_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_STATS_H
@@ -0,0 +1,156 @@
+/**
+ * @file test_fpr_store_forward.c
+ * @brief FPR Extender Store-and-Forward Test Implementation
+ *
+ * A neighbor relays frames from a remote origin to a destination this
+ * extender has never heard. Frames reach the extender's receive handler
+ * directly; what it forwards is read from the send log, and send results
+ * are reported by the test. Age is simulated by moving timestamps into
+ * the past.
+ */
+
+#include "test_fpr_store_forward.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_extender.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_STORE_FWD_TEST";
+
+#define TEST_DATA_ID        1
+// One more than the quota, so the oldest frame is evicted
+#define TEST_SENDS          (FPR_EXTENDER_STORE_PER_DEST + 1)
+
+static const uint8_t s_neighbor[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x60 };
+static const uint8_t s_origin[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x70 };
+static const uint8_t s_dest[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x71 };
+
+// The neighbor relays a frame from the origin towards the destination
+static void relay_for_dest(int value)
+{
+    fpr_package_t package = {0};
+    package.protocol.data_int[0] = value;
+    package.id = TEST_DATA_ID;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(int);
+    memcpy(package.origin_mac, s_origin, 6);
+    memcpy(package.dest_mac, s_dest, 6);
+    package.hop_count = 1;
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_receive(s_neighbor, fpr_net.mac, &package);
+}
+
+// The destination itself is heard, one hop away
+static void hear_dest(void)
+{
+    fpr_package_t package = {0};
+    package.id = TEST_DATA_ID;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(int);
+    memcpy(package.origin_mac, s_dest, 6);
+    memcpy(package.dest_mac, fpr_net.mac, 6);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_receive(s_dest, fpr_net.mac, &package);
+}
+
+static size_t count_sent_to_dest(void)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        if (memcmp(sent->dest, s_dest, 6) == 0 && sent->package.id == TEST_DATA_ID) {
+            count++;
+        }
+    }
+    return count;
+}
+
+esp_err_t fpr_store_forward_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Store-and-Forward Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-StoreFwd-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = fpr_network_start();
+    if (ret == ESP_OK) {
+        fpr_network_set_mode(FPR_MODE_EXTENDER);
+        // Nothing in the public API turns forwarding on yet
+        fpr_net.routing_enabled = true;
+        ret = fpr_extender_set_store_and_forward(true);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    fpr_extender_store_stats_t stats;
+
+    // [TEST 1] Frames for an unknown destination are held, up to the quota
+    fpr_test_sent_reset();
+    for (int i = 0; i < TEST_SENDS; i++) {
+        relay_for_dest(i);
+    }
+    fpr_extender_get_store_stats(&stats);
+    passed &= fpr_test_check(TAG, "Nothing is forwarded without a route", count_sent_to_dest() == 0);
+    passed &= fpr_test_check(TAG, "Frames are held up to the quota", stats.held == FPR_EXTENDER_STORE_PER_DEST);
+    passed &= fpr_test_check(TAG, "The oldest frame is evicted", stats.evicted == 1 && stats.stored == TEST_SENDS);
+
+    // [TEST 2] Hearing the destination flushes everything held for it
+    fpr_test_sent_reset();
+    hear_dest();
+    fpr_extender_get_store_stats(&stats);
+    bool newest_kept = true;
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        if (memcmp(sent->dest, s_dest, 6) == 0 && sent->package.id == TEST_DATA_ID) {
+            newest_kept &= (sent->package.protocol.data_int[0] != 0);
+        }
+    }
+    passed &= fpr_test_check(TAG, "Held frames go out once the destination is heard",
+                             count_sent_to_dest() == FPR_EXTENDER_STORE_PER_DEST);
+    passed &= fpr_test_check(TAG, "Flushed frames are the newest ones", newest_kept);
+    passed &= fpr_test_check(TAG, "Store is empty after the flush", stats.held == 0 && stats.delivered == FPR_EXTENDER_STORE_PER_DEST);
+
+    // [TEST 3] An unacknowledged send holds the frame again and drops the route
+    fpr_test_send_done(s_dest, false);
+    fpr_extender_get_store_stats(&stats);
+    passed &= fpr_test_check(TAG, "Failed send is held again", stats.send_failed == 1 && stats.held == 1);
+    passed &= fpr_test_check(TAG, "Route through the silent neighbor is dropped", _get_peer_from_map(s_dest)->hop_count == 0);
+
+    fpr_test_sent_reset();
+    hear_dest();
+    fpr_extender_get_store_stats(&stats);
+    passed &= fpr_test_check(TAG, "Re-held frame goes out when the destination returns",
+                             count_sent_to_dest() == 1 && stats.held == 0);
+
+    // [TEST 4] A route whose next hop went quiet expires and the frame is held
+    _get_peer_from_map(s_dest)->last_seen = esp_timer_get_time() - ((int64_t)FPR_EXTENDER_ROUTE_MAX_AGE_MS + 1000) * 1000;
+    fpr_test_sent_reset();
+    relay_for_dest(100);
+    fpr_extender_get_store_stats(&stats);
+    passed &= fpr_test_check(TAG, "Stale route expires", stats.routes_expired == 1);
+    passed &= fpr_test_check(TAG, "Frame for the stale route is held", count_sent_to_dest() == 0 && stats.held == 1);
+
+    // [TEST 5] A held frame past its age limit is dropped, not sent
+    taskENTER_CRITICAL(&fpr_net.store.lock);
+    for (int i = 0; i < FPR_EXTENDER_STORE_SIZE; i++) {
+        fpr_net.store.entries[i].stored_us -= ((int64_t)FPR_EXTENDER_STORE_MAX_AGE_MS + 1000) * 1000;
+    }
+    taskEXIT_CRITICAL(&fpr_net.store.lock);
+    fpr_test_sent_reset();
+    hear_dest();
+    fpr_extender_get_store_stats(&stats);
+    passed &= fpr_test_check(TAG, "Expired frame is dropped", stats.expired == 1 && stats.held == 0);
+    passed &= fpr_test_check(TAG, "Expired frame is not sent", count_sent_to_dest() == 0);
+
+    fpr_extender_set_store_and_forward(false);
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,34 @@
+/**
+ * @file test_fpr_store_forward.h
+ * @brief FPR Extender Store-and-Forward Test API
+ *
+ * Single-device check of how an extender holds unicast frames it cannot
+ * deliver and sends them once their destination is heard again.
+ */
+
+#ifndef TEST_FPR_STORE_FORWARD_H
+#define TEST_FPR_STORE_FORWARD_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the store-and-forward test
+ *
+ * Initializes WiFi and FPR as an extender with store-and-forward on,
+ * relays injected frames for an absent destination and checks the quota,
+ * the flush when the destination reappears, re-holding after a failed
+ * send, route expiry and frame expiry.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_store_forward_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_STORE_FORWARD_H
@@ -0,0 +1,132 @@
+/**
+ * @file test_fpr_tdma.c
+ * @brief FPR TDMA Scheduling Test Implementation
+ *
+ * Slot requests are injected from peers that exist only in the local peer
+ * table. Idleness is simulated by moving a peer's last_seen into the
+ * past; the beacon fill then reclaims its slot.
+ */
+
+#include "test_fpr_tdma.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_tdma.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/services.h"
+
+static const char *TAG = "FPR_TDMA_TEST";
+
+// Long enough that only the simulated idleness reclaims a slot
+#define TEST_SLOT_US        10000
+#define TEST_IDLE_FRAMES    255
+#define TEST_IDLE_US        (60LL * 1000 * 1000)
+// More reassignments than there are tags, so the tag counter wraps
+#define TEST_REASSIGNMENTS  600
+
+static void request_slot(const uint8_t *mac)
+{
+    fpr_package_t package = {0};
+    fpr_tdma_frame_t *frame = (fpr_tdma_frame_t *)&package.protocol;
+    frame->kind = FPR_TDMA_KIND_SLOT_REQUEST;
+    package.id = FPR_PACKET_ID_TDMA;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(*frame);
+    fpr_test_inject(mac, &package);
+}
+
+static void fill_beacon(fpr_beacon_frame_t *beacon)
+{
+    memset(beacon, 0, sizeof(*beacon));
+    _fpr_tdma_fill_beacon(beacon);
+}
+
+static void make_idle(const uint8_t *mac)
+{
+    _get_peer_from_map(mac)->last_seen = esp_timer_get_time() - TEST_IDLE_US;
+}
+
+static void make_active(const uint8_t *mac)
+{
+    _get_peer_from_map(mac)->last_seen = esp_timer_get_time();
+}
+
+esp_err_t fpr_tdma_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR TDMA Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-TDMA-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    fpr_network_set_mode(FPR_MODE_HOST);
+
+    uint8_t mac_a[6], mac_b[6];
+    ret = fpr_test_add_fake_peer(0x40, mac_a);
+    if (ret == ESP_OK) {
+        ret = fpr_test_add_fake_peer(0x41, mac_b);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Adding peers failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    fpr_tdma_config_t config = fpr_tdma_default_config();
+    config.slot_us = TEST_SLOT_US;
+    config.idle_superframes = TEST_IDLE_FRAMES;
+    ret = fpr_tdma_host_start(&config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "TDMA start failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    fpr_beacon_frame_t beacon;
+
+    // [TEST 1] Each client gets its own slot, and asking again keeps it
+    request_slot(mac_a);
+    request_slot(mac_b);
+    request_slot(mac_a);
+    fill_beacon(&beacon);
+    fpr_tdma_status_t status;
+    fpr_tdma_get_status(&status);
+    uint8_t tag_a = beacon.owner_tag[0];
+    uint8_t tag_b = beacon.owner_tag[1];
+    passed &= fpr_test_check(TAG, "Two requests from one client assign one slot", status.slots_assigned == 2);
+    passed &= fpr_test_check(TAG, "Beacon lists both slots", beacon.slot_count == 2);
+    passed &= fpr_test_check(TAG, "Owned slots carry distinct non-zero tags", tag_a != 0 && tag_b != 0 && tag_a != tag_b);
+
+    // [TEST 2] An idle client loses its slot, which the beacon shows as free
+    make_idle(mac_a);
+    make_active(mac_b);
+    fill_beacon(&beacon);
+    fpr_tdma_get_status(&status);
+    passed &= fpr_test_check(TAG, "Idle slot is reclaimed", status.slots_reclaimed == 1 && beacon.owner_tag[0] == 0);
+    passed &= fpr_test_check(TAG, "Active slot keeps its tag", beacon.owner_tag[1] == tag_b);
+
+    // [TEST 3] Reassigning the slot over and over never reuses a tag a stale owner could match
+    bool tags_ok = true;
+    uint8_t previous = tag_a;
+    for (int i = 0; i < TEST_REASSIGNMENTS && tags_ok; i++) {
+        request_slot(mac_a);
+        make_active(mac_b);
+        fill_beacon(&beacon);
+        uint8_t tag = beacon.owner_tag[0];
+        tags_ok = tag != 0 && tag != previous && tag != beacon.owner_tag[1];
+        if (!tags_ok) {
+            ESP_LOGE(TAG, "Reassignment %d drew tag %u (previous %u, other slot %u)",
+                     i, tag, previous, beacon.owner_tag[1]);
+        }
+        previous = tag;
+        make_idle(mac_a);
+        fill_beacon(&beacon);
+    }
+    passed &= fpr_test_check(TAG, "Every reassignment draws a fresh, unshared tag", tags_ok);
+
+    fpr_tdma_host_stop();
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,33 @@
+/**
+ * @file test_fpr_tdma.h
+ * @brief FPR TDMA Scheduling Test API
+ *
+ * Single-device check of host slot assignment, idle reclaim and the
+ * per-assignment owner tags carried in the beacon.
+ */
+
+#ifndef TEST_FPR_TDMA_H
+#define TEST_FPR_TDMA_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the TDMA test
+ *
+ * Initializes WiFi and FPR as a TDMA host, lets injected clients request
+ * slots and checks that a reclaimed slot is never handed out again under a
+ * tag a stale owner could still match.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_tdma_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_TDMA_H
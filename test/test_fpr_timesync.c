@@ -0,0 +1,104 @@
+/**
+ * @file test_fpr_timesync.c
+ * @brief FPR Time Synchronization Test Implementation
+ *
+ * The host exists only in the local peer table. Its answer to the
+ * client's request is built here from the request's own t1, with the
+ * host clock TEST_OFFSET_US ahead of the local one, and injected into the
+ * receive path.
+ */
+
+#include "test_fpr_timesync.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_timesync.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/services.h"
+
+static const char *TAG = "FPR_TIMESYNC_TEST";
+
+#define TEST_OFFSET_US      2500000LL
+#define TEST_TOLERANCE_US   2000
+
+static uint8_t host_mac[6];
+
+static void build_response(fpr_package_t *package)
+{
+    memset(package, 0, sizeof(*package));
+    fpr_timesync_frame_t *frame = (fpr_timesync_frame_t *)&package->protocol;
+    frame->kind = FPR_TIMESYNC_KIND_RESPONSE;
+    frame->seq = fpr_net.timesync.seq;
+    frame->t1 = fpr_net.timesync.request_t1;
+    frame->t2 = frame->t1 + TEST_OFFSET_US;
+    frame->t3 = esp_timer_get_time() + TEST_OFFSET_US;
+    package->id = FPR_PACKET_ID_TIMESYNC;
+    package->package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package->payload_size = sizeof(*frame);
+}
+
+static int64_t abs64(int64_t v)
+{
+    return v < 0 ? -v : v;
+}
+
+esp_err_t fpr_timesync_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Time Sync Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Timesync-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    fpr_network_set_mode(FPR_MODE_CLIENT);
+    ret = fpr_test_add_fake_peer(0x30, host_mac);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Adding host failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    passed &= fpr_test_check(TAG, "Not synced before any exchange", !fpr_timesync_is_synced());
+
+    // Connecting sends the first request to the host
+    _fpr_services_on_peer_connected(_get_peer_from_map(host_mac));
+
+    // [TEST 1] One exchange gives the host's offset
+    fpr_package_t response;
+    build_response(&response);
+    fpr_test_inject(host_mac, &response);
+
+    fpr_timesync_status_t status;
+    fpr_timesync_get_status(&status);
+    ESP_LOGI(TAG, "Offset: %lld us (expected %lld), RTT: %lu us",
+             (long long)status.offset_us, (long long)TEST_OFFSET_US, (unsigned long)status.rtt_us);
+    passed &= fpr_test_check(TAG, "Synced after one exchange", status.synced && status.samples == 1);
+    passed &= fpr_test_check(TAG, "Offset matches the host clock",
+                             abs64(status.offset_us - TEST_OFFSET_US) <= TEST_TOLERANCE_US);
+    passed &= fpr_test_check(TAG, "Client is stratum 1", status.stratum == 1);
+
+    int64_t network_us = 0;
+    int64_t local_us = esp_timer_get_time();
+    fpr_timesync_get_time(&network_us, NULL);
+    passed &= fpr_test_check(TAG, "Network time runs ahead by the offset",
+                             abs64(network_us - local_us - TEST_OFFSET_US) <= TEST_TOLERANCE_US);
+    passed &= fpr_test_check(TAG, "Local and network time convert back and forth",
+                             abs64(fpr_timesync_network_to_local(fpr_timesync_local_to_network(local_us)) - local_us) <= 1);
+
+    // [TEST 2] The same response again does not count as a second sample
+    fpr_test_inject(host_mac, &response);
+    fpr_timesync_get_status(&status);
+    passed &= fpr_test_check(TAG, "Duplicate response is rejected", status.samples == 1 && status.rejected == 1);
+
+    // [TEST 3] A different host has a different clock
+    uint8_t other_mac[6];
+    fpr_test_add_fake_peer(0x31, other_mac);
+    _fpr_services_on_peer_connected(_get_peer_from_map(other_mac));
+    passed &= fpr_test_check(TAG, "Switching hosts drops the estimate", !fpr_timesync_is_synced());
+
+    return fpr_test_finish(TAG, passed);
+}
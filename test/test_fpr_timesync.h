@@ -0,0 +1,33 @@
+/**
+ * @file test_fpr_timesync.h
+ * @brief FPR Time Synchronization Test API
+ *
+ * Single-device check of the client side of time sync: offset from one
+ * exchange, duplicate rejection and reset on a host switch.
+ */
+
+#ifndef TEST_FPR_TIMESYNC_H
+#define TEST_FPR_TIMESYNC_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the time sync test
+ *
+ * Initializes WiFi and FPR as a client of an injected host, answers its
+ * time request with a host clock a fixed offset ahead and checks the
+ * estimate that results.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_timesync_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_TIMESYNC_H
@@ -0,0 +1,182 @@
+/**
+ * @file test_fpr_trace.c
+ * @brief FPR Packet-Event Trace Test Implementation
+ *
+ * Frames from a client that does not exist are injected and sent to it, and
+ * the records they leave are read back. The ring is then overrun with
+ * synthetic records, with the network paused, to check the loss accounting
+ * and the dump size.
+ */
+
+#include "test_fpr_trace.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_trace.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_TRACE_TEST";
+
+#define TEST_DATA_ID 7
+#define TEST_OVERRUN 10
+#define TEST_READ_CHUNK 16
+
+static fpr_trace_record_t s_records[TEST_READ_CHUNK];
+
+typedef struct {
+    size_t bytes;
+    bool header_ok;
+} dump_ctx_t;
+
+static esp_err_t count_sink(const void *data, size_t size, void *ctx)
+{
+    dump_ctx_t *dump = (dump_ctx_t *)ctx;
+    if (dump->bytes == 0 && size >= sizeof(fpr_trace_file_header_t)) {
+        const fpr_trace_file_header_t *header = (const fpr_trace_file_header_t *)data;
+        dump->header_ok = memcmp(header->magic, FPR_TRACE_FILE_MAGIC, 4) == 0 &&
+                          header->version == FPR_TRACE_FILE_VERSION &&
+                          header->record_size == sizeof(fpr_trace_record_t) &&
+                          memcmp(header->node_mac, fpr_net.mac, 6) == 0;
+    }
+    dump->bytes += size;
+    return ESP_OK;
+}
+
+// Skip everything recorded so far
+static uint32_t cursor_now(void)
+{
+    uint32_t cursor = 0;
+    while (fpr_trace_read(&cursor, s_records, TEST_READ_CHUNK) > 0) {
+    }
+    return cursor;
+}
+
+// Read from cursor and keep the record of the given event for peer
+static bool find_event(uint32_t *cursor, fpr_trace_event_t event, const uint8_t *peer, fpr_trace_record_t *out)
+{
+    bool found = false;
+    size_t n;
+    while ((n = fpr_trace_read(cursor, s_records, TEST_READ_CHUNK)) > 0) {
+        for (size_t i = 0; i < n && !found; i++) {
+            if (s_records[i].event == event && memcmp(s_records[i].peer, peer, 6) == 0) {
+                *out = s_records[i];
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+static void receive(const uint8_t *client, uint32_t seq)
+{
+    fpr_package_t package = {0};
+    package.id = TEST_DATA_ID;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(int);
+    package.sequence_num = seq;
+    memcpy(package.origin_mac, client, 6);
+    memcpy(package.dest_mac, fpr_net.mac, 6);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_receive(client, fpr_net.mac, &package);
+}
+
+esp_err_t fpr_trace_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Packet-Event Trace Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Trace-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint8_t client[6];
+    ret = fpr_network_start();
+    if (ret == ESP_OK) {
+        fpr_network_set_mode(FPR_MODE_HOST);
+        ret = fpr_test_add_fake_peer(0xA5, client);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+
+    bool passed = true;
+    fpr_trace_record_t record;
+    uint32_t cursor;
+
+    // [TEST 1] A received frame leaves rx and enqueue records
+    cursor = cursor_now();
+    uint32_t start = cursor;
+    receive(client, 500);
+    passed &= fpr_test_check(TAG, "Receive is recorded",
+                             find_event(&cursor, FPR_TRACE_RX, client, &record) && record.sequence_num == 500 &&
+                             record.package_id == TEST_DATA_ID);
+    cursor = start;
+    passed &= fpr_test_check(TAG, "Enqueue is recorded with the queue depth",
+                             find_event(&cursor, FPR_TRACE_ENQUEUE, client, &record) && record.arg == 1);
+
+    // [TEST 2] A replayed frame leaves a drop record with the reason
+    receive(client, 499);
+    passed &= fpr_test_check(TAG, "Replay drop is recorded",
+                             find_event(&cursor, FPR_TRACE_DROP, client, &record) && record.arg == FPR_TRACE_DROP_REPLAY &&
+                             record.sequence_num == 499);
+
+    // [TEST 3] A send and its result are recorded
+    start = cursor;
+    int value = 1;
+    fpr_network_send_to_peer(client, &value, sizeof(value), TEST_DATA_ID);
+    fpr_test_send_done(client, false);
+    passed &= fpr_test_check(TAG, "Send is recorded",
+                             find_event(&cursor, FPR_TRACE_TX, client, &record) && record.arg == 0 &&
+                             record.package_id == TEST_DATA_ID);
+    cursor = start;
+    passed &= fpr_test_check(TAG, "Missing ack is recorded", find_event(&cursor, FPR_TRACE_TX_DONE, client, &record) && record.arg == 1);
+
+    // [TEST 4] Nothing is recorded while paused
+    cursor = cursor_now();
+    fpr_trace_set_enabled(false);
+    receive(client, 501);
+    size_t paused = fpr_trace_read(&cursor, s_records, TEST_READ_CHUNK);
+    fpr_trace_set_enabled(true);
+    passed &= fpr_test_check(TAG, "Paused trace records nothing", paused == 0);
+
+    // [TEST 5] Overwritten records are reported as lost. Pausing stops the
+    // host's own broadcasts, so only the records written here enter the ring.
+    fpr_network_pause();
+    cursor = cursor_now();
+    start = cursor;
+    for (int i = 0; i < FPR_TRACE_RING_SIZE + TEST_OVERRUN; i++) {
+        FPR_TRACE(FPR_TRACE_FORWARD, 1, client, NULL);
+    }
+    size_t first = fpr_trace_read(&cursor, s_records, 1);
+    passed &= fpr_test_check(TAG, "Lost records show as a jump in seq",
+                             first == 1 && s_records[0].seq - start == TEST_OVERRUN);
+    size_t total = first;
+    size_t n;
+    while ((n = fpr_trace_read(&cursor, s_records, TEST_READ_CHUNK)) > 0) {
+        total += n;
+    }
+    passed &= fpr_test_check(TAG, "The rest of the ring is returned once", total == FPR_TRACE_RING_SIZE);
+
+    // [TEST 6] A dump holds a header and the whole ring
+    dump_ctx_t dump = {0};
+    ret = fpr_trace_dump(count_sink, &dump);
+    passed &= fpr_test_check(TAG, "Dump header is valid", ret == ESP_OK && dump.header_ok);
+    passed &= fpr_test_check(TAG, "Dump holds every record",
+                             dump.bytes == sizeof(fpr_trace_file_header_t) + FPR_TRACE_RING_SIZE * sizeof(fpr_trace_record_t));
+
+    // [TEST 7] Clear discards every record but keeps cursors valid
+    fpr_trace_clear();
+    cursor = start;
+    size_t after_clear = fpr_trace_read(&cursor, s_records, TEST_READ_CHUNK);
+    memset(&dump, 0, sizeof(dump));
+    fpr_trace_dump(count_sink, &dump);
+    passed &= fpr_test_check(TAG, "Cleared ring is empty",
+                             after_clear == 0 && dump.bytes == sizeof(fpr_trace_file_header_t));
+    fpr_network_resume();
+
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,32 @@
+/**
+ * @file test_fpr_trace.h
+ * @brief FPR Packet-Event Trace Test API
+ *
+ * Single-device check of the trace ring: the events the data path records,
+ * incremental reads, overwrite accounting, dumps, pause and clear.
+ */
+
+#ifndef TEST_FPR_TRACE_H
+#define TEST_FPR_TRACE_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the packet-event trace test
+ *
+ * Initializes WiFi and FPR as a host with one injected client. Needs
+ * CONFIG_FPR_TRACE_ENABLE.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_trace_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_TRACE_H
@@ -0,0 +1,201 @@
+/**
+ * @file test_fpr_transport.c
+ * @brief FPR Transport Interface Test Implementation
+ *
+ * FPR is re-initialized on a probe transport that counts every operation
+ * FPR calls and keeps the callbacks it registers. Peers and receive still
+ * go to ESP-NOW, but nothing is sent on air and the probe gives the node
+ * its own address.
+ */
+
+#include "test_fpr_transport.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_transport.h"
+#include "fpr/internal/helpers.h"
+
+static const char *TAG = "FPR_TRANSPORT_TEST";
+
+#define TEST_NAME "FPR-Transport-Test"
+#define TEST_DATA_ID 1
+
+static const uint8_t s_probe_addr[6] = { 0x02, 0xFE, 0x00, 0x00, 0x00, 0x01 };
+
+typedef struct {
+    int inits;
+    int deinits;
+    int sends;
+    uint8_t last_dest[6];
+    uint8_t last_added[6];
+    uint8_t last_deleted[6];
+    fpr_transport_rx_cb_t rx;
+    fpr_transport_tx_done_cb_t tx_done;
+} probe_t;
+
+static probe_t s_probe;
+static fpr_transport_ops_t s_probe_ops;
+static fpr_transport_t s_probe_transport;
+
+static esp_err_t probe_init(void *ctx)
+{
+    s_probe.inits++;
+    return fpr_transport_espnow()->ops->init(ctx);
+}
+
+static esp_err_t probe_deinit(void *ctx)
+{
+    s_probe.deinits++;
+    return fpr_transport_espnow()->ops->deinit(ctx);
+}
+
+static esp_err_t probe_set_callbacks(void *ctx, fpr_transport_rx_cb_t rx, fpr_transport_tx_done_cb_t tx_done)
+{
+    s_probe.rx = rx;
+    s_probe.tx_done = tx_done;
+    return fpr_transport_espnow()->ops->set_callbacks(ctx, rx, tx_done);
+}
+
+static esp_err_t probe_send(void *ctx, const uint8_t *dest_addr, const uint8_t *data, size_t len)
+{
+    (void)ctx;
+    (void)data;
+    (void)len;
+    s_probe.sends++;
+    memcpy(s_probe.last_dest, dest_addr, 6);
+    return ESP_OK;
+}
+
+static esp_err_t probe_add_peer(void *ctx, const fpr_transport_peer_t *peer)
+{
+    memcpy(s_probe.last_added, peer->addr, 6);
+    return fpr_transport_espnow()->ops->add_peer(ctx, peer);
+}
+
+static esp_err_t probe_del_peer(void *ctx, const uint8_t *addr)
+{
+    memcpy(s_probe.last_deleted, addr, 6);
+    return fpr_transport_espnow()->ops->del_peer(ctx, addr);
+}
+
+static esp_err_t probe_get_addr(void *ctx, uint8_t addr[FPR_TRANSPORT_ADDR_LEN])
+{
+    (void)ctx;
+    memcpy(addr, s_probe_addr, FPR_TRANSPORT_ADDR_LEN);
+    return ESP_OK;
+}
+
+static const fpr_transport_t *probe_transport(void)
+{
+    const fpr_transport_t *espnow = fpr_transport_espnow();
+    s_probe_ops = *espnow->ops;
+    s_probe_ops.name = "test-probe";
+    s_probe_ops.init = probe_init;
+    s_probe_ops.deinit = probe_deinit;
+    s_probe_ops.set_callbacks = probe_set_callbacks;
+    s_probe_ops.send = probe_send;
+    s_probe_ops.add_peer = probe_add_peer;
+    s_probe_ops.del_peer = probe_del_peer;
+    s_probe_ops.get_addr = probe_get_addr;
+    s_probe_transport.ops = &s_probe_ops;
+    s_probe_transport.ctx = espnow->ctx;
+    return &s_probe_transport;
+}
+
+esp_err_t fpr_transport_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Transport Interface Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up(TEST_NAME);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    bool passed = true;
+    const fpr_transport_t *recording = fpr_transport_get();
+    const fpr_transport_t *probe = probe_transport();
+
+    // [TEST 1] The transport only changes while no network is initialized
+    passed &= fpr_test_check(TAG, "Transport is fixed while initialized",
+                             fpr_transport_set(probe) == ESP_ERR_INVALID_STATE);
+    fpr_network_deinit();
+    static const fpr_transport_ops_t no_send_ops = { .name = "no-send" };
+    const fpr_transport_t no_send = { .ops = &no_send_ops };
+    passed &= fpr_test_check(TAG, "Transport without send is refused",
+                             fpr_transport_set(&no_send) == ESP_ERR_INVALID_ARG);
+
+    // [TEST 2] Init starts the transport and takes the node address from it
+    ret = fpr_transport_set(probe);
+    if (ret == ESP_OK) {
+        ret = fpr_network_init(TEST_NAME);
+    }
+    passed &= fpr_test_check(TAG, "Init starts the selected transport",
+                             ret == ESP_OK && fpr_transport_get() == probe && s_probe.inits == 1 &&
+                             s_probe.rx != NULL && s_probe.tx_done != NULL);
+    passed &= fpr_test_check(TAG, "Node address comes from the transport", memcmp(fpr_net.mac, s_probe_addr, 6) == 0);
+
+    uint8_t client[6];
+    if (ret == ESP_OK) {
+        ret = fpr_network_start();
+    }
+    if (ret == ESP_OK) {
+        fpr_network_set_mode(FPR_MODE_HOST);
+        ret = fpr_test_add_fake_peer(0xC1, client);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        fpr_network_deinit();
+        fpr_transport_set(recording);
+        fpr_network_init(TEST_NAME);
+        return fpr_test_finish(TAG, false);
+    }
+
+    // [TEST 3] Peers are registered with the transport
+    passed &= fpr_test_check(TAG, "New peer is added to the transport", memcmp(s_probe.last_added, client, 6) == 0);
+
+    // [TEST 4] Sends go to the transport and its result reaches the peer's stats
+    int value = 1;
+    int sends = s_probe.sends;
+    fpr_network_send_to_peer(client, &value, sizeof(value), TEST_DATA_ID);
+    s_probe.tx_done(client, false);
+    fpr_peer_stats_t stats;
+    fpr_network_get_peer_stats(client, &stats);
+    passed &= fpr_test_check(TAG, "Send goes to the transport",
+                             s_probe.sends > sends && memcmp(s_probe.last_dest, client, 6) == 0);
+    passed &= fpr_test_check(TAG, "Send result comes from the transport", stats.send_failures == 1);
+
+    // [TEST 5] Frames the transport receives reach the peer queue
+    fpr_package_t package = {0};
+    package.protocol.data_int[0] = 41;
+    package.id = TEST_DATA_ID;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(int);
+    package.sequence_num = 100;
+    package.version = FPR_PROTOCOL_VERSION;
+    memcpy(package.origin_mac, client, 6);
+    memcpy(package.dest_mac, fpr_net.mac, 6);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    const fpr_transport_rx_info_t info = { .src_addr = client, .dest_addr = fpr_net.mac };
+    s_probe.rx(&info, (const uint8_t *)&package, sizeof(package));
+    value = 0;
+    bool got = fpr_network_get_data_from_peer(client, &value, sizeof(value), 0);
+    passed &= fpr_test_check(TAG, "Received frame is delivered", got && value == 41);
+
+    // [TEST 6] Removed peers leave the transport, and deinit stops it
+    memset(s_probe.last_deleted, 0, sizeof(s_probe.last_deleted));
+    fpr_network_remove_peer(client);
+    passed &= fpr_test_check(TAG, "Removed peer is deleted from the transport",
+                             memcmp(s_probe.last_deleted, client, 6) == 0);
+    fpr_network_deinit();
+    passed &= fpr_test_check(TAG, "Deinit stops the transport", s_probe.deinits == 1);
+    passed &= fpr_test_check(TAG, "NULL selects ESP-NOW",
+                             fpr_transport_set(NULL) == ESP_OK && fpr_transport_get() == fpr_transport_espnow());
+
+    // Back on the recording transport for the common teardown
+    fpr_transport_set(recording);
+    fpr_network_init(TEST_NAME);
+    return fpr_test_finish(TAG, passed);
+}
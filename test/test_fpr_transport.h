@@ -0,0 +1,33 @@
+/**
+ * @file test_fpr_transport.h
+ * @brief FPR Transport Interface Test API
+ *
+ * Single-device check of the pluggable transport: selection rules, and the
+ * init, address, peer, send, send result, receive and deinit calls FPR
+ * makes on it.
+ */
+
+#ifndef TEST_FPR_TRANSPORT_H
+#define TEST_FPR_TRANSPORT_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the transport interface test
+ *
+ * Initializes WiFi and FPR, then re-initializes FPR as a host on a probe
+ * transport with one injected client.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_transport_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_TRANSPORT_H
@@ -0,0 +1,181 @@
+/**
+ * @file test_fpr_tree.c
+ * @brief FPR Collection Tree Test Implementation
+ *
+ * Extender side: beacons from two candidate parents that do not exist are
+ * injected, then data from a child, from the parent itself and at the hop
+ * limit. Where each frame goes is read from the send log. Host side: the
+ * device becomes the sink and tree data from an injected node is read from
+ * that node's queue.
+ */
+
+#include "test_fpr_tree.h"
+#include "test_fpr_common.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "fpr/fpr.h"
+#include "fpr/fpr_tree.h"
+#include "fpr/internal/helpers.h"
+#include "fpr/internal/scheduler.h"
+
+static const char *TAG = "FPR_TREE_TEST";
+
+#define TEST_DATA_ID 5
+
+static const uint8_t s_sink[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x8F };
+static const uint8_t s_near[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x80 };
+static const uint8_t s_far[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x81 };
+static const uint8_t s_child[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x82 };
+static const uint8_t s_broadcast[6] = FPR_BROADCAST_ADDRESS;
+
+static void beacon(const uint8_t *from, uint16_t cost, uint16_t seq)
+{
+    fpr_package_t package = {0};
+    fpr_tree_header_t *header = &((fpr_tree_frame_t *)&package.protocol)->header;
+    header->kind = FPR_TREE_KIND_BEACON;
+    header->cost = cost;
+    header->seq = seq;
+    memcpy(header->sink, s_sink, 6);
+    package.id = FPR_PACKET_ID_TREE;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(*header);
+    memcpy(package.origin_mac, from, 6);
+    memcpy(package.dest_mac, s_broadcast, 6);
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_receive(from, s_broadcast, &package);
+}
+
+// Tree data sent by from, which advertises cost
+static void data_from(const uint8_t *from, uint16_t cost, uint8_t hop_count, int value)
+{
+    fpr_package_t package = {0};
+    fpr_tree_frame_t *frame = (fpr_tree_frame_t *)&package.protocol;
+    frame->header.kind = FPR_TREE_KIND_DATA;
+    frame->header.cost = cost;
+    frame->header.inner_id = TEST_DATA_ID;
+    frame->header.payload_len = sizeof(value);
+    memcpy(frame->payload, &value, sizeof(value));
+    memcpy(frame->header.sink, s_sink, 6);
+    package.id = FPR_PACKET_ID_TREE;
+    package.package_type = FPR_PACKAGE_TYPE_SINGLE;
+    package.payload_size = sizeof(frame->header) + sizeof(value);
+    memcpy(package.origin_mac, from, 6);
+    memcpy(package.dest_mac, s_sink, 6);
+    package.hop_count = hop_count;
+    package.max_hops = FPR_DEFAULT_MAX_HOPS;
+    fpr_test_receive(from, fpr_net.mac, &package);
+}
+
+// Last tree frame of the given kind handed to the radio
+static const fpr_test_sent_t *last_sent(fpr_tree_kind_t kind)
+{
+    const fpr_test_sent_t *found = NULL;
+    for (size_t i = 0; i < fpr_test_sent_count(); i++) {
+        const fpr_test_sent_t *sent = fpr_test_sent_get(i);
+        const fpr_tree_header_t *header = &((const fpr_tree_frame_t *)&sent->package.protocol)->header;
+        if (sent->package.id == FPR_PACKET_ID_TREE && header->kind == kind) {
+            found = sent;
+        }
+    }
+    return found;
+}
+
+esp_err_t fpr_tree_test_run(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "FPR Collection Tree Test Starting");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = fpr_test_bring_up("FPR-Tree-Test");
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = fpr_network_start();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Start failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+    fpr_network_set_mode(FPR_MODE_EXTENDER);
+
+    bool passed = true;
+    fpr_tree_info_t info;
+    fpr_tree_stats_t stats;
+    const fpr_test_sent_t *sent;
+    bool idle = !_fpr_sched_is_armed(FPR_JOB_TREE);
+
+    // [TEST 1] The parent is the neighbor with the lowest path cost, not the loudest
+    beacon(s_near, 0, 1);
+    beacon(s_far, 30, 1);
+    fpr_tree_get_info(&info);
+    passed &= fpr_test_check(TAG, "Sink neighbor becomes the parent",
+                             info.has_parent && memcmp(info.parent_mac, s_near, 6) == 0 &&
+                             memcmp(info.sink_mac, s_sink, 6) == 0 && info.neighbors == 2);
+    passed &= fpr_test_check(TAG, "Cost is the parent's cost plus the link cost",
+                             info.cost == info.parent_link_cost && info.cost < FPR_TREE_COST_INFINITE);
+    passed &= fpr_test_check(TAG, "Beacon job starts when the router joins", idle && _fpr_sched_is_armed(FPR_JOB_TREE));
+    uint16_t own_cost = info.cost;
+
+    // [TEST 2] Own data goes to the parent, addressed to the sink
+    fpr_test_sent_reset();
+    int value = 1;
+    ret = fpr_tree_send(&value, sizeof(value), TEST_DATA_ID);
+    sent = last_sent(FPR_TREE_KIND_DATA);
+    passed &= fpr_test_check(TAG, "Data goes to the parent",
+                             ret == ESP_OK && sent != NULL && memcmp(sent->dest, s_near, 6) == 0 &&
+                             memcmp(sent->package.dest_mac, s_sink, 6) == 0);
+    passed &= fpr_test_check(TAG, "Data carries our cost",
+                             sent != NULL && ((const fpr_tree_frame_t *)&sent->package.protocol)->header.cost == own_cost);
+
+    // [TEST 3] Data from a child is passed up
+    fpr_test_sent_reset();
+    data_from(s_child, own_cost + 20, 0, 2);
+    sent = last_sent(FPR_TREE_KIND_DATA);
+    passed &= fpr_test_check(TAG, "Child data is forwarded to the parent",
+                             sent != NULL && memcmp(sent->dest, s_near, 6) == 0 && sent->package.hop_count == 1 &&
+                             memcmp(sent->package.origin_mac, s_child, 6) == 0);
+
+    // [TEST 4] Data at the hop limit is dropped
+    fpr_test_sent_reset();
+    data_from(s_child, own_cost + 20, FPR_DEFAULT_MAX_HOPS - 1, 3);
+    fpr_tree_get_stats(&stats);
+    passed &= fpr_test_check(TAG, "Hop-limited data is dropped", last_sent(FPR_TREE_KIND_DATA) == NULL && stats.hop_limit == 1);
+
+    // [TEST 5] Data from our own parent is a loop: the parent is dropped
+    fpr_test_sent_reset();
+    data_from(s_near, 0, 0, 4);
+    fpr_tree_get_info(&info);
+    fpr_tree_get_stats(&stats);
+    sent = last_sent(FPR_TREE_KIND_DATA);
+    passed &= fpr_test_check(TAG, "Loop is detected", stats.loops == 1);
+    passed &= fpr_test_check(TAG, "Alternate parent takes over",
+                             info.has_parent && memcmp(info.parent_mac, s_far, 6) == 0 && info.cost > own_cost &&
+                             sent != NULL && memcmp(sent->dest, s_far, 6) == 0);
+    passed &= fpr_test_check(TAG, "Forwarding is counted", stats.sent == 1 && stats.forwarded == 2 && stats.parent_changes == 2);
+
+    // [TEST 6] A host sink advertises cost 0 and delivers tree data
+    fpr_network_set_mode(FPR_MODE_HOST);
+    uint8_t node[6];
+    ret = fpr_test_add_fake_peer(0x83, node);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Adding node failed: %s", esp_err_to_name(ret));
+        return fpr_test_finish(TAG, false);
+    }
+    fpr_test_sent_reset();
+    idle = !_fpr_sched_is_armed(FPR_JOB_TREE);
+    fpr_tree_set_sink(true);
+    passed &= fpr_test_check(TAG, "Beacon job starts when the host becomes the sink", idle && _fpr_sched_is_armed(FPR_JOB_TREE));
+    sent = last_sent(FPR_TREE_KIND_BEACON);
+    const fpr_tree_header_t *header = sent != NULL ? &((const fpr_tree_frame_t *)&sent->package.protocol)->header : NULL;
+    passed &= fpr_test_check(TAG, "Sink beacons cost 0",
+                             header != NULL && header->cost == 0 && memcmp(header->sink, fpr_net.mac, 6) == 0 &&
+                             memcmp(sent->dest, s_broadcast, 6) == 0);
+
+    data_from(node, 40, 1, 42);
+    int received = 0;
+    bool got = fpr_network_get_data_from_peer(node, &received, sizeof(received), pdMS_TO_TICKS(100));
+    fpr_tree_get_stats(&stats);
+    passed &= fpr_test_check(TAG, "Sink delivers the data to the application", got && received == 42 && stats.delivered == 1);
+
+    return fpr_test_finish(TAG, passed);
+}
@@ -0,0 +1,32 @@
+/**
+ * @file test_fpr_tree.h
+ * @brief FPR Collection Tree Test API
+ *
+ * Single-device check of collection-tree routing: parent choice from sink
+ * cost beacons, upstream forwarding, loop detection and delivery at the sink.
+ */
+
+#ifndef TEST_FPR_TREE_H
+#define TEST_FPR_TREE_H
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run the collection tree test
+ *
+ * Initializes WiFi and FPR as an extender that hears injected tree beacons
+ * and data, then as a host acting as the sink.
+ *
+ * @return ESP_OK if the test passed, ESP_FAIL if it failed, or an init error
+ */
+esp_err_t fpr_tree_test_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FPR_TREE_H
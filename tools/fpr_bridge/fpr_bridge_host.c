@@ -0,0 +1,510 @@
+/**
+ * @file fpr_bridge_host.c
+ * @brief FPR Serial Bridge, Linux side
+ *
+ * The reader buffer is filled by read() and never copied again: frames are
+ * COBS-decoded where they lie, and records point at them. The buffer is
+ * compacted only once every record has been taken, which is also when
+ * the frames are acknowledged, so the window offered in HELLO is what
+ * the buffer can hold.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#define _GNU_SOURCE
+
+#include "fpr_bridge_host.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define HOST_WIRE_MAX FPR_BRIDGE_WIRE_MAX(FPR_BRIDGE_MAX_FRAME)
+#define HOST_WINDOW (FPR_BRIDGE_HOST_RX_BUFFER / HOST_WIRE_MAX > 255 ? 255 : FPR_BRIDGE_HOST_RX_BUFFER / HOST_WIRE_MAX)
+#define HOST_MAX_READY HOST_WINDOW
+
+typedef struct {
+    size_t off;                 // Records, decoded, in rx
+    size_t len;
+    uint8_t count;
+} host_frame_t;
+
+struct fpr_bridge_host {
+    int fd;
+    bool own_fd;
+
+    bool connected;
+    uint8_t peer_window;
+    uint16_t peer_max_frame;
+    uint16_t tx_seq;            // Last DATA frame sealed
+    uint16_t peer_ack;          // Last DATA frame the node released
+    uint16_t rx_seq;            // Last DATA frame decoded
+    uint16_t rx_released;       // Last DATA frame the application finished with
+    uint16_t ack_sent;
+
+    // Reader
+    uint8_t rx[FPR_BRIDGE_HOST_RX_BUFFER];
+    size_t rx_fill;
+    size_t rx_parsed;           // Up to and including the last delimiter handled
+    bool rx_skipping;           // Dropping an oversized frame up to its delimiter
+    host_frame_t ready[HOST_MAX_READY];
+    size_t ready_count;
+    size_t ready_index;
+    size_t rec_off;
+    uint8_t rec_index;
+    uint16_t ready_last_seq;
+
+    // Writer
+    uint8_t stage[FPR_BRIDGE_MAX_FRAME];
+    size_t stage_len;
+    uint8_t stage_count;
+    uint8_t tx[FPR_BRIDGE_HOST_TX_BUFFER];
+    size_t tx_len;
+    size_t tx_sent;
+
+    fpr_bridge_host_stats_t stats;
+};
+
+// ========== OUTPUT ==========
+
+static int _host_write(fpr_bridge_host_t *b)
+{
+    while (b->tx_sent < b->tx_len) {
+        ssize_t n = write(b->fd, b->tx + b->tx_sent, b->tx_len - b->tx_sent);
+        if (n > 0) {
+            b->tx_sent += (size_t)n;
+            b->stats.tx_bytes += (uint64_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return -EAGAIN;
+        }
+        return n < 0 ? -errno : -EIO;
+    }
+    b->tx_len = 0;
+    b->tx_sent = 0;
+    return 0;
+}
+
+// Room for one more sealed frame of len decoded bytes
+static bool _host_tx_room(fpr_bridge_host_t *b, size_t len)
+{
+    size_t need = FPR_BRIDGE_WIRE_MAX(len + FPR_BRIDGE_CRC_LEN);
+    if (b->tx_len + need <= sizeof(b->tx)) {
+        return true;
+    }
+    if (b->tx_sent > 0) {
+        memmove(b->tx, b->tx + b->tx_sent, b->tx_len - b->tx_sent);
+        b->tx_len -= b->tx_sent;
+        b->tx_sent = 0;
+    }
+    return b->tx_len + need <= sizeof(b->tx);
+}
+
+static void _host_seal(fpr_bridge_host_t *b, uint8_t *frame, size_t len)
+{
+    fpr_bridge_frame_header_t *hdr = (fpr_bridge_frame_header_t *)frame;
+    hdr->ack = b->rx_released;
+    b->ack_sent = b->rx_released;
+    b->tx_len += fpr_bridge_frame_seal(frame, len, b->tx + b->tx_len);
+}
+
+static void _host_queue_control(fpr_bridge_host_t *b, uint8_t type, uint8_t hello_flags)
+{
+    uint8_t frame[sizeof(fpr_bridge_frame_header_t) + sizeof(fpr_bridge_hello_t) + FPR_BRIDGE_CRC_LEN];
+    fpr_bridge_frame_header_t hdr = { .type = type };
+    size_t len = sizeof(hdr);
+    if (type == FPR_BRIDGE_FRAME_HELLO) {
+        fpr_bridge_hello_t hello = {
+            .version = FPR_BRIDGE_PROTO_VERSION,
+            .flags = hello_flags,
+            .window = HOST_WINDOW,
+            .max_frame = FPR_BRIDGE_MAX_FRAME,
+        };
+        memcpy(frame + len, &hello, sizeof(hello));
+        len += sizeof(hello);
+    }
+    // A dropped ACK is repeated by the next one; a dropped HELLO by the node's retry
+    if (!_host_tx_room(b, len)) {
+        return;
+    }
+    memcpy(frame, &hdr, sizeof(hdr));
+    _host_seal(b, frame, len);
+}
+
+static int _host_close_stage(fpr_bridge_host_t *b)
+{
+    if (b->stage_count == 0) {
+        return 0;
+    }
+    if ((uint16_t)(b->tx_seq - b->peer_ack) >= b->peer_window || !_host_tx_room(b, b->stage_len)) {
+        return -EAGAIN;
+    }
+    fpr_bridge_frame_header_t hdr = {
+        .type = FPR_BRIDGE_FRAME_DATA,
+        .count = b->stage_count,
+        .seq = ++b->tx_seq,
+    };
+    memcpy(b->stage, &hdr, sizeof(hdr));
+    _host_seal(b, b->stage, b->stage_len);
+    b->stats.tx_frames++;
+    b->stats.tx_records += b->stage_count;
+    b->stage_len = 0;
+    b->stage_count = 0;
+    return 0;
+}
+
+// ========== INPUT ==========
+
+static void _host_reset(fpr_bridge_host_t *b)
+{
+    b->tx_seq = 0;
+    b->peer_ack = 0;
+    b->rx_seq = 0;
+    b->rx_released = 0;
+    b->ack_sent = 0;
+    b->ready_last_seq = 0;
+    // Output numbered for the old session is useless to the new one
+    b->stage_len = 0;
+    b->stage_count = 0;
+    b->tx_len = 0;
+    b->tx_sent = 0;
+}
+
+static void _host_on_frame(fpr_bridge_host_t *b, size_t off, size_t wire_len)
+{
+    int len = fpr_bridge_frame_open(b->rx + off, wire_len);
+    if (len < 0) {
+        b->stats.bad_frames++;
+        return;
+    }
+    fpr_bridge_frame_header_t hdr;
+    memcpy(&hdr, b->rx + off, sizeof(hdr));
+    size_t body = off + sizeof(hdr);
+    size_t body_len = (size_t)len - sizeof(hdr);
+
+    switch (hdr.type) {
+    case FPR_BRIDGE_FRAME_HELLO: {
+        fpr_bridge_hello_t hello;
+        if (body_len < sizeof(hello)) {
+            b->stats.bad_frames++;
+            return;
+        }
+        memcpy(&hello, b->rx + body, sizeof(hello));
+        if (hello.version != FPR_BRIDGE_PROTO_VERSION) {
+            return;
+        }
+        b->peer_window = hello.window != 0 ? hello.window : 1;
+        b->peer_max_frame = hello.max_frame < FPR_BRIDGE_MAX_FRAME ? hello.max_frame : FPR_BRIDGE_MAX_FRAME;
+        if ((hello.flags & FPR_BRIDGE_HELLO_REPLY) == 0) {
+            // The node (re)started: both directions count from 1 again
+            _host_reset(b);
+            _host_queue_control(b, FPR_BRIDGE_FRAME_HELLO, FPR_BRIDGE_HELLO_REPLY);
+        }
+        b->connected = true;
+        return;
+    }
+    case FPR_BRIDGE_FRAME_DATA: {
+        if (!b->connected) {
+            return;
+        }
+        if (b->ready_count == HOST_MAX_READY) {
+            b->stats.bad_frames++; // Beyond the window we offered
+            return;
+        }
+        int16_t gap = (int16_t)(hdr.seq - b->rx_seq - 1);
+        if (gap > 0) {
+            b->stats.lost_frames += (uint64_t)gap;
+        }
+        b->rx_seq = hdr.seq;
+        b->ready[b->ready_count++] = (host_frame_t){ .off = body, .len = body_len, .count = hdr.count };
+        b->ready_last_seq = hdr.seq;
+        b->peer_ack = hdr.ack;
+        b->stats.rx_frames++;
+        return;
+    }
+    case FPR_BRIDGE_FRAME_ACK:
+        if (b->connected) {
+            b->peer_ack = hdr.ack;
+        }
+        return;
+    default:
+        b->stats.bad_frames++;
+        return;
+    }
+}
+
+// All records taken: acknowledge the frames and free the buffer
+static void _host_release(fpr_bridge_host_t *b)
+{
+    if (b->ready_count == 0) {
+        return;
+    }
+    b->rx_released = b->ready_last_seq;
+    b->ready_count = 0;
+    b->ready_index = 0;
+    b->rec_off = 0;
+    b->rec_index = 0;
+
+    memmove(b->rx, b->rx + b->rx_parsed, b->rx_fill - b->rx_parsed);
+    b->rx_fill -= b->rx_parsed;
+    b->rx_parsed = 0;
+
+    // Ride on a staged DATA frame when there is one, else acknowledge alone
+    _host_close_stage(b);
+    if (b->ack_sent != b->rx_released) {
+        _host_queue_control(b, FPR_BRIDGE_FRAME_ACK, 0);
+    }
+    _host_write(b);
+}
+
+// ========== PUBLIC API ==========
+
+static speed_t _host_speed(int baud)
+{
+    switch (baud) {
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    case 1000000: return B1000000;
+    case 1500000: return B1500000;
+    case 2000000: return B2000000;
+    case 3000000: return B3000000;
+    default: return 0;
+    }
+}
+
+int fpr_bridge_host_open(const char *path, int baud, fpr_bridge_host_t **bridge)
+{
+    speed_t speed = _host_speed(baud);
+    if (path == NULL || bridge == NULL || speed == 0) {
+        return -EINVAL;
+    }
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return -errno;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        int err = -errno;
+        close(fd);
+        return err;
+    }
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, speed);
+    tio.c_cflag |= CLOCAL | CREAD;
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        int err = -errno;
+        close(fd);
+        return err;
+    }
+    tcflush(fd, TCIOFLUSH);
+
+    int err = fpr_bridge_host_attach(fd, bridge);
+    if (err != 0) {
+        close(fd);
+        return err;
+    }
+    (*bridge)->own_fd = true;
+    return 0;
+}
+
+int fpr_bridge_host_attach(int fd, fpr_bridge_host_t **bridge)
+{
+    if (fd < 0 || bridge == NULL) {
+        return -EINVAL;
+    }
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+        return -errno;
+    }
+    if (isatty(fd)) {
+        struct termios tio;
+        if (tcgetattr(fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+    }
+
+    fpr_bridge_host_t *b = calloc(1, sizeof(*b));
+    if (b == NULL) {
+        return -ENOMEM;
+    }
+    b->fd = fd;
+    _host_queue_control(b, FPR_BRIDGE_FRAME_HELLO, 0);
+    int err = _host_write(b);
+    if (err != 0 && err != -EAGAIN) {
+        free(b);
+        return err;
+    }
+    *bridge = b;
+    return 0;
+}
+
+void fpr_bridge_host_close(fpr_bridge_host_t *bridge)
+{
+    if (bridge == NULL) {
+        return;
+    }
+    if (bridge->own_fd) {
+        close(bridge->fd);
+    }
+    free(bridge);
+}
+
+int fpr_bridge_host_fd(const fpr_bridge_host_t *bridge)
+{
+    return bridge->fd;
+}
+
+bool fpr_bridge_host_connected(const fpr_bridge_host_t *bridge)
+{
+    return bridge->connected;
+}
+
+int fpr_bridge_host_poll(fpr_bridge_host_t *b)
+{
+    while (b->rx_fill < sizeof(b->rx)) {
+        ssize_t n = read(b->fd, b->rx + b->rx_fill, sizeof(b->rx) - b->rx_fill);
+        if (n > 0) {
+            b->rx_fill += (size_t)n;
+            b->stats.rx_bytes += (uint64_t)n;
+            continue;
+        }
+        if (n == 0) {
+            return -EPIPE;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        // A pty whose other side closed reads EIO
+        return errno == EIO ? -EPIPE : -errno;
+    }
+
+    // Control frames behind a full window still count, so parse everything
+    bool partial = false;
+    while (b->rx_parsed < b->rx_fill) {
+        uint8_t *start = b->rx + b->rx_parsed;
+        uint8_t *zero = memchr(start, 0x00, b->rx_fill - b->rx_parsed);
+        if (zero == NULL) {
+            partial = true;
+            break;
+        }
+        size_t len = (size_t)(zero - start);
+        if (b->rx_skipping) {
+            b->rx_skipping = false;
+            b->stats.bad_frames++;
+        } else if (len > 0) {
+            _host_on_frame(b, b->rx_parsed, len);
+        }
+        b->rx_parsed += len + 1;
+    }
+    // Longer than any frame without a delimiter: drop it up to the next one
+    if (partial && b->rx_fill - b->rx_parsed > HOST_WIRE_MAX) {
+        b->rx_fill = b->rx_parsed;
+        b->rx_skipping = true;
+    }
+    if (b->ready_count == 0 && b->rx_parsed > 0) {
+        memmove(b->rx, b->rx + b->rx_parsed, b->rx_fill - b->rx_parsed);
+        b->rx_fill -= b->rx_parsed;
+        b->rx_parsed = 0;
+    }
+
+    // Acknowledgements may have opened the node's window
+    int err = fpr_bridge_host_flush(b);
+    if (err != 0 && err != -EAGAIN) {
+        return err;
+    }
+    return (int)(b->ready_count - b->ready_index);
+}
+
+int fpr_bridge_host_next(fpr_bridge_host_t *b, fpr_bridge_host_record_t *rec)
+{
+    while (b->ready_index < b->ready_count) {
+        host_frame_t *frame = &b->ready[b->ready_index];
+        if (b->rec_index < frame->count) {
+            fpr_bridge_record_t hdr;
+            size_t remain = frame->len - b->rec_off;
+            const uint8_t *at = b->rx + frame->off + b->rec_off;
+            if (remain >= sizeof(hdr)) {
+                memcpy(&hdr, at, sizeof(hdr));
+                if (remain - sizeof(hdr) >= hdr.len) {
+                    rec->addr = at; // addr is the first field
+                    rec->id = hdr.id;
+                    rec->fragment = hdr.fragment;
+                    rec->data = at + sizeof(hdr);
+                    rec->len = hdr.len;
+                    b->rec_off += sizeof(hdr) + hdr.len;
+                    b->rec_index++;
+                    b->stats.rx_records++;
+                    return 1;
+                }
+            }
+            b->stats.bad_frames++; // Count disagrees with the body
+        }
+        b->ready_index++;
+        b->rec_off = 0;
+        b->rec_index = 0;
+    }
+    _host_release(b);
+    return 0;
+}
+
+int fpr_bridge_host_send(fpr_bridge_host_t *b, const uint8_t addr[6], uint8_t id, const void *data, size_t len)
+{
+    if (!b->connected) {
+        return -ENOTCONN;
+    }
+    size_t limit = (size_t)b->peer_max_frame - FPR_BRIDGE_CRC_LEN;
+    size_t size = sizeof(fpr_bridge_record_t) + len;
+    if (sizeof(fpr_bridge_frame_header_t) + size > limit || len > UINT16_MAX) {
+        return -EMSGSIZE;
+    }
+    if (b->stage_count > 0 && (b->stage_len + size > limit || b->stage_count == UINT8_MAX)) {
+        int err = _host_close_stage(b);
+        if (err != 0) {
+            return err;
+        }
+    }
+    if (b->stage_count == 0) {
+        b->stage_len = sizeof(fpr_bridge_frame_header_t);
+    }
+
+    fpr_bridge_record_t hdr = { .id = id, .len = (uint16_t)len };
+    memcpy(hdr.addr, addr, sizeof(hdr.addr));
+    memcpy(b->stage + b->stage_len, &hdr, sizeof(hdr));
+    memcpy(b->stage + b->stage_len + sizeof(hdr), data, len);
+    b->stage_len += size;
+    b->stage_count++;
+    return 0;
+}
+
+int fpr_bridge_host_flush(fpr_bridge_host_t *b)
+{
+    int staged = _host_close_stage(b);
+    int err = _host_write(b);
+    if (err != 0) {
+        return err;
+    }
+    return staged;
+}
+
+bool fpr_bridge_host_want_write(const fpr_bridge_host_t *bridge)
+{
+    return bridge->tx_sent < bridge->tx_len;
+}
+
+void fpr_bridge_host_get_stats(const fpr_bridge_host_t *bridge, fpr_bridge_host_stats_t *stats)
+{
+    *stats = bridge->stats;
+}
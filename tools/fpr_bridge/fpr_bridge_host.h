@@ -0,0 +1,138 @@
+#pragma once
+
+/**
+ * @file fpr_bridge_host.h
+ * @brief FPR Serial Bridge, Linux side
+ *
+ * Talks to a node running fpr_bridge_start() over a serial port (or any
+ * file descriptor: a pty, a socket). Nothing blocks: the application
+ * waits on fpr_bridge_host_fd() with poll/epoll and calls in when it is
+ * readable or writable.
+ *
+ * Reading is zero-copy. fpr_bridge_host_poll() reads into one buffer and
+ * decodes frames in place; fpr_bridge_host_next() returns records that
+ * point into it. Frames stay unacknowledged, and hold back the node, until
+ * the application has taken every record.
+ *
+ * Sending batches: fpr_bridge_host_send() appends records to an open
+ * frame, fpr_bridge_host_flush() seals it and writes what the node's
+ * window allows.
+ *
+ * Flow:
+ * 1. fpr_bridge_host_open("/dev/ttyUSB0", 921600, &bridge)
+ * 2. Wait for POLLIN on fpr_bridge_host_fd(), plus POLLOUT while
+ *    fpr_bridge_host_want_write()
+ * 3. On POLLIN: fpr_bridge_host_poll(), then fpr_bridge_host_next() until
+ *    it returns 0
+ * 4. fpr_bridge_host_send() records, then fpr_bridge_host_flush()
+ *
+ * Build (Linux, C11):
+ *     cc -O2 -I../../include fpr_bridge_host.c ../../fpr_bridge_proto.c ...
+ *
+ * Errors are negative errno values.
+ *
+ * @version 1.0.0
+ * @date December 2025
+ */
+
+#include "fpr/fpr_bridge_proto.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FPR_BRIDGE_HOST_RX_BUFFER (64 * 1024)   // Sets the window offered to the node
+#define FPR_BRIDGE_HOST_TX_BUFFER (64 * 1024)
+
+typedef struct fpr_bridge_host fpr_bridge_host_t;
+
+/**
+ * @brief A received record. Pointers are into the reader buffer and stay
+ * valid until fpr_bridge_host_next() returns 0.
+ */
+typedef struct {
+    const uint8_t *addr;        // Source peer MAC (6 bytes)
+    uint8_t id;                 // fpr_package_id_t
+    uint8_t fragment;           // fpr_package_type_t
+    const uint8_t *data;
+    size_t len;
+} fpr_bridge_host_record_t;
+
+typedef struct {
+    uint64_t rx_bytes;          // Wire bytes
+    uint64_t rx_frames;
+    uint64_t rx_records;
+    uint64_t bad_frames;        // CRC or framing errors
+    uint64_t lost_frames;       // Gaps in the DATA sequence
+    uint64_t tx_bytes;
+    uint64_t tx_frames;
+    uint64_t tx_records;
+} fpr_bridge_host_stats_t;
+
+/**
+ * @brief Open a serial port in raw mode and start the HELLO exchange.
+ * @return 0, -EINVAL for an unsupported baud rate, or the open/termios error.
+ */
+int fpr_bridge_host_open(const char *path, int baud, fpr_bridge_host_t **bridge);
+
+/**
+ * @brief Use an already open descriptor. It is made non-blocking, and raw
+ * if it is a terminal; fpr_bridge_host_close() does not close it.
+ */
+int fpr_bridge_host_attach(int fd, fpr_bridge_host_t **bridge);
+
+void fpr_bridge_host_close(fpr_bridge_host_t *bridge);
+
+/**
+ * @brief Descriptor to wait on.
+ */
+int fpr_bridge_host_fd(const fpr_bridge_host_t *bridge);
+
+/**
+ * @brief Check whether the HELLO exchange is done.
+ */
+bool fpr_bridge_host_connected(const fpr_bridge_host_t *bridge);
+
+/**
+ * @brief Read what is available and decode complete frames. Records not
+ * yet taken stay valid.
+ * @return Frames with records ready, -EPIPE if the other end closed, or a
+ * read error.
+ */
+int fpr_bridge_host_poll(fpr_bridge_host_t *bridge);
+
+/**
+ * @brief Take the next received record.
+ * @return 1 with rec filled, 0 when none are left. Returning 0 releases the
+ * buffer and acknowledges the frames.
+ */
+int fpr_bridge_host_next(fpr_bridge_host_t *bridge, fpr_bridge_host_record_t *rec);
+
+/**
+ * @brief Queue a record for a peer (FF:FF:FF:FF:FF:FF broadcasts).
+ * @return 0, -ENOTCONN before the HELLO exchange, -EMSGSIZE if it can
+ * never fit a frame, -EAGAIN if the window or buffer is full (wait for
+ * POLLIN/POLLOUT, poll(), flush(), retry).
+ */
+int fpr_bridge_host_send(fpr_bridge_host_t *bridge, const uint8_t addr[6], uint8_t id, const void *data, size_t len);
+
+/**
+ * @brief Seal the open frame and write pending output without blocking.
+ * @return 0 when everything is written, -EAGAIN if output remains, or a
+ * write error.
+ */
+int fpr_bridge_host_flush(fpr_bridge_host_t *bridge);
+
+/**
+ * @brief Check whether output is waiting for POLLOUT.
+ */
+bool fpr_bridge_host_want_write(const fpr_bridge_host_t *bridge);
+
+void fpr_bridge_host_get_stats(const fpr_bridge_host_t *bridge, fpr_bridge_host_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
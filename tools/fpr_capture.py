@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""Turn a console capture stream into a pcap file (see include/fpr/fpr_capture.h).
+
+fpr_capture_start_console() prints the pcap stream as "FPRC " hex lines
+between other log output. Feed a saved monitor log, or the serial port
+itself, to get a file Wireshark opens with tools/wireshark/fpr.lua.
+
+    fpr_capture.py monitor.log -o capture.pcap
+    fpr_capture.py /dev/ttyUSB0 -o capture.pcap    # until Ctrl-C or FPRC END
+
+Lines are written out as they arrive, so a live capture can be stopped at
+any time and still yields a valid file (up to the last complete line).
+"""
+
+import argparse
+import sys
+
+PREFIX = "FPRC "
+
+
+def convert(lines, out):
+    started = False
+    written = 0
+    for line in lines:
+        idx = line.find(PREFIX)
+        if idx < 0:
+            continue
+        body = line[idx + len(PREFIX):].strip()
+        if body == "BEGIN":
+            # A restarted capture begins a new file
+            out.seek(0)
+            out.truncate()
+            started, written = True, 0
+        elif body == "END":
+            if started:
+                break
+        elif started:
+            try:
+                data = bytes.fromhex(body)
+            except ValueError:
+                # Line garbled by interleaved output; the rest of the
+                # stream would be misaligned
+                sys.exit("corrupt line after %d bytes: %r" % (written, body[:40]))
+            out.write(data)
+            out.flush()
+            written += len(data)
+    if not started:
+        sys.exit("no capture found (missing 'FPRC BEGIN')")
+    return written
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("input", help="log file or serial device ('-' for stdin)")
+    ap.add_argument("-o", "--output", required=True, help="pcap file to write")
+    ap.add_argument("-b", "--baud", type=int, default=115200, help="baud rate for a serial device")
+    args = ap.parse_args()
+
+    with open(args.output, "wb") as out:
+        try:
+            if args.input == "-":
+                written = convert(sys.stdin, out)
+            elif args.input.startswith("/dev/") or args.input.upper().startswith("COM"):
+                import serial  # pyserial, only needed for live capture
+                with serial.Serial(args.input, args.baud) as port:
+                    lines = (raw.decode("utf-8", "replace") for raw in iter(port.readline, b""))
+                    written = convert(lines, out)
+            else:
+                with open(args.input, "r", errors="replace") as f:
+                    written = convert(f, out)
+        except KeyboardInterrupt:
+            written = out.tell()
+    print("%d bytes written to %s" % (written, args.output))
+
+
+if __name__ == "__main__":
+    main()
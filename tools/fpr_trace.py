@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Decode an FPR packet-event trace dump (see include/fpr/fpr_trace.h).
+
+Input is either the binary stream written by fpr_trace_dump(), or a console
+log containing the "FPRT " lines printed by fpr_trace_dump_console(). For a
+log, the last complete dump in it is used.
+
+    fpr_trace.py monitor.log                  # JSON to stdout
+    fpr_trace.py trace.bin --pcap trace.pcap  # one pcap packet per record
+
+The pcap uses link type USER0 (147); each packet is the raw 24-byte record.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b"FPRT"
+HEADER = struct.Struct("<4sHH6sH")
+RECORD = struct.Struct("<IIIi6sBB")
+LINKTYPE_USER0 = 147
+
+EVENTS = {
+    1: "rx",
+    2: "enqueue",
+    3: "drop",
+    4: "tx",
+    5: "tx_done",
+    6: "forward",
+    7: "handshake",
+}
+
+DROP_REASONS = {
+    1: "paused",
+    2: "malformed",
+    3: "version",
+    4: "replay",
+    5: "queue_full",
+    6: "latest_only",
+    7: "superseded",
+    8: "orphan",
+    9: "no_route",
+    10: "hop_limit",
+    11: "unauthorized",
+}
+
+PACKAGE_TYPES = {0: "single", 1: "start", 2: "continued", 3: "end"}
+
+
+def mac_str(raw):
+    return ":".join("%02x" % b for b in raw)
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data.startswith(MAGIC):
+        return data
+
+    # Console log: take the last BEGIN..END block
+    blob, current = None, None
+    for line in data.decode("utf-8", "replace").splitlines():
+        idx = line.find("FPRT ")
+        if idx < 0:
+            continue
+        body = line[idx + 5:].strip()
+        if body == "BEGIN":
+            current = []
+        elif body == "END":
+            if current is not None:
+                blob = bytes.fromhex("".join(current))
+            current = None
+        elif current is not None:
+            current.append(body)
+    if blob is None:
+        sys.exit("%s: no trace dump found" % path)
+    return blob
+
+
+def parse(data):
+    magic, version, record_size, node, _ = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        sys.exit("not an FPR trace (bad magic)")
+    if version != 1 or record_size != RECORD.size:
+        sys.exit("unsupported trace version %d / record size %d" % (version, record_size))
+
+    records = []
+    ts_high, last_ts = 0, None
+    for off in range(HEADER.size, len(data) - RECORD.size + 1, RECORD.size):
+        raw = data[off:off + RECORD.size]
+        seq, ts, sequence_num, package_id, peer, event, arg = RECORD.unpack(raw)
+        # Timestamps are 32-bit microseconds; records are in order, so a
+        # step backwards is a wrap
+        if last_ts is not None and ts < last_ts:
+            ts_high += 1 << 32
+        last_ts = ts
+
+        rec = {
+            "seq": seq,
+            "time_us": ts_high + ts,
+            "event": EVENTS.get(event, event),
+            "peer": mac_str(peer),
+            "package_id": package_id,
+            "sequence_num": sequence_num,
+        }
+        if event == 1:
+            rec["package_type"] = PACKAGE_TYPES.get(arg, arg)
+        elif event == 2:
+            rec["queue_depth"] = arg
+        elif event == 3:
+            rec["reason"] = DROP_REASONS.get(arg, arg)
+        elif event in (4, 5):
+            rec["ok"] = arg == 0
+        elif event == 6:
+            rec["hop_count"] = arg
+        elif event == 7:
+            rec["step"] = arg & 0x7F
+            rec["ok"] = not (arg & 0x80)
+        rec["_raw"] = raw
+        records.append(rec)
+    return mac_str(node), records
+
+
+def write_pcap(path, records):
+    with open(path, "wb") as f:
+        f.write(struct.pack("<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, 65535, LINKTYPE_USER0))
+        for rec in records:
+            t = rec["time_us"]
+            raw = rec["_raw"]
+            f.write(struct.pack("<IIII", t // 1000000, t % 1000000, len(raw), len(raw)))
+            f.write(raw)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("input", help="binary dump or console log")
+    ap.add_argument("--pcap", metavar="FILE", help="write a pcap file instead of JSON")
+    args = ap.parse_args()
+
+    node, records = parse(load(args.input))
+    if args.pcap:
+        write_pcap(args.pcap, records)
+        print("%d records from %s written to %s" % (len(records), node, args.pcap))
+        return
+
+    lost = 0
+    for prev, cur in zip(records, records[1:]):
+        lost += cur["seq"] - prev["seq"] - 1
+    for rec in records:
+        del rec["_raw"]
+    json.dump({"node": node, "lost": lost, "records": records}, sys.stdout, indent=1)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()
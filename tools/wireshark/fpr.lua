@@ -0,0 +1,194 @@
+-- Wireshark dissector for FPR captures (see include/fpr/fpr_capture.h).
+--
+-- Install: copy to the Wireshark personal plugins folder, or run
+--   wireshark -X lua_script:tools/wireshark/fpr.lua capture.pcap
+--
+-- Packets use link type USER1 (148): a 16-byte fpr_capture_header_t, then
+-- the fpr_package_t as sent over the air. Offsets below are the ESP32
+-- layout (little-endian, 4-byte aligned, 228-byte package).
+
+local fpr = Proto("fpr", "FPR (ESP-NOW mesh)")
+local cap = Proto("fpr_capture", "FPR capture metadata")
+
+local directions = { [0] = "RX", [1] = "TX" }
+
+local package_types = {
+    [0] = "SINGLE", [1] = "START", [2] = "CONTINUED", [3] = "END",
+}
+
+local package_ids = {
+    [-1] = "CONTROL", [-2] = "RPC", [-3] = "PUBSUB", [-4] = "TIMESYNC",
+    [-5] = "BEACON", [-6] = "TDMA", [-7] = "SLEEPY", [-8] = "PROBE",
+    [-9] = "LINK", [-10] = "AGGREGATE", [-11] = "TREE", [-12] = "MPR",
+}
+
+local visibility = { [0] = "PUBLIC", [1] = "PRIVATE" }
+local tree_kinds = { [0] = "BEACON", [1] = "DATA" }
+local aggregate_ops = { [0] = "CONCAT", [1] = "MIN", [2] = "MAX", [3] = "SUM", [4] = "COUNT", [5] = "CUSTOM" }
+
+-- Capture metadata
+local c_version   = ProtoField.uint8("fpr_capture.version", "Version")
+local c_direction = ProtoField.uint8("fpr_capture.direction", "Direction", base.DEC, directions)
+local c_rssi      = ProtoField.int8("fpr_capture.rssi", "RSSI (dBm)")
+local c_channel   = ProtoField.uint8("fpr_capture.channel", "Channel")
+local c_src       = ProtoField.ether("fpr_capture.src", "Radio source")
+local c_dst       = ProtoField.ether("fpr_capture.dst", "Radio destination")
+cap.fields = { c_version, c_direction, c_rssi, c_channel, c_src, c_dst }
+
+-- fpr_package_t
+local f_protocol     = ProtoField.bytes("fpr.protocol", "Protocol data")
+local f_payload      = ProtoField.bytes("fpr.payload", "Payload")
+local f_type         = ProtoField.uint32("fpr.type", "Package type", base.DEC, package_types)
+local f_id           = ProtoField.int32("fpr.id", "Package ID")
+local f_origin       = ProtoField.ether("fpr.origin", "Origin")
+local f_dest         = ProtoField.ether("fpr.dest", "Destination")
+local f_hop_count    = ProtoField.uint8("fpr.hop_count", "Hop count")
+local f_max_hops     = ProtoField.uint8("fpr.max_hops", "Max hops")
+local f_version      = ProtoField.uint32("fpr.version", "Protocol version", base.HEX)
+local f_payload_size = ProtoField.uint16("fpr.payload_size", "Payload size")
+local f_seq          = ProtoField.uint32("fpr.seq", "Sequence number")
+
+-- Control (fpr_connect_t)
+local f_c_name    = ProtoField.stringz("fpr.connect.name", "Name")
+local f_c_mac     = ProtoField.ether("fpr.connect.mac", "Peer MAC")
+local f_c_channel = ProtoField.uint8("fpr.connect.channel", "Channel")
+local f_c_vis     = ProtoField.uint32("fpr.connect.visibility", "Visibility", base.DEC, visibility)
+local f_c_pwk     = ProtoField.bytes("fpr.connect.pwk", "PWK")
+local f_c_lwk     = ProtoField.bytes("fpr.connect.lwk", "LWK")
+local f_c_has_pwk = ProtoField.bool("fpr.connect.has_pwk", "Has PWK")
+local f_c_has_lwk = ProtoField.bool("fpr.connect.has_lwk", "Has LWK")
+local f_c_load    = ProtoField.uint8("fpr.connect.load_flags", "Load flags", base.HEX)
+local f_c_conn    = ProtoField.uint8("fpr.connect.connected", "Connected clients")
+local f_c_cap     = ProtoField.uint8("fpr.connect.capacity", "Capacity")
+local f_c_qpct    = ProtoField.uint8("fpr.connect.queue_pct", "Queue fill (%)")
+
+-- Collection tree (fpr_tree_header_t)
+local f_t_kind  = ProtoField.uint8("fpr.tree.kind", "Kind", base.DEC, tree_kinds)
+local f_t_cost  = ProtoField.uint16("fpr.tree.cost", "Path cost (ETX x10)")
+local f_t_sink  = ProtoField.ether("fpr.tree.sink", "Sink")
+local f_t_seq   = ProtoField.uint16("fpr.tree.seq", "Beacon sequence")
+local f_t_inner = ProtoField.int32("fpr.tree.inner_id", "Inner package ID")
+local f_t_len   = ProtoField.uint16("fpr.tree.payload_len", "Payload length")
+
+-- Aggregation (fpr_aggregate_header_t)
+local f_a_inner = ProtoField.int32("fpr.agg.inner_id", "Inner package ID")
+local f_a_op    = ProtoField.uint8("fpr.agg.op", "Operation", base.DEC, aggregate_ops)
+local f_a_rsize = ProtoField.uint8("fpr.agg.record_size", "Record size")
+local f_a_count = ProtoField.uint8("fpr.agg.record_count", "Record count")
+local f_a_contr = ProtoField.uint16("fpr.agg.contributors", "Contributors")
+local f_a_delay = ProtoField.uint16("fpr.agg.delay_ms", "Added delay (ms)")
+
+fpr.fields = {
+    f_protocol, f_payload, f_type, f_id, f_origin, f_dest, f_hop_count, f_max_hops,
+    f_version, f_payload_size, f_seq,
+    f_c_name, f_c_mac, f_c_channel, f_c_vis, f_c_pwk, f_c_lwk, f_c_has_pwk, f_c_has_lwk,
+    f_c_load, f_c_conn, f_c_cap, f_c_qpct,
+    f_t_kind, f_t_cost, f_t_sink, f_t_seq, f_t_inner, f_t_len,
+    f_a_inner, f_a_op, f_a_rsize, f_a_count, f_a_contr, f_a_delay,
+}
+
+local PROTOCOL_SIZE = 180
+local PACKAGE_SIZE = 228
+
+local function dissect_connect(buf, tree)
+    local t = tree:add(fpr, buf(0, 110), "Connect info")
+    t:add(f_c_name, buf(0, 32))
+    t:add(f_c_mac, buf(32, 6))
+    t:add(f_c_channel, buf(54, 1))
+    t:add_le(f_c_vis, buf(68, 4))
+    t:add(f_c_pwk, buf(72, 16))
+    t:add(f_c_lwk, buf(88, 16))
+    t:add(f_c_has_pwk, buf(104, 1))
+    t:add(f_c_has_lwk, buf(105, 1))
+    t:add(f_c_load, buf(106, 1))
+    t:add(f_c_conn, buf(107, 1))
+    t:add(f_c_cap, buf(108, 1))
+    t:add(f_c_qpct, buf(109, 1))
+end
+
+local function dissect_tree(buf, tree)
+    local t = tree:add(fpr, buf(0, 18), "Collection tree")
+    t:add(f_t_kind, buf(0, 1))
+    t:add_le(f_t_cost, buf(2, 2))
+    t:add(f_t_sink, buf(4, 6))
+    t:add_le(f_t_seq, buf(10, 2))
+    t:add_le(f_t_inner, buf(12, 4))
+    t:add_le(f_t_len, buf(16, 2))
+end
+
+local function dissect_aggregate(buf, tree)
+    local t = tree:add(fpr, buf(0, 12), "Aggregation")
+    t:add_le(f_a_inner, buf(0, 4))
+    t:add(f_a_op, buf(4, 1))
+    t:add(f_a_rsize, buf(5, 1))
+    t:add(f_a_count, buf(6, 1))
+    t:add_le(f_a_contr, buf(8, 2))
+    t:add_le(f_a_delay, buf(10, 2))
+end
+
+function fpr.dissector(buf, pinfo, tree)
+    if buf:len() < PACKAGE_SIZE then
+        return 0
+    end
+    pinfo.cols.protocol = "FPR"
+
+    local t = tree:add(fpr, buf(0, PACKAGE_SIZE))
+    local ptype = buf(PROTOCOL_SIZE, 4):le_uint()
+    local id = buf(PROTOCOL_SIZE + 4, 4):le_int()
+    local payload_size = buf(PROTOCOL_SIZE + 28, 2):le_uint()
+
+    t:add_le(f_type, buf(PROTOCOL_SIZE, 4))
+    local id_item = t:add_le(f_id, buf(PROTOCOL_SIZE + 4, 4))
+    if package_ids[id] then
+        id_item:append_text(" (" .. package_ids[id] .. ")")
+    end
+    t:add(f_origin, buf(PROTOCOL_SIZE + 8, 6))
+    t:add(f_dest, buf(PROTOCOL_SIZE + 14, 6))
+    t:add(f_hop_count, buf(PROTOCOL_SIZE + 20, 1))
+    t:add(f_max_hops, buf(PROTOCOL_SIZE + 21, 1))
+    t:add_le(f_version, buf(PROTOCOL_SIZE + 24, 4))
+    t:add_le(f_payload_size, buf(PROTOCOL_SIZE + 28, 2))
+    t:add_le(f_seq, buf(PROTOCOL_SIZE + 32, 4))
+
+    local proto = buf(0, PROTOCOL_SIZE)
+    if id == -1 then
+        dissect_connect(proto, t)
+    elseif id == -11 then
+        dissect_tree(proto, t)
+    elseif id == -10 then
+        dissect_aggregate(proto, t)
+    end
+    if payload_size > 0 and payload_size <= PROTOCOL_SIZE then
+        t:add(f_payload, buf(0, payload_size))
+    else
+        t:add(f_protocol, proto)
+    end
+
+    local name = package_ids[id] or tostring(id)
+    pinfo.cols.info = string.format("%s %s seq=%u hop=%u/%u",
+        name, package_types[ptype] or tostring(ptype),
+        buf(PROTOCOL_SIZE + 32, 4):le_uint(),
+        buf(PROTOCOL_SIZE + 20, 1):uint(), buf(PROTOCOL_SIZE + 21, 1):uint())
+    return PACKAGE_SIZE
+end
+
+function cap.dissector(buf, pinfo, tree)
+    if buf:len() < 16 then
+        return 0
+    end
+    local t = tree:add(cap, buf(0, 16))
+    t:add(c_version, buf(0, 1))
+    t:add(c_direction, buf(1, 1))
+    t:add(c_rssi, buf(2, 1))
+    t:add(c_channel, buf(3, 1))
+    t:add(c_src, buf(4, 6))
+    t:add(c_dst, buf(10, 6))
+    pinfo.cols.src = tostring(buf(4, 6):ether())
+    pinfo.cols.dst = tostring(buf(10, 6):ether())
+
+    fpr.dissector(buf(16):tvb(), pinfo, tree)
+    pinfo.cols.info:prepend(directions[buf(1, 1):uint()] .. " ")
+    return buf:len()
+end
+
+DissectorTable.get("wtap_encap"):add(wtap.USER1, cap)